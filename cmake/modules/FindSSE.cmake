@@ -142,7 +142,7 @@ if (ENABLE_SSE)
         # Check compiler for AVX intrinsics
         #
         if (CMAKE_COMPILER_IS_GNUCC OR (CMAKE_C_COMPILER_ID MATCHES "Clang") OR (CMAKE_CXX_COMPILER_ID MATCHES "Clang"))
-            set(CMAKE_REQUIRED_FLAGS "-mavx512f")
+            set(CMAKE_REQUIRED_FLAGS "-mavx512f -mavx512bw -mavx512dq")
             check_c_source_runs("
           #include <immintrin.h>
           int main()
@@ -153,6 +153,7 @@ if (ENABLE_SSE)
             a =  _mm512_loadu_si512( (__m512i*)src );
             b =  _mm512_loadu_si512( (__m512i*)src );
             c = _mm512_add_epi32( a, b );
+            c = _mm512_max_epi16( c, _mm512_setzero_si512() );
             _mm512_storeu_si512( (__m512i*)dst, c );
             int i = 0;
             for( i = 0; i < 16; i++ ){
@@ -57,11 +57,15 @@ public:
 class srslte_gw_config_t
 {
 public:
-  srslte_gw_config_t(uint32_t lcid_ = 0)
+  srslte_gw_config_t(uint32_t lcid_ = 0, uint32_t nof_queues_ = 1, bool tun_offload_ = false)
   :lcid(lcid_)
+  ,nof_queues(nof_queues_)
+  ,tun_offload(tun_offload_)
   {}
 
   uint32_t lcid;
+  uint32_t nof_queues;  // Number of TUN queues, each read by its own thread
+  bool     tun_offload; // Let the kernel hand over TSO/checksum offloaded packets
 };
 
 
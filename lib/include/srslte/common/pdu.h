@@ -283,7 +283,11 @@ public:
   void fprint(FILE *stream);
   
   bool     set_next_mch_sched_info(uint8_t lcid, uint16_t mtch_stop);
-  
+
+  // Buffer size (Table 6.1.3.1-1) and power headroom (36.133 Table 9.1.8.4-1) mappings
+  static uint8_t  buff_size_table(uint32_t buffer_size);
+  static uint32_t buff_size_value(uint32_t buff_size_idx);
+  static uint8_t  phr_report_table(float phr_value);
   
 protected:
 
@@ -299,8 +303,6 @@ protected:
 
 private: 
   uint32_t sizeof_ce(uint32_t lcid, bool is_ul);
-  static uint8_t buff_size_table(uint32_t buffer_size);
-  static uint8_t phr_report_table(float phr_value);
 };
 
 
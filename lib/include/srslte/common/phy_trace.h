@@ -0,0 +1,162 @@
+/**
+ *
+ * \section COPYRIGHT
+ *
+ * Copyright 2013-2015 Software Radio Systems Limited
+ *
+ * \section LICENSE
+ *
+ * This file is part of the srsUE library.
+ *
+ * srsUE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsUE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ *  File:         phy_trace.h
+ *  Description:  Per-worker timeline of the PHY processing stages. Each
+ *                worker owns a preallocated event buffer stamped with the
+ *                CPU timestamp counter, so recording an event costs two
+ *                counter reads and a store. The buffers of all workers can
+ *                be dumped as a Chrome trace (chrome://tracing, Perfetto).
+ *                The subframe processing time is always measured, and the
+ *                subframes exceeding the processing budget are counted.
+ *  Reference:
+ *****************************************************************************/
+
+#ifndef SRSLTE_PHY_TRACE_H
+#define SRSLTE_PHY_TRACE_H
+
+#include <stdint.h>
+#include <pthread.h>
+#include <time.h>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace srslte {
+
+typedef enum {
+  PHY_TRACE_SF = 0,
+  PHY_TRACE_FFT,
+  PHY_TRACE_CHEST,
+  PHY_TRACE_PDCCH,
+  PHY_TRACE_PDSCH,
+  PHY_TRACE_PUSCH,
+  PHY_TRACE_PUCCH,
+  PHY_TRACE_PHICH,
+  PHY_TRACE_ENCODE,
+  PHY_TRACE_TX_WAIT,
+  PHY_TRACE_TX,
+  PHY_TRACE_N_ITEMS,
+} phy_trace_stage_t;
+static const char phy_trace_stage_text[PHY_TRACE_N_ITEMS][10] = {"SF", "FFT", "CHEST", "PDCCH", "PDSCH", "PUSCH",
+                                                                 "PUCCH", "PHICH", "ENCODE", "TX_WAIT", "TX"};
+
+typedef struct {
+  float    avg_us;    // Average subframe processing time
+  float    max_us;    // Maximum subframe processing time
+  uint32_t nof_sf;    // Processed subframes
+  uint32_t nof_late;  // Subframes exceeding the processing budget
+} phy_proc_metrics_t;
+
+class phy_trace
+{
+public:
+  phy_trace();
+  ~phy_trace();
+
+  void init(uint32_t nof_events, float budget_us);
+  void set_budget(float budget_us);
+  void start();
+  void stop();
+  bool is_enabled() { return enabled; }
+
+  // Timestamp in counter ticks. Only differences between values are meaningful.
+  static inline uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t) t.tv_sec*1000000000 + t.tv_nsec;
+#endif
+  }
+  static double ticks_to_us(uint64_t ticks);
+  static uint64_t us_to_ticks(double us);
+
+  void sf_begin(uint32_t tti);
+  bool sf_end(); // Returns true if the subframe was late
+
+  // Same as above with timestamps given by the caller, from now() or derived from it
+  void sf_begin(uint32_t tti, uint64_t t);
+  bool sf_end(uint64_t t);
+  void push(phy_trace_stage_t stage, uint64_t begin, uint64_t end);
+
+  // Reads and resets the processing time statistics
+  void get_metrics(phy_proc_metrics_t *m);
+
+  // Each buffer is shown as a thread named after its index in traces
+  static bool write_json(std::string filename, std::vector<phy_trace*> &traces);
+
+  class scope
+  {
+  public:
+    scope(phy_trace *trace_, phy_trace_stage_t stage_) {
+      trace = (trace_ && trace_->enabled) ? trace_ : NULL;
+      stage = stage_;
+      begin = trace ? now() : 0;
+    }
+    ~scope() {
+      if (trace) {
+        trace->push(stage, begin, now());
+      }
+    }
+  private:
+    phy_trace        *trace;
+    phy_trace_stage_t stage;
+    uint64_t          begin;
+  };
+
+private:
+  typedef struct {
+    uint64_t begin;
+    uint64_t end;
+    uint32_t tti;
+    uint32_t stage;
+  } event_t;
+
+  bool                 enabled;
+  std::vector<event_t> events;
+  uint32_t             wpm;
+  bool                 wrapped;
+
+  uint32_t             tti;
+  uint64_t             sf_start;
+
+  pthread_mutex_t      mutex;
+  uint64_t             budget_ticks;
+  uint64_t             sum_ticks;
+  uint64_t             max_ticks;
+  uint32_t             nof_sf;
+  uint32_t             nof_late;
+};
+
+} // namespace srslte
+
+#endif // SRSLTE_PHY_TRACE_H
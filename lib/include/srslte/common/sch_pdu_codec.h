@@ -0,0 +1,145 @@
+/**
+ *
+ * \section COPYRIGHT
+ *
+ * Copyright 2013-2015 Software Radio Systems Limited
+ *
+ * \section LICENSE
+ *
+ * This file is part of the srsUE library.
+ *
+ * srsUE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsUE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ *  File:         sch_pdu_codec.h
+ *  Description:  Compact encoder and decoder of UL-SCH/DL-SCH MAC PDUs.
+ *                Subheaders are plain structs in arrays allocated once, with
+ *                no virtual calls. The encoder keeps the header and CE sizes
+ *                up to date as elements are added, so the packet is written
+ *                in a single pass. Produces the same PDUs as sch_pdu.
+ *  Reference:    3GPP TS 36.321 version 10.0.0 Section 6.1.2
+ *****************************************************************************/
+
+#ifndef SRSLTE_SCH_PDU_CODEC_H
+#define SRSLTE_SCH_PDU_CODEC_H
+
+#include <stdint.h>
+#include <vector>
+#include "srslte/common/log.h"
+#include "srslte/common/pdu.h"
+#include "srslte/common/interfaces_common.h"
+
+namespace srslte {
+
+// One subheader and its payload
+class sch_pdu_elem
+{
+public:
+  uint32_t lcid;
+  uint32_t nof_bytes;
+  uint8_t *payload;
+
+  bool             is_sdu()           { return lcid < sch_subh::PHR_REPORT; }
+  sch_subh::cetype ce_type()          { return is_sdu() ? sch_subh::SDU : (sch_subh::cetype) lcid; }
+  uint32_t         get_sdu_lcid()     { return lcid; }
+  uint32_t         get_payload_size() { return nof_bytes; }
+  uint8_t*         get_sdu_ptr()      { return payload; }
+
+  uint16_t get_c_rnti();
+  uint64_t get_con_res_id();
+  uint8_t  get_ta_cmd();
+  float    get_phr();
+  int      get_bsr(uint32_t buff_size[4]);
+};
+
+class sch_pdu_encoder
+{
+public:
+  sch_pdu_encoder(uint32_t max_subh);
+
+  /* The SDUs are written at buffer + get_sdu_offset(). The headers and CEs are written right before
+   * them, and write_packet() returns the start of the PDU. The buffer must hold get_sdu_offset() + pdu_len bytes */
+  void     init(uint8_t *buffer, uint32_t pdu_len);
+  uint32_t get_sdu_offset() { return sdu_offset_start; }
+
+  int      get_pdu_len() { return pdu_len; }
+  int      rem_size()    { return rem_len; }
+  int      get_sdu_space();
+  uint32_t nof_subh()    { return nof_ce + nof_sdu; }
+
+  // Return the number of bytes written, 0 if the interface had nothing to write or -1 if there is no space
+  int      add_sdu(uint32_t lcid, uint32_t requested_bytes, read_pdu_interface *sdu_itf);
+  int      add_sdu(uint32_t lcid, uint32_t nof_bytes, uint8_t *payload);
+
+  bool     add_c_rnti(uint16_t crnti);
+  bool     add_bsr(uint32_t buff_size[4], sch_subh::cetype format);
+  bool     add_con_res_id(uint64_t con_res_id);
+  bool     add_ta_cmd(uint8_t ta_cmd);
+  bool     add_phr(float phr);
+
+  uint8_t* write_packet(srslte::log *log_h);
+
+private:
+  const static uint32_t MAX_CE_LEN = 6;
+
+  bool     has_space_subh();
+  uint8_t* new_ce(uint32_t lcid, uint32_t nof_bytes);
+  void     commit_sdu(uint32_t lcid, uint32_t nof_bytes);
+
+  std::vector<sch_pdu_elem> ces;
+  std::vector<sch_pdu_elem> sdus;
+  std::vector<uint8_t>      ce_buffer;
+  uint32_t                  max_subh;
+  uint32_t                  nof_ce;
+  uint32_t                  nof_sdu;
+
+  uint8_t                  *buffer;
+  uint32_t                  pdu_len;
+  int                       rem_len;
+  uint32_t                  sdu_offset_start;
+  uint32_t                  total_sdu_len;
+  uint32_t                  sdu_header_len;  // Subheaders of all SDUs, as if none were the last
+};
+
+class sch_pdu_decoder
+{
+public:
+  sch_pdu_decoder(uint32_t max_subh);
+
+  // Returns false if the subheaders do not describe a valid PDU of pdu_len bytes
+  bool     parse_packet(uint8_t *ptr, uint32_t pdu_len, bool is_ul);
+
+  uint32_t      nof_subh() { return nof_elems; }
+  sch_pdu_elem* get(uint32_t idx) { return &elems[idx]; }
+
+  // Iterates over the subheaders like pdu<>::next() and pdu<>::get()
+  void          reset() { cur_idx = -1; }
+  bool          next()  { return ++cur_idx < (int) nof_elems; }
+  sch_pdu_elem* get()   { return cur_idx >= 0 && cur_idx < (int) nof_elems ? &elems[cur_idx] : NULL; }
+
+private:
+  static uint32_t ce_size(uint32_t lcid, bool is_ul);
+
+  std::vector<sch_pdu_elem> elems;
+  uint32_t                  max_subh;
+  uint32_t                  nof_elems;
+  int                       cur_idx;
+};
+
+} // namespace srslte
+
+#endif // SRSLTE_SCH_PDU_CODEC_H
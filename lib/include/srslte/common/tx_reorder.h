@@ -0,0 +1,103 @@
+/**
+ *
+ * \section COPYRIGHT
+ *
+ * Copyright 2013-2015 Software Radio Systems Limited
+ *
+ * \section LICENSE
+ *
+ * This file is part of the srsUE library.
+ *
+ * srsUE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsUE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ *  File:         tx_reorder.h
+ *  Description:  Reorder stage between the PHY workers and the radio. Each
+ *                subframe carries a sequence number. Workers copy their
+ *                samples into the slot of that number and publish it without
+ *                waiting for each other. A dedicated thread drains the slots
+ *                in sequence order and hands them to the transmitter, so a
+ *                slow subframe only delays its own transmission.
+ *  Reference:
+ *****************************************************************************/
+
+#ifndef SRSLTE_TX_REORDER_H
+#define SRSLTE_TX_REORDER_H
+
+#include <stdint.h>
+#include <semaphore.h>
+#include <vector>
+
+#include "srslte/common/threads.h"
+#include "srslte/phy/common/phy_common.h"
+#include "srslte/phy/common/timestamp.h"
+
+namespace srslte {
+
+typedef struct {
+  void              *buffer[SRSLTE_MAX_PORTS];
+  uint32_t           nof_samples;
+  srslte_timestamp_t tx_time;
+  bool               tx_enable;
+  bool               c16;
+} tx_reorder_slot_t;
+
+class tx_reorder_handler
+{
+public:
+  // Called from the tx thread, once per sequence number and in order
+  virtual void tx_slot(uint32_t seq, tx_reorder_slot_t *slot) = 0;
+};
+
+class tx_reorder : public thread
+{
+public:
+  tx_reorder();
+  ~tx_reorder();
+
+  // nof_slots is rounded up to a power of two
+  bool init(tx_reorder_handler *handler, uint32_t nof_slots, uint32_t nof_ports, uint32_t slot_bytes, int prio);
+  void stop();
+
+  /* Any thread may fill any sequence number, in any order, but each number exactly once.
+   * get_slot() only blocks while the slot still holds the number nof_slots before, that is,
+   * when the transmitter is a whole ring behind. */
+  tx_reorder_slot_t* get_slot(uint32_t seq);
+  void               push(uint32_t seq);
+
+  uint32_t get_nof_slots() { return nof_slots; }
+  uint32_t get_slot_bytes() { return slot_bytes; }
+
+private:
+  const static uint32_t SLOT_WAIT_US = 20;
+
+  void run_thread();
+
+  tx_reorder_handler            *handler;
+  std::vector<tx_reorder_slot_t> slots;
+  std::vector<uint32_t>          slot_seq;   // Last number published in each slot
+  uint32_t                       nof_slots;
+  uint32_t                       nof_ports;
+  uint32_t                       slot_bytes;
+  uint32_t                       next_seq;   // Next number to transmit, written by the tx thread only
+  sem_t                          ready_sem;
+  bool                           running;
+};
+
+} // namespace srslte
+
+#endif // SRSLTE_TX_REORDER_H
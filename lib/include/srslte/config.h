@@ -68,8 +68,8 @@
 // cf_t definition
 typedef _Complex float cf_t;
 
-#ifdef ENABLE_C16
+// c16_t definition, interleaved 16-bit I/Q as produced by most RF front-ends.
+// ENABLE_C16 only selects the SIMD kernels operating on it.
 typedef _Complex short int c16_t;
-#endif /* ENABLE_C16 */
 
 #endif // SRSLTE_CONFIG_H
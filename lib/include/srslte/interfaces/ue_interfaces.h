@@ -543,6 +543,8 @@ typedef struct {
   bool estimator_fil_auto;
   float estimator_fil_stddev;
   uint32_t estimator_fil_order;
+  bool estimator_plan;
+  uint32_t estimator_meas_mask;
   std::string sss_algorithm;
   bool rssi_sensor_enabled;
   bool sic_pss_enabled;
@@ -34,6 +34,10 @@
  *                transmitted symbol.
  *                This object depends on the srslte_refsignal_t object for creating the LTE
  *                CSR signal.
+ *                With srslte_chest_dl_set_interp_plan(), the smoothing filter and the
+ *                frequency interpolation are precomputed as one banded matrix when the cell
+ *                or the filter changes, and each subframe applies it, and the linear time
+ *                interpolation, in a single SIMD pass over the resource grid.
  *
  *  Reference:
  *********************************************************************************************/
@@ -58,6 +62,31 @@ typedef enum {
   SRSLTE_NOISE_ALG_EMPTY,
 } srslte_chest_dl_noise_alg_t; 
 
+/* Smoothing and linear interpolation in frequency of one OFDM symbol of pilots. RE k is the
+ * sum of nof_taps pilots, starting 'lead' pilots before the last pilot at or below k */
+typedef struct {
+  uint32_t nof_ref;
+  uint32_t spacing;
+  uint32_t offset;
+  uint32_t nof_taps;
+  uint32_t lead;
+  float   *coeff;    // nof_taps rows of nof_ref*spacing coefficients, each one twice (real, imag)
+  cf_t    *rep;      // Each pilot repeated spacing times, zero padded
+} srslte_chest_dl_freq_plan_t;
+
+#define SRSLTE_CHEST_DL_MAX_REF_SYMBOLS 4
+
+/* Linear interpolation (or extrapolation) in time of the OFDM symbols without pilots */
+typedef struct {
+  uint32_t nof_ref;
+  uint32_t ref_symbol[SRSLTE_CHEST_DL_MAX_REF_SYMBOLS];
+  uint32_t nof_symbols;
+  uint32_t symbol[SRSLTE_CP_NORM_SF_NSYMB];
+  uint32_t ref0[SRSLTE_CP_NORM_SF_NSYMB];
+  uint32_t ref1[SRSLTE_CP_NORM_SF_NSYMB];
+  float    weight[SRSLTE_CP_NORM_SF_NSYMB];
+} srslte_chest_dl_time_plan_t;
+
 typedef struct {
   srslte_cell_t cell; 
   srslte_refsignal_t   csr_refs;
@@ -102,6 +131,17 @@ typedef struct {
   int last_nof_antennas;
 
   bool average_subframe;
+
+  /* Subframes in which RSRP, RSSI and noise are measured */
+  uint32_t meas_sf_mask;
+
+  /* Precomputed interpolation: two pilot offsets in a symbol, and the subframe average */
+  bool     interp_plan;
+  bool     plan_ready;
+  float    plan_filter[SRSLTE_CHEST_MAX_SMOOTH_FIL_LEN];
+  uint32_t plan_filter_len;
+  srslte_chest_dl_freq_plan_t freq_plan[3];
+  srslte_chest_dl_time_plan_t time_plan[2];
 } srslte_chest_dl_t;
 
 
@@ -172,6 +212,16 @@ SRSLTE_API void srslte_chest_dl_average_subframe(srslte_chest_dl_t *q,
 SRSLTE_API void srslte_chest_dl_set_rsrp_neighbour(srslte_chest_dl_t *q,
                                                    bool rsrp_for_neighbour);
 
+/* Enables the precomputed interpolation. It is not used with the adaptive smoothing filter
+ * or in MBSFN subframes, which keep the per-subframe interpolation */
+SRSLTE_API void srslte_chest_dl_set_interp_plan(srslte_chest_dl_t *q,
+                                                bool enable);
+
+/* RSRP, RSSI and noise are only measured in the subframes set in mask (bit i for subframe i),
+ * the other subframes keep the last values. Default is all subframes */
+SRSLTE_API void srslte_chest_dl_set_meas_sf_mask(srslte_chest_dl_t *q,
+                                                 uint32_t mask);
+
 SRSLTE_API float srslte_chest_dl_get_noise_estimate(srslte_chest_dl_t *q);
 
 SRSLTE_API float srslte_chest_dl_get_cfo(srslte_chest_dl_t *q);
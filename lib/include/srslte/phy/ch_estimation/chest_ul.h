@@ -69,6 +69,13 @@ typedef struct {
   float smooth_filter[SRSLTE_CHEST_MAX_SMOOTH_FIL_LEN];
 
   srslte_interp_linsrslte_vec_t srslte_interp_linvec; 
+
+  /* Smoothed estimates of the two DMRS symbols of the allocation, kept by
+   * srslte_chest_ul_estimate_dmrs() for srslte_chest_ul_equalize_symbol() */
+  cf_t *dmrs_ce[2];
+  cf_t *dmrs_ce_slope;
+  uint32_t dmrs_nof_re;
+  bool dmrs_hopping;
   
   float pilot_power; 
   float noise_estimate;
@@ -105,6 +112,24 @@ SRSLTE_API int srslte_chest_ul_estimate(srslte_chest_ul_t *q,
                                         uint32_t cyclic_shift_for_dmrs, 
                                         uint32_t n_prb[2]);
 
+/* Estimates the channel in the two DMRS symbols of the allocation only. The data symbols
+ * are then equalized one at a time with srslte_chest_ul_equalize_symbol(), which
+ * interpolates their estimates on the fly instead of filling a resource grid. */
+SRSLTE_API int srslte_chest_ul_estimate_dmrs(srslte_chest_ul_t *q, 
+                                             cf_t *input, 
+                                             uint32_t nof_prb, 
+                                             uint32_t sf_idx, 
+                                             uint32_t cyclic_shift_for_dmrs, 
+                                             uint32_t n_prb[2]);
+
+/* ZF/MMSE equalizes the allocated REs of symbol l of the subframe (ZF if noise_estimate=0).
+ * input points to the first allocated RE of the symbol. Returns the number of REs. */
+SRSLTE_API int srslte_chest_ul_equalize_symbol(srslte_chest_ul_t *q, 
+                                               cf_t *input, 
+                                               uint32_t l, 
+                                               float noise_estimate, 
+                                               cf_t *output);
+
 SRSLTE_API int srslte_chest_ul_estimate_pucch(srslte_chest_ul_t *q, 
                                               cf_t *input, 
                                               cf_t *ce, 
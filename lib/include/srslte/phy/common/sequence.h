@@ -49,6 +49,14 @@ typedef struct SRSLTE_API {
   uint32_t max_len;
 } srslte_sequence_t;
 
+/* Reentrant generator of the 36.211 7.2 sequence c(n). Holds 64 bits of each m-sequence
+ * starting at the next output bit and produces 32 bits of c(n) per step.
+ */
+typedef struct SRSLTE_API {
+  uint64_t x1;
+  uint64_t x2;
+} srslte_sequence_state_t;
+
 SRSLTE_API int srslte_sequence_init(srslte_sequence_t *q, uint32_t len);
 
 SRSLTE_API void srslte_sequence_free(srslte_sequence_t *q);
@@ -61,6 +69,68 @@ SRSLTE_API int srslte_sequence_set_LTE_pr(srslte_sequence_t *q,
                                            uint32_t len,
                                            uint32_t seed);
 
+SRSLTE_API void srslte_sequence_state_init(srslte_sequence_state_t *s,
+                                           uint32_t seed);
+
+/* Returns the next 32 bits of c(n), c(n) in bit 0, and advances the state nof_bits (1 to 32).
+ * The recursions are explained in sequence.c */
+static inline uint32_t srslte_sequence_state_next(srslte_sequence_state_t *s, uint32_t nof_bits) {
+  uint32_t c  = (uint32_t) (s->x1 ^ s->x2);
+  uint64_t f1 = (s->x1 >> 2) ^ (s->x1 >> 8);
+  uint64_t f2 = (s->x2 >> 2) ^ (s->x2 >> 4) ^ (s->x2 >> 6) ^ (s->x2 >> 8);
+  s->x1 = (s->x1 >> nof_bits) | (f1 << (64 - nof_bits));
+  s->x2 = (s->x2 >> nof_bits) | (f2 << (64 - nof_bits));
+  return c;
+}
+
+SRSLTE_API void srslte_sequence_state_advance(srslte_sequence_state_t *s,
+                                              uint32_t len);
+
+SRSLTE_API void srslte_sequence_state_gen_bits(srslte_sequence_state_t *s,
+                                               uint8_t *bits,
+                                               uint32_t len);
+
+SRSLTE_API void srslte_sequence_state_gen_packed(srslte_sequence_state_t *s,
+                                                 uint8_t *packed,
+                                                 uint32_t len);
+
+SRSLTE_API void srslte_sequence_state_gen_f(srslte_sequence_state_t *s,
+                                            float *out,
+                                            uint32_t len);
+
+SRSLTE_API void srslte_sequence_state_gen_s(srslte_sequence_state_t *s,
+                                            int16_t *out,
+                                            uint32_t len);
+
+SRSLTE_API void srslte_sequence_state_gen_sb(srslte_sequence_state_t *s,
+                                             int8_t *out,
+                                             uint32_t len);
+
+SRSLTE_API void srslte_sequence_state_apply_bits(srslte_sequence_state_t *s,
+                                                 uint8_t *in,
+                                                 uint8_t *out,
+                                                 uint32_t len);
+
+SRSLTE_API void srslte_sequence_state_apply_packed(srslte_sequence_state_t *s,
+                                                   uint8_t *in,
+                                                   uint8_t *out,
+                                                   uint32_t len);
+
+SRSLTE_API void srslte_sequence_state_apply_f(srslte_sequence_state_t *s,
+                                              float *in,
+                                              float *out,
+                                              uint32_t len);
+
+SRSLTE_API void srslte_sequence_state_apply_s(srslte_sequence_state_t *s,
+                                              int16_t *in,
+                                              int16_t *out,
+                                              uint32_t len);
+
+SRSLTE_API void srslte_sequence_state_apply_sb(srslte_sequence_state_t *s,
+                                               int8_t *in,
+                                               int8_t *out,
+                                               uint32_t len);
+
 SRSLTE_API int srslte_sequence_pbch(srslte_sequence_t *seq, 
                                     srslte_cp_t cp, 
                                     uint32_t cell_id);
@@ -78,6 +148,19 @@ SRSLTE_API int srslte_sequence_pdcch(srslte_sequence_t *seq,
                                      uint32_t cell_id, 
                                      uint32_t len);
 
+SRSLTE_API uint32_t srslte_sequence_pdsch_c_init(uint16_t rnti,
+                                                 int q,
+                                                 uint32_t nslot,
+                                                 uint32_t cell_id);
+
+SRSLTE_API uint32_t srslte_sequence_pusch_c_init(uint16_t rnti,
+                                                 uint32_t nslot,
+                                                 uint32_t cell_id);
+
+SRSLTE_API uint32_t srslte_sequence_pucch_c_init(uint16_t rnti,
+                                                 uint32_t nslot,
+                                                 uint32_t cell_id);
+
 SRSLTE_API int srslte_sequence_pdsch(srslte_sequence_t *seq, 
                                      uint16_t rnti, 
                                      int q,
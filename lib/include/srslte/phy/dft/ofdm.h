@@ -119,6 +119,10 @@ SRSLTE_API void srslte_ofdm_rx_slot_ng(srslte_ofdm_t *q,
 
 SRSLTE_API void srslte_ofdm_rx_sf(srslte_ofdm_t *q);
 
+SRSLTE_API void srslte_ofdm_rx_sf_c16(srslte_ofdm_t *q,
+                                      const c16_t *input,
+                                      float scale);
+
 SRSLTE_API void srslte_ofdm_rx_sf_ng(srslte_ofdm_t *q,
                                      cf_t *input,
                                      cf_t *output);
@@ -148,6 +152,10 @@ SRSLTE_API void srslte_ofdm_tx_slot_mbsfn(srslte_ofdm_t *q,
 
 SRSLTE_API void srslte_ofdm_tx_sf(srslte_ofdm_t *q);
 
+SRSLTE_API void srslte_ofdm_tx_sf_c16(srslte_ofdm_t *q,
+                                      c16_t *output,
+                                      float scale);
+
 SRSLTE_API int srslte_ofdm_set_freq_shift(srslte_ofdm_t *q, 
                                          float freq_shift); 
 
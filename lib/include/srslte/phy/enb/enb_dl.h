@@ -171,6 +171,14 @@ SRSLTE_API void srslte_enb_dl_gen_signal(srslte_enb_dl_t *q);
 
 SRSLTE_API void srslte_enb_dl_gen_signal_mbsfn(srslte_enb_dl_t *q);
 
+SRSLTE_API void srslte_enb_dl_gen_signal_c16(srslte_enb_dl_t *q,
+                                             c16_t *output[SRSLTE_MAX_PORTS],
+                                             float scale);
+
+SRSLTE_API void srslte_enb_dl_gen_signal_mbsfn_c16(srslte_enb_dl_t *q,
+                                                   c16_t *output,
+                                                   float scale);
+
 SRSLTE_API int srslte_enb_dl_add_rnti(srslte_enb_dl_t *q, 
                                       uint16_t rnti); 
 
@@ -82,6 +82,9 @@ typedef struct SRSLTE_API {
   srslte_pusch_cfg_t     pusch_cfg; 
   
   srslte_pusch_hopping_cfg_t hopping_cfg;
+
+  srslte_mimo_decoder_t mimo_decoder;
+  bool                  pusch_fused;
   
   // Configuration for each user
   srslte_enb_ul_user_t **users; 
@@ -125,8 +128,21 @@ SRSLTE_API int srslte_enb_ul_cfg_ue(srslte_enb_ul_t *q, uint16_t rnti,
                                     srslte_refsignal_srs_cfg_t *srs_cfg);
 
 
+/* Equalizer of the PUSCH, MMSE by default */
+SRSLTE_API void srslte_enb_ul_set_mimo_decoder(srslte_enb_ul_t *q,
+                                               srslte_mimo_decoder_t mimo_decoder);
+
+/* Estimates, equalizes and demodulates each PUSCH data symbol in one pass, disabled by default.
+ * The channel estimate grid ce is then not filled for the PUSCH */
+SRSLTE_API void srslte_enb_ul_set_pusch_fused(srslte_enb_ul_t *q,
+                                              bool enable);
+
 SRSLTE_API void srslte_enb_ul_fft(srslte_enb_ul_t *q);
 
+SRSLTE_API void srslte_enb_ul_fft_c16(srslte_enb_ul_t *q,
+                                      const c16_t *input,
+                                      float scale);
+
 SRSLTE_API int srslte_enb_ul_get_pucch(srslte_enb_ul_t *q, 
                                        uint16_t rnti, 
                                        uint32_t pdcch_n_cce, 
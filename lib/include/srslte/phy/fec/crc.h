@@ -48,6 +48,8 @@ typedef struct SRSLTE_API {
   uint64_t crcmask;
   uint64_t crchighbit;
   uint32_t srslte_crc_out;
+  uint32_t table8[8][256];  // Slice-by-8 tables, with the checksum aligned to 32 bits
+  uint64_t fold_k[4];       // Carry-less multiplication constants for folding 16 and 64 bytes
 } srslte_crc_t;
 
 SRSLTE_API int srslte_crc_init(srslte_crc_t *h, 
@@ -79,6 +81,12 @@ static inline uint64_t srslte_crc_checksum_get(srslte_crc_t *h) {
   return (h->crcinit  & h->crcmask);
 }
 
+/* Adds nof_bytes packed bytes to the running checksum. Combined with srslte_crc_set_init() and
+ * srslte_crc_checksum_get(), computes the CRC incrementally as the data is produced */
+SRSLTE_API void srslte_crc_checksum_put(srslte_crc_t *h,
+                                        uint8_t *data,
+                                        uint32_t nof_bytes);
+
 SRSLTE_API uint32_t srslte_crc_checksum_byte(srslte_crc_t *h, 
                                              uint8_t *data, 
                                              int len); 
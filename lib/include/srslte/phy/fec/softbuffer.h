@@ -36,15 +36,43 @@
 #ifndef SRSLTE_SOFTBUFFER_H
 #define SRSLTE_SOFTBUFFER_H
 
+#include <pthread.h>
+
 #include "srslte/config.h"
 #include "srslte/phy/common/phy_common.h"
 
+/* Shared arena of soft-bit storage. RX softbuffers initialized with srslte_softbuffer_rx_init_pool()
+ * take storage for each code block from the arena the first time the code block is received, sized
+ * to the code block length of the actual grant, and give it back when the TB is decoded or reset.
+ */
+typedef struct SRSLTE_API {
+  uint32_t nof_chunks;
+  uint32_t nof_used;
+  uint32_t max_used;    // Since the last call to srslte_softbuffer_pool_get_metrics()
+  uint32_t nof_cb;
+  uint32_t nof_fail;    // Code blocks that could not get storage
+  uint32_t chunk_sz;
+} srslte_softbuffer_pool_metrics_t;
+
+typedef struct SRSLTE_API {
+  uint8_t  *arena;
+  uint64_t *free_map;
+  uint32_t  nof_chunks;
+  uint32_t  next_chunk;
+  uint32_t  llr_sz;
+  pthread_mutex_t mutex;
+  srslte_softbuffer_pool_metrics_t metrics;
+} srslte_softbuffer_pool_t;
+
 typedef struct SRSLTE_API {
   uint32_t max_cb;
   int16_t **buffer_f;  
   uint8_t **data;
   bool *cb_crc;
   bool tb_crc;
+  srslte_softbuffer_pool_t *pool;
+  uint32_t *cb_chunk;
+  uint32_t *cb_nof_chunks;
 } srslte_softbuffer_rx_t;
 
 typedef struct SRSLTE_API {
@@ -54,9 +82,30 @@ typedef struct SRSLTE_API {
 
 #define SOFTBUFFER_SIZE 18600 
 
+#define SRSLTE_SOFTBUFFER_POOL_CHUNK_SZ 512
+
+SRSLTE_API int  srslte_softbuffer_pool_init(srslte_softbuffer_pool_t *q,
+                                            uint32_t size_bytes,
+                                            bool llr_is_8bit);
+
+SRSLTE_API void srslte_softbuffer_pool_free(srslte_softbuffer_pool_t *q);
+
+SRSLTE_API void srslte_softbuffer_pool_get_metrics(srslte_softbuffer_pool_t *q,
+                                                   srslte_softbuffer_pool_metrics_t *metrics);
+
 SRSLTE_API int  srslte_softbuffer_rx_init(srslte_softbuffer_rx_t * q,
                                           uint32_t nof_prb);
 
+SRSLTE_API int  srslte_softbuffer_rx_init_pool(srslte_softbuffer_rx_t *q,
+                                               uint32_t nof_prb,
+                                               srslte_softbuffer_pool_t *pool);
+
+SRSLTE_API int16_t* srslte_softbuffer_rx_get_cb(srslte_softbuffer_rx_t *q,
+                                                uint32_t cb_idx,
+                                                uint32_t cb_len);
+
+SRSLTE_API void srslte_softbuffer_rx_release(srslte_softbuffer_rx_t *q);
+
 SRSLTE_API void srslte_softbuffer_rx_reset(srslte_softbuffer_rx_t *p);
 
 SRSLTE_API void srslte_softbuffer_rx_reset_tbs(srslte_softbuffer_rx_t *q, 
@@ -103,14 +103,14 @@ SRSLTE_API int srslte_predecoding_diversity(cf_t *y,
 SRSLTE_API int srslte_predecoding_diversity_multi(cf_t *y[SRSLTE_MAX_PORTS], 
                                                   cf_t *h[SRSLTE_MAX_PORTS][SRSLTE_MAX_PORTS], 
                                                   cf_t *x[SRSLTE_MAX_LAYERS],
-                                                  float *csi[SRSLTE_MAX_LAYERS],
+                                                  float *csi[SRSLTE_MAX_CODEWORDS],
                                                   int nof_rxant,
                                                   int nof_ports, 
                                                   int nof_symbols,
                                                   float scaling);
 
-SRSLTE_API void srslte_predecoding_set_mimo_decoder (srslte_mimo_decoder_t _mimo_decoder);
-
+/* The MIMO decoder selects the ZF or MMSE equalizer of CDD and spatial multiplexing. Up to 4 ports, layers and
+ * rx antennas are supported */
 SRSLTE_API int srslte_predecoding_type(cf_t *y[SRSLTE_MAX_PORTS],
                                        cf_t *h[SRSLTE_MAX_PORTS][SRSLTE_MAX_PORTS],
                                        cf_t *x[SRSLTE_MAX_LAYERS],
@@ -122,7 +122,8 @@ SRSLTE_API int srslte_predecoding_type(cf_t *y[SRSLTE_MAX_PORTS],
                                        int nof_symbols,
                                        srslte_mimo_type_t type,
                                        float scaling,
-                                       float noise_estimate);
+                                       float noise_estimate,
+                                       srslte_mimo_decoder_t mimo_decoder);
 
 SRSLTE_API int srslte_precoding_pmi_select(cf_t *h[SRSLTE_MAX_PORTS][SRSLTE_MAX_PORTS],
                                            uint32_t nof_symbols,
@@ -47,12 +47,6 @@
 #include "srslte/phy/phch/sch.h"
 #include "srslte/phy/phch/pdsch_cfg.h"
 
-typedef struct {
-  srslte_sequence_t seq[SRSLTE_MAX_CODEWORDS][SRSLTE_NSUBFRAMES_X_FRAME];
-  uint32_t cell_id;
-  bool sequence_generated;
-} srslte_pdsch_user_t;
-
 /* PDSCH object */
 typedef struct SRSLTE_API {
   srslte_cell_t cell;
@@ -70,6 +64,8 @@ typedef struct SRSLTE_API {
   /* Power allocation parameter 3GPP 36.213 Clause 5.2 Rho_b */
   float rho_a;
 
+  srslte_mimo_decoder_t mimo_decoder;
+
   /* buffers */
   // void buffers are shared for tx and rx
   cf_t *ce[SRSLTE_MAX_PORTS][SRSLTE_MAX_PORTS]; /* Channel estimation (Rx only) */
@@ -84,11 +80,6 @@ typedef struct SRSLTE_API {
   /* tx & rx objects */
   srslte_modem_table_t mod[4];
   
-  // This is to generate the scrambling seq for multiple CRNTIs
-  srslte_pdsch_user_t **users;
-
-  srslte_sequence_t tmp_seq;
-
   srslte_sch_t dl_sch;
 
   void *coworker_ptr;
@@ -117,6 +108,9 @@ SRSLTE_API void srslte_pdsch_set_power_allocation(srslte_pdsch_t *q,
 SRSLTE_API int srslte_pdsch_enable_csi(srslte_pdsch_t *q,
                                        bool enable);
 
+SRSLTE_API void srslte_pdsch_set_mimo_decoder(srslte_pdsch_t *q,
+                                              srslte_mimo_decoder_t mimo_decoder);
+
 SRSLTE_API void srslte_pdsch_free_rnti(srslte_pdsch_t *q, 
                                       uint16_t rnti);
 
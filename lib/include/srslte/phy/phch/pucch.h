@@ -79,12 +79,6 @@ typedef struct SRSLTE_API {
   bool srs_simul_ack; 
 } srslte_pucch_cfg_t;
 
-typedef struct  {
-  srslte_sequence_t seq_f2[SRSLTE_NSUBFRAMES_X_FRAME];
-  uint32_t cell_id;
-  bool sequence_generated;
-} srslte_pucch_user_t; 
-
 /* PUCCH object */
 typedef struct SRSLTE_API {
   srslte_cell_t cell;
@@ -93,8 +87,6 @@ typedef struct SRSLTE_API {
   
   srslte_uci_cqi_pucch_t cqi; 
   
-  srslte_pucch_user_t **users;
-  
   uint8_t bits_scram[SRSLTE_PUCCH_MAX_BITS];
   cf_t d[SRSLTE_PUCCH_MAX_BITS/2];
   uint32_t n_cs_cell[SRSLTE_NSLOTS_X_FRAME][SRSLTE_CP_NORM_NSYMB]; 
@@ -113,7 +105,6 @@ typedef struct SRSLTE_API {
   uint32_t last_n_prb;
   uint32_t last_n_pucch;
 
-  srslte_sequence_t tmp_seq;
   uint16_t ue_rnti;
   bool is_ue;
 }srslte_pucch_t;
@@ -48,6 +48,7 @@
 #include "srslte/phy/phch/pusch_cfg.h"
 #include "srslte/phy/dft/dft_precoding.h"
 #include "srslte/phy/ch_estimation/refsignal_ul.h"
+#include "srslte/phy/ch_estimation/chest_ul.h"
 
 #define SRSLTE_PUSCH_MAX_TDEC_ITERS         5
 
@@ -60,12 +61,6 @@ typedef struct {
   uint32_t n_sb;
 } srslte_pusch_hopping_cfg_t;
 
-typedef struct {
-  srslte_sequence_t seq[SRSLTE_NSUBFRAMES_X_FRAME];
-  uint32_t cell_id;
-  bool sequence_generated;
-} srslte_pusch_user_t;
-
 /* PUSCH object */
 typedef struct SRSLTE_API {
   srslte_cell_t cell;
@@ -91,8 +86,7 @@ typedef struct SRSLTE_API {
   srslte_modem_table_t mod[4];
   srslte_sequence_t seq_type2_fo; 
   
-  // This is to generate the scrambling seq for multiple CRNTIs
-  srslte_pusch_user_t **users;
+  // Sequence for the RI/HARQ placeholders, only generated when UCI is multiplexed
   srslte_sequence_t tmp_seq;
 
   srslte_sch_t ul_sch;
@@ -147,6 +141,19 @@ SRSLTE_API int srslte_pusch_decode(srslte_pusch_t *q,
                                    srslte_cqi_value_t *cqi_value,
                                    srslte_uci_data_t *uci_data);
 
+/* Same as srslte_pusch_decode() but each data symbol is equalized, DFT de-precoded and demodulated 
+ * in one pass. The DMRS must have been estimated with srslte_chest_ul_estimate_dmrs() */
+SRSLTE_API int srslte_pusch_decode_fused(srslte_pusch_t *q, 
+                                         srslte_pusch_cfg_t *cfg,
+                                         srslte_softbuffer_rx_t *softbuffer,
+                                         cf_t *sf_symbols, 
+                                         srslte_chest_ul_t *chest,
+                                         float noise_estimate, 
+                                         uint16_t rnti,
+                                         uint8_t *data, 
+                                         srslte_cqi_value_t *cqi_value,
+                                         srslte_uci_data_t *uci_data);
+
 SRSLTE_API float srslte_pusch_average_noi(srslte_pusch_t *q); 
 
 SRSLTE_API uint32_t srslte_pusch_last_noi(srslte_pusch_t *q); 
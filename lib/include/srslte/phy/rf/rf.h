@@ -46,8 +46,17 @@ typedef struct {
   double new_rx_gain;   
   bool   tx_gain_same_rx; 
   float  tx_rx_gain_offset; 
+
+  // Conversion buffers for devices without a native complex int16 interface. Receive and
+  // transmit run in different threads, each direction has its own buffers
+  cf_t    *c16_rx_buffer[4];
+  cf_t    *c16_tx_buffer[4];
 } srslte_rf_t;
 
+/* Complex int16 samples exchanged with the _c16 functions are Q15: a float
+ * sample of 1.0 maps to 32768, matching the sc16 format of most front-ends. */
+#define SRSLTE_RF_C16_SCALE 32768.0f
+
 typedef struct {
   double min_tx_gain;
   double max_tx_gain;
@@ -150,6 +159,13 @@ SRSLTE_API int srslte_rf_recv_with_time_multi(srslte_rf_t *h,
                                               time_t *secs,
                                               double *frac_secs);
 
+SRSLTE_API int srslte_rf_recv_with_time_multi_c16(srslte_rf_t *h,
+                                                  void **data,
+                                                  uint32_t nsamples,
+                                                  bool blocking,
+                                                  time_t *secs,
+                                                  double *frac_secs);
+
 SRSLTE_API double srslte_rf_set_tx_srate(srslte_rf_t *h, 
                                   double freq);
 
@@ -204,6 +220,15 @@ SRSLTE_API int srslte_rf_send_timed_multi(srslte_rf_t *rf,
                                           bool is_start_of_burst,
                                           bool is_end_of_burst);
 
+SRSLTE_API int srslte_rf_send_timed_multi_c16(srslte_rf_t *rf,
+                                              void *data[4],
+                                              int nsamples,
+                                              time_t secs,
+                                              double frac_secs,
+                                              bool blocking,
+                                              bool is_start_of_burst,
+                                              bool is_end_of_burst);
+
 SRSLTE_API int srslte_rf_send_multi(srslte_rf_t *rf,
                                     void *data[4],
                                     int nsamples,
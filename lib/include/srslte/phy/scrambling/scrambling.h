@@ -81,4 +81,27 @@ SRSLTE_API void srslte_scrambling_c_offset(srslte_sequence_t *s,
                                            int offset, 
                                            int len);
 
+/* Scrambling with the sequence generated on the fly. The state is initialized with the c_init of
+ * the channel (e.g. srslte_sequence_pdsch_c_init()) and advanced len bits, so consecutive calls
+ * scramble consecutive parts of a codeword. No sequence tables are needed. */
+SRSLTE_API void srslte_scrambling_state_b(srslte_sequence_state_t *s,
+                                          uint8_t *data,
+                                          int len);
+
+SRSLTE_API void srslte_scrambling_state_bytes(srslte_sequence_state_t *s,
+                                              uint8_t *data,
+                                              int len);
+
+SRSLTE_API void srslte_scrambling_state_f(srslte_sequence_state_t *s,
+                                          float *data,
+                                          int len);
+
+SRSLTE_API void srslte_scrambling_state_s(srslte_sequence_state_t *s,
+                                          short *data,
+                                          int len);
+
+SRSLTE_API void srslte_scrambling_state_sb(srslte_sequence_state_t *s,
+                                           int8_t *data,
+                                           int len);
+
 #endif // SRSLTE_SCRAMBLING_H
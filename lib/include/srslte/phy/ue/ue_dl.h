@@ -245,6 +245,10 @@ SRSLTE_API void srslte_ue_dl_set_power_alloc(srslte_ue_dl_t *q,
                                               float rho_a,
                                               float rho_b);
 
+/* Equalizer of CDD and spatial multiplexing, MMSE by default */
+SRSLTE_API void srslte_ue_dl_set_mimo_decoder(srslte_ue_dl_t *q,
+                                              srslte_mimo_decoder_t mimo_decoder);
+
 
 SRSLTE_API void srslte_ue_dl_save_signal(srslte_ue_dl_t *q, 
                                          srslte_softbuffer_rx_t *softbuffer, 
@@ -0,0 +1,85 @@
+/**
+ *
+ * \section COPYRIGHT
+ *
+ * Copyright 2013-2015 Software Radio Systems Limited
+ *
+ * \section LICENSE
+ *
+ * This file is part of the srsLTE library.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ *  File:         cpu_features.h
+ *
+ *  Description:  Run-time selection of the SIMD kernels.
+ *                The library is built for a baseline instruction set (the
+ *                LV_HAVE_* flags). With ENABLE_SIMD_DISPATCH, the vector
+ *                kernels, the QAM soft demodulator, the Viterbi decoder, the
+ *                windowed turbo decoder and the sequence state scrambling are
+ *                also built for AVX2 and AVX512 (SRSLTE_DISPATCH_*), and
+ *                the best ones the CPU supports are selected at start-up.
+ *                The CPU is probed once. The environment variable
+ *                SRSLTE_CPU_ISA (sse, avx2 or avx512) caps the selection.
+ *
+ *  Reference:
+ *****************************************************************************/
+
+#ifndef SRSLTE_CPU_FEATURES_H
+#define SRSLTE_CPU_FEATURES_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "srslte/config.h"
+
+/* Kernels built either as the baseline or as a run-time variant */
+#if defined(LV_HAVE_AVX2) || defined(SRSLTE_DISPATCH_AVX2)
+#define SRSLTE_HAVE_AVX2_KERNELS
+#endif
+
+typedef enum SRSLTE_API {
+  SRSLTE_CPU_ISA_GENERIC = 0,
+  SRSLTE_CPU_ISA_NEON,
+  SRSLTE_CPU_ISA_SSE,     // SSE4.1
+  SRSLTE_CPU_ISA_AVX2,    // AVX2 and FMA
+  SRSLTE_CPU_ISA_AVX512   // AVX512 F, CD, BW and DQ
+} srslte_cpu_isa_t;
+
+/* Instruction set of the kernels in use */
+SRSLTE_API srslte_cpu_isa_t srslte_cpu_isa();
+
+/* Best instruction set supported by the CPU and the OS */
+SRSLTE_API srslte_cpu_isa_t srslte_cpu_isa_detected();
+
+/* Instruction set the library was built for, without the run-time variants */
+SRSLTE_API srslte_cpu_isa_t srslte_cpu_isa_baseline();
+
+SRSLTE_API const char* srslte_cpu_isa_string(srslte_cpu_isa_t isa);
+
+/* Writes a one-line summary of the above, for the logs */
+SRSLTE_API int srslte_cpu_isa_info(char *str, uint32_t max_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SRSLTE_CPU_FEATURES_H
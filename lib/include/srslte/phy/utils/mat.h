@@ -27,6 +27,8 @@
 #ifndef SRSLTE_MAT_H
 #define SRSLTE_MAT_H
 
+#include <stdint.h>
+
 #include "srslte/config.h"
 #include "srslte/phy/utils/simd.h"
 
@@ -64,6 +66,21 @@ SRSLTE_API float srslte_mat_2x2_cn(cf_t h00,
                                    cf_t h10,
                                    cf_t h11);
 
+/* Maximum number of receive antennas and layers of the NxM solvers */
+#define SRSLTE_MAT_MAX_DIM 4
+
+/* Generic implementation for Minimum Mean Squared Error (MMSE) NxM solver, with N receive antennas and M layers
+ * (M <= N). h[i][j] is the channel from layer j to antenna i. A = H' x H + No is factored as L x D x L' instead of
+ * being inverted. A Zero Forcing (ZF) solver is obtained with noise_estimate set to 0. The CSI of each layer is
+ * 1 / inv(A)[j][j], it is skipped when csi is NULL */
+SRSLTE_API void srslte_mat_mimo_mmse_csi_gen(cf_t y[SRSLTE_MAT_MAX_DIM],
+                                             cf_t h[SRSLTE_MAT_MAX_DIM][SRSLTE_MAT_MAX_DIM],
+                                             uint32_t nof_rxant,
+                                             uint32_t nof_layers,
+                                             cf_t x[SRSLTE_MAT_MAX_DIM],
+                                             float csi[SRSLTE_MAT_MAX_DIM],
+                                             float noise_estimate);
+
 #ifdef LV_HAVE_SSE
 
 /* SSE implementation for complex reciprocal */
@@ -222,5 +239,79 @@ static inline void srslte_mat_2x2_mmse_simd(simd_cf_t y0,
   srslte_mat_2x2_mmse_csi_simd(y0, y1, h00, h01, h10, h11, x0, x1, &csi0, &csi1, noise_estimate, norm);
 }
 
+/* Generic SIMD implementation for Minimum Mean Squared Error (MMSE) NxM solver, one RE per SIMD lane */
+static inline void srslte_mat_mimo_mmse_csi_simd(simd_cf_t y[SRSLTE_MAT_MAX_DIM],
+                                                 simd_cf_t h[SRSLTE_MAT_MAX_DIM][SRSLTE_MAT_MAX_DIM],
+                                                 uint32_t nof_rxant,
+                                                 uint32_t nof_layers,
+                                                 simd_cf_t x[SRSLTE_MAT_MAX_DIM],
+                                                 simd_f_t csi[SRSLTE_MAT_MAX_DIM],
+                                                 float noise_estimate) {
+  simd_cf_t l[SRSLTE_MAT_MAX_DIM][SRSLTE_MAT_MAX_DIM];
+  simd_cf_t e[SRSLTE_MAT_MAX_DIM][SRSLTE_MAT_MAX_DIM];
+  simd_f_t d_rcp[SRSLTE_MAT_MAX_DIM];
+  simd_cf_t z[SRSLTE_MAT_MAX_DIM];
+  simd_f_t _two = srslte_simd_f_set1(2.0f);
+
+  /* 1. A = H' x H + No = L x D x L', column by column */
+  for (uint32_t j = 0; j < nof_layers; j++) {
+    simd_cf_t a = srslte_simd_cf_conjprod(h[0][j], h[0][j]);
+    z[j] = srslte_simd_cf_conjprod(y[0], h[0][j]);
+    for (uint32_t r = 1; r < nof_rxant; r++) {
+      a = srslte_simd_cf_add(a, srslte_simd_cf_conjprod(h[r][j], h[r][j]));
+      z[j] = srslte_simd_cf_add(z[j], srslte_simd_cf_conjprod(y[r], h[r][j]));
+    }
+    for (uint32_t k = 0; k < j; k++) {
+      a = srslte_simd_cf_sub(a, srslte_simd_cf_conjprod(e[j][k], l[j][k]));
+    }
+    simd_f_t d = srslte_simd_f_add(srslte_simd_cf_re(a), srslte_simd_f_set1(noise_estimate));
+
+    /* Reciprocal estimate refined with one Newton-Raphson iteration */
+    simd_f_t d_inv = srslte_simd_f_rcp(d);
+    d_rcp[j] = srslte_simd_f_mul(d_inv, srslte_simd_f_sub(_two, srslte_simd_f_mul(d, d_inv)));
+
+    for (uint32_t i = j + 1; i < nof_layers; i++) {
+      a = srslte_simd_cf_conjprod(h[0][j], h[0][i]);
+      for (uint32_t r = 1; r < nof_rxant; r++) {
+        a = srslte_simd_cf_add(a, srslte_simd_cf_conjprod(h[r][j], h[r][i]));
+      }
+      for (uint32_t k = 0; k < j; k++) {
+        a = srslte_simd_cf_sub(a, srslte_simd_cf_conjprod(e[i][k], l[j][k]));
+      }
+      e[i][j] = a;
+      l[i][j] = srslte_simd_cf_mul(a, d_rcp[j]);
+    }
+  }
+
+  /* 2. Solve L x D x L' x X = H' x Y */
+  for (uint32_t i = 1; i < nof_layers; i++) {
+    for (uint32_t k = 0; k < i; k++) {
+      z[i] = srslte_simd_cf_sub(z[i], srslte_simd_cf_prod(l[i][k], z[k]));
+    }
+  }
+  for (int i = nof_layers - 1; i >= 0; i--) {
+    x[i] = srslte_simd_cf_mul(z[i], d_rcp[i]);
+    for (uint32_t k = i + 1; k < nof_layers; k++) {
+      x[i] = srslte_simd_cf_sub(x[i], srslte_simd_cf_conjprod(x[k], l[k][i]));
+    }
+  }
+
+  /* 3. CSI is the inverse of the diagonal of inv(A) = inv(L') x inv(D) x inv(L) */
+  if (csi) {
+    for (uint32_t j = 0; j < nof_layers; j++) {
+      simd_cf_t v[SRSLTE_MAT_MAX_DIM];
+      simd_f_t b = d_rcp[j];
+      for (uint32_t i = j + 1; i < nof_layers; i++) {
+        v[i] = srslte_simd_cf_neg(l[i][j]);
+        for (uint32_t k = j + 1; k < i; k++) {
+          v[i] = srslte_simd_cf_sub(v[i], srslte_simd_cf_prod(l[i][k], v[k]));
+        }
+        b = srslte_simd_f_add(b, srslte_simd_f_mul(srslte_simd_cf_re(srslte_simd_cf_conjprod(v[i], v[i])), d_rcp[i]));
+      }
+      csi[j] = srslte_simd_f_rcp(b);
+    }
+  }
+}
+
 #endif /* SRSLTE_SIMD_CF_SIZE != 0 */
 #endif /* SRSLTE_MAT_H */
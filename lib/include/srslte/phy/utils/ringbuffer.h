@@ -40,6 +40,80 @@ SRSLTE_API int  srslte_ringbuffer_read(srslte_ringbuffer_t *q,
 
 SRSLTE_API void srslte_ringbuffer_stop(srslte_ringbuffer_t *q);
 
+/* Lock-free ring for exactly one producer thread and one consumer thread. Neither side
+ * blocks or takes a lock, so it can be fed from the real-time receive thread. The consumer
+ * is expected to be woken up by other means once the data it waits for is committed.
+ *
+ * Writes are staged and only become visible to the consumer on commit, which allows the
+ * producer to drop a partially written block with cancel. The reserve/peek functions give
+ * direct access to the buffer, returning the contiguous number of bytes available at the
+ * current position (less than requested when the ring wraps around).
+ */
+typedef struct {
+  uint8_t *buffer;
+  uint64_t capacity;
+  bool     active;
+
+  // Producer owned. wpos is published to the consumer, wpos_staged is private.
+  // The padding keeps producer and consumer positions in different cache lines
+  uint8_t  pad0[64];
+  uint64_t wpos;
+  uint64_t wpos_staged;
+
+  // Consumer owned
+  uint8_t  pad1[64];
+  uint64_t rpos;
+  uint8_t  pad2[64];
+} srslte_ringbuffer_spsc_t;
+
+SRSLTE_API int  srslte_ringbuffer_spsc_init(srslte_ringbuffer_spsc_t *q,
+                                            int capacity);
+
+SRSLTE_API void srslte_ringbuffer_spsc_free(srslte_ringbuffer_spsc_t *q);
+
+// Must not be called while the producer or the consumer are using the ring
+SRSLTE_API void srslte_ringbuffer_spsc_reset(srslte_ringbuffer_spsc_t *q);
+
+SRSLTE_API void srslte_ringbuffer_spsc_stop(srslte_ringbuffer_spsc_t *q);
+
+// Committed bytes, as seen by the consumer
+SRSLTE_API int  srslte_ringbuffer_spsc_status(srslte_ringbuffer_spsc_t *q);
+
+// Free bytes, as seen by the producer
+SRSLTE_API int  srslte_ringbuffer_spsc_space(srslte_ringbuffer_spsc_t *q);
+
+/* Producer */
+SRSLTE_API int  srslte_ringbuffer_spsc_write(srslte_ringbuffer_spsc_t *q,
+                                             void *ptr,
+                                             int nof_bytes);
+
+SRSLTE_API int  srslte_ringbuffer_spsc_write_staged(srslte_ringbuffer_spsc_t *q,
+                                                    void *ptr,
+                                                    int nof_bytes);
+
+SRSLTE_API int  srslte_ringbuffer_spsc_write_reserve(srslte_ringbuffer_spsc_t *q,
+                                                     void **ptr,
+                                                     int nof_bytes);
+
+SRSLTE_API void srslte_ringbuffer_spsc_write_advance(srslte_ringbuffer_spsc_t *q,
+                                                     int nof_bytes);
+
+SRSLTE_API void srslte_ringbuffer_spsc_write_commit(srslte_ringbuffer_spsc_t *q);
+
+SRSLTE_API void srslte_ringbuffer_spsc_write_cancel(srslte_ringbuffer_spsc_t *q);
+
+/* Consumer */
+SRSLTE_API int  srslte_ringbuffer_spsc_read(srslte_ringbuffer_spsc_t *q,
+                                            void *ptr,
+                                            int nof_bytes);
+
+SRSLTE_API int  srslte_ringbuffer_spsc_read_peek(srslte_ringbuffer_spsc_t *q,
+                                                 void **ptr,
+                                                 int nof_bytes);
+
+SRSLTE_API void srslte_ringbuffer_spsc_read_advance(srslte_ringbuffer_spsc_t *q,
+                                                    int nof_bytes);
+
 #endif // SRSLTE_RINGBUFFER_H
 
 
@@ -1321,6 +1321,42 @@ static inline simd_s_t srslte_simd_s_zero(void) {
 #endif /* LV_HAVE_AVX512 */
 }
 
+static inline simd_s_t srslte_simd_s_set1(int16_t x) {
+#ifdef LV_HAVE_AVX512
+  return _mm512_set1_epi16(x);
+#else /* LV_HAVE_AVX512 */
+#ifdef LV_HAVE_AVX2
+  return _mm256_set1_epi16(x);
+#else /* LV_HAVE_AVX2 */
+#ifdef LV_HAVE_SSE
+  return _mm_set1_epi16(x);
+#else /* LV_HAVE_SSE */
+#ifdef HAVE_NEON
+  return vdupq_n_s16(x);
+#endif /* HAVE_NEON */
+#endif /* LV_HAVE_SSE */
+#endif /* LV_HAVE_AVX2 */
+#endif /* LV_HAVE_AVX512 */
+}
+
+static inline simd_s_t srslte_simd_s_abs(simd_s_t a) {
+#ifdef LV_HAVE_AVX512
+  return _mm512_abs_epi16(a);
+#else /* LV_HAVE_AVX512 */
+#ifdef LV_HAVE_AVX2
+  return _mm256_abs_epi16(a);
+#else /* LV_HAVE_AVX2 */
+#ifdef LV_HAVE_SSE
+  return _mm_abs_epi16(a);
+#else /* LV_HAVE_SSE */
+#ifdef HAVE_NEON
+  return vabsq_s16(a);
+#endif /* HAVE_NEON */
+#endif /* LV_HAVE_SSE */
+#endif /* LV_HAVE_AVX2 */
+#endif /* LV_HAVE_AVX512 */
+}
+
 static inline simd_s_t srslte_simd_s_mul(simd_s_t a, simd_s_t b) {
 #ifdef LV_HAVE_AVX512
   return _mm512_mullo_epi16(a, b);
@@ -1341,7 +1377,10 @@ static inline simd_s_t srslte_simd_s_mul(simd_s_t a, simd_s_t b) {
 
 static inline simd_s_t srslte_simd_s_neg(simd_s_t a, simd_s_t b) {
 #ifdef LV_HAVE_AVX512
-#error sign instruction not available in avx512
+  __m512i zero = _mm512_setzero_si512();
+  __mmask32 neg = _mm512_cmplt_epi16_mask(b, zero);
+  __mmask32 nz  = _mm512_cmpneq_epi16_mask(b, zero);
+  return _mm512_maskz_mov_epi16(nz, _mm512_mask_sub_epi16(a, neg, zero, a));
 #else /* LV_HAVE_AVX512 */
 #ifdef LV_HAVE_AVX2
   return _mm256_sign_epi16(a, b);
@@ -1682,6 +1721,136 @@ static inline simd_s_t srslte_simd_convert_2f_s(simd_f_t a, simd_f_t b) {
 
 #endif /* SRSLTE_SIMD_F_SIZE && SRSLTE_SIMD_C16_SIZE */
 
+#if SRSLTE_SIMD_F_SIZE && SRSLTE_SIMD_S_SIZE && defined(LV_HAVE_SSE)
+
+/* Interleaving of consecutive (re, im) pairs, as the soft demodulator writes them. With 2 inputs the outputs hold
+ * a0 b0 a1 b1 ... and with 3 inputs a0 b0 c0 a1 b1 c1 ..., where each element is a pair of 2 floats or 2 shorts */
+static inline void srslte_simd_f_interleave2_pairs(simd_f_t a, simd_f_t b, simd_f_t *r0, simd_f_t *r1) {
+#ifdef LV_HAVE_AVX512
+  __m512d ad = _mm512_castps_pd(a);
+  __m512d bd = _mm512_castps_pd(b);
+  *r0 = _mm512_castpd_ps(_mm512_permutex2var_pd(ad, _mm512_setr_epi64(0, 8, 1, 9, 2, 10, 3, 11), bd));
+  *r1 = _mm512_castpd_ps(_mm512_permutex2var_pd(ad, _mm512_setr_epi64(4, 12, 5, 13, 6, 14, 7, 15), bd));
+#else /* LV_HAVE_AVX512 */
+#ifdef LV_HAVE_AVX2
+  __m256d lo = _mm256_unpacklo_pd(_mm256_castps_pd(a), _mm256_castps_pd(b));
+  __m256d hi = _mm256_unpackhi_pd(_mm256_castps_pd(a), _mm256_castps_pd(b));
+  *r0 = _mm256_castpd_ps(_mm256_permute2f128_pd(lo, hi, 0x20));
+  *r1 = _mm256_castpd_ps(_mm256_permute2f128_pd(lo, hi, 0x31));
+#else /* LV_HAVE_AVX2 */
+  *r0 = _mm_movelh_ps(a, b);
+  *r1 = _mm_movehl_ps(b, a);
+#endif /* LV_HAVE_AVX2 */
+#endif /* LV_HAVE_AVX512 */
+}
+
+static inline void srslte_simd_f_interleave3_pairs(simd_f_t a, simd_f_t b, simd_f_t c,
+                                                   simd_f_t *r0, simd_f_t *r1, simd_f_t *r2) {
+#ifdef LV_HAVE_AVX512
+  __m512d ad = _mm512_castps_pd(a);
+  __m512d bd = _mm512_castps_pd(b);
+  __m512d cd = _mm512_castps_pd(c);
+  __m512d t0 = _mm512_permutex2var_pd(ad, _mm512_setr_epi64(0, 8, 0, 1, 9, 0, 2, 10), bd);
+  __m512d t1 = _mm512_permutex2var_pd(ad, _mm512_setr_epi64(0, 3, 11, 0, 4, 12, 0, 5), bd);
+  __m512d t2 = _mm512_permutex2var_pd(ad, _mm512_setr_epi64(13, 0, 6, 14, 0, 7, 15, 0), bd);
+  *r0 = _mm512_castpd_ps(_mm512_permutex2var_pd(t0, _mm512_setr_epi64(0, 1, 8, 3, 4, 9, 6, 7), cd));
+  *r1 = _mm512_castpd_ps(_mm512_permutex2var_pd(t1, _mm512_setr_epi64(10, 1, 2, 11, 4, 5, 12, 7), cd));
+  *r2 = _mm512_castpd_ps(_mm512_permutex2var_pd(t2, _mm512_setr_epi64(0, 13, 2, 3, 14, 5, 6, 15), cd));
+#else /* LV_HAVE_AVX512 */
+#ifdef LV_HAVE_AVX2
+  __m256d ad = _mm256_castps_pd(a);
+  __m256d bd = _mm256_castps_pd(b);
+  __m256d cd = _mm256_castps_pd(c);
+  /* a0 b0 c0 a1 | b1 c1 a2 b2 | c2 a3 b3 c3 */
+  __m256d a0 = _mm256_permute4x64_pd(ad, _MM_SHUFFLE(1, 0, 0, 0));
+  __m256d b0 = _mm256_permute4x64_pd(bd, _MM_SHUFFLE(1, 0, 0, 0));
+  __m256d c0 = _mm256_permute4x64_pd(cd, _MM_SHUFFLE(1, 0, 0, 0));
+  __m256d a1 = _mm256_permute4x64_pd(ad, _MM_SHUFFLE(2, 2, 1, 1));
+  __m256d b1 = _mm256_permute4x64_pd(bd, _MM_SHUFFLE(2, 2, 1, 1));
+  __m256d c1 = _mm256_permute4x64_pd(cd, _MM_SHUFFLE(2, 2, 1, 1));
+  __m256d a2 = _mm256_permute4x64_pd(ad, _MM_SHUFFLE(3, 3, 3, 2));
+  __m256d b2 = _mm256_permute4x64_pd(bd, _MM_SHUFFLE(3, 3, 3, 2));
+  __m256d c2 = _mm256_permute4x64_pd(cd, _MM_SHUFFLE(3, 3, 3, 2));
+  *r0 = _mm256_castpd_ps(_mm256_blend_pd(_mm256_blend_pd(a0, b0, 0x2), c0, 0x4));
+  *r1 = _mm256_castpd_ps(_mm256_blend_pd(_mm256_blend_pd(a1, b1, 0x9), c1, 0x2));
+  *r2 = _mm256_castpd_ps(_mm256_blend_pd(_mm256_blend_pd(a2, b2, 0x4), c2, 0x9));
+#else /* LV_HAVE_AVX2 */
+  *r0 = _mm_movelh_ps(a, b);
+  *r1 = _mm_shuffle_ps(c, a, _MM_SHUFFLE(3, 2, 1, 0));
+  *r2 = _mm_movehl_ps(c, b);
+#endif /* LV_HAVE_AVX2 */
+#endif /* LV_HAVE_AVX512 */
+}
+
+static inline void srslte_simd_s_interleave2_pairs(simd_s_t a, simd_s_t b, simd_s_t *r0, simd_s_t *r1) {
+#ifdef LV_HAVE_AVX512
+  *r0 = _mm512_permutex2var_epi32(a, _mm512_setr_epi32(0, 16, 1, 17, 2, 18, 3, 19,
+                                                       4, 20, 5, 21, 6, 22, 7, 23), b);
+  *r1 = _mm512_permutex2var_epi32(a, _mm512_setr_epi32(8, 24, 9, 25, 10, 26, 11, 27,
+                                                       12, 28, 13, 29, 14, 30, 15, 31), b);
+#else /* LV_HAVE_AVX512 */
+#ifdef LV_HAVE_AVX2
+  __m256i lo = _mm256_unpacklo_epi32(a, b);
+  __m256i hi = _mm256_unpackhi_epi32(a, b);
+  *r0 = _mm256_permute2x128_si256(lo, hi, 0x20);
+  *r1 = _mm256_permute2x128_si256(lo, hi, 0x31);
+#else /* LV_HAVE_AVX2 */
+  *r0 = _mm_unpacklo_epi32(a, b);
+  *r1 = _mm_unpackhi_epi32(a, b);
+#endif /* LV_HAVE_AVX2 */
+#endif /* LV_HAVE_AVX512 */
+}
+
+static inline void srslte_simd_s_interleave3_pairs(simd_s_t a, simd_s_t b, simd_s_t c,
+                                                   simd_s_t *r0, simd_s_t *r1, simd_s_t *r2) {
+#ifdef LV_HAVE_AVX512
+  __m512i t0 = _mm512_permutex2var_epi32(a, _mm512_setr_epi32(0, 16, 0, 1, 17, 0, 2, 18,
+                                                              0, 3, 19, 0, 4, 20, 0, 5), b);
+  __m512i t1 = _mm512_permutex2var_epi32(a, _mm512_setr_epi32(21, 0, 6, 22, 0, 7, 23, 0,
+                                                              8, 24, 0, 9, 25, 0, 10, 26), b);
+  __m512i t2 = _mm512_permutex2var_epi32(a, _mm512_setr_epi32(0, 11, 27, 0, 12, 28, 0, 13,
+                                                              29, 0, 14, 30, 0, 15, 31, 0), b);
+  *r0 = _mm512_permutex2var_epi32(t0, _mm512_setr_epi32(0, 1, 16, 3, 4, 17, 6, 7,
+                                                        18, 9, 10, 19, 12, 13, 20, 15), c);
+  *r1 = _mm512_permutex2var_epi32(t1, _mm512_setr_epi32(0, 21, 2, 3, 22, 5, 6, 23,
+                                                        8, 9, 24, 11, 12, 25, 14, 15), c);
+  *r2 = _mm512_permutex2var_epi32(t2, _mm512_setr_epi32(26, 1, 2, 27, 4, 5, 28, 7,
+                                                        8, 29, 10, 11, 30, 13, 14, 31), c);
+#else /* LV_HAVE_AVX512 */
+#ifdef LV_HAVE_AVX2
+  /* a0 b0 c0 a1 b1 c1 a2 b2 | c2 a3 b3 c3 a4 b4 c4 a5 | b5 c5 a6 b6 c6 a7 b7 c7 */
+  __m256i i0 = _mm256_setr_epi32(0, 0, 0, 1, 1, 1, 2, 2);
+  __m256i i1 = _mm256_setr_epi32(2, 3, 3, 3, 4, 4, 4, 5);
+  __m256i i2 = _mm256_setr_epi32(5, 5, 6, 6, 6, 7, 7, 7);
+  *r0 = _mm256_blend_epi32(_mm256_blend_epi32(_mm256_permutevar8x32_epi32(a, i0),
+                                              _mm256_permutevar8x32_epi32(b, i0), 0x92),
+                           _mm256_permutevar8x32_epi32(c, i0), 0x24);
+  *r1 = _mm256_blend_epi32(_mm256_blend_epi32(_mm256_permutevar8x32_epi32(a, i1),
+                                              _mm256_permutevar8x32_epi32(b, i1), 0x24),
+                           _mm256_permutevar8x32_epi32(c, i1), 0x49);
+  *r2 = _mm256_blend_epi32(_mm256_blend_epi32(_mm256_permutevar8x32_epi32(a, i2),
+                                              _mm256_permutevar8x32_epi32(b, i2), 0x49),
+                           _mm256_permutevar8x32_epi32(c, i2), 0x92);
+#else /* LV_HAVE_AVX2 */
+  /* a0 b0 c0 a1 | b1 c1 a2 b2 | c2 a3 b3 c3 */
+  __m128 a0 = _mm_castsi128_ps(_mm_shuffle_epi32(a, _MM_SHUFFLE(1, 0, 0, 0)));
+  __m128 b0 = _mm_castsi128_ps(_mm_shuffle_epi32(b, _MM_SHUFFLE(1, 0, 0, 0)));
+  __m128 c0 = _mm_castsi128_ps(_mm_shuffle_epi32(c, _MM_SHUFFLE(1, 0, 0, 0)));
+  __m128 a1 = _mm_castsi128_ps(_mm_shuffle_epi32(a, _MM_SHUFFLE(2, 2, 1, 1)));
+  __m128 b1 = _mm_castsi128_ps(_mm_shuffle_epi32(b, _MM_SHUFFLE(2, 2, 1, 1)));
+  __m128 c1 = _mm_castsi128_ps(_mm_shuffle_epi32(c, _MM_SHUFFLE(2, 2, 1, 1)));
+  __m128 a2 = _mm_castsi128_ps(_mm_shuffle_epi32(a, _MM_SHUFFLE(3, 3, 3, 2)));
+  __m128 b2 = _mm_castsi128_ps(_mm_shuffle_epi32(b, _MM_SHUFFLE(3, 3, 3, 2)));
+  __m128 c2 = _mm_castsi128_ps(_mm_shuffle_epi32(c, _MM_SHUFFLE(3, 3, 3, 2)));
+  *r0 = _mm_castps_si128(_mm_blend_ps(_mm_blend_ps(a0, b0, 0x2), c0, 0x4));
+  *r1 = _mm_castps_si128(_mm_blend_ps(_mm_blend_ps(a1, b1, 0x9), c1, 0x2));
+  *r2 = _mm_castps_si128(_mm_blend_ps(_mm_blend_ps(a2, b2, 0x4), c2, 0x9));
+#endif /* LV_HAVE_AVX2 */
+#endif /* LV_HAVE_AVX512 */
+}
+
+#endif /* SRSLTE_SIMD_F_SIZE && SRSLTE_SIMD_S_SIZE && LV_HAVE_SSE */
+
 #if SRSLTE_SIMD_B_SIZE
 /* Data types */
 #ifdef LV_HAVE_AVX512
@@ -1814,7 +1983,10 @@ static inline simd_s_t srslte_simd_b_sub(simd_s_t a, simd_s_t b) {
 
 static inline simd_s_t srslte_simd_b_neg(simd_b_t a, simd_b_t b) {
 #ifdef LV_HAVE_AVX512
-#error sign instruction not available in avx512
+  __m512i zero = _mm512_setzero_si512();
+  __mmask64 neg = _mm512_cmplt_epi8_mask(b, zero);
+  __mmask64 nz  = _mm512_cmpneq_epi8_mask(b, zero);
+  return _mm512_maskz_mov_epi8(nz, _mm512_mask_sub_epi8(a, neg, zero, a));
 #else /* LV_HAVE_AVX512 */
 #ifdef LV_HAVE_AVX2
   return _mm256_sign_epi8(a, b);
@@ -1832,6 +2004,27 @@ static inline simd_s_t srslte_simd_b_neg(simd_b_t a, simd_b_t b) {
 
 
 
+#if SRSLTE_SIMD_S_SIZE
+/* Packs two vectors of shorts into one of bytes with saturation, keeping the order of the elements */
+static inline simd_b_t srslte_simd_convert_2s_b(simd_s_t a, simd_s_t b) {
+#ifdef LV_HAVE_AVX512
+  return _mm512_permutexvar_epi64(_mm512_setr_epi64(0, 2, 4, 6, 1, 3, 5, 7), _mm512_packs_epi16(a, b));
+#else /* LV_HAVE_AVX512 */
+#ifdef LV_HAVE_AVX2
+  return _mm256_permute4x64_epi64(_mm256_packs_epi16(a, b), _MM_SHUFFLE(3, 1, 2, 0));
+#else /* LV_HAVE_AVX2 */
+#ifdef LV_HAVE_SSE
+  return _mm_packs_epi16(a, b);
+#else /* LV_HAVE_SSE */
+#ifdef HAVE_NEON
+  return vcombine_s8(vqmovn_s16(a), vqmovn_s16(b));
+#endif /* HAVE_NEON */
+#endif /* LV_HAVE_SSE */
+#endif /* LV_HAVE_AVX2 */
+#endif /* LV_HAVE_AVX512 */
+}
+#endif /* SRSLTE_SIMD_S_SIZE */
+
 #endif /*SRSLTE_SIMD_B_SIZE */
 
 
@@ -150,6 +150,62 @@ SRSLTE_API uint32_t srslte_vec_max_abs_fi_simd(const float *x, const int len);
 
 SRSLTE_API uint32_t srslte_vec_max_ci_simd(const cf_t *x, const int len);
 
+/* Kernels of one build of vector_simd.c. The library is built for the baseline instruction set
+ * (srslte_vec_simd_default) and, with SIMD dispatch, also for AVX2 and AVX512. vector.c calls the
+ * table selected for the CPU, see srslte/phy/utils/cpu_features.h */
+typedef struct {
+  void (*xor_bbb)(const int8_t *x, const int8_t *y, int8_t *z, int len);
+  void (*sum_sss)(const int16_t *x, const int16_t *y, int16_t *z, int len);
+  void (*sub_sss)(const int16_t *x, const int16_t *y, int16_t *z, int len);
+  void (*sub_bbb)(const int8_t *x, const int8_t *y, int8_t *z, int len);
+  float (*acc_ff)(const float *x, int len);
+  cf_t (*acc_cc)(const cf_t *x, int len);
+  void (*add_fff)(const float *x, const float *y, float *z, int len);
+  void (*sub_fff)(const float *x, const float *y, float *z, int len);
+  void (*sc_prod_cfc)(const cf_t *x, const float h, cf_t *y, const int len);
+  void (*sc_prod_fff)(const float *x, const float h, float *z, const int len);
+  void (*sc_prod_ccc)(const cf_t *x, const cf_t h, cf_t *z, const int len);
+  void (*prod_ccc_split)(const float *a_re, const float *a_im, const float *b_re, const float *b_im,
+                         float *r_re, float *r_im, const int len);
+  void (*prod_sss)(const int16_t *x, const int16_t *y, int16_t *z, const int len);
+  void (*neg_sss)(const int16_t *x, const int16_t *y, int16_t *z, const int len);
+  void (*neg_bbb)(const int8_t *x, const int8_t *y, int8_t *z, const int len);
+  void (*prod_cfc)(const cf_t *x, const float *y, cf_t *z, const int len);
+  void (*prod_fff)(const float *x, const float *y, float *z, const int len);
+  void (*prod_ccc)(const cf_t *x, const cf_t *y, cf_t *z, const int len);
+  void (*prod_conj_ccc)(const cf_t *x, const cf_t *y, cf_t *z, const int len);
+  void (*div_ccc)(const cf_t *x, const cf_t *y, cf_t *z, const int len);
+  void (*div_cfc)(const cf_t *x, const float *y, cf_t *z, const int len);
+  void (*div_fff)(const float *x, const float *y, float *z, const int len);
+  cf_t (*dot_prod_conj_ccc)(const cf_t *x, const cf_t *y, const int len);
+  cf_t (*dot_prod_ccc)(const cf_t *x, const cf_t *y, const int len);
+  int (*dot_prod_sss)(const int16_t *x, const int16_t *y, const int len);
+  void (*abs_cf)(const cf_t *x, float *z, const int len);
+  void (*abs_square_cf)(const cf_t *x, float *z, const int len);
+  void (*lut_sss)(const short *x, const unsigned short *lut, short *y, const int len);
+  void (*lut_bbb)(const int8_t *x, const unsigned short *lut, int8_t *y, const int len);
+  void (*convert_if)(const int16_t *x, float *z, const float scale, const int len);
+  void (*convert_fi)(const float *x, int16_t *z, const float scale, const int len);
+  void (*convert_fb)(const float *x, int8_t *z, const float scale, const int len);
+  void (*cp)(const cf_t *src, cf_t *dst, int len);
+  void (*interleave)(const cf_t *x, const cf_t *y, cf_t *z, const int len);
+  void (*interleave_add)(const cf_t *x, const cf_t *y, cf_t *z, const int len);
+  void (*apply_cfo)(const cf_t *x, float cfo, cf_t *z, int len);
+  uint32_t (*max_fi)(const float *x, const int len);
+  uint32_t (*max_abs_fi)(const float *x, const int len);
+  uint32_t (*max_ci)(const cf_t *x, const int len);
+} srslte_vec_simd_t;
+
+SRSLTE_API extern const srslte_vec_simd_t srslte_vec_simd_default;
+
+#ifdef SRSLTE_DISPATCH_AVX2
+SRSLTE_API extern const srslte_vec_simd_t srslte_vec_simd_avx2;
+#endif /* SRSLTE_DISPATCH_AVX2 */
+
+#ifdef SRSLTE_DISPATCH_AVX512
+SRSLTE_API extern const srslte_vec_simd_t srslte_vec_simd_avx512;
+#endif /* SRSLTE_DISPATCH_AVX512 */
+
 #ifdef __cplusplus
 }
 #endif
@@ -82,6 +82,10 @@ class radio {
   bool tx(void *buffer[SRSLTE_MAX_PORTS], uint32_t nof_samples, srslte_timestamp_t tx_time);
   void tx_end();
   bool rx_now(void *buffer[SRSLTE_MAX_PORTS], uint32_t nof_samples, srslte_timestamp_t *rxd_time);
+
+  // Same as tx() and rx_now() with complex int16 (Q15) buffers, see SRSLTE_RF_C16_SCALE
+  bool tx_c16(void *buffer[SRSLTE_MAX_PORTS], uint32_t nof_samples, srslte_timestamp_t tx_time);
+  bool rx_now_c16(void *buffer[SRSLTE_MAX_PORTS], uint32_t nof_samples, srslte_timestamp_t *rxd_time);
   bool rx_at(void *buffer, uint32_t nof_samples, srslte_timestamp_t rx_time);
 
   void set_tx_gain(float gain);
@@ -125,6 +129,11 @@ class radio {
 
   void save_trace(uint32_t is_eob, srslte_timestamp_t *usrp_time);
 
+  bool rx_multi(void *buffer[SRSLTE_MAX_PORTS], uint32_t nof_samples, srslte_timestamp_t *rxd_time, bool c16);
+  bool tx_multi(void *buffer[SRSLTE_MAX_PORTS], uint32_t nof_samples, srslte_timestamp_t tx_time, bool c16);
+  int  send_multi(void *buffer[SRSLTE_MAX_PORTS], uint32_t nof_samples, srslte_timestamp_t *tx_time,
+                  bool is_start_of_burst_, bool c16);
+
   srslte_rf_t rf_device;
 
   const static uint32_t burst_preamble_max_samples = 13824;
@@ -44,6 +44,7 @@
 #include "srslte/phy/utils/debug.h"
 #include "srslte/phy/utils/cexptab.h"
 #include "srslte/phy/utils/vector.h"
+#include "srslte/phy/utils/cpu_features.h"
 
 #include "srslte/phy/common/timestamp.h"
 #include "srslte/phy/common/sequence.h"
@@ -2912,7 +2912,12 @@ LIBLTE_ERROR_ENUM liblte_mme_unpack_tracking_area_identity_list_ie(uint8
         while(length < sent_length)
         {
             type    = (LIBLTE_MME_TRACKING_AREA_IDENTITY_LIST_TYPE_ENUM)(((*ie_ptr)[length] >> 5) & 0x03);
-            N_elems = (*ie_ptr)[length++] & 0x1F;
+            // Number of elements is coded as N-1 (24.301 section 9.9.3.33)
+            N_elems = ((*ie_ptr)[length++] & 0x1F) + 1;
+            if(N_elems > LIBLTE_MME_TRACKING_AREA_IDENTITY_LIST_MAX_SIZE - tai_list->N_tais)
+            {
+                break;
+            }
             if(LIBLTE_MME_TRACKING_AREA_IDENTITY_LIST_TYPE_ONE_PLMN_NON_CONSECUTIVE_TACS == type)
             {
                 mcc  = ((*ie_ptr)[length] & 0x0F)*100;
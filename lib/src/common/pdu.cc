@@ -413,20 +413,14 @@ int sch_subh::get_bsr(uint32_t buff_size[4])
     if (ce_type()==LONG_BSR) {
       buff_size[0] = (payload[0]&0xFC) >> 2;
       buff_size[1] = (payload[0]&0x03) << 4 | (payload[1]&0xF0) >> 4;
-      buff_size[2] = (payload[1]&0x0F) << 4 | (payload[1]&0xC0) >> 6;
-      buff_size[3] = (payload[2]&0x3F); 
+      buff_size[2] = (payload[1]&0x0F) << 2 | (payload[2]&0xC0) >> 6;
+      buff_size[3] = (payload[2]&0x3F);
     } else {
       nonzero_lcg              = (payload[0]&0xc0) >> 6;
       buff_size[nonzero_lcg%4] =  payload[0]&0x3f;
     }
     for (int i=0;i<4;i++) {
-      if (buff_size[i]) {
-        if (buff_size[i]<63) {
-          buff_size[i] = btable[1+buff_size[i]];
-        } else {
-          buff_size[i] = btable[63];
-        }
-      }
+      buff_size[i] = buff_size_value(buff_size[i]);
     }
     return nonzero_lcg;
   } else {
@@ -511,8 +505,8 @@ bool sch_subh::set_bsr(uint32_t buff_size[4], sch_subh::cetype format)
   uint32_t ce_size = format==LONG_BSR?3:1;
   if (((sch_pdu*)parent)->has_space_ce(ce_size)) {
     if (format==LONG_BSR) {
-      w_payload_ce[0] = (buff_size_table(buff_size[0])&0x3f) << 2 | (buff_size_table(buff_size[1])&0xc0)>>6;
-      w_payload_ce[1] = (buff_size_table(buff_size[1])&0xf)  << 4 | (buff_size_table(buff_size[2])&0xf0)>>4;
+      w_payload_ce[0] = (buff_size_table(buff_size[0])&0x3f) << 2 | (buff_size_table(buff_size[1])&0x30)>>4;
+      w_payload_ce[1] = (buff_size_table(buff_size[1])&0xf)  << 4 | (buff_size_table(buff_size[2])&0x3c)>>2;
       w_payload_ce[2] = (buff_size_table(buff_size[2])&0x3)  << 6 | (buff_size_table(buff_size[3])&0x3f);
     } else {
       w_payload_ce[0] = (nonzero_lcg&0x3)<<6 | (buff_size_table(buff_size[nonzero_lcg])&0x3f);
@@ -775,6 +769,17 @@ uint8_t sch_subh::buff_size_table(uint32_t buffer_size) {
     return 62; 
   }
 }
+
+uint32_t sch_subh::buff_size_value(uint32_t buff_size_idx)
+{
+  if (buff_size_idx == 0) {
+    return 0;
+  } else if (buff_size_idx < 63) {
+    return btable[1+buff_size_idx];
+  } else {
+    return btable[63];
+  }
+}
   
 // Implements Table 9.1.8.4-1 Power headroom report mapping (36.133)
 uint8_t sch_subh::phr_report_table(float phr_value)
@@ -0,0 +1,222 @@
+/**
+ *
+ * \section COPYRIGHT
+ *
+ * Copyright 2013-2015 Software Radio Systems Limited
+ *
+ * \section LICENSE
+ *
+ * This file is part of the srsUE library.
+ *
+ * srsUE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsUE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include "srslte/common/phy_trace.h"
+
+namespace srslte {
+
+/* The counter frequency is measured once against CLOCK_MONOTONIC. The
+ * first sample is also the origin of the trace timeline. */
+static pthread_once_t calibrate_once = PTHREAD_ONCE_INIT;
+static uint64_t       origin_ticks   = 0;
+static double         ticks_per_us   = 1000.0;
+
+static uint64_t monotonic_ns()
+{
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return (uint64_t) t.tv_sec*1000000000 + t.tv_nsec;
+}
+
+static void calibrate()
+{
+  uint64_t ns0 = monotonic_ns();
+  uint64_t t0  = phy_trace::now();
+  usleep(10000);
+  uint64_t ns1 = monotonic_ns();
+  uint64_t t1  = phy_trace::now();
+
+  origin_ticks = t0;
+  if (ns1 > ns0 && t1 > t0) {
+    ticks_per_us = (double) (t1 - t0) * 1000.0 / (double) (ns1 - ns0);
+  }
+}
+
+phy_trace::phy_trace()
+{
+  enabled      = false;
+  wpm          = 0;
+  wrapped      = false;
+  tti          = 0;
+  sf_start     = 0;
+  budget_ticks = 0;
+  sum_ticks    = 0;
+  max_ticks    = 0;
+  nof_sf       = 0;
+  nof_late     = 0;
+  pthread_mutex_init(&mutex, NULL);
+}
+
+phy_trace::~phy_trace()
+{
+  pthread_mutex_destroy(&mutex);
+}
+
+void phy_trace::init(uint32_t nof_events, float budget_us)
+{
+  pthread_once(&calibrate_once, calibrate);
+
+  budget_ticks = us_to_ticks(budget_us);
+  events.resize(nof_events > 0 ? nof_events : 1);
+  wpm          = 0;
+  wrapped      = false;
+}
+
+void phy_trace::set_budget(float budget_us)
+{
+  pthread_mutex_lock(&mutex);
+  budget_ticks = us_to_ticks(budget_us);
+  pthread_mutex_unlock(&mutex);
+}
+
+void phy_trace::start()
+{
+  enabled = true;
+}
+
+void phy_trace::stop()
+{
+  enabled = false;
+}
+
+double phy_trace::ticks_to_us(uint64_t ticks)
+{
+  return (double) ticks / ticks_per_us;
+}
+
+uint64_t phy_trace::us_to_ticks(double us)
+{
+  return (uint64_t) (us * ticks_per_us);
+}
+
+void phy_trace::sf_begin(uint32_t tti_)
+{
+  sf_begin(tti_, now());
+}
+
+void phy_trace::sf_begin(uint32_t tti_, uint64_t t)
+{
+  tti      = tti_;
+  sf_start = t;
+}
+
+bool phy_trace::sf_end()
+{
+  return sf_end(now());
+}
+
+bool phy_trace::sf_end(uint64_t sf_stop)
+{
+  uint64_t ticks   = sf_stop - sf_start;
+  bool     late;
+
+  pthread_mutex_lock(&mutex);
+  sum_ticks += ticks;
+  if (ticks > max_ticks) {
+    max_ticks = ticks;
+  }
+  late = ticks > budget_ticks;
+  if (late) {
+    nof_late++;
+  }
+  nof_sf++;
+  pthread_mutex_unlock(&mutex);
+
+  if (enabled) {
+    push(PHY_TRACE_SF, sf_start, sf_stop);
+  }
+  return late;
+}
+
+void phy_trace::push(phy_trace_stage_t stage, uint64_t begin, uint64_t end)
+{
+  event_t *e = &events[wpm];
+  e->begin = begin;
+  e->end   = end;
+  e->tti   = tti;
+  e->stage = stage;
+  wpm++;
+  if (wpm >= events.size()) {
+    wpm     = 0;
+    wrapped = true;
+  }
+}
+
+void phy_trace::get_metrics(phy_proc_metrics_t *m)
+{
+  pthread_mutex_lock(&mutex);
+  m->avg_us   = nof_sf ? (float) ticks_to_us(sum_ticks / nof_sf) : 0;
+  m->max_us   = (float) ticks_to_us(max_ticks);
+  m->nof_sf   = nof_sf;
+  m->nof_late = nof_late;
+  sum_ticks = 0;
+  max_ticks = 0;
+  nof_sf    = 0;
+  nof_late  = 0;
+  pthread_mutex_unlock(&mutex);
+}
+
+/* Writes the events in the Chrome trace event format, one thread per worker.
+ * Call it once the workers are stopped, the buffers are not locked. */
+bool phy_trace::write_json(std::string filename, std::vector<phy_trace*> &traces)
+{
+  FILE *f = fopen(filename.c_str(), "w");
+  if (f == NULL) {
+    perror("fopen");
+    return false;
+  }
+
+  int  pid   = (int) getpid();
+  bool first = true;
+  fprintf(f, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+  for (uint32_t i = 0; i < traces.size(); i++) {
+    phy_trace *t = traces[i];
+    fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"PHY worker %d\"}}",
+            first ? "" : ",\n", pid, i, i);
+    first = false;
+
+    uint32_t n  = t->wrapped ? t->events.size() : t->wpm;
+    uint32_t st = t->wrapped ? t->wpm : 0;
+    for (uint32_t j = 0; j < n; j++) {
+      event_t *e = &t->events[(st + j) % t->events.size()];
+      if (e->begin < origin_ticks || e->end < e->begin) {
+        continue;
+      }
+      fprintf(f, ",\n{\"name\":\"%s\",\"cat\":\"phy\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+                 "\"pid\":%d,\"tid\":%d,\"args\":{\"tti\":%d}}",
+              phy_trace_stage_text[e->stage], ticks_to_us(e->begin - origin_ticks), ticks_to_us(e->end - e->begin),
+              pid, i, e->tti);
+    }
+  }
+  fprintf(f, "\n]}\n");
+  fclose(f);
+  return true;
+}
+
+} // namespace srslte
@@ -0,0 +1,408 @@
+/**
+ *
+ * \section COPYRIGHT
+ *
+ * Copyright 2013-2015 Software Radio Systems Limited
+ *
+ * \section LICENSE
+ *
+ * This file is part of the srsUE library.
+ *
+ * srsUE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsUE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <strings.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "srslte/common/sch_pdu_codec.h"
+
+namespace srslte {
+
+/* Element readers. Section 6.1.3 */
+
+uint16_t sch_pdu_elem::get_c_rnti()
+{
+  return (uint16_t) payload[0]<<8 | payload[1];
+}
+
+uint64_t sch_pdu_elem::get_con_res_id()
+{
+  return ((uint64_t) payload[5]) | (((uint64_t) payload[4])<<8) | (((uint64_t) payload[3])<<16) |
+         (((uint64_t) payload[2])<<24) | (((uint64_t) payload[1])<<32) | (((uint64_t) payload[0])<<40);
+}
+
+uint8_t sch_pdu_elem::get_ta_cmd()
+{
+  return (uint8_t) payload[0]&0x3f;
+}
+
+float sch_pdu_elem::get_phr()
+{
+  return (float) (payload[0]&0x3f) - 23;
+}
+
+int sch_pdu_elem::get_bsr(uint32_t buff_size[4])
+{
+  uint32_t nonzero_lcg = 0;
+  if (lcid == sch_subh::LONG_BSR) {
+    buff_size[0] = (payload[0]&0xFC) >> 2;
+    buff_size[1] = (payload[0]&0x03) << 4 | (payload[1]&0xF0) >> 4;
+    buff_size[2] = (payload[1]&0x0F) << 2 | (payload[2]&0xC0) >> 6;
+    buff_size[3] = (payload[2]&0x3F);
+  } else {
+    nonzero_lcg              = (payload[0]&0xc0) >> 6;
+    buff_size[nonzero_lcg%4] =  payload[0]&0x3f;
+  }
+  for (int i=0;i<4;i++) {
+    buff_size[i] = sch_subh::buff_size_value(buff_size[i]);
+  }
+  return nonzero_lcg;
+}
+
+
+/* Encoder. Produces the same layout as sch_pdu::write_packet(): padding of one or two bytes, CE subheaders,
+ * SDU subheaders, multi-byte padding subheader, CE payloads, SDU payloads and padding. Unlike sch_pdu,
+ * the space reserved for headers also fits a TB full of SDUs of 128 bytes or more. */
+
+sch_pdu_encoder::sch_pdu_encoder(uint32_t max_subh_) : ces(max_subh_), sdus(max_subh_), ce_buffer(max_subh_*MAX_CE_LEN)
+{
+  max_subh = max_subh_;
+  init(NULL, 0);
+}
+
+void sch_pdu_encoder::init(uint8_t *buffer_, uint32_t pdu_len_)
+{
+  buffer           = buffer_;
+  pdu_len          = pdu_len_;
+  rem_len          = pdu_len_;
+  nof_ce           = 0;
+  nof_sdu          = 0;
+  total_sdu_len    = 0;
+  sdu_header_len   = 0;
+  sdu_offset_start = max_subh*(3 + MAX_CE_LEN); // Worst case of 3-byte subheaders or CEs only
+}
+
+bool sch_pdu_encoder::has_space_subh()
+{
+  return nof_ce + nof_sdu < max_subh - 1 && rem_len > 0;
+}
+
+// The last SDU is assumed to take a 1-byte subheader until another SDU follows it
+int sch_pdu_encoder::get_sdu_space()
+{
+  if (nof_sdu == 0) {
+    return rem_len - 1;
+  } else {
+    return rem_len - (sch_pdu::size_header_sdu(sdus[nof_sdu-1].nof_bytes)-1) - 1;
+  }
+}
+
+void sch_pdu_encoder::commit_sdu(uint32_t lcid, uint32_t nof_bytes)
+{
+  if (nof_sdu > 0) {
+    rem_len -= sch_pdu::size_header_sdu(sdus[nof_sdu-1].nof_bytes)-1;
+  }
+  rem_len -= nof_bytes+1;
+
+  sch_pdu_elem *e = &sdus[nof_sdu++];
+  e->lcid      = lcid;
+  e->nof_bytes = nof_bytes;
+  e->payload   = &buffer[sdu_offset_start+total_sdu_len];
+
+  total_sdu_len  += nof_bytes;
+  sdu_header_len += sch_pdu::size_header_sdu(nof_bytes);
+}
+
+int sch_pdu_encoder::add_sdu(uint32_t lcid, uint32_t requested_bytes, read_pdu_interface *sdu_itf)
+{
+  int space = get_sdu_space();
+  if (!has_space_subh() || space < 0 || (uint32_t) space < requested_bytes) {
+    return -1;
+  }
+  int sdu_sz = sdu_itf->read_pdu(lcid, &buffer[sdu_offset_start+total_sdu_len], requested_bytes);
+  if (sdu_sz <= 0) {
+    return sdu_sz;
+  }
+  if ((uint32_t) sdu_sz > requested_bytes) {
+    return -1;
+  }
+  commit_sdu(lcid, sdu_sz);
+  return sdu_sz;
+}
+
+int sch_pdu_encoder::add_sdu(uint32_t lcid, uint32_t nof_bytes, uint8_t *payload)
+{
+  int space = get_sdu_space();
+  if (!has_space_subh() || space < 0 || (uint32_t) space < nof_bytes) {
+    return -1;
+  }
+  if (nof_bytes == 0) {
+    return 0;
+  }
+  memcpy(&buffer[sdu_offset_start+total_sdu_len], payload, nof_bytes);
+  commit_sdu(lcid, nof_bytes);
+  return nof_bytes;
+}
+
+// Returns where to write the CE payload, or NULL if there is no space
+uint8_t* sch_pdu_encoder::new_ce(uint32_t lcid, uint32_t nof_bytes)
+{
+  if (!has_space_subh() || rem_len < (int) nof_bytes + 1) {
+    return NULL;
+  }
+  rem_len -= nof_bytes + 1;
+
+  sch_pdu_elem *e = &ces[nof_ce];
+  e->lcid      = lcid;
+  e->nof_bytes = nof_bytes;
+  e->payload   = &ce_buffer[nof_ce*MAX_CE_LEN];
+  nof_ce++;
+  return e->payload;
+}
+
+bool sch_pdu_encoder::add_c_rnti(uint16_t crnti)
+{
+  uint8_t *ptr = new_ce(sch_subh::CRNTI, 2);
+  if (ptr) {
+    ptr[0] = (uint8_t) ((crnti&0xff00)>>8);
+    ptr[1] = (uint8_t) ((crnti&0x00ff));
+  }
+  return ptr != NULL;
+}
+
+bool sch_pdu_encoder::add_bsr(uint32_t buff_size[4], sch_subh::cetype format)
+{
+  uint8_t *ptr = new_ce(format, format==sch_subh::LONG_BSR?3:1);
+  if (ptr) {
+    if (format == sch_subh::LONG_BSR) {
+      uint8_t bs[4];
+      for (int i=0;i<4;i++) {
+        bs[i] = sch_subh::buff_size_table(buff_size[i])&0x3f;
+      }
+      ptr[0] = bs[0]<<2        | bs[1]>>4;
+      ptr[1] = (bs[1]&0xf)<<4  | bs[2]>>2;
+      ptr[2] = (bs[2]&0x3)<<6  | bs[3];
+    } else {
+      uint32_t nonzero_lcg = 0;
+      for (int i=0;i<4;i++) {
+        if (buff_size[i]) {
+          nonzero_lcg = i;
+        }
+      }
+      ptr[0] = (nonzero_lcg&0x3)<<6 | (sch_subh::buff_size_table(buff_size[nonzero_lcg])&0x3f);
+    }
+  }
+  return ptr != NULL;
+}
+
+bool sch_pdu_encoder::add_con_res_id(uint64_t con_res_id)
+{
+  uint8_t *ptr = new_ce(sch_subh::CON_RES_ID, sch_subh::MAC_CE_CONTRES_LEN);
+  if (ptr) {
+    for (int i=0;i<sch_subh::MAC_CE_CONTRES_LEN;i++) {
+      ptr[i] = (uint8_t) ((con_res_id >> (8*(sch_subh::MAC_CE_CONTRES_LEN-1-i)))&0xff);
+    }
+  }
+  return ptr != NULL;
+}
+
+bool sch_pdu_encoder::add_ta_cmd(uint8_t ta_cmd)
+{
+  uint8_t *ptr = new_ce(sch_subh::TA_CMD, 1);
+  if (ptr) {
+    ptr[0] = ta_cmd&0x3f;
+  }
+  return ptr != NULL;
+}
+
+bool sch_pdu_encoder::add_phr(float phr)
+{
+  uint8_t *ptr = new_ce(sch_subh::PHR_REPORT, 1);
+  if (ptr) {
+    ptr[0] = sch_subh::phr_report_table(phr)&0x3f;
+  }
+  return ptr != NULL;
+}
+
+/* The header size is known before writing anything, so the subheaders and the CE payloads are written
+ * in one pass right before the SDUs. Section 6.1.2 */
+uint8_t* sch_pdu_encoder::write_packet(srslte::log *log_h)
+{
+  if (nof_ce + nof_sdu == 0 || rem_len < 0) {
+    if (log_h) {
+      log_h->error("Trying to write packet with %d subheaders and rem_len=%d\n", nof_ce + nof_sdu, rem_len);
+    }
+    return NULL;
+  }
+
+  bool     ce_only        = nof_sdu == 0;
+  bool     multibyte_pad  = rem_len > 2;
+  uint32_t onetwo_padding = multibyte_pad ? 0 : rem_len;
+  uint32_t padding_len    = 0;
+  uint32_t last_sdu_hdr   = ce_only ? 0 : sch_pdu::size_header_sdu(sdus[nof_sdu-1].nof_bytes);
+
+  uint32_t header_sz = nof_ce + sdu_header_len;
+  if (multibyte_pad) {
+    // Padding subheader and full subheader for the last SDU
+    padding_len = rem_len - 1 - (ce_only ? 0 : last_sdu_hdr - 1);
+    header_sz  += 1;
+  } else {
+    header_sz  += onetwo_padding - (ce_only ? 0 : last_sdu_hdr - 1);
+  }
+  uint32_t ce_payload_sz = pdu_len - total_sdu_len - padding_len - header_sz;
+
+  if (header_sz + ce_payload_sz >= sdu_offset_start) {
+    if (log_h) {
+      log_h->error("Writing PDU: header sz + ce_payload_sz >= sdu_offset_start (%d>=%d). pdu_len=%d, total_sdu_len=%d\n",
+                   header_sz + ce_payload_sz, sdu_offset_start, pdu_len, total_sdu_len);
+    }
+    return NULL;
+  }
+
+  uint8_t *pdu_start_ptr = &buffer[sdu_offset_start-header_sz-ce_payload_sz];
+  uint8_t *ptr           = pdu_start_ptr;
+  uint8_t *ce_ptr        = &buffer[sdu_offset_start-ce_payload_sz];
+
+  for (uint32_t i=0;i<onetwo_padding;i++) {
+    *ptr++ = (1<<5) | sch_subh::PADDING;
+  }
+  for (uint32_t i=0;i<nof_ce;i++) {
+    bool is_last = ce_only && !multibyte_pad && i == nof_ce-1;
+    *ptr++ = (is_last?0:(1<<5)) | (ces[i].lcid&0x1f);
+    memcpy(ce_ptr, ces[i].payload, ces[i].nof_bytes);
+    ce_ptr += ces[i].nof_bytes;
+  }
+  for (uint32_t i=0;i<nof_sdu;i++) {
+    uint32_t n = sdus[i].nof_bytes;
+    if (!multibyte_pad && i == nof_sdu-1) {
+      *ptr++ = sdus[i].lcid&0x1f;
+    } else if (n >= 128) {
+      *ptr++ = (1<<5) | (sdus[i].lcid&0x1f);
+      *ptr++ = (1<<7) | ((n&0x7f00)>>8);
+      *ptr++ = n&0xff;
+    } else {
+      *ptr++ = (1<<5) | (sdus[i].lcid&0x1f);
+      *ptr++ = n&0x7f;
+    }
+  }
+  if (multibyte_pad) {
+    *ptr++ = sch_subh::PADDING;
+  }
+  if (padding_len > 0) {
+    bzero(&pdu_start_ptr[pdu_len-padding_len], padding_len);
+  }
+
+  if (log_h) {
+    log_h->debug("Wrote PDU: pdu_len=%d, header_and_ce=%d (%d+%d), nof_subh=%d, sdu_len=%d, onepad=%d, multi=%d\n",
+                 pdu_len, header_sz+ce_payload_sz, header_sz, ce_payload_sz,
+                 nof_ce + nof_sdu, total_sdu_len, onetwo_padding, padding_len);
+  }
+  return pdu_start_ptr;
+}
+
+
+/* Decoder */
+
+sch_pdu_decoder::sch_pdu_decoder(uint32_t max_subh_) : elems(max_subh_)
+{
+  max_subh  = max_subh_;
+  nof_elems = 0;
+  cur_idx   = -1;
+}
+
+uint32_t sch_pdu_decoder::ce_size(uint32_t lcid, bool is_ul)
+{
+  if (is_ul) {
+    switch(lcid) {
+      case sch_subh::PHR_REPORT:
+      case sch_subh::TRUNC_BSR:
+      case sch_subh::SHORT_BSR:
+        return 1;
+      case sch_subh::CRNTI:
+        return 2;
+      case sch_subh::LONG_BSR:
+        return 3;
+    }
+  } else {
+    switch(lcid) {
+      case sch_subh::CON_RES_ID:
+        return sch_subh::MAC_CE_CONTRES_LEN;
+      case sch_subh::TA_CMD:
+        return 1;
+    }
+  }
+  return 0;
+}
+
+/* Subheaders are read in one pass checking the bounds of the PDU. The last subheader takes the
+ * bytes not claimed by the others. Padding subheaders other than the last are skipped, thus a PDU
+ * written by sch_pdu_encoder with the same max_subh always fits. Section 6.1.2 */
+bool sch_pdu_decoder::parse_packet(uint8_t *ptr, uint32_t pdu_len, bool is_ul)
+{
+  uint8_t *end         = ptr + pdu_len;
+  uint32_t payload_len = 0;
+  bool     e_bit       = true;
+
+  nof_elems = 0;
+  cur_idx   = -1;
+  while (e_bit) {
+    if (nof_elems >= max_subh || ptr >= end) {
+      nof_elems = 0;
+      return false;
+    }
+    sch_pdu_elem *e = &elems[nof_elems];
+    e_bit        = (*ptr & 0x20) ? true : false;
+    e->lcid      = *ptr & 0x1f;
+    e->nof_bytes = 0;
+    ptr++;
+    if (e->lcid < sch_subh::PHR_REPORT) {
+      if (e_bit) {
+        if (ptr >= end || ((*ptr & 0x80) && ptr + 1 >= end)) {
+          nof_elems = 0;
+          return false;
+        }
+        e->nof_bytes = *ptr & 0x7f;
+        if (*ptr++ & 0x80) {
+          e->nof_bytes = e->nof_bytes<<8 | *ptr++;
+        }
+      }
+    } else {
+      e->nof_bytes = ce_size(e->lcid, is_ul);
+    }
+    if (e_bit) {
+      payload_len += e->nof_bytes;
+    }
+    // One and two byte padding carries nothing, so it does not take an element
+    if (!e_bit || e->lcid != sch_subh::PADDING) {
+      nof_elems++;
+    }
+  }
+
+  if (ptr + payload_len > end) {
+    nof_elems = 0;
+    return false;
+  }
+  elems[nof_elems-1].nof_bytes = end - ptr - payload_len;
+
+  for (uint32_t i=0;i<nof_elems;i++) {
+    elems[i].payload = ptr;
+    ptr += elems[i].nof_bytes;
+  }
+  return true;
+}
+
+} // namespace srslte
@@ -0,0 +1,134 @@
+/**
+ *
+ * \section COPYRIGHT
+ *
+ * Copyright 2013-2015 Software Radio Systems Limited
+ *
+ * \section LICENSE
+ *
+ * This file is part of the srsUE library.
+ *
+ * srsUE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsUE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "srslte/common/tx_reorder.h"
+
+namespace srslte {
+
+tx_reorder::tx_reorder()
+{
+  handler    = NULL;
+  nof_slots  = 0;
+  nof_ports  = 0;
+  slot_bytes = 0;
+  next_seq   = 0;
+  running    = false;
+  sem_init(&ready_sem, 0, 0);
+}
+
+tx_reorder::~tx_reorder()
+{
+  stop();
+  for (uint32_t i=0;i<slots.size();i++) {
+    for (uint32_t p=0;p<nof_ports;p++) {
+      if (slots[i].buffer[p]) {
+        free(slots[i].buffer[p]);
+      }
+    }
+  }
+  sem_destroy(&ready_sem);
+}
+
+bool tx_reorder::init(tx_reorder_handler *handler_, uint32_t nof_slots_, uint32_t nof_ports_, uint32_t slot_bytes_, int prio)
+{
+  handler    = handler_;
+  nof_ports  = nof_ports_ < SRSLTE_MAX_PORTS ? nof_ports_ : SRSLTE_MAX_PORTS;
+  slot_bytes = slot_bytes_;
+
+  // A power of two keeps seq%nof_slots continuous when the sequence number wraps
+  nof_slots = 1;
+  while (nof_slots < nof_slots_) {
+    nof_slots <<= 1;
+  }
+
+  slots.resize(nof_slots);
+  slot_seq.resize(nof_slots);
+  for (uint32_t i=0;i<nof_slots;i++) {
+    bzero(&slots[i], sizeof(tx_reorder_slot_t));
+    for (uint32_t p=0;p<nof_ports;p++) {
+      if (posix_memalign(&slots[i].buffer[p], 64, slot_bytes)) {
+        slots[i].buffer[p] = NULL;
+        fprintf(stderr, "Error allocating memory\n");
+        return false;
+      }
+      bzero(slots[i].buffer[p], slot_bytes);
+    }
+    // Not ready for the first number that maps to the slot
+    slot_seq[i] = i - nof_slots;
+  }
+  next_seq = 0;
+
+  running = true;
+  start(prio);
+  return true;
+}
+
+void tx_reorder::stop()
+{
+  if (running) {
+    __atomic_store_n(&running, false, __ATOMIC_RELEASE);
+    sem_post(&ready_sem);
+    wait_thread_finish();
+  }
+}
+
+tx_reorder_slot_t* tx_reorder::get_slot(uint32_t seq)
+{
+  // Waiting here means the radio is nof_slots subframes behind, so a short poll is enough
+  while ((uint32_t) (seq - __atomic_load_n(&next_seq, __ATOMIC_ACQUIRE)) >= nof_slots &&
+         __atomic_load_n(&running, __ATOMIC_ACQUIRE)) {
+    usleep(SLOT_WAIT_US);
+  }
+  return &slots[seq & (nof_slots-1)];
+}
+
+void tx_reorder::push(uint32_t seq)
+{
+  __atomic_store_n(&slot_seq[seq & (nof_slots-1)], seq, __ATOMIC_RELEASE);
+  sem_post(&ready_sem);
+}
+
+/* Slots may be published out of order, so a wake up does not always find the next one ready.
+ * Every push posts the semaphore after publishing, thus the thread never sleeps on a ready slot. */
+void tx_reorder::run_thread()
+{
+  while (__atomic_load_n(&running, __ATOMIC_ACQUIRE)) {
+    uint32_t idx = next_seq & (nof_slots-1);
+    if (__atomic_load_n(&slot_seq[idx], __ATOMIC_ACQUIRE) == next_seq) {
+      handler->tx_slot(next_seq, &slots[idx]);
+      __atomic_store_n(&next_seq, next_seq + 1, __ATOMIC_RELEASE);
+    } else {
+      sem_wait(&ready_sem);
+    }
+  }
+}
+
+} // namespace srslte
@@ -40,6 +40,7 @@
 #include "srslte/phy/ch_estimation/chest_dl.h"
 #include "srslte/phy/utils/vector.h"
 #include "srslte/phy/utils/convolution.h"
+#include "srslte/phy/utils/simd.h"
 
 //#define DEFAULT_FILTER_LEN 3
 
@@ -155,6 +156,8 @@ int srslte_chest_dl_init(srslte_chest_dl_t *q, uint32_t max_prb)
 
     q->rsrp_neighbour = false;
     q->average_subframe = false;
+    q->meas_sf_mask = (1 << 10) - 1;
+    q->interp_plan = false;
     q->smooth_filter_auto = false;
     q->smooth_filter_len = 3; 
     srslte_chest_dl_set_smooth_filter3_coeff(q, 0.1);
@@ -204,6 +207,14 @@ void srslte_chest_dl_free(srslte_chest_dl_t *q)
   if (q->pilot_recv_signal) {
     free(q->pilot_recv_signal);
   }
+  for (int i = 0; i < 3; i++) {
+    if (q->freq_plan[i].coeff) {
+      free(q->freq_plan[i].coeff);
+    }
+    if (q->freq_plan[i].rep) {
+      free(q->freq_plan[i].rep);
+    }
+  }
   bzero(q, sizeof(srslte_chest_dl_t));
 }
 
@@ -226,6 +237,166 @@ int srslte_chest_dl_set_mbsfn_area_id(srslte_chest_dl_t *q, uint16_t mbsfn_area_
   return SRSLTE_ERROR;
 }
 
+/* Pilots are smoothed as in average_pilots() */
+static uint32_t chest_dl_smooth_filter_len(srslte_chest_dl_t *q)
+{
+  if (q->smooth_filter_len == 0 || (q->smooth_filter_len == 3 && q->smooth_filter[0] == 0)) {
+    return 0;
+  }
+  return q->smooth_filter_len;
+}
+
+static int floor_div(int a, int b)
+{
+  return (a >= 0) ? a / b : -((b - 1 - a) / b);
+}
+
+/* The smoothing and the interpolation are linear, so the plan is found by running them on impulses.
+ * A RE depends on the pilots up to filter_len + 2 positions away, so impulses spaced more than twice
+ * that apart do not overlap and all the coefficients are found in 2 * (filter_len + 2) + 1 runs */
+static int freq_plan_build(srslte_chest_dl_freq_plan_t *p, srslte_interp_lin_t *interp, uint32_t offset,
+                           float *filter, uint32_t filter_len)
+{
+  uint32_t nof_ref = interp->vector_len;
+  uint32_t spacing = interp->M;
+  uint32_t nof_re  = nof_ref * spacing;
+  int      R       = filter_len + 2;
+  int      D       = 2 * R + 1;
+  int      ret     = SRSLTE_ERROR;
+
+  cf_t  *in    = srslte_vec_malloc(sizeof(cf_t) * nof_ref * 2);
+  cf_t  *out   = srslte_vec_malloc(sizeof(cf_t) * nof_re);
+  float *dense = srslte_vec_malloc(sizeof(float) * nof_re * D);
+  if (!in || !out || !dense) {
+    perror("malloc");
+    goto clean_exit;
+  }
+  bzero(dense, sizeof(float) * nof_re * D);
+
+  for (int r = 0; r < D; r++) {
+    for (int m = 0; m < nof_ref; m++) {
+      in[m] = (m % D == r) ? 1.0f : 0.0f;
+    }
+    cf_t *pilots = in;
+    if (filter_len) {
+      srslte_conv_same_cf(in, filter, &in[nof_ref], nof_ref, filter_len);
+      pilots = &in[nof_ref];
+    }
+    srslte_interp_linear_offset(interp, pilots, out, offset, spacing - offset);
+
+    for (int k = 0; k < nof_re; k++) {
+      int c = floor_div(k - (int) offset, spacing);
+      int m = c - R + ((r - (c - R)) % D + D) % D;
+      if (m >= 0 && m < nof_ref) {
+        dense[k * D + m - c + R] = crealf(out[k]);
+      }
+    }
+  }
+
+  /* Narrowest window, in pilots relative to the one at or below each RE, that covers all rows */
+  int first = D;
+  int last  = 0;
+  for (int k = 0; k < nof_re; k++) {
+    for (int i = 0; i < D; i++) {
+      if (dense[k * D + i] != 0.0f) {
+        first = SRSLTE_MIN(first, i);
+        last  = SRSLTE_MAX(last, i);
+      }
+    }
+  }
+  if (first > last) {
+    first = last = R;
+  }
+
+  if (p->coeff) {
+    free(p->coeff);
+  }
+  if (p->rep) {
+    free(p->rep);
+  }
+  p->nof_ref  = nof_ref;
+  p->spacing  = spacing;
+  p->offset   = offset;
+  p->lead     = R - first;
+  p->nof_taps = last - first + 1;
+  p->coeff    = srslte_vec_malloc(sizeof(float) * p->nof_taps * nof_re * 2);
+  p->rep      = srslte_vec_malloc(sizeof(cf_t) * (nof_re + (p->nof_taps - 1) * spacing));
+  if (!p->coeff || !p->rep) {
+    perror("malloc");
+    goto clean_exit;
+  }
+  for (int t = 0; t < p->nof_taps; t++) {
+    for (int k = 0; k < nof_re; k++) {
+      p->coeff[2 * (t * nof_re + k)]     = dense[k * D + first + t];
+      p->coeff[2 * (t * nof_re + k) + 1] = dense[k * D + first + t];
+    }
+  }
+  ret = SRSLTE_SUCCESS;
+
+clean_exit:
+  if (in) {
+    free(in);
+  }
+  if (out) {
+    free(out);
+  }
+  if (dense) {
+    free(dense);
+  }
+  return ret;
+}
+
+static void time_plan_build(srslte_chest_dl_time_plan_t *p, srslte_cp_t cp, uint32_t port_id)
+{
+  p->nof_ref = srslte_refsignal_cs_nof_symbols(port_id);
+  for (uint32_t l = 0; l < p->nof_ref; l++) {
+    p->ref_symbol[l] = srslte_refsignal_cs_nsymbol(l, cp, port_id);
+  }
+
+  uint32_t r = 0;
+  p->nof_symbols = 0;
+  for (uint32_t l = 0; l < 2 * SRSLTE_CP_NSYMB(cp); l++) {
+    if (r < p->nof_ref && l == p->ref_symbol[r]) {
+      r++;
+    } else {
+      // Interpolate between the pilot symbols around, or extrapolate from the closest two
+      uint32_t r1 = (r == 0) ? 1 : ((r == p->nof_ref) ? p->nof_ref - 1 : r);
+      uint32_t r0 = r1 - 1;
+      uint32_t i  = p->nof_symbols++;
+      p->symbol[i] = l;
+      p->ref0[i]   = r0;
+      p->ref1[i]   = r1;
+      p->weight[i] = ((float) l - p->ref_symbol[r0]) / (p->ref_symbol[r1] - p->ref_symbol[r0]);
+    }
+  }
+}
+
+/* Builds the plans for the current cell, or rebuilds them if the smoothing filter changed */
+static int chest_dl_plan_update(srslte_chest_dl_t *q)
+{
+  uint32_t filter_len = chest_dl_smooth_filter_len(q);
+
+  if (q->plan_ready && q->plan_filter_len == filter_len &&
+      !memcmp(q->plan_filter, q->smooth_filter, sizeof(float) * filter_len)) {
+    return SRSLTE_SUCCESS;
+  }
+
+  q->plan_ready = false;
+  uint32_t v_shift = q->cell.id % 6;
+  if (freq_plan_build(&q->freq_plan[0], &q->srslte_interp_lin, v_shift, q->smooth_filter, filter_len) ||
+      freq_plan_build(&q->freq_plan[1], &q->srslte_interp_lin, (v_shift + 3) % 6, q->smooth_filter, filter_len) ||
+      freq_plan_build(&q->freq_plan[2], &q->srslte_interp_lin_3, q->cell.id % 3, q->smooth_filter, filter_len)) {
+    return SRSLTE_ERROR;
+  }
+  time_plan_build(&q->time_plan[0], q->cell.cp, 0);
+  time_plan_build(&q->time_plan[1], q->cell.cp, 2);
+
+  memcpy(q->plan_filter, q->smooth_filter, sizeof(float) * filter_len);
+  q->plan_filter_len = filter_len;
+  q->plan_ready      = true;
+  return SRSLTE_SUCCESS;
+}
+
 int srslte_chest_dl_set_cell(srslte_chest_dl_t *q, srslte_cell_t cell)
 {
   int ret = SRSLTE_ERROR_INVALID_INPUTS;
@@ -258,6 +429,12 @@ int srslte_chest_dl_set_cell(srslte_chest_dl_t *q, srslte_cell_t cell)
         return SRSLTE_ERROR;
       }
 
+      q->plan_ready = false;
+      if (q->interp_plan && chest_dl_plan_update(q)) {
+        fprintf(stderr, "Error computing the interpolation plan\n");
+        return SRSLTE_ERROR;
+      }
+
     }
     ret = SRSLTE_SUCCESS;
   }
@@ -566,6 +743,104 @@ static void average_pilots(srslte_chest_dl_t *q, cf_t *input, cf_t *output, uint
   }
 }
 
+/* The coefficients are real, so the kernels run on the interleaved real and imaginary parts */
+static void freq_plan_apply(srslte_chest_dl_freq_plan_t *p, cf_t *pilots, cf_t *output)
+{
+  uint32_t nof_re = p->nof_ref * p->spacing;
+  uint32_t len    = nof_re + (p->nof_taps - 1) * p->spacing;
+  cf_t    *rep    = p->rep;
+
+  /* rep[k + t * spacing] is the pilot multiplied by the coefficient t of RE k */
+  int      j   = -1 - (int) p->lead;
+  uint32_t n   = 0;
+  uint32_t end = p->offset;
+  while (n < len) {
+    cf_t v = (j >= 0 && j < p->nof_ref) ? pilots[j] : 0;
+    for (; n < end && n < len; n++) {
+      rep[n] = v;
+    }
+    end += p->spacing;
+    j++;
+  }
+
+  float   *x = (float *) rep;
+  float   *y = (float *) output;
+  uint32_t i = 0;
+#if SRSLTE_SIMD_F_SIZE
+  for (; i + SRSLTE_SIMD_F_SIZE < 2 * nof_re + 1; i += SRSLTE_SIMD_F_SIZE) {
+    simd_f_t acc = srslte_simd_f_zero();
+    for (uint32_t t = 0; t < p->nof_taps; t++) {
+      simd_f_t a = srslte_simd_f_loadu(&x[i + 2 * t * p->spacing]);
+      simd_f_t c = srslte_simd_f_loadu(&p->coeff[2 * t * nof_re + i]);
+      acc = srslte_simd_f_add(acc, srslte_simd_f_mul(a, c));
+    }
+    srslte_simd_f_storeu(&y[i], acc);
+  }
+#endif /* SRSLTE_SIMD_F_SIZE */
+
+  for (; i < 2 * nof_re; i++) {
+    float acc = 0;
+    for (uint32_t t = 0; t < p->nof_taps; t++) {
+      acc += x[i + 2 * t * p->spacing] * p->coeff[2 * t * nof_re + i];
+    }
+    y[i] = acc;
+  }
+}
+
+/* All the symbols are computed while the pilot symbols are in registers */
+static void time_plan_apply(srslte_chest_dl_time_plan_t *p, cf_t *ce, uint32_t nof_re)
+{
+  float   *x   = (float *) ce;
+  uint32_t len = 2 * nof_re;
+  uint32_t i   = 0;
+#if SRSLTE_SIMD_F_SIZE
+  for (; i + SRSLTE_SIMD_F_SIZE < len + 1; i += SRSLTE_SIMD_F_SIZE) {
+    simd_f_t ref[SRSLTE_CHEST_DL_MAX_REF_SYMBOLS];
+    for (uint32_t r = 0; r < p->nof_ref; r++) {
+      ref[r] = srslte_simd_f_loadu(&x[p->ref_symbol[r] * len + i]);
+    }
+    for (uint32_t s = 0; s < p->nof_symbols; s++) {
+      simd_f_t a = ref[p->ref0[s]];
+      simd_f_t d = srslte_simd_f_sub(ref[p->ref1[s]], a);
+      simd_f_t y = srslte_simd_f_add(a, srslte_simd_f_mul(d, srslte_simd_f_set1(p->weight[s])));
+      srslte_simd_f_storeu(&x[p->symbol[s] * len + i], y);
+    }
+  }
+#endif /* SRSLTE_SIMD_F_SIZE */
+
+  for (; i < len; i++) {
+    for (uint32_t s = 0; s < p->nof_symbols; s++) {
+      float a = x[p->ref_symbol[p->ref0[s]] * len + i];
+      float b = x[p->ref_symbol[p->ref1[s]] * len + i];
+      x[p->symbol[s] * len + i] = a + (b - a) * p->weight[s];
+    }
+  }
+}
+
+static void interpolate_pilots_plan(srslte_chest_dl_t *q, cf_t *ce, uint32_t port_id)
+{
+  uint32_t nof_re = q->cell.nof_prb * SRSLTE_NRE;
+
+  if (q->average_subframe) {
+    srslte_chest_dl_interleave_pilots(q, q->pilot_estimates, q->pilot_estimates_average, q->pilot_estimates,
+                                      port_id, SRSLTE_SF_NORM);
+    freq_plan_apply(&q->freq_plan[2], q->pilot_estimates, ce);
+    for (uint32_t l = 1; l < 2 * SRSLTE_CP_NSYMB(q->cell.cp); l++) {
+      memcpy(&ce[l * nof_re], ce, sizeof(cf_t) * nof_re);
+    }
+  } else {
+    srslte_chest_dl_time_plan_t *t = &q->time_plan[port_id / 2];
+    uint32_t nof_ref = 2 * q->cell.nof_prb;
+
+    for (uint32_t l = 0; l < t->nof_ref; l++) {
+      uint32_t fidx = srslte_refsignal_cs_fidx(q->cell, l, port_id, 0);
+      srslte_chest_dl_freq_plan_t *p = (fidx == q->freq_plan[0].offset) ? &q->freq_plan[0] : &q->freq_plan[1];
+      freq_plan_apply(p, &q->pilot_estimates[l * nof_ref], &ce[t->ref_symbol[l] * nof_re]);
+    }
+    time_plan_apply(t, ce, nof_re);
+  }
+}
+
 float srslte_chest_dl_rssi(srslte_chest_dl_t *q, cf_t *input, uint32_t port_id) {
   uint32_t l;
   
@@ -607,8 +882,10 @@ void chest_interpolate_noise_est(srslte_chest_dl_t *q, cf_t *input, cf_t *ce, ui
     q->cfo = chest_estimate_cfo(q);
   }
 
+  bool meas = (q->meas_sf_mask & (1 << sf_idx)) != 0;
+
   /* Estimate noise */
-  if (q->noise_alg == SRSLTE_NOISE_ALG_REFS && ch_mode != SRSLTE_SF_MBSFN ) {
+  if (meas && q->noise_alg == SRSLTE_NOISE_ALG_REFS && ch_mode != SRSLTE_SF_MBSFN ) {
     q->noise_estimate[rxant_id][port_id] = estimate_noise_pilots(q, port_id, ch_mode);
   }
 
@@ -618,7 +895,9 @@ void chest_interpolate_noise_est(srslte_chest_dl_t *q, cf_t *input, cf_t *ce, ui
     }
 
     /* Smooth estimates (if applicable) and interpolate */
-    if (q->smooth_filter_len == 0 || (q->smooth_filter_len == 3 && q->smooth_filter[0] == 0)) {
+    if (q->interp_plan && !q->smooth_filter_auto && ch_mode != SRSLTE_SF_MBSFN && !chest_dl_plan_update(q)) {
+      interpolate_pilots_plan(q, ce, port_id);
+    } else if (!chest_dl_smooth_filter_len(q)) {
       interpolate_pilots(q, q->pilot_estimates, ce, port_id, ch_mode);
     } else {
       average_pilots(q, q->pilot_estimates, q->pilot_estimates_average, port_id, ch_mode);
@@ -626,7 +905,9 @@ void chest_interpolate_noise_est(srslte_chest_dl_t *q, cf_t *input, cf_t *ce, ui
     }
   
     /* Estimate noise power */
-    if (q->noise_alg == SRSLTE_NOISE_ALG_PSS) {
+    if (!meas) {
+      // Keep the last estimate
+    } else if (q->noise_alg == SRSLTE_NOISE_ALG_PSS) {
       if (sf_idx == 0 || sf_idx == 5) {
         q->noise_estimate[rxant_id][port_id] = estimate_noise_pss(q, input, ce);
       }
@@ -638,7 +919,10 @@ void chest_interpolate_noise_est(srslte_chest_dl_t *q, cf_t *input, cf_t *ce, ui
   }
 }
 
-int srslte_chest_dl_estimate_port(srslte_chest_dl_t *q, cf_t *input, cf_t *ce, uint32_t sf_idx, uint32_t port_id, uint32_t rxant_id)
+/* Ports 0 and 1, and ports 2 and 3, have pilots in the same symbols, so the second port of each pair
+ * can take the RSSI of the first one */
+static int chest_dl_estimate_port(srslte_chest_dl_t *q, cf_t *input, cf_t *ce, uint32_t sf_idx, uint32_t port_id,
+                                  uint32_t rxant_id, bool rssi_from_pair)
 {
   uint32_t npilots = SRSLTE_REFSIGNAL_NUM_SF(q->cell.nof_prb, port_id);
 
@@ -650,18 +934,29 @@ int srslte_chest_dl_estimate_port(srslte_chest_dl_t *q, cf_t *input, cf_t *ce, u
               q->pilot_estimates, npilots);
 
   /* Compute RSRP for the channel estimates in this port */
-  if (q->rsrp_neighbour) {
-    double energy = cabs(srslte_vec_acc_cc(q->pilot_estimates, npilots)/npilots);
-    q->rsrp_corr[rxant_id][port_id] = energy*energy;
+  if (q->meas_sf_mask & (1 << sf_idx)) {
+    if (q->rsrp_neighbour) {
+      double energy = cabs(srslte_vec_acc_cc(q->pilot_estimates, npilots)/npilots);
+      q->rsrp_corr[rxant_id][port_id] = energy*energy;
+    }
+    q->rsrp[rxant_id][port_id] = srslte_vec_avg_power_cf(q->pilot_recv_signal, npilots);
+    if (rssi_from_pair && (port_id % 2)) {
+      q->rssi[rxant_id][port_id] = q->rssi[rxant_id][port_id - 1];
+    } else {
+      q->rssi[rxant_id][port_id] = srslte_chest_dl_rssi(q, input, port_id);
+    }
   }
-  q->rsrp[rxant_id][port_id] = srslte_vec_avg_power_cf(q->pilot_recv_signal, npilots);
-  q->rssi[rxant_id][port_id] = srslte_chest_dl_rssi(q, input, port_id);
 
   chest_interpolate_noise_est(q, input, ce, sf_idx, port_id, rxant_id, SRSLTE_SF_NORM);
 
   return 0;
 }
 
+int srslte_chest_dl_estimate_port(srslte_chest_dl_t *q, cf_t *input, cf_t *ce, uint32_t sf_idx, uint32_t port_id, uint32_t rxant_id)
+{
+  return chest_dl_estimate_port(q, input, ce, sf_idx, port_id, rxant_id, false);
+}
+
 int srslte_chest_dl_estimate_port_mbsfn(srslte_chest_dl_t *q, cf_t *input, cf_t *ce, uint32_t sf_idx, uint32_t port_id, uint32_t rxant_id, uint16_t mbsfn_area_id)
 {
 
@@ -684,7 +979,7 @@ int srslte_chest_dl_estimate_multi(srslte_chest_dl_t *q, cf_t *input[SRSLTE_MAX_
 {
   for (uint32_t rxant_id=0;rxant_id<nof_rx_antennas;rxant_id++) {
     for (uint32_t port_id=0;port_id<q->cell.nof_ports;port_id++) {
-      if (srslte_chest_dl_estimate_port(q, input[rxant_id], ce[port_id][rxant_id], sf_idx, port_id, rxant_id)) {
+      if (chest_dl_estimate_port(q, input[rxant_id], ce[port_id][rxant_id], sf_idx, port_id, rxant_id, true)) {
         return SRSLTE_ERROR; 
       }
     }
@@ -698,7 +993,7 @@ int srslte_chest_dl_estimate(srslte_chest_dl_t *q, cf_t *input, cf_t *ce[SRSLTE_
   uint32_t port_id; 
 
   for (port_id=0;port_id<q->cell.nof_ports;port_id++) {
-    if (srslte_chest_dl_estimate_port(q, input, ce[port_id], sf_idx, port_id, 0)) {
+    if (chest_dl_estimate_port(q, input, ce[port_id], sf_idx, port_id, 0, true)) {
       return SRSLTE_ERROR;
     }
   }
@@ -728,6 +1023,16 @@ void srslte_chest_dl_average_subframe(srslte_chest_dl_t *q, bool enable)
   q->average_subframe = enable;
 }
 
+void srslte_chest_dl_set_interp_plan(srslte_chest_dl_t *q, bool enable)
+{
+  q->interp_plan = enable;
+}
+
+void srslte_chest_dl_set_meas_sf_mask(srslte_chest_dl_t *q, uint32_t mask)
+{
+  q->meas_sf_mask = mask;
+}
+
 void srslte_chest_dl_cfo_estimate_enable(srslte_chest_dl_t *q, bool enable, uint32_t mask)
 {
   q->cfo_estimate_enable  = enable;
@@ -41,6 +41,7 @@
 #include "srslte/phy/ch_estimation/chest_ul.h"
 #include "srslte/phy/utils/vector.h"
 #include "srslte/phy/utils/convolution.h"
+#include "srslte/phy/utils/simd.h"
 
 #define NOF_REFS_SYM    (q->cell.nof_prb*SRSLTE_NRE)
 #define NOF_REFS_SF     (NOF_REFS_SYM*2) // 2 reference symbols per subframe
@@ -99,6 +100,19 @@ int srslte_chest_ul_init(srslte_chest_ul_t *q, uint32_t max_prb)
       goto clean_exit;
     }
     
+    for (int i=0;i<2;i++) {
+      q->dmrs_ce[i] = srslte_vec_malloc(sizeof(cf_t) * MAX_REFS_SYM);
+      if (!q->dmrs_ce[i]) {
+        perror("malloc");
+        goto clean_exit;
+      }
+    }
+    q->dmrs_ce_slope = srslte_vec_malloc(sizeof(cf_t) * MAX_REFS_SYM);
+    if (!q->dmrs_ce_slope) {
+      perror("malloc");
+      goto clean_exit;
+    }
+    
     if (srslte_interp_linear_vector_init(&q->srslte_interp_linvec, MAX_REFS_SYM)) {
       fprintf(stderr, "Error initializing vector interpolator\n");
       goto clean_exit; 
@@ -149,6 +163,14 @@ void srslte_chest_ul_free(srslte_chest_ul_t *q)
   if (q->pilot_known_signal) {
     free(q->pilot_known_signal);
   }
+  for (int i=0;i<2;i++) {
+    if (q->dmrs_ce[i]) {
+      free(q->dmrs_ce[i]);
+    }
+  }
+  if (q->dmrs_ce_slope) {
+    free(q->dmrs_ce_slope);
+  }
   bzero(q, sizeof(srslte_chest_ul_t));
 }
 
@@ -187,13 +209,13 @@ void srslte_chest_ul_set_cfg(srslte_chest_ul_t *q,
 }
 
 /* Uses the difference between the averaged and non-averaged pilot estimates */
-static float estimate_noise_pilots(srslte_chest_ul_t *q, cf_t *ce, uint32_t nrefs, uint32_t n_prb[2]) 
+static float estimate_noise_pilots(srslte_chest_ul_t *q, cf_t *averaged[2], uint32_t nrefs) 
 {
   
   float power = 0; 
   for (int i=0;i<2;i++) {
     power += srslte_chest_estimate_noise_pilots(&q->pilot_estimates[i*nrefs], 
-                                                &ce[SRSLTE_REFSIGNAL_UL_L(i, q->cell.cp)*q->cell.nof_prb*SRSLTE_NRE+n_prb[i]*SRSLTE_NRE], 
+                                                averaged[i], 
                                                 q->tmp_noise, 
                                                 nrefs);
   }
@@ -256,8 +278,9 @@ static void average_pilots(srslte_chest_ul_t *q, cf_t *input, cf_t *ce, uint32_t
   }
 }
 
-int srslte_chest_ul_estimate(srslte_chest_ul_t *q, cf_t *input, cf_t *ce, 
-                             uint32_t nof_prb, uint32_t sf_idx, uint32_t cyclic_shift_for_dmrs, uint32_t n_prb[2]) 
+/* Least-squares estimates of the DMRS of both slots, into pilot_estimates */
+static int estimate_ls(srslte_chest_ul_t *q, cf_t *input, 
+                       uint32_t nof_prb, uint32_t sf_idx, uint32_t cyclic_shift_for_dmrs, uint32_t n_prb[2]) 
 {
   if (!q->dmrs_signal_configured) {
     fprintf(stderr, "Error must call srslte_chest_ul_set_cfg() before using the UL estimator\n");
@@ -269,8 +292,7 @@ int srslte_chest_ul_estimate(srslte_chest_ul_t *q, cf_t *input, cf_t *ce,
     return SRSLTE_ERROR_INVALID_INPUTS;
   }
   
-  int nrefs_sym = nof_prb*SRSLTE_NRE; 
-  int nrefs_sf  = nrefs_sym*2; 
+  int nrefs_sf = nof_prb*SRSLTE_NRE*2; 
   
   /* Get references from the input signal */
   srslte_refsignal_dmrs_pusch_get(&q->dmrs_signal, input, nof_prb, n_prb, q->pilot_recv_signal);
@@ -278,6 +300,19 @@ int srslte_chest_ul_estimate(srslte_chest_ul_t *q, cf_t *input, cf_t *ce,
   /* Use the known DMRS signal to compute Least-squares estimates */
   srslte_vec_prod_conj_ccc(q->pilot_recv_signal, q->dmrs_pregen.r[cyclic_shift_for_dmrs][sf_idx][nof_prb], 
                            q->pilot_estimates, nrefs_sf);
+  return SRSLTE_SUCCESS;
+}
+
+int srslte_chest_ul_estimate(srslte_chest_ul_t *q, cf_t *input, cf_t *ce, 
+                             uint32_t nof_prb, uint32_t sf_idx, uint32_t cyclic_shift_for_dmrs, uint32_t n_prb[2]) 
+{
+  int ret = estimate_ls(q, input, nof_prb, sf_idx, cyclic_shift_for_dmrs, n_prb);
+  if (ret) {
+    return ret; 
+  }
+  
+  int nrefs_sym = nof_prb*SRSLTE_NRE; 
+  int nrefs_sf  = nrefs_sym*2; 
   
   if (n_prb[0] != n_prb[1]) {
     printf("ERROR: intra-subframe frequency hopping not supported in the estimator!!\n");
@@ -289,7 +324,11 @@ int srslte_chest_ul_estimate(srslte_chest_ul_t *q, cf_t *input, cf_t *ce,
       interpolate_pilots(q, ce, nrefs_sym, n_prb);
 
       /* If averaging, compute noise from difference between received and averaged estimates */
-      q->noise_estimate = estimate_noise_pilots(q, ce, nrefs_sym, n_prb);
+      cf_t *averaged[2]; 
+      for (int i=0;i<2;i++) {
+        averaged[i] = &ce[SRSLTE_REFSIGNAL_UL_L(i, q->cell.cp)*q->cell.nof_prb*SRSLTE_NRE+n_prb[i]*SRSLTE_NRE];
+      }
+      q->noise_estimate = estimate_noise_pilots(q, averaged, nrefs_sym);
     } else {
       // Copy estimates to CE vector without averaging
       for (int i=0;i<2;i++) {
@@ -306,6 +345,88 @@ int srslte_chest_ul_estimate(srslte_chest_ul_t *q, cf_t *input, cf_t *ce,
   return 0;
 }
 
+int srslte_chest_ul_estimate_dmrs(srslte_chest_ul_t *q, cf_t *input, 
+                                  uint32_t nof_prb, uint32_t sf_idx, uint32_t cyclic_shift_for_dmrs, uint32_t n_prb[2]) 
+{
+  int ret = estimate_ls(q, input, nof_prb, sf_idx, cyclic_shift_for_dmrs, n_prb);
+  if (ret) {
+    return ret; 
+  }
+  
+  uint32_t nrefs_sym = nof_prb*SRSLTE_NRE; 
+  
+  if (q->smooth_filter_len > 0) {
+    srslte_chest_average_pilots(q->pilot_estimates, q->dmrs_ce[0], q->smooth_filter, nrefs_sym, 1, q->smooth_filter_len);
+    srslte_chest_average_pilots(&q->pilot_estimates[nrefs_sym], q->dmrs_ce[1], q->smooth_filter, nrefs_sym, 1, q->smooth_filter_len);
+    q->noise_estimate = estimate_noise_pilots(q, q->dmrs_ce, nrefs_sym);
+  } else {
+    memcpy(q->dmrs_ce[0], q->pilot_estimates, nrefs_sym*sizeof(cf_t));
+    memcpy(q->dmrs_ce[1], &q->pilot_estimates[nrefs_sym], nrefs_sym*sizeof(cf_t));
+    q->noise_estimate = 0; 
+  }
+  
+  /* With intra-subframe hopping each slot is equalized with its own DMRS, 
+   * otherwise the estimates are linearly interpolated in time */
+  q->dmrs_hopping = n_prb[0] != n_prb[1]; 
+  if (q->dmrs_hopping) {
+    bzero(q->dmrs_ce_slope, nrefs_sym*sizeof(cf_t));
+  } else {
+    uint32_t L1 = SRSLTE_REFSIGNAL_UL_L(0, q->cell.cp);
+    uint32_t L2 = SRSLTE_REFSIGNAL_UL_L(1, q->cell.cp); 
+    srslte_vec_sub_ccc(q->dmrs_ce[1], q->dmrs_ce[0], q->dmrs_ce_slope, nrefs_sym);
+    srslte_vec_sc_prod_cfc(q->dmrs_ce_slope, (float) 1/(L2-L1), q->dmrs_ce_slope, nrefs_sym);
+  }
+  q->dmrs_nof_re = nrefs_sym; 
+  
+  // Estimate received pilot power
+  q->pilot_power = srslte_vec_avg_power_cf(q->pilot_recv_signal, 2*nrefs_sym); 
+  return SRSLTE_SUCCESS;
+}
+
+/* x=y*conj(h)/(|h|^2+n0) with h=h0+k*slope */
+static void equalize_interp(cf_t *y, cf_t *h0, cf_t *slope, float k, float noise_estimate, cf_t *x, uint32_t len) 
+{
+  uint32_t i = 0; 
+  
+#if SRSLTE_SIMD_CF_SIZE
+  const simd_f_t _k     = srslte_simd_f_set1(k);
+  const simd_f_t _noise = srslte_simd_f_set1(noise_estimate);
+  
+  for (; i + SRSLTE_SIMD_CF_SIZE <= len; i += SRSLTE_SIMD_CF_SIZE) {
+    simd_cf_t _h = srslte_simd_cf_add(srslte_simd_cfi_loadu(&h0[i]), 
+                                      srslte_simd_cf_mul(srslte_simd_cfi_loadu(&slope[i]), _k));
+    simd_cf_t _y = srslte_simd_cfi_loadu(&y[i]);
+    
+    simd_f_t _hh = srslte_simd_f_add(srslte_simd_cf_re(srslte_simd_cf_conjprod(_h, _h)), _noise);
+    simd_cf_t _x = srslte_simd_cf_mul(srslte_simd_cf_conjprod(_y, _h), srslte_simd_f_rcp(_hh));
+    
+    srslte_simd_cfi_storeu(&x[i], _x);
+  }
+#endif /* SRSLTE_SIMD_CF_SIZE */
+  
+  for (; i < len; i++) {
+    cf_t h = h0[i] + k*slope[i]; 
+    float hh = __real__ h * __real__ h + __imag__ h * __imag__ h; 
+    x[i] = y[i] * conjf(h) / (hh + noise_estimate);
+  }
+}
+
+int srslte_chest_ul_equalize_symbol(srslte_chest_ul_t *q, cf_t *input, uint32_t l, float noise_estimate, cf_t *output) 
+{
+  uint32_t nsymb = SRSLTE_CP_NSYMB(q->cell.cp);
+  if (l >= 2*nsymb || !q->dmrs_nof_re) {
+    return SRSLTE_ERROR_INVALID_INPUTS; 
+  }
+  
+  if (q->dmrs_hopping) {
+    equalize_interp(input, q->dmrs_ce[l/nsymb], q->dmrs_ce_slope, 0, noise_estimate, output, q->dmrs_nof_re);
+  } else {
+    float k = (float) l - SRSLTE_REFSIGNAL_UL_L(0, q->cell.cp); 
+    equalize_interp(input, q->dmrs_ce[0], q->dmrs_ce_slope, k, noise_estimate, output, q->dmrs_nof_re);
+  }
+  return q->dmrs_nof_re; 
+}
+
 int srslte_chest_ul_estimate_pucch(srslte_chest_ul_t *q, cf_t *input, cf_t *ce, 
                                    srslte_pucch_format_t format, uint32_t n_pucch, uint32_t sf_idx, 
                                    uint8_t *pucch2_ack_bits) 
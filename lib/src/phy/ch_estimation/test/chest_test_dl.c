@@ -43,6 +43,7 @@ srslte_cell_t cell = {
 };
 
 char *output_matlab = NULL;
+bool interp_plan = false;
 
 void usage(char *prog) {
   printf("Usage: %s [recov]\n", prog);
@@ -51,6 +52,8 @@ void usage(char *prog) {
   printf("\t-e extended cyclic prefix [Default normal]\n");
 
   printf("\t-c cell_id (1000 tests all). [Default %d]\n", cell.id);
+  printf("\t-p use the precomputed interpolation and compare it with the default [Default %s]\n",
+         interp_plan?"Enabled":"Disabled");
 
   printf("\t-o output matlab file [Default %s]\n",output_matlab?output_matlab:"None");
   printf("\t-v increase verbosity\n");
@@ -58,7 +61,7 @@ void usage(char *prog) {
 
 void parse_args(int argc, char **argv) {
   int opt;
-  while ((opt = getopt(argc, argv, "recov")) != -1) {
+  while ((opt = getopt(argc, argv, "recpov")) != -1) {
     switch(opt) {
     case 'r':
       cell.nof_prb = atoi(argv[optind]);
@@ -72,6 +75,9 @@ void parse_args(int argc, char **argv) {
     case 'o':
       output_matlab = argv[optind];
       break;
+    case 'p':
+      interp_plan = true;
+      break;
     case 'v':
       srslte_verbose++;
       break;
@@ -84,8 +90,8 @@ void parse_args(int argc, char **argv) {
 
 
 int main(int argc, char **argv) {
-  srslte_chest_dl_t est;
-  cf_t *input = NULL, *ce = NULL, *h = NULL, *output = NULL;
+  srslte_chest_dl_t est, est_ref;
+  cf_t *input = NULL, *ce = NULL, *ce_ref = NULL, *h = NULL, *output = NULL;
   int i, j, n_port=0, sf_idx=0, cid=0, num_re;
   int ret = -1;
   int max_cid;
@@ -123,6 +129,11 @@ int main(int argc, char **argv) {
     perror("srslte_vec_malloc");
     goto do_exit;
   }
+  ce_ref = srslte_vec_malloc(num_re * sizeof(cf_t));
+  if (!ce_ref) {
+    perror("srslte_vec_malloc");
+    goto do_exit;
+  }
 
   if (cell.id == 1000) {
     cid = 0;
@@ -131,13 +142,14 @@ int main(int argc, char **argv) {
     cid = cell.id;
     max_cid = cell.id;
   }
-  if (srslte_chest_dl_init(&est, cell.nof_prb)) {
+  if (srslte_chest_dl_init(&est, cell.nof_prb) || srslte_chest_dl_init(&est_ref, cell.nof_prb)) {
     fprintf(stderr, "Error initializing equalizer\n");
     goto do_exit;
   }
+  srslte_chest_dl_set_interp_plan(&est, interp_plan);
   while(cid <= max_cid) {
     cell.id = cid; 
-    if (srslte_chest_dl_set_cell(&est, cell)) {
+    if (srslte_chest_dl_set_cell(&est, cell) || srslte_chest_dl_set_cell(&est_ref, cell)) {
       fprintf(stderr, "Error initializing equalizer\n");
       goto do_exit;
     }
@@ -172,6 +184,18 @@ int main(int argc, char **argv) {
         gettimeofday(&t[2], NULL);
         get_time_interval(t);
         printf("CHEST: %f us\n", (float) t[0].tv_usec/100);
+
+        if (interp_plan) {
+          srslte_chest_dl_estimate_port(&est_ref, input, ce_ref, sf_idx, n_port, 0);
+          float max_diff = 0;
+          for (i=0;i<num_re;i++) {
+            max_diff = SRSLTE_MAX(max_diff, cabsf(ce[i]-ce_ref[i]));
+          }
+          printf("Precomputed interpolation max error: %f\n", max_diff);
+          if (max_diff > 1e-3) {
+            goto do_exit;
+          }
+        }
         
         gettimeofday(&t[1], NULL);
         for (int j=0;j<100;j++) {
@@ -224,6 +248,7 @@ int main(int argc, char **argv) {
     INFO("cid=%d\n", cid);
   }
   srslte_chest_dl_free(&est);
+  srslte_chest_dl_free(&est_ref);
 
 
   ret = 0;
@@ -236,6 +261,9 @@ do_exit:
   if (ce) {
     free(ce);
   }
+  if (ce_ref) {
+    free(ce_ref);
+  }
   if (input) {
     free(input);
   }
@@ -0,0 +1,357 @@
+/**
+ *
+ * \section COPYRIGHT
+ *
+ * Copyright 2013-2015 Software Radio Systems Limited
+ *
+ * \section LICENSE
+ *
+ * This file is part of the srsLTE library.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/* Compares the fused PUSCH receiver (srslte_chest_ul_estimate_dmrs() and srslte_pusch_decode_fused())
+ * with the estimator filling the resource grid followed by srslte_pusch_decode(). Both must decode 
+ * the same constellation. The estimation and equalization of the data symbols is timed for both */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <complex.h>
+#include <sys/time.h>
+
+#include "srslte/srslte.h"
+
+srslte_cell_t cell = {
+  .nof_prb = 50,
+  .nof_ports = 1,
+  .id = 1,
+  .cp = SRSLTE_CP_NORM,
+  .phich_length = SRSLTE_PHICH_NORM,
+  .phich_resources = SRSLTE_PHICH_R_1_6
+};
+
+uint32_t L_prb = 48;
+uint32_t n_prb = 0;
+uint32_t mcs_idx = 20;
+uint32_t nof_subframes = 100;
+uint32_t nof_reps = 10;
+float snr_db = 30.0;
+bool zero_forcing = false;
+
+void usage(char *prog) {
+  printf("Usage: %s [reLNmstnzv]\n", prog);
+  printf("\t-r cell nof_prb [Default %d]\n", cell.nof_prb);
+  printf("\t-e extended cyclic prefix [Default normal]\n");
+  printf("\t-L L_prb [Default %d]\n", L_prb);
+  printf("\t-N n_prb [Default %d]\n", n_prb);
+  printf("\t-m MCS index [Default %d]\n", mcs_idx);
+  printf("\t-s number of subframes [Default %d]\n", nof_subframes);
+  printf("\t-t timed repetitions per subframe [Default %d]\n", nof_reps);
+  printf("\t-n SNR in dB [Default %.1f]\n", snr_db);
+  printf("\t-z zero forcing equalizer [Default MMSE]\n");
+  printf("\t-v increase verbosity\n");
+}
+
+void parse_args(int argc, char **argv) {
+  int opt;
+  while ((opt = getopt(argc, argv, "reLNmstnzv")) != -1) {
+    switch(opt) {
+    case 'r':
+      cell.nof_prb = atoi(argv[optind]);
+      break;
+    case 'e':
+      cell.cp = SRSLTE_CP_EXT;
+      break;
+    case 'L':
+      L_prb = atoi(argv[optind]);
+      break;
+    case 'N':
+      n_prb = atoi(argv[optind]);
+      break;
+    case 'm':
+      mcs_idx = atoi(argv[optind]);
+      break;
+    case 's':
+      nof_subframes = atoi(argv[optind]);
+      break;
+    case 't':
+      nof_reps = atoi(argv[optind]);
+      break;
+    case 'n':
+      snr_db = atof(argv[optind]);
+      break;
+    case 'z':
+      zero_forcing = true;
+      break;
+    case 'v':
+      srslte_verbose++;
+      break;
+    default:
+      usage(argv[0]);
+      exit(-1);
+    }
+  }
+}
+
+/* Index of the first allocated RE of the data symbols, in the order of the PUSCH */
+static uint32_t data_symbols(srslte_pusch_cfg_t *cfg, uint32_t *l, uint32_t *idx) {
+  uint32_t n = 0;
+  for (uint32_t slot = 0; slot < 2; slot++) {
+    for (uint32_t i = 0; i < SRSLTE_CP_NSYMB(cell.cp); i++) {
+      if (i != SRSLTE_REFSIGNAL_UL_L(0, cell.cp)) {
+        l[n] = i + slot * SRSLTE_CP_NSYMB(cell.cp);
+        idx[n] = SRSLTE_RE_IDX(cell.nof_prb, l[n], cfg->grant.n_prb_tilde[slot] * SRSLTE_NRE);
+        n++;
+      }
+    }
+  }
+  return n;
+}
+
+int main(int argc, char **argv) {
+  srslte_pusch_t pusch_tx, pusch_rx;
+  srslte_refsignal_ul_t dmrs;
+  srslte_chest_ul_t est;
+  srslte_softbuffer_tx_t softbuffer_tx;
+  srslte_softbuffer_rx_t softbuffer_rx;
+  srslte_pusch_cfg_t cfg;
+  srslte_uci_data_t uci_data;
+  srslte_ra_ul_grant_t grant;
+  srslte_ra_ul_dci_t dci;
+  struct timeval t[3];
+  cf_t *sf_symbols = NULL, *ce = NULL, *d_ref = NULL, *r_pusch = NULL, *y = NULL, *h = NULL, *x = NULL;
+  uint32_t l[SRSLTE_CP_NORM_SF_NSYMB], idx[SRSLTE_CP_NORM_SF_NSYMB];
+  uint8_t *data = NULL, *data_rx = NULL;
+  uint64_t t_ref = 0, t_fused = 0;
+  float max_error = 0;
+  int ret = -1;
+
+  parse_args(argc, argv);
+
+  srslte_dft_load();
+
+  bzero(&cfg, sizeof(srslte_pusch_cfg_t));
+  bzero(&uci_data, sizeof(srslte_uci_data_t));
+  bzero(&dci, sizeof(srslte_ra_ul_dci_t));
+  dci.freq_hop_fl = -1;
+  dci.type2_alloc.L_crb = L_prb;
+  dci.type2_alloc.RB_start = n_prb;
+  dci.mcs_idx = mcs_idx;
+  if (srslte_ra_ul_dci_to_grant(&dci, cell.nof_prb, 0, &grant)) {
+    fprintf(stderr, "Error computing resource allocation\n");
+    exit(-1);
+  }
+  if (grant.mcs.mod == SRSLTE_MOD_64QAM) {
+    grant.mcs.mod = SRSLTE_MOD_16QAM;
+    grant.Qm = 4;
+  }
+
+  srslte_pusch_hopping_cfg_t ul_hopping;
+  ul_hopping.n_sb = 1;
+  ul_hopping.hopping_offset = 0;
+  ul_hopping.hop_mode = 1;
+
+  srslte_refsignal_dmrs_pusch_cfg_t dmrs_cfg;
+  bzero(&dmrs_cfg, sizeof(srslte_refsignal_dmrs_pusch_cfg_t));
+  dmrs_cfg.cyclic_shift = 3;
+
+  if (srslte_pusch_init_ue(&pusch_tx, cell.nof_prb) || srslte_pusch_set_cell(&pusch_tx, cell) ||
+      srslte_pusch_init_enb(&pusch_rx, cell.nof_prb) || srslte_pusch_set_cell(&pusch_rx, cell)) {
+    fprintf(stderr, "Error creating PUSCH object\n");
+    exit(-1);
+  }
+  if (srslte_refsignal_ul_init(&dmrs, cell.nof_prb) || srslte_refsignal_ul_set_cell(&dmrs, cell)) {
+    fprintf(stderr, "Error creating DMRS object\n");
+    exit(-1);
+  }
+  srslte_refsignal_ul_set_cfg(&dmrs, &dmrs_cfg, NULL, NULL);
+  if (srslte_chest_ul_init(&est, cell.nof_prb) || srslte_chest_ul_set_cell(&est, cell)) {
+    fprintf(stderr, "Error initializing equalizer\n");
+    exit(-1);
+  }
+  srslte_chest_ul_set_cfg(&est, &dmrs_cfg, NULL, NULL);
+  if (srslte_softbuffer_tx_init(&softbuffer_tx, cell.nof_prb) || srslte_softbuffer_rx_init(&softbuffer_rx, cell.nof_prb)) {
+    fprintf(stderr, "Error initiating soft buffer\n");
+    exit(-1);
+  }
+
+  uint16_t rnti = 1234;
+  srslte_pusch_set_rnti(&pusch_tx, rnti);
+  srslte_pusch_set_rnti(&pusch_rx, rnti);
+
+  uint32_t nof_re = SRSLTE_SF_LEN_RE(cell.nof_prb, cell.cp);
+  sf_symbols = srslte_vec_malloc(sizeof(cf_t) * nof_re);
+  ce         = srslte_vec_malloc(sizeof(cf_t) * nof_re);
+  d_ref      = srslte_vec_malloc(sizeof(cf_t) * nof_re);
+  r_pusch    = srslte_vec_malloc(sizeof(cf_t) * 2 * SRSLTE_NRE * cell.nof_prb);
+  y          = srslte_vec_malloc(sizeof(cf_t) * nof_re);
+  h          = srslte_vec_malloc(sizeof(cf_t) * nof_re);
+  x          = srslte_vec_malloc(sizeof(cf_t) * nof_re);
+  data       = srslte_vec_malloc(sizeof(uint8_t) * 150000);
+  data_rx    = srslte_vec_malloc(sizeof(uint8_t) * 150000);
+  if (!sf_symbols || !ce || !d_ref || !r_pusch || !y || !h || !x || !data || !data_rx) {
+    perror("srslte_vec_malloc");
+    goto do_exit;
+  }
+  bzero(ce, sizeof(cf_t) * nof_re);
+
+  float noise_var = powf(10.0f, -snr_db / 10.0f);
+
+  for (uint32_t n = 0; n < nof_subframes; n++) {
+    uint32_t sf_idx = n % 10;
+
+    if (srslte_pusch_cfg(&pusch_tx, &cfg, &grant, NULL, &ul_hopping, NULL, sf_idx, 0, 0) ||
+        srslte_pusch_cfg(&pusch_rx, &cfg, &grant, NULL, &ul_hopping, NULL, sf_idx, 0, 0)) {
+      fprintf(stderr, "Error configuring PUSCH\n");
+      goto do_exit;
+    }
+
+    for (uint32_t i = 0; i < cfg.grant.mcs.tbs / 8; i++) {
+      data[i] = (uint8_t) (rand() & 0xff);
+    }
+
+    /* Transmit PUSCH and DMRS */
+    bzero(sf_symbols, sizeof(cf_t) * nof_re);
+    srslte_softbuffer_tx_reset(&softbuffer_tx);
+    if (srslte_pusch_encode(&pusch_tx, &cfg, &softbuffer_tx, data, uci_data, rnti, sf_symbols)) {
+      fprintf(stderr, "Error encoding TB\n");
+      goto do_exit;
+    }
+    srslte_refsignal_dmrs_pusch_gen(&dmrs, cfg.grant.L_prb, sf_idx, 0, r_pusch);
+    srslte_refsignal_dmrs_pusch_put(&dmrs, r_pusch, cfg.grant.L_prb, cfg.grant.n_prb_tilde, sf_symbols);
+
+    /* Channel varying in time and frequency, plus noise */
+    for (uint32_t i = 0; i < 2 * SRSLTE_CP_NSYMB(cell.cp); i++) {
+      for (uint32_t j = 0; j < cell.nof_prb * SRSLTE_NRE; j++) {
+        float x = -1 + (float) i / SRSLTE_CP_NSYMB(cell.cp) / 4 + cosf(2 * M_PI * (float) j / cell.nof_prb / SRSLTE_NRE + n);
+        sf_symbols[i * cell.nof_prb * SRSLTE_NRE + j] *= (3 + x) / 4 * cexpf(I * x);
+      }
+    }
+    srslte_ch_awgn_c(sf_symbols, sf_symbols, noise_var, nof_re);
+
+    /* Estimation of the resource grid followed by the decoder */
+    srslte_softbuffer_rx_reset(&softbuffer_rx);
+    srslte_chest_ul_estimate(&est, sf_symbols, ce, cfg.grant.L_prb, sf_idx, 0, cfg.grant.n_prb_tilde);
+    float noise = zero_forcing ? 0 : srslte_chest_ul_get_noise_estimate(&est);
+    int r = srslte_pusch_decode(&pusch_rx, &cfg, &softbuffer_rx, sf_symbols, ce, noise, rnti, data_rx, NULL, &uci_data);
+    if (r || memcmp(data, data_rx, cfg.grant.mcs.tbs / 8)) {
+      fprintf(stderr, "Error decoding subframe %d with the resource grid estimator\n", n);
+      goto do_exit;
+    }
+    memcpy(d_ref, pusch_rx.d, sizeof(cf_t) * cfg.nbits.nof_re);
+
+    /* Fused estimation, equalization and demodulation */
+    srslte_softbuffer_rx_reset(&softbuffer_rx);
+    bzero(data_rx, cfg.grant.mcs.tbs / 8);
+    srslte_chest_ul_estimate_dmrs(&est, sf_symbols, cfg.grant.L_prb, sf_idx, 0, cfg.grant.n_prb_tilde);
+    noise = zero_forcing ? 0 : srslte_chest_ul_get_noise_estimate(&est);
+    r = srslte_pusch_decode_fused(&pusch_rx, &cfg, &softbuffer_rx, sf_symbols, &est, noise, rnti, data_rx, NULL, &uci_data);
+    if (r || memcmp(data, data_rx, cfg.grant.mcs.tbs / 8)) {
+      fprintf(stderr, "Error decoding subframe %d with the fused receiver\n", n);
+      goto do_exit;
+    }
+
+    /* Both receivers must produce the same constellation */
+    for (uint32_t i = 0; i < cfg.nbits.nof_re; i++) {
+      float e = cabsf(pusch_rx.d[i] - d_ref[i]);
+      if (e > max_error) {
+        max_error = e;
+      }
+    }
+
+    /* Timing of the estimation and equalization of the data symbols, the rest of the decoder is common */
+    uint32_t nof_symb = data_symbols(&cfg, l, idx);
+    uint32_t nof_re_symb = cfg.grant.L_prb * SRSLTE_NRE;
+
+    gettimeofday(&t[1], NULL);
+    for (uint32_t k = 0; k < nof_reps; k++) {
+      srslte_chest_ul_estimate(&est, sf_symbols, ce, cfg.grant.L_prb, sf_idx, 0, cfg.grant.n_prb_tilde);
+      for (uint32_t i = 0; i < nof_symb; i++) {
+        memcpy(&y[i * nof_re_symb], &sf_symbols[idx[i]], sizeof(cf_t) * nof_re_symb);
+        memcpy(&h[i * nof_re_symb], &ce[idx[i]], sizeof(cf_t) * nof_re_symb);
+      }
+      srslte_predecoding_single(y, h, x, NULL, nof_symb * nof_re_symb, 1.0f, noise);
+    }
+    gettimeofday(&t[2], NULL);
+    get_time_interval(t);
+    t_ref += t[0].tv_sec * 1000000 + t[0].tv_usec;
+
+    gettimeofday(&t[1], NULL);
+    for (uint32_t k = 0; k < nof_reps; k++) {
+      srslte_chest_ul_estimate_dmrs(&est, sf_symbols, cfg.grant.L_prb, sf_idx, 0, cfg.grant.n_prb_tilde);
+      for (uint32_t i = 0; i < nof_symb; i++) {
+        srslte_chest_ul_equalize_symbol(&est, &sf_symbols[idx[i]], l[i], noise, x);
+      }
+    }
+    gettimeofday(&t[2], NULL);
+    get_time_interval(t);
+    t_fused += t[0].tv_sec * 1000000 + t[0].tv_usec;
+  }
+
+  printf("L_prb=%d, %s: estimation and equalization grid %.1f us, fused %.1f us per subframe, max error %f\n",
+         L_prb, zero_forcing ? "ZF" : "MMSE",
+         (float) t_ref / nof_subframes / nof_reps, (float) t_fused / nof_subframes / nof_reps, max_error);
+
+  if (max_error < 0.01) {
+    ret = 0;
+  }
+
+do_exit:
+  srslte_pusch_free(&pusch_tx);
+  srslte_pusch_free(&pusch_rx);
+  srslte_refsignal_ul_free(&dmrs);
+  srslte_chest_ul_free(&est);
+  srslte_softbuffer_tx_free(&softbuffer_tx);
+  srslte_softbuffer_rx_free(&softbuffer_rx);
+  if (sf_symbols) {
+    free(sf_symbols);
+  }
+  if (ce) {
+    free(ce);
+  }
+  if (d_ref) {
+    free(d_ref);
+  }
+  if (r_pusch) {
+    free(r_pusch);
+  }
+  if (y) {
+    free(y);
+  }
+  if (h) {
+    free(h);
+  }
+  if (x) {
+    free(x);
+  }
+  if (data) {
+    free(data);
+  }
+  if (data_rx) {
+    free(data_rx);
+  }
+
+  if (!ret) {
+    printf("OK\n");
+  } else {
+    printf("Error\n");
+  }
+  exit(ret);
+}
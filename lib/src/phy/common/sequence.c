@@ -26,121 +26,240 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <strings.h>
-#include <pthread.h>
-#include <srslte/phy/common/sequence.h>
 
 #include "srslte/phy/common/sequence.h"
 #include "srslte/phy/utils/vector.h"
 #include "srslte/phy/utils/bit.h"
 
-#define Nc 1600
-
-#define MAX_SEQ_LEN  (128*1024)
-
-#define static_memory
-
 /*
  * Pseudo Random Sequence generation.
  * It follows the 3GPP Release 8 (LTE) 36.211
  * Section 7.2
+ *
+ * Bit i of the 64-bit registers x1 and x2 holds x1(n+i) and x2(n+i), where n is the index of the
+ * next output bit. Squaring the generator polynomials gives the recursions
+ *    x1(n+62) = x1(n+6) + x1(n)
+ *    x2(n+62) = x2(n+6) + x2(n+4) + x2(n+2) + x2(n)
+ * which produce up to 56 new bits from a 64-bit register at once, so the registers advance
+ * 32 bits per step. The initial registers at n=Nc=1600 are precomputed: x1 is fixed and x2 is
+ * linear in c_init, so it is the XOR of the registers obtained with each bit of c_init alone.
  */
-#ifdef static_memory
-static uint8_t x1[Nc+MAX_SEQ_LEN+31];
-static uint8_t x2[Nc+MAX_SEQ_LEN+31];
 
-static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
-int srslte_sequence_set_LTE_pr(srslte_sequence_t *q, uint32_t len, uint32_t seed) {
-  int n;
+static const uint64_t x1_Nc = 0x6ac0a9a45e485840ULL;
 
-  if (len > q->max_len) {
-    fprintf(stderr, "Error generating pseudo-random sequence: len %d exceeds maximum len %d\n",
-            len, MAX_SEQ_LEN);
-    return -1;
+static const uint64_t x2_Nc[31] = {
+  0x2d7ff07070889900ULL, 0x778010909199ab01ULL, 0xc27fd15153bbcf03ULL,
+  0xa98052d2d7ff0707ULL, 0x5300a5a5affe0e0eULL, 0xa6014b4b5ffc1c1cULL,
+  0x4c029696bff83838ULL, 0x98052d2d7ff07070ULL, 0x300a5a5affe0e0e1ULL,
+  0x6014b4b5ffc1c1c2ULL, 0xc029696bff838384ULL, 0x8052d2d7ff070708ULL,
+  0x00a5a5affe0e0e11ULL, 0x014b4b5ffc1c1c22ULL, 0x029696bff8383844ULL,
+  0x052d2d7ff0707088ULL, 0x0a5a5affe0e0e111ULL, 0x14b4b5ffc1c1c222ULL,
+  0x29696bff83838444ULL, 0x52d2d7ff07070889ULL, 0xa5a5affe0e0e1113ULL,
+  0x4b4b5ffc1c1c2226ULL, 0x9696bff83838444cULL, 0x2d2d7ff070708899ULL,
+  0x5a5affe0e0e11132ULL, 0xb4b5ffc1c1c22264ULL, 0x696bff83838444c8ULL,
+  0xd2d7ff0707088990ULL, 0xa5affe0e0e111320ULL, 0x4b5ffc1c1c222640ULL,
+  0x96bff83838444c80ULL
+};
+
+void srslte_sequence_state_init(srslte_sequence_state_t *s, uint32_t seed) {
+  s->x1 = x1_Nc;
+  s->x2 = 0;
+  for (uint32_t i=0;i<31;i++) {
+    if ((seed >> i) & 0x1) {
+      s->x2 ^= x2_Nc[i];
+    }
   }
+}
 
-  if (len > q->max_len) {
-    fprintf(stderr, "Error generating pseudo-random sequence: len %d is greater than allocated len %d\n",
-            len, q->max_len);
-    return -1;
+/* Reverses the bits of each byte, so that c(n) goes to the MSB of its byte as in srslte_bit_pack_vector() */
+static inline uint32_t reverse_bytes(uint32_t c) {
+  c = ((c & 0xf0f0f0f0) >> 4) | ((c & 0x0f0f0f0f) << 4);
+  c = ((c & 0xcccccccc) >> 2) | ((c & 0x33333333) << 2);
+  c = ((c & 0xaaaaaaaa) >> 1) | ((c & 0x55555555) << 1);
+  return c;
+}
+
+void srslte_sequence_state_advance(srslte_sequence_state_t *s, uint32_t len) {
+  for (uint32_t i=0;i<len;i+=32) {
+    srslte_sequence_state_next(s, SRSLTE_MIN(32, len-i));
   }
-  pthread_mutex_lock(&mutex);
+}
 
-  for (n = 0; n < 31; n++) {
-    x2[n] = (seed >> n) & 0x1;
+void srslte_sequence_state_gen_bits(srslte_sequence_state_t *s, uint8_t *bits, uint32_t len) {
+  uint32_t i = 0;
+  for (;i+32<=len;i+=32) {
+    uint32_t c = srslte_sequence_state_next(s, 32);
+    for (uint32_t j=0;j<4;j++) {
+      // Spread the 8 bits of a byte to the LSB of 8 bytes (little endian)
+      uint64_t b = ((c >> (8*j)) & 0xff) * 0x0101010101010101ULL;
+      b = (((b & 0x8040201008040201ULL) + 0x7f7f7f7f7f7f7f7fULL) >> 7) & 0x0101010101010101ULL;
+      memcpy(&bits[i+8*j], &b, sizeof(uint64_t));
+    }
+  }
+  if (i < len) {
+    uint32_t c = srslte_sequence_state_next(s, len-i);
+    for (uint32_t j=0;j<len-i;j++) {
+      bits[i+j] = (uint8_t) ((c >> j) & 0x1);
+    }
   }
-  x1[0] = 1;
+}
 
-  for (n = 0; n < Nc + len; n++) {
-    x1[n + 31] = (x1[n + 3] + x1[n]) & 0x1;
-    x2[n + 31] = (x2[n + 3] + x2[n + 2] + x2[n+1] + x2[n]) & 0x1;
+/* Bytes are packed MSB first like srslte_bit_pack_vector(). len is in bits and must be
+ * a multiple of 8 unless it is the last call for this sequence. */
+void srslte_sequence_state_gen_packed(srslte_sequence_state_t *s, uint8_t *packed, uint32_t len) {
+  uint32_t i = 0;
+  for (;i+32<=len;i+=32) {
+    uint32_t c = reverse_bytes(srslte_sequence_state_next(s, 32));
+    memcpy(&packed[i/8], &c, sizeof(uint32_t));
+  }
+  if (i < len) {
+    uint32_t n = len - i;
+    uint32_t c = reverse_bytes(srslte_sequence_state_next(s, n));
+    for (uint32_t j=0;j<n;j+=8) {
+      uint8_t b = (uint8_t) (c >> j);
+      if (n - j < 8) {
+        b &= (uint8_t) (0xff << (8 - (n - j)));
+      }
+      packed[(i+j)/8] = b;
+    }
   }
+}
 
-  for (n = 0; n < len; n++) {
-    q->c[n] = (x1[n + Nc] + x2[n + Nc]) & 0x1;
+void srslte_sequence_state_gen_f(srslte_sequence_state_t *s, float *out, uint32_t len) {
+  for (uint32_t i=0;i<len;i+=32) {
+    uint32_t n = SRSLTE_MIN(32, len-i);
+    uint32_t c = srslte_sequence_state_next(s, n);
+    for (uint32_t j=0;j<n;j++) {
+      out[i+j] = 1.0f - 2.0f*((c >> j) & 0x1);
+    }
   }
-  pthread_mutex_unlock(&mutex);
+}
 
-  return 0;
+void srslte_sequence_state_gen_s(srslte_sequence_state_t *s, int16_t *out, uint32_t len) {
+  for (uint32_t i=0;i<len;i+=32) {
+    uint32_t n = SRSLTE_MIN(32, len-i);
+    uint32_t c = srslte_sequence_state_next(s, n);
+    for (uint32_t j=0;j<n;j++) {
+      out[i+j] = (int16_t) (1 - 2*((c >> j) & 0x1));
+    }
+  }
 }
 
-#else
-int srslte_sequence_set_LTE_pr(srslte_sequence_t *q, uint32_t len, uint32_t seed) {
-  int n;
-  uint32_t *x1, *x2;
+void srslte_sequence_state_gen_sb(srslte_sequence_state_t *s, int8_t *out, uint32_t len) {
+  for (uint32_t i=0;i<len;i+=32) {
+    uint32_t n = SRSLTE_MIN(32, len-i);
+    uint32_t c = srslte_sequence_state_next(s, n);
+    for (uint32_t j=0;j<n;j++) {
+      out[i+j] = (int8_t) (1 - 2*((c >> j) & 0x1));
+    }
+  }
+}
 
-  if (len > q->max_len) {
-    fprintf(stderr, "Error generating pseudo-random sequence: len %d is greater than allocated len %d\n",
-            len, q->max_len);
-    return -1;
+void srslte_sequence_state_apply_bits(srslte_sequence_state_t *s, uint8_t *in, uint8_t *out, uint32_t len) {
+  for (uint32_t i=0;i<len;i+=32) {
+    uint32_t n = SRSLTE_MIN(32, len-i);
+    uint32_t c = srslte_sequence_state_next(s, n);
+    for (uint32_t j=0;j<n;j++) {
+      out[i+j] = in[i+j] ^ (uint8_t) ((c >> j) & 0x1);
+    }
   }
+}
 
-  x1 = calloc(Nc + len + 31, sizeof(uint32_t));
-  if (!x1) {
-    perror("calloc");
-    return -1;
+/* Same packing and length rules as srslte_sequence_state_gen_packed() */
+void srslte_sequence_state_apply_packed(srslte_sequence_state_t *s, uint8_t *in, uint8_t *out, uint32_t len) {
+  uint32_t i = 0;
+  for (;i+32<=len;i+=32) {
+    uint32_t c = reverse_bytes(srslte_sequence_state_next(s, 32));
+    uint32_t x;
+    memcpy(&x, &in[i/8], sizeof(uint32_t));
+    x ^= c;
+    memcpy(&out[i/8], &x, sizeof(uint32_t));
   }
-  x2 = calloc(Nc + len + 31, sizeof(uint32_t));
-  if (!x2) {
-    free(x1);
-    perror("calloc");
-    return -1;
+  if (i < len) {
+    uint32_t n = len - i;
+    uint32_t c = reverse_bytes(srslte_sequence_state_next(s, n));
+    for (uint32_t j=0;j<n;j+=8) {
+      uint8_t b = (uint8_t) (c >> j);
+      if (n - j < 8) {
+        b &= (uint8_t) (0xff << (8 - (n - j)));
+      }
+      out[(i+j)/8] = in[(i+j)/8] ^ b;
+    }
+  }
+}
+
+void srslte_sequence_state_apply_f(srslte_sequence_state_t *s, float *in, float *out, uint32_t len) {
+  for (uint32_t i=0;i<len;i+=32) {
+    uint32_t n = SRSLTE_MIN(32, len-i);
+    uint32_t c = srslte_sequence_state_next(s, n);
+    for (uint32_t j=0;j<n;j++) {
+      union {
+        float    f;
+        uint32_t u;
+      } v;
+      v.f = in[i+j];
+      v.u ^= ((c >> j) & 0x1) << 31;
+      out[i+j] = v.f;
+    }
   }
+}
 
-  for (n = 0; n < 31; n++) {
-    x2[n] = (seed >> n) & 0x1;
+void srslte_sequence_state_apply_s(srslte_sequence_state_t *s, int16_t *in, int16_t *out, uint32_t len) {
+  for (uint32_t i=0;i<len;i+=32) {
+    uint32_t n = SRSLTE_MIN(32, len-i);
+    uint32_t c = srslte_sequence_state_next(s, n);
+    for (uint32_t j=0;j<n;j++) {
+      int16_t m = (int16_t) -((c >> j) & 0x1);
+      out[i+j] = (int16_t) ((in[i+j] ^ m) - m);
+    }
   }
-  x1[0] = 1;
+}
 
-  for (n = 0; n < Nc + len; n++) {
-    x1[n + 31] = (x1[n + 3] + x1[n]) & 0x1;
-    x2[n + 31] = (x2[n + 3] + x2[n + 2] + +x2[n+1] + x2[n]) & 0x1;
+void srslte_sequence_state_apply_sb(srslte_sequence_state_t *s, int8_t *in, int8_t *out, uint32_t len) {
+  for (uint32_t i=0;i<len;i+=32) {
+    uint32_t n = SRSLTE_MIN(32, len-i);
+    uint32_t c = srslte_sequence_state_next(s, n);
+    for (uint32_t j=0;j<n;j++) {
+      int8_t m = (int8_t) -((c >> j) & 0x1);
+      out[i+j] = (int8_t) ((in[i+j] ^ m) - m);
+    }
   }
+}
+
+int srslte_sequence_set_LTE_pr(srslte_sequence_t *q, uint32_t len, uint32_t seed) {
+  srslte_sequence_state_t s;
 
-  for (n = 0; n < len; n++) {
-    q->c[n] = (x1[n + Nc] + x2[n + Nc]) & 0x1;
+  if (len > q->max_len) {
+    fprintf(stderr, "Error generating pseudo-random sequence: len %d is greater than allocated len %d\n",
+            len, q->max_len);
+    return -1;
   }
 
-  free(x1);
-  free(x2);
+  srslte_sequence_state_init(&s, seed);
+  srslte_sequence_state_gen_bits(&s, q->c, len);
 
   return 0;
 }
 
-#endif
-
 int srslte_sequence_LTE_pr(srslte_sequence_t *q, uint32_t len, uint32_t seed) {
+  srslte_sequence_state_t s;
+
   if (srslte_sequence_init(q, len)) {
     return SRSLTE_ERROR;
   }
   q->cur_len = len;
-  srslte_sequence_set_LTE_pr(q, len, seed);
-  srslte_bit_pack_vector(q->c, q->c_bytes, len);
-  for (int i=0;i<len;i++) {
-    q->c_float[i] = (1-2*q->c[i]);
-    q->c_short[i] = (int16_t) q->c_float[i];
-    q->c_char[i]  = (int8_t) q->c_float[i];;
-  }
+  srslte_sequence_state_init(&s, seed);
+  srslte_sequence_state_gen_bits(&s, q->c, len);
+  srslte_sequence_state_init(&s, seed);
+  srslte_sequence_state_gen_packed(&s, q->c_bytes, len);
+  srslte_sequence_state_init(&s, seed);
+  srslte_sequence_state_gen_f(&s, q->c_float, len);
+  srslte_sequence_state_init(&s, seed);
+  srslte_sequence_state_gen_s(&s, q->c_short, len);
+  srslte_sequence_state_init(&s, seed);
+  srslte_sequence_state_gen_sb(&s, q->c_char, len);
   return SRSLTE_SUCCESS;
 }
 
@@ -0,0 +1,199 @@
+/**
+ *
+ * \section COPYRIGHT
+ *
+ * Copyright 2013-2015 Software Radio Systems Limited
+ *
+ * \section LICENSE
+ *
+ * This file is part of the srsLTE library.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+#include "srslte/srslte.h"
+
+#define Nc      1600
+#define MAX_LEN (8*1024)
+
+int nof_repetitions = 200;
+
+void usage(char *prog) {
+  printf("Usage: %s [n]\n", prog);
+  printf("\t-n nof_repetitions [Default %d]\n", nof_repetitions);
+}
+
+void parse_args(int argc, char **argv) {
+  int opt;
+  while ((opt = getopt(argc, argv, "n")) != -1) {
+    switch (opt) {
+    case 'n':
+      nof_repetitions = atoi(argv[optind]);
+      break;
+    default:
+      usage(argv[0]);
+      exit(-1);
+    }
+  }
+}
+
+/* Bit by bit generation as written in 36.211 7.2 */
+static uint8_t x1[Nc+MAX_LEN+31];
+static uint8_t x2[Nc+MAX_LEN+31];
+
+void sequence_reference(uint8_t *c, uint32_t len, uint32_t seed) {
+  bzero(x1, sizeof(x1));
+  for (int n = 0; n < 31; n++) {
+    x2[n] = (seed >> n) & 0x1;
+  }
+  x1[0] = 1;
+  for (int n = 0; n < Nc + len; n++) {
+    x1[n + 31] = (x1[n + 3] + x1[n]) & 0x1;
+    x2[n + 31] = (x2[n + 3] + x2[n + 2] + x2[n+1] + x2[n]) & 0x1;
+  }
+  for (int n = 0; n < len; n++) {
+    c[n] = (x1[n + Nc] + x2[n + Nc]) & 0x1;
+  }
+}
+
+int main(int argc, char **argv) {
+  uint8_t c_ref[MAX_LEN];
+  uint8_t c[MAX_LEN];
+  uint8_t c_packed[MAX_LEN/8+1];
+  uint8_t c_ref_packed[MAX_LEN/8+1];
+  float   c_f[MAX_LEN];
+  int16_t c_s[MAX_LEN];
+  int8_t  c_sb[MAX_LEN];
+  float   d_f[MAX_LEN];
+  int16_t d_s[MAX_LEN];
+  int8_t  d_sb[MAX_LEN];
+  srslte_sequence_state_t s;
+  struct timeval t[3];
+  uint64_t t_ref = 0, t_gen = 0;
+
+  parse_args(argc, argv);
+  srand(0);
+
+  for (int r=0;r<nof_repetitions;r++) {
+    uint32_t seed = (uint32_t) rand() & 0x7fffffff;
+    uint32_t len  = 1 + (uint32_t) rand() % MAX_LEN;
+
+    gettimeofday(&t[1], NULL);
+    sequence_reference(c_ref, len, seed);
+    gettimeofday(&t[2], NULL);
+    get_time_interval(t);
+    t_ref += t[0].tv_usec;
+
+    gettimeofday(&t[1], NULL);
+    srslte_sequence_state_init(&s, seed);
+    srslte_sequence_state_gen_bits(&s, c, len);
+    gettimeofday(&t[2], NULL);
+    get_time_interval(t);
+    t_gen += t[0].tv_usec;
+
+    if (memcmp(c, c_ref, len)) {
+      fprintf(stderr, "Error in bits seed=0x%x len=%d\n", seed, len);
+      exit(-1);
+    }
+
+    // Generate in pieces of random length, skipping some
+    uint32_t i = 0;
+    srslte_sequence_state_init(&s, seed);
+    while (i < len) {
+      uint32_t n = 1 + (uint32_t) rand() % 100;
+      n = SRSLTE_MIN(len - i, n);
+      if (rand() % 4) {
+        srslte_sequence_state_gen_bits(&s, &c[i], n);
+      } else {
+        srslte_sequence_state_advance(&s, n);
+        memcpy(&c[i], &c_ref[i], n);
+      }
+      i += n;
+    }
+    if (memcmp(c, c_ref, len)) {
+      fprintf(stderr, "Error in split generation seed=0x%x len=%d\n", seed, len);
+      exit(-1);
+    }
+
+    // Signs and packed bits
+    srslte_bit_pack_vector(c_ref, c_ref_packed, len);
+    srslte_sequence_state_init(&s, seed);
+    srslte_sequence_state_gen_packed(&s, c_packed, len);
+    srslte_sequence_state_init(&s, seed);
+    srslte_sequence_state_gen_f(&s, c_f, len);
+    srslte_sequence_state_init(&s, seed);
+    srslte_sequence_state_gen_s(&s, c_s, len);
+    srslte_sequence_state_init(&s, seed);
+    srslte_sequence_state_gen_sb(&s, c_sb, len);
+    if (memcmp(c_packed, c_ref_packed, (len+7)/8)) {
+      fprintf(stderr, "Error in packed bits seed=0x%x len=%d\n", seed, len);
+      exit(-1);
+    }
+    for (uint32_t j=0;j<len;j++) {
+      if (c_f[j] != 1-2*c_ref[j] || c_s[j] != 1-2*c_ref[j] || c_sb[j] != 1-2*c_ref[j]) {
+        fprintf(stderr, "Error in signs seed=0x%x len=%d\n", seed, len);
+        exit(-1);
+      }
+    }
+
+    // Scrambling, in place, of random values
+    for (uint32_t j=0;j<len;j++) {
+      d_f[j]  = (float) (rand() % 201 - 100);
+      d_s[j]  = (int16_t) (rand() % 201 - 100);
+      d_sb[j] = (int8_t) (rand() % 201 - 100);
+      c_f[j]  = d_f[j]*(1-2*c_ref[j]);
+      c_s[j]  = (int16_t) (d_s[j]*(1-2*c_ref[j]));
+      c_sb[j] = (int8_t) (d_sb[j]*(1-2*c_ref[j]));
+      c[j]    = (uint8_t) (rand() % 2);
+    }
+    srslte_bit_pack_vector(c, c_ref_packed, len);
+    srslte_sequence_state_init(&s, seed);
+    srslte_sequence_state_apply_f(&s, d_f, d_f, len);
+    srslte_sequence_state_init(&s, seed);
+    srslte_sequence_state_apply_s(&s, d_s, d_s, len);
+    srslte_sequence_state_init(&s, seed);
+    srslte_sequence_state_apply_sb(&s, d_sb, d_sb, len);
+    srslte_sequence_state_init(&s, seed);
+    srslte_sequence_state_apply_packed(&s, c_ref_packed, c_ref_packed, len);
+    srslte_sequence_state_init(&s, seed);
+    srslte_sequence_state_apply_bits(&s, c, c, len);
+    for (uint32_t j=0;j<len;j++) {
+      if (d_f[j] != c_f[j] || d_s[j] != c_s[j] || d_sb[j] != c_sb[j]) {
+        fprintf(stderr, "Error in scrambling seed=0x%x len=%d\n", seed, len);
+        exit(-1);
+      }
+    }
+    // Scrambling the random bits gives the same as XOR of both packed sequences
+    srslte_bit_pack_vector(c, c, len);
+    for (uint32_t j=0;j<len/8;j++) {
+      if (c[j] != c_ref_packed[j]) {
+        fprintf(stderr, "Error in bit scrambling seed=0x%x len=%d\n", seed, len);
+        exit(-1);
+      }
+    }
+  }
+
+  printf("Ok. Reference: %.1f us, word-parallel: %.1f us per sequence\n",
+         (float) t_ref/nof_repetitions, (float) t_gen/nof_repetitions);
+  exit(0);
+}
@@ -469,6 +469,33 @@ void srslte_ofdm_rx_sf(srslte_ofdm_t *q) {
   }
 }
 
+/* Converts a subframe of complex int16 samples into the input buffer and demodulates it.
+ * scale is the int16 value of a sample of amplitude 1.0 
+ */
+void srslte_ofdm_rx_sf_c16(srslte_ofdm_t *q, const c16_t *input, float scale) {
+  const int16_t *in = (const int16_t*) input;
+  if (q->mbsfn_subframe) {
+    srslte_vec_convert_if(in, scale, (float*) q->in_buffer, 2*2*q->slot_sz);
+    srslte_ofdm_rx_sf(q);
+    return;
+  }
+  // The FFT only reads the useful part of each symbol, the cyclic prefixes are neither converted nor shifted
+  for (uint32_t n=0;n<2;n++) {
+    uint32_t offset = n*q->slot_sz;
+    for (uint32_t i=0;i<q->nof_symbols;i++) {
+      offset += SRSLTE_CP_ISNORM(q->cp)?SRSLTE_CP_LEN_NORM(i, q->symbol_sz):SRSLTE_CP_LEN_EXT(q->symbol_sz);
+      srslte_vec_convert_if(&in[2*offset], scale, (float*) &q->in_buffer[offset], 2*q->symbol_sz);
+      if (q->freq_shift) {
+        srslte_vec_prod_ccc(&q->in_buffer[offset], &q->shift_buffer[offset], &q->in_buffer[offset], q->symbol_sz);
+      }
+      offset += q->symbol_sz;
+    }
+  }
+  for (uint32_t n=0;n<2;n++) {
+    srslte_ofdm_rx_slot(q, n);
+  }
+}
+
 void srslte_ofdm_rx_sf_ng(srslte_ofdm_t *q, cf_t *input, cf_t *output) {
   uint32_t n;
   if (q->freq_shift) {
@@ -597,3 +624,10 @@ void srslte_ofdm_tx_sf(srslte_ofdm_t *q)
   }
 }
 
+/* Modulates the input buffer and converts the subframe to complex int16 samples */
+void srslte_ofdm_tx_sf_c16(srslte_ofdm_t *q, c16_t *output, float scale)
+{
+  srslte_ofdm_tx_sf(q);
+  srslte_vec_convert_fi((float*) q->out_buffer, scale, (int16_t*) output, 2*2*q->slot_sz);
+}
+
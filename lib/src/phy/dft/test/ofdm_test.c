@@ -162,6 +162,33 @@ int main(int argc, char **argv) {
       exit(-1);
     }
 
+    /* Round trip of a whole subframe through complex int16 samples. The scale keeps the
+     * time domain peaks within int16 range, the error is dominated by the quantization */
+    c16_t *sf_c16 = srslte_vec_malloc(sizeof(c16_t) * SRSLTE_SLOT_LEN(srslte_symbol_sz(n_prb)) * 2);
+    if (!sf_c16) {
+      perror("malloc");
+      exit(-1);
+    }
+    for (i=0;i<2*n_re;i++) {
+      input[i] = 100 * ((float) rand() / (float) RAND_MAX + I * ((float) rand() / (float) RAND_MAX));
+    }
+    srslte_ofdm_tx_sf_c16(&ifft, sf_c16, 10.0f);
+    srslte_ofdm_rx_sf_c16(&fft, sf_c16, 10.0f);
+
+    mse = 0.0f;
+    for (i=0;i<2*n_re;i++) {
+      cf_t error = input[i] - outfft[i];
+      mse += (__real__ error * __real__ error + __imag__ error * __imag__ error)/cabsf(input[i]);
+    }
+    mse /= 2*n_re;
+    printf("     c16 MSE=%.6f per RE\n", mse);
+
+    if (mse >= 1e-3) {
+      printf("c16 MSE too large\n");
+      exit(-1);
+    }
+    free(sf_c16);
+
     srslte_ofdm_rx_free(&fft);
     srslte_ofdm_tx_free(&ifft);
 
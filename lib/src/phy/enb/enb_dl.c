@@ -403,6 +403,23 @@ void srslte_enb_dl_gen_signal_mbsfn(srslte_enb_dl_t *q)
   srslte_vec_sc_prod_cfc(q->ifft_mbsfn.out_buffer, norm_factor, q->ifft_mbsfn.out_buffer, (uint32_t) SRSLTE_SF_LEN_PRB(q->cell.nof_prb));
 }
 
+/* Same as srslte_enb_dl_gen_signal() writing complex int16 samples. The normalization
+ * is folded into the conversion. scale is the int16 value of a sample of amplitude 1.0 
+ */
+void srslte_enb_dl_gen_signal_c16(srslte_enb_dl_t *q, c16_t *output[SRSLTE_MAX_PORTS], float scale)
+{
+  float norm_factor = 0.05f / sqrt(q->cell.nof_prb);
+  for (int i = 0; i < q->cell.nof_ports; i++) {
+    srslte_ofdm_tx_sf_c16(&q->ifft[i], output[i], norm_factor * scale);
+  }
+}
+
+void srslte_enb_dl_gen_signal_mbsfn_c16(srslte_enb_dl_t *q, c16_t *output, float scale)
+{
+  float norm_factor = 0.05f / sqrt(q->cell.nof_prb);
+  srslte_ofdm_tx_sf_c16(&q->ifft_mbsfn, output, norm_factor * scale);
+}
+
 int srslte_enb_dl_add_rnti(srslte_enb_dl_t *q, uint16_t rnti)
 {
   return srslte_pdsch_set_rnti(&q->pdsch, rnti);
@@ -50,6 +50,8 @@ int srslte_enb_ul_init(srslte_enb_ul_t *q,
     ret = SRSLTE_ERROR;
     
     bzero(q, sizeof(srslte_enb_ul_t));
+
+    q->mimo_decoder = SRSLTE_MIMO_DECODER_MMSE;
     
     q->users = calloc(sizeof(srslte_enb_ul_user_t*), (1+SRSLTE_SIRNTI));
     if (!q->users) {
@@ -253,11 +255,30 @@ int srslte_enb_ul_cfg_ue(srslte_enb_ul_t *q, uint16_t rnti,
   }
 }
 
+void srslte_enb_ul_set_mimo_decoder(srslte_enb_ul_t *q, srslte_mimo_decoder_t mimo_decoder)
+{
+  if (q) {
+    q->mimo_decoder = mimo_decoder;
+  }
+}
+
+void srslte_enb_ul_set_pusch_fused(srslte_enb_ul_t *q, bool enable)
+{
+  if (q) {
+    q->pusch_fused = enable;
+  }
+}
+
 void srslte_enb_ul_fft(srslte_enb_ul_t *q)
 {
   srslte_ofdm_rx_sf(&q->fft);
 }
 
+void srslte_enb_ul_fft_c16(srslte_enb_ul_t *q, const c16_t *input, float scale)
+{
+  srslte_ofdm_rx_sf_c16(&q->fft, input, scale);
+}
+
 int get_pucch(srslte_enb_ul_t *q, uint16_t rnti, 
               uint32_t pdcch_n_cce, uint32_t sf_rx, 
               srslte_uci_data_t *uci_data, uint8_t bits[SRSLTE_PUCCH_MAX_BITS], uint32_t nof_bits)
@@ -371,16 +392,37 @@ int srslte_enb_ul_get_pusch(srslte_enb_ul_t *q, srslte_ra_ul_grant_t *grant, srs
   
   uint32_t cyclic_shift_for_dmrs = 0; 
   
-  srslte_chest_ul_estimate(&q->chest, q->sf_symbols, q->ce, grant->L_prb, tti%10, cyclic_shift_for_dmrs, grant->n_prb);
+  if (q->pusch_fused) {
+    // Only the DMRS are estimated, the data symbols are equalized as they are decoded
+    if (srslte_chest_ul_estimate_dmrs(&q->chest, q->sf_symbols, grant->L_prb, tti%10, cyclic_shift_for_dmrs, 
+                                      q->pusch_cfg.grant.n_prb_tilde)) {
+      fprintf(stderr, "Error estimating PUSCH DMRS\n");
+      return SRSLTE_ERROR;
+    }
+  } else {
+    srslte_chest_ul_estimate(&q->chest, q->sf_symbols, q->ce, grant->L_prb, tti%10, cyclic_shift_for_dmrs, grant->n_prb);
+  }
   
   float noise_power = srslte_chest_ul_get_noise_estimate(&q->chest); 
+  if (q->mimo_decoder == SRSLTE_MIMO_DECODER_ZF) {
+    noise_power = 0.0f;
+  }
   
-  return srslte_pusch_decode(&q->pusch, &q->pusch_cfg, 
-                              softbuffer, q->sf_symbols, 
-                              q->ce, noise_power, 
-                              rnti, data, 
-                              cqi_value,
-                              uci_data);
+  if (q->pusch_fused) {
+    return srslte_pusch_decode_fused(&q->pusch, &q->pusch_cfg, 
+                                      softbuffer, q->sf_symbols, 
+                                      &q->chest, noise_power, 
+                                      rnti, data, 
+                                      cqi_value,
+                                      uci_data);
+  } else {
+    return srslte_pusch_decode(&q->pusch, &q->pusch_cfg, 
+                                softbuffer, q->sf_symbols, 
+                                q->ce, noise_power, 
+                                rnti, data, 
+                                cqi_value,
+                                uci_data);
+  }
 }
 
 
@@ -31,6 +31,14 @@
 #include "srslte/phy/utils/bit.h"
 #include "srslte/phy/fec/crc.h"
 
+#if defined(LV_HAVE_SSE) && defined(__PCLMUL__)
+#include <x86intrin.h>
+#define CRC_HAVE_PCLMUL
+#endif
+
+/* Shortest buffer worth folding with carry-less multiplications */
+#define CRC_FOLD_MIN_BYTES 64
+
 void gen_crc_table(srslte_crc_t *h) {
 
   int i, j, ord = (h->order - 8);
@@ -46,6 +54,135 @@ void gen_crc_table(srslte_crc_t *h) {
     }
     h->table[i] = crc & h->crcmask;
   }
+
+  /* The tables below work on the checksum shifted to the top of a 32-bit word, which turns
+   * every order into a CRC-32 whose generator is multiplied by x^(32-order) */
+  uint32_t poly32 = (uint32_t) ((h->polynom & h->crcmask) << (32 - h->order));
+  for (i = 0; i < 256; i++) {
+    uint32_t c = (uint32_t) i << 24;
+    for (j = 0; j < 8; j++) {
+      c = (c & 0x80000000) ? (c << 1) ^ poly32 : (c << 1);
+    }
+    h->table8[0][i] = c;
+  }
+  // table8[k][i] is the checksum of byte i followed by k zero bytes
+  for (j = 1; j < 8; j++) {
+    for (i = 0; i < 256; i++) {
+      uint32_t c = h->table8[j - 1][i];
+      h->table8[j][i] = (c << 8) ^ h->table8[0][c >> 24];
+    }
+  }
+}
+
+/* x^n modulo the generator aligned to 32 bits */
+static uint64_t crc_xpow_mod(srslte_crc_t *h, uint32_t n) {
+  uint64_t poly33 = ((uint64_t) 1 << 32) | (uint32_t) ((h->polynom & h->crcmask) << (32 - h->order));
+  uint64_t r = 1;
+  for (uint32_t i = 0; i < n; i++) {
+    r <<= 1;
+    if (r & ((uint64_t) 1 << 32)) {
+      r ^= poly33;
+    }
+  }
+  return r;
+}
+
+static void gen_crc_fold_constants(srslte_crc_t *h) {
+  // A 128-bit remainder X = Xh*x^64 + Xl is shifted by 128 (or 512) bits as Xh*x^(n+64) + Xl*x^n
+  h->fold_k[0] = crc_xpow_mod(h, 128);
+  h->fold_k[1] = crc_xpow_mod(h, 128 + 64);
+  h->fold_k[2] = crc_xpow_mod(h, 512);
+  h->fold_k[3] = crc_xpow_mod(h, 512 + 64);
+}
+
+static uint32_t crc_put_slice8(srslte_crc_t *h, uint32_t crc, uint8_t *data, uint32_t nof_bytes) {
+  uint32_t (*t)[256] = h->table8;
+
+  while (nof_bytes >= 8) {
+    uint32_t a = crc ^ ((uint32_t) data[0] << 24 | (uint32_t) data[1] << 16 | (uint32_t) data[2] << 8 | data[3]);
+    uint32_t b = (uint32_t) data[4] << 24 | (uint32_t) data[5] << 16 | (uint32_t) data[6] << 8 | data[7];
+    crc = t[7][a >> 24] ^ t[6][(a >> 16) & 0xff] ^ t[5][(a >> 8) & 0xff] ^ t[4][a & 0xff] ^
+          t[3][b >> 24] ^ t[2][(b >> 16) & 0xff] ^ t[1][(b >> 8) & 0xff] ^ t[0][b & 0xff];
+    data += 8;
+    nof_bytes -= 8;
+  }
+  while (nof_bytes > 0) {
+    crc = (crc << 8) ^ t[0][(crc >> 24) ^ *data];
+    data++;
+    nof_bytes--;
+  }
+  return crc;
+}
+
+#ifdef CRC_HAVE_PCLMUL
+
+static inline __m128i crc_load_be(uint8_t *ptr) {
+  const __m128i bswap = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+  return _mm_shuffle_epi8(_mm_loadu_si128((__m128i *) ptr), bswap);
+}
+
+/* Returns x * x^n + b modulo the generator, in 128 bits */
+static inline __m128i crc_fold(__m128i x, __m128i k, __m128i b) {
+  __m128i hi = _mm_clmulepi64_si128(x, k, 0x11);
+  __m128i lo = _mm_clmulepi64_si128(x, k, 0x00);
+  return _mm_xor_si128(_mm_xor_si128(hi, lo), b);
+}
+
+/* Folds nof_bytes (a multiple of 16, at least 64) into a 128-bit remainder, four blocks at a time,
+ * and reduces it with the tables */
+static uint32_t crc_put_pclmul(srslte_crc_t *h, uint32_t crc, uint8_t *data, uint32_t nof_bytes) {
+  __m128i k128 = _mm_set_epi64x((long long) h->fold_k[1], (long long) h->fold_k[0]);
+  __m128i k512 = _mm_set_epi64x((long long) h->fold_k[3], (long long) h->fold_k[2]);
+
+  // The running checksum is added to the first 32 bits of the message
+  __m128i x0 = _mm_xor_si128(crc_load_be(&data[0]), _mm_set_epi32((int) crc, 0, 0, 0));
+  __m128i x1 = crc_load_be(&data[16]);
+  __m128i x2 = crc_load_be(&data[32]);
+  __m128i x3 = crc_load_be(&data[48]);
+  data += 64;
+  nof_bytes -= 64;
+
+  while (nof_bytes >= 64) {
+    x0 = crc_fold(x0, k512, crc_load_be(&data[0]));
+    x1 = crc_fold(x1, k512, crc_load_be(&data[16]));
+    x2 = crc_fold(x2, k512, crc_load_be(&data[32]));
+    x3 = crc_fold(x3, k512, crc_load_be(&data[48]));
+    data += 64;
+    nof_bytes -= 64;
+  }
+
+  x1 = crc_fold(x0, k128, x1);
+  x2 = crc_fold(x1, k128, x2);
+  x3 = crc_fold(x2, k128, x3);
+  while (nof_bytes >= 16) {
+    x3 = crc_fold(x3, k128, crc_load_be(data));
+    data += 16;
+    nof_bytes -= 16;
+  }
+
+  // The checksum of the data is the checksum of the 16 bytes of the remainder
+  uint8_t rem[16];
+  const __m128i bswap = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+  _mm_storeu_si128((__m128i *) rem, _mm_shuffle_epi8(x3, bswap));
+  return crc_put_slice8(h, 0, rem, 16);
+}
+
+#endif /* CRC_HAVE_PCLMUL */
+
+void srslte_crc_checksum_put(srslte_crc_t *h, uint8_t *data, uint32_t nof_bytes) {
+  uint32_t crc = (uint32_t) ((h->crcinit & h->crcmask) << (32 - h->order));
+
+#ifdef CRC_HAVE_PCLMUL
+  if (nof_bytes >= CRC_FOLD_MIN_BYTES) {
+    uint32_t n = nof_bytes & ~15u;
+    crc = crc_put_pclmul(h, crc, data, n);
+    data += n;
+    nof_bytes -= n;
+  }
+#endif /* CRC_HAVE_PCLMUL */
+
+  crc = crc_put_slice8(h, crc, data, nof_bytes);
+  h->crcinit = crc >> (32 - h->order);
 }
 
 uint64_t reversecrcbit(uint32_t crc, int nbits, srslte_crc_t *h) {
@@ -96,42 +233,38 @@ int srslte_crc_init(srslte_crc_t *h, uint32_t crc_poly, int crc_order) {
 
   // generate lookup table
   gen_crc_table(h);
+  gen_crc_fold_constants(h);
 
   return 0;
 }
 
 uint32_t srslte_crc_checksum(srslte_crc_t *h, uint8_t *data, int len) {
-  int i, k, len8, res8, a = 0;
+  int k, len8, res8;
   uint32_t crc = 0;
-  uint8_t *pter;
+  uint8_t packed[64];
 
   srslte_crc_set_init(h, 0);
 
-  // Pack bits into bytes
   len8 = (len >> 3);
   res8 = (len - (len8 << 3));
-  if (res8 > 0) {
-    a = 1;
-  }
 
-  // Calculate CRC
-  for (i = 0; i < len8 + a; i++) {
-    pter = (uint8_t *) (data + 8 * i);
-    uint8_t byte;
-    if (i == len8) {
-      byte = 0x00;
-      for (k = 0; k < res8; k++) {
-        byte |= ((uint8_t) *(pter + k)) << (7 - k);
-      }
-    } else {
-      byte = (uint8_t) (srslte_bit_pack(&pter, 8) & 0xFF);
+  // Pack bits into bytes and calculate CRC
+  for (int i = 0; i < len8; i += sizeof(packed)) {
+    int n = (len8 - i < (int) sizeof(packed)) ? len8 - i : (int) sizeof(packed);
+    srslte_bit_pack_vector(&data[8 * i], packed, 8 * n);
+    srslte_crc_checksum_put(h, packed, (uint32_t) n);
+  }
+  if (res8 > 0) {
+    uint8_t byte = 0x00;
+    for (k = 0; k < res8; k++) {
+      byte |= ((uint8_t) data[8 * len8 + k]) << (7 - k);
     }
     srslte_crc_checksum_put_byte(h, byte);
   }
   crc = (uint32_t) srslte_crc_checksum_get(h);
 
   // Reverse CRC res8 positions
-  if (a == 1) {
+  if (res8 > 0) {
     crc = reversecrcbit(crc, 8 - res8, h);
   }
 
@@ -142,15 +275,12 @@ uint32_t srslte_crc_checksum(srslte_crc_t *h, uint8_t *data, int len) {
 
 // len is multiple of 8
 uint32_t srslte_crc_checksum_byte(srslte_crc_t *h, uint8_t *data, int len) {
-  int i;
   uint32_t crc = 0;
 
   srslte_crc_set_init(h, 0);
 
   // Calculate CRC
-  for (i = 0; i < len/8; i++) {
-    srslte_crc_checksum_put_byte(h, data[i]);
-  }
+  srslte_crc_checksum_put(h, data, (uint32_t) len / 8);
   crc = (uint32_t) srslte_crc_checksum_get(h);
 
   return crc;
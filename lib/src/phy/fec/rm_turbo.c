@@ -44,14 +44,6 @@
 
 #ifdef LV_HAVE_SSE
 #include <x86intrin.h>
-int srslte_rm_turbo_rx_lut_sse(int16_t *input, int16_t *output, uint16_t *deinter, uint32_t in_len, uint32_t cb_idx, uint32_t rv_idx);
-int srslte_rm_turbo_rx_lut_sse_8bit(int8_t *input, int8_t *output, uint16_t *deinter, uint32_t in_len, uint32_t cb_idx, uint32_t rv_idx);
-#endif
-
-#ifdef LV_HAVE_AVX
-#include <x86intrin.h>
-int srslte_rm_turbo_rx_lut_avx(int16_t *input, int16_t *output, uint16_t *deinter, uint32_t in_len, uint32_t cb_idx, uint32_t rv_idx);
-int srslte_rm_turbo_rx_lut_avx_8bit(int8_t *input, int8_t *output, uint16_t *deinter, uint32_t in_len, uint32_t cb_idx, uint32_t rv_idx);
 #endif
 
 #define NCOLS 32
@@ -60,37 +52,31 @@ int srslte_rm_turbo_rx_lut_avx_8bit(int8_t *input, int8_t *output, uint16_t *dei
 static uint8_t RM_PERM_TC[NCOLS] = { 0, 16, 8, 24, 4, 20, 12, 28, 2, 18, 10, 26,
     6, 22, 14, 30, 1, 17, 9, 25, 5, 21, 13, 29, 3, 19, 11, 27, 7, 23, 15, 31 };
 
+/* Largest sub-block interleaver and circular buffer */
+#define RM_MAX_KP   (NCOLS * ((SRSLTE_TCOD_MAX_LEN_CB + 4 + NCOLS - 1) / NCOLS))
+#define RM_MAX_NCB  (3 * RM_MAX_KP)
+#define RM_MAX_RUNS 128
+
 /* Align tables to 16-byte boundary */
 
 static uint16_t interleaver_systematic_bits[192][6160]; // 4 tail bits
 static srslte_bit_interleaver_t bit_interleavers_systematic_bits[192];
 static uint16_t interleaver_parity_bits[192][2*6160];
 static srslte_bit_interleaver_t bit_interleavers_parity_bits[192];
-static uint16_t deinterleaver[192][4][18448];
 static int k0_vec[SRSLTE_NOF_TC_CB_SIZES][4][2];
 static bool rm_turbo_tables_generated = false;
 
+/* Segments of the circular buffer that do not hold dummy bits. The receiver
+ * copies the soft bits of a whole segment at once */
+typedef struct {
+  uint16_t nof_runs;
+  uint16_t start[RM_MAX_RUNS];
+  uint16_t len[RM_MAX_RUNS];
+  uint16_t k0_run[4];     // Segment and offset of the first bit of each redundancy version
+  uint16_t k0_offset[4];
+} rm_turbo_runs_t;
 
-// Store deinterleaver version for sub-block turbo decoder
-#if SRSLTE_TDEC_EXPECT_INPUT_SB == 1
-// Prepare bit for sub-block decoder processing. These are the nof subblock sizes
-#define NOF_DEINTER_TABLE_SB_IDX 3
-const static int deinter_table_sb_idx[NOF_DEINTER_TABLE_SB_IDX] = {8, 16, 32};
-int deinter_table_idx_from_sb_len(uint32_t nof_subblocks) {
-  for (int i=0;i<NOF_DEINTER_TABLE_SB_IDX;i++) {
-    if (deinter_table_sb_idx[i] == nof_subblocks) {
-      return i;
-    }
-  }
-  if (nof_subblocks != 0) {
-    fprintf(stderr, "Error number of sub-blocks %d not supported in RM\n", nof_subblocks);
-  }
-  return -1;
-}
-static uint16_t deinterleaver_sb[NOF_DEINTER_TABLE_SB_IDX][192][4][18448];
-#endif
-
-static uint16_t temp_table1[3*6176], temp_table2[3*6176];
+static rm_turbo_runs_t rm_runs[SRSLTE_NOF_TC_CB_SIZES];
 
 static void srslte_rm_turbo_gentable_systematic(uint16_t *table_bits, int k0_vec[4][2], uint32_t nrows, int ndummy) {
 
@@ -161,108 +147,60 @@ static void srslte_rm_turbo_gentable_parity(uint16_t *table_parity, int k0_vec[4
   }
 }
 
-static void srslte_rm_turbo_gentable_receive(uint16_t *table, uint32_t cb_len, uint32_t rv_idx)
+static int srslte_rm_turbo_gentable_runs(rm_turbo_runs_t *t, uint32_t cb_len)
 {
-  
   int nrows = (uint32_t) (cb_len / 3 - 1) / NCOLS + 1;
-  int ndummy = nrows*NCOLS - cb_len / 3;
+  int K_p = nrows * NCOLS;
+  int N_cb = 3 * K_p;
+  int ndummy = K_p - cb_len / 3;
   if (ndummy < 0) {
     ndummy = 0;
   }
 
-  /* Undo bit collection. Account for dummy bits */
-  int N_cb = 3*nrows*NCOLS;   
-  int k0 = nrows*(2*(uint16_t) ceilf((float) N_cb/(float) (8*nrows))*rv_idx+2);
-
-  int kidx; 
-  int K_p = nrows * NCOLS;
-  int k = 0, jp=0, j=0;  
-  bool isdummy = false; 
-  int d_i, d_j; 
-  while (k < cb_len) {
-    jp = (k0 + j) % N_cb;
-
-    if (jp < K_p || !(jp % 2)) {
-      if (jp >= K_p) {
-        d_i = ((jp - K_p) / 2) / nrows;
-        d_j = ((jp - K_p) / 2) % nrows;
-      } else {
-        d_i = jp / nrows;
-        d_j = jp % nrows;        
-      }      
-      if (d_j * NCOLS + RM_PERM_TC[d_i] >= ndummy) {
-        isdummy = false;
-        if (d_j * NCOLS + RM_PERM_TC[d_i] - ndummy < 0) {
-          isdummy = true;
-        } 
-      } else {
-        isdummy = true;
-      }
-
+  bool in_run = false;
+  t->nof_runs = 0;
+  for (int k = 0; k < N_cb; k++) {
+    bool isdummy;
+    if (k < K_p) {
+      isdummy = (k % nrows) * NCOLS + RM_PERM_TC[k / nrows] < ndummy;
+    } else if (!((k - K_p) % 2)) {
+      int kp = (k - K_p) / 2;
+      isdummy = (kp % nrows) * NCOLS + RM_PERM_TC[kp / nrows] < ndummy;
     } else {
-      uint32_t jpp = (jp - K_p - 1) / 2;
-      kidx = (RM_PERM_TC[jpp / nrows] + NCOLS * (jpp % nrows) + 1) % K_p;
-      if ((kidx - ndummy) < 0) {
-        isdummy = true;
-      } else {
-        isdummy = false;
-      }      
+      int kp = (k - K_p - 1) / 2;
+      isdummy = (RM_PERM_TC[kp / nrows] + NCOLS * (kp % nrows) + 1) % K_p < ndummy;
     }
-    
     if (!isdummy) {
-      temp_table1[k] = jp%(3*nrows*NCOLS);
-      k++;
+      if (!in_run) {
+        if (t->nof_runs == RM_MAX_RUNS) {
+          return SRSLTE_ERROR;
+        }
+        t->start[t->nof_runs] = (uint16_t) k;
+        t->len[t->nof_runs] = 0;
+        t->nof_runs++;
+      }
+      t->len[t->nof_runs - 1]++;
     }
-    j++;
+    in_run = !isdummy;
   }
 
-  for (int i = 0; i < cb_len / 3; i++) {
-    d_i = (i + ndummy) / NCOLS;
-    d_j = (i + ndummy) % NCOLS;
-    for (j = 0; j < 3; j++) {
-      if (j != 2) {
-        kidx = K_p * j + (j + 1) * (RM_PERM_TC[d_j] * nrows + d_i);
-      } else {
-        k = (i + ndummy - 1) % K_p;
-        if (k < 0)
-          k += K_p;
-        kidx = (k / NCOLS + nrows * RM_PERM_TC[k % NCOLS]) % K_p;
-        kidx = 2 * kidx + K_p + 1;
-      }
-      temp_table2[kidx] = 3*i+j;
+  /* Each redundancy version starts at the first bit from k0 that is not a dummy bit */
+  for (int rv = 0; rv < 4; rv++) {
+    int k0 = nrows * (2 * (uint16_t) ceilf((float) N_cb / (float) (8 * nrows)) * rv + 2);
+    int r = 0;
+    while (r < t->nof_runs && t->start[r] + t->len[r] <= k0) {
+      r++;
     }
-  }
-  for (int i=0;i<cb_len;i++) {
-    table[i] = temp_table2[temp_table1[i]];
-  }
-}
-#if SRSLTE_TDEC_EXPECT_INPUT_SB==1
-#define inter(x,win) ((x%(long_cb/win))*(win)+x/(long_cb/win))
-
-/* Prepare output for sliding window decoder:
- * (0..long_cb-1) bits are systematic
- * (long_cb..2*long_cb-1) are parity0
- * (2*long_cb..3*long_cb-1) are parity1
- * then tail bits
- *
- * Within each block, bits are interleaved every nof_sb
- */
-static void interleave_table_sb(uint16_t *in, uint16_t *out, uint32_t cb_idx, uint32_t nof_sb)
-{
-  int long_cb = srslte_cbsegm_cbsize(cb_idx);
-  int out_len = 3*long_cb+12;
-  for (int i=0;i<out_len;i++) {
-    // Do not change tail bit order
-    if (in[i] < 3*long_cb) {
-
-      // align to 32 bytes (warning: must be same alignment as in rm_turbo.c)
-      out[i] = (in[i]%3)*(long_cb+32)+inter(in[i]/3,nof_sb);
+    if (r < t->nof_runs) {
+      t->k0_run[rv] = (uint16_t) r;
+      t->k0_offset[rv] = (uint16_t) (k0 > t->start[r] ? k0 - t->start[r] : 0);
     } else {
-      out[i] = (in[i]-3*long_cb)+3*(long_cb+32);
+      t->k0_run[rv] = 0;
+      t->k0_offset[rv] = 0;
     }
   }
+  return SRSLTE_SUCCESS;
 }
-#endif
 
 void srslte_rm_turbo_gentables() {
   if (!rm_turbo_tables_generated) {
@@ -290,15 +228,8 @@ void srslte_rm_turbo_gentables() {
       srslte_bit_interleaver_init(&bit_interleavers_parity_bits[cb_idx], interleaver_parity_bits[cb_idx],
                                   (uint32_t) (srslte_cbsegm_cbsize(cb_idx) + 4) * 2);
 
-      for (int i = 0; i < 4; i++) {
-        srslte_rm_turbo_gentable_receive(deinterleaver[cb_idx][i], in_len, i);
-
-#if SRSLTE_TDEC_EXPECT_INPUT_SB == 1
-        for (uint32_t s = 0; s < NOF_DEINTER_TABLE_SB_IDX; s++) {
-          interleave_table_sb(deinterleaver[cb_idx][i], deinterleaver_sb[s][cb_idx][i], cb_idx,
-                              deinter_table_sb_idx[s]);
-        }
-#endif
+      if (srslte_rm_turbo_gentable_runs(&rm_runs[cb_idx], in_len)) {
+        fprintf(stderr, "Error generating rate matching tables for cb_idx=%d\n", cb_idx);
       }
     }
   }
@@ -375,364 +306,413 @@ int srslte_rm_turbo_tx_lut(uint8_t *w_buff, uint8_t *systematic, uint8_t *parity
   }
 }
 
-int srslte_rm_turbo_rx_lut(int16_t *input, int16_t *output, uint32_t in_len, uint32_t cb_idx, uint32_t rv_idx)
-{
-  return srslte_rm_turbo_rx_lut_(input, output, in_len, cb_idx, rv_idx, true);
+/* Soft combining saturates instead of wrapping around */
+static inline int16_t rm_sat_s(int32_t x) {
+  return (int16_t) (x > INT16_MAX ? INT16_MAX : (x < INT16_MIN ? INT16_MIN : x));
 }
-/**
- * Undoes rate matching for LTE Turbo Coder. Expands rate matched buffer to full size buffer.
- *
- * @param[in] input Input buffer of size in_len
- * @param[out] output Output buffer of size 3*srslte_cbsegm_cbsize(cb_idx)+12
- * @param[in] cb_idx Code block table index
- * @param[in] rv_idx Redundancy Version from DCI control message
- * @return Error code
- */
-int srslte_rm_turbo_rx_lut_(int16_t *input, int16_t *output, uint32_t in_len, uint32_t cb_idx, uint32_t rv_idx, bool enable_input_tdec)
-{
 
-  if (rv_idx < 4 && cb_idx < SRSLTE_NOF_TC_CB_SIZES) {
+static inline int8_t rm_sat_b(int32_t x) {
+  return (int8_t) (x > INT8_MAX ? INT8_MAX : (x < INT8_MIN ? INT8_MIN : x));
+}
 
-#if SRSLTE_TDEC_EXPECT_INPUT_SB == 1
-  int cb_len=srslte_cbsegm_cbsize(cb_idx);
-  int idx = deinter_table_idx_from_sb_len(srslte_tdec_autoimp_get_subblocks(cb_len));
-  uint16_t *deinter = NULL;
-  if (idx < 0 || !enable_input_tdec) {
-    deinter = deinterleaver[cb_idx][rv_idx];
-  } else if (idx < NOF_DEINTER_TABLE_SB_IDX) {
-    deinter = deinterleaver_sb[idx][cb_idx][rv_idx];
-  } else {
-    fprintf(stderr, "Sub-block size index %d not supported in srslte_rm_turbo_rx_lut()\n", idx);
-    return -1;
+static void rm_add_s(int16_t *x, int16_t *y, uint32_t len) {
+  uint32_t i = 0;
+#ifdef LV_HAVE_SSE
+  for (; i + 8 <= len; i += 8) {
+    __m128i a = _mm_loadu_si128((__m128i *) &x[i]);
+    __m128i b = _mm_loadu_si128((__m128i *) &y[i]);
+    _mm_storeu_si128((__m128i *) &x[i], _mm_adds_epi16(a, b));
   }
-#else
-  uint16_t *deinter = deinterleaver[cb_idx][rv_idx];
-#endif
-
-  #ifdef LV_HAVE_AVX
-    return srslte_rm_turbo_rx_lut_avx(input, output, deinter, in_len, cb_idx, rv_idx);
-  #else
-  #ifdef LV_HAVE_SSE
-    return srslte_rm_turbo_rx_lut_sse(input, output, deinter, in_len, cb_idx, rv_idx);
-  #else
-      uint32_t out_len = 3*srslte_cbsegm_cbsize(cb_idx)+12;
-
-      for (int i=0;i<in_len;i++) {
-        output[deinter[i%out_len]] += input[i];
-      }
-      return 0;    
-  #endif
-#endif
-  } else {
-    printf("Invalid inputs rv_idx=%d, cb_idx=%d\n", rv_idx, cb_idx);
-    return SRSLTE_ERROR_INVALID_INPUTS;
+#endif /* LV_HAVE_SSE */
+  for (; i < len; i++) {
+    x[i] = rm_sat_s(x[i] + y[i]);
   }
 }
 
-int srslte_rm_turbo_rx_lut_8bit(int8_t *input, int8_t *output, uint32_t in_len, uint32_t cb_idx, uint32_t rv_idx)
-{
-  if (rv_idx < 4 && cb_idx < SRSLTE_NOF_TC_CB_SIZES) {
+static void rm_add_b(int8_t *x, int8_t *y, uint32_t len) {
+  uint32_t i = 0;
+#ifdef LV_HAVE_SSE
+  for (; i + 16 <= len; i += 16) {
+    __m128i a = _mm_loadu_si128((__m128i *) &x[i]);
+    __m128i b = _mm_loadu_si128((__m128i *) &y[i]);
+    _mm_storeu_si128((__m128i *) &x[i], _mm_adds_epi8(a, b));
+  }
+#endif /* LV_HAVE_SSE */
+  for (; i < len; i++) {
+    x[i] = rm_sat_b(x[i] + y[i]);
+  }
+}
 
-#if SRSLTE_TDEC_EXPECT_INPUT_SB == 1
-    int cb_len=srslte_cbsegm_cbsize(cb_idx);
-    int idx = deinter_table_idx_from_sb_len(srslte_tdec_autoimp_get_subblocks_8bit(cb_len));
-    uint16_t *deinter = NULL;
-    if (idx < 0) {
-      deinter = deinterleaver[cb_idx][rv_idx];
-    } else if (idx < NOF_DEINTER_TABLE_SB_IDX) {
-      deinter = deinterleaver_sb[idx][cb_idx][rv_idx];
+/* Undoes the bit selection of len <= 3*K+12 soft bits starting at k0: the soft bits are written
+ * (or combined) segment by segment into the circular buffer w, skipping the dummy bits */
+static void rm_fold_s(rm_turbo_runs_t *t, uint32_t rv_idx, int16_t *input, uint32_t len, int16_t *w, bool combine) {
+  uint32_t r = t->k0_run[rv_idx];
+  uint32_t offset = t->k0_offset[rv_idx];
+  while (len > 0) {
+    uint32_t n = SRSLTE_MIN(t->len[r] - offset, len);
+    if (combine) {
+      rm_add_s(&w[t->start[r] + offset], input, n);
     } else {
-      fprintf(stderr, "Sub-block size index %d not supported in srslte_rm_turbo_rx_lut()\n", idx);
-      return -1;
+      memcpy(&w[t->start[r] + offset], input, sizeof(int16_t) * n);
     }
-#else
-    uint16_t *deinter = deinterleaver[cb_idx][rv_idx];
-#endif
+    input += n;
+    len -= n;
+    offset = 0;
+    r = (r + 1) % t->nof_runs;
+  }
+}
 
-    // FIXME: AVX version of rm_turbo_rx_lut not working
-    // Warning: Need to check if 8-bit sse version is correct
+static void rm_fold_b(rm_turbo_runs_t *t, uint32_t rv_idx, int8_t *input, uint32_t len, int8_t *w, bool combine) {
+  uint32_t r = t->k0_run[rv_idx];
+  uint32_t offset = t->k0_offset[rv_idx];
+  while (len > 0) {
+    uint32_t n = SRSLTE_MIN(t->len[r] - offset, len);
+    if (combine) {
+      rm_add_b(&w[t->start[r] + offset], input, n);
+    } else {
+      memcpy(&w[t->start[r] + offset], input, sizeof(int8_t) * n);
+    }
+    input += n;
+    len -= n;
+    offset = 0;
+    r = (r + 1) % t->nof_runs;
+  }
+}
 
 #ifdef LV_HAVE_SSE
-    return srslte_rm_turbo_rx_lut_sse_8bit(input, output, deinter, in_len, cb_idx, rv_idx);
-#else
-    uint32_t out_len = 3*srslte_cbsegm_cbsize(cb_idx)+12;
 
-    for (int i=0;i<in_len;i++) {
-      output[deinter[i%out_len]] += input[i];
-    }
-    return 0;
-#endif
+/* Loads 8 soft bits separated by stride (1 or 2) */
+static inline __m128i rm_load8_s(int16_t *ptr, uint32_t stride) {
+  if (stride == 1) {
+    return _mm_loadu_si128((__m128i *) ptr);
   } else {
-    printf("Invalid inputs rv_idx=%d, cb_idx=%d\n", rv_idx, cb_idx);
-    return SRSLTE_ERROR_INVALID_INPUTS;
+    __m128i even = _mm_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1);
+    __m128i lo = _mm_shuffle_epi8(_mm_loadu_si128((__m128i *) ptr), even);
+    __m128i hi = _mm_shuffle_epi8(_mm_loadu_si128((__m128i *) (ptr + 8)), even);
+    return _mm_unpacklo_epi64(lo, hi);
   }
 }
 
+static inline __m128i rm_load16_b(int8_t *ptr, uint32_t stride) {
+  if (stride == 1) {
+    return _mm_loadu_si128((__m128i *) ptr);
+  } else {
+    __m128i even = _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, -1, -1, -1, -1, -1, -1, -1, -1);
+    __m128i lo = _mm_shuffle_epi8(_mm_loadu_si128((__m128i *) ptr), even);
+    __m128i hi = _mm_shuffle_epi8(_mm_loadu_si128((__m128i *) (ptr + 16)), even);
+    return _mm_unpacklo_epi64(lo, hi);
+  }
+}
 
-#ifdef LV_HAVE_SSE
+static inline void rm_store8_s(int16_t *ptr, __m128i x, bool combine) {
+  if (combine) {
+    x = _mm_adds_epi16(_mm_loadu_si128((__m128i *) ptr), x);
+  }
+  _mm_storeu_si128((__m128i *) ptr, x);
+}
 
-int srslte_rm_turbo_rx_lut_sse(int16_t *input, int16_t *output, uint16_t *deinter, uint32_t in_len, uint32_t cb_idx, uint32_t rv_idx)
-{
-  if (rv_idx < 4 && cb_idx < SRSLTE_NOF_TC_CB_SIZES) {
-    uint32_t out_len = 3*srslte_cbsegm_cbsize(cb_idx)+12;
+static inline void rm_store8_b(int8_t *ptr, __m128i x, bool combine) {
+  if (combine) {
+    x = _mm_adds_epi8(_mm_loadl_epi64((__m128i *) ptr), x);
+  }
+  _mm_storel_epi64((__m128i *) ptr, x);
+}
 
-    const __m128i* xPtr   = (const __m128i*) input;
-    const __m128i* lutPtr = (const __m128i*) deinter;
-    __m128i xVal, lutVal;
-    
-    /* Simplify load if we do not need to wrap (ie high rates) */
-    if (in_len <= out_len) {
-      for (int i=0;i<in_len/8;i++) {
-        xVal   = _mm_loadu_si128(xPtr);
-        lutVal = _mm_loadu_si128(lutPtr);
-      
-        for (int j=0;j<8;j++) {
-          int16_t x  = (int16_t)  _mm_extract_epi16(xVal,   j); 
-          uint16_t l = (uint16_t) _mm_extract_epi16(lutVal, j);
-          output[l] += x;
-        }
-        xPtr ++;
-        lutPtr ++;
-      }
-      for (int i=8*(in_len/8);i<in_len;i++) {      
-        output[deinter[i%out_len]] += input[i];
-      }
-    } else {
-      int intCnt = 8;
-      int inputCnt = 0;
-      int nwrapps = 0; 
-      while(inputCnt < in_len - 8) {
-        xVal   = _mm_loadu_si128(xPtr);
-        lutVal = _mm_loadu_si128(lutPtr);
-      
-        for (int j=0;j<8;j++) {
-          int16_t x  = (int16_t)  _mm_extract_epi16(xVal,   j); 
-          uint16_t l = (uint16_t) _mm_extract_epi16(lutVal, j);
-          output[l] += x;
-        }
-        xPtr++;
-        lutPtr++;
-        intCnt   += 8;
-        inputCnt += 8;
-        if (intCnt >= out_len && inputCnt < in_len - 8) {
-          /* Copy last elements */
-          for (int j=(nwrapps+1)*out_len-4;j<(nwrapps+1)*out_len;j++) {      
-            output[deinter[j%out_len]] += input[j];
-            inputCnt++;
-          }
-          /* And wrap pointers */
-          nwrapps++;
-          intCnt = 8; 
-          xPtr   = (const __m128i*) &input[nwrapps*out_len];
-          lutPtr = (const __m128i*) deinter;
-        }
-      }      
-      for (int i=inputCnt;i<in_len;i++) {      
-        output[deinter[i%out_len]] += input[i];
-      }
-    }
+#endif /* LV_HAVE_SSE */
 
-    
-    return 0;    
-  } else {
-    printf("Invalid inputs rv_idx=%d, cb_idx=%d\n", rv_idx, cb_idx);
-    return SRSLTE_ERROR_INVALID_INPUTS; 
+/* Transposes nof_rows (a multiple of 8) rows of len soft bits separated by stride:
+ * output[i * nof_rows + j] = rows[j][i * stride]. With combine, the result is added to the output */
+static void rm_transpose_s(int16_t **rows, uint32_t nof_rows, uint32_t len, uint32_t stride, int16_t *output,
+                           bool combine) {
+  uint32_t i = 0;
+#ifdef LV_HAVE_SSE
+  for (; i + 8 <= len; i += 8) {
+    for (uint32_t j = 0; j < nof_rows; j += 8) {
+      __m128i a0 = rm_load8_s(&rows[j + 0][i * stride], stride);
+      __m128i a1 = rm_load8_s(&rows[j + 1][i * stride], stride);
+      __m128i a2 = rm_load8_s(&rows[j + 2][i * stride], stride);
+      __m128i a3 = rm_load8_s(&rows[j + 3][i * stride], stride);
+      __m128i a4 = rm_load8_s(&rows[j + 4][i * stride], stride);
+      __m128i a5 = rm_load8_s(&rows[j + 5][i * stride], stride);
+      __m128i a6 = rm_load8_s(&rows[j + 6][i * stride], stride);
+      __m128i a7 = rm_load8_s(&rows[j + 7][i * stride], stride);
+
+      __m128i b0 = _mm_unpacklo_epi16(a0, a1);
+      __m128i b1 = _mm_unpackhi_epi16(a0, a1);
+      __m128i b2 = _mm_unpacklo_epi16(a2, a3);
+      __m128i b3 = _mm_unpackhi_epi16(a2, a3);
+      __m128i b4 = _mm_unpacklo_epi16(a4, a5);
+      __m128i b5 = _mm_unpackhi_epi16(a4, a5);
+      __m128i b6 = _mm_unpacklo_epi16(a6, a7);
+      __m128i b7 = _mm_unpackhi_epi16(a6, a7);
+
+      __m128i c0 = _mm_unpacklo_epi32(b0, b2);
+      __m128i c1 = _mm_unpackhi_epi32(b0, b2);
+      __m128i c2 = _mm_unpacklo_epi32(b1, b3);
+      __m128i c3 = _mm_unpackhi_epi32(b1, b3);
+      __m128i c4 = _mm_unpacklo_epi32(b4, b6);
+      __m128i c5 = _mm_unpackhi_epi32(b4, b6);
+      __m128i c6 = _mm_unpacklo_epi32(b5, b7);
+      __m128i c7 = _mm_unpackhi_epi32(b5, b7);
+
+      int16_t *out = &output[i * nof_rows + j];
+      rm_store8_s(&out[0 * nof_rows], _mm_unpacklo_epi64(c0, c4), combine);
+      rm_store8_s(&out[1 * nof_rows], _mm_unpackhi_epi64(c0, c4), combine);
+      rm_store8_s(&out[2 * nof_rows], _mm_unpacklo_epi64(c1, c5), combine);
+      rm_store8_s(&out[3 * nof_rows], _mm_unpackhi_epi64(c1, c5), combine);
+      rm_store8_s(&out[4 * nof_rows], _mm_unpacklo_epi64(c2, c6), combine);
+      rm_store8_s(&out[5 * nof_rows], _mm_unpackhi_epi64(c2, c6), combine);
+      rm_store8_s(&out[6 * nof_rows], _mm_unpacklo_epi64(c3, c7), combine);
+      rm_store8_s(&out[7 * nof_rows], _mm_unpackhi_epi64(c3, c7), combine);
+    }
+  }
+#endif /* LV_HAVE_SSE */
+  for (; i < len; i++) {
+    for (uint32_t j = 0; j < nof_rows; j++) {
+      int16_t x = rows[j][i * stride];
+      output[i * nof_rows + j] = combine ? rm_sat_s(output[i * nof_rows + j] + x) : x;
+    }
   }
 }
 
-int srslte_rm_turbo_rx_lut_sse_8bit(int8_t *input, int8_t *output, uint16_t *deinter, uint32_t in_len, uint32_t cb_idx, uint32_t rv_idx)
-{
-  if (rv_idx < 4 && cb_idx < SRSLTE_NOF_TC_CB_SIZES) {
-    uint32_t out_len = 3*srslte_cbsegm_cbsize(cb_idx)+12;
-
-    const __m128i* xPtr   = (const __m128i*) input;
-    const __m128i* lutPtr = (const __m128i*) deinter;
-    __m128i xVal, lutVal1, lutVal2;
-
-    /* Simplify load if we do not need to wrap (ie high rates) */
-    if (in_len <= out_len) {
-      for (int i=0;i<in_len/16;i++) {
-        xVal   = _mm_loadu_si128(xPtr);
-        xPtr ++;
-        lutVal1 = _mm_loadu_si128(lutPtr);
-        lutPtr++;
-        lutVal2 = _mm_loadu_si128(lutPtr);
-        lutPtr ++;
-
-        for (int j=0;j<8;j++) {
-          int8_t x  = (int8_t)  _mm_extract_epi8(xVal,   j);
-          uint16_t l = (uint16_t) _mm_extract_epi16(lutVal1, j);
-          output[l] += x;
-        }
-        for (int j=0;j<8;j++) {
-          int8_t x  = (int8_t)  _mm_extract_epi8(xVal,   j+8);
-          uint16_t l = (uint16_t) _mm_extract_epi16(lutVal2, j);
-          output[l] += x;
-        }
-      }
-      for (int i=16*(in_len/16);i<in_len;i++) {
-        output[deinter[i%out_len]] += input[i];
-      }
-    } else {
-      int intCnt = 16;
-      int inputCnt = 0;
-      int nwrapps = 0;
-      while(inputCnt < in_len - 16) {
-        xVal   = _mm_loadu_si128(xPtr);
-        xPtr ++;
-        lutVal1 = _mm_loadu_si128(lutPtr);
-        lutPtr++;
-        lutVal2 = _mm_loadu_si128(lutPtr);
-        lutPtr ++;
-
-        for (int j=0;j<8;j++) {
-          int8_t x  = (int8_t)  _mm_extract_epi8(xVal,   j);
-          uint16_t l = (uint16_t) _mm_extract_epi16(lutVal1, j);
-          output[l] += x;
-        }
-        for (int j=0;j<8;j++) {
-          int8_t x  = (int8_t)  _mm_extract_epi8(xVal,   j+8);
-          uint16_t l = (uint16_t) _mm_extract_epi16(lutVal2, j);
-          output[l] += x;
-        }
-        intCnt   += 16;
-        inputCnt += 16;
-        if (intCnt >= out_len && inputCnt < in_len - 16) {
-          /* Copy last elements */
-          if ((out_len%16) == 12) {
-            for (int j=(nwrapps+1)*out_len-12;j<(nwrapps+1)*out_len;j++) {
-              output[deinter[j%out_len]] += input[j];
-              inputCnt++;
-            }
-          } else {
-            for (int j=(nwrapps+1)*out_len-4;j<(nwrapps+1)*out_len;j++) {
-              output[deinter[j%out_len]] += input[j];
-              inputCnt++;
-            }
-          }
-          /* And wrap pointers */
-          nwrapps++;
-          intCnt = 16;
-          xPtr   = (const __m128i*) &input[nwrapps*out_len];
-          lutPtr = (const __m128i*) deinter;
-        }
-      }
-      for (int i=inputCnt;i<in_len;i++) {
-        output[deinter[i%out_len]] += input[i];
+static void rm_transpose_b(int8_t **rows, uint32_t nof_rows, uint32_t len, uint32_t stride, int8_t *output,
+                           bool combine) {
+  uint32_t i = 0;
+#ifdef LV_HAVE_SSE
+  for (; i + 16 <= len; i += 16) {
+    for (uint32_t j = 0; j < nof_rows; j += 8) {
+      __m128i a0 = rm_load16_b(&rows[j + 0][i * stride], stride);
+      __m128i a1 = rm_load16_b(&rows[j + 1][i * stride], stride);
+      __m128i a2 = rm_load16_b(&rows[j + 2][i * stride], stride);
+      __m128i a3 = rm_load16_b(&rows[j + 3][i * stride], stride);
+      __m128i a4 = rm_load16_b(&rows[j + 4][i * stride], stride);
+      __m128i a5 = rm_load16_b(&rows[j + 5][i * stride], stride);
+      __m128i a6 = rm_load16_b(&rows[j + 6][i * stride], stride);
+      __m128i a7 = rm_load16_b(&rows[j + 7][i * stride], stride);
+
+      __m128i b0 = _mm_unpacklo_epi8(a0, a1);
+      __m128i b1 = _mm_unpackhi_epi8(a0, a1);
+      __m128i b2 = _mm_unpacklo_epi8(a2, a3);
+      __m128i b3 = _mm_unpackhi_epi8(a2, a3);
+      __m128i b4 = _mm_unpacklo_epi8(a4, a5);
+      __m128i b5 = _mm_unpackhi_epi8(a4, a5);
+      __m128i b6 = _mm_unpacklo_epi8(a6, a7);
+      __m128i b7 = _mm_unpackhi_epi8(a6, a7);
+
+      __m128i c0 = _mm_unpacklo_epi16(b0, b2);
+      __m128i c1 = _mm_unpackhi_epi16(b0, b2);
+      __m128i c2 = _mm_unpacklo_epi16(b1, b3);
+      __m128i c3 = _mm_unpackhi_epi16(b1, b3);
+      __m128i c4 = _mm_unpacklo_epi16(b4, b6);
+      __m128i c5 = _mm_unpackhi_epi16(b4, b6);
+      __m128i c6 = _mm_unpacklo_epi16(b5, b7);
+      __m128i c7 = _mm_unpackhi_epi16(b5, b7);
+
+      /* Each register holds two output rows of 8 soft bits */
+      __m128i d[8];
+      d[0] = _mm_unpacklo_epi32(c0, c4);
+      d[1] = _mm_unpackhi_epi32(c0, c4);
+      d[2] = _mm_unpacklo_epi32(c1, c5);
+      d[3] = _mm_unpackhi_epi32(c1, c5);
+      d[4] = _mm_unpacklo_epi32(c2, c6);
+      d[5] = _mm_unpackhi_epi32(c2, c6);
+      d[6] = _mm_unpacklo_epi32(c3, c7);
+      d[7] = _mm_unpackhi_epi32(c3, c7);
+
+      int8_t *out = &output[i * nof_rows + j];
+      for (uint32_t k = 0; k < 8; k++) {
+        rm_store8_b(&out[(2 * k) * nof_rows], d[k], combine);
+        rm_store8_b(&out[(2 * k + 1) * nof_rows], _mm_unpackhi_epi64(d[k], d[k]), combine);
       }
     }
+  }
+#endif /* LV_HAVE_SSE */
+  for (; i < len; i++) {
+    for (uint32_t j = 0; j < nof_rows; j++) {
+      int8_t x = rows[j][i * stride];
+      output[i * nof_rows + j] = combine ? rm_sat_b(output[i * nof_rows + j] + x) : x;
+    }
+  }
+}
 
+/* Adds the three streams to the decoder input, in the order of the turbo coder output */
+static void rm_interleave3_s(int16_t *d0, int16_t *d1, int16_t *d2, uint32_t len, int16_t *output) {
+  uint32_t i = 0;
+#ifdef LV_HAVE_SSE
+  __m128i m0a = _mm_setr_epi8(0, 1, -1, -1, -1, -1, 2, 3, -1, -1, -1, -1, 4, 5, -1, -1);
+  __m128i m0b = _mm_setr_epi8(-1, -1, 0, 1, -1, -1, -1, -1, 2, 3, -1, -1, -1, -1, 4, 5);
+  __m128i m0c = _mm_setr_epi8(-1, -1, -1, -1, 0, 1, -1, -1, -1, -1, 2, 3, -1, -1, -1, -1);
+  __m128i m1a = _mm_setr_epi8(-1, -1, 6, 7, -1, -1, -1, -1, 8, 9, -1, -1, -1, -1, 10, 11);
+  __m128i m1b = _mm_setr_epi8(-1, -1, -1, -1, 6, 7, -1, -1, -1, -1, 8, 9, -1, -1, -1, -1);
+  __m128i m1c = _mm_setr_epi8(4, 5, -1, -1, -1, -1, 6, 7, -1, -1, -1, -1, 8, 9, -1, -1);
+  __m128i m2a = _mm_setr_epi8(-1, -1, -1, -1, 12, 13, -1, -1, -1, -1, 14, 15, -1, -1, -1, -1);
+  __m128i m2b = _mm_setr_epi8(10, 11, -1, -1, -1, -1, 12, 13, -1, -1, -1, -1, 14, 15, -1, -1);
+  __m128i m2c = _mm_setr_epi8(-1, -1, 10, 11, -1, -1, -1, -1, 12, 13, -1, -1, -1, -1, 14, 15);
+  for (; i + 8 <= len; i += 8) {
+    __m128i a = _mm_loadu_si128((__m128i *) &d0[i]);
+    __m128i b = _mm_loadu_si128((__m128i *) &d1[i]);
+    __m128i c = _mm_loadu_si128((__m128i *) &d2[i]);
+    __m128i r0 = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a, m0a), _mm_shuffle_epi8(b, m0b)), _mm_shuffle_epi8(c, m0c));
+    __m128i r1 = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a, m1a), _mm_shuffle_epi8(b, m1b)), _mm_shuffle_epi8(c, m1c));
+    __m128i r2 = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a, m2a), _mm_shuffle_epi8(b, m2b)), _mm_shuffle_epi8(c, m2c));
+    rm_store8_s(&output[3 * i], r0, true);
+    rm_store8_s(&output[3 * i + 8], r1, true);
+    rm_store8_s(&output[3 * i + 16], r2, true);
+  }
+#endif /* LV_HAVE_SSE */
+  for (; i < len; i++) {
+    output[3 * i]     = rm_sat_s(output[3 * i] + d0[i]);
+    output[3 * i + 1] = rm_sat_s(output[3 * i + 1] + d1[i]);
+    output[3 * i + 2] = rm_sat_s(output[3 * i + 2] + d2[i]);
+  }
+}
 
-    return 0;
-  } else {
-    printf("Invalid inputs rv_idx=%d, cb_idx=%d\n", rv_idx, cb_idx);
-    return SRSLTE_ERROR_INVALID_INPUTS;
+static void rm_interleave3_b(int8_t *d0, int8_t *d1, int8_t *d2, uint32_t len, int8_t *output) {
+  uint32_t i = 0;
+#ifdef LV_HAVE_SSE
+  __m128i m0a = _mm_setr_epi8(0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1, 5);
+  __m128i m0b = _mm_setr_epi8(-1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1);
+  __m128i m0c = _mm_setr_epi8(-1, -1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1);
+  __m128i m1a = _mm_setr_epi8(-1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10, -1);
+  __m128i m1b = _mm_setr_epi8(5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10);
+  __m128i m1c = _mm_setr_epi8(-1, 5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1);
+  __m128i m2a = _mm_setr_epi8(-1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1, -1);
+  __m128i m2b = _mm_setr_epi8(-1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1);
+  __m128i m2c = _mm_setr_epi8(10, -1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15);
+  for (; i + 16 <= len; i += 16) {
+    __m128i a = _mm_loadu_si128((__m128i *) &d0[i]);
+    __m128i b = _mm_loadu_si128((__m128i *) &d1[i]);
+    __m128i c = _mm_loadu_si128((__m128i *) &d2[i]);
+    __m128i r0 = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a, m0a), _mm_shuffle_epi8(b, m0b)), _mm_shuffle_epi8(c, m0c));
+    __m128i r1 = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a, m1a), _mm_shuffle_epi8(b, m1b)), _mm_shuffle_epi8(c, m1c));
+    __m128i r2 = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a, m2a), _mm_shuffle_epi8(b, m2b)), _mm_shuffle_epi8(c, m2c));
+    int8_t *out = &output[3 * i];
+    _mm_storeu_si128((__m128i *) &out[0], _mm_adds_epi8(_mm_loadu_si128((__m128i *) &out[0]), r0));
+    _mm_storeu_si128((__m128i *) &out[16], _mm_adds_epi8(_mm_loadu_si128((__m128i *) &out[16]), r1));
+    _mm_storeu_si128((__m128i *) &out[32], _mm_adds_epi8(_mm_loadu_si128((__m128i *) &out[32]), r2));
+  }
+#endif /* LV_HAVE_SSE */
+  for (; i < len; i++) {
+    output[3 * i]     = rm_sat_b(output[3 * i] + d0[i]);
+    output[3 * i + 1] = rm_sat_b(output[3 * i + 1] + d1[i]);
+    output[3 * i + 2] = rm_sat_b(output[3 * i + 2] + d2[i]);
   }
 }
 
+/* Undoes the bit selection and the sub-block interleavers (5.1.4.1). Soft bit i of stream s is left in d[s][i] */
+static void rm_deinterleave_s(uint32_t cb_idx, uint32_t rv_idx, int16_t *input, uint32_t in_len,
+                              int16_t *w, int16_t y[3][RM_MAX_KP + 1], int16_t *d[3]) {
+  uint32_t D      = (uint32_t) srslte_cbsegm_cbsize(cb_idx) + 4;
+  uint32_t nrows  = (D - 1) / NCOLS + 1;
+  uint32_t K_p    = nrows * NCOLS;
+  uint32_t ndummy = K_p - D;
+  int16_t *rows[3][NCOLS];
+
+  /* Repetitions of the circular buffer are soft combined. Dummy bits are not written, they are discarded below */
+  if (in_len < 3 * D) {
+    bzero(w, sizeof(int16_t) * 3 * K_p);
+  }
+  for (uint32_t i = 0; i < in_len; i += 3 * D) {
+    rm_fold_s(&rm_runs[cb_idx], rv_idx, &input[i], SRSLTE_MIN(3 * D, in_len - i), w, i > 0);
+  }
 
-#endif
+  /* Column j of the interleaver holds the bits of column RM_PERM_TC[j] of the matrix, which is its own inverse */
+  for (uint32_t j = 0; j < NCOLS; j++) {
+    rows[0][j] = &w[RM_PERM_TC[j] * nrows];
+    rows[1][j] = &w[K_p + 2 * RM_PERM_TC[j] * nrows];
+    rows[2][j] = &w[K_p + 2 * RM_PERM_TC[j] * nrows + 1];
+  }
+  rm_transpose_s(rows[0], NCOLS, nrows, 1, y[0], false);
+  rm_transpose_s(rows[1], NCOLS, nrows, 2, y[1], false);
+  rm_transpose_s(rows[2], NCOLS, nrows, 2, &y[2][1], false);
+
+  /* The interleaver of the third stream is shifted by one bit */
+  y[2][0] = y[2][K_p];
+
+  d[0] = &y[0][ndummy];
+  d[1] = &y[1][ndummy];
+  d[2] = &y[2][ndummy];
+}
+
+static void rm_deinterleave_b(uint32_t cb_idx, uint32_t rv_idx, int8_t *input, uint32_t in_len,
+                              int8_t *w, int8_t y[3][RM_MAX_KP + 1], int8_t *d[3]) {
+  uint32_t D      = (uint32_t) srslte_cbsegm_cbsize(cb_idx) + 4;
+  uint32_t nrows  = (D - 1) / NCOLS + 1;
+  uint32_t K_p    = nrows * NCOLS;
+  uint32_t ndummy = K_p - D;
+  int8_t *rows[3][NCOLS];
 
+  if (in_len < 3 * D) {
+    bzero(w, sizeof(int8_t) * 3 * K_p);
+  }
+  for (uint32_t i = 0; i < in_len; i += 3 * D) {
+    rm_fold_b(&rm_runs[cb_idx], rv_idx, &input[i], SRSLTE_MIN(3 * D, in_len - i), w, i > 0);
+  }
+
+  for (uint32_t j = 0; j < NCOLS; j++) {
+    rows[0][j] = &w[RM_PERM_TC[j] * nrows];
+    rows[1][j] = &w[K_p + 2 * RM_PERM_TC[j] * nrows];
+    rows[2][j] = &w[K_p + 2 * RM_PERM_TC[j] * nrows + 1];
+  }
+  rm_transpose_b(rows[0], NCOLS, nrows, 1, y[0], false);
+  rm_transpose_b(rows[1], NCOLS, nrows, 2, y[1], false);
+  rm_transpose_b(rows[2], NCOLS, nrows, 2, &y[2][1], false);
 
-#ifdef LV_HAVE_AVX
+  y[2][0] = y[2][K_p];
 
-#define SAVE_OUTPUT(j) x  = (int16_t) _mm256_extract_epi16(xVal,   j);\
-                       l = (uint16_t) _mm256_extract_epi16(lutVal, j);\
-                       output[l] += x;
+  d[0] = &y[0][ndummy];
+  d[1] = &y[1][ndummy];
+  d[2] = &y[2][ndummy];
+}
 
-int srslte_rm_turbo_rx_lut_avx(int16_t *input, int16_t *output, uint16_t *deinter, uint32_t in_len, uint32_t cb_idx, uint32_t rv_idx)
+int srslte_rm_turbo_rx_lut(int16_t *input, int16_t *output, uint32_t in_len, uint32_t cb_idx, uint32_t rv_idx)
+{
+  return srslte_rm_turbo_rx_lut_(input, output, in_len, cb_idx, rv_idx, true);
+}
+/**
+ * Undoes rate matching for LTE Turbo Coder. Expands rate matched buffer to full size buffer.
+ * The soft bits are combined with the contents of the output buffer.
+ *
+ * @param[in] input Input buffer of size in_len
+ * @param[out] output Output buffer of size 3*srslte_cbsegm_cbsize(cb_idx)+12
+ * @param[in] cb_idx Code block table index
+ * @param[in] rv_idx Redundancy Version from DCI control message
+ * @return Error code
+ */
+int srslte_rm_turbo_rx_lut_(int16_t *input, int16_t *output, uint32_t in_len, uint32_t cb_idx, uint32_t rv_idx, bool enable_input_tdec)
 {
   if (rv_idx < 4 && cb_idx < SRSLTE_NOF_TC_CB_SIZES) {
-    uint32_t out_len = 3*srslte_cbsegm_cbsize(cb_idx)+12;
-
-    const __m256i* xPtr   = (const __m256i*) input;
-    const __m256i* lutPtr = (const __m256i*) deinter;
-    __m256i xVal, lutVal;
-
-    int16_t x;
-    uint16_t l;
-
-    /* Simplify load if we do not need to wrap (ie high rates) */
-    if (in_len <= out_len) {
-      for (int i=0;i<in_len/16;i++) {
-        xVal   = _mm256_loadu_si256(xPtr);
-        lutVal = _mm256_loadu_si256(lutPtr);
-        SAVE_OUTPUT(0);
-        SAVE_OUTPUT(1);
-        SAVE_OUTPUT(2);
-        SAVE_OUTPUT(3);
-        SAVE_OUTPUT(4);
-        SAVE_OUTPUT(5);
-        SAVE_OUTPUT(6);
-        SAVE_OUTPUT(7);
-
-        SAVE_OUTPUT(8);
-        SAVE_OUTPUT(9);
-        SAVE_OUTPUT(10);
-        SAVE_OUTPUT(11);
-        SAVE_OUTPUT(12);
-        SAVE_OUTPUT(13);
-        SAVE_OUTPUT(14);
-        SAVE_OUTPUT(15);
-
-        xPtr ++;
-        lutPtr ++;
-      }
-      for (int i=16*(in_len/16);i<in_len;i++) {
-        output[deinter[i%out_len]] += input[i];
-      }
-    } else {
-      int intCnt = 16;
-      int inputCnt = 0;
-      int nwrapps = 0;
-      while(inputCnt < in_len - 16) {
-        xVal   = _mm256_loadu_si256(xPtr);
-        lutVal = _mm256_loadu_si256(lutPtr);
-
-        SAVE_OUTPUT(0);
-        SAVE_OUTPUT(1);
-        SAVE_OUTPUT(2);
-        SAVE_OUTPUT(3);
-        SAVE_OUTPUT(4);
-        SAVE_OUTPUT(5);
-        SAVE_OUTPUT(6);
-        SAVE_OUTPUT(7);
-
-        SAVE_OUTPUT(8);
-        SAVE_OUTPUT(9);
-        SAVE_OUTPUT(10);
-        SAVE_OUTPUT(11);
-        SAVE_OUTPUT(12);
-        SAVE_OUTPUT(13);
-        SAVE_OUTPUT(14);
-        SAVE_OUTPUT(15);
-        xPtr++;
-        lutPtr++;
-        intCnt   += 16;
-        inputCnt += 16;
-        if (intCnt >= out_len && inputCnt < in_len - 16) {
-          /* Copy last elements */
-          if ((out_len%16) == 12) {
-            for (int j=(nwrapps+1)*out_len-12;j<(nwrapps+1)*out_len;j++) {
-              output[deinter[j%out_len]] += input[j];
-              inputCnt++;
-            }
-          } else {
-            for (int j=(nwrapps+1)*out_len-4;j<(nwrapps+1)*out_len;j++) {
-              output[deinter[j%out_len]] += input[j];
-              inputCnt++;
-            }
-          }
-          /* And wrap pointers */
-          nwrapps++;
-          intCnt = 16;
-          xPtr   = (const __m256i*) &input[nwrapps*out_len];
-          lutPtr = (const __m256i*) deinter;
+    uint32_t long_cb = (uint32_t) srslte_cbsegm_cbsize(cb_idx);
+    uint32_t nof_sb = 0;
+    int16_t w[RM_MAX_NCB + 8];
+    int16_t y[3][RM_MAX_KP + 1];
+    int16_t *d[3];
+
+#if SRSLTE_TDEC_EXPECT_INPUT_SB == 1
+    if (enable_input_tdec) {
+      nof_sb = srslte_tdec_autoimp_get_subblocks(long_cb);
+    }
+#endif
+    if (nof_sb % 8 || (nof_sb && long_cb % nof_sb)) {
+      fprintf(stderr, "Sub-block size %d not supported in srslte_rm_turbo_rx_lut()\n", nof_sb);
+      return SRSLTE_ERROR;
+    }
+
+    rm_deinterleave_s(cb_idx, rv_idx, input, in_len, w, y, d);
+
+    if (nof_sb) {
+      /* Input of the sliding window decoder: each stream is interleaved every nof_sb bits
+       * (32-bit aligned), followed by the tail bits in the turbo coder order */
+      for (uint32_t s = 0; s < 3; s++) {
+        int16_t *rows[32];
+        for (uint32_t p = 0; p < nof_sb; p++) {
+          rows[p] = &d[s][p * (long_cb / nof_sb)];
         }
+        rm_transpose_s(rows, nof_sb, long_cb / nof_sb, 1, &output[s * (long_cb + 32)], true);
       }
-      for (int i=inputCnt;i<in_len;i++) {
-        output[deinter[i%out_len]] += input[i];
-      }
+      rm_interleave3_s(&d[0][long_cb], &d[1][long_cb], &d[2][long_cb], 4, &output[3 * (long_cb + 32)]);
+    } else {
+      rm_interleave3_s(d[0], d[1], d[2], long_cb + 4, output);
     }
     return 0;
   } else {
@@ -741,147 +721,36 @@ int srslte_rm_turbo_rx_lut_avx(int16_t *input, int16_t *output, uint16_t *deinte
   }
 }
 
-#define SAVE_OUTPUT8(j) x = (int8_t) _mm256_extract_epi8(xVal,   j);\
-                        l = (uint16_t) _mm256_extract_epi16(lutVal1, j);\
-                        output[l] += x;
-
-#define SAVE_OUTPUT8_2(j) x = (int8_t) _mm256_extract_epi8(xVal,   j+8);\
-                          l = (uint16_t) _mm256_extract_epi16(lutVal2, j);\
-                          output[l] += x;
-
-
-int srslte_rm_turbo_rx_lut_avx_8bit(int8_t *input, int8_t *output, uint16_t *deinter, uint32_t in_len, uint32_t cb_idx, uint32_t rv_idx)
+int srslte_rm_turbo_rx_lut_8bit(int8_t *input, int8_t *output, uint32_t in_len, uint32_t cb_idx, uint32_t rv_idx)
 {
   if (rv_idx < 4 && cb_idx < SRSLTE_NOF_TC_CB_SIZES) {
-    uint32_t out_len = 3*srslte_cbsegm_cbsize(cb_idx)+12;
-
-    const __m256i* xPtr   = (const __m256i*) input;
-    const __m256i* lutPtr = (const __m256i*) deinter;
-    __m256i xVal, lutVal1, lutVal2;
-
-    int8_t x;
-    uint16_t l;
-
-    /* Simplify load if we do not need to wrap (ie high rates) */
-    if (in_len <= out_len) {
-      for (int i=0;i<in_len/32;i++) {
-        xVal   = _mm256_loadu_si256(xPtr);
-        xPtr ++;
-        lutVal1 = _mm256_loadu_si256(lutPtr);
-        lutPtr ++;
-        lutVal2 = _mm256_loadu_si256(lutPtr);
-        lutPtr ++;
-
-        SAVE_OUTPUT8(0);
-        SAVE_OUTPUT8(1);
-        SAVE_OUTPUT8(2);
-        SAVE_OUTPUT8(3);
-        SAVE_OUTPUT8(4);
-        SAVE_OUTPUT8(5);
-        SAVE_OUTPUT8(6);
-        SAVE_OUTPUT8(7);
-
-        SAVE_OUTPUT8(8);
-        SAVE_OUTPUT8(9);
-        SAVE_OUTPUT8(10);
-        SAVE_OUTPUT8(11);
-        SAVE_OUTPUT8(12);
-        SAVE_OUTPUT8(13);
-        SAVE_OUTPUT8(14);
-        SAVE_OUTPUT8(15);
-
-        SAVE_OUTPUT8_2(0);
-        SAVE_OUTPUT8_2(1);
-        SAVE_OUTPUT8_2(2);
-        SAVE_OUTPUT8_2(3);
-        SAVE_OUTPUT8_2(4);
-        SAVE_OUTPUT8_2(5);
-        SAVE_OUTPUT8_2(6);
-        SAVE_OUTPUT8_2(7);
-
-        SAVE_OUTPUT8_2(8);
-        SAVE_OUTPUT8_2(9);
-        SAVE_OUTPUT8_2(10);
-        SAVE_OUTPUT8_2(11);
-        SAVE_OUTPUT8_2(12);
-        SAVE_OUTPUT8_2(13);
-        SAVE_OUTPUT8_2(14);
-        SAVE_OUTPUT8_2(15);
+    uint32_t long_cb = (uint32_t) srslte_cbsegm_cbsize(cb_idx);
+    uint32_t nof_sb = 0;
+    int8_t w[RM_MAX_NCB + 16];
+    int8_t y[3][RM_MAX_KP + 1];
+    int8_t *d[3];
 
-      }
-      for (int i=32*(in_len/32);i<in_len;i++) {
-        output[deinter[i%out_len]] += input[i];
-      }
-    } else {
-      printf("wraps not implemented!\n");
-#ifdef kk
-      int intCnt = 32;
-      int inputCnt = 0;
-      int nwrapps = 0;
-      while(inputCnt < in_len - 32) {
-        xVal   = _mm256_loadu_si256(xPtr);
-        xPtr ++;
-        lutVal1 = _mm256_loadu_si256(lutPtr);
-        lutPtr ++;
-        lutVal2 = _mm256_loadu_si256(lutPtr);
-        lutPtr ++;
-
-        SAVE_OUTPUT8(0);
-        SAVE_OUTPUT8(1);
-        SAVE_OUTPUT8(2);
-        SAVE_OUTPUT8(3);
-        SAVE_OUTPUT8(4);
-        SAVE_OUTPUT8(5);
-        SAVE_OUTPUT8(6);
-        SAVE_OUTPUT8(7);
-
-        SAVE_OUTPUT8(8);
-        SAVE_OUTPUT8(9);
-        SAVE_OUTPUT8(10);
-        SAVE_OUTPUT8(11);
-        SAVE_OUTPUT8(12);
-        SAVE_OUTPUT8(13);
-        SAVE_OUTPUT8(14);
-        SAVE_OUTPUT8(15);
-
-        SAVE_OUTPUT8_2(0);
-        SAVE_OUTPUT8_2(1);
-        SAVE_OUTPUT8_2(2);
-        SAVE_OUTPUT8_2(3);
-        SAVE_OUTPUT8_2(4);
-        SAVE_OUTPUT8_2(5);
-        SAVE_OUTPUT8_2(6);
-        SAVE_OUTPUT8_2(7);
-
-        SAVE_OUTPUT8_2(8);
-        SAVE_OUTPUT8_2(9);
-        SAVE_OUTPUT8_2(10);
-        SAVE_OUTPUT8_2(11);
-        SAVE_OUTPUT8_2(12);
-        SAVE_OUTPUT8_2(13);
-        SAVE_OUTPUT8_2(14);
-        SAVE_OUTPUT8_2(15);
-        
-        intCnt   += 32;
-        inputCnt += 32;
-        if (intCnt >= out_len && inputCnt < in_len - 32) {
-          printf("warning rate matching wrapping remainder %d\n", out_len%32);
-          /* Copy last elements */
-          for (int j=(nwrapps+1)*out_len-(out_len%32) ;j<(nwrapps+1)*out_len;j++) {
-            output[deinter[j%out_len]] += input[j];
-            inputCnt++;
-          }
-          /* And wrap pointers */
-          nwrapps++;
-          intCnt = 32;
-          xPtr   = (const __m256i*) &input[nwrapps*out_len];
-          lutPtr = (const __m256i*) deinter;
+#if SRSLTE_TDEC_EXPECT_INPUT_SB == 1
+    nof_sb = srslte_tdec_autoimp_get_subblocks_8bit(long_cb);
+#endif
+    if (nof_sb % 8 || (nof_sb && long_cb % nof_sb)) {
+      fprintf(stderr, "Sub-block size %d not supported in srslte_rm_turbo_rx_lut_8bit()\n", nof_sb);
+      return SRSLTE_ERROR;
+    }
+
+    rm_deinterleave_b(cb_idx, rv_idx, input, in_len, w, y, d);
+
+    if (nof_sb) {
+      for (uint32_t s = 0; s < 3; s++) {
+        int8_t *rows[32];
+        for (uint32_t p = 0; p < nof_sb; p++) {
+          rows[p] = &d[s][p * (long_cb / nof_sb)];
         }
+        rm_transpose_b(rows, nof_sb, long_cb / nof_sb, 1, &output[s * (long_cb + 32)], true);
       }
-      for (int i=inputCnt;i<in_len;i++) {
-        output[deinter[i%out_len]] += input[i];
-      }
-#endif
+      rm_interleave3_b(&d[0][long_cb], &d[1][long_cb], &d[2][long_cb], 4, &output[3 * (long_cb + 32)]);
+    } else {
+      rm_interleave3_b(d[0], d[1], d[2], long_cb + 4, output);
     }
     return 0;
   } else {
@@ -889,28 +758,6 @@ int srslte_rm_turbo_rx_lut_avx_8bit(int8_t *input, int8_t *output, uint16_t *dei
     return SRSLTE_ERROR_INVALID_INPUTS;
   }
 }
-
-#endif
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
 
 /* Turbo Code Rate Matching.
  * 3GPP TS 36.212 v10.1.0 section 5.1.4.1
@@ -43,6 +43,224 @@
 
 #define MAX_PDSCH_RE(cp) (2 * SRSLTE_CP_NSYMB(cp) * 12)
 
+/* Soft bits of a code block as srslte_rm_turbo_rx_lut() writes them for the turbo decoder: with sub-block
+ * input the three streams of K bits start K+32 apart and the 12 tail bits follow at 3*(K+32). This also
+ * covers the 3*K+12 bits of the plain layout. */
+#define POOL_CB_LLR_LEN(K) (3*((K) + 32) + 12)
+#define POOL_CB_ALIGN  32
+
+int srslte_softbuffer_pool_init(srslte_softbuffer_pool_t *q, uint32_t size_bytes, bool llr_is_8bit) {
+  int ret = SRSLTE_ERROR_INVALID_INPUTS;
+
+  if (q != NULL && size_bytes >= SRSLTE_SOFTBUFFER_POOL_CHUNK_SZ) {
+    ret = SRSLTE_ERROR;
+
+    bzero(q, sizeof(srslte_softbuffer_pool_t));
+
+    q->nof_chunks = size_bytes / SRSLTE_SOFTBUFFER_POOL_CHUNK_SZ;
+    q->llr_sz     = llr_is_8bit?sizeof(int8_t):sizeof(int16_t);
+
+    q->arena = srslte_vec_malloc((size_t) q->nof_chunks * SRSLTE_SOFTBUFFER_POOL_CHUNK_SZ);
+    if (!q->arena) {
+      perror("malloc");
+      goto clean_exit;
+    }
+
+    q->free_map = srslte_vec_malloc(sizeof(uint64_t) * (q->nof_chunks + 63) / 64);
+    if (!q->free_map) {
+      perror("malloc");
+      goto clean_exit;
+    }
+    bzero(q->free_map, sizeof(uint64_t) * (q->nof_chunks + 63) / 64);
+
+    pthread_mutex_init(&q->mutex, NULL);
+
+    q->metrics.nof_chunks = q->nof_chunks;
+    q->metrics.chunk_sz   = SRSLTE_SOFTBUFFER_POOL_CHUNK_SZ;
+    ret = SRSLTE_SUCCESS;
+  }
+
+clean_exit:
+  if (ret == SRSLTE_ERROR) {
+    if (q->arena) {
+      free(q->arena);
+    }
+    if (q->free_map) {
+      free(q->free_map);
+    }
+    bzero(q, sizeof(srslte_softbuffer_pool_t));
+  }
+  return ret;
+}
+
+void srslte_softbuffer_pool_free(srslte_softbuffer_pool_t *q) {
+  if (q && q->arena) {
+    free(q->arena);
+    free(q->free_map);
+    pthread_mutex_destroy(&q->mutex);
+    bzero(q, sizeof(srslte_softbuffer_pool_t));
+  }
+}
+
+void srslte_softbuffer_pool_get_metrics(srslte_softbuffer_pool_t *q, srslte_softbuffer_pool_metrics_t *metrics) {
+  if (q && q->arena) {
+    pthread_mutex_lock(&q->mutex);
+    memcpy(metrics, &q->metrics, sizeof(srslte_softbuffer_pool_metrics_t));
+    q->metrics.max_used = q->metrics.nof_used;
+    q->metrics.nof_fail = 0;
+    pthread_mutex_unlock(&q->mutex);
+  } else {
+    bzero(metrics, sizeof(srslte_softbuffer_pool_metrics_t));
+  }
+}
+
+static inline bool pool_chunk_is_used(srslte_softbuffer_pool_t *q, uint32_t idx) {
+  return (q->free_map[idx/64] >> (idx%64)) & 1;
+}
+
+static void pool_set_chunks(srslte_softbuffer_pool_t *q, uint32_t first, uint32_t n, bool used) {
+  for (uint32_t i=first;i<first+n;i++) {
+    if (used) {
+      q->free_map[i/64] |= ((uint64_t) 1) << (i%64);
+    } else {
+      q->free_map[i/64] &= ~(((uint64_t) 1) << (i%64));
+    }
+  }
+}
+
+/* Next-fit search of n contiguous free chunks starting at the position of the last allocation.
+ * Fully used 64-chunk words are skipped. Must be called with the mutex locked. Returns -1 if not found. */
+static int pool_alloc_chunks(srslte_softbuffer_pool_t *q, uint32_t n) {
+  uint32_t start = q->next_chunk;
+  uint32_t run   = 0;
+  uint32_t i     = start;
+  uint32_t nof_checked = 0;
+
+  while (nof_checked < q->nof_chunks + n) {
+    if (i == q->nof_chunks) {
+      // Runs do not wrap around the end of the arena
+      i   = 0;
+      run = 0;
+    }
+    if (i%64 == 0 && q->free_map[i/64] == ~((uint64_t) 0)) {
+      uint32_t skip = SRSLTE_MIN(64, q->nof_chunks - i);
+      i           += skip;
+      nof_checked += skip;
+      run = 0;
+      continue;
+    }
+    if (pool_chunk_is_used(q, i)) {
+      run = 0;
+    } else {
+      run++;
+      if (run == n) {
+        uint32_t first = i + 1 - n;
+        pool_set_chunks(q, first, n, true);
+        q->next_chunk = (i + 1)%q->nof_chunks;
+        return (int) first;
+      }
+    }
+    i++;
+    nof_checked++;
+  }
+  return -1;
+}
+
+static void softbuffer_rx_release_cb(srslte_softbuffer_rx_t *q, uint32_t cb_idx) {
+  if (q->cb_nof_chunks[cb_idx]) {
+    pool_set_chunks(q->pool, q->cb_chunk[cb_idx], q->cb_nof_chunks[cb_idx], false);
+    q->pool->metrics.nof_used -= q->cb_nof_chunks[cb_idx];
+    q->pool->metrics.nof_cb--;
+    q->cb_nof_chunks[cb_idx] = 0;
+    q->buffer_f[cb_idx] = NULL;
+    q->data[cb_idx]     = NULL;
+  }
+}
+
+int srslte_softbuffer_rx_init_pool(srslte_softbuffer_rx_t *q, uint32_t nof_prb, srslte_softbuffer_pool_t *pool) {
+  int ret = SRSLTE_ERROR_INVALID_INPUTS;
+
+  if (q != NULL && pool != NULL && pool->arena != NULL) {
+    bzero(q, sizeof(srslte_softbuffer_rx_t));
+
+    ret = srslte_ra_tbs_from_idx(26, nof_prb);
+    if (ret != SRSLTE_ERROR) {
+      q->max_cb = (uint32_t) ret / (SRSLTE_TCOD_MAX_LEN_CB - 24) + 1;
+      q->pool   = pool;
+      ret = SRSLTE_ERROR;
+
+      // Code block storage is taken from the pool on demand by srslte_softbuffer_rx_get_cb()
+      q->buffer_f      = calloc(q->max_cb, sizeof(int16_t*));
+      q->data          = calloc(q->max_cb, sizeof(uint8_t*));
+      q->cb_crc        = calloc(q->max_cb, sizeof(bool));
+      q->cb_chunk      = calloc(q->max_cb, sizeof(uint32_t));
+      q->cb_nof_chunks = calloc(q->max_cb, sizeof(uint32_t));
+      if (!q->buffer_f || !q->data || !q->cb_crc || !q->cb_chunk || !q->cb_nof_chunks) {
+        perror("malloc");
+        srslte_softbuffer_rx_free(q);
+      } else {
+        ret = SRSLTE_SUCCESS;
+      }
+    }
+  }
+  return ret;
+}
+
+int16_t* srslte_softbuffer_rx_get_cb(srslte_softbuffer_rx_t *q, uint32_t cb_idx, uint32_t cb_len) {
+  if (cb_idx >= q->max_cb) {
+    return NULL;
+  }
+  if (!q->pool) {
+    return q->buffer_f[cb_idx];
+  }
+
+  srslte_softbuffer_pool_t *pool = q->pool;
+  uint32_t llr_bytes = POOL_CB_LLR_LEN(cb_len) * pool->llr_sz;
+  llr_bytes = POOL_CB_ALIGN * ((llr_bytes + POOL_CB_ALIGN - 1) / POOL_CB_ALIGN);
+  uint32_t n = (llr_bytes + cb_len/8 + SRSLTE_SOFTBUFFER_POOL_CHUNK_SZ - 1) / SRSLTE_SOFTBUFFER_POOL_CHUNK_SZ;
+
+  if (q->cb_nof_chunks[cb_idx] >= n) {
+    return q->buffer_f[cb_idx];
+  }
+
+  pthread_mutex_lock(&pool->mutex);
+  // Storage of a previous, shorter, code block does not hold valid soft bits for this one
+  softbuffer_rx_release_cb(q, cb_idx);
+  int first = pool_alloc_chunks(pool, n);
+  if (first >= 0) {
+    q->cb_chunk[cb_idx]      = (uint32_t) first;
+    q->cb_nof_chunks[cb_idx] = n;
+    pool->metrics.nof_used  += n;
+    pool->metrics.nof_cb++;
+    if (pool->metrics.nof_used > pool->metrics.max_used) {
+      pool->metrics.max_used = pool->metrics.nof_used;
+    }
+  } else {
+    pool->metrics.nof_fail++;
+  }
+  pthread_mutex_unlock(&pool->mutex);
+
+  if (first < 0) {
+    return NULL;
+  }
+
+  uint8_t *ptr = &pool->arena[(size_t) first * SRSLTE_SOFTBUFFER_POOL_CHUNK_SZ];
+  bzero(ptr, llr_bytes);
+  q->buffer_f[cb_idx] = (int16_t*) ptr;
+  q->data[cb_idx]     = &ptr[llr_bytes];
+  return q->buffer_f[cb_idx];
+}
+
+void srslte_softbuffer_rx_release(srslte_softbuffer_rx_t *q) {
+  if (q->pool && q->cb_nof_chunks) {
+    pthread_mutex_lock(&q->pool->mutex);
+    for (uint32_t i=0;i<q->max_cb;i++) {
+      softbuffer_rx_release_cb(q, i);
+    }
+    pthread_mutex_unlock(&q->pool->mutex);
+  }
+}
+
 int srslte_softbuffer_rx_init(srslte_softbuffer_rx_t *q, uint32_t nof_prb) {
   int ret = SRSLTE_ERROR_INVALID_INPUTS;
   
@@ -101,7 +319,25 @@ int srslte_softbuffer_rx_init(srslte_softbuffer_rx_t *q, uint32_t nof_prb) {
 }
 
 void srslte_softbuffer_rx_free(srslte_softbuffer_rx_t *q) {
-  if (q) {
+  if (q && q->pool) {
+    srslte_softbuffer_rx_release(q);
+    if (q->buffer_f) {
+      free(q->buffer_f);
+    }
+    if (q->data) {
+      free(q->data);
+    }
+    if (q->cb_crc) {
+      free(q->cb_crc);
+    }
+    if (q->cb_chunk) {
+      free(q->cb_chunk);
+    }
+    if (q->cb_nof_chunks) {
+      free(q->cb_nof_chunks);
+    }
+    bzero(q, sizeof(srslte_softbuffer_rx_t));
+  } else if (q) {
     if (q->buffer_f) {
       for (uint32_t i=0;i<q->max_cb;i++) {
         if (q->buffer_f[i]) {
@@ -135,7 +371,10 @@ void srslte_softbuffer_rx_reset(srslte_softbuffer_rx_t *q) {
 }
 
 void srslte_softbuffer_rx_reset_cb(srslte_softbuffer_rx_t *q, uint32_t nof_cb) {
-  if (q->buffer_f) {
+  if (q->pool) {
+    // Storage beyond nof_cb is released too, it is zeroed again when taken from the pool
+    srslte_softbuffer_rx_release(q);
+  } else if (q->buffer_f) {
     if (nof_cb > q->max_cb) {
       nof_cb = q->max_cb; 
     }
@@ -102,8 +102,35 @@ int main(int argc, char **argv) {
   // generate CRC word
   crc_word = srslte_crc_checksum(&crc_p, data, num_bits);
 
+  // The packed bytes fed in two parts must match the byte-wise checksum
+  uint32_t nof_bytes = (uint32_t) num_bits / 8;
+  uint8_t *packed = malloc(sizeof(uint8_t) * (nof_bytes + 1));
+  if (!packed) {
+    perror("malloc");
+    exit(-1);
+  }
+  srslte_bit_pack_vector(data, packed, nof_bytes * 8);
+
+  srslte_crc_set_init(&crc_p, 0);
+  for (i = 0; i < nof_bytes; i++) {
+    srslte_crc_checksum_put_byte(&crc_p, packed[i]);
+  }
+  uint32_t crc_bytewise = (uint32_t) srslte_crc_checksum_get(&crc_p);
+
+  uint32_t split = (uint32_t) rand() % (nof_bytes + 1);
+  srslte_crc_set_init(&crc_p, 0);
+  srslte_crc_checksum_put(&crc_p, packed, split);
+  srslte_crc_checksum_put(&crc_p, &packed[split], nof_bytes - split);
+  uint32_t crc_incremental = (uint32_t) srslte_crc_checksum_get(&crc_p);
+
+  free(packed);
   free(data);
 
+  if (crc_incremental != crc_bytewise) {
+    fprintf(stderr, "Incremental CRC 0x%x does not match 0x%x\n", crc_incremental, crc_bytewise);
+    exit(-1);
+  }
+
   // check if generated word is as expected
   if (get_expected_word(num_bits, crc_length, crc_poly, seed,
       &expected_word)) {
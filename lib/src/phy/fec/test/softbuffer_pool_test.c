@@ -0,0 +1,164 @@
+/**
+ *
+ * \section COPYRIGHT
+ *
+ * Copyright 2013-2015 Software Radio Systems Limited
+ *
+ * \section LICENSE
+ *
+ * This file is part of the srsLTE library.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+
+#include "srslte/srslte.h"
+
+#define NOF_SOFTBUFFERS 8
+
+uint32_t nof_prb = 50;
+bool llr_8bit = false;
+uint32_t pool_sz = 256*1024;
+
+void usage(char *prog) {
+  printf("Usage: %s [pbs]\n", prog);
+  printf("\t-p nof_prb [Default %d]\n", nof_prb);
+  printf("\t-b use 8-bit LLRs [Default %s]\n", llr_8bit?"yes":"no");
+  printf("\t-s pool size in bytes [Default %d]\n", pool_sz);
+}
+
+void parse_args(int argc, char **argv) {
+  int opt;
+  while ((opt = getopt(argc, argv, "pbs")) != -1) {
+    switch (opt) {
+    case 'p':
+      nof_prb = atoi(argv[optind]);
+      break;
+    case 'b':
+      llr_8bit = true;
+      break;
+    case 's':
+      pool_sz = atoi(argv[optind]);
+      break;
+    default:
+      usage(argv[0]);
+      exit(-1);
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  srslte_softbuffer_pool_t pool;
+  srslte_softbuffer_pool_metrics_t m;
+  srslte_softbuffer_rx_t sb[NOF_SOFTBUFFERS];
+  uint32_t cb_len = 6144;
+  int ret = -1;
+
+  parse_args(argc, argv);
+  uint32_t llr_sz = llr_8bit?1:2;
+
+  if (srslte_softbuffer_pool_init(&pool, pool_sz, llr_8bit)) {
+    fprintf(stderr, "Error initiating pool\n");
+    exit(-1);
+  }
+  for (int i=0;i<NOF_SOFTBUFFERS;i++) {
+    if (srslte_softbuffer_rx_init_pool(&sb[i], nof_prb, &pool)) {
+      fprintf(stderr, "Error initiating softbuffer\n");
+      exit(-1);
+    }
+  }
+
+  // Nothing is taken from the pool until a CB is received
+  srslte_softbuffer_pool_get_metrics(&pool, &m);
+  if (m.nof_used || m.nof_cb) {
+    fprintf(stderr, "Pool is not empty after init\n");
+    goto clean_exit;
+  }
+
+  // Fill the pool with maximum size CBs and check they do not overlap
+  uint32_t nof_cb = 0;
+  for (int i=0;i<NOF_SOFTBUFFERS;i++) {
+    for (uint32_t j=0;j<sb[i].max_cb;j++) {
+      int16_t *buff = srslte_softbuffer_rx_get_cb(&sb[i], j, cb_len);
+      if (!buff) {
+        break;
+      }
+      if (((uintptr_t) buff) % 32) {
+        fprintf(stderr, "CB buffer is not aligned\n");
+        goto clean_exit;
+      }
+      for (uint32_t k=0;k<(3*(cb_len+32)+12)*llr_sz;k++) {
+        if (((uint8_t*) buff)[k]) {
+          fprintf(stderr, "CB buffer is not zero\n");
+          goto clean_exit;
+        }
+      }
+      memset(buff, i*16+j+1, (3*(cb_len+32)+12)*llr_sz);
+      memset(sb[i].data[j], 0xff, cb_len/8);
+      nof_cb++;
+    }
+  }
+  for (int i=0;i<NOF_SOFTBUFFERS;i++) {
+    for (uint32_t j=0;j<sb[i].max_cb;j++) {
+      uint8_t *buff = (uint8_t*) sb[i].buffer_f[j];
+      if (buff && (buff[0] != i*16+j+1 || buff[(3*(cb_len+32)+12)*llr_sz-1] != i*16+j+1)) {
+        fprintf(stderr, "CB buffers overlap\n");
+        goto clean_exit;
+      }
+    }
+  }
+
+  srslte_softbuffer_pool_get_metrics(&pool, &m);
+  printf("Pool of %d chunks: %d CBs use %d chunks, %d failed\n", m.nof_chunks, m.nof_cb, m.nof_used, m.nof_fail);
+  if (m.nof_cb != nof_cb || m.nof_used > m.nof_chunks || m.max_used != m.nof_used) {
+    fprintf(stderr, "Wrong metrics\n");
+    goto clean_exit;
+  }
+  if (pool_sz < NOF_SOFTBUFFERS * sb[0].max_cb * (3*cb_len+12) * llr_sz && m.nof_fail == 0) {
+    fprintf(stderr, "Pool exhaustion was not reported\n");
+    goto clean_exit;
+  }
+
+  // Releasing one softbuffer makes room for short CBs of another one
+  srslte_softbuffer_rx_reset(&sb[0]);
+  srslte_softbuffer_rx_reset(&sb[NOF_SOFTBUFFERS-1]);
+  for (uint32_t j=0;j<sb[NOF_SOFTBUFFERS-1].max_cb;j++) {
+    if (!srslte_softbuffer_rx_get_cb(&sb[NOF_SOFTBUFFERS-1], j, 40)) {
+      fprintf(stderr, "Short CB does not fit after release\n");
+      goto clean_exit;
+    }
+  }
+
+  for (int i=0;i<NOF_SOFTBUFFERS;i++) {
+    srslte_softbuffer_rx_free(&sb[i]);
+  }
+  srslte_softbuffer_pool_get_metrics(&pool, &m);
+  if (m.nof_used || m.nof_cb) {
+    fprintf(stderr, "Pool is not empty after free\n");
+    goto clean_exit;
+  }
+  ret = 0;
+
+clean_exit:
+  srslte_softbuffer_pool_free(&pool);
+  printf("%s\n", ret?"Error":"Ok");
+  exit(ret);
+}
@@ -219,16 +219,13 @@ int srslte_tcod_encode_lut(srslte_tcod_t *h,
     if (crc_cb) {
       int block_size_nocrc = (long_cb - crc_cb->order - ((last_cb) ? crc_tb->order : 0)) / 8;
 
-      /* if CRC pointer is given */
+      /* if CRC pointer is given, put the bytes in the TB and CB CRCs */
+      srslte_crc_checksum_put(crc_tb, input, (uint32_t) block_size_nocrc);
+      srslte_crc_checksum_put(crc_cb, input, (uint32_t) block_size_nocrc);
+
       for (int i = 0; i < block_size_nocrc; i++) {
         uint8_t in = input[i];
 
-        /* Put byte in TB CRC and save latest checksum */
-        srslte_crc_checksum_put_byte(crc_tb, in);
-
-        /* Put byte in CB CRC and save latest checksum */
-        srslte_crc_checksum_put_byte(crc_cb, in);
-
         /* Run actual encoder */
         tcod_lut_t l = tcod_lut[state0][in];
         parity[i] = l.output;
@@ -268,11 +265,11 @@ int srslte_tcod_encode_lut(srslte_tcod_t *h,
       /* No CRC given */
       int block_size_nocrc = (long_cb - ((last_cb) ? crc_tb->order : 0)) / 8;
 
+      srslte_crc_checksum_put(crc_tb, input, (uint32_t) block_size_nocrc);
+
       for (uint32_t i = 0; i < block_size_nocrc; i++) {
         uint8_t in = input[i];
 
-        srslte_crc_checksum_put_byte(crc_tb, in);
-
         tcod_lut_t l = tcod_lut[state0][in];
         parity[i] = l.output;
         state0 = l.next_state;
@@ -31,6 +31,7 @@
 #include <srslte/srslte.h>
 
 #include "srslte/phy/utils/vector.h"
+#include "srslte/phy/utils/cpu_features.h"
 #include "srslte/phy/fec/turbodecoder.h"
 
 #define debug_enabled 0
@@ -70,20 +71,6 @@ srslte_tdec_16bit_impl_t sse16_win_impl = {
 };
 #endif
 
-/* AVX window implementation */
-#ifdef LV_HAVE_AVX2
-#define WINIMP_IS_AVX16
-#include "srslte/phy/fec/turbodecoder_win.h"
-#undef WINIMP_IS_AVX16
-srslte_tdec_16bit_impl_t avx16_win_impl = {
-    tdec_winavx16_init,
-    tdec_winavx16_free,
-    tdec_winavx16_dec,
-    tdec_winavx16_extract_input,
-    tdec_winavx16_decision_byte
-};
-#endif
-
 /* SSE window implementation */
 #ifdef LV_HAVE_SSE
 #define WINIMP_IS_SSE8
@@ -99,19 +86,19 @@ srslte_tdec_8bit_impl_t sse8_win_impl = {
 };
 #endif
 
-/* AVX window implementation */
-#ifdef LV_HAVE_AVX2
-#define WINIMP_IS_AVX8
-#include "srslte/phy/fec/turbodecoder_win.h"
-#undef WINIMP_IS_AVX8
-srslte_tdec_8bit_impl_t avx8_win_impl = {
-    tdec_winavx8_init,
-    tdec_winavx8_free,
-    tdec_winavx8_dec,
-    tdec_winavx8_extract_input,
-    tdec_winavx8_decision_byte
-};
-#endif
+/* AVX window implementations, built with AVX2 in turbodecoder_win_avx2.c and used if the CPU supports it */
+#ifdef SRSLTE_HAVE_AVX2_KERNELS
+extern srslte_tdec_16bit_impl_t avx16_win_impl;
+extern srslte_tdec_8bit_impl_t avx8_win_impl;
+
+static bool tdec_have_avx2() {
+  return srslte_cpu_isa() >= SRSLTE_CPU_ISA_AVX2;
+}
+#else
+static bool tdec_have_avx2() {
+  return false;
+}
+#endif /* SRSLTE_HAVE_AVX2_KERNELS */
 
 #define AUTO_16_SSE    0
 #define AUTO_16_SSEWIN 1
@@ -178,12 +165,20 @@ int srslte_tdec_init_manual(srslte_tdec_t * h, uint32_t max_long_cb, srslte_tdec
       h->dec8[0] = &sse8_win_impl;
       h->current_llr_type = SRSLTE_TDEC_8;
       break;
-#ifdef LV_HAVE_AVX2
+#ifdef SRSLTE_HAVE_AVX2_KERNELS
     case SRSLTE_TDEC_AVX_WINDOW:
+      if (!tdec_have_avx2()) {
+        fprintf(stderr, "Error decoder %d not supported by this CPU\n", dec_type);
+        goto clean_and_exit;
+      }
       h->dec16[0] = &avx16_win_impl;
       h->current_llr_type = SRSLTE_TDEC_16;
       break;
     case SRSLTE_TDEC_AVX8_WINDOW:
+      if (!tdec_have_avx2()) {
+        fprintf(stderr, "Error decoder %d not supported by this CPU\n", dec_type);
+        goto clean_and_exit;
+      }
       h->dec8[0] = &avx8_win_impl;
       h->current_llr_type = SRSLTE_TDEC_8;
       break;
@@ -240,9 +235,11 @@ int srslte_tdec_init_manual(srslte_tdec_t * h, uint32_t max_long_cb, srslte_tdec
     h->dec16[AUTO_16_SSE] = &sse_impl;
     h->dec16[AUTO_16_SSEWIN] = &sse16_win_impl;
     h->dec8[AUTO_8_SSEWIN]  = &sse8_win_impl;
-#ifdef LV_HAVE_AVX2
-    h->dec16[AUTO_16_AVXWIN] = &avx16_win_impl;
-    h->dec8[AUTO_8_AVXWIN]  = &avx8_win_impl;
+#ifdef SRSLTE_HAVE_AVX2_KERNELS
+    if (tdec_have_avx2()) {
+      h->dec16[AUTO_16_AVXWIN] = &avx16_win_impl;
+      h->dec8[AUTO_8_AVXWIN]  = &avx8_win_impl;
+    }
 #endif
 
     for (int td=0;td<SRSLTE_TDEC_NOF_AUTO_MODES_16;td++) {
@@ -363,12 +360,9 @@ static void tdec_decision_byte(srslte_tdec_t * h, uint8_t *output)
 /* Returns number of subblocks in automatic mode for this long_cb */
 uint32_t srslte_tdec_autoimp_get_subblocks(uint32_t long_cb)
 {
-#ifdef LV_HAVE_AVX2
-  if (!(long_cb%16) && long_cb > 800) {
+  if (tdec_have_avx2() && !(long_cb%16) && long_cb > 800) {
     return 16;
-  } else
-#endif
-  if (!(long_cb%8) && long_cb > 400) {
+  } else if (!(long_cb%8) && long_cb > 400) {
     return 8;
   } else {
     return 0;
@@ -391,12 +385,9 @@ static int tdec_sb_idx(uint32_t long_cb) {
 
 uint32_t srslte_tdec_autoimp_get_subblocks_8bit(uint32_t long_cb)
 {
-#ifdef LV_HAVE_AVX2
-  if (!(long_cb%32) && long_cb > 2048) {
+  if (tdec_have_avx2() && !(long_cb%32) && long_cb > 2048) {
     return 32;
-  } else
-#endif
-  if (!(long_cb%16) && long_cb > 800) {
+  } else if (!(long_cb%16) && long_cb > 800) {
     return 16;
   } else if (!(long_cb%8) && long_cb > 400) {
     return 8;
@@ -32,6 +32,7 @@
 #include <string.h>
 
 #include "srslte/phy/utils/vector.h"
+#include "srslte/phy/utils/cpu_features.h"
 #include "srslte/phy/fec/viterbi.h"
 #include "parity.h"
 #include "viterbi37.h"
@@ -43,11 +44,6 @@
 #define DEFAULT_GAIN 100
 
 #define DEFAULT_GAIN_16 1000
-#define VITERBI_16 
-
-#ifndef LV_HAVE_AVX2
-#undef VITERBI_16
-#endif
 
 
 //#undef LV_HAVE_SSE
@@ -129,7 +125,7 @@ void free37_sse(void *o) {
 
 
 
-#ifdef LV_HAVE_AVX2
+#ifdef SRSLTE_HAVE_AVX2_KERNELS
 int decode37_avx2_16bit(void *o, uint16_t *symbols, uint8_t *data, uint32_t frame_length) {
   srslte_viterbi_t *q = o;
 
@@ -284,6 +280,7 @@ int init37(srslte_viterbi_t *q, int poly[3], uint32_t framebits, bool tail_bitin
   q->gain_quant = DEFAULT_GAIN; 
   q->tail_biting = tail_biting;
   q->decode = decode37;
+  q->decode_s = NULL;
   q->free = free37;
   q->decode_f = NULL;
   q->symbols_uc = srslte_vec_malloc(3 * (q->framebits + q->K - 1) * sizeof(uint8_t));
@@ -321,6 +318,7 @@ int init37_sse(srslte_viterbi_t *q, int poly[3], uint32_t framebits, bool tail_b
   q->gain_quant = DEFAULT_GAIN; 
   q->tail_biting = tail_biting;
   q->decode = decode37_sse;
+  q->decode_s = NULL;
   q->free = free37_sse;
   q->decode_f = NULL;
   q->symbols_uc = srslte_vec_malloc(3 * (q->framebits + q->K - 1) * sizeof(uint8_t));
@@ -358,6 +356,7 @@ int init37_neon(srslte_viterbi_t *q, int poly[3], uint32_t framebits, bool tail_
   q->gain_quant = DEFAULT_GAIN; 
   q->tail_biting = tail_biting;
   q->decode = decode37_neon;
+  q->decode_s = NULL;
   q->free = free37_neon;
   q->decode_f = NULL;
   printf("USING NEON VITERBI***************\n");
@@ -388,7 +387,7 @@ int init37_neon(srslte_viterbi_t *q, int poly[3], uint32_t framebits, bool tail_
 #endif
 
 
-#ifdef LV_HAVE_AVX2
+#ifdef SRSLTE_HAVE_AVX2_KERNELS
 int init37_avx2(srslte_viterbi_t *q, int poly[3], uint32_t framebits, bool tail_biting) {
   q->K = 7;
   q->R = 3;
@@ -397,6 +396,7 @@ int init37_avx2(srslte_viterbi_t *q, int poly[3], uint32_t framebits, bool tail_
   q->gain_quant = DEFAULT_GAIN; 
   q->tail_biting = tail_biting;
   q->decode = decode37_avx2;
+  q->decode_s = NULL;
   q->free = free37_avx2;
   q->decode_f = NULL;
   q->symbols_uc = srslte_vec_malloc(3 * (q->framebits + q->K - 1) * sizeof(uint8_t));
@@ -476,16 +476,12 @@ int srslte_viterbi_init(srslte_viterbi_t *q, srslte_viterbi_type_t type, int pol
   switch (type) {
   case SRSLTE_VITERBI_37:
 #ifdef LV_HAVE_SSE
-    
-    #ifdef LV_HAVE_AVX2
-      #ifdef VITERBI_16
-        return init37_avx2_16bit(q, poly, max_frame_length, tail_bitting);
-      #else
-        return init37_avx2(q, poly, max_frame_length, tail_bitting);
-      #endif
-    #else
-        return init37_sse(q, poly, max_frame_length, tail_bitting);
-    #endif
+  #ifdef SRSLTE_HAVE_AVX2_KERNELS
+    if (srslte_cpu_isa() >= SRSLTE_CPU_ISA_AVX2) {
+      return init37_avx2_16bit(q, poly, max_frame_length, tail_bitting);
+    }
+  #endif
+    return init37_sse(q, poly, max_frame_length, tail_bitting);
 #else
 	#ifdef HAVE_NEON
 	return init37_neon(q, poly, max_frame_length, tail_bitting);
@@ -506,10 +502,14 @@ int srslte_viterbi_init_sse(srslte_viterbi_t *q, srslte_viterbi_type_t type, int
 }
 #endif
 
-#ifdef LV_HAVE_AVX2
+#ifdef SRSLTE_HAVE_AVX2_KERNELS
 int srslte_viterbi_init_avx2(srslte_viterbi_t *q, srslte_viterbi_type_t type, int poly[3], uint32_t max_frame_length, bool tail_bitting) 
 {
-  return init37_avx2(q, poly, max_frame_length, tail_bitting);      
+  if (srslte_cpu_isa() < SRSLTE_CPU_ISA_AVX2) {
+    fprintf(stderr, "AVX2 Viterbi decoder not supported by this CPU\n");
+    return -1;
+  }
+  return init37_avx2(q, poly, max_frame_length, tail_bitting);
 }
 #endif
 
@@ -542,13 +542,13 @@ int srslte_viterbi_decode_f(srslte_viterbi_t *q, float *symbols, uint8_t *data,
         max = fabs(symbols[i]);
       }
     }
-#ifdef VITERBI_16
-    srslte_vec_quant_fus(symbols, q->symbols_us, q->gain_quant/max, 32767.5, 65535, len);
-    return srslte_viterbi_decode_us(q, q->symbols_us, data, frame_length);
-#else
-    srslte_vec_quant_fuc(symbols, q->symbols_uc, q->gain_quant/max, 127.5, 255, len);
-    return srslte_viterbi_decode_uc(q, q->symbols_uc, data, frame_length);
-#endif
+    if (q->decode_s) {
+      srslte_vec_quant_fus(symbols, q->symbols_us, q->gain_quant/max, 32767.5, 65535, len);
+      return srslte_viterbi_decode_us(q, q->symbols_us, data, frame_length);
+    } else {
+      srslte_vec_quant_fuc(symbols, q->symbols_uc, q->gain_quant/max, 127.5, 255, len);
+      return srslte_viterbi_decode_uc(q, q->symbols_uc, data, frame_length);
+    }
   } else {
     return q->decode_f(q, symbols, data, frame_length);
   }  
@@ -575,13 +575,13 @@ int srslte_viterbi_decode_s(srslte_viterbi_t *q, int16_t *symbols, uint8_t *data
       max = abs(symbols[i]);
     }
   }
-#ifdef VITERBI_16
-   srslte_vec_quant_sus(symbols, q->symbols_us, 1, 32767, len);
-   return srslte_viterbi_decode_us(q, q->symbols_us, data, frame_length);
-#else
-   srslte_vec_quant_suc(symbols, q->symbols_uc, (float) q->gain_quant/max, 127, 255, len);    
-   return srslte_viterbi_decode_uc(q, q->symbols_uc, data, frame_length);  
-#endif
+  if (q->decode_s) {
+    srslte_vec_quant_sus(symbols, q->symbols_us, 1, 32767, len);
+    return srslte_viterbi_decode_us(q, q->symbols_us, data, frame_length);
+  } else {
+    srslte_vec_quant_suc(symbols, q->symbols_uc, (float) q->gain_quant/max, 127, 255, len);
+    return srslte_viterbi_decode_uc(q, q->symbols_uc, data, frame_length);
+  }
 
   
 }
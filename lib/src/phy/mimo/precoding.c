@@ -35,6 +35,7 @@
 #include "srslte/phy/utils/debug.h"
 #include "srslte/phy/utils/mat.h"
 #include "srslte/phy/utils/simd.h"
+#include "srslte/phy/utils/vector_simd.h"
 
 #ifdef LV_HAVE_SSE
 #include <immintrin.h>
@@ -48,7 +49,161 @@ int srslte_predecoding_single_avx(cf_t *y[SRSLTE_MAX_PORTS], cf_t *h[SRSLTE_MAX_
 #endif
 #include "srslte/phy/utils/mat.h"
 
-static srslte_mimo_decoder_t mimo_decoder = SRSLTE_MIMO_DECODER_MMSE;
+/************************************************
+ *
+ * PRECODING MATRICES
+ *
+ **************************************************/
+
+/* Room for the longest precoder period (4 ports CDD with 3 layers) repeated up to a whole number of SIMD registers */
+#define PRECODER_MAX_LEN 48
+
+/* 36.211 v10.3.0 Table 6.3.4.2.3-2, vectors u_n of the codebook for 4 antenna ports */
+static const cf_t codebook4_u[16][4] = {
+    {1, -1, -1, -1},
+    {1, -_Complex_I, 1, _Complex_I},
+    {1, 1, -1, 1},
+    {1, _Complex_I, 1, -_Complex_I},
+    {1, (-1 - _Complex_I) * (float) M_SQRT1_2, -_Complex_I, (1 - _Complex_I) * (float) M_SQRT1_2},
+    {1, (1 - _Complex_I) * (float) M_SQRT1_2, _Complex_I, (-1 - _Complex_I) * (float) M_SQRT1_2},
+    {1, (1 + _Complex_I) * (float) M_SQRT1_2, -_Complex_I, (-1 + _Complex_I) * (float) M_SQRT1_2},
+    {1, (-1 + _Complex_I) * (float) M_SQRT1_2, _Complex_I, (1 + _Complex_I) * (float) M_SQRT1_2},
+    {1, -1, 1, 1},
+    {1, -_Complex_I, -1, -_Complex_I},
+    {1, 1, 1, -1},
+    {1, _Complex_I, -1, _Complex_I},
+    {1, -1, -1, 1},
+    {1, -1, 1, -1},
+    {1, 1, -1, -1},
+    {1, 1, 1, 1}
+};
+
+/* Columns of W_n taken for each number of layers, counting from 0 */
+static const uint8_t codebook4_columns[16][SRSLTE_MAX_LAYERS][SRSLTE_MAX_LAYERS] = {
+    {{0}, {0, 3}, {0, 1, 3}, {0, 1, 2, 3}},
+    {{0}, {0, 1}, {0, 1, 2}, {0, 1, 2, 3}},
+    {{0}, {0, 1}, {0, 1, 2}, {2, 1, 0, 3}},
+    {{0}, {0, 1}, {0, 1, 2}, {2, 1, 0, 3}},
+    {{0}, {0, 3}, {0, 1, 3}, {0, 1, 2, 3}},
+    {{0}, {0, 3}, {0, 1, 3}, {0, 1, 2, 3}},
+    {{0}, {0, 2}, {0, 2, 3}, {0, 2, 1, 3}},
+    {{0}, {0, 2}, {0, 2, 3}, {0, 2, 1, 3}},
+    {{0}, {0, 1}, {0, 1, 3}, {0, 1, 2, 3}},
+    {{0}, {0, 3}, {0, 2, 3}, {0, 1, 2, 3}},
+    {{0}, {0, 2}, {0, 1, 2}, {0, 2, 1, 3}},
+    {{0}, {0, 2}, {0, 2, 3}, {0, 2, 1, 3}},
+    {{0}, {0, 1}, {0, 1, 2}, {0, 1, 2, 3}},
+    {{0}, {0, 2}, {0, 1, 2}, {0, 2, 1, 3}},
+    {{0}, {0, 2}, {0, 1, 2}, {2, 1, 0, 3}},
+    {{0}, {0, 1}, {0, 1, 2}, {0, 1, 2, 3}}
+};
+
+/* 36.211 v10.3.0 Section 6.3.4.2.3. Precoding matrix of a codebook index, rows are ports and columns are layers */
+static int precoding_codebook(int nof_ports, int nof_layers, int codebook_idx,
+                              cf_t W[SRSLTE_MAX_PORTS][SRSLTE_MAX_LAYERS]) {
+  bzero(W, sizeof(cf_t) * SRSLTE_MAX_PORTS * SRSLTE_MAX_LAYERS);
+
+  if (nof_ports == 2 && nof_layers == 1 && codebook_idx >= 0 && codebook_idx < 4) {
+    const cf_t w1[4] = {1, -1, _Complex_I, -_Complex_I};
+    W[0][0] = (float) M_SQRT1_2;
+    W[1][0] = w1[codebook_idx] * (float) M_SQRT1_2;
+  } else if (nof_ports == 2 && nof_layers == 2 && codebook_idx >= 0 && codebook_idx < 3) {
+    switch (codebook_idx) {
+      case 0:
+        W[0][0] = (float) M_SQRT1_2;
+        W[1][1] = (float) M_SQRT1_2;
+        break;
+      case 1:
+        W[0][0] = W[0][1] = W[1][0] = 0.5f;
+        W[1][1] = -0.5f;
+        break;
+      case 2:
+        W[0][0] = W[0][1] = 0.5f;
+        W[1][0] = 0.5f * _Complex_I;
+        W[1][1] = -0.5f * _Complex_I;
+        break;
+    }
+  } else if (nof_ports == 4 && nof_layers >= 1 && nof_layers <= 4 && codebook_idx >= 0 && codebook_idx < 16) {
+    /* W_n = I - 2 x u_n x u_n' / (u_n' x u_n), where u_n' x u_n = 4 */
+    const cf_t *u = codebook4_u[codebook_idx];
+    float norm = 1.0f / sqrtf(nof_layers);
+    for (int l = 0; l < nof_layers; l++) {
+      int c = codebook4_columns[codebook_idx][nof_layers - 1][l];
+      for (int p = 0; p < nof_ports; p++) {
+        W[p][l] = ((p == c) ? 1.0f : 0.0f) - 0.5f * u[p] * conjf(u[c]);
+        W[p][l] *= norm;
+      }
+    }
+  } else {
+    ERROR("Invalid codebook_idx=%d for %d ports and %d layers", codebook_idx, nof_ports, nof_layers);
+    return SRSLTE_ERROR;
+  }
+  return SRSLTE_SUCCESS;
+}
+
+/* 36.211 v10.3.0 Section 6.3.4.2.2. Precoding matrices W(i) x D(i) x U of large delay CDD. They repeat every 2 REs
+ * with 2 ports and every 4 x nof_layers REs with 4 ports. Returns the period */
+static int precoding_cdd_matrices(int nof_ports, int nof_layers, cf_t P[][SRSLTE_MAX_PORTS][SRSLTE_MAX_LAYERS]) {
+  int period;
+
+  if (nof_layers < 2 || nof_layers > nof_ports) {
+    DEBUG("Invalid number of layers %d for %d ports\n", nof_layers, nof_ports);
+    return SRSLTE_ERROR;
+  }
+  if (nof_ports == 2) {
+    period = 2;
+  } else if (nof_ports == 4) {
+    period = 4 * nof_layers;
+  } else {
+    DEBUG("Number of ports must be 2 or 4 for CDD (nof_ports=%d)\n", nof_ports);
+    return SRSLTE_ERROR;
+  }
+
+  for (int i = 0; i < period; i++) {
+    cf_t W[SRSLTE_MAX_PORTS][SRSLTE_MAX_LAYERS];
+
+    /* W(i) is fixed with 2 ports, it cycles through codebook indexes 12 to 15 with 4 ports */
+    precoding_codebook(nof_ports, nof_layers, (nof_ports == 2) ? 0 : 12 + (i / nof_layers) % 4, W);
+
+    for (int p = 0; p < nof_ports; p++) {
+      for (int l = 0; l < nof_layers; l++) {
+        cf_t acc = 0;
+        for (int k = 0; k < nof_layers; k++) {
+          cf_t d = cexpf(-_Complex_I * 2.0f * (float) M_PI * (float) ((i * k) % nof_layers) / nof_layers);
+          cf_t u = cexpf(-_Complex_I * 2.0f * (float) M_PI * (float) ((k * l) % nof_layers) / nof_layers);
+          acc += W[p][k] * d * u;
+        }
+        P[i][p][l] = acc / sqrtf(nof_layers);
+      }
+    }
+  }
+  return period;
+}
+
+/* Repeats the scaled precoding matrices over a whole number of SIMD registers. Each coefficient is contiguous over
+ * the REs so it can be loaded like the channel estimates. Returns the number of REs */
+static int precoding_expand(cf_t P[][SRSLTE_MAX_PORTS][SRSLTE_MAX_LAYERS], int period, int nof_ports, int nof_layers,
+                            float scaling, cf_t w[SRSLTE_MAX_PORTS][SRSLTE_MAX_LAYERS][PRECODER_MAX_LEN]) {
+#if SRSLTE_SIMD_CF_SIZE != 0
+  int simd_len = SRSLTE_SIMD_CF_SIZE;
+#else
+  int simd_len = 1;
+#endif /* SRSLTE_SIMD_CF_SIZE != 0 */
+
+  int len = period;
+  while (len % simd_len) {
+    len += period;
+  }
+
+  for (int p = 0; p < nof_ports; p++) {
+    for (int l = 0; l < nof_layers; l++) {
+      for (int i = 0; i < len; i++) {
+        w[p][l][i] = P[i % period][p][l] * scaling;
+      }
+    }
+  }
+  return len;
+}
 
 /************************************************
  * 
@@ -719,6 +874,109 @@ int srslte_precoding_mimo_2x2_gen(cf_t W[2][2], cf_t *y[SRSLTE_MAX_PORTS], cf_t
   return SRSLTE_SUCCESS; 
 }
 
+/* Stores the CSI of a layer. With more than 2 layers it is interleaved like the layer demapper output */
+static void predecoding_linear_csi(float *csi[SRSLTE_MAX_CODEWORDS], int nof_layers, int layer, int i,
+                                   const float *v, int n) {
+  int nof_cw0_layers = (nof_layers > 2) ? nof_layers / 2 : 1;
+  int cw = (layer < nof_cw0_layers) ? 0 : 1;
+  int nof_cw_layers = cw ? (nof_layers - nof_cw0_layers) : nof_cw0_layers;
+  int offset = cw ? (layer - nof_cw0_layers) : layer;
+
+  for (int k = 0; k < n; k++) {
+    csi[cw][(i + k) * nof_cw_layers + offset] = v[k];
+  }
+}
+
+/* Linear equalizer of the effective channel H x P(i) for up to 4 receive antennas and 4 layers, one RE per SIMD lane.
+ * P(i) repeats every period REs. It is an MMSE equalizer, or ZF when noise_estimate is 0 */
+static int srslte_predecoding_linear(cf_t *y[SRSLTE_MAX_PORTS],
+                                     cf_t *h[SRSLTE_MAX_PORTS][SRSLTE_MAX_PORTS],
+                                     cf_t *x[SRSLTE_MAX_LAYERS],
+                                     float *csi[SRSLTE_MAX_CODEWORDS],
+                                     int nof_rxant,
+                                     int nof_ports,
+                                     int nof_layers,
+                                     cf_t P[][SRSLTE_MAX_PORTS][SRSLTE_MAX_LAYERS],
+                                     int period,
+                                     int nof_symbols,
+                                     float scaling,
+                                     float noise_estimate) {
+  __attribute__((aligned(SRSLTE_SIMD_BIT_ALIGN))) cf_t w[SRSLTE_MAX_PORTS][SRSLTE_MAX_LAYERS][PRECODER_MAX_LEN];
+  int i = 0;
+
+  if (nof_rxant > SRSLTE_MAT_MAX_DIM || nof_layers > nof_rxant) {
+    DEBUG("Error predecoding: %d layers can not be equalized with %d rx antennas\n", nof_layers, nof_rxant);
+    return SRSLTE_ERROR;
+  }
+  bool csi_enabled = csi && csi[0] && (nof_layers == 1 || csi[1]);
+  int len = precoding_expand(P, period, nof_ports, nof_layers, scaling, w);
+
+#if SRSLTE_SIMD_CF_SIZE != 0
+  for (; i < nof_symbols - SRSLTE_SIMD_CF_SIZE + 1; i += SRSLTE_SIMD_CF_SIZE) {
+    simd_cf_t _y[SRSLTE_MAT_MAX_DIM];
+    simd_cf_t _h[SRSLTE_MAT_MAX_DIM][SRSLTE_MAT_MAX_DIM];
+    simd_cf_t _x[SRSLTE_MAT_MAX_DIM];
+    simd_f_t _csi[SRSLTE_MAT_MAX_DIM];
+    int t = i % len;
+
+    /* Effective channel */
+    for (int r = 0; r < nof_rxant; r++) {
+      _y[r] = srslte_simd_cfi_load(&y[r][i]);
+      for (int p = 0; p < nof_ports; p++) {
+        simd_cf_t hp = srslte_simd_cfi_load(&h[p][r][i]);
+        for (int l = 0; l < nof_layers; l++) {
+          simd_cf_t hw = srslte_simd_cf_prod(hp, srslte_simd_cfi_load(&w[p][l][t]));
+          _h[r][l] = (p == 0) ? hw : srslte_simd_cf_add(_h[r][l], hw);
+        }
+      }
+    }
+
+    srslte_mat_mimo_mmse_csi_simd(_y, _h, nof_rxant, nof_layers, _x, csi_enabled ? _csi : NULL, noise_estimate);
+
+    for (int l = 0; l < nof_layers; l++) {
+      srslte_simd_cfi_store(&x[l][i], _x[l]);
+      if (csi_enabled) {
+        if (nof_layers > 2) {
+          __attribute__((aligned(SRSLTE_SIMD_BIT_ALIGN))) float v[SRSLTE_SIMD_CF_SIZE];
+          srslte_simd_f_store(v, _csi[l]);
+          predecoding_linear_csi(csi, nof_layers, l, i, v, SRSLTE_SIMD_CF_SIZE);
+        } else {
+          srslte_simd_f_store(&csi[l][i], _csi[l]);
+        }
+      }
+    }
+  }
+#endif /* SRSLTE_SIMD_CF_SIZE != 0 */
+
+  for (; i < nof_symbols; i++) {
+    cf_t _y[SRSLTE_MAT_MAX_DIM];
+    cf_t _h[SRSLTE_MAT_MAX_DIM][SRSLTE_MAT_MAX_DIM];
+    cf_t _x[SRSLTE_MAT_MAX_DIM];
+    float _csi[SRSLTE_MAT_MAX_DIM];
+    int t = i % len;
+
+    for (int r = 0; r < nof_rxant; r++) {
+      _y[r] = y[r][i];
+      for (int l = 0; l < nof_layers; l++) {
+        _h[r][l] = 0;
+        for (int p = 0; p < nof_ports; p++) {
+          _h[r][l] += h[p][r][i] * w[p][l][t];
+        }
+      }
+    }
+
+    srslte_mat_mimo_mmse_csi_gen(_y, _h, nof_rxant, nof_layers, _x, csi_enabled ? _csi : NULL, noise_estimate);
+
+    for (int l = 0; l < nof_layers; l++) {
+      x[l][i] = _x[l];
+      if (csi_enabled) {
+        predecoding_linear_csi(csi, nof_layers, l, i, &_csi[l], 1);
+      }
+    }
+  }
+  return SRSLTE_SUCCESS;
+}
+
 static int srslte_predecoding_ccd_2x2_zf_csi(cf_t *y[SRSLTE_MAX_PORTS],
                                              cf_t *h[SRSLTE_MAX_PORTS][SRSLTE_MAX_PORTS],
                                              cf_t *x[SRSLTE_MAX_LAYERS],
@@ -892,6 +1150,28 @@ static int srslte_predecoding_ccd_2x2_zf(cf_t *y[SRSLTE_MAX_PORTS],
   return SRSLTE_SUCCESS;
 }
 
+/* CDD with 4 ports, or with 2 ports and other than 2 rx antennas */
+static int srslte_predecoding_ccd_linear(cf_t *y[SRSLTE_MAX_PORTS],
+                                         cf_t *h[SRSLTE_MAX_PORTS][SRSLTE_MAX_PORTS],
+                                         cf_t *x[SRSLTE_MAX_LAYERS],
+                                         float *csi[SRSLTE_MAX_CODEWORDS],
+                                         int nof_rxant,
+                                         int nof_ports,
+                                         int nof_layers,
+                                         int nof_symbols,
+                                         float scaling,
+                                         float noise_estimate) {
+  cf_t P[4 * SRSLTE_MAX_LAYERS][SRSLTE_MAX_PORTS][SRSLTE_MAX_LAYERS];
+
+  int period = precoding_cdd_matrices(nof_ports, nof_layers, P);
+  if (period < 0) {
+    DEBUG("Error predecoding CCD: Invalid combination of ports %d and layers %d\n", nof_ports, nof_layers);
+    return SRSLTE_ERROR;
+  }
+  return srslte_predecoding_linear(y, h, x, csi, nof_rxant, nof_ports, nof_layers, P, period, nof_symbols, scaling,
+                                   noise_estimate);
+}
+
 static int srslte_predecoding_ccd_zf(cf_t *y[SRSLTE_MAX_PORTS],
                                      cf_t *h[SRSLTE_MAX_PORTS][SRSLTE_MAX_PORTS],
                                      cf_t *x[SRSLTE_MAX_LAYERS],
@@ -912,10 +1192,8 @@ static int srslte_predecoding_ccd_zf(cf_t *y[SRSLTE_MAX_PORTS],
       DEBUG("Error predecoding CCD: Invalid number of layers %d\n", nof_layers);
       return -1;
     }
-  } else if (nof_ports == 4) {
-    DEBUG("Error predecoding CCD: Only 2 ports supported\n");
   } else {
-    DEBUG("Error predecoding CCD: Invalid combination of ports %d and rx antennax %d\n", nof_ports, nof_rxant);
+    return srslte_predecoding_ccd_linear(y, h, x, csi, nof_rxant, nof_ports, nof_layers, nof_symbols, scaling, 0.0f);
   }
   return SRSLTE_ERROR;
 }
@@ -1110,10 +1388,9 @@ int srslte_predecoding_ccd_mmse(cf_t *y[SRSLTE_MAX_PORTS],
       DEBUG("Error predecoding CCD: Invalid number of layers %d\n", nof_layers);
       return -1;
     }
-  } else if (nof_ports == 4) {
-    DEBUG("Error predecoding CCD: Only 2 ports supported\n");
   } else {
-    DEBUG("Error predecoding CCD: Invalid combination of ports %d and rx antennax %d\n", nof_ports, nof_rxant);
+    return srslte_predecoding_ccd_linear(y, h, x, csi, nof_rxant, nof_ports, nof_layers, nof_symbols, scaling,
+                                         noise_estimate);
   }
   return SRSLTE_ERROR;
 }
@@ -1722,7 +1999,8 @@ static int srslte_predecoding_multiplex(cf_t *y[SRSLTE_MAX_PORTS],
                                         int codebook_idx,
                                         int nof_symbols,
                                         float scaling,
-                                        float noise_estimate) {
+                                        float noise_estimate,
+                                        srslte_mimo_decoder_t mimo_decoder) {
   if (nof_ports == 2 && nof_rxant <= 2) {
     if (nof_layers == 2) {
       switch (mimo_decoder) {
@@ -1755,23 +2033,27 @@ static int srslte_predecoding_multiplex(cf_t *y[SRSLTE_MAX_PORTS],
         return srslte_predecoding_multiplex_2x1_mrc(y, h, x, codebook_idx, nof_symbols, scaling);
       }
     }
-  } else if (nof_ports == 4) {
-    DEBUG("Error predecoding multiplex: not implemented for %d Tx ports", nof_ports);
+  } else if (nof_ports == 2 || nof_ports == 4) {
+    cf_t W[1][SRSLTE_MAX_PORTS][SRSLTE_MAX_LAYERS];
+    if (precoding_codebook(nof_ports, nof_layers, codebook_idx, W[0])) {
+      return SRSLTE_ERROR;
+    }
+    if (mimo_decoder == SRSLTE_MIMO_DECODER_ZF) {
+      noise_estimate = 0.0f;
+    }
+    return srslte_predecoding_linear(y, h, x, csi, nof_rxant, nof_ports, nof_layers, W, 1, nof_symbols, scaling,
+                                     noise_estimate);
   } else {
     DEBUG("Error predecoding multiplex: Invalid combination of ports %d and rx antennas %d\n", nof_ports, nof_rxant);
   }
   return SRSLTE_ERROR;
 }
 
-void srslte_predecoding_set_mimo_decoder (srslte_mimo_decoder_t _mimo_decoder) {
-  mimo_decoder = _mimo_decoder;
-}
-
 /* 36.211 v10.3.0 Section 6.3.4 */
 int srslte_predecoding_type(cf_t *y[SRSLTE_MAX_PORTS], cf_t *h[SRSLTE_MAX_PORTS][SRSLTE_MAX_PORTS],
                             cf_t *x[SRSLTE_MAX_LAYERS], float *csi[SRSLTE_MAX_CODEWORDS], int nof_rxant, int nof_ports, int nof_layers,
                             int codebook_idx, int nof_symbols, srslte_mimo_type_t type, float scaling,
-                            float noise_estimate) {
+                            float noise_estimate, srslte_mimo_decoder_t mimo_decoder) {
 
   if (nof_ports > SRSLTE_MAX_PORTS) {
     fprintf(stderr, "Maximum number of ports is %d (nof_ports=%d)\n", SRSLTE_MAX_PORTS,
@@ -1820,7 +2102,7 @@ int srslte_predecoding_type(cf_t *y[SRSLTE_MAX_PORTS], cf_t *h[SRSLTE_MAX_PORTS]
     break;
   case SRSLTE_MIMO_TYPE_SPATIAL_MULTIPLEX:
     return srslte_predecoding_multiplex(y, h, x, csi, nof_rxant, nof_ports, nof_layers, codebook_idx, nof_symbols,
-                                        scaling, noise_estimate);
+                                        scaling, noise_estimate, mimo_decoder);
     default:
       return SRSLTE_ERROR;
   }
@@ -1957,6 +2239,46 @@ int srslte_precoding_cdd_2x2_gen(cf_t *x[SRSLTE_MAX_LAYERS], cf_t *y[SRSLTE_MAX_
   return 2 * nof_symbols;
 }
 
+/* Generic precoder y(i) = P(i) x x(i), where P(i) repeats every period REs */
+static int srslte_precoding_linear(cf_t *x[SRSLTE_MAX_LAYERS], cf_t *y[SRSLTE_MAX_PORTS], int nof_layers,
+                                   int nof_ports, cf_t P[][SRSLTE_MAX_PORTS][SRSLTE_MAX_LAYERS], int period,
+                                   int nof_symbols, float scaling)
+{
+  __attribute__((aligned(SRSLTE_SIMD_BIT_ALIGN))) cf_t w[SRSLTE_MAX_PORTS][SRSLTE_MAX_LAYERS][PRECODER_MAX_LEN];
+  int len = precoding_expand(P, period, nof_ports, nof_layers, scaling, w);
+  int i = 0;
+
+#if SRSLTE_SIMD_CF_SIZE != 0
+  for (; i < nof_symbols - SRSLTE_SIMD_CF_SIZE + 1; i += SRSLTE_SIMD_CF_SIZE) {
+    simd_cf_t _x[SRSLTE_MAX_LAYERS];
+    int t = i % len;
+
+    for (int l = 0; l < nof_layers; l++) {
+      _x[l] = srslte_simd_cfi_load(&x[l][i]);
+    }
+    for (int p = 0; p < nof_ports; p++) {
+      simd_cf_t _y = srslte_simd_cf_prod(_x[0], srslte_simd_cfi_load(&w[p][0][t]));
+      for (int l = 1; l < nof_layers; l++) {
+        _y = srslte_simd_cf_add(_y, srslte_simd_cf_prod(_x[l], srslte_simd_cfi_load(&w[p][l][t])));
+      }
+      srslte_simd_cfi_store(&y[p][i], _y);
+    }
+  }
+#endif /* SRSLTE_SIMD_CF_SIZE != 0 */
+
+  for (; i < nof_symbols; i++) {
+    int t = i % len;
+    for (int p = 0; p < nof_ports; p++) {
+      cf_t acc = 0;
+      for (int l = 0; l < nof_layers; l++) {
+        acc += x[l][i] * w[p][l][t];
+      }
+      y[p][i] = acc;
+    }
+  }
+  return nof_ports * nof_symbols;
+}
+
 int srslte_precoding_cdd(cf_t *x[SRSLTE_MAX_LAYERS], cf_t *y[SRSLTE_MAX_PORTS], int nof_layers, int nof_ports, int nof_symbols, float scaling)
 {
   if (nof_ports == 2) {
@@ -1974,8 +2296,12 @@ int srslte_precoding_cdd(cf_t *x[SRSLTE_MAX_LAYERS], cf_t *y[SRSLTE_MAX_PORTS],
 #endif /* LV_HAVE_SSE */
 #endif /* LV_HAVE_AVX */
   } else if (nof_ports == 4) {
-    DEBUG("Not implemented\n");
-    return -1;
+    cf_t P[4 * SRSLTE_MAX_LAYERS][SRSLTE_MAX_PORTS][SRSLTE_MAX_LAYERS];
+    int period = precoding_cdd_matrices(nof_ports, nof_layers, P);
+    if (period < 0) {
+      return -1;
+    }
+    return srslte_precoding_linear(x, y, nof_layers, nof_ports, P, period, nof_symbols, scaling);
   } else {
     DEBUG("Number of ports must be 2 or 4 for transmit diversity (nof_ports=%d)\n", nof_ports);
     return -1;
@@ -2093,6 +2419,12 @@ int srslte_precoding_multiplex(cf_t *x[SRSLTE_MAX_LAYERS], cf_t *y[SRSLTE_MAX_PO
     } else {
       ERROR("Not implemented");
     }
+  } else if (nof_ports == 4) {
+    cf_t W[1][SRSLTE_MAX_PORTS][SRSLTE_MAX_LAYERS];
+    if (precoding_codebook(nof_ports, nof_layers, codebook_idx, W[0])) {
+      return SRSLTE_ERROR;
+    }
+    srslte_precoding_linear(x, y, nof_layers, nof_ports, W, 1, nof_symbols, scaling);
   } else {
     ERROR("Not implemented");
   }
@@ -192,8 +192,8 @@ int main(int argc, char **argv) {
       nof_re = nof_symbols;
       break;
     case SRSLTE_MIMO_TYPE_CDD:
-      nof_re = nof_symbols*nof_tx_ports/nof_layers;
-      if (nof_rx_ports != 2 || nof_tx_ports != 2) {
+      nof_re = nof_symbols;
+      if (nof_rx_ports < nof_layers || (nof_tx_ports != 2 && nof_tx_ports != 4)) {
         fprintf(stderr, "CDD nof_tx_ports=%d nof_rx_ports=%d is not currently supported\n", nof_tx_ports, nof_rx_ports);
         exit(-1);
       }
@@ -278,10 +278,11 @@ int main(int argc, char **argv) {
   awgn(r, (uint32_t) nof_re, snr_db);
 
   /* If CDD or Spatial muliplex choose decoder */
+  srslte_mimo_decoder_t mimo_decoder;
   if (strncmp(decoder_type_name, "zf", 16) == 0) {
-    srslte_predecoding_set_mimo_decoder(SRSLTE_MIMO_DECODER_ZF);
+    mimo_decoder = SRSLTE_MIMO_DECODER_ZF;
   } else if (strncmp(decoder_type_name, "mmse", 16) == 0) {
-    srslte_predecoding_set_mimo_decoder(SRSLTE_MIMO_DECODER_MMSE);
+    mimo_decoder = SRSLTE_MIMO_DECODER_MMSE;
   } else {
     ret = SRSLTE_ERROR;
     goto quit;
@@ -291,8 +292,12 @@ int main(int argc, char **argv) {
   /* predecoding / equalization */
   struct timeval t[3];
   gettimeofday(&t[1], NULL);
-  srslte_predecoding_type(r, h, xr, NULL, nof_rx_ports, nof_tx_ports, nof_layers,
-                          codebook_idx, nof_re, type, scaling, powf(10, -snr_db / 10));
+  if (srslte_predecoding_type(r, h, xr, NULL, nof_rx_ports, nof_tx_ports, nof_layers,
+                              codebook_idx, nof_re, type, scaling, powf(10, -snr_db / 10), mimo_decoder) < 0) {
+    fprintf(stderr, "Error predecoding\n");
+    ret = SRSLTE_ERROR;
+    goto quit;
+  }
   gettimeofday(&t[2], NULL);
   get_time_interval(t);
 
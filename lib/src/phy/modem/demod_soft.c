@@ -31,20 +31,8 @@
 #include "srslte/phy/utils/vector.h"
 #include "srslte/phy/utils/bit.h"
 #include "srslte/phy/modem/demod_soft.h"
-
-
-#ifdef LV_HAVE_SSE
-#include <smmintrin.h>
-void demod_16qam_lte_s_sse(const cf_t *symbols, short *llr, int nsymbols);
-#endif
-
-#define SCALE_SHORT_CONV_QPSK  100
-#define SCALE_SHORT_CONV_QAM16 400
-#define SCALE_SHORT_CONV_QAM64 700
-
-#define SCALE_BYTE_CONV_QPSK  20
-#define SCALE_BYTE_CONV_QAM16 30
-#define SCALE_BYTE_CONV_QAM64 40
+#include "srslte/phy/utils/cpu_features.h"
+#include "demod_soft_simd.h"
 
 void demod_bpsk_lte_b(const cf_t *symbols, int8_t *llr, int nsymbols) {
   for (int i=0;i<nsymbols;i++) {
@@ -76,8 +64,30 @@ void demod_qpsk_lte(const cf_t *symbols, float *llr, int nsymbols) {
   srslte_vec_sc_prod_fff((const float*) symbols, -sqrt(2), llr, nsymbols*2);
 }
 
+static const srslte_demod_soft_simd_t *simd = &srslte_demod_soft_simd_default;
+
+/* Picks the SIMD kernels for the instruction set in use, see cpu_features.h */
+__attribute__((constructor)) static void demod_soft_simd_select() {
+  switch (srslte_cpu_isa()) {
+#ifdef SRSLTE_DISPATCH_AVX512
+    case SRSLTE_CPU_ISA_AVX512:
+      simd = &srslte_demod_soft_simd_avx512;
+      break;
+#endif /* SRSLTE_DISPATCH_AVX512 */
+#ifdef SRSLTE_DISPATCH_AVX2
+    case SRSLTE_CPU_ISA_AVX2:
+      simd = &srslte_demod_soft_simd_avx2;
+      break;
+#endif /* SRSLTE_DISPATCH_AVX2 */
+    default:
+      simd = &srslte_demod_soft_simd_default;
+  }
+}
+
 void demod_16qam_lte(const cf_t *symbols, float *llr, int nsymbols) {
-  for (int i=0;i<nsymbols;i++) {
+  int i = simd->qam16(symbols, llr, nsymbols);
+
+  for (; i < nsymbols; i++) {
     float yre = crealf(symbols[i]);
     float yim = cimagf(symbols[i]);
     
@@ -88,113 +98,10 @@ void demod_16qam_lte(const cf_t *symbols, float *llr, int nsymbols) {
   }
 }
 
-#ifdef LV_HAVE_SSE
-
-void demod_16qam_lte_s_sse(const cf_t *symbols, short *llr, int nsymbols) {
-    float *symbolsPtr = (float*) symbols;
-  __m128i *resultPtr = (__m128i*) llr;
-  __m128 symbol1, symbol2; 
-  __m128i symbol_i1, symbol_i2, symbol_i, symbol_abs;
-  __m128i offset = _mm_set1_epi16(2*SCALE_SHORT_CONV_QAM16/sqrt(10));
-  __m128i result11, result12, result22, result21; 
-  __m128 scale_v = _mm_set1_ps(-SCALE_SHORT_CONV_QAM16);
-  __m128i shuffle_negated_1 = _mm_set_epi8(0xff,0xff,0xff,0xff,7,6,5,4,0xff,0xff,0xff,0xff,3,2,1,0);
-  __m128i shuffle_abs_1 = _mm_set_epi8(7,6,5,4,0xff,0xff,0xff,0xff,3,2,1,0,0xff,0xff,0xff,0xff);
-
-  __m128i shuffle_negated_2 = _mm_set_epi8(0xff,0xff,0xff,0xff,15,14,13,12,0xff,0xff,0xff,0xff,11,10,9,8);
-  __m128i shuffle_abs_2 = _mm_set_epi8(15,14,13,12,0xff,0xff,0xff,0xff,11,10,9,8,0xff,0xff,0xff,0xff);
-
-  for (int i=0;i<nsymbols/4;i++) {
-    symbol1   = _mm_load_ps(symbolsPtr); symbolsPtr+=4;
-    symbol2   = _mm_load_ps(symbolsPtr); symbolsPtr+=4;
-    symbol_i1 = _mm_cvtps_epi32(_mm_mul_ps(symbol1, scale_v));
-    symbol_i2 = _mm_cvtps_epi32(_mm_mul_ps(symbol2, scale_v));
-    symbol_i  = _mm_packs_epi32(symbol_i1, symbol_i2);
-    
-    symbol_abs  = _mm_abs_epi16(symbol_i);
-    symbol_abs  = _mm_sub_epi16(symbol_abs, offset);
-    
-    result11 = _mm_shuffle_epi8(symbol_i, shuffle_negated_1);  
-    result12 = _mm_shuffle_epi8(symbol_abs, shuffle_abs_1);  
-
-    result21 = _mm_shuffle_epi8(symbol_i, shuffle_negated_2);  
-    result22 = _mm_shuffle_epi8(symbol_abs, shuffle_abs_2);  
-
-    _mm_store_si128(resultPtr, _mm_or_si128(result11, result12)); resultPtr++;
-    _mm_store_si128(resultPtr, _mm_or_si128(result21, result22)); resultPtr++;
-  }
-  // Demodulate last symbols 
-  for (int i=4*(nsymbols/4);i<nsymbols;i++) {
-    short yre = (short) (SCALE_SHORT_CONV_QAM16*crealf(symbols[i]));
-    short yim = (short) (SCALE_SHORT_CONV_QAM16*cimagf(symbols[i]));
-        
-    llr[4*i+0] = -yre;
-    llr[4*i+1] = -yim;
-    llr[4*i+2] = abs(yre)-2*SCALE_SHORT_CONV_QAM16/sqrt(10);
-    llr[4*i+3] = abs(yim)-2*SCALE_SHORT_CONV_QAM16/sqrt(10);    
-  }
-}
-
-void demod_16qam_lte_b_sse(const cf_t *symbols, int8_t *llr, int nsymbols) {
-  float *symbolsPtr = (float*) symbols;
-  __m128i *resultPtr = (__m128i*) llr;
-  __m128 symbol1, symbol2, symbol3, symbol4;
-  __m128i symbol_i1, symbol_i2, symbol_i3, symbol_i4, symbol_i, symbol_abs, symbol_12, symbol_34;
-  __m128i offset = _mm_set1_epi8(2*SCALE_BYTE_CONV_QAM16/sqrt(10));
-  __m128i result1n, result1a, result2n, result2a;
-  __m128 scale_v = _mm_set1_ps(-SCALE_BYTE_CONV_QAM16);
-
-  __m128i shuffle_negated_1 = _mm_set_epi8(0xff,0xff,7,6,0xff,0xff,5,4,0xff,0xff,3,2,0xff,0xff,1,0);
-  __m128i shuffle_abs_1     = _mm_set_epi8(7,6,0xff,0xff,5,4,0xff,0xff,3,2,0xff,0xff,1,0,0xff,0xff);
-
-  __m128i shuffle_negated_2 = _mm_set_epi8(0xff,0xff,15,14,0xff,0xff,13,12,0xff,0xff,11,10,0xff,0xff,9,8);
-  __m128i shuffle_abs_2     = _mm_set_epi8(15,14,0xff,0xff,13,12,0xff,0xff,11,10,0xff,0xff,9,8,0xff,0xff);
-
-  for (int i=0;i<nsymbols/8;i++) {
-    symbol1   = _mm_load_ps(symbolsPtr); symbolsPtr+=4;
-    symbol2   = _mm_load_ps(symbolsPtr); symbolsPtr+=4;
-    symbol3   = _mm_load_ps(symbolsPtr); symbolsPtr+=4;
-    symbol4   = _mm_load_ps(symbolsPtr); symbolsPtr+=4;
-    symbol_i1 = _mm_cvtps_epi32(_mm_mul_ps(symbol1, scale_v));
-    symbol_i2 = _mm_cvtps_epi32(_mm_mul_ps(symbol2, scale_v));
-    symbol_i3 = _mm_cvtps_epi32(_mm_mul_ps(symbol3, scale_v));
-    symbol_i4 = _mm_cvtps_epi32(_mm_mul_ps(symbol4, scale_v));
-    symbol_12  = _mm_packs_epi32(symbol_i1, symbol_i2);
-    symbol_34  = _mm_packs_epi32(symbol_i3, symbol_i4);
-    symbol_i   = _mm_packs_epi16(symbol_12, symbol_34);
-
-    symbol_abs  = _mm_abs_epi8(symbol_i);
-    symbol_abs  = _mm_sub_epi8(symbol_abs, offset);
-
-    result1n = _mm_shuffle_epi8(symbol_i, shuffle_negated_1);
-    result1a = _mm_shuffle_epi8(symbol_abs, shuffle_abs_1);
-
-    result2n = _mm_shuffle_epi8(symbol_i, shuffle_negated_2);
-    result2a = _mm_shuffle_epi8(symbol_abs, shuffle_abs_2);
-
-    _mm_store_si128(resultPtr, _mm_or_si128(result1n, result1a)); resultPtr++;
-    _mm_store_si128(resultPtr, _mm_or_si128(result2n, result2a)); resultPtr++;
-
-  }
-  // Demodulate last symbols
-  for (int i=8*(nsymbols/8);i<nsymbols;i++) {
-    short yre = (int8_t) (SCALE_BYTE_CONV_QAM16*crealf(symbols[i]));
-    short yim = (int8_t) (SCALE_BYTE_CONV_QAM16*cimagf(symbols[i]));
-
-    llr[4*i+0] = -yre;
-    llr[4*i+1] = -yim;
-    llr[4*i+2] = abs(yre)-2*SCALE_BYTE_CONV_QAM16/sqrt(10);
-    llr[4*i+3] = abs(yim)-2*SCALE_BYTE_CONV_QAM16/sqrt(10);
-  }
-}
-
-#endif
-
 void demod_16qam_lte_s(const cf_t *symbols, short *llr, int nsymbols) {
-#ifdef LV_HAVE_SSE
-  demod_16qam_lte_s_sse(symbols, llr, nsymbols);
-#else
-  for (int i=0;i<nsymbols;i++) {
+  int i = simd->qam16_s(symbols, llr, nsymbols);
+
+  for (; i < nsymbols; i++) {
     short yre = (short) (SCALE_SHORT_CONV_QAM16*crealf(symbols[i]));
     short yim = (short) (SCALE_SHORT_CONV_QAM16*cimagf(symbols[i]));
         
@@ -203,14 +110,12 @@ void demod_16qam_lte_s(const cf_t *symbols, short *llr, int nsymbols) {
     llr[4*i+2] = abs(yre)-2*SCALE_SHORT_CONV_QAM16/sqrt(10);
     llr[4*i+3] = abs(yim)-2*SCALE_SHORT_CONV_QAM16/sqrt(10);    
   }
-#endif
 }
 
 void demod_16qam_lte_b(const cf_t *symbols, int8_t *llr, int nsymbols) {
-#ifdef LV_HAVE_SSE
-  demod_16qam_lte_b_sse(symbols, llr, nsymbols);
-#else
-  for (int i=0;i<nsymbols;i++) {
+  int i = simd->qam16_b(symbols, llr, nsymbols);
+
+  for (; i < nsymbols; i++) {
     int8_t yre = (int8_t) (SCALE_BYTE_CONV_QAM16*crealf(symbols[i]));
     int8_t yim = (int8_t) (SCALE_BYTE_CONV_QAM16*cimagf(symbols[i]));
 
@@ -219,12 +124,13 @@ void demod_16qam_lte_b(const cf_t *symbols, int8_t *llr, int nsymbols) {
     llr[4*i+2] = abs(yre)-2*SCALE_BYTE_CONV_QAM16/sqrt(10);
     llr[4*i+3] = abs(yim)-2*SCALE_BYTE_CONV_QAM16/sqrt(10);
   }
-#endif
 }
 
 void demod_64qam_lte(const cf_t *symbols, float *llr, int nsymbols) 
 {
-  for (int i=0;i<nsymbols;i++) {
+  int i = simd->qam64(symbols, llr, nsymbols);
+
+  for (; i < nsymbols; i++) {
     float yre = crealf(symbols[i]);
     float yim = cimagf(symbols[i]);
 
@@ -238,149 +144,11 @@ void demod_64qam_lte(const cf_t *symbols, float *llr, int nsymbols)
   
 }
 
-#ifdef LV_HAVE_SSE
-
-void demod_64qam_lte_s_sse(const cf_t *symbols, short *llr, int nsymbols) 
-{
-  float *symbolsPtr = (float*) symbols;
-  __m128i *resultPtr = (__m128i*) llr;
-  __m128 symbol1, symbol2; 
-  __m128i symbol_i1, symbol_i2, symbol_i, symbol_abs, symbol_abs2;
-  __m128i offset1 = _mm_set1_epi16(4*SCALE_SHORT_CONV_QAM64/sqrt(42));
-  __m128i offset2 = _mm_set1_epi16(2*SCALE_SHORT_CONV_QAM64/sqrt(42));
-  __m128 scale_v = _mm_set1_ps(-SCALE_SHORT_CONV_QAM64);
-  __m128i result11, result12, result13, result22, result21,result23, result31, result32, result33; 
-
-  __m128i shuffle_negated_1 = _mm_set_epi8(7,6,5,4,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,3,2,1,0);
-  __m128i shuffle_negated_2 = _mm_set_epi8(0xff,0xff,0xff,0xff,11,10,9,8,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff);
-  __m128i shuffle_negated_3 = _mm_set_epi8(0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,15,14,13,12,0xff,0xff,0xff,0xff);
-
-  __m128i shuffle_abs_1 = _mm_set_epi8(0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,3,2,1,0,0xff,0xff,0xff,0xff);
-  __m128i shuffle_abs_2 = _mm_set_epi8(11,10,9,8,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,7,6,5,4);
-  __m128i shuffle_abs_3 = _mm_set_epi8(0xff,0xff,0xff,0xff,15,14,13,12,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff);
-
-  __m128i shuffle_abs2_1 = _mm_set_epi8(0xff,0xff,0xff,0xff,3,2,1,0,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff);
-  __m128i shuffle_abs2_2 = _mm_set_epi8(0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,7,6,5,4,0xff,0xff,0xff,0xff);
-  __m128i shuffle_abs2_3 = _mm_set_epi8(15,14,13,12,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,11,10,9,8);
-
-  for (int i=0;i<nsymbols/4;i++) {
-    symbol1   = _mm_load_ps(symbolsPtr); symbolsPtr+=4;
-    symbol2   = _mm_load_ps(symbolsPtr); symbolsPtr+=4;
-    symbol_i1 = _mm_cvtps_epi32(_mm_mul_ps(symbol1, scale_v));
-    symbol_i2 = _mm_cvtps_epi32(_mm_mul_ps(symbol2, scale_v));
-    symbol_i  = _mm_packs_epi32(symbol_i1, symbol_i2);
-    
-    symbol_abs  = _mm_abs_epi16(symbol_i);
-    symbol_abs  = _mm_sub_epi16(symbol_abs, offset1);
-    symbol_abs2 = _mm_sub_epi16(_mm_abs_epi16(symbol_abs), offset2);
-    
-    result11 = _mm_shuffle_epi8(symbol_i, shuffle_negated_1);  
-    result12 = _mm_shuffle_epi8(symbol_abs, shuffle_abs_1);  
-    result13 = _mm_shuffle_epi8(symbol_abs2, shuffle_abs2_1);  
-
-    result21 = _mm_shuffle_epi8(symbol_i, shuffle_negated_2);  
-    result22 = _mm_shuffle_epi8(symbol_abs, shuffle_abs_2);  
-    result23 = _mm_shuffle_epi8(symbol_abs2, shuffle_abs2_2);  
-
-    result31 = _mm_shuffle_epi8(symbol_i, shuffle_negated_3);  
-    result32 = _mm_shuffle_epi8(symbol_abs, shuffle_abs_3);  
-    result33 = _mm_shuffle_epi8(symbol_abs2, shuffle_abs2_3);  
-
-    _mm_store_si128(resultPtr, _mm_or_si128(_mm_or_si128(result11, result12),result13)); resultPtr++;
-    _mm_store_si128(resultPtr, _mm_or_si128(_mm_or_si128(result21, result22),result23)); resultPtr++;
-    _mm_store_si128(resultPtr, _mm_or_si128(_mm_or_si128(result31, result32),result33)); resultPtr++;
-  }
-  for (int i=4*(nsymbols/4);i<nsymbols;i++) {
-    float yre = (short) (SCALE_SHORT_CONV_QAM64*crealf(symbols[i]));
-    float yim = (short) (SCALE_SHORT_CONV_QAM64*cimagf(symbols[i]));
-
-    llr[6*i+0] = -yre;
-    llr[6*i+1] = -yim;
-    llr[6*i+2] = abs(yre)-4*SCALE_SHORT_CONV_QAM64/sqrt(42);
-    llr[6*i+3] = abs(yim)-4*SCALE_SHORT_CONV_QAM64/sqrt(42);
-    llr[6*i+4] = abs(llr[6*i+2])-2*SCALE_SHORT_CONV_QAM64/sqrt(42);
-    llr[6*i+5] = abs(llr[6*i+3])-2*SCALE_SHORT_CONV_QAM64/sqrt(42);        
-  }
-}
-
-void demod_64qam_lte_b_sse(const cf_t *symbols, int8_t *llr, int nsymbols)
-{
-  float *symbolsPtr = (float*) symbols;
-  __m128i *resultPtr = (__m128i*) llr;
-  __m128 symbol1, symbol2, symbol3, symbol4;
-  __m128i symbol_i1, symbol_i2, symbol_i3, symbol_i4, symbol_i, symbol_abs, symbol_abs2,symbol_12, symbol_34;
-  __m128i offset1 = _mm_set1_epi8(4*SCALE_BYTE_CONV_QAM64/sqrt(42));
-  __m128i offset2 = _mm_set1_epi8(2*SCALE_BYTE_CONV_QAM64/sqrt(42));
-  __m128 scale_v = _mm_set1_ps(-SCALE_BYTE_CONV_QAM64);
-  __m128i result11, result12, result13, result22, result21,result23, result31, result32, result33;
-
-  __m128i shuffle_negated_1 = _mm_set_epi8(0xff,0xff,5,4,0xff,0xff,0xff,0xff,3,2,0xff,0xff,0xff,0xff,1,0);
-  __m128i shuffle_negated_2 = _mm_set_epi8(11,10,0xff,0xff,0xff,0xff,9,8,0xff,0xff,0xff,0xff,7,6,0xff,0xff);
-  __m128i shuffle_negated_3 = _mm_set_epi8(0xff,0xff,0xff,0xff,15,14,0xff,0xff,0xff,0xff,13,12,0xff,0xff,0xff,0xff);
-
-  __m128i shuffle_abs_1 = _mm_set_epi8(5,4,0xff,0xff,0xff,0xff,3,2,0xff,0xff,0xff,0xff,1,0,0xff,0xff);
-  __m128i shuffle_abs_2 = _mm_set_epi8(0xff,0xff,0xff,0xff,9,8,0xff,0xff,0xff,0xff,7,6,0xff,0xff,0xff,0xff);
-  __m128i shuffle_abs_3 = _mm_set_epi8(0xff,0xff,15,14,0xff,0xff,0xff,0xff,13,12,0xff,0xff,0xff,0xff,11,10);
-
-  __m128i shuffle_abs2_1 = _mm_set_epi8(0xff,0xff,0xff,0xff,3,2,0xff,0xff,0xff,0xff,1,0,0xff,0xff,0xff,0xff);
-  __m128i shuffle_abs2_2 = _mm_set_epi8(0xff,0xff,9,8,0xff,0xff,0xff,0xff,7,6,0xff,0xff,0xff,0xff,5,4);
-  __m128i shuffle_abs2_3 = _mm_set_epi8(15,14,0xff,0xff,0xff,0xff,13,12,0xff,0xff,0xff,0xff,11,10,0xff,0xff);
-
-  for (int i=0;i<nsymbols/8;i++) {
-    symbol1   = _mm_load_ps(symbolsPtr); symbolsPtr+=4;
-    symbol2   = _mm_load_ps(symbolsPtr); symbolsPtr+=4;
-    symbol3   = _mm_load_ps(symbolsPtr); symbolsPtr+=4;
-    symbol4   = _mm_load_ps(symbolsPtr); symbolsPtr+=4;
-    symbol_i1 = _mm_cvtps_epi32(_mm_mul_ps(symbol1, scale_v));
-    symbol_i2 = _mm_cvtps_epi32(_mm_mul_ps(symbol2, scale_v));
-    symbol_i3 = _mm_cvtps_epi32(_mm_mul_ps(symbol3, scale_v));
-    symbol_i4 = _mm_cvtps_epi32(_mm_mul_ps(symbol4, scale_v));
-    symbol_12  = _mm_packs_epi32(symbol_i1, symbol_i2);
-    symbol_34  = _mm_packs_epi32(symbol_i3, symbol_i4);
-    symbol_i   = _mm_packs_epi16(symbol_12, symbol_34);
-
-    symbol_abs  = _mm_abs_epi8(symbol_i);
-    symbol_abs  = _mm_sub_epi8(symbol_abs, offset1);
-    symbol_abs2 = _mm_sub_epi8(_mm_abs_epi8(symbol_abs), offset2);
-
-    result11 = _mm_shuffle_epi8(symbol_i, shuffle_negated_1);
-    result12 = _mm_shuffle_epi8(symbol_abs, shuffle_abs_1);
-    result13 = _mm_shuffle_epi8(symbol_abs2, shuffle_abs2_1);
-
-    result21 = _mm_shuffle_epi8(symbol_i, shuffle_negated_2);
-    result22 = _mm_shuffle_epi8(symbol_abs, shuffle_abs_2);
-    result23 = _mm_shuffle_epi8(symbol_abs2, shuffle_abs2_2);
-
-    result31 = _mm_shuffle_epi8(symbol_i, shuffle_negated_3);
-    result32 = _mm_shuffle_epi8(symbol_abs, shuffle_abs_3);
-    result33 = _mm_shuffle_epi8(symbol_abs2, shuffle_abs2_3);
-
-    _mm_store_si128(resultPtr, _mm_or_si128(_mm_or_si128(result11, result12),result13)); resultPtr++;
-    _mm_store_si128(resultPtr, _mm_or_si128(_mm_or_si128(result21, result22),result23)); resultPtr++;
-    _mm_store_si128(resultPtr, _mm_or_si128(_mm_or_si128(result31, result32),result33)); resultPtr++;
-
-  }
-  for (int i=8*(nsymbols/8);i<nsymbols;i++) {
-    float yre = (int8_t) (SCALE_BYTE_CONV_QAM64*crealf(symbols[i]));
-    float yim = (int8_t) (SCALE_BYTE_CONV_QAM64*cimagf(symbols[i]));
-
-    llr[6*i+0] = -yre;
-    llr[6*i+1] = -yim;
-    llr[6*i+2] = abs(yre)-4*SCALE_BYTE_CONV_QAM64/sqrt(42);
-    llr[6*i+3] = abs(yim)-4*SCALE_BYTE_CONV_QAM64/sqrt(42);
-    llr[6*i+4] = abs(llr[6*i+2])-2*SCALE_BYTE_CONV_QAM64/sqrt(42);
-    llr[6*i+5] = abs(llr[6*i+3])-2*SCALE_BYTE_CONV_QAM64/sqrt(42);
-  }
-}
-  
-#endif
-
 void demod_64qam_lte_s(const cf_t *symbols, short *llr, int nsymbols) 
 {
-#ifdef LV_HAVE_SSE
-  demod_64qam_lte_s_sse(symbols, llr, nsymbols);
-#else
-  for (int i=0;i<nsymbols;i++) {
+  int i = simd->qam64_s(symbols, llr, nsymbols);
+
+  for (; i < nsymbols; i++) {
     float yre = (short) (SCALE_SHORT_CONV_QAM64*crealf(symbols[i]));
     float yim = (short) (SCALE_SHORT_CONV_QAM64*cimagf(symbols[i]));
 
@@ -391,15 +159,13 @@ void demod_64qam_lte_s(const cf_t *symbols, short *llr, int nsymbols)
     llr[6*i+4] = abs(llr[6*i+2])-2*SCALE_SHORT_CONV_QAM64/sqrt(42);
     llr[6*i+5] = abs(llr[6*i+3])-2*SCALE_SHORT_CONV_QAM64/sqrt(42);        
   }
-#endif
 }
 
 void demod_64qam_lte_b(const cf_t *symbols, int8_t *llr, int nsymbols)
 {
-#ifdef LV_HAVE_SSE
-  demod_64qam_lte_b_sse(symbols, llr, nsymbols);
-#else
-  for (int i=0;i<nsymbols;i++) {
+  int i = simd->qam64_b(symbols, llr, nsymbols);
+
+  for (; i < nsymbols; i++) {
     float yre = (int8_t) (SCALE_BYTE_CONV_QAM64*crealf(symbols[i]));
     float yim = (int8_t) (SCALE_BYTE_CONV_QAM64*cimagf(symbols[i]));
 
@@ -410,7 +176,6 @@ void demod_64qam_lte_b(const cf_t *symbols, int8_t *llr, int nsymbols)
     llr[6*i+4] = abs(llr[6*i+2])-2*SCALE_BYTE_CONV_QAM64/sqrt(42);
     llr[6*i+5] = abs(llr[6*i+3])-2*SCALE_BYTE_CONV_QAM64/sqrt(42);
   }
-#endif
 }
 
 int srslte_demod_soft_demodulate(srslte_mod_t modulation, const cf_t* symbols, float* llr, int nsymbols) {
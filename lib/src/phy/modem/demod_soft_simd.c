@@ -0,0 +1,195 @@
+/**
+ *
+ * \section COPYRIGHT
+ *
+ * Copyright 2013-2015 Software Radio Systems Limited
+ *
+ * \section LICENSE
+ *
+ * This file is part of the srsLTE library.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+
+#include <complex.h>
+#include <math.h>
+
+#include "srslte/config.h"
+#include "demod_soft_simd.h"
+#include "srslte/phy/utils/simd.h"
+
+/* The kernels work on whole vectors of (re, im) pairs: they compute the LLRs of the real and imaginary
+ * parts at once and interleave them per symbol with srslte_simd_*_interleave*_pairs(). The width (SSE,
+ * AVX2 or AVX512) is the one simd.h is built with. The short and byte kernels quantize the symbols first
+ * and run the rest in 16-bit arithmetic; the byte kernels pack to 8 bits with saturation at the end. */
+
+#define QAM16_OFFSET(scale) ((scale)*2/sqrt(10))
+#define QAM64_OFFSET1(scale) ((scale)*4/sqrt(42))
+#define QAM64_OFFSET2(scale) ((scale)*2/sqrt(42))
+
+#if SRSLTE_SIMD_F_SIZE && SRSLTE_SIMD_S_SIZE && defined(LV_HAVE_SSE)
+
+/* Quantizes SRSLTE_SIMD_S_SIZE/2 symbols, negated */
+static inline simd_s_t demod_load_s(const cf_t *symbols, simd_f_t scale) {
+  simd_f_t y0 = srslte_simd_f_loadu((float *) symbols);
+  simd_f_t y1 = srslte_simd_f_loadu((float *) symbols + SRSLTE_SIMD_F_SIZE);
+  return srslte_simd_convert_2f_s(srslte_simd_f_mul(y0, scale), srslte_simd_f_mul(y1, scale));
+}
+
+static inline void demod_16qam_simd_s(const cf_t *symbols, simd_f_t scale, simd_s_t offset,
+                                      simd_s_t *r0, simd_s_t *r1) {
+  simd_s_t n = demod_load_s(symbols, scale);
+  simd_s_t a = srslte_simd_s_sub(srslte_simd_s_abs(n), offset);
+  srslte_simd_s_interleave2_pairs(n, a, r0, r1);
+}
+
+static inline void demod_64qam_simd_s(const cf_t *symbols, simd_f_t scale, simd_s_t offset1, simd_s_t offset2,
+                                      simd_s_t *r0, simd_s_t *r1, simd_s_t *r2) {
+  simd_s_t n = demod_load_s(symbols, scale);
+  simd_s_t a = srslte_simd_s_sub(srslte_simd_s_abs(n), offset1);
+  simd_s_t b = srslte_simd_s_sub(srslte_simd_s_abs(a), offset2);
+  srslte_simd_s_interleave3_pairs(n, a, b, r0, r1, r2);
+}
+
+#endif /* SRSLTE_SIMD_F_SIZE && SRSLTE_SIMD_S_SIZE && LV_HAVE_SSE */
+
+static int demod_16qam_lte_simd(const cf_t *symbols, float *llr, int nsymbols) {
+  int i = 0;
+
+#if SRSLTE_SIMD_F_SIZE && SRSLTE_SIMD_S_SIZE && defined(LV_HAVE_SSE)
+  simd_f_t offset = srslte_simd_f_set1(QAM16_OFFSET(1.0f));
+  for (; i < nsymbols - SRSLTE_SIMD_F_SIZE / 2 + 1; i += SRSLTE_SIMD_F_SIZE / 2) {
+    simd_f_t y = srslte_simd_f_loadu((float *) &symbols[i]);
+    simd_f_t n = srslte_simd_f_neg(y);
+    simd_f_t a = srslte_simd_f_sub(srslte_simd_f_abs(y), offset);
+
+    simd_f_t r0, r1;
+    srslte_simd_f_interleave2_pairs(n, a, &r0, &r1);
+
+    srslte_simd_f_storeu(&llr[4 * i], r0);
+    srslte_simd_f_storeu(&llr[4 * i + SRSLTE_SIMD_F_SIZE], r1);
+  }
+#endif /* SRSLTE_SIMD_F_SIZE && SRSLTE_SIMD_S_SIZE && LV_HAVE_SSE */
+
+  return i;
+}
+
+static int demod_16qam_lte_s_simd(const cf_t *symbols, short *llr, int nsymbols) {
+  int i = 0;
+
+#if SRSLTE_SIMD_F_SIZE && SRSLTE_SIMD_S_SIZE && defined(LV_HAVE_SSE)
+  simd_f_t scale  = srslte_simd_f_set1(-SCALE_SHORT_CONV_QAM16);
+  simd_s_t offset = srslte_simd_s_set1(QAM16_OFFSET(SCALE_SHORT_CONV_QAM16));
+  for (; i < nsymbols - SRSLTE_SIMD_S_SIZE / 2 + 1; i += SRSLTE_SIMD_S_SIZE / 2) {
+    simd_s_t r0, r1;
+    demod_16qam_simd_s(&symbols[i], scale, offset, &r0, &r1);
+    srslte_simd_s_storeu(&llr[4 * i], r0);
+    srslte_simd_s_storeu(&llr[4 * i + SRSLTE_SIMD_S_SIZE], r1);
+  }
+#endif /* SRSLTE_SIMD_F_SIZE && SRSLTE_SIMD_S_SIZE && LV_HAVE_SSE */
+
+  return i;
+}
+
+static int demod_16qam_lte_b_simd(const cf_t *symbols, int8_t *llr, int nsymbols) {
+  int i = 0;
+
+#if SRSLTE_SIMD_F_SIZE && SRSLTE_SIMD_S_SIZE && SRSLTE_SIMD_B_SIZE && defined(LV_HAVE_SSE)
+  simd_f_t scale  = srslte_simd_f_set1(-SCALE_BYTE_CONV_QAM16);
+  simd_s_t offset = srslte_simd_s_set1(QAM16_OFFSET(SCALE_BYTE_CONV_QAM16));
+  for (; i < nsymbols - SRSLTE_SIMD_S_SIZE / 2 + 1; i += SRSLTE_SIMD_S_SIZE / 2) {
+    simd_s_t r0, r1;
+    demod_16qam_simd_s(&symbols[i], scale, offset, &r0, &r1);
+    srslte_simd_b_storeu(&llr[4 * i], srslte_simd_convert_2s_b(r0, r1));
+  }
+#endif /* SRSLTE_SIMD_F_SIZE && SRSLTE_SIMD_S_SIZE && SRSLTE_SIMD_B_SIZE && LV_HAVE_SSE */
+
+  return i;
+}
+
+static int demod_64qam_lte_simd(const cf_t *symbols, float *llr, int nsymbols) {
+  int i = 0;
+
+#if SRSLTE_SIMD_F_SIZE && SRSLTE_SIMD_S_SIZE && defined(LV_HAVE_SSE)
+  simd_f_t offset1 = srslte_simd_f_set1(QAM64_OFFSET1(1.0f));
+  simd_f_t offset2 = srslte_simd_f_set1(QAM64_OFFSET2(1.0f));
+  for (; i < nsymbols - SRSLTE_SIMD_F_SIZE / 2 + 1; i += SRSLTE_SIMD_F_SIZE / 2) {
+    simd_f_t y = srslte_simd_f_loadu((float *) &symbols[i]);
+    simd_f_t n = srslte_simd_f_neg(y);
+    simd_f_t a = srslte_simd_f_sub(srslte_simd_f_abs(y), offset1);
+    simd_f_t b = srslte_simd_f_sub(srslte_simd_f_abs(a), offset2);
+
+    simd_f_t r0, r1, r2;
+    srslte_simd_f_interleave3_pairs(n, a, b, &r0, &r1, &r2);
+
+    srslte_simd_f_storeu(&llr[6 * i], r0);
+    srslte_simd_f_storeu(&llr[6 * i + SRSLTE_SIMD_F_SIZE], r1);
+    srslte_simd_f_storeu(&llr[6 * i + 2 * SRSLTE_SIMD_F_SIZE], r2);
+  }
+#endif /* SRSLTE_SIMD_F_SIZE && SRSLTE_SIMD_S_SIZE && LV_HAVE_SSE */
+
+  return i;
+}
+
+static int demod_64qam_lte_s_simd(const cf_t *symbols, short *llr, int nsymbols) {
+  int i = 0;
+
+#if SRSLTE_SIMD_F_SIZE && SRSLTE_SIMD_S_SIZE && defined(LV_HAVE_SSE)
+  simd_f_t scale   = srslte_simd_f_set1(-SCALE_SHORT_CONV_QAM64);
+  simd_s_t offset1 = srslte_simd_s_set1(QAM64_OFFSET1(SCALE_SHORT_CONV_QAM64));
+  simd_s_t offset2 = srslte_simd_s_set1(QAM64_OFFSET2(SCALE_SHORT_CONV_QAM64));
+  for (; i < nsymbols - SRSLTE_SIMD_S_SIZE / 2 + 1; i += SRSLTE_SIMD_S_SIZE / 2) {
+    simd_s_t r0, r1, r2;
+    demod_64qam_simd_s(&symbols[i], scale, offset1, offset2, &r0, &r1, &r2);
+    srslte_simd_s_storeu(&llr[6 * i], r0);
+    srslte_simd_s_storeu(&llr[6 * i + SRSLTE_SIMD_S_SIZE], r1);
+    srslte_simd_s_storeu(&llr[6 * i + 2 * SRSLTE_SIMD_S_SIZE], r2);
+  }
+#endif /* SRSLTE_SIMD_F_SIZE && SRSLTE_SIMD_S_SIZE && LV_HAVE_SSE */
+
+  return i;
+}
+
+static int demod_64qam_lte_b_simd(const cf_t *symbols, int8_t *llr, int nsymbols) {
+  int i = 0;
+
+#if SRSLTE_SIMD_F_SIZE && SRSLTE_SIMD_S_SIZE && SRSLTE_SIMD_B_SIZE && defined(LV_HAVE_SSE)
+  simd_f_t scale   = srslte_simd_f_set1(-SCALE_BYTE_CONV_QAM64);
+  simd_s_t offset1 = srslte_simd_s_set1(QAM64_OFFSET1(SCALE_BYTE_CONV_QAM64));
+  simd_s_t offset2 = srslte_simd_s_set1(QAM64_OFFSET2(SCALE_BYTE_CONV_QAM64));
+  /* Two vectors of symbols give 6 vectors of short LLRs, packed into 3 of bytes */
+  for (; i < nsymbols - SRSLTE_SIMD_S_SIZE + 1; i += SRSLTE_SIMD_S_SIZE) {
+    simd_s_t r0, r1, r2, r3, r4, r5;
+    demod_64qam_simd_s(&symbols[i], scale, offset1, offset2, &r0, &r1, &r2);
+    demod_64qam_simd_s(&symbols[i + SRSLTE_SIMD_S_SIZE / 2], scale, offset1, offset2, &r3, &r4, &r5);
+    srslte_simd_b_storeu(&llr[6 * i], srslte_simd_convert_2s_b(r0, r1));
+    srslte_simd_b_storeu(&llr[6 * i + SRSLTE_SIMD_B_SIZE], srslte_simd_convert_2s_b(r2, r3));
+    srslte_simd_b_storeu(&llr[6 * i + 2 * SRSLTE_SIMD_B_SIZE], srslte_simd_convert_2s_b(r4, r5));
+  }
+#endif /* SRSLTE_SIMD_F_SIZE && SRSLTE_SIMD_S_SIZE && SRSLTE_SIMD_B_SIZE && LV_HAVE_SSE */
+
+  return i;
+}
+
+const srslte_demod_soft_simd_t srslte_demod_soft_simd_default = {
+  .qam16   = demod_16qam_lte_simd,
+  .qam16_s = demod_16qam_lte_s_simd,
+  .qam16_b = demod_16qam_lte_b_simd,
+  .qam64   = demod_64qam_lte_simd,
+  .qam64_s = demod_64qam_lte_s_simd,
+  .qam64_b = demod_64qam_lte_b_simd,
+};
@@ -0,0 +1,73 @@
+/**
+ *
+ * \section COPYRIGHT
+ *
+ * Copyright 2013-2015 Software Radio Systems Limited
+ *
+ * \section LICENSE
+ *
+ * This file is part of the srsLTE library.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*
+ * SIMD kernels of the QAM soft demodulator. demod_soft_simd.c is built for the baseline
+ * instruction set and once more for each instruction set selected at run time (see
+ * cpu_features.h). Each kernel processes whole vectors of symbols and returns how many
+ * it did; demod_soft.c finishes the remaining ones.
+ */
+
+#ifndef SRSLTE_DEMOD_SOFT_SIMD_H
+#define SRSLTE_DEMOD_SOFT_SIMD_H
+
+#include <stdint.h>
+
+#include "srslte/config.h"
+
+#define SCALE_SHORT_CONV_QPSK  100
+#define SCALE_SHORT_CONV_QAM16 400
+#define SCALE_SHORT_CONV_QAM64 700
+
+#define SCALE_BYTE_CONV_QPSK  20
+#define SCALE_BYTE_CONV_QAM16 30
+#define SCALE_BYTE_CONV_QAM64 40
+
+typedef struct {
+  int (*qam16)   (const cf_t *symbols, float *llr, int nsymbols);
+  int (*qam16_s) (const cf_t *symbols, short *llr, int nsymbols);
+  int (*qam16_b) (const cf_t *symbols, int8_t *llr, int nsymbols);
+  int (*qam64)   (const cf_t *symbols, float *llr, int nsymbols);
+  int (*qam64_s) (const cf_t *symbols, short *llr, int nsymbols);
+  int (*qam64_b) (const cf_t *symbols, int8_t *llr, int nsymbols);
+} srslte_demod_soft_simd_t;
+
+/* The run-time variants export their table as srslte_demod_soft_simd_<isa> */
+#ifdef SRSLTE_SIMD_ISA
+#define srslte_demod_soft_simd_default CONCAT2(srslte_demod_soft_simd, CONCAT2(_, SRSLTE_SIMD_ISA))
+#endif /* SRSLTE_SIMD_ISA */
+
+extern const srslte_demod_soft_simd_t srslte_demod_soft_simd_default;
+
+#ifdef SRSLTE_DISPATCH_AVX2
+extern const srslte_demod_soft_simd_t srslte_demod_soft_simd_avx2;
+#endif /* SRSLTE_DISPATCH_AVX2 */
+
+#ifdef SRSLTE_DISPATCH_AVX512
+extern const srslte_demod_soft_simd_t srslte_demod_soft_simd_avx512;
+#endif /* SRSLTE_DISPATCH_AVX512 */
+
+#endif // SRSLTE_DEMOD_SOFT_SIMD_H
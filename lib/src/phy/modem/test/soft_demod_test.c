@@ -105,6 +105,41 @@ float mse_threshold() {
   }
 }
 
+/* Scale of the short and byte LLRs with respect to the float ones */
+void fixed_point_scale(float *scale_s, float *scale_b) {
+  switch(modulation) {
+    case SRSLTE_MOD_16QAM:
+      *scale_s = 400;
+      *scale_b = 30;
+      break;
+    case SRSLTE_MOD_64QAM:
+      *scale_s = 700;
+      *scale_b = 40;
+      break;
+    default:
+      *scale_s = 100;
+      *scale_b = 20;
+      break;
+  }
+}
+
+/* The fixed point demodulators truncate, so allow a small error against the scaled float LLRs */
+int check_fixed_point(float *llr, short *llr_s, int8_t *llr_b) {
+  float scale_s, scale_b;
+  fixed_point_scale(&scale_s, &scale_b);
+  for (int i=0;i<num_bits;i++) {
+    if (fabsf(llr_s[i] - scale_s*llr[i]) > 3) {
+      printf("Error in short LLR %d: %d != %f\n", i, llr_s[i], scale_s*llr[i]);
+      return -1;
+    }
+    if (fabsf(llr_b[i] - scale_b*llr[i]) > 3) {
+      printf("Error in byte LLR %d: %d != %f\n", i, llr_b[i], scale_b*llr[i]);
+      return -1;
+    }
+  }
+  return 0;
+}
+
 int main(int argc, char **argv) {
   int i;
   srslte_modem_table_t mod;
@@ -229,6 +264,20 @@ int main(int argc, char **argv) {
           goto clean_exit;
       }
     }
+    if (check_fixed_point(llr, llr_s, llr_b)) {
+      goto clean_exit;
+    }
+
+    // Check the fixed point LLRs with noisy symbols too
+    for (i=0;i<num_bits / mod.nbits_x_symbol;i++) {
+      symbols[i] += 0.4*((float) rand()/RAND_MAX - 0.5) + _Complex_I*0.4*((float) rand()/RAND_MAX - 0.5);
+    }
+    srslte_demod_soft_demodulate(modulation, symbols, llr, num_bits / mod.nbits_x_symbol);
+    srslte_demod_soft_demodulate_s(modulation, symbols, llr_s, num_bits / mod.nbits_x_symbol);
+    srslte_demod_soft_demodulate_b(modulation, symbols, llr_b, num_bits / mod.nbits_x_symbol);
+    if (check_fixed_point(llr, llr_s, llr_b)) {
+      goto clean_exit;
+    }
   }
   ret = 0; 
 
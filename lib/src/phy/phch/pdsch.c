@@ -246,6 +246,7 @@ static int pdsch_init(srslte_pdsch_t *q, uint32_t max_prb, bool is_ue, uint32_t
     q->max_re          = max_prb * MAX_PDSCH_RE(q->cell.cp);
     q->is_ue           = is_ue;
     q->nof_rx_antennas = nof_antennas;
+    q->mimo_decoder    = SRSLTE_MIMO_DECODER_MMSE;
 
     INFO("Init PDSCH: %d PRBs, max_symbols: %d\n", max_prb, q->max_re);
 
@@ -293,16 +294,6 @@ static int pdsch_init(srslte_pdsch_t *q, uint32_t max_prb, bool is_ue, uint32_t
       }
     }
 
-    q->users = calloc(sizeof(srslte_pdsch_user_t*), q->is_ue?1:(1+SRSLTE_SIRNTI));
-    if (!q->users) {
-      perror("malloc");
-      goto clean;
-    }
-
-    if (srslte_sequence_init(&q->tmp_seq, q->max_re * srslte_mod_bits_x_symbol(SRSLTE_MOD_64QAM))) {
-      goto clean;
-    }
-
     ret = SRSLTE_SUCCESS;
   }
 
@@ -377,21 +368,6 @@ void srslte_pdsch_free(srslte_pdsch_t *q) {
       }
     }
   }
-  if (q->users) {
-    if (q->is_ue) {
-      srslte_pdsch_free_rnti(q, 0);
-    } else {
-      for (int u=0;u<=SRSLTE_SIRNTI;u++) {
-        if (q->users[u]) {
-          srslte_pdsch_free_rnti(q, u);
-        }
-      }
-    }
-    free(q->users);
-  }
-
-  srslte_sequence_free(&q->tmp_seq);
-
   for (int i = 0; i < 4; i++) {
     srslte_modem_table_free(&q->mod[i]);
   }
@@ -417,39 +393,11 @@ int srslte_pdsch_set_cell(srslte_pdsch_t *q, srslte_cell_t cell)
   return ret;
 }
 
-/* Precalculate the PDSCH scramble sequences for a given RNTI. This function takes a while 
- * to execute, so shall be called once the final C-RNTI has been allocated for the session.
+/* The scrambling sequence is generated on the fly for every codeword, so there is nothing to
+ * precompute for the RNTI. Kept so that the C-RNTI of the UE is known.
  */
 int srslte_pdsch_set_rnti(srslte_pdsch_t *q, uint16_t rnti) {
-  uint32_t rnti_idx = q->is_ue?0:rnti;
-
-  if (!q->users[rnti_idx] || q->is_ue) {
-    if (!q->users[rnti_idx]) {
-      q->users[rnti_idx] = calloc(1, sizeof(srslte_pdsch_user_t));
-      if(!q->users[rnti_idx]) {
-        perror("calloc");
-        return -1;
-      }
-    }
-    q->users[rnti_idx]->sequence_generated = false;
-
-    for (int i = 0; i < SRSLTE_NSUBFRAMES_X_FRAME; i++) {
-      for (int j = 0; j < SRSLTE_MAX_CODEWORDS; j++) {
-        if (srslte_sequence_pdsch(&q->users[rnti_idx]->seq[j][i], rnti, j, 2 * i, q->cell.id,
-                                  q->max_re * srslte_mod_bits_x_symbol(SRSLTE_MOD_64QAM)))
-        {
-          fprintf(stderr, "Error initializing PDSCH scrambling sequence\n");
-          srslte_pdsch_free_rnti(q, rnti);
-          return SRSLTE_ERROR;
-        }
-      }
-    }
-    q->ue_rnti = rnti; 
-    q->users[rnti_idx]->cell_id = q->cell.id;
-    q->users[rnti_idx]->sequence_generated = true;
-  } else {
-    fprintf(stderr, "Error generating PDSCH sequence: rnti=0x%x already generated\n", rnti);
-  }
+  q->ue_rnti = rnti;
   return SRSLTE_SUCCESS;
 }
 
@@ -459,6 +407,12 @@ void srslte_pdsch_set_power_allocation(srslte_pdsch_t *q, float rho_a) {
   }
 }
 
+void srslte_pdsch_set_mimo_decoder(srslte_pdsch_t *q, srslte_mimo_decoder_t mimo_decoder) {
+  if (q) {
+    q->mimo_decoder = mimo_decoder;
+  }
+}
+
 int srslte_pdsch_enable_csi(srslte_pdsch_t *q, bool enable) {
   if (enable) {
     for (int i = 0; i < SRSLTE_MAX_CODEWORDS; i++) {
@@ -477,15 +431,7 @@ int srslte_pdsch_enable_csi(srslte_pdsch_t *q, bool enable) {
 
 void srslte_pdsch_free_rnti(srslte_pdsch_t* q, uint16_t rnti)
 {
-  uint32_t rnti_idx = q->is_ue?0:rnti;
-  if (q->users[rnti_idx]) {
-    for (int i = 0; i < SRSLTE_NSUBFRAMES_X_FRAME; i++) {
-      for (int j = 0; j < SRSLTE_MAX_CODEWORDS; j++) {
-        srslte_sequence_free(&q->users[rnti_idx]->seq[j][i]);
-      }
-    }
-    free(q->users[rnti_idx]);
-    q->users[rnti_idx] = NULL;
+  if (q->ue_rnti == rnti) {
     q->ue_rnti = 0;
   }
 }
@@ -613,24 +559,6 @@ int srslte_pdsch_cfg_mimo(srslte_pdsch_cfg_t *cfg, srslte_cell_t cell, srslte_ra
   }
 }
 
-static srslte_sequence_t *get_user_sequence(srslte_pdsch_t *q, uint16_t rnti,
-                                            uint32_t codeword_idx, uint32_t sf_idx, uint32_t len)
-{
-  uint32_t rnti_idx = q->is_ue?0:rnti;
-
-  // The scrambling sequence is pregenerated for all RNTIs in the eNodeB but only for C-RNTI in the UE
-  if (q->users[rnti_idx] &&
-      q->users[rnti_idx]->sequence_generated &&
-      q->users[rnti_idx]->cell_id == q->cell.id &&
-      (!q->is_ue || q->ue_rnti == rnti))
-  {
-    return &q->users[rnti_idx]->seq[codeword_idx][sf_idx];
-  } else {
-    srslte_sequence_pdsch(&q->tmp_seq, rnti, codeword_idx, 2 * sf_idx, q->cell.id, len);
-    return &q->tmp_seq;
-  }
-}
-
 static int srslte_pdsch_codeword_encode(srslte_pdsch_t *q, srslte_pdsch_cfg_t *cfg,
                                                srslte_softbuffer_tx_t *softbuffer, uint16_t rnti, uint8_t *data,
                                                uint32_t codeword_idx, uint32_t tb_idx) {
@@ -655,11 +583,10 @@ static int srslte_pdsch_codeword_encode(srslte_pdsch_t *q, srslte_pdsch_cfg_t *c
       return SRSLTE_ERROR;
     }
 
-    /* Select scrambling sequence */
-    srslte_sequence_t *seq = get_user_sequence(q, rnti, codeword_idx, cfg->sf_idx, nbits->nof_bits);
-
-    /* Bit scrambling */
-    srslte_scrambling_bytes(seq, (uint8_t *) q->e[codeword_idx], nbits->nof_bits);
+    /* Bit scrambling, the sequence is generated while scrambling */
+    srslte_sequence_state_t seq;
+    srslte_sequence_state_init(&seq, srslte_sequence_pdsch_c_init(rnti, codeword_idx, 2 * cfg->sf_idx, q->cell.id));
+    srslte_scrambling_state_bytes(&seq, (uint8_t *) q->e[codeword_idx], nbits->nof_bits);
 
     /* Bit mapping */
     srslte_mod_modulate_bytes(&q->mod[mcs->mod],
@@ -798,14 +725,13 @@ static int srslte_pdsch_codeword_decode(srslte_pdsch_t *q, srslte_pdsch_cfg_t *c
       srslte_demod_soft_demodulate_s(mcs->mod, q->d[codeword_idx], q->e[codeword_idx], nbits->nof_re);
     }
 
-    /* Select scrambling sequence */
-    srslte_sequence_t *seq = get_user_sequence(q, rnti, codeword_idx, cfg->sf_idx, nbits->nof_bits);
-
-    /* Bit scrambling */
+    /* Bit descrambling, the sequence is generated while descrambling */
+    srslte_sequence_state_t seq;
+    srslte_sequence_state_init(&seq, srslte_sequence_pdsch_c_init(rnti, codeword_idx, 2 * cfg->sf_idx, q->cell.id));
     if (q->llr_is_8bit) {
-      srslte_scrambling_sb_offset(seq, q->e[codeword_idx], 0, nbits->nof_bits);
+      srslte_scrambling_state_sb(&seq, q->e[codeword_idx], nbits->nof_bits);
     } else {
-      srslte_scrambling_s_offset(seq, q->e[codeword_idx], 0, nbits->nof_bits);
+      srslte_scrambling_state_s(&seq, q->e[codeword_idx], nbits->nof_bits);
     }
 
     if (q->csi_enabled) {
@@ -928,7 +854,8 @@ int srslte_pdsch_decode(srslte_pdsch_t *q,
 
     // Pre-decoder
     if (srslte_predecoding_type(q->symbols, q->ce, x, q->csi, q->nof_rx_antennas, q->cell.nof_ports, cfg->nof_layers,
-                                      cfg->codebook_idx, cfg->nbits[0].nof_re, cfg->mimo_type, pdsch_scaling, noise_estimate)<0) {
+                                cfg->codebook_idx, cfg->nbits[0].nof_re, cfg->mimo_type, pdsch_scaling, noise_estimate,
+                                q->mimo_decoder) < 0) {
       DEBUG("Error predecoding\n");
       return SRSLTE_ERROR;
     }
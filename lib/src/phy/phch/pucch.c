@@ -428,16 +428,6 @@ int srslte_pucch_init_(srslte_pucch_t *q, bool is_ue) {
 
     q->is_ue = is_ue;
 
-    q->users = calloc(sizeof(srslte_pucch_user_t*), q->is_ue?1:(1+SRSLTE_SIRNTI));
-    if (!q->users) {
-      perror("malloc");
-      goto clean_exit;
-    }
-
-    if (srslte_sequence_init(&q->tmp_seq, 20)) {
-      goto clean_exit;
-    }
-
     srslte_uci_cqi_pucch_init(&q->cqi);
 
     q->z = srslte_vec_malloc(sizeof(cf_t)*SRSLTE_PUCCH_MAX_SYMBOLS);
@@ -451,7 +441,6 @@ int srslte_pucch_init_(srslte_pucch_t *q, bool is_ue) {
 
     ret = SRSLTE_SUCCESS;
   }
-clean_exit:
   if (ret == SRSLTE_ERROR) {
     srslte_pucch_free(q);
   }
@@ -467,19 +456,6 @@ int srslte_pucch_init_enb(srslte_pucch_t *q) {
 }
 
 void srslte_pucch_free(srslte_pucch_t *q) {
-  if (q->users) {
-    if (q->is_ue) {
-      srslte_pucch_clear_rnti(q, 0);
-    } else {
-      for (int rnti = 0; rnti <= SRSLTE_SIRNTI; rnti++) {
-        srslte_pucch_clear_rnti(q, rnti);
-      }
-    }
-    free(q->users);
-  }
-
-  srslte_sequence_free(&q->tmp_seq);
-
   srslte_uci_cqi_pucch_free(&q->cqi);
   if (q->z) {
     free(q->z);
@@ -521,44 +497,14 @@ int srslte_pucch_set_cell(srslte_pucch_t *q, srslte_cell_t cell) {
 
 
 void srslte_pucch_clear_rnti(srslte_pucch_t *q, uint16_t rnti) {
-  uint32_t rnti_idx = q->is_ue?0:rnti;
-
-  if (q->users[rnti_idx]) {
-    for (int i = 0; i < SRSLTE_NSUBFRAMES_X_FRAME; i++) {
-      srslte_sequence_free(&q->users[rnti_idx]->seq_f2[i]);
-    }    
-    free(q->users[rnti_idx]);
-    q->users[rnti_idx] = NULL;
+  if (q->ue_rnti == rnti) {
     q->ue_rnti = 0;
   }
 }
 
+/* The Format 2 scrambling sequence is generated on the fly, nothing is precomputed for the RNTI */
 int srslte_pucch_set_crnti(srslte_pucch_t *q, uint16_t rnti) {
-
-  uint32_t rnti_idx = q->is_ue?0:rnti;
-  if (!q->users[rnti_idx] || q->is_ue) {
-    if (!q->users[rnti_idx]) {
-      q->users[rnti_idx] = calloc(1, sizeof(srslte_pucch_user_t));
-      if (!q->users[rnti_idx]) {
-        perror("calloc");
-        return -1;
-      }
-    }
-    q->users[rnti_idx]->sequence_generated = false;
-    for (uint32_t sf_idx=0;sf_idx<SRSLTE_NSUBFRAMES_X_FRAME;sf_idx++) {
-      // Precompute scrambling sequence for pucch format 2
-      if (srslte_sequence_pucch(&q->users[rnti_idx]->seq_f2[sf_idx], rnti, 2*sf_idx, q->cell.id)) {
-        fprintf(stderr, "Error computing PUCCH Format 2 scrambling sequence\n");
-        srslte_pucch_clear_rnti(q, rnti);
-        return SRSLTE_ERROR;
-      }
-    }
-    q->ue_rnti = rnti;
-    q->users[rnti_idx]->cell_id = q->cell.id;
-    q->users[rnti_idx]->sequence_generated = true;
-  } else {
-    fprintf(stderr, "Error generating PUSCH sequence: rnti=0x%x already generated\n", rnti);
-  }
+  q->ue_rnti = rnti;
   return SRSLTE_SUCCESS;
 }
 
@@ -630,28 +576,14 @@ int srslte_pucch_format2ab_mod_bits(srslte_pucch_format_t format, uint8_t bits[2
   }
 }
 
-static srslte_sequence_t *get_user_sequence(srslte_pucch_t *q, uint16_t rnti, uint32_t sf_idx)
+static bool get_user_sequence(srslte_pucch_t *q, uint16_t rnti, uint32_t sf_idx, srslte_sequence_state_t *seq)
 {
-  uint32_t rnti_idx = q->is_ue?0:rnti;
-
-  // The scrambling sequence is pregenerated for all RNTIs in the eNodeB but only for C-RNTI in the UE
   if (rnti >= SRSLTE_CRNTI_START && rnti < SRSLTE_CRNTI_END) {
-    if (q->users[rnti_idx] &&
-        q->users[rnti_idx]->sequence_generated &&
-        q->users[rnti_idx]->cell_id == q->cell.id &&
-        (!q->is_ue || q->ue_rnti == rnti))
-    {
-      return &q->users[rnti_idx]->seq_f2[sf_idx];
-    } else {
-      if (srslte_sequence_pucch(&q->tmp_seq, rnti, 2 * sf_idx, q->cell.id)) {
-        fprintf(stderr, "Error computing PUCCH Format 2 scrambling sequence\n");
-        return NULL;
-      }
-      return &q->tmp_seq;
-    }
+    srslte_sequence_state_init(seq, srslte_sequence_pucch_c_init(rnti, 2 * sf_idx, q->cell.id));
+    return true;
   } else {
     fprintf(stderr, "Invalid RNTI=0x%x\n", rnti);
-    return NULL;
+    return false;
   }
 }
 
@@ -659,7 +591,7 @@ static srslte_sequence_t *get_user_sequence(srslte_pucch_t *q, uint16_t rnti, ui
 static int uci_mod_bits(srslte_pucch_t *q, srslte_pucch_format_t format, uint8_t bits[SRSLTE_PUCCH_MAX_BITS], uint32_t sf_idx, uint16_t rnti)
 {  
   uint8_t tmp[2];
-  srslte_sequence_t *seq;
+  srslte_sequence_state_t seq;
   switch(format) {
     case SRSLTE_PUCCH_FORMAT_1:
       q->d[0] = uci_encode_format1();
@@ -675,10 +607,9 @@ static int uci_mod_bits(srslte_pucch_t *q, srslte_pucch_format_t format, uint8_t
     case SRSLTE_PUCCH_FORMAT_2:
     case SRSLTE_PUCCH_FORMAT_2A:
     case SRSLTE_PUCCH_FORMAT_2B:
-      seq = get_user_sequence(q, rnti, sf_idx);
-      if (seq) {
+      if (get_user_sequence(q, rnti, sf_idx, &seq)) {
         memcpy(q->bits_scram, bits, SRSLTE_PUCCH2_NOF_BITS*sizeof(uint8_t));
-        srslte_scrambling_b(seq, q->bits_scram);
+        srslte_scrambling_state_b(&seq, q->bits_scram, SRSLTE_PUCCH2_NOF_BITS);
         srslte_mod_modulate(&q->mod, q->bits_scram, q->d, SRSLTE_PUCCH2_NOF_BITS);
       } else {
         fprintf(stderr, "Error modulating PUCCH2 bits: could not generate sequence\n");
@@ -809,7 +740,7 @@ int srslte_pucch_decode(srslte_pucch_t* q, srslte_pucch_format_t format,
                         uint8_t bits[SRSLTE_PUCCH_MAX_BITS], uint32_t nof_bits)
 {
   int ret = SRSLTE_ERROR_INVALID_INPUTS;
-  srslte_sequence_t *seq;
+  srslte_sequence_state_t seq;
 
   if (q          != NULL && 
       ce         != NULL && 
@@ -909,8 +840,7 @@ int srslte_pucch_decode(srslte_pucch_t* q, srslte_pucch_format_t format,
       case SRSLTE_PUCCH_FORMAT_2:
       case SRSLTE_PUCCH_FORMAT_2A:
       case SRSLTE_PUCCH_FORMAT_2B:
-        seq = get_user_sequence(q, rnti, sf_idx);
-        if (seq) {
+        if (get_user_sequence(q, rnti, sf_idx, &seq)) {
           pucch_encode_(q, format, n_pucch, sf_idx, rnti, NULL, ref, true);
           srslte_vec_prod_conj_ccc(q->z, ref, q->z_tmp, SRSLTE_PUCCH_MAX_SYMBOLS);
           for (int i=0;i<SRSLTE_PUCCH2_NOF_BITS/2;i++) {
@@ -920,7 +850,7 @@ int srslte_pucch_decode(srslte_pucch_t* q, srslte_pucch_format_t format,
             }
           }
           srslte_demod_soft_demodulate_s(SRSLTE_MOD_QPSK, q->z, llr_pucch2, SRSLTE_PUCCH2_NOF_BITS/2);
-          srslte_scrambling_s(seq, llr_pucch2);
+          srslte_scrambling_state_s(&seq, llr_pucch2, SRSLTE_PUCCH2_NOF_BITS);
           q->last_corr = (float) srslte_uci_decode_cqi_pucch(&q->cqi, llr_pucch2, bits, nof_bits)/2000;
           ret = 1; 
         } else {
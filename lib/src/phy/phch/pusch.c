@@ -209,12 +209,6 @@ int pusch_init(srslte_pusch_t *q, uint32_t max_prb, bool is_ue) {
 
     q->is_ue = is_ue;
 
-    q->users = calloc(sizeof(srslte_pusch_user_t*), q->is_ue?1:(1+SRSLTE_SIRNTI));
-    if (!q->users) {
-      perror("malloc");
-      goto clean;
-    }
-
     if (srslte_sequence_init(&q->tmp_seq, q->max_re * srslte_mod_bits_x_symbol(SRSLTE_MOD_64QAM))) {
       goto clean;
     }
@@ -291,17 +285,6 @@ void srslte_pusch_free(srslte_pusch_t *q) {
   
   srslte_dft_precoding_free(&q->dft_precoding);
 
-  if (q->users) {
-    if (q->is_ue) {
-      srslte_pusch_free_rnti(q, 0);
-    } else {
-      for (int rnti=0;rnti<=SRSLTE_SIRNTI;rnti++) {
-        srslte_pusch_free_rnti(q, rnti);
-      }
-    }
-    free(q->users);
-  }
-
   srslte_sequence_free(&q->seq_type2_fo);
   
   srslte_sequence_free(&q->tmp_seq);
@@ -428,77 +411,26 @@ int srslte_pusch_cfg(srslte_pusch_t             *q,
   }
 }
 
-/* Precalculate the PUSCH scramble sequences for a given RNTI. This function takes a while 
- * to execute, so shall be called once the final C-RNTI has been allocated for the session.
- * For the connection procedure, use srslte_pusch_encode() functions */
+/* The scrambling sequence is generated on the fly for every subframe, so there is nothing to
+ * precompute for the RNTI. Kept so that the C-RNTI of the UE is known. */
 int srslte_pusch_set_rnti(srslte_pusch_t *q, uint16_t rnti) {
-  uint32_t i;
-
-  uint32_t rnti_idx = q->is_ue?0:rnti;
-
-  if (!q->users[rnti_idx] || q->is_ue) {
-    if (!q->users[rnti_idx]) {
-      q->users[rnti_idx] = calloc(1, sizeof(srslte_pusch_user_t));
-      if (!q->users[rnti_idx]) {
-        perror("calloc");
-        return -1;
-      }
-    }
-    q->users[rnti_idx]->sequence_generated = false;
-    for (i = 0; i < SRSLTE_NSUBFRAMES_X_FRAME; i++) {
-      if (srslte_sequence_pusch(&q->users[rnti_idx]->seq[i], rnti, 2 * i, q->cell.id,
-                                q->max_re * srslte_mod_bits_x_symbol(SRSLTE_MOD_64QAM)))
-      {
-        fprintf(stderr, "Error initializing PUSCH scrambling sequence\n");
-        srslte_pusch_free_rnti(q, rnti);
-        return SRSLTE_ERROR;
-      }
-    }
-    q->ue_rnti = rnti;
-    q->users[rnti_idx]->cell_id = q->cell.id;
-    q->users[rnti_idx]->sequence_generated = true;
-  } else {
-    fprintf(stderr, "Error generating PUSCH sequence: rnti=0x%x already generated\n", rnti);
-  }
+  q->ue_rnti = rnti;
   return SRSLTE_SUCCESS;
 }
 
 void srslte_pusch_free_rnti(srslte_pusch_t *q, uint16_t rnti) {
-
-  uint32_t rnti_idx = q->is_ue?0:rnti;
-
-  if (q->users[rnti_idx]) {
-    for (int i = 0; i < SRSLTE_NSUBFRAMES_X_FRAME; i++) {
-      srslte_sequence_free(&q->users[rnti_idx]->seq[i]);
-    }    
-    free(q->users[rnti_idx]);
-    q->users[rnti_idx] = NULL;
+  if (q->ue_rnti == rnti) {
     q->ue_rnti = 0;
   }
 }
 
-static srslte_sequence_t *get_user_sequence(srslte_pusch_t *q, uint16_t rnti, uint32_t sf_idx, uint32_t len)
+static bool is_valid_rnti(uint16_t rnti)
 {
-  uint32_t rnti_idx = q->is_ue?0:rnti;
-
   if (rnti >= SRSLTE_CRNTI_START && rnti < SRSLTE_CRNTI_END) {
-    // The scrambling sequence is pregenerated for all RNTIs in the eNodeB but only for C-RNTI in the UE
-    if (q->users[rnti_idx]                          &&
-        q->users[rnti_idx]->sequence_generated      &&
-        q->users[rnti_idx]->cell_id == q->cell.id   &&
-        (!q->is_ue || q->ue_rnti == rnti))
-    {
-      return &q->users[rnti_idx]->seq[sf_idx];
-    } else {
-      if (srslte_sequence_pusch(&q->tmp_seq, rnti, 2 * sf_idx, q->cell.id, len)) {
-        fprintf(stderr, "Error generating temporal scrambling sequence\n");
-        return NULL;
-      }
-      return &q->tmp_seq;
-    }
+    return true;
   } else {
     fprintf(stderr, "Invalid RNTI=0x%x\n", rnti);
-    return NULL;
+    return false;
   }
 }
 
@@ -529,15 +461,14 @@ int srslte_pusch_encode(srslte_pusch_t *q, srslte_pusch_cfg_t *cfg, srslte_softb
       return SRSLTE_ERROR;
     }
 
-    // Generate scrambling sequence if not pre-generated
-    srslte_sequence_t *seq = get_user_sequence(q, rnti, cfg->sf_idx, cfg->nbits.nof_bits);
-
-    // Run scrambling
-    if (!seq) {
+    // Run scrambling, the sequence is generated while scrambling
+    if (!is_valid_rnti(rnti)) {
       fprintf(stderr, "Error getting scrambling sequence\n");
       return SRSLTE_ERROR;
     }
-    srslte_scrambling_bytes(seq, (uint8_t*) q->q, cfg->nbits.nof_bits);
+    srslte_sequence_state_t seq;
+    srslte_sequence_state_init(&seq, srslte_sequence_pusch_c_init(rnti, 2 * cfg->sf_idx, q->cell.id));
+    srslte_scrambling_state_bytes(&seq, (uint8_t*) q->q, cfg->nbits.nof_bits);
 
     // Correct UCI placeholder/repetition bits
     uint8_t *d = q->q; 
@@ -572,6 +503,66 @@ int srslte_pusch_encode(srslte_pusch_t *q, srslte_pusch_cfg_t *cfg, srslte_softb
 }
 
 
+/* Decodes the soft bits in q->q: UCI, descrambling and UL-SCH */
+static int pusch_decode_llr(srslte_pusch_t *q, 
+                            srslte_pusch_cfg_t *cfg, srslte_softbuffer_rx_t *softbuffer, 
+                            uint16_t rnti, uint8_t *data, srslte_cqi_value_t *cqi_value, srslte_uci_data_t *uci_data)
+{
+  if (!is_valid_rnti(rnti)) {
+    fprintf(stderr, "Error getting scrambling sequence\n");
+    return SRSLTE_ERROR;
+  }
+  uint32_t c_init = srslte_sequence_pusch_c_init(rnti, 2 * cfg->sf_idx, q->cell.id);
+
+  // Set CQI len assuming RI = 1 (3GPP 36.212 Clause 5.2.4.1. Uplink control information on PUSCH without UL-SCH data)
+  if (cqi_value) {
+    if (cqi_value->type == SRSLTE_CQI_TYPE_SUBBAND_HL && cqi_value->subband_hl.ri_present) {
+      cqi_value->subband_hl.rank_is_not_one = false;
+      uci_data->uci_ri_len = (q->cell.nof_ports == 4) ? 2 : 1;
+    }
+    uci_data->uci_cqi_len = (uint32_t) srslte_cqi_size(cqi_value);
+  }
+
+  // Decode RI/HARQ bits before descrambling. They need the sequence at the UCI positions only
+  if (uci_data->uci_ack_len > 0 || uci_data->uci_ri_len > 0) {
+    if (srslte_sequence_set_LTE_pr(&q->tmp_seq, cfg->nbits.nof_bits, c_init)) {
+      fprintf(stderr, "Error generating temporal scrambling sequence\n");
+      return SRSLTE_ERROR;
+    }
+  }
+  if (srslte_ulsch_uci_decode_ri_ack(&q->ul_sch, cfg, softbuffer, q->q, q->tmp_seq.c, uci_data)) {
+    fprintf(stderr, "Error decoding RI/HARQ bits\n");
+    return SRSLTE_ERROR; 
+  }
+
+  // Set CQI len with corresponding RI
+  if (cqi_value) {
+    if (cqi_value->type == SRSLTE_CQI_TYPE_SUBBAND_HL) {
+      cqi_value->subband_hl.rank_is_not_one = (uci_data->uci_ri != 0);
+    }
+    uci_data->uci_cqi_len = (uint32_t) srslte_cqi_size(cqi_value);
+  }
+  
+  // Descrambling, the sequence is generated while descrambling
+  srslte_sequence_state_t seq;
+  srslte_sequence_state_init(&seq, c_init);
+  if (q->llr_is_8bit) {
+    srslte_scrambling_state_sb(&seq, q->q, cfg->nbits.nof_bits);
+  } else {
+    srslte_scrambling_state_s(&seq, q->q, cfg->nbits.nof_bits);
+  }
+
+  // Decode
+  int ret = srslte_ulsch_uci_decode(&q->ul_sch, cfg, softbuffer, q->q, q->g, data, uci_data);
+
+  // Unpack CQI value if available
+  if (cqi_value) {
+    srslte_cqi_value_unpack(uci_data->uci_cqi, cqi_value);
+  }
+
+  return ret;
+}
+
 /** Decodes the PUSCH from the received symbols
  */
 int srslte_pusch_decode(srslte_pusch_t *q, 
@@ -620,46 +611,81 @@ int srslte_pusch_decode(srslte_pusch_t *q,
       srslte_demod_soft_demodulate_s(cfg->grant.mcs.mod, q->d, q->q, cfg->nbits.nof_re);
     }
 
-    // Generate scrambling sequence if not pre-generated
-    srslte_sequence_t *seq = get_user_sequence(q, rnti, cfg->sf_idx, cfg->nbits.nof_bits);
+    ret = pusch_decode_llr(q, cfg, softbuffer, rnti, data, cqi_value, uci_data);
+  }
 
-    // Set CQI len assuming RI = 1 (3GPP 36.212 Clause 5.2.4.1. Uplink control information on PUSCH without UL-SCH data)
-    if (cqi_value) {
-      if (cqi_value->type == SRSLTE_CQI_TYPE_SUBBAND_HL && cqi_value->subband_hl.ri_present) {
-        cqi_value->subband_hl.rank_is_not_one = false;
-        uci_data->uci_ri_len = (q->cell.nof_ports == 4) ? 2 : 1;
-      }
-      uci_data->uci_cqi_len = (uint32_t) srslte_cqi_size(cqi_value);
-    }
+  return ret;
+}
 
-    // Decode RI/HARQ bits before descrambling
-    if (srslte_ulsch_uci_decode_ri_ack(&q->ul_sch, cfg, softbuffer, q->q, seq->c, uci_data)) {
-      fprintf(stderr, "Error decoding RI/HARQ bits\n");
-      return SRSLTE_ERROR; 
+/** Decodes the PUSCH from the received symbols and the DMRS estimates in chest. Each data symbol 
+ * goes through the equalizer, the DFT de-precoding and the soft demodulator while it is in cache 
+ */
+int srslte_pusch_decode_fused(srslte_pusch_t *q, 
+                              srslte_pusch_cfg_t *cfg, srslte_softbuffer_rx_t *softbuffer, 
+                              cf_t *sf_symbols, 
+                              srslte_chest_ul_t *chest, float noise_estimate, uint16_t rnti, 
+                              uint8_t *data, srslte_cqi_value_t *cqi_value, srslte_uci_data_t *uci_data)
+{
+  int ret = SRSLTE_ERROR_INVALID_INPUTS;
+  
+  if (q           != NULL &&
+      sf_symbols  != NULL &&
+      chest       != NULL &&
+      data        != NULL &&
+      cfg         != NULL)
+  {
+    
+    INFO("Decoding PUSCH SF: %d, Mod %s, NofBits: %d, NofRE: %d, NofSymbols=%d, NofBitsE: %d, rv_idx: %d\n",
+        cfg->sf_idx, srslte_mod_string(cfg->grant.mcs.mod), cfg->grant.mcs.tbs, 
+          cfg->nbits.nof_re, cfg->nbits.nof_symb, cfg->nbits.nof_bits, cfg->rv);
+
+    if (chest->dmrs_nof_re != cfg->grant.L_prb*SRSLTE_NRE) {
+      fprintf(stderr, "Error DMRS estimated for %d RE but the grant has %d\n", 
+              chest->dmrs_nof_re, cfg->grant.L_prb*SRSLTE_NRE);
+      return SRSLTE_ERROR;
     }
 
-    // Set CQI len with corresponding RI
-    if (cqi_value) {
-      if (cqi_value->type == SRSLTE_CQI_TYPE_SUBBAND_HL) {
-        cqi_value->subband_hl.rank_is_not_one = (uci_data->uci_ri != 0);
-      }
-      uci_data->uci_cqi_len = (uint32_t) srslte_cqi_size(cqi_value);
+    uint32_t L_ref = 3;
+    if (SRSLTE_CP_ISEXT(q->cell.cp)) {
+      L_ref = 2; 
     }
+    uint32_t nof_re_symb = cfg->grant.L_prb*SRSLTE_NRE; 
+    uint32_t Qm = srslte_mod_bits_x_symbol(cfg->grant.mcs.mod);
+    uint32_t n = 0; 
     
-    // Descrambling
-    if (q->llr_is_8bit) {
-      srslte_scrambling_sb_offset(seq, q->q, 0, cfg->nbits.nof_bits);
-    } else {
-      srslte_scrambling_s_offset(seq, q->q, 0, cfg->nbits.nof_bits);
+    for (uint32_t slot=0;slot<2;slot++) {        
+      uint32_t N_srs = 0; 
+      if (q->shortened && slot == 1) {
+        N_srs = 1; 
+      }
+      for (uint32_t l=0;l<SRSLTE_CP_NSYMB(q->cell.cp)-N_srs;l++) {
+        if (l != L_ref && n + nof_re_symb <= cfg->nbits.nof_re) {
+          uint32_t idx = SRSLTE_RE_IDX(q->cell.nof_prb, l+slot*SRSLTE_CP_NSYMB(q->cell.cp), 
+                                       cfg->grant.n_prb_tilde[slot]*SRSLTE_NRE);
+
+          // Equalization, into a scratch symbol
+          srslte_chest_ul_equalize_symbol(chest, &sf_symbols[idx], l+slot*SRSLTE_CP_NSYMB(q->cell.cp), 
+                                          noise_estimate, q->z);
+          
+          // DFT predecoding
+          srslte_dft_precoding(&q->dft_precoding, q->z, &q->d[n], cfg->grant.L_prb, 1);
+
+          // Soft demodulation
+          if (q->llr_is_8bit) {
+            srslte_demod_soft_demodulate_b(cfg->grant.mcs.mod, &q->d[n], &((int8_t*) q->q)[n*Qm], nof_re_symb);
+          } else {
+            srslte_demod_soft_demodulate_s(cfg->grant.mcs.mod, &q->d[n], &((int16_t*) q->q)[n*Qm], nof_re_symb);
+          }
+          n += nof_re_symb; 
+        }
+      }
     }
-
-    // Decode
-    ret = srslte_ulsch_uci_decode(&q->ul_sch, cfg, softbuffer, q->q, q->g, data, uci_data);
-
-    // Unpack CQI value if available
-    if (cqi_value) {
-      srslte_cqi_value_unpack(uci_data->uci_cqi, cqi_value);
+    if (n != cfg->nbits.nof_re) {
+      fprintf(stderr, "Error expecting %d symbols but got %d\n", cfg->nbits.nof_re, n);
+      return SRSLTE_ERROR;
     }
+
+    ret = pusch_decode_llr(q, cfg, softbuffer, rnti, data, cqi_value, uci_data);
   }
 
   return ret;
@@ -341,13 +341,20 @@ bool decode_tb_cb(srslte_sch_t *q,
         rp   = (cb_segm->C - gamma)*n_e + (cb_idx-(cb_segm->C - gamma))*n_e2;
       }
 
+      int16_t *cb_buffer = srslte_softbuffer_rx_get_cb(softbuffer, cb_idx, cb_len);
+      if (!cb_buffer) {
+        // No soft buffer memory left for this CB. Count it as failed, the TB CRC will fail
+        INFO("CB %d: no soft buffer available, cb_len=%d\n", cb_idx, cb_len);
+        continue;
+      }
+
       if (q->llr_is_8bit) {
-        if (srslte_rm_turbo_rx_lut_8bit(&e_bits_b[rp], (int8_t*) softbuffer->buffer_f[cb_idx], n_e2, cb_len_idx, rv)) {
+        if (srslte_rm_turbo_rx_lut_8bit(&e_bits_b[rp], (int8_t*) cb_buffer, n_e2, cb_len_idx, rv)) {
           fprintf(stderr, "Error in rate matching\n");
           return SRSLTE_ERROR;
         }
       } else {
-        if (srslte_rm_turbo_rx_lut(&e_bits_s[rp], softbuffer->buffer_f[cb_idx], n_e2, cb_len_idx, rv)) {
+        if (srslte_rm_turbo_rx_lut(&e_bits_s[rp], cb_buffer, n_e2, cb_len_idx, rv)) {
           fprintf(stderr, "Error in rate matching\n");
           return SRSLTE_ERROR;
         }
@@ -360,9 +367,9 @@ bool decode_tb_cb(srslte_sch_t *q,
       uint32_t cb_noi = 0;
       do {
         if (q->llr_is_8bit) {
-          srslte_tdec_iteration_8bit(&q->decoder, (int8_t*) softbuffer->buffer_f[cb_idx], &data[cb_idx*rlen/8]);
+          srslte_tdec_iteration_8bit(&q->decoder, (int8_t*) cb_buffer, &data[cb_idx*rlen/8]);
         } else {
-          srslte_tdec_iteration(&q->decoder, softbuffer->buffer_f[cb_idx], &data[cb_idx*rlen/8]);
+          srslte_tdec_iteration(&q->decoder, cb_buffer, &data[cb_idx*rlen/8]);
         }
         q->nof_iterations++;
         cb_noi++;
@@ -415,6 +422,10 @@ bool decode_tb_cb(srslte_sch_t *q,
         memcpy(softbuffer->data[i], &data[i * rlen / 8], rlen/8 * sizeof(uint8_t));
       }
     }
+  } else if (softbuffer->pool) {
+    // The TB is decoded, give the soft bits back to the pool instead of holding them until the next new tx
+    srslte_softbuffer_rx_release(softbuffer);
+    bzero(softbuffer->cb_crc, sizeof(bool) * softbuffer->max_cb);
   }
 
   q->nof_iterations /= cb_segm->C;
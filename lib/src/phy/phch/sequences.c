@@ -61,22 +61,34 @@ int srslte_sequence_pdcch(srslte_sequence_t *seq, uint32_t nslot, uint32_t cell_
 /**
  * 36.211 6.3.1
  */
+uint32_t srslte_sequence_pdsch_c_init(uint16_t rnti, int q, uint32_t nslot, uint32_t cell_id) {
+  return (rnti<<14) + (q<<13) + ((nslot/2)<<9) + cell_id;
+}
+
 int srslte_sequence_pdsch(srslte_sequence_t *seq, uint16_t rnti, int q, uint32_t nslot, uint32_t cell_id, uint32_t len) {
-  return srslte_sequence_LTE_pr(seq, len, (rnti<<14) + (q<<13) + ((nslot/2)<<9) + cell_id);
+  return srslte_sequence_LTE_pr(seq, len, srslte_sequence_pdsch_c_init(rnti, q, nslot, cell_id));
 }
 
 /**
  * 36.211 5.3.1
  */
+uint32_t srslte_sequence_pusch_c_init(uint16_t rnti, uint32_t nslot, uint32_t cell_id) {
+  return (rnti<<14) + ((nslot/2)<<9) + cell_id;
+}
+
 int srslte_sequence_pusch(srslte_sequence_t *seq, uint16_t rnti, uint32_t nslot, uint32_t cell_id, uint32_t len) {
-  return srslte_sequence_LTE_pr(seq, len, (rnti<<14) + ((nslot/2)<<9) + cell_id);
+  return srslte_sequence_LTE_pr(seq, len, srslte_sequence_pusch_c_init(rnti, nslot, cell_id));
 }
 
 /**
  * 36.211 5.4.2
  */
+uint32_t srslte_sequence_pucch_c_init(uint16_t rnti, uint32_t nslot, uint32_t cell_id) {
+  return ((((nslot/2)+1)*(2*cell_id+1))<<16)+rnti;
+}
+
 int srslte_sequence_pucch(srslte_sequence_t *seq, uint16_t rnti, uint32_t nslot, uint32_t cell_id) {
-  return srslte_sequence_LTE_pr(seq, 20, ((((nslot/2)+1)*(2*cell_id+1))<<16)+rnti);
+  return srslte_sequence_LTE_pr(seq, 20, srslte_sequence_pucch_c_init(rnti, nslot, cell_id));
 }
 
 int srslte_sequence_pmch(srslte_sequence_t *seq, uint32_t nslot, uint32_t mbsfn_id , uint32_t len){
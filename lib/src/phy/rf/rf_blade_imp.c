@@ -444,14 +444,12 @@ int rf_blade_recv_with_time_multi(void *h,
   return rf_blade_recv_with_time(h, *data, nsamples, blocking, secs, frac_secs);  
 }
 
-int rf_blade_recv_with_time(void *h,
-                    void *data,
-                    uint32_t nsamples,
-                    bool blocking,
-                    time_t *secs,
-                    double *frac_secs) 
+/* Receives nsamples SC16_Q11 samples into handler->rx_buffer */
+static int rf_blade_recv_sc16(rf_blade_handler_t *handler,
+                              uint32_t nsamples,
+                              time_t *secs,
+                              double *frac_secs)
 {
-  rf_blade_handler_t *handler = (rf_blade_handler_t*) h;
   struct bladerf_metadata meta;
   int status; 
   
@@ -479,10 +477,42 @@ int rf_blade_recv_with_time(void *h,
   }
   
   timestamp_to_secs(handler->rx_rate, meta.timestamp, secs, frac_secs);
-  srslte_vec_convert_if(handler->rx_buffer, 2048, data, 2*nsamples);
-  
   return nsamples;
 }
+
+int rf_blade_recv_with_time(void *h,
+                    void *data,
+                    uint32_t nsamples,
+                    bool blocking,
+                    time_t *secs,
+                    double *frac_secs) 
+{
+  rf_blade_handler_t *handler = (rf_blade_handler_t*) h;
+  int n = rf_blade_recv_sc16(handler, nsamples, secs, frac_secs);
+  if (n > 0) {
+    srslte_vec_convert_if(handler->rx_buffer, 2048, data, 2*n);
+  }
+  return n;
+}
+
+int rf_blade_recv_with_time_multi_c16(void *h,
+                                      void **data,
+                                      uint32_t nsamples,
+                                      bool blocking,
+                                      time_t *secs,
+                                      double *frac_secs) 
+{
+  rf_blade_handler_t *handler = (rf_blade_handler_t*) h;
+  int n = rf_blade_recv_sc16(handler, nsamples, secs, frac_secs);
+  if (n > 0) {
+    // Q11 to Q15 
+    int16_t *out = (int16_t*) data[0];
+    for (int i=0;i<2*n;i++) {
+      out[i] = (int16_t) (handler->rx_buffer[i] << 4);
+    }
+  }
+  return n;
+}
                    
 int rf_blade_send_timed_multi(void *h,
                      void *data[4],
@@ -498,31 +528,22 @@ int rf_blade_send_timed_multi(void *h,
                              is_end_of_burst);
 }
 
-int rf_blade_send_timed(void *h,
-                     void *data,
-                     int nsamples,
-                     time_t secs,
-                     double frac_secs,                      
-                     bool has_time_spec,
-                     bool blocking,
-                     bool is_start_of_burst,
-                     bool is_end_of_burst) 
+/* Sends nsamples SC16_Q11 samples from handler->tx_buffer */
+static int rf_blade_send_sc16(rf_blade_handler_t *handler,
+                              int nsamples,
+                              time_t secs,
+                              double frac_secs,
+                              bool has_time_spec,
+                              bool is_start_of_burst,
+                              bool is_end_of_burst)
 {
-  rf_blade_handler_t *handler = (rf_blade_handler_t*) h;
   struct bladerf_metadata meta;
   int status; 
   
   if (!handler->tx_stream_enabled) {
-    rf_blade_start_tx_stream(h);
+    rf_blade_start_tx_stream(handler);
   }
   
-  if (2*nsamples > CONVERT_BUFFER_SIZE) {
-    fprintf(stderr, "TX failed: nsamples exceeds buffer size (%d>%d)\n", nsamples, CONVERT_BUFFER_SIZE);
-    return -1;
-  }
-
-  srslte_vec_convert_fi(data, 2048, handler->tx_buffer, 2*nsamples);
-  
   memset(&meta, 0, sizeof(meta));
   if (is_start_of_burst) {
     if (has_time_spec) {
@@ -561,3 +582,52 @@ int rf_blade_send_timed(void *h,
   return nsamples;
 }
 
+int rf_blade_send_timed(void *h,
+                     void *data,
+                     int nsamples,
+                     time_t secs,
+                     double frac_secs,                      
+                     bool has_time_spec,
+                     bool blocking,
+                     bool is_start_of_burst,
+                     bool is_end_of_burst) 
+{
+  rf_blade_handler_t *handler = (rf_blade_handler_t*) h;
+  
+  if (2*nsamples > CONVERT_BUFFER_SIZE) {
+    fprintf(stderr, "TX failed: nsamples exceeds buffer size (%d>%d)\n", nsamples, CONVERT_BUFFER_SIZE);
+    return -1;
+  }
+
+  srslte_vec_convert_fi(data, 2048, handler->tx_buffer, 2*nsamples);
+  
+  return rf_blade_send_sc16(handler, nsamples, secs, frac_secs, has_time_spec, is_start_of_burst, is_end_of_burst);
+}
+
+int rf_blade_send_timed_multi_c16(void *h,
+                                  void *data[4],
+                                  int nsamples,
+                                  time_t secs,
+                                  double frac_secs,                      
+                                  bool has_time_spec,
+                                  bool blocking,
+                                  bool is_start_of_burst,
+                                  bool is_end_of_burst)
+{
+  rf_blade_handler_t *handler = (rf_blade_handler_t*) h;
+  
+  if (2*nsamples > CONVERT_BUFFER_SIZE) {
+    fprintf(stderr, "TX failed: nsamples exceeds buffer size (%d>%d)\n", nsamples, CONVERT_BUFFER_SIZE);
+    return -1;
+  }
+
+  // Q15 to Q11
+  int16_t *in = (int16_t*) data[0];
+  for (int i=0;i<2*nsamples;i++) {
+    handler->tx_buffer[i] = in[i] >> 4;
+  }
+  
+  return rf_blade_send_sc16(handler, nsamples, secs, frac_secs, has_time_spec, is_start_of_burst, is_end_of_burst);
+}
+
+
@@ -96,6 +96,13 @@ SRSLTE_API int rf_blade_recv_with_time(void *h,
                                   time_t *secs,
                                   double *frac_secs);
 
+SRSLTE_API int rf_blade_recv_with_time_multi_c16(void *h,
+                                                 void **data,
+                                                 uint32_t nsamples,
+                                                 bool blocking,
+                                                 time_t *secs,
+                                                 double *frac_secs);
+
 SRSLTE_API double rf_blade_set_tx_srate(void *h, 
                                     double freq);
 
@@ -119,6 +126,16 @@ SRSLTE_API int rf_blade_send_timed_multi(void *h,
                               bool is_start_of_burst,
                               bool is_end_of_burst);
 
+SRSLTE_API int rf_blade_send_timed_multi_c16(void *h,
+                                             void *data[4],
+                                             int nsamples,
+                                             time_t secs,
+                                             double frac_secs,
+                                             bool has_time_spec,
+                                             bool blocking,
+                                             bool is_start_of_burst,
+                                             bool is_end_of_burst);
+
 SRSLTE_API int  rf_blade_send_timed(void *h, 
                                   void *data, 
                                   int nsamples,
@@ -62,6 +62,12 @@ typedef struct {
   int    (*srslte_rf_send_timed_multi)(void *h, void *data[4], int nsamples,
                      time_t secs, double frac_secs, bool has_time_spec,
                      bool blocking, bool is_start_of_burst, bool is_end_of_burst);
+  /* Optional complex int16 (Q15) interface. When NULL, rf_imp converts to and from cf_t */
+  int    (*srslte_rf_recv_with_time_multi_c16)(void *h, void **data, uint32_t nsamples,
+                           bool blocking, time_t *secs,double *frac_secs);
+  int    (*srslte_rf_send_timed_multi_c16)(void *h, void *data[4], int nsamples,
+                     time_t secs, double frac_secs, bool has_time_spec,
+                     bool blocking, bool is_start_of_burst, bool is_end_of_burst);
 } rf_dev_t; 
 
 /* Define implementation for UHD */
@@ -98,7 +104,9 @@ static rf_dev_t dev_uhd = {
   rf_uhd_recv_with_time,
   rf_uhd_recv_with_time_multi,
   rf_uhd_send_timed,
-  .srslte_rf_send_timed_multi = rf_uhd_send_timed_multi
+  .srslte_rf_send_timed_multi = rf_uhd_send_timed_multi,
+  .srslte_rf_recv_with_time_multi_c16 = rf_uhd_recv_with_time_multi_c16,
+  .srslte_rf_send_timed_multi_c16 = rf_uhd_send_timed_multi_c16
 };
 #endif
 
@@ -136,7 +144,9 @@ static rf_dev_t dev_blade = {
   rf_blade_recv_with_time,
   rf_blade_recv_with_time_multi,
   rf_blade_send_timed,
-  .srslte_rf_send_timed_multi = rf_blade_send_timed_multi
+  .srslte_rf_send_timed_multi = rf_blade_send_timed_multi,
+  .srslte_rf_recv_with_time_multi_c16 = rf_blade_recv_with_time_multi_c16,
+  .srslte_rf_send_timed_multi_c16 = rf_blade_send_timed_multi_c16
 };
 #endif
 
@@ -220,6 +230,45 @@ static rf_dev_t dev_dummy = {
 };
 #endif
 
+/* Define implementation for the shared memory link between local eNB and UE processes */
+#ifdef ENABLE_RF_SHM
+
+#include "rf_shm_imp.h"
+
+static rf_dev_t dev_shm = {
+  RF_SHM_DEVNAME,
+  rf_shm_devname,
+  rf_shm_rx_wait_lo_locked,
+  rf_shm_start_rx_stream,
+  rf_shm_stop_rx_stream,
+  rf_shm_flush_buffer,
+  rf_shm_has_rssi,
+  rf_shm_get_rssi,
+  rf_shm_suppress_stdout,
+  rf_shm_register_error_handler,
+  rf_shm_open,
+  .srslte_rf_open_multi = rf_shm_open_multi,
+  rf_shm_close,
+  rf_shm_set_master_clock_rate,
+  rf_shm_is_master_clock_dynamic,
+  rf_shm_set_rx_srate,
+  rf_shm_set_rx_gain,
+  rf_shm_set_tx_gain,
+  rf_shm_get_rx_gain,
+  rf_shm_get_tx_gain,
+  rf_shm_get_info,
+  rf_shm_set_rx_freq,
+  rf_shm_set_tx_srate,
+  rf_shm_set_tx_freq,
+  rf_shm_get_time,
+  rf_shm_recv_with_time,
+  rf_shm_recv_with_time_multi,
+  rf_shm_send_timed,
+  .srslte_rf_send_timed_multi = rf_shm_send_timed_multi
+};
+
+#endif
+
 static rf_dev_t *available_devices[] = {
 
 #ifdef ENABLE_UHD
@@ -233,6 +282,9 @@ static rf_dev_t *available_devices[] = {
 #endif
 #ifdef ENABLE_DUMMY_DEV
   &dev_dummy,
+#endif
+#ifdef ENABLE_RF_SHM
+  &dev_shm,
 #endif
   NULL
 };
@@ -25,6 +25,7 @@
  */
 
 #include <string.h>
+#include <stdlib.h>
 
 #include "srslte/phy/rf/rf.h"
 #include "srslte/srslte.h"
@@ -100,7 +101,51 @@ const char* srslte_rf_get_devname(srslte_rf_t *rf) {
   return ((rf_dev_t*) rf->dev)->name;
 }
 
+/* Samples converted at once by the _c16 functions on devices that only exchange cf_t */
+#define RF_C16_BUFFER_LEN SRSLTE_SF_LEN_MAX
+
+static void rf_c16_buffers_free(srslte_rf_t *rf)
+{
+  for (int i=0;i<4;i++) {
+    if (rf->c16_rx_buffer[i]) {
+      free(rf->c16_rx_buffer[i]);
+      rf->c16_rx_buffer[i] = NULL;
+    }
+    if (rf->c16_tx_buffer[i]) {
+      free(rf->c16_tx_buffer[i]);
+      rf->c16_tx_buffer[i] = NULL;
+    }
+  }
+}
+
+static int rf_c16_buffers_alloc(srslte_rf_t *rf, uint32_t nof_channels)
+{
+  rf_dev_t *dev = (rf_dev_t*) rf->dev;
+  for (uint32_t i=0;i<nof_channels && i<4;i++) {
+    if (!dev->srslte_rf_recv_with_time_multi_c16) {
+      rf->c16_rx_buffer[i] = srslte_vec_malloc(sizeof(cf_t)*RF_C16_BUFFER_LEN);
+      if (!rf->c16_rx_buffer[i]) {
+        fprintf(stderr, "Error allocating RF conversion buffers\n");
+        rf_c16_buffers_free(rf);
+        return SRSLTE_ERROR;
+      }
+    }
+    if (!dev->srslte_rf_send_timed_multi_c16) {
+      rf->c16_tx_buffer[i] = srslte_vec_malloc(sizeof(cf_t)*RF_C16_BUFFER_LEN);
+      if (!rf->c16_tx_buffer[i]) {
+        fprintf(stderr, "Error allocating RF conversion buffers\n");
+        rf_c16_buffers_free(rf);
+        return SRSLTE_ERROR;
+      }
+    }
+  }
+  return SRSLTE_SUCCESS;
+}
+
 int srslte_rf_open_devname(srslte_rf_t *rf, char *devname, char *args, uint32_t nof_channels) {
+  bzero(rf->c16_rx_buffer, sizeof(rf->c16_rx_buffer));
+  bzero(rf->c16_tx_buffer, sizeof(rf->c16_tx_buffer));
+
   /* Try to open the device if name is provided */
   if (devname) {
     if (devname[0] != '\0') {
@@ -108,7 +153,11 @@ int srslte_rf_open_devname(srslte_rf_t *rf, char *devname, char *args, uint32_t
       while(available_devices[i] != NULL) {
         if (!strcmp(available_devices[i]->name, devname)) {
           rf->dev = available_devices[i];
-          return available_devices[i]->srslte_rf_open_multi(args, &rf->handler, nof_channels);
+          int ret = available_devices[i]->srslte_rf_open_multi(args, &rf->handler, nof_channels);
+          if (!ret && rf_c16_buffers_alloc(rf, nof_channels)) {
+            return -1;
+          }
+          return ret;
         }
         i++;
       }    
@@ -121,7 +170,7 @@ int srslte_rf_open_devname(srslte_rf_t *rf, char *devname, char *args, uint32_t
   while(available_devices[i] != NULL) {
     if (!available_devices[i]->srslte_rf_open_multi(args, &rf->handler, nof_channels)) {
       rf->dev = available_devices[i];
-      return 0; 
+      return rf_c16_buffers_alloc(rf, nof_channels) ? -1 : 0;
     }
     i++;
   }
@@ -185,6 +234,7 @@ int srslte_rf_open_multi(srslte_rf_t *h, char *args, uint32_t nof_channels)
 
 int srslte_rf_close(srslte_rf_t *rf)
 {
+  rf_c16_buffers_free(rf);
   return ((rf_dev_t*) rf->dev)->srslte_rf_close(rf->handler);  
 }
 
@@ -263,6 +313,49 @@ int srslte_rf_recv_with_time_multi(srslte_rf_t *rf,
   return ((rf_dev_t*) rf->dev)->srslte_rf_recv_with_time_multi(rf->handler, data, nsamples, blocking, secs, frac_secs);  
 }
 
+int srslte_rf_recv_with_time_multi_c16(srslte_rf_t *rf,
+                                       void **data,
+                                       uint32_t nsamples,
+                                       bool blocking,
+                                       time_t *secs,
+                                       double *frac_secs)
+{
+  rf_dev_t *dev = (rf_dev_t*) rf->dev;
+  if (dev->srslte_rf_recv_with_time_multi_c16) {
+    return dev->srslte_rf_recv_with_time_multi_c16(rf->handler, data, nsamples, blocking, secs, frac_secs);
+  }
+
+  /* Longer reads than the conversion buffers are split, the first part gives the time */
+  uint32_t n = 0;
+  while (n < nsamples) {
+    uint32_t len = SRSLTE_MIN(nsamples - n, RF_C16_BUFFER_LEN);
+    void *buffer[4] = {NULL, NULL, NULL, NULL};
+    for (int i=0;i<4;i++) {
+      if (data[i]) {
+        if (!rf->c16_rx_buffer[i]) {
+          return SRSLTE_ERROR;
+        }
+        buffer[i] = rf->c16_rx_buffer[i];
+      }
+    }
+    int ret = dev->srslte_rf_recv_with_time_multi(rf->handler, buffer, len, blocking,
+                                                  n ? NULL : secs, n ? NULL : frac_secs);
+    if (ret <= 0) {
+      return n ? (int) n : ret;
+    }
+    for (int i=0;i<4;i++) {
+      if (data[i]) {
+        srslte_vec_convert_fi((float*) buffer[i], SRSLTE_RF_C16_SCALE, &((int16_t*) data[i])[2*n], 2*ret);
+      }
+    }
+    n += ret;
+    if ((uint32_t) ret < len) {
+      break;
+    }
+  }
+  return n;
+}
+
 double srslte_rf_set_tx_gain(srslte_rf_t *rf, double gain)
 {
   return ((rf_dev_t*) rf->dev)->srslte_rf_set_tx_gain(rf->handler, gain);  
@@ -313,6 +406,48 @@ int srslte_rf_send_timed_multi(srslte_rf_t *rf,
                                                            true, blocking, is_start_of_burst, is_end_of_burst);
 }
 
+int srslte_rf_send_timed_multi_c16(srslte_rf_t *rf,
+                                   void *data[4],
+                                   int nsamples,
+                                   time_t secs,
+                                   double frac_secs,
+                                   bool blocking,
+                                   bool is_start_of_burst,
+                                   bool is_end_of_burst)
+{
+  rf_dev_t *dev = (rf_dev_t*) rf->dev;
+  if (dev->srslte_rf_send_timed_multi_c16) {
+    return dev->srslte_rf_send_timed_multi_c16(rf->handler, data, nsamples, secs, frac_secs,
+                                               true, blocking, is_start_of_burst, is_end_of_burst);
+  }
+
+  /* Longer bursts than the conversion buffers are split, only the first part is timed */
+  int n = 0;
+  do {
+    int len = SRSLTE_MIN(nsamples - n, RF_C16_BUFFER_LEN);
+    void *buffer[4] = {NULL, NULL, NULL, NULL};
+    for (int i=0;i<4;i++) {
+      if (data[i]) {
+        if (!rf->c16_tx_buffer[i]) {
+          return SRSLTE_ERROR;
+        }
+        buffer[i] = rf->c16_tx_buffer[i];
+        if (len > 0) {
+          srslte_vec_convert_if(&((int16_t*) data[i])[2*n], SRSLTE_RF_C16_SCALE, (float*) buffer[i], 2*len);
+        }
+      }
+    }
+    int ret = dev->srslte_rf_send_timed_multi(rf->handler, buffer, len, secs, frac_secs, n == 0, blocking,
+                                              is_start_of_burst && n == 0,
+                                              is_end_of_burst && n + len >= nsamples);
+    if (ret < 0) {
+      return ret;
+    }
+    n += len;
+  } while (n < nsamples);
+  return n;
+}
+
 int srslte_rf_send_multi(srslte_rf_t *rf,
                      void *data[4],
                      int nsamples,
@@ -0,0 +1,686 @@
+/**
+ *
+ * \section COPYRIGHT
+ *
+ * Copyright 2013-2015 Software Radio Systems Limited
+ *
+ * \section LICENSE
+ *
+ * This file is part of the srsLTE library.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "srslte/srslte.h"
+#include "srslte/phy/channel/ch_awgn.h"
+#include "rf_shm_imp.h"
+
+#define SHM_MAGIC            0x4d48534652535253ULL // "SRSRFSHM" read as little-endian
+#define SHM_VERSION          1
+#define SHM_CTRL_LEN         4096
+#define SHM_DEFAULT_NAME     "srslte_rf"
+#define SHM_DEFAULT_RING_LEN (1<<20) // Samples, ~45 ms at 23.04 MHz
+#define SHM_MAX_RING_LEN     (1<<24)
+#define SHM_OPEN_TIMEOUT_MS  1000
+
+#define SHM_DIR_DL 0
+#define SHM_DIR_UL 1
+
+/* Segment layout: header, one control block per direction, then the samples
+ * of every direction and channel. Fields written by the writer and the reader
+ * of a ring are kept in separate cache lines. */
+typedef struct {
+  uint64_t magic;                 // Set last by the process creating the segment
+  uint32_t version;
+  uint32_t ring_len;
+  uint64_t epoch_ns;              // CLOCK_MONOTONIC time of sample time 0
+  int32_t  refcount;
+} shm_header_t;
+
+typedef struct {
+  // Writer side
+  int32_t  writer_pid;
+  uint64_t srate;                 // Writer sampling rate in Hz, 0 if unknown
+  uint64_t freq;                  // Writer carrier frequency in Hz, 0 if unknown
+  uint64_t tail;                  // Writer index of the oldest valid sample
+  uint64_t head;                  // Writer index after the newest written sample, 0 if none
+  uint8_t  pad[64 - 5 * sizeof(uint64_t)];
+  // Reader side
+  uint64_t read_ns;               // Time up to which the reader consumed samples
+} shm_ring_ctrl_t;
+
+typedef struct {
+  char              name[64];
+  bool              is_enb;
+  uint8_t          *map;
+  size_t            map_len;
+  shm_header_t     *header;
+  shm_ring_ctrl_t  *tx_ctrl;
+  shm_ring_ctrl_t  *rx_ctrl;
+  cf_t             *tx_ring[SRSLTE_MAX_PORTS];
+  cf_t             *rx_ring[SRSLTE_MAX_PORTS];
+  uint32_t          ring_len;
+  uint32_t          nof_channels;
+
+  double            rx_srate;
+  double            tx_srate;
+  double            rx_freq;
+  double            rx_gain;
+  double            tx_gain;
+  bool              streaming;
+  uint64_t          rx_pos;       // Next sample to receive, counted at rx_srate since the epoch
+
+  float             imp_gain;
+  float             imp_noise_std;
+  double            imp_cfo_hz;
+  double            imp_delay_sec;
+
+  srslte_rf_info_t  info;
+  srslte_rf_error_handler_t error_handler;
+} rf_shm_handler_t;
+
+static uint64_t monotonic_ns()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static uint64_t now_ns(rf_shm_handler_t *handler)
+{
+  return monotonic_ns() - handler->header->epoch_ns;
+}
+
+static void report_error(rf_shm_handler_t *handler, int type, int opt)
+{
+  if (handler->error_handler) {
+    srslte_rf_error_t error;
+    bzero(&error, sizeof(srslte_rf_error_t));
+    error.type = type;
+    error.opt  = opt;
+    handler->error_handler(error);
+  }
+}
+
+static int parse_args(rf_shm_handler_t *handler, char *args)
+{
+  strncpy(handler->name, "/" SHM_DEFAULT_NAME, sizeof(handler->name));
+  handler->ring_len      = SHM_DEFAULT_RING_LEN;
+  handler->imp_gain      = 1.0;
+  handler->imp_noise_std = -1.0;
+
+  bool has_role = false;
+  char *tmp = strdup(args ? args : "");
+  char *saveptr = NULL;
+  char *tok = strtok_r(tmp, ",", &saveptr);
+  while (tok) {
+    while (*tok == ' ') {
+      tok++;
+    }
+    if (!strncmp(tok, "shm_role=", 9)) {
+      has_role = true;
+      if (!strcmp(&tok[9], "enb")) {
+        handler->is_enb = true;
+      } else if (!strcmp(&tok[9], "ue")) {
+        handler->is_enb = false;
+      } else {
+        fprintf(stderr, "[shm] Error invalid role %s, use enb or ue\n", &tok[9]);
+        free(tmp);
+        return -1;
+      }
+    } else if (!strncmp(tok, "shm_name=", 9)) {
+      snprintf(handler->name, sizeof(handler->name), "/%s", &tok[9]);
+    } else if (!strncmp(tok, "shm_ring_len=", 13)) {
+      handler->ring_len = (uint32_t) atoi(&tok[13]);
+    } else if (!strncmp(tok, "shm_gain_db=", 12)) {
+      handler->imp_gain = powf(10.0f, atof(&tok[12]) / 20.0f);
+    } else if (!strncmp(tok, "shm_noise_dbfs=", 15)) {
+      // Complex noise of the given power, split between I and Q
+      handler->imp_noise_std = sqrtf(powf(10.0f, atof(&tok[15]) / 10.0f) / 2.0f);
+    } else if (!strncmp(tok, "shm_cfo_hz=", 11)) {
+      handler->imp_cfo_hz = atof(&tok[11]);
+    } else if (!strncmp(tok, "shm_delay_us=", 13)) {
+      handler->imp_delay_sec = atof(&tok[13]) * 1e-6;
+    }
+    tok = strtok_r(NULL, ",", &saveptr);
+  }
+  free(tmp);
+
+  // Only used when asked for explicitly
+  if (!has_role) {
+    return -1;
+  }
+  if (handler->ring_len < 4096 || handler->ring_len > SHM_MAX_RING_LEN ||
+      (handler->ring_len & (handler->ring_len - 1)) != 0)
+  {
+    fprintf(stderr, "[shm] Error ring length %d must be a power of two between 4096 and %d\n",
+            handler->ring_len, SHM_MAX_RING_LEN);
+    return -1;
+  }
+  return 0;
+}
+
+static size_t segment_len(uint32_t ring_len)
+{
+  return 3 * SHM_CTRL_LEN + 2 * SRSLTE_MAX_PORTS * (size_t) ring_len * sizeof(cf_t);
+}
+
+/* Creates the segment, or maps the one created by the other side */
+static int map_segment(rf_shm_handler_t *handler)
+{
+  bool creator = true;
+  int fd = shm_open(handler->name, O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (fd < 0 && errno == EEXIST) {
+    creator = false;
+    fd = shm_open(handler->name, O_RDWR, 0600);
+  }
+  if (fd < 0) {
+    fprintf(stderr, "[shm] Error opening shared memory %s: %s\n", handler->name, strerror(errno));
+    return -1;
+  }
+
+  size_t map_len = segment_len(handler->ring_len);
+  if (creator) {
+    // Sparse, pages of unused channels take no memory
+    if (ftruncate(fd, map_len) < 0) {
+      fprintf(stderr, "[shm] Error sizing shared memory %s: %s\n", handler->name, strerror(errno));
+      close(fd);
+      shm_unlink(handler->name);
+      return -1;
+    }
+  } else {
+    // Wait for the creator to size it, then follow its ring length
+    struct stat st;
+    int waited_ms = 0;
+    while (fstat(fd, &st) == 0 && st.st_size == 0 && waited_ms < SHM_OPEN_TIMEOUT_MS) {
+      usleep(1000);
+      waited_ms++;
+    }
+    map_len = st.st_size;
+  }
+
+  uint8_t *map = map_len > 0 ? mmap(NULL, map_len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+  close(fd);
+  if (map == MAP_FAILED) {
+    fprintf(stderr, "[shm] Error mapping shared memory %s: %s\n", handler->name, strerror(errno));
+    return -1;
+  }
+  shm_header_t *header = (shm_header_t*) map;
+
+  if (creator) {
+    header->version  = SHM_VERSION;
+    header->ring_len = handler->ring_len;
+    header->epoch_ns = monotonic_ns();
+    header->refcount = 0;
+    __atomic_store_n(&header->magic, SHM_MAGIC, __ATOMIC_RELEASE);
+  } else {
+    int waited_ms = 0;
+    while (__atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) != SHM_MAGIC && waited_ms < SHM_OPEN_TIMEOUT_MS) {
+      usleep(1000);
+      waited_ms++;
+    }
+    if (header->magic != SHM_MAGIC || header->version != SHM_VERSION || map_len != segment_len(header->ring_len)) {
+      fprintf(stderr, "[shm] Error shared memory %s has an incompatible format. Remove /dev/shm%s\n",
+              handler->name, handler->name);
+      munmap(map, map_len);
+      return -1;
+    }
+    if (header->ring_len != handler->ring_len) {
+      printf("[shm] Using ring length %d of the existing shared memory\n", header->ring_len);
+      handler->ring_len = header->ring_len;
+    }
+  }
+  __atomic_add_fetch(&header->refcount, 1, __ATOMIC_ACQ_REL);
+
+  shm_ring_ctrl_t *dl_ctrl = (shm_ring_ctrl_t*) (map + SHM_CTRL_LEN);
+  shm_ring_ctrl_t *ul_ctrl = (shm_ring_ctrl_t*) (map + 2 * SHM_CTRL_LEN);
+  cf_t *samples = (cf_t*) (map + 3 * SHM_CTRL_LEN);
+  uint32_t tx_dir = handler->is_enb ? SHM_DIR_DL : SHM_DIR_UL;
+  uint32_t rx_dir = handler->is_enb ? SHM_DIR_UL : SHM_DIR_DL;
+  for (uint32_t i = 0; i < SRSLTE_MAX_PORTS; i++) {
+    handler->tx_ring[i] = &samples[(tx_dir * SRSLTE_MAX_PORTS + i) * (size_t) handler->ring_len];
+    handler->rx_ring[i] = &samples[(rx_dir * SRSLTE_MAX_PORTS + i) * (size_t) handler->ring_len];
+  }
+  handler->map     = map;
+  handler->map_len = map_len;
+  handler->header  = header;
+  handler->tx_ctrl = handler->is_enb ? dl_ctrl : ul_ctrl;
+  handler->rx_ctrl = handler->is_enb ? ul_ctrl : dl_ctrl;
+  return 0;
+}
+
+static void unmap_segment(rf_shm_handler_t *handler)
+{
+  if (__atomic_sub_fetch(&handler->header->refcount, 1, __ATOMIC_ACQ_REL) == 0) {
+    shm_unlink(handler->name);
+  }
+  munmap(handler->map, handler->map_len);
+}
+
+/* Each ring has a single writer. A writer left by a dead process is taken over. */
+static int claim_writer(rf_shm_handler_t *handler)
+{
+  int32_t pid = getpid();
+  int32_t cur = __atomic_load_n(&handler->tx_ctrl->writer_pid, __ATOMIC_ACQUIRE);
+  while (true) {
+    if (cur != 0 && (cur == pid || kill(cur, 0) == 0)) {
+      fprintf(stderr, "[shm] Error process %d already transmits as %s on %s\n",
+              cur, handler->is_enb ? "eNB" : "UE", handler->name);
+      return -1;
+    }
+    if (__atomic_compare_exchange_n(&handler->tx_ctrl->writer_pid, &cur, pid, false,
+                                    __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+      return 0;
+    }
+  }
+}
+
+static void release_writer(rf_shm_handler_t *handler)
+{
+  int32_t pid = getpid();
+  __atomic_store_n(&handler->tx_ctrl->srate, 0, __ATOMIC_RELEASE);
+  __atomic_store_n(&handler->tx_ctrl->head, 0, __ATOMIC_RELEASE);
+  __atomic_compare_exchange_n(&handler->tx_ctrl->writer_pid, &pid, 0, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+}
+
+char* rf_shm_devname(void *h)
+{
+  return RF_SHM_DEVNAME;
+}
+
+bool rf_shm_rx_wait_lo_locked(void *h)
+{
+  return true;
+}
+
+int rf_shm_start_rx_stream(void *h, bool now)
+{
+  rf_shm_handler_t *handler = (rf_shm_handler_t*) h;
+  if (handler->rx_srate > 0) {
+    handler->rx_pos = (uint64_t) (now_ns(handler) * 1e-9 * handler->rx_srate);
+  }
+  handler->streaming = true;
+  return 0;
+}
+
+int rf_shm_stop_rx_stream(void *h)
+{
+  rf_shm_handler_t *handler = (rf_shm_handler_t*) h;
+  handler->streaming = false;
+  return 0;
+}
+
+void rf_shm_flush_buffer(void *h)
+{
+  rf_shm_start_rx_stream(h, true);
+}
+
+bool rf_shm_has_rssi(void *h)
+{
+  return false;
+}
+
+float rf_shm_get_rssi(void *h)
+{
+  return 0.0;
+}
+
+void rf_shm_suppress_stdout(void *h)
+{
+}
+
+void rf_shm_register_error_handler(void *h, srslte_rf_error_handler_t error_handler)
+{
+  rf_shm_handler_t *handler = (rf_shm_handler_t*) h;
+  handler->error_handler = error_handler;
+}
+
+int rf_shm_open(char *args, void **h)
+{
+  return rf_shm_open_multi(args, h, 1);
+}
+
+int rf_shm_open_multi(char *args, void **h, uint32_t nof_channels)
+{
+  if (nof_channels > SRSLTE_MAX_PORTS) {
+    fprintf(stderr, "[shm] Error too many channels %d\n", nof_channels);
+    return -1;
+  }
+  rf_shm_handler_t *handler = calloc(1, sizeof(rf_shm_handler_t));
+  if (!handler) {
+    return -1;
+  }
+  if (parse_args(handler, args) || map_segment(handler)) {
+    free(handler);
+    return -1;
+  }
+  if (claim_writer(handler)) {
+    unmap_segment(handler);
+    free(handler);
+    return -1;
+  }
+  handler->nof_channels     = nof_channels;
+
+  // Touch the transmit rings now rather than in the first real-time write
+  for (uint32_t i = 0; i < nof_channels; i++) {
+    bzero(handler->tx_ring[i], sizeof(cf_t) * handler->ring_len);
+  }
+  handler->info.min_rx_gain = 0;
+  handler->info.max_rx_gain = 90;
+  handler->info.min_tx_gain = 0;
+  handler->info.max_tx_gain = 90;
+
+  printf("[shm] Opened %s as %s, ring of %d samples", handler->name, handler->is_enb ? "eNB" : "UE", handler->ring_len);
+  if (handler->imp_noise_std >= 0 || handler->imp_cfo_hz != 0 || handler->imp_delay_sec != 0 || handler->imp_gain != 1.0) {
+    printf(", rx impairments: gain %.1f dB, noise %s, cfo %.1f Hz, delay %.1f us",
+           20 * log10f(handler->imp_gain), handler->imp_noise_std >= 0 ? "on" : "off",
+           handler->imp_cfo_hz, handler->imp_delay_sec * 1e6);
+  }
+  printf("\n");
+
+  *h = handler;
+  return 0;
+}
+
+int rf_shm_close(void *h)
+{
+  rf_shm_handler_t *handler = (rf_shm_handler_t*) h;
+  release_writer(handler);
+  unmap_segment(handler);
+  free(handler);
+  return 0;
+}
+
+void rf_shm_set_master_clock_rate(void *h, double rate)
+{
+}
+
+bool rf_shm_is_master_clock_dynamic(void *h)
+{
+  return true;
+}
+
+double rf_shm_set_rx_srate(void *h, double srate)
+{
+  rf_shm_handler_t *handler = (rf_shm_handler_t*) h;
+  if (srate != handler->rx_srate) {
+    handler->rx_srate = round(srate);
+    // Continue at the current time, as a radio restarting its stream
+    if (handler->streaming) {
+      rf_shm_start_rx_stream(h, true);
+    }
+  }
+  return handler->rx_srate;
+}
+
+double rf_shm_set_tx_srate(void *h, double srate)
+{
+  rf_shm_handler_t *handler = (rf_shm_handler_t*) h;
+  handler->tx_srate = round(srate);
+  return handler->tx_srate;
+}
+
+double rf_shm_set_rx_gain(void *h, double gain)
+{
+  rf_shm_handler_t *handler = (rf_shm_handler_t*) h;
+  handler->rx_gain = gain;
+  return gain;
+}
+
+double rf_shm_set_tx_gain(void *h, double gain)
+{
+  rf_shm_handler_t *handler = (rf_shm_handler_t*) h;
+  handler->tx_gain = gain;
+  return gain;
+}
+
+double rf_shm_get_rx_gain(void *h)
+{
+  rf_shm_handler_t *handler = (rf_shm_handler_t*) h;
+  return handler->rx_gain;
+}
+
+double rf_shm_get_tx_gain(void *h)
+{
+  rf_shm_handler_t *handler = (rf_shm_handler_t*) h;
+  return handler->tx_gain;
+}
+
+srslte_rf_info_t *rf_shm_get_info(void *h)
+{
+  rf_shm_handler_t *handler = (rf_shm_handler_t*) h;
+  return &handler->info;
+}
+
+double rf_shm_set_rx_freq(void *h, double freq)
+{
+  rf_shm_handler_t *handler = (rf_shm_handler_t*) h;
+  handler->rx_freq = freq;
+  return freq;
+}
+
+double rf_shm_set_tx_freq(void *h, double freq)
+{
+  rf_shm_handler_t *handler = (rf_shm_handler_t*) h;
+  __atomic_store_n(&handler->tx_ctrl->freq, (uint64_t) llround(freq), __ATOMIC_RELEASE);
+  return freq;
+}
+
+void rf_shm_get_time(void *h, time_t *secs, double *frac_secs)
+{
+  rf_shm_handler_t *handler = (rf_shm_handler_t*) h;
+  uint64_t ns = now_ns(handler);
+  if (secs) {
+    *secs = ns / 1000000000ULL;
+  }
+  if (frac_secs) {
+    *frac_secs = (ns % 1000000000ULL) * 1e-9;
+  }
+}
+
+int rf_shm_recv_with_time(void *h, void *data, uint32_t nsamples, bool blocking, time_t *secs, double *frac_secs)
+{
+  void *_data[SRSLTE_MAX_PORTS] = {data, NULL, NULL, NULL};
+  return rf_shm_recv_with_time_multi(h, _data, nsamples, blocking, secs, frac_secs);
+}
+
+static void apply_impairments(rf_shm_handler_t *handler, cf_t *buffer, uint32_t nsamples)
+{
+  if (handler->imp_gain != 1.0) {
+    srslte_vec_sc_prod_cfc(buffer, handler->imp_gain, buffer, nsamples);
+  }
+  if (handler->imp_cfo_hz != 0) {
+    // Phase follows the absolute time so that it is continuous between calls
+    double t0    = (double) handler->rx_pos / handler->rx_srate;
+    double phase = fmod(2 * M_PI * handler->imp_cfo_hz * t0, 2 * M_PI);
+    cf_t   rot   = cexpf(_Complex_I * phase);
+    cf_t   step  = cexpf(_Complex_I * 2 * M_PI * handler->imp_cfo_hz / handler->rx_srate);
+    for (uint32_t i = 0; i < nsamples; i++) {
+      buffer[i] *= rot;
+      rot       *= step;
+    }
+  }
+  if (handler->imp_noise_std >= 0) {
+    srslte_ch_awgn_c(buffer, buffer, handler->imp_noise_std, nsamples);
+  }
+}
+
+int rf_shm_recv_with_time_multi(void *h, void **data, uint32_t nsamples, bool blocking, time_t *secs, double *frac_secs)
+{
+  rf_shm_handler_t *handler = (rf_shm_handler_t*) h;
+  if (handler->rx_srate <= 0) {
+    return -1;
+  }
+  if (!handler->streaming) {
+    rf_shm_start_rx_stream(h, true);
+  }
+
+  shm_ring_ctrl_t *ctrl = handler->rx_ctrl;
+  double ring_srate = SRSLTE_MAX(handler->rx_srate, (double) __atomic_load_n(&ctrl->srate, __ATOMIC_RELAXED));
+  uint64_t end_ns = (uint64_t) ((handler->rx_pos + nsamples) * 1e9 / handler->rx_srate);
+  uint64_t cur_ns = now_ns(handler);
+  if (cur_ns > end_ns + (uint64_t) (handler->ring_len / 2 * 1e9 / ring_srate)) {
+    // Too far behind, samples the peer wrote have been overwritten
+    report_error(handler, SRSLTE_RF_ERROR_OVERFLOW, 1);
+    handler->rx_pos = (uint64_t) (cur_ns * 1e-9 * handler->rx_srate);
+    end_ns = (uint64_t) ((handler->rx_pos + nsamples) * 1e9 / handler->rx_srate);
+  }
+
+  // Samples are returned once their time has passed, as from a radio
+  if (end_ns > cur_ns) {
+    uint64_t abs_ns = handler->header->epoch_ns + end_ns;
+    struct timespec ts;
+    ts.tv_sec  = abs_ns / 1000000000ULL;
+    ts.tv_nsec = abs_ns % 1000000000ULL;
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR);
+  }
+
+  uint64_t wsrate = __atomic_load_n(&ctrl->srate, __ATOMIC_ACQUIRE);
+  uint64_t head   = __atomic_load_n(&ctrl->head, __ATOMIC_ACQUIRE);
+  uint64_t tail   = __atomic_load_n(&ctrl->tail, __ATOMIC_RELAXED);
+  uint64_t wfreq  = __atomic_load_n(&ctrl->freq, __ATOMIC_ACQUIRE);
+
+  // Nothing is received from a peer tuned elsewhere or at a rate that is not a multiple of ours
+  uint32_t decim = wsrate > 0 ? (uint32_t) (wsrate / (uint64_t) handler->rx_srate) : 0;
+  bool connected = decim > 0 && decim * (uint64_t) handler->rx_srate == wsrate && head > 0 &&
+                   (wfreq == 0 || handler->rx_freq == 0 || fabs((double) wfreq - handler->rx_freq) < 1e3);
+
+  uint64_t delay = (uint64_t) llround(handler->imp_delay_sec * wsrate);
+  uint64_t w0    = handler->rx_pos * decim;
+  uint64_t mask  = handler->ring_len - 1;
+  for (uint32_t i = 0; i < handler->nof_channels; i++) {
+    cf_t *out = (cf_t*) data[i];
+    if (!out) {
+      continue;
+    }
+    for (uint32_t j = 0; j < nsamples; j++) {
+      uint64_t w = w0 + (uint64_t) j * decim;
+      if (!connected || w < delay + tail || w - delay + decim > head || w - delay + handler->ring_len < head) {
+        out[j] = 0;
+      } else if (decim == 1) {
+        out[j] = handler->rx_ring[i][(w - delay) & mask];
+      } else {
+        // Average before decimating, a crude anti-aliasing filter good enough for cell search
+        cf_t acc = 0;
+        for (uint32_t k = 0; k < decim; k++) {
+          acc += handler->rx_ring[i][(w - delay + k) & mask];
+        }
+        out[j] = acc / decim;
+      }
+    }
+    apply_impairments(handler, out, nsamples);
+  }
+  __atomic_store_n(&ctrl->read_ns, end_ns, __ATOMIC_RELEASE);
+
+  uint64_t srate_int = (uint64_t) handler->rx_srate;
+  if (secs) {
+    *secs = handler->rx_pos / srate_int;
+  }
+  if (frac_secs) {
+    *frac_secs = (double) (handler->rx_pos % srate_int) / handler->rx_srate;
+  }
+  handler->rx_pos += nsamples;
+  return nsamples;
+}
+
+int rf_shm_send_timed(void *h, void *data, int nsamples, time_t secs, double frac_secs, bool has_time_spec,
+                      bool blocking, bool is_start_of_burst, bool is_end_of_burst)
+{
+  void *_data[4] = {data, NULL, NULL, NULL};
+  return rf_shm_send_timed_multi(h, _data, nsamples, secs, frac_secs, has_time_spec, blocking, is_start_of_burst, is_end_of_burst);
+}
+
+int rf_shm_send_timed_multi(void *h, void *data[4], int nsamples, time_t secs, double frac_secs, bool has_time_spec,
+                            bool blocking, bool is_start_of_burst, bool is_end_of_burst)
+{
+  rf_shm_handler_t *handler = (rf_shm_handler_t*) h;
+  shm_ring_ctrl_t  *ctrl    = handler->tx_ctrl;
+  if (nsamples <= 0) {
+    return 0;
+  }
+  if (handler->tx_srate <= 0) {
+    return -1;
+  }
+
+  uint64_t srate = (uint64_t) handler->tx_srate;
+  uint64_t idx;
+  if (has_time_spec) {
+    idx = (uint64_t) secs * srate + (uint64_t) llround(frac_secs * handler->tx_srate);
+  } else {
+    idx = (uint64_t) (now_ns(handler) * 1e-9 * handler->tx_srate);
+  }
+
+  uint64_t head = __atomic_load_n(&ctrl->head, __ATOMIC_RELAXED);
+  if (__atomic_load_n(&ctrl->srate, __ATOMIC_RELAXED) != srate) {
+    // Samples at the old rate are meaningless, start over
+    __atomic_store_n(&ctrl->head, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&ctrl->srate, srate, __ATOMIC_RELEASE);
+    head = 0;
+  }
+  if (head == 0) {
+    __atomic_store_n(&ctrl->tail, idx, __ATOMIC_RELAXED);
+    head = idx;
+  }
+
+  // Samples the reader has already consumed are late
+  uint32_t first   = 0;
+  uint64_t read_ns = __atomic_load_n(&ctrl->read_ns, __ATOMIC_ACQUIRE);
+  uint64_t read    = (uint64_t) (read_ns * 1e-9 * handler->tx_srate);
+  if (idx < read && read - idx < handler->ring_len) {
+    report_error(handler, SRSLTE_RF_ERROR_LATE, 0);
+    if (idx + nsamples <= read) {
+      return nsamples;
+    }
+    first = read - idx;
+  }
+
+  // Everything between the previous burst and this one is silence
+  uint64_t mask  = handler->ring_len - 1;
+  uint64_t start = idx + first;
+  if (start > head) {
+    uint64_t fill_start = SRSLTE_MAX(head, start > handler->ring_len ? start - handler->ring_len : 0);
+    uint32_t pos = fill_start & mask;
+    uint32_t len = start - fill_start;
+    uint32_t n   = SRSLTE_MIN(len, handler->ring_len - pos);
+    for (uint32_t i = 0; i < handler->nof_channels; i++) {
+      bzero(&handler->tx_ring[i][pos], sizeof(cf_t) * n);
+      bzero(handler->tx_ring[i], sizeof(cf_t) * (len - n));
+    }
+  }
+  for (uint32_t i = 0; i < handler->nof_channels; i++) {
+    cf_t *in = (cf_t*) data[i];
+    for (uint32_t j = first; j < (uint32_t) nsamples; j++) {
+      handler->tx_ring[i][(idx + j) & mask] = in ? in[j] : 0;
+    }
+  }
+  if (idx + nsamples > head) {
+    __atomic_store_n(&ctrl->head, idx + nsamples, __ATOMIC_RELEASE);
+  }
+  return nsamples;
+}
@@ -63,6 +63,14 @@ typedef struct {
   pthread_t async_thread;
 
   pthread_mutex_t tx_mutex;
+
+  // Host sample format of the streamers, the other format is converted through the buffers below
+  bool   cpu_sc16;
+  size_t cpu_sample_size;
+  void  *rx_convert[SRSLTE_MAX_PORTS];
+  void  *tx_convert[SRSLTE_MAX_PORTS];
+  uint32_t rx_convert_len;
+  uint32_t tx_convert_len;
 } rf_uhd_handler_t;
 
 void suppress_handler(const char *x)
@@ -72,6 +80,35 @@ void suppress_handler(const char *x)
 
 static cf_t zero_mem[64*1024];
 
+/* Buffers hold nsamples of either format, cf_t being the larger one */
+static int convert_buffer_resize(void *buffer[SRSLTE_MAX_PORTS], uint32_t *len, uint32_t nsamples)
+{
+  if (nsamples > *len) {
+    for (int i=0;i<SRSLTE_MAX_PORTS;i++) {
+      if (buffer[i]) {
+        free(buffer[i]);
+      }
+      buffer[i] = srslte_vec_malloc(sizeof(cf_t)*nsamples);
+      if (!buffer[i]) {
+        *len = 0;
+        return -1;
+      }
+    }
+    *len = nsamples;
+  }
+  return 0;
+}
+
+static void convert_buffer_free(void *buffer[SRSLTE_MAX_PORTS])
+{
+  for (int i=0;i<SRSLTE_MAX_PORTS;i++) {
+    if (buffer[i]) {
+      free(buffer[i]);
+      buffer[i] = NULL;
+    }
+  }
+}
+
 static void log_overflow(rf_uhd_handler_t *h) {  
   if (h->uhd_error_handler) {
     srslte_rf_error_t error; 
@@ -381,6 +418,19 @@ int rf_uhd_open_multi(char *args, void **h, uint32_t nof_channels)
       return -1;
     }
 
+    // Set host sample format
+    handler->cpu_sc16 = false;
+    if (strstr(args, "cpu_format=sc16")) {
+      REMOVE_SUBSTRING_WITHCOMAS(args, "cpu_format=sc16");
+      handler->cpu_sc16 = true;
+    } else if (strstr(args, "cpu_format=fc32")) {
+      REMOVE_SUBSTRING_WITHCOMAS(args, "cpu_format=fc32");
+    } else if (strstr(args, "cpu_format=")) {
+      fprintf(stderr, "Wrong host sample format. Valid formats: fc32, sc16\n");
+      return -1;
+    }
+    handler->cpu_sample_size = handler->cpu_sc16 ? sizeof(c16_t) : sizeof(cf_t);
+
     // Set transmitter subdevice spec string
     const char tx_subdev_arg[] = "tx_subdev_spec=";
     char tx_subdev_str[64] = {0};
@@ -517,7 +567,7 @@ int rf_uhd_open_multi(char *args, void **h, uint32_t nof_channels)
 
     size_t channel[4] = {0, 1, 2, 3};
     uhd_stream_args_t stream_args = {
-          .cpu_format = "fc32",
+          .cpu_format = handler->cpu_sc16 ? "sc16" : "fc32",
           .otw_format = otw_format,
           .args = "",
           .channel_list = channel,
@@ -617,6 +667,9 @@ int rf_uhd_close(void *h)
   uhd_rx_streamer_free(&handler->rx_stream);
   uhd_usrp_free(&handler->usrp);
 
+  convert_buffer_free(handler->rx_convert);
+  convert_buffer_free(handler->tx_convert);
+
   free(handler);
   
   /** Something else to close the USRP?? */
@@ -767,14 +820,14 @@ int rf_uhd_recv_with_time(void *h,
   return rf_uhd_recv_with_time_multi(h, &data, nsamples, blocking, secs, frac_secs);
 }
 
-int rf_uhd_recv_with_time_multi(void *h,
-                                void *data[SRSLTE_MAX_PORTS],
-                                uint32_t nsamples,
-                                bool blocking,
-                                time_t *secs,
-                                double *frac_secs) 
+/* Receives in the host format of the streamer */
+static int recv_samples(rf_uhd_handler_t *handler,
+                    void *data[SRSLTE_MAX_PORTS],
+                    uint32_t nsamples,
+                    bool blocking,
+                    time_t *secs,
+                    double *frac_secs) 
 {
-  rf_uhd_handler_t *handler = (rf_uhd_handler_t*) h;
   uhd_rx_metadata_handle *md = &handler->rx_md_first; 
   size_t rxd_samples = 0;
   size_t rxd_samples_total = 0;
@@ -783,8 +836,8 @@ int rf_uhd_recv_with_time_multi(void *h,
     while (rxd_samples_total < nsamples && trials < 100) {
       void *buffs_ptr[4]; 
       for (int i=0;i<handler->nof_rx_channels;i++) {
-        cf_t *data_c = (cf_t*) data[i];
-        buffs_ptr[i] = &data_c[rxd_samples_total];
+        uint8_t *data_c = (uint8_t*) data[i];
+        buffs_ptr[i] = &data_c[rxd_samples_total*handler->cpu_sample_size];
       }
 
       size_t num_samps_left = nsamples - rxd_samples_total;
@@ -831,6 +884,50 @@ int rf_uhd_recv_with_time_multi(void *h,
   }
   return rxd_samples_total;
 }
+
+int rf_uhd_recv_with_time_multi(void *h,
+                                void *data[SRSLTE_MAX_PORTS],
+                                uint32_t nsamples,
+                                bool blocking,
+                                time_t *secs,
+                                double *frac_secs) 
+{
+  rf_uhd_handler_t *handler = (rf_uhd_handler_t*) h;
+  if (!handler->cpu_sc16) {
+    return recv_samples(handler, data, nsamples, blocking, secs, frac_secs);
+  }
+  if (convert_buffer_resize(handler->rx_convert, &handler->rx_convert_len, nsamples)) {
+    fprintf(stderr, "Error allocating UHD conversion buffer\n");
+    return -1;
+  }
+  int n = recv_samples(handler, handler->rx_convert, nsamples, blocking, secs, frac_secs);
+  for (int i=0;i<handler->nof_rx_channels && n > 0;i++) {
+    srslte_vec_convert_if(handler->rx_convert[i], SRSLTE_RF_C16_SCALE, data[i], 2*n);
+  }
+  return n;
+}
+
+int rf_uhd_recv_with_time_multi_c16(void *h,
+                                    void **data,
+                                    uint32_t nsamples,
+                                    bool blocking,
+                                    time_t *secs,
+                                    double *frac_secs) 
+{
+  rf_uhd_handler_t *handler = (rf_uhd_handler_t*) h;
+  if (handler->cpu_sc16) {
+    return recv_samples(handler, data, nsamples, blocking, secs, frac_secs);
+  }
+  if (convert_buffer_resize(handler->rx_convert, &handler->rx_convert_len, nsamples)) {
+    fprintf(stderr, "Error allocating UHD conversion buffer\n");
+    return -1;
+  }
+  int n = recv_samples(handler, handler->rx_convert, nsamples, blocking, secs, frac_secs);
+  for (int i=0;i<handler->nof_rx_channels && n > 0;i++) {
+    srslte_vec_convert_fi(handler->rx_convert[i], SRSLTE_RF_C16_SCALE, data[i], 2*n);
+  }
+  return n;
+}
                    
 int rf_uhd_send_timed(void *h,
                      void *data,
@@ -847,19 +944,17 @@ int rf_uhd_send_timed(void *h,
   return rf_uhd_send_timed_multi(h, _data, nsamples, secs, frac_secs, has_time_spec, blocking, is_start_of_burst, is_end_of_burst);
 }
 
-int rf_uhd_send_timed_multi(void *h,
-                            void *data[4],
-                            int nsamples,
-                            time_t secs,
-                            double frac_secs,
-                            bool has_time_spec,
-                            bool blocking,
-                            bool is_start_of_burst,
-                            bool is_end_of_burst)
+/* Sends in the host format of the streamer, called with tx_mutex held */
+static int send_samples(rf_uhd_handler_t *handler,
+                    void *data[4],
+                    int nsamples,
+                    time_t secs,
+                    double frac_secs,
+                    bool has_time_spec,
+                    bool blocking,
+                    bool is_start_of_burst,
+                    bool is_end_of_burst)
 {
-  rf_uhd_handler_t* handler = (rf_uhd_handler_t*) h;
-
-  pthread_mutex_lock(&handler->tx_mutex);
   int ret = -1;
 
   /* Resets the USRP time FIXME: this might cause problems for burst transmissions */
@@ -875,9 +970,9 @@ int rf_uhd_send_timed_multi(void *h,
       uhd_tx_metadata_set_time_spec(&handler->tx_md, secs, frac_secs);
     }
     int n = 0;
-    cf_t *data_c[4];
+    uint8_t *data_c[4];
     for (int i = 0; i < 4; i++) {
-      data_c[i] = data[i] ? data[i] : zero_mem;
+      data_c[i] = data[i] ? (uint8_t*) data[i] : (uint8_t*) zero_mem;
     }
     do {
       size_t tx_samples = handler->tx_nof_samples;
@@ -899,14 +994,14 @@ int rf_uhd_send_timed_multi(void *h,
 
       const void *buffs_ptr[4];
       for (int i = 0; i < 4; i++) {
-        void *buff = (void*) &data_c[i][n];
+        void *buff = (void*) &data_c[i][n*handler->cpu_sample_size];
         buffs_ptr[i] = buff;
       }
       uhd_error error = uhd_tx_streamer_send(handler->tx_stream, buffs_ptr, 
                                              tx_samples, &handler->tx_md, 1.0, &txd_samples);
       if (error) {
         fprintf(stderr, "Error sending to UHD: %d\n", error);
-        goto unlock;
+        return -1;
       }
       // Increase time spec 
       uhd_tx_metadata_add_time_spec(&handler->tx_md, txd_samples/handler->tx_rate);
@@ -928,14 +1023,77 @@ int rf_uhd_send_timed_multi(void *h,
     uhd_error error = uhd_tx_streamer_send(handler->tx_stream, buffs_ptr, nsamples, &handler->tx_md, 0.0, &txd_samples);
     if (error) {
       fprintf(stderr, "Error sending to UHD: %d\n", error);
-      goto unlock;
+      return -1;
     }
 
     ret = txd_samples;
 
   }
+  return ret;
+}
+
+/* Converts data to the host format of the streamer when it differs from the caller's */
+static int send_samples_convert(rf_uhd_handler_t *handler,
+                            bool data_sc16,
+                            void *data[4],
+                            int nsamples,
+                            time_t secs,
+                            double frac_secs,
+                            bool has_time_spec,
+                            bool blocking,
+                            bool is_start_of_burst,
+                            bool is_end_of_burst)
+{
+  pthread_mutex_lock(&handler->tx_mutex);
+  int ret = -1;
+  void *buffer[4] = {data[0], data[1], data[2], data[3]};
+  if (data_sc16 != handler->cpu_sc16 && nsamples > 0) {
+    if (convert_buffer_resize(handler->tx_convert, &handler->tx_convert_len, nsamples)) {
+      fprintf(stderr, "Error allocating UHD conversion buffer\n");
+      goto unlock;
+    }
+    for (int i = 0; i < 4; i++) {
+      if (data[i]) {
+        buffer[i] = handler->tx_convert[i];
+        if (data_sc16) {
+          srslte_vec_convert_if(data[i], SRSLTE_RF_C16_SCALE, buffer[i], 2*nsamples);
+        } else {
+          srslte_vec_convert_fi(data[i], SRSLTE_RF_C16_SCALE, buffer[i], 2*nsamples);
+        }
+      }
+    }
+  }
+  ret = send_samples(handler, buffer, nsamples, secs, frac_secs, has_time_spec, blocking, is_start_of_burst, is_end_of_burst);
 unlock:
   pthread_mutex_unlock(&handler->tx_mutex);
   return ret;
 }
 
+int rf_uhd_send_timed_multi(void *h,
+                            void *data[4],
+                            int nsamples,
+                            time_t secs,
+                            double frac_secs,
+                            bool has_time_spec,
+                            bool blocking,
+                            bool is_start_of_burst,
+                            bool is_end_of_burst)
+{
+  return send_samples_convert((rf_uhd_handler_t*) h, false, data, nsamples, secs, frac_secs,
+                          has_time_spec, blocking, is_start_of_burst, is_end_of_burst);
+}
+
+int rf_uhd_send_timed_multi_c16(void *h,
+                                void *data[4],
+                                int nsamples,
+                                time_t secs,
+                                double frac_secs,
+                                bool has_time_spec,
+                                bool blocking,
+                                bool is_start_of_burst,
+                                bool is_end_of_burst)
+{
+  return send_samples_convert((rf_uhd_handler_t*) h, true, data, nsamples, secs, frac_secs,
+                          has_time_spec, blocking, is_start_of_burst, is_end_of_burst);
+}
+
@@ -101,6 +101,13 @@ SRSLTE_API int rf_uhd_recv_with_time_multi(void *h,
                                 time_t *secs,
                                 double *frac_secs); 
 
+SRSLTE_API int rf_uhd_recv_with_time_multi_c16(void *h,
+                                               void **data,
+                                               uint32_t nsamples,
+                                               bool blocking,
+                                               time_t *secs,
+                                               double *frac_secs);
+
 SRSLTE_API double rf_uhd_set_tx_srate(void *h, 
                                     double freq);
 
@@ -134,3 +141,13 @@ SRSLTE_API int rf_uhd_send_timed_multi(void *h,
                                        bool is_start_of_burst,
                                        bool is_end_of_burst);
 
+SRSLTE_API int rf_uhd_send_timed_multi_c16(void *h,
+                                           void *data[4],
+                                           int nsamples,
+                                           time_t secs,
+                                           double frac_secs,
+                                           bool has_time_spec,
+                                           bool blocking,
+                                           bool is_start_of_burst,
+                                           bool is_end_of_burst);
+
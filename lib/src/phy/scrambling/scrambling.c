@@ -31,6 +31,12 @@
 #include "srslte/phy/utils/bit.h"
 #include "srslte/phy/utils/vector.h"
 #include "srslte/phy/scrambling/scrambling.h"
+#include "srslte/phy/utils/cpu_features.h"
+#include "scrambling_avx2.h"
+
+#ifdef LV_HAVE_SSE
+#include <immintrin.h>
+#endif
 
 void srslte_scrambling_f(srslte_sequence_t *s, float *data) {
   srslte_scrambling_f_offset(s, data, 0, s->cur_len);
@@ -106,3 +112,90 @@ void srslte_scrambling_bytes(srslte_sequence_t *s, uint8_t *data, int len) {
     srslte_bit_pack_vector(tmp_bits, &data[len/8], len%8);
   }    
 }
+
+/* The kernels below take 32 bits of the sequence per step and expand them to lane masks
+ * (all ones where c(n)=1) by selecting one bit per lane. Each lane is then negated
+ * as (x ^ m) - m, or by flipping the sign bit for floats. */
+
+void srslte_scrambling_state_b(srslte_sequence_state_t *s, uint8_t *data, int len) {
+  srslte_sequence_state_apply_bits(s, data, data, len);
+}
+
+void srslte_scrambling_state_bytes(srslte_sequence_state_t *s, uint8_t *data, int len) {
+  srslte_sequence_state_apply_packed(s, data, data, len);
+}
+
+void srslte_scrambling_state_f(srslte_sequence_state_t *s, float *data, int len) {
+  int i = 0;
+#ifdef SRSLTE_HAVE_AVX2_KERNELS
+  if (srslte_cpu_isa() >= SRSLTE_CPU_ISA_AVX2) {
+    i = srslte_scrambling_state_f_avx2(s, data, len);
+  }
+#endif /* SRSLTE_HAVE_AVX2_KERNELS */
+#ifdef LV_HAVE_SSE
+  const __m128i bitsel = _mm_setr_epi32(1, 2, 4, 8);
+  for (;i+32<=len;i+=32) {
+    uint32_t c = srslte_sequence_state_next(s, 32);
+    for (int j=0;j<8;j++) {
+      __m128i m = _mm_set1_epi32((c >> (4*j)) & 0xf);
+      m = _mm_slli_epi32(_mm_cmpeq_epi32(_mm_and_si128(m, bitsel), bitsel), 31);
+      __m128 x = _mm_loadu_ps(&data[i+4*j]);
+      _mm_storeu_ps(&data[i+4*j], _mm_xor_ps(x, _mm_castsi128_ps(m)));
+    }
+  }
+#endif /* LV_HAVE_SSE */
+  if (i < len) {
+    srslte_sequence_state_apply_f(s, &data[i], &data[i], len - i);
+  }
+}
+
+void srslte_scrambling_state_s(srslte_sequence_state_t *s, short *data, int len) {
+  int i = 0;
+#ifdef SRSLTE_HAVE_AVX2_KERNELS
+  if (srslte_cpu_isa() >= SRSLTE_CPU_ISA_AVX2) {
+    i = srslte_scrambling_state_s_avx2(s, data, len);
+  }
+#endif /* SRSLTE_HAVE_AVX2_KERNELS */
+#ifdef LV_HAVE_SSE
+  const __m128i bitsel = _mm_setr_epi16(1, 2, 4, 8, 16, 32, 64, 128);
+  for (;i+32<=len;i+=32) {
+    uint32_t c = srslte_sequence_state_next(s, 32);
+    for (int j=0;j<4;j++) {
+      __m128i m = _mm_set1_epi16((short) ((c >> (8*j)) & 0xff));
+      m = _mm_cmpeq_epi16(_mm_and_si128(m, bitsel), bitsel);
+      __m128i x = _mm_loadu_si128((__m128i*) &data[i+8*j]);
+      _mm_storeu_si128((__m128i*) &data[i+8*j], _mm_sub_epi16(_mm_xor_si128(x, m), m));
+    }
+  }
+#endif /* LV_HAVE_SSE */
+  if (i < len) {
+    srslte_sequence_state_apply_s(s, &data[i], &data[i], len - i);
+  }
+}
+
+void srslte_scrambling_state_sb(srslte_sequence_state_t *s, int8_t *data, int len) {
+  int i = 0;
+#ifdef SRSLTE_HAVE_AVX2_KERNELS
+  if (srslte_cpu_isa() >= SRSLTE_CPU_ISA_AVX2) {
+    i = srslte_scrambling_state_sb_avx2(s, data, len);
+  }
+#endif /* SRSLTE_HAVE_AVX2_KERNELS */
+#ifdef LV_HAVE_SSE
+  const __m128i bytesel_lo = _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1);
+  const __m128i bytesel_hi = _mm_setr_epi8(2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+  const __m128i bitsel     = _mm_set1_epi64x(0x8040201008040201LL);
+  for (;i+32<=len;i+=32) {
+    uint32_t c = srslte_sequence_state_next(s, 32);
+    __m128i w  = _mm_set1_epi32((int) c);
+    __m128i m0 = _mm_cmpeq_epi8(_mm_and_si128(_mm_shuffle_epi8(w, bytesel_lo), bitsel), bitsel);
+    __m128i m1 = _mm_cmpeq_epi8(_mm_and_si128(_mm_shuffle_epi8(w, bytesel_hi), bitsel), bitsel);
+    __m128i x0 = _mm_loadu_si128((__m128i*) &data[i]);
+    __m128i x1 = _mm_loadu_si128((__m128i*) &data[i+16]);
+    _mm_storeu_si128((__m128i*) &data[i],    _mm_sub_epi8(_mm_xor_si128(x0, m0), m0));
+    _mm_storeu_si128((__m128i*) &data[i+16], _mm_sub_epi8(_mm_xor_si128(x1, m1), m1));
+  }
+#endif /* LV_HAVE_SSE */
+  if (i < len) {
+    srslte_sequence_state_apply_sb(s, &data[i], &data[i], len - i);
+  }
+}
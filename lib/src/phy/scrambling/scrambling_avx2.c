@@ -0,0 +1,83 @@
+/**
+ *
+ * \section COPYRIGHT
+ *
+ * Copyright 2013-2015 Software Radio Systems Limited
+ *
+ * \section LICENSE
+ *
+ * This file is part of the srsLTE library.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+
+#include <stdint.h>
+
+#include "scrambling_avx2.h"
+
+#ifdef LV_HAVE_AVX2
+
+#include <immintrin.h>
+
+int srslte_scrambling_state_f_avx2(srslte_sequence_state_t *s, float *data, int len) {
+  int i = 0;
+  const __m256i bitsel = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+  for (;i+32<=len;i+=32) {
+    uint32_t c = srslte_sequence_state_next(s, 32);
+    for (int j=0;j<4;j++) {
+      __m256i m = _mm256_set1_epi32((c >> (8*j)) & 0xff);
+      m = _mm256_slli_epi32(_mm256_cmpeq_epi32(_mm256_and_si256(m, bitsel), bitsel), 31);
+      __m256 x = _mm256_loadu_ps(&data[i+8*j]);
+      _mm256_storeu_ps(&data[i+8*j], _mm256_xor_ps(x, _mm256_castsi256_ps(m)));
+    }
+  }
+  return i;
+}
+
+int srslte_scrambling_state_s_avx2(srslte_sequence_state_t *s, short *data, int len) {
+  int i = 0;
+  const __m256i bitsel = _mm256_setr_epi16(0x0001, 0x0002, 0x0004, 0x0008, 0x0010, 0x0020, 0x0040, 0x0080,
+                                           0x0100, 0x0200, 0x0400, 0x0800, 0x1000, 0x2000, 0x4000, (short) 0x8000);
+  for (;i+32<=len;i+=32) {
+    uint32_t c = srslte_sequence_state_next(s, 32);
+    for (int j=0;j<2;j++) {
+      __m256i m = _mm256_set1_epi16((short) (c >> (16*j)));
+      m = _mm256_cmpeq_epi16(_mm256_and_si256(m, bitsel), bitsel);
+      __m256i x = _mm256_loadu_si256((__m256i*) &data[i+16*j]);
+      _mm256_storeu_si256((__m256i*) &data[i+16*j], _mm256_sub_epi16(_mm256_xor_si256(x, m), m));
+    }
+  }
+  return i;
+}
+
+int srslte_scrambling_state_sb_avx2(srslte_sequence_state_t *s, int8_t *data, int len) {
+  int i = 0;
+  // Lane k takes byte k/8 of the word and bit k%8 of that byte
+  const __m256i bytesel = _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+                                           2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+  const __m256i bitsel  = _mm256_set1_epi64x(0x8040201008040201LL);
+  for (;i+32<=len;i+=32) {
+    uint32_t c = srslte_sequence_state_next(s, 32);
+    __m256i m = _mm256_shuffle_epi8(_mm256_set1_epi32((int) c), bytesel);
+    m = _mm256_cmpeq_epi8(_mm256_and_si256(m, bitsel), bitsel);
+    __m256i x = _mm256_loadu_si256((__m256i*) &data[i]);
+    _mm256_storeu_si256((__m256i*) &data[i], _mm256_sub_epi8(_mm256_xor_si256(x, m), m));
+  }
+  return i;
+}
+
+#endif /* LV_HAVE_AVX2 */
@@ -0,0 +1,48 @@
+/**
+ *
+ * \section COPYRIGHT
+ *
+ * Copyright 2013-2015 Software Radio Systems Limited
+ *
+ * \section LICENSE
+ *
+ * This file is part of the srsLTE library.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+
+/*
+ * AVX2 versions of the sequence state scrambling kernels. scrambling_avx2.c is built with
+ * AVX2 enabled, also when the baseline is SSE, and scrambling.c calls it when
+ * srslte_cpu_isa() reports AVX2. Each kernel does whole words of 32 bits and returns how
+ * many samples it processed.
+ */
+
+#ifndef SRSLTE_SCRAMBLING_AVX2_H
+#define SRSLTE_SCRAMBLING_AVX2_H
+
+#include <stdint.h>
+
+#include "srslte/phy/common/sequence.h"
+
+int srslte_scrambling_state_f_avx2(srslte_sequence_state_t *s, float *data, int len);
+
+int srslte_scrambling_state_s_avx2(srslte_sequence_state_t *s, short *data, int len);
+
+int srslte_scrambling_state_sb_avx2(srslte_sequence_state_t *s, int8_t *data, int len);
+
+#endif // SRSLTE_SCRAMBLING_AVX2_H
@@ -40,6 +40,7 @@ bool do_floats = false;
 srslte_cp_t cp = SRSLTE_CP_NORM;
 int cell_id = -1;
 int nof_bits = 100; 
+uint32_t c_init = 0;
 
 void usage(char *prog) {
   printf("Usage: %s [ef] -c cell_id -s [PBCH, PDSCH, PDCCH, PMCH, PUCCH]\n", prog);
@@ -85,9 +86,11 @@ void parse_args(int argc, char **argv) {
 int init_sequence(srslte_sequence_t *seq, char *name) {
   if (!strcmp(name, "PBCH")) {
     bzero(seq, sizeof(srslte_sequence_t));
+    c_init = cell_id;
     return srslte_sequence_pbch(seq, cp, cell_id);
   } else if (!strcmp(name, "PDSCH")) {
     bzero(seq, sizeof(srslte_sequence_t));
+    c_init = srslte_sequence_pdsch_c_init(1234, 0, 0, cell_id);
     return srslte_sequence_pdsch(seq, 1234, 0, 0, cell_id, nof_bits);
   } else {
     fprintf(stderr, "Unsupported sequence name %s\n", name);
@@ -95,6 +98,88 @@ int init_sequence(srslte_sequence_t *seq, char *name) {
   }
 }
 
+/* Compares scrambling with the sequence generated on the fly against the stored sequence */
+int test_on_the_fly(srslte_sequence_t *seq) {
+  srslte_sequence_state_t s;
+  struct timeval t[3];
+  int len = seq->cur_len;
+  int ret = -1;
+
+  float   *f  = srslte_vec_malloc(sizeof(float) * len);
+  float   *f2 = srslte_vec_malloc(sizeof(float) * len);
+  int16_t *s1 = srslte_vec_malloc(sizeof(int16_t) * len);
+  int16_t *s2 = srslte_vec_malloc(sizeof(int16_t) * len);
+  int8_t  *b1 = srslte_vec_malloc(sizeof(int8_t) * len);
+  int8_t  *b2 = srslte_vec_malloc(sizeof(int8_t) * len);
+  uint8_t *u1 = srslte_vec_malloc(sizeof(uint8_t) * len);
+  uint8_t *u2 = srslte_vec_malloc(sizeof(uint8_t) * len);
+  if (!f || !f2 || !s1 || !s2 || !b1 || !b2 || !u1 || !u2) {
+    perror("malloc");
+    exit(-1);
+  }
+
+  for (int i=0;i<len;i++) {
+    f[i]  = f2[i] = (float) (rand()%200 - 100);
+    s1[i] = s2[i] = (int16_t) (rand()%200 - 100);
+    b1[i] = b2[i] = (int8_t) (rand()%200 - 100);
+    u1[i] = u2[i] = (uint8_t) (rand()%256);
+  }
+
+  srslte_scrambling_f_offset(seq, f, 0, len);
+  srslte_scrambling_s_offset(seq, s1, 0, len);
+  srslte_scrambling_sb_offset(seq, b1, 0, len);
+  srslte_scrambling_bytes(seq, u1, len);
+
+  srslte_sequence_state_init(&s, c_init);
+  srslte_scrambling_state_f(&s, f2, len);
+  srslte_sequence_state_init(&s, c_init);
+  gettimeofday(&t[1], NULL);
+  srslte_scrambling_state_s(&s, s2, len);
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+  printf("Texec on-the-fly short=%ld us for %d bits\n", t[0].tv_usec, len);
+  srslte_sequence_state_init(&s, c_init);
+  srslte_scrambling_state_sb(&s, b2, len);
+  srslte_sequence_state_init(&s, c_init);
+  srslte_scrambling_state_bytes(&s, u2, len);
+
+  // Only the first len%8 bits of the last byte are scrambled
+  if (len%8) {
+    u1[len/8] &= (uint8_t) (0xff << (8 - len%8));
+    u2[len/8] &= (uint8_t) (0xff << (8 - len%8));
+  }
+  if (memcmp(f, f2, sizeof(float)*len) || memcmp(s1, s2, sizeof(int16_t)*len) ||
+      memcmp(b1, b2, sizeof(int8_t)*len) || memcmp(u1, u2, (len+7)/8))
+  {
+    printf("Error in on-the-fly scrambling\n");
+    goto clean_exit;
+  }
+
+  // Bits, in two halves
+  for (int i=0;i<len;i++) {
+    u1[i] = u2[i] = (uint8_t) (rand()%2);
+  }
+  srslte_scrambling_b_offset(seq, u1, 0, len);
+  srslte_sequence_state_init(&s, c_init);
+  srslte_scrambling_state_b(&s, u2, len/2);
+  srslte_scrambling_state_b(&s, &u2[len/2], len - len/2);
+  if (memcmp(u1, u2, len)) {
+    printf("Error in on-the-fly bit scrambling\n");
+    goto clean_exit;
+  }
+  ret = 0;
+
+clean_exit:
+  free(f);
+  free(f2);
+  free(s1);
+  free(s2);
+  free(b1);
+  free(b2);
+  free(u1);
+  free(u2);
+  return ret;
+}
 
 int main(int argc, char **argv) {
   int i;
@@ -255,6 +340,9 @@ int main(int argc, char **argv) {
     free(input_b);
     free(scrambled_b);
   }
+  if (test_on_the_fly(&seq)) {
+    exit(-1);
+  }
   printf("Ok\n");
   srslte_sequence_free(&seq);
   exit(0);
@@ -342,6 +342,12 @@ void srslte_ue_dl_set_power_alloc(srslte_ue_dl_t *q, float rho_a, float rho_b) {
   }
 }
 
+void srslte_ue_dl_set_mimo_decoder(srslte_ue_dl_t *q, srslte_mimo_decoder_t mimo_decoder) {
+  if (q) {
+    srslte_pdsch_set_mimo_decoder(&q->pdsch, mimo_decoder);
+  }
+}
+
 void srslte_ue_dl_reset(srslte_ue_dl_t *q) {
   for(int i = 0; i < SRSLTE_MAX_CODEWORDS; i++){
     srslte_softbuffer_rx_reset(q->softbuffers[i]);
@@ -0,0 +1,179 @@
+/**
+ *
+ * \section COPYRIGHT
+ *
+ * Copyright 2013-2015 Software Radio Systems Limited
+ *
+ * \section LICENSE
+ *
+ * This file is part of the srsLTE library.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <strings.h>
+
+#include "srslte/phy/utils/cpu_features.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#define CPU_IS_X86
+#endif
+
+#define NOF_CPU_ISA (SRSLTE_CPU_ISA_AVX512 + 1)
+
+static const char *cpu_isa_names[NOF_CPU_ISA] = {"generic", "NEON", "SSE", "AVX2", "AVX512"};
+
+static pthread_once_t   cpu_probe_once = PTHREAD_ONCE_INIT;
+static srslte_cpu_isa_t cpu_detected   = SRSLTE_CPU_ISA_GENERIC;
+static srslte_cpu_isa_t cpu_selected   = SRSLTE_CPU_ISA_GENERIC;
+
+srslte_cpu_isa_t srslte_cpu_isa_baseline() {
+#if defined(LV_HAVE_AVX512)
+  return SRSLTE_CPU_ISA_AVX512;
+#elif defined(LV_HAVE_AVX2)
+  return SRSLTE_CPU_ISA_AVX2;
+#elif defined(LV_HAVE_SSE)
+  return SRSLTE_CPU_ISA_SSE;
+#elif defined(HAVE_NEON)
+  return SRSLTE_CPU_ISA_NEON;
+#else
+  return SRSLTE_CPU_ISA_GENERIC;
+#endif
+}
+
+/* Best instruction set there are kernels for */
+static srslte_cpu_isa_t cpu_isa_built() {
+#if defined(SRSLTE_DISPATCH_AVX512)
+  return SRSLTE_CPU_ISA_AVX512;
+#elif defined(SRSLTE_DISPATCH_AVX2)
+  return SRSLTE_CPU_ISA_AVX2;
+#else
+  return srslte_cpu_isa_baseline();
+#endif
+}
+
+#ifdef CPU_IS_X86
+
+static uint64_t cpu_xgetbv() {
+  uint32_t eax, edx;
+  __asm__ volatile ("xgetbv" : "=a" (eax), "=d" (edx) : "c" (0));
+  return ((uint64_t) edx << 32) | eax;
+}
+
+static srslte_cpu_isa_t cpu_probe_x86() {
+  uint32_t eax, ebx, ecx, edx;
+
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & (1 << 19))) {
+    return SRSLTE_CPU_ISA_GENERIC;
+  }
+  bool fma     = (ecx & (1 << 12)) != 0;
+  bool osxsave = (ecx & (1 << 27)) != 0;
+
+  // The OS must save the YMM (and ZMM) registers on context switches
+  uint64_t xcr0 = osxsave ? cpu_xgetbv() : 0;
+  bool os_ymm = (xcr0 & 0x06) == 0x06;
+  bool os_zmm = (xcr0 & 0xe6) == 0xe6;
+
+  if (__get_cpuid_max(0, NULL) < 7) {
+    return SRSLTE_CPU_ISA_SSE;
+  }
+  __cpuid_count(7, 0, eax, ebx, ecx, edx);
+  bool avx2   = (ebx & (1 << 5)) != 0;
+  bool avx512 = (ebx & (1 << 16)) && (ebx & (1 << 17)) && (ebx & (1 << 28)) && (ebx & (1u << 30));
+
+  if (avx2 && fma && os_ymm) {
+    if (avx512 && os_zmm) {
+      return SRSLTE_CPU_ISA_AVX512;
+    }
+    return SRSLTE_CPU_ISA_AVX2;
+  }
+  return SRSLTE_CPU_ISA_SSE;
+}
+
+#endif /* CPU_IS_X86 */
+
+static void cpu_probe() {
+  srslte_cpu_isa_t baseline = srslte_cpu_isa_baseline();
+
+#ifdef CPU_IS_X86
+  cpu_detected = cpu_probe_x86();
+#else
+  // NEON is a build option, it is not probed
+  cpu_detected = baseline;
+#endif /* CPU_IS_X86 */
+
+  srslte_cpu_isa_t isa = cpu_detected < cpu_isa_built() ? cpu_detected : cpu_isa_built();
+
+  char *env = getenv("SRSLTE_CPU_ISA");
+  if (env && env[0]) {
+    int i = 0;
+    while (i < NOF_CPU_ISA && strcasecmp(env, cpu_isa_names[i])) {
+      i++;
+    }
+    if (i < NOF_CPU_ISA) {
+      if (i < isa) {
+        isa = (srslte_cpu_isa_t) i;
+      }
+    } else {
+      fprintf(stderr, "Ignoring unknown SRSLTE_CPU_ISA=%s\n", env);
+    }
+  }
+
+  // The baseline kernels are always in use
+  if (isa < baseline) {
+    isa = baseline;
+  }
+  if (cpu_detected < baseline) {
+    fprintf(stderr, "Warning: srsLTE was built for %s but this CPU only supports %s\n",
+            cpu_isa_names[baseline], cpu_isa_names[cpu_detected]);
+  }
+  cpu_selected = isa;
+}
+
+srslte_cpu_isa_t srslte_cpu_isa() {
+  pthread_once(&cpu_probe_once, cpu_probe);
+  return cpu_selected;
+}
+
+srslte_cpu_isa_t srslte_cpu_isa_detected() {
+  pthread_once(&cpu_probe_once, cpu_probe);
+  return cpu_detected;
+}
+
+const char* srslte_cpu_isa_string(srslte_cpu_isa_t isa) {
+  if (isa < NOF_CPU_ISA) {
+    return cpu_isa_names[isa];
+  }
+  return "unknown";
+}
+
+int srslte_cpu_isa_info(char *str, uint32_t max_len) {
+  srslte_cpu_isa_t baseline = srslte_cpu_isa_baseline();
+  srslte_cpu_isa_t built    = cpu_isa_built();
+
+  char variants[32] = "";
+  if (built > baseline) {
+    snprintf(variants, sizeof(variants), ", run-time up to %s", cpu_isa_names[built]);
+  }
+  return snprintf(str, max_len, "Using %s kernels (CPU supports %s, built for %s%s)",
+                  srslte_cpu_isa_string(srslte_cpu_isa()), srslte_cpu_isa_string(srslte_cpu_isa_detected()),
+                  cpu_isa_names[baseline], variants);
+}
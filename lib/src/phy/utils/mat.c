@@ -126,6 +126,76 @@ inline float srslte_mat_2x2_cn(cf_t h00, cf_t h01, cf_t h10, cf_t h11) {
   return 10 * log10f(xmax / xmin);
 }
 
+/* Generic implementation for Minimum Mean Squared Error (MMSE) NxM solver */
+void srslte_mat_mimo_mmse_csi_gen(cf_t y[SRSLTE_MAT_MAX_DIM],
+                                  cf_t h[SRSLTE_MAT_MAX_DIM][SRSLTE_MAT_MAX_DIM],
+                                  uint32_t nof_rxant,
+                                  uint32_t nof_layers,
+                                  cf_t x[SRSLTE_MAT_MAX_DIM],
+                                  float csi[SRSLTE_MAT_MAX_DIM],
+                                  float noise_estimate) {
+  cf_t l[SRSLTE_MAT_MAX_DIM][SRSLTE_MAT_MAX_DIM];
+  cf_t e[SRSLTE_MAT_MAX_DIM][SRSLTE_MAT_MAX_DIM];
+  float d_rcp[SRSLTE_MAT_MAX_DIM];
+  cf_t z[SRSLTE_MAT_MAX_DIM];
+
+  /* 1. A = H' x H + No = L x D x L', column by column */
+  for (uint32_t j = 0; j < nof_layers; j++) {
+    float d = noise_estimate;
+    z[j] = 0;
+    for (uint32_t r = 0; r < nof_rxant; r++) {
+      d += crealf(h[r][j]) * crealf(h[r][j]) + cimagf(h[r][j]) * cimagf(h[r][j]);
+      z[j] += conjf(h[r][j]) * y[r];
+    }
+    for (uint32_t k = 0; k < j; k++) {
+      d -= crealf(e[j][k] * conjf(l[j][k]));
+    }
+    d_rcp[j] = 1.0f / d;
+
+    for (uint32_t i = j + 1; i < nof_layers; i++) {
+      cf_t a = 0;
+      for (uint32_t r = 0; r < nof_rxant; r++) {
+        a += conjf(h[r][i]) * h[r][j];
+      }
+      for (uint32_t k = 0; k < j; k++) {
+        a -= e[i][k] * conjf(l[j][k]);
+      }
+      e[i][j] = a;
+      l[i][j] = a * d_rcp[j];
+    }
+  }
+
+  /* 2. Solve L x D x L' x X = H' x Y */
+  for (uint32_t i = 0; i < nof_layers; i++) {
+    for (uint32_t k = 0; k < i; k++) {
+      z[i] -= l[i][k] * z[k];
+    }
+  }
+  for (int i = nof_layers - 1; i >= 0; i--) {
+    x[i] = z[i] * d_rcp[i];
+    for (uint32_t k = i + 1; k < nof_layers; k++) {
+      x[i] -= conjf(l[k][i]) * x[k];
+    }
+  }
+
+  /* 3. CSI is the inverse of the diagonal of inv(A) = inv(L') x inv(D) x inv(L) */
+  if (csi) {
+    for (uint32_t j = 0; j < nof_layers; j++) {
+      cf_t v[SRSLTE_MAT_MAX_DIM];
+      float b = d_rcp[j];
+      v[j] = 1.0f;
+      for (uint32_t i = j + 1; i < nof_layers; i++) {
+        v[i] = 0;
+        for (uint32_t k = j; k < i; k++) {
+          v[i] -= l[i][k] * v[k];
+        }
+        b += (crealf(v[i]) * crealf(v[i]) + cimagf(v[i]) * cimagf(v[i])) * d_rcp[i];
+      }
+      csi[j] = 1.0f / b;
+    }
+  }
+}
+
 #ifdef LV_HAVE_SSE
 #include <smmintrin.h>
 
@@ -115,3 +115,149 @@ void srslte_ringbuffer_stop(srslte_ringbuffer_t *q) {
   pthread_mutex_unlock(&q->mutex);
 }
 
+
+int srslte_ringbuffer_spsc_init(srslte_ringbuffer_spsc_t *q, int capacity)
+{
+  q->buffer = srslte_vec_malloc(capacity);
+  if (!q->buffer) {
+    return -1;
+  }
+  q->capacity = capacity;
+  q->active   = true;
+  srslte_ringbuffer_spsc_reset(q);
+  return 0;
+}
+
+void srslte_ringbuffer_spsc_free(srslte_ringbuffer_spsc_t *q)
+{
+  if (q) {
+    srslte_ringbuffer_spsc_stop(q);
+    if (q->buffer) {
+      free(q->buffer);
+      q->buffer = NULL;
+    }
+  }
+}
+
+void srslte_ringbuffer_spsc_reset(srslte_ringbuffer_spsc_t *q)
+{
+  q->wpos_staged = 0;
+  __atomic_store_n(&q->rpos, 0, __ATOMIC_RELEASE);
+  __atomic_store_n(&q->wpos, 0, __ATOMIC_RELEASE);
+}
+
+void srslte_ringbuffer_spsc_stop(srslte_ringbuffer_spsc_t *q)
+{
+  __atomic_store_n(&q->active, false, __ATOMIC_RELEASE);
+}
+
+int srslte_ringbuffer_spsc_status(srslte_ringbuffer_spsc_t *q)
+{
+  return (int) (__atomic_load_n(&q->wpos, __ATOMIC_ACQUIRE) - q->rpos);
+}
+
+int srslte_ringbuffer_spsc_space(srslte_ringbuffer_spsc_t *q)
+{
+  return (int) (q->capacity - (q->wpos_staged - __atomic_load_n(&q->rpos, __ATOMIC_ACQUIRE)));
+}
+
+int srslte_ringbuffer_spsc_write_reserve(srslte_ringbuffer_spsc_t *q, void **ptr, int nof_bytes)
+{
+  uint64_t idx  = q->wpos_staged % q->capacity;
+  int      len  = srslte_ringbuffer_spsc_space(q);
+  if (len > nof_bytes) {
+    len = nof_bytes;
+  }
+  if (len > (int) (q->capacity - idx)) {
+    len = (int) (q->capacity - idx);
+  }
+  *ptr = &q->buffer[idx];
+  return len;
+}
+
+void srslte_ringbuffer_spsc_write_advance(srslte_ringbuffer_spsc_t *q, int nof_bytes)
+{
+  q->wpos_staged += nof_bytes;
+}
+
+void srslte_ringbuffer_spsc_write_commit(srslte_ringbuffer_spsc_t *q)
+{
+  // Release orders the sample copies before the new position becomes visible to the consumer
+  __atomic_store_n(&q->wpos, q->wpos_staged, __ATOMIC_RELEASE);
+}
+
+void srslte_ringbuffer_spsc_write_cancel(srslte_ringbuffer_spsc_t *q)
+{
+  q->wpos_staged = q->wpos;
+}
+
+/* Stages nof_bytes without publishing them, all or nothing */
+int srslte_ringbuffer_spsc_write_staged(srslte_ringbuffer_spsc_t *q, void *p, int nof_bytes)
+{
+  uint8_t *ptr = (uint8_t*) p;
+  if (!__atomic_load_n(&q->active, __ATOMIC_ACQUIRE)) {
+    return 0;
+  }
+  if (srslte_ringbuffer_spsc_space(q) < nof_bytes) {
+    return 0;
+  }
+  int w_bytes = 0;
+  while (w_bytes < nof_bytes) {
+    void *dst;
+    int n = srslte_ringbuffer_spsc_write_reserve(q, &dst, nof_bytes - w_bytes);
+    memcpy(dst, &ptr[w_bytes], n);
+    srslte_ringbuffer_spsc_write_advance(q, n);
+    w_bytes += n;
+  }
+  return w_bytes;
+}
+
+int srslte_ringbuffer_spsc_write(srslte_ringbuffer_spsc_t *q, void *p, int nof_bytes)
+{
+  int w_bytes = srslte_ringbuffer_spsc_write_staged(q, p, nof_bytes);
+  if (w_bytes > 0) {
+    srslte_ringbuffer_spsc_write_commit(q);
+  }
+  return w_bytes;
+}
+
+int srslte_ringbuffer_spsc_read_peek(srslte_ringbuffer_spsc_t *q, void **ptr, int nof_bytes)
+{
+  uint64_t idx = q->rpos % q->capacity;
+  int      len = srslte_ringbuffer_spsc_status(q);
+  if (len > nof_bytes) {
+    len = nof_bytes;
+  }
+  if (len > (int) (q->capacity - idx)) {
+    len = (int) (q->capacity - idx);
+  }
+  *ptr = &q->buffer[idx];
+  return len;
+}
+
+void srslte_ringbuffer_spsc_read_advance(srslte_ringbuffer_spsc_t *q, int nof_bytes)
+{
+  // Release keeps the producer from overwriting the bytes before they have been read
+  __atomic_store_n(&q->rpos, q->rpos + nof_bytes, __ATOMIC_RELEASE);
+}
+
+/* Reads nof_bytes if they are all available, otherwise returns 0 without blocking */
+int srslte_ringbuffer_spsc_read(srslte_ringbuffer_spsc_t *q, void *p, int nof_bytes)
+{
+  uint8_t *ptr = (uint8_t*) p;
+  if (!__atomic_load_n(&q->active, __ATOMIC_ACQUIRE)) {
+    return 0;
+  }
+  if (srslte_ringbuffer_spsc_status(q) < nof_bytes) {
+    return 0;
+  }
+  int r_bytes = 0;
+  while (r_bytes < nof_bytes) {
+    void *src;
+    int n = srslte_ringbuffer_spsc_read_peek(q, &src, nof_bytes - r_bytes);
+    memcpy(&ptr[r_bytes], src, n);
+    srslte_ringbuffer_spsc_read_advance(q, n);
+    r_bytes += n;
+  }
+  return r_bytes;
+}
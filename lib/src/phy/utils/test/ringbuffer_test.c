@@ -0,0 +1,134 @@
+/**
+ *
+ * \section COPYRIGHT
+ *
+ * Copyright 2013-2015 Software Radio Systems Limited
+ *
+ * \section LICENSE
+ *
+ * This file is part of the srsLTE library.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "srslte/phy/utils/ringbuffer.h"
+
+/* Checks the single-producer/single-consumer ring with a producer and a consumer thread
+ * moving a counter sequence through it in blocks of varying size */
+
+#define CAPACITY   (4096 + 100)
+#define NOF_BYTES  (16*1024*1024)
+
+static srslte_ringbuffer_spsc_t ring;
+static int nof_errors = 0;
+
+static void *producer(void *arg)
+{
+  uint8_t block[1000];
+  uint32_t cnt = 0;
+  uint32_t len = 1;
+  while (cnt < NOF_BYTES) {
+    len = (len * 7 + 13) % sizeof(block) + 1;
+    if (len > NOF_BYTES - cnt) {
+      len = NOF_BYTES - cnt;
+    }
+    for (uint32_t i = 0; i < len; i++) {
+      block[i] = (uint8_t) (cnt + i);
+    }
+    // Every other block goes through the staged path and a cancelled dummy write
+    if (len % 2) {
+      while (srslte_ringbuffer_spsc_write(&ring, block, len) == 0) {
+        usleep(0);
+      }
+    } else {
+      while (srslte_ringbuffer_spsc_space(&ring) < (int) (len + 1)) {
+        usleep(0);
+      }
+      srslte_ringbuffer_spsc_write_staged(&ring, block, len);
+      srslte_ringbuffer_spsc_write_commit(&ring);
+      srslte_ringbuffer_spsc_write_staged(&ring, block, 1);
+      srslte_ringbuffer_spsc_write_cancel(&ring);
+    }
+    cnt += len;
+  }
+  return NULL;
+}
+
+static void *consumer(void *arg)
+{
+  uint8_t block[700];
+  uint32_t cnt = 0;
+  uint32_t len = 1;
+  while (cnt < NOF_BYTES) {
+    len = (len * 5 + 11) % sizeof(block) + 1;
+    if (len > NOF_BYTES - cnt) {
+      len = NOF_BYTES - cnt;
+    }
+    if (len % 3) {
+      while (srslte_ringbuffer_spsc_read(&ring, block, len) == 0) {
+        usleep(0);
+      }
+    } else {
+      // Zero-copy read
+      uint32_t n = 0;
+      while (n < len) {
+        void *ptr;
+        int r = srslte_ringbuffer_spsc_read_peek(&ring, &ptr, len - n);
+        memcpy(&block[n], ptr, r);
+        srslte_ringbuffer_spsc_read_advance(&ring, r);
+        n += r;
+      }
+    }
+    for (uint32_t i = 0; i < len; i++) {
+      if (block[i] != (uint8_t) (cnt + i)) {
+        nof_errors++;
+      }
+    }
+    cnt += len;
+  }
+  return NULL;
+}
+
+int main(int argc, char **argv)
+{
+  pthread_t tx, rx;
+
+  if (srslte_ringbuffer_spsc_init(&ring, CAPACITY)) {
+    fprintf(stderr, "Error initiating ring\n");
+    exit(-1);
+  }
+
+  pthread_create(&rx, NULL, consumer, NULL);
+  pthread_create(&tx, NULL, producer, NULL);
+  pthread_join(tx, NULL);
+  pthread_join(rx, NULL);
+
+  if (srslte_ringbuffer_spsc_status(&ring) != 0) {
+    printf("Ring not empty: %d bytes\n", srslte_ringbuffer_spsc_status(&ring));
+    nof_errors++;
+  }
+
+  srslte_ringbuffer_spsc_free(&ring);
+
+  printf("%d errors\n", nof_errors);
+  exit(nof_errors ? -1 : 0);
+}
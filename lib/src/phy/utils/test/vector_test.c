@@ -844,6 +844,10 @@ int main(int argc, char **argv) {
   uint32_t func_count = 0;
   bool passed[MAX_FUNCTIONS][MAX_BLOCKS];
   bool all_passed = true;
+  char isa_info[128];
+
+  srslte_cpu_isa_info(isa_info, sizeof(isa_info));
+  printf("%s\n", isa_info);
 
   for (uint32_t block_size = 1; block_size <= 1024*32; block_size *= 2) {
     func_count = 0;
@@ -33,33 +33,53 @@
 
 #include "srslte/phy/utils/vector.h"
 #include "srslte/phy/utils/vector_simd.h"
+#include "srslte/phy/utils/cpu_features.h"
 #include "srslte/phy/utils/bit.h"
 
+static const srslte_vec_simd_t *simd = &srslte_vec_simd_default;
+
+/* Selects the kernels once, before main() */
+__attribute__((constructor)) static void vec_simd_select() {
+  switch (srslte_cpu_isa()) {
+#ifdef SRSLTE_DISPATCH_AVX512
+    case SRSLTE_CPU_ISA_AVX512:
+      simd = &srslte_vec_simd_avx512;
+      break;
+#endif /* SRSLTE_DISPATCH_AVX512 */
+#ifdef SRSLTE_DISPATCH_AVX2
+    case SRSLTE_CPU_ISA_AVX2:
+      simd = &srslte_vec_simd_avx2;
+      break;
+#endif /* SRSLTE_DISPATCH_AVX2 */
+    default:
+      simd = &srslte_vec_simd_default;
+  }
+}
 
 
 void srslte_vec_xor_bbb(int8_t *x,int8_t *y,int8_t *z, const uint32_t len) {
-  srslte_vec_xor_bbb_simd(x, y, z, len);
+  simd->xor_bbb(x, y, z, len);
 }
 
 // Used in PRACH detector, AGC and chest_dl for noise averaging
 float srslte_vec_acc_ff(const float *x, const uint32_t len) {
-  return srslte_vec_acc_ff_simd(x, len);
+  return simd->acc_ff(x, len);
 }
 
 cf_t srslte_vec_acc_cc(const cf_t *x, const uint32_t len) {
-  return srslte_vec_acc_cc_simd(x, len);
+  return simd->acc_cc(x, len);
 }
 
 void srslte_vec_sub_fff(const float *x, const float *y, float *z, const uint32_t len) {
-  srslte_vec_sub_fff_simd(x, y, z, len);
+  simd->sub_fff(x, y, z, len);
 }
 
 void srslte_vec_sub_sss(const int16_t *x, const int16_t *y, int16_t *z, const uint32_t len) {
-  srslte_vec_sub_sss_simd(x, y, z, len);
+  simd->sub_sss(x, y, z, len);
 }
 
 void srslte_vec_sub_bbb(const int8_t *x, const int8_t *y, int8_t *z, const uint32_t len) {
-  srslte_vec_sub_bbb_simd(x, y, z, len);
+  simd->sub_bbb(x, y, z, len);
 }
 
 // Noise estimation in chest_dl, interpolation
@@ -69,11 +89,11 @@ void srslte_vec_sub_ccc(const cf_t *x, const cf_t *y, cf_t *z, const uint32_t le
 
 // Used in PSS/SSS and sum_ccc
 void srslte_vec_sum_fff(const float *x, const float *y, float *z, const uint32_t len) {
-  srslte_vec_add_fff_simd(x, y, z, len);
+  simd->add_fff(x, y, z, len);
 }
 
 void srslte_vec_sum_sss(const int16_t *x, const int16_t *y, int16_t *z, const uint32_t len) {
-  srslte_vec_sum_sss_simd(x, y, z, len);
+  simd->sum_sss(x, y, z, len);
 }
 
 void srslte_vec_sum_ccc(const cf_t *x, const cf_t *y, cf_t *z, const uint32_t len) {
@@ -82,38 +102,38 @@ void srslte_vec_sum_ccc(const cf_t *x, const cf_t *y, cf_t *z, const uint32_t le
 
 // PSS, PBCH, DEMOD, FFTW, etc.
 void srslte_vec_sc_prod_fff(const float *x, const float h, float *z, const uint32_t len) {
-  srslte_vec_sc_prod_fff_simd(x, h, z, len);
+  simd->sc_prod_fff(x, h, z, len);
 }
 
 // Used throughout 
 void srslte_vec_sc_prod_cfc(const cf_t *x, const float h, cf_t *z, const uint32_t len) {
-  srslte_vec_sc_prod_cfc_simd(x,h,z,len);
+  simd->sc_prod_cfc(x,h,z,len);
 }
 
 // Chest UL 
 void srslte_vec_sc_prod_ccc(const cf_t *x, const cf_t h, cf_t *z, const uint32_t len) {
-  srslte_vec_sc_prod_ccc_simd(x,h,z,len);
+  simd->sc_prod_ccc(x,h,z,len);
 }
 
 // Used in turbo decoder 
 void srslte_vec_convert_if(const int16_t *x, const float scale, float *z, const uint32_t len) {
-  srslte_vec_convert_if_simd(x, z, scale, len);
+  simd->convert_if(x, z, scale, len);
 }
 
 void srslte_vec_convert_fi(const float *x, const float scale, int16_t *z, const uint32_t len) {
-  srslte_vec_convert_fi_simd(x, z, scale, len);
+  simd->convert_fi(x, z, scale, len);
 }
 
 void srslte_vec_convert_fb(const float *x, const float scale, int8_t *z, const uint32_t len) {
-  srslte_vec_convert_fb_simd(x, z, scale, len);
+  simd->convert_fb(x, z, scale, len);
 }
 
 void srslte_vec_lut_sss(const short *x, const unsigned short *lut, short *y, const uint32_t len) {
-  srslte_vec_lut_sss_simd(x, lut, y, len);
+  simd->lut_sss(x, lut, y, len);
 }
 
 void srslte_vec_lut_bbb(const int8_t *x, const unsigned short *lut, int8_t *y, const uint32_t len) {
-  srslte_vec_lut_bbb_simd(x, lut, y, len);
+  simd->lut_bbb(x, lut, y, len);
 }
 
 void srslte_vec_lut_sis(const short *x, const unsigned int *lut, short *y, const uint32_t len) {
@@ -284,60 +304,60 @@ void srslte_vec_conj_cc(const cf_t *x, cf_t *y, const uint32_t len) {
 
 // Used in scrambling complex 
 void srslte_vec_prod_cfc(const cf_t *x, const float *y, cf_t *z, const uint32_t len) {
-  srslte_vec_prod_cfc_simd(x, y, z, len);
+  simd->prod_cfc(x, y, z, len);
 }
 
 // Used in scrambling float
 void srslte_vec_prod_fff(const float *x, const float *y, float *z, const uint32_t len) {
-  srslte_vec_prod_fff_simd(x, y, z, len);
+  simd->prod_fff(x, y, z, len);
 }
 
 void srslte_vec_prod_sss(const int16_t *x, const int16_t *y, int16_t *z, const uint32_t len) {
-  srslte_vec_prod_sss_simd(x,y,z,len);
+  simd->prod_sss(x,y,z,len);
 }
 
 // Scrambling
 void srslte_vec_neg_sss(const int16_t *x, const int16_t *y, int16_t *z, const uint32_t len) {
-  srslte_vec_neg_sss_simd(x,y,z,len);
+  simd->neg_sss(x,y,z,len);
 }
 void srslte_vec_neg_bbb(const int8_t *x, const int8_t *y, int8_t *z, const uint32_t len) {
-  srslte_vec_neg_bbb_simd(x,y,z,len);
+  simd->neg_bbb(x,y,z,len);
 }
 
 // CFO and OFDM processing
 void srslte_vec_prod_ccc(const cf_t *x, const cf_t *y, cf_t *z, const uint32_t len) {
-  srslte_vec_prod_ccc_simd(x,y,z,len);
+  simd->prod_ccc(x,y,z,len);
 }
 
 void srslte_vec_prod_ccc_split(const float *x_re, const float *x_im, const float *y_re, const float *y_im,
                                float *z_re, float *z_im, const uint32_t len) {
-  srslte_vec_prod_ccc_split_simd(x_re, x_im, y_re , y_im, z_re,z_im, len);
+  simd->prod_ccc_split(x_re, x_im, y_re , y_im, z_re,z_im, len);
 }
 
 // PRACH, CHEST UL, etc. 
 void srslte_vec_prod_conj_ccc(const cf_t *x, const cf_t *y, cf_t *z, const uint32_t len) {
-  srslte_vec_prod_conj_ccc_simd(x,y,z,len);
+  simd->prod_conj_ccc(x,y,z,len);
 }
 
 //#define DIV_USE_VEC
 
 // Used in SSS 
 void srslte_vec_div_ccc(const cf_t *x, const cf_t *y, cf_t *z, const uint32_t len) {
-  srslte_vec_div_ccc_simd(x, y, z, len);
+  simd->div_ccc(x, y, z, len);
 }
 
 /* Complex division by float z=x/y */
 void srslte_vec_div_cfc(const cf_t *x, const float *y, cf_t *z, const uint32_t len) {
-  srslte_vec_div_cfc_simd(x, y, z, len);
+  simd->div_cfc(x, y, z, len);
 }
 
 void srslte_vec_div_fff(const float *x, const float *y, float *z, const uint32_t len) {
-  srslte_vec_div_fff_simd(x, y, z, len);
+  simd->div_fff(x, y, z, len);
 }
 
 // PSS. convolution 
 cf_t srslte_vec_dot_prod_ccc(const cf_t *x, const cf_t *y, const uint32_t len) {
-  return srslte_vec_dot_prod_ccc_simd(x, y, len);
+  return simd->dot_prod_ccc(x, y, len);
 }
 
 // Convolution filter and in SSS search 
@@ -352,7 +372,7 @@ cf_t srslte_vec_dot_prod_cfc(const cf_t *x, const float *y, const uint32_t len)
 
 // SYNC 
 cf_t srslte_vec_dot_prod_conj_ccc(const cf_t *x, const cf_t *y, const uint32_t len) {
-  return srslte_vec_dot_prod_conj_ccc_simd(x, y, len);
+  return simd->dot_prod_conj_ccc(x, y, len);
 }
 
 // PHICH 
@@ -366,7 +386,7 @@ float srslte_vec_dot_prod_fff(const float *x, const float *y, const uint32_t len
 }
 
 int32_t srslte_vec_dot_prod_sss(const int16_t *x, const int16_t *y, const uint32_t len) {
-  return srslte_vec_dot_prod_sss_simd(x, y, len);
+  return simd->dot_prod_sss(x, y, len);
 }
 
 float srslte_vec_avg_power_cf(const cf_t *x, const uint32_t len) {
@@ -384,25 +404,25 @@ float srslte_vec_corr_ccc(const cf_t *x, cf_t *y, const uint32_t len) {
 
 // PSS (disabled and using abs_square )
 void srslte_vec_abs_cf(const cf_t *x, float *abs, const uint32_t len) {
-  srslte_vec_abs_cf_simd(x, abs, len);
+  simd->abs_cf(x, abs, len);
 }
 
 // PRACH 
 void srslte_vec_abs_square_cf(const cf_t *x, float *abs_square, const uint32_t len) {
-  srslte_vec_abs_square_cf_simd(x,abs_square,len);
+  simd->abs_square_cf(x,abs_square,len);
 }
 
 uint32_t srslte_vec_max_fi(const float *x, const uint32_t len) {
-  return srslte_vec_max_fi_simd(x, len);
+  return simd->max_fi(x, len);
 }
 
 uint32_t srslte_vec_max_abs_fi(const float *x, const uint32_t len) {
-  return srslte_vec_max_abs_fi_simd(x, len);
+  return simd->max_abs_fi(x, len);
 }
 
 // CP autocorr
 uint32_t srslte_vec_max_abs_ci(const cf_t *x, const uint32_t len) {
-  return srslte_vec_max_ci_simd(x, len);
+  return simd->max_ci(x, len);
 }
 
 void srslte_vec_quant_fus(float *in, uint16_t *out, float gain, float offset, float clip, uint32_t len) {
@@ -460,17 +480,17 @@ void srslte_vec_quant_sus(const int16_t *in, uint16_t *out, const float gain, co
 }
 
 void srs_vec_cf_cpy(const cf_t *src, cf_t *dst, int len) {
-  srslte_vec_cp_simd(src, dst, len);
+  simd->cp(src, dst, len);
 }
 
 void srslte_vec_interleave(const cf_t *x, const cf_t *y, cf_t *z, const int len) {
-  srslte_vec_interleave_simd(x, y, z, len);
+  simd->interleave(x, y, z, len);
 }
 
 void srslte_vec_interleave_add(const cf_t *x, const cf_t *y, cf_t *z, const int len) {
-  srslte_vec_interleave_add_simd(x, y, z, len);
+  simd->interleave_add(x, y, z, len);
 }
 
 void srslte_vec_apply_cfo(const cf_t *x, float cfo, cf_t *z, int len) {
-  srslte_vec_apply_cfo_simd(x, cfo, z, len);
+  simd->apply_cfo(x, cfo, z, len);
 }
@@ -33,6 +33,7 @@
 #include <stdio.h>
 
 #include <srslte/config.h>
+#include "vector_simd_isa.h"
 #include "srslte/phy/utils/vector_simd.h"
 #include "srslte/phy/utils/simd.h"
 
@@ -428,67 +429,37 @@ void srslte_vec_convert_fi_simd(const float *x, int16_t *z, const float scale, c
   }
 }
 
-#define SRSLTE_IS_ALIGNED_SSE(PTR) (((size_t)(PTR) & 0x0F) == 0)
-
 void srslte_vec_convert_fb_simd(const float *x, int8_t *z, const float scale, const int len) {
   int i = 0;
 
-  // Force the use of SSE here instead of AVX since the implementations requires too many permutes across 128-bit boundaries
+#if SRSLTE_SIMD_F_SIZE && SRSLTE_SIMD_S_SIZE && SRSLTE_SIMD_B_SIZE
+  simd_f_t s = srslte_simd_f_set1(scale);
+  if (SRSLTE_IS_ALIGNED(x) && SRSLTE_IS_ALIGNED(z)) {
+    for (; i < len - SRSLTE_SIMD_B_SIZE + 1; i += SRSLTE_SIMD_B_SIZE) {
+      simd_f_t a = srslte_simd_f_load(&x[i]);
+      simd_f_t b = srslte_simd_f_load(&x[i + 1 * SRSLTE_SIMD_F_SIZE]);
+      simd_f_t c = srslte_simd_f_load(&x[i + 2 * SRSLTE_SIMD_F_SIZE]);
+      simd_f_t d = srslte_simd_f_load(&x[i + 3 * SRSLTE_SIMD_F_SIZE]);
+
+      simd_s_t ab = srslte_simd_convert_2f_s(srslte_simd_f_mul(a, s), srslte_simd_f_mul(b, s));
+      simd_s_t cd = srslte_simd_convert_2f_s(srslte_simd_f_mul(c, s), srslte_simd_f_mul(d, s));
 
-#ifdef LV_HAVE_SSE
-  __m128 s = _mm_set1_ps(scale);
-  if (SRSLTE_IS_ALIGNED_SSE(x) && SRSLTE_IS_ALIGNED_SSE(z)) {
-    for (; i < len - 16 + 1; i += 16) {
-      __m128 a = _mm_load_ps(&x[i]);
-      __m128 b = _mm_load_ps(&x[i + 1*4]);
-      __m128 c = _mm_load_ps(&x[i + 2*4]);
-      __m128 d = _mm_load_ps(&x[i + 3*4]);
-
-      __m128  sa = _mm_mul_ps(a, s);
-      __m128  sb = _mm_mul_ps(b, s);
-      __m128  sc = _mm_mul_ps(c, s);
-      __m128  sd = _mm_mul_ps(d, s);
-
-      __m128i ai = _mm_cvttps_epi32(sa);
-      __m128i bi = _mm_cvttps_epi32(sb);
-      __m128i ci = _mm_cvttps_epi32(sc);
-      __m128i di = _mm_cvttps_epi32(sd);
-      __m128i ab = _mm_packs_epi32(ai, bi);
-      __m128i cd = _mm_packs_epi32(ci, di);
-
-      __m128i i8 =_mm_packs_epi16(ab, cd);
-
-      _mm_store_si128((__m128i*)&z[i], i8);
+      srslte_simd_b_store(&z[i], srslte_simd_convert_2s_b(ab, cd));
     }
   } else {
-    for (; i < len - 16 + 1; i += 16) {
-      __m128 a = _mm_load_ps(&x[i]);
-      __m128 b = _mm_load_ps(&x[i + 1*4]);
-      __m128 c = _mm_load_ps(&x[i + 2*4]);
-      __m128 d = _mm_load_ps(&x[i + 3*4]);
-
-      __m128  sa = _mm_mul_ps(a, s);
-      __m128  sb = _mm_mul_ps(b, s);
-      __m128  sc = _mm_mul_ps(c, s);
-      __m128  sd = _mm_mul_ps(d, s);
-
-      __m128i ai = _mm_cvttps_epi32(sa);
-      __m128i bi = _mm_cvttps_epi32(sb);
-      __m128i ci = _mm_cvttps_epi32(sc);
-      __m128i di = _mm_cvttps_epi32(sd);
-      __m128i ab = _mm_packs_epi32(ai, bi);
-      __m128i cd = _mm_packs_epi32(ci, di);
+    for (; i < len - SRSLTE_SIMD_B_SIZE + 1; i += SRSLTE_SIMD_B_SIZE) {
+      simd_f_t a = srslte_simd_f_loadu(&x[i]);
+      simd_f_t b = srslte_simd_f_loadu(&x[i + 1 * SRSLTE_SIMD_F_SIZE]);
+      simd_f_t c = srslte_simd_f_loadu(&x[i + 2 * SRSLTE_SIMD_F_SIZE]);
+      simd_f_t d = srslte_simd_f_loadu(&x[i + 3 * SRSLTE_SIMD_F_SIZE]);
 
-      __m128i i8 =_mm_packs_epi16(ab, cd);
+      simd_s_t ab = srslte_simd_convert_2f_s(srslte_simd_f_mul(a, s), srslte_simd_f_mul(b, s));
+      simd_s_t cd = srslte_simd_convert_2f_s(srslte_simd_f_mul(c, s), srslte_simd_f_mul(d, s));
 
-      _mm_storeu_si128((__m128i*)&z[i], i8);
+      srslte_simd_b_storeu(&z[i], srslte_simd_convert_2s_b(ab, cd));
     }
   }
-#endif
-
-#ifdef HAVE_NEON
-#warning srslte_vec_convert_fb_simd not implemented in neon
-#endif /* HAVE_NEON */
+#endif /* SRSLTE_SIMD_F_SIZE && SRSLTE_SIMD_S_SIZE && SRSLTE_SIMD_B_SIZE */
 
   for(; i < len; i++){
     z[i] = (int8_t) (x[i] * scale);
@@ -1015,26 +986,24 @@ void srslte_vec_div_fff_simd(const float *x, const float *y, float *z, const int
 }
 
 
-
-int  srslte_vec_sc_prod_ccc_simd2(const cf_t *x, const cf_t h, cf_t *z, const int len)
-{     
-   int i = 0;
-   const unsigned int loops = len / 4;
 #ifdef HAVE_NEON
-  simd_cf_t h_vec; 
-    h_vec.val[0] = srslte_simd_f_set1(__real__ h);
-    h_vec.val[1] = srslte_simd_f_set1(__imag__ h);
+static int srslte_vec_sc_prod_ccc_simd2(const cf_t *x, const cf_t h, cf_t *z, const int len)
+{
+  int i = 0;
+  const unsigned int loops = len / 4;
+  simd_cf_t h_vec;
+  h_vec.val[0] = srslte_simd_f_set1(__real__ h);
+  h_vec.val[1] = srslte_simd_f_set1(__imag__ h);
   for (; i < loops; i++) {
 
     simd_cf_t in =  srslte_simd_cfi_load(&x[i*4]);
     simd_cf_t temp =  srslte_simd_cf_prod(in, h_vec);
     srslte_simd_cfi_store(&z[i*4], temp);
   }
-          
-#endif  
   i = loops * 4;
-return i;
+  return i;
 }
+#endif /* HAVE_NEON */
 
 void srslte_vec_sc_prod_ccc_simd(const cf_t *x, const cf_t h, cf_t *z, const int len) {
   int i = 0;
@@ -1559,3 +1528,44 @@ void srslte_vec_apply_cfo_simd(const cf_t *x, float cfo, cf_t *z, int len) {
   }
 }
 
+const srslte_vec_simd_t srslte_vec_simd_default = {
+    .xor_bbb           = srslte_vec_xor_bbb_simd,
+    .sum_sss           = srslte_vec_sum_sss_simd,
+    .sub_sss           = srslte_vec_sub_sss_simd,
+    .sub_bbb           = srslte_vec_sub_bbb_simd,
+    .acc_ff            = srslte_vec_acc_ff_simd,
+    .acc_cc            = srslte_vec_acc_cc_simd,
+    .add_fff           = srslte_vec_add_fff_simd,
+    .sub_fff           = srslte_vec_sub_fff_simd,
+    .sc_prod_cfc       = srslte_vec_sc_prod_cfc_simd,
+    .sc_prod_fff       = srslte_vec_sc_prod_fff_simd,
+    .sc_prod_ccc       = srslte_vec_sc_prod_ccc_simd,
+    .prod_ccc_split    = srslte_vec_prod_ccc_split_simd,
+    .prod_sss          = srslte_vec_prod_sss_simd,
+    .neg_sss           = srslte_vec_neg_sss_simd,
+    .neg_bbb           = srslte_vec_neg_bbb_simd,
+    .prod_cfc          = srslte_vec_prod_cfc_simd,
+    .prod_fff          = srslte_vec_prod_fff_simd,
+    .prod_ccc          = srslte_vec_prod_ccc_simd,
+    .prod_conj_ccc     = srslte_vec_prod_conj_ccc_simd,
+    .div_ccc           = srslte_vec_div_ccc_simd,
+    .div_cfc           = srslte_vec_div_cfc_simd,
+    .div_fff           = srslte_vec_div_fff_simd,
+    .dot_prod_conj_ccc = srslte_vec_dot_prod_conj_ccc_simd,
+    .dot_prod_ccc      = srslte_vec_dot_prod_ccc_simd,
+    .dot_prod_sss      = srslte_vec_dot_prod_sss_simd,
+    .abs_cf            = srslte_vec_abs_cf_simd,
+    .abs_square_cf     = srslte_vec_abs_square_cf_simd,
+    .lut_sss           = srslte_vec_lut_sss_simd,
+    .lut_bbb           = srslte_vec_lut_bbb_simd,
+    .convert_if        = srslte_vec_convert_if_simd,
+    .convert_fi        = srslte_vec_convert_fi_simd,
+    .convert_fb        = srslte_vec_convert_fb_simd,
+    .cp                = srslte_vec_cp_simd,
+    .interleave        = srslte_vec_interleave_simd,
+    .interleave_add    = srslte_vec_interleave_add_simd,
+    .apply_cfo         = srslte_vec_apply_cfo_simd,
+    .max_fi            = srslte_vec_max_fi_simd,
+    .max_abs_fi        = srslte_vec_max_abs_fi_simd,
+    .max_ci            = srslte_vec_max_ci_simd,
+};
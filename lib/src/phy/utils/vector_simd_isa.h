@@ -0,0 +1,89 @@
+/**
+ *
+ * \section COPYRIGHT
+ *
+ * Copyright 2013-2015 Software Radio Systems Limited
+ *
+ * \section LICENSE
+ *
+ * This file is part of the srsLTE library.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*
+ * vector_simd.c is built once more for each run-time variant, with SRSLTE_SIMD_ISA set to
+ * the name of the instruction set. Renames the symbols of those builds, so that
+ * srslte_vec_prod_ccc_simd becomes srslte_vec_prod_ccc_avx2 and srslte_vec_simd_default
+ * becomes srslte_vec_simd_avx2.
+ */
+
+#ifndef SRSLTE_VECTOR_SIMD_ISA_H
+#define SRSLTE_VECTOR_SIMD_ISA_H
+
+#ifdef SRSLTE_SIMD_ISA
+
+#include "srslte/config.h"
+
+#define SRSLTE_VEC_ISA_NAME(name) CONCAT2(name, CONCAT2(_, SRSLTE_SIMD_ISA))
+
+#define srslte_vec_simd_default SRSLTE_VEC_ISA_NAME(srslte_vec_simd)
+
+#define srslte_vec_xor_bbb_simd           SRSLTE_VEC_ISA_NAME(srslte_vec_xor_bbb)
+#define srslte_vec_dot_prod_sss_simd      SRSLTE_VEC_ISA_NAME(srslte_vec_dot_prod_sss)
+#define srslte_vec_sum_sss_simd           SRSLTE_VEC_ISA_NAME(srslte_vec_sum_sss)
+#define srslte_vec_sub_sss_simd           SRSLTE_VEC_ISA_NAME(srslte_vec_sub_sss)
+#define srslte_vec_sub_bbb_simd           SRSLTE_VEC_ISA_NAME(srslte_vec_sub_bbb)
+#define srslte_vec_prod_sss_simd          SRSLTE_VEC_ISA_NAME(srslte_vec_prod_sss)
+#define srslte_vec_neg_sss_simd           SRSLTE_VEC_ISA_NAME(srslte_vec_neg_sss)
+#define srslte_vec_neg_bbb_simd           SRSLTE_VEC_ISA_NAME(srslte_vec_neg_bbb)
+#define srslte_vec_lut_sss_simd           SRSLTE_VEC_ISA_NAME(srslte_vec_lut_sss)
+#define srslte_vec_lut_bbb_simd           SRSLTE_VEC_ISA_NAME(srslte_vec_lut_bbb)
+#define srslte_vec_convert_if_simd        SRSLTE_VEC_ISA_NAME(srslte_vec_convert_if)
+#define srslte_vec_convert_fi_simd        SRSLTE_VEC_ISA_NAME(srslte_vec_convert_fi)
+#define srslte_vec_convert_fb_simd        SRSLTE_VEC_ISA_NAME(srslte_vec_convert_fb)
+#define srslte_vec_acc_ff_simd            SRSLTE_VEC_ISA_NAME(srslte_vec_acc_ff)
+#define srslte_vec_acc_cc_simd            SRSLTE_VEC_ISA_NAME(srslte_vec_acc_cc)
+#define srslte_vec_add_fff_simd           SRSLTE_VEC_ISA_NAME(srslte_vec_add_fff)
+#define srslte_vec_sub_fff_simd           SRSLTE_VEC_ISA_NAME(srslte_vec_sub_fff)
+#define srslte_vec_dot_prod_ccc_simd      SRSLTE_VEC_ISA_NAME(srslte_vec_dot_prod_ccc)
+#define srslte_vec_dot_prod_ccc_c16i_simd SRSLTE_VEC_ISA_NAME(srslte_vec_dot_prod_ccc_c16i)
+#define srslte_vec_dot_prod_conj_ccc_simd SRSLTE_VEC_ISA_NAME(srslte_vec_dot_prod_conj_ccc)
+#define srslte_vec_prod_cfc_simd          SRSLTE_VEC_ISA_NAME(srslte_vec_prod_cfc)
+#define srslte_vec_prod_fff_simd          SRSLTE_VEC_ISA_NAME(srslte_vec_prod_fff)
+#define srslte_vec_prod_ccc_simd          SRSLTE_VEC_ISA_NAME(srslte_vec_prod_ccc)
+#define srslte_vec_prod_ccc_split_simd    SRSLTE_VEC_ISA_NAME(srslte_vec_prod_ccc_split)
+#define srslte_vec_prod_ccc_c16_simd      SRSLTE_VEC_ISA_NAME(srslte_vec_prod_ccc_c16)
+#define srslte_vec_prod_conj_ccc_simd     SRSLTE_VEC_ISA_NAME(srslte_vec_prod_conj_ccc)
+#define srslte_vec_div_ccc_simd           SRSLTE_VEC_ISA_NAME(srslte_vec_div_ccc)
+#define srslte_vec_div_cfc_simd           SRSLTE_VEC_ISA_NAME(srslte_vec_div_cfc)
+#define srslte_vec_div_fff_simd           SRSLTE_VEC_ISA_NAME(srslte_vec_div_fff)
+#define srslte_vec_sc_prod_ccc_simd       SRSLTE_VEC_ISA_NAME(srslte_vec_sc_prod_ccc)
+#define srslte_vec_sc_prod_fff_simd       SRSLTE_VEC_ISA_NAME(srslte_vec_sc_prod_fff)
+#define srslte_vec_abs_cf_simd            SRSLTE_VEC_ISA_NAME(srslte_vec_abs_cf)
+#define srslte_vec_abs_square_cf_simd     SRSLTE_VEC_ISA_NAME(srslte_vec_abs_square_cf)
+#define srslte_vec_sc_prod_cfc_simd       SRSLTE_VEC_ISA_NAME(srslte_vec_sc_prod_cfc)
+#define srslte_vec_cp_simd                SRSLTE_VEC_ISA_NAME(srslte_vec_cp)
+#define srslte_vec_max_fi_simd            SRSLTE_VEC_ISA_NAME(srslte_vec_max_fi)
+#define srslte_vec_max_abs_fi_simd        SRSLTE_VEC_ISA_NAME(srslte_vec_max_abs_fi)
+#define srslte_vec_max_ci_simd            SRSLTE_VEC_ISA_NAME(srslte_vec_max_ci)
+#define srslte_vec_interleave_simd        SRSLTE_VEC_ISA_NAME(srslte_vec_interleave)
+#define srslte_vec_interleave_add_simd    SRSLTE_VEC_ISA_NAME(srslte_vec_interleave_add)
+#define srslte_vec_apply_cfo_simd         SRSLTE_VEC_ISA_NAME(srslte_vec_apply_cfo)
+
+#endif /* SRSLTE_SIMD_ISA */
+
+#endif // SRSLTE_VECTOR_SIMD_ISA_H
@@ -146,13 +146,30 @@ bool radio::rx_at(void* buffer, uint32_t nof_samples, srslte_timestamp_t rx_time
 }
 
 bool radio::rx_now(void* buffer[SRSLTE_MAX_PORTS], uint32_t nof_samples, srslte_timestamp_t* rxd_time)
+{
+  return rx_multi(buffer, nof_samples, rxd_time, false);
+}
+
+bool radio::rx_now_c16(void* buffer[SRSLTE_MAX_PORTS], uint32_t nof_samples, srslte_timestamp_t* rxd_time)
+{
+  return rx_multi(buffer, nof_samples, rxd_time, true);
+}
+
+bool radio::rx_multi(void* buffer[SRSLTE_MAX_PORTS], uint32_t nof_samples, srslte_timestamp_t* rxd_time, bool c16)
 {
   if (!radio_is_streaming) {
     srslte_rf_start_rx_stream(&rf_device, false);
     radio_is_streaming = true;
   }
-  if (srslte_rf_recv_with_time_multi(&rf_device, buffer, nof_samples, true,
-    rxd_time?&rxd_time->full_secs:NULL, rxd_time?&rxd_time->frac_secs:NULL) > 0) {
+  int ret;
+  if (c16) {
+    ret = srslte_rf_recv_with_time_multi_c16(&rf_device, buffer, nof_samples, true,
+                                             rxd_time?&rxd_time->full_secs:NULL, rxd_time?&rxd_time->frac_secs:NULL);
+  } else {
+    ret = srslte_rf_recv_with_time_multi(&rf_device, buffer, nof_samples, true,
+                                         rxd_time?&rxd_time->full_secs:NULL, rxd_time?&rxd_time->frac_secs:NULL);
+  }
+  if (ret > 0) {
     return true; 
   } else {
     return false; 
@@ -210,6 +227,25 @@ bool radio::tx_single(void *buffer, uint32_t nof_samples, srslte_timestamp_t tx_
 }
 
 bool radio::tx(void *buffer[SRSLTE_MAX_PORTS], uint32_t nof_samples, srslte_timestamp_t tx_time) {
+  return tx_multi(buffer, nof_samples, tx_time, false);
+}
+
+bool radio::tx_c16(void *buffer[SRSLTE_MAX_PORTS], uint32_t nof_samples, srslte_timestamp_t tx_time) {
+  return tx_multi(buffer, nof_samples, tx_time, true);
+}
+
+int radio::send_multi(void *buffer[SRSLTE_MAX_PORTS], uint32_t nof_samples, srslte_timestamp_t *tx_time,
+                      bool is_start_of_burst_, bool c16) {
+  if (c16) {
+    return srslte_rf_send_timed_multi_c16(&rf_device, buffer, nof_samples, tx_time->full_secs, tx_time->frac_secs,
+                                          BLOCKING_TX, is_start_of_burst_, false);
+  } else {
+    return srslte_rf_send_timed_multi(&rf_device, buffer, nof_samples, tx_time->full_secs, tx_time->frac_secs,
+                                      BLOCKING_TX, is_start_of_burst_, false);
+  }
+}
+
+bool radio::tx_multi(void *buffer[SRSLTE_MAX_PORTS], uint32_t nof_samples, srslte_timestamp_t tx_time, bool c16) {
   if (!tx_adv_negative) {
     srslte_timestamp_sub(&tx_time, 0, tx_adv_sec);
   } else {
@@ -222,7 +258,7 @@ bool radio::tx(void *buffer[SRSLTE_MAX_PORTS], uint32_t nof_samples, srslte_time
       srslte_timestamp_copy(&tx_time_pad, &tx_time);
       srslte_timestamp_sub(&tx_time_pad, 0, burst_preamble_time_rounded); 
       save_trace(1, &tx_time_pad);
-      srslte_rf_send_timed_multi(&rf_device, buffer, burst_preamble_samples, tx_time_pad.full_secs, tx_time_pad.frac_secs, true, true, false);
+      send_multi(buffer, burst_preamble_samples, &tx_time_pad, true, c16);
       is_start_of_burst = false; 
     }
   }
@@ -232,9 +268,7 @@ bool radio::tx(void *buffer[SRSLTE_MAX_PORTS], uint32_t nof_samples, srslte_time
   srslte_timestamp_add(&end_of_burst_time, 0, (double) nof_samples/cur_tx_srate); 
   
   save_trace(0, &tx_time);
-  int ret = srslte_rf_send_timed_multi(&rf_device, buffer, nof_samples,
-                                       tx_time.full_secs, tx_time.frac_secs,
-                                       BLOCKING_TX, is_start_of_burst, false);
+  int ret = send_multi(buffer, nof_samples, &tx_time, is_start_of_burst, c16);
   is_start_of_burst = false;
   if (ret > 0) {
     return true; 
@@ -0,0 +1,625 @@
+/**
+ *
+ * \section COPYRIGHT
+ *
+ * Copyright 2013-2015 Software Radio Systems Limited
+ *
+ * \section LICENSE
+ *
+ * This file is part of the srsUE library.
+ *
+ * srsUE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsUE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*
+ * Control-plane codec benchmark. Encodes and decodes a representative set of
+ * RRC, S1AP and NAS messages in a loop and reports the time and heap
+ * allocation per message. Every message is also round-trip checked, so the
+ * benchmark doubles as a codec regression test when run with few iterations.
+ */
+
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <unistd.h>
+#include "srslte/asn1/liblte_rrc.h"
+#include "srslte/asn1/liblte_mme.h"
+#include "srslte/asn1/liblte_s1ap.h"
+
+uint32_t nof_iterations = 10000;
+bool     csv_output     = false;
+
+/*******************************************************************************
+                              HEAP ACCOUNTING
+*******************************************************************************/
+
+static uint64_t heap_bytes  = 0;
+
+void* operator new(size_t size) throw(std::bad_alloc)
+{
+  heap_bytes += size;
+  void *ptr = malloc(size ? size : 1);
+  if (ptr == NULL) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void* operator new[](size_t size) throw(std::bad_alloc)
+{
+  return operator new(size);
+}
+
+void operator delete(void *ptr) throw()
+{
+  free(ptr);
+}
+
+void operator delete[](void *ptr) throw()
+{
+  free(ptr);
+}
+
+static uint64_t now_ns()
+{
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return (uint64_t) t.tv_sec * 1000000000 + t.tv_nsec;
+}
+
+/*******************************************************************************
+                              CODEC CASES
+*******************************************************************************/
+
+class codec_case
+{
+public:
+  codec_case(const char *name_) : name(name_) {}
+  virtual ~codec_case() {}
+
+  // Encodes the message struct into buf
+  virtual bool encode(LIBLTE_BYTE_MSG_STRUCT *buf) = 0;
+  // Decodes buf into the message struct
+  virtual bool decode(LIBLTE_BYTE_MSG_STRUCT *buf) = 0;
+  // Footprint of the decoded message
+  virtual size_t msg_size() = 0;
+
+  const char *name;
+};
+
+// RRC codecs work on unpacked bits, so the byte (un)packing done by the stack
+// before and after every call is part of the measured path.
+template<typename T,
+         LIBLTE_ERROR_ENUM (*pack_fn)(T*, LIBLTE_BIT_MSG_STRUCT*),
+         LIBLTE_ERROR_ENUM (*unpack_fn)(LIBLTE_BIT_MSG_STRUCT*, T*)>
+class rrc_case : public codec_case
+{
+public:
+  rrc_case(const char *name_) : codec_case(name_) { bzero(&msg, sizeof(T)); }
+
+  bool encode(LIBLTE_BYTE_MSG_STRUCT *buf) {
+    if (pack_fn(&msg, &bits) != LIBLTE_SUCCESS) {
+      return false;
+    }
+    // Zero-pad to a byte boundary, as srslte_bit_pack_vector() does in the stack
+    uint32_t nof_pad = (8 - bits.N_bits % 8) % 8;
+    bzero(&bits.msg[bits.N_bits], nof_pad);
+    liblte_pack(bits.msg, bits.N_bits + nof_pad, buf->msg);
+    buf->N_bytes = (bits.N_bits + nof_pad) / 8;
+    return true;
+  }
+  bool decode(LIBLTE_BYTE_MSG_STRUCT *buf) {
+    liblte_unpack(buf->msg, buf->N_bytes, bits.msg);
+    bits.N_bits = buf->N_bytes * 8;
+    return unpack_fn(&bits, &msg) == LIBLTE_SUCCESS;
+  }
+  size_t msg_size() { return sizeof(T); }
+
+  T msg;
+
+private:
+  LIBLTE_BIT_MSG_STRUCT bits;
+};
+
+template<typename T,
+         LIBLTE_ERROR_ENUM (*pack_fn)(T*, LIBLTE_BYTE_MSG_STRUCT*),
+         LIBLTE_ERROR_ENUM (*unpack_fn)(LIBLTE_BYTE_MSG_STRUCT*, T*)>
+class byte_case : public codec_case
+{
+public:
+  byte_case(const char *name_) : codec_case(name_) { bzero(&msg, sizeof(T)); }
+
+  bool encode(LIBLTE_BYTE_MSG_STRUCT *buf) { return pack_fn(&msg, buf) == LIBLTE_SUCCESS; }
+  bool decode(LIBLTE_BYTE_MSG_STRUCT *buf) { return unpack_fn(buf, &msg) == LIBLTE_SUCCESS; }
+  size_t msg_size() { return sizeof(T); }
+
+  T msg;
+};
+
+LIBLTE_ERROR_ENUM pack_attach_request(LIBLTE_MME_ATTACH_REQUEST_MSG_STRUCT *msg, LIBLTE_BYTE_MSG_STRUCT *buf)
+{
+  return liblte_mme_pack_attach_request_msg(msg, buf);
+}
+
+LIBLTE_ERROR_ENUM pack_attach_accept(LIBLTE_MME_ATTACH_ACCEPT_MSG_STRUCT *msg, LIBLTE_BYTE_MSG_STRUCT *buf)
+{
+  return liblte_mme_pack_attach_accept_msg(msg, LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY_AND_CIPHERED, 0, buf);
+}
+
+typedef rrc_case<LIBLTE_RRC_BCCH_DLSCH_MSG_STRUCT,
+                 liblte_rrc_pack_bcch_dlsch_msg,
+                 liblte_rrc_unpack_bcch_dlsch_msg>      bcch_dlsch_case;
+typedef rrc_case<LIBLTE_RRC_DL_CCCH_MSG_STRUCT,
+                 liblte_rrc_pack_dl_ccch_msg,
+                 liblte_rrc_unpack_dl_ccch_msg>         dl_ccch_case;
+typedef rrc_case<LIBLTE_RRC_DL_DCCH_MSG_STRUCT,
+                 liblte_rrc_pack_dl_dcch_msg,
+                 liblte_rrc_unpack_dl_dcch_msg>         dl_dcch_case;
+typedef byte_case<LIBLTE_S1AP_S1AP_PDU_STRUCT,
+                  liblte_s1ap_pack_s1ap_pdu,
+                  liblte_s1ap_unpack_s1ap_pdu>          s1ap_case;
+typedef byte_case<LIBLTE_MME_ATTACH_REQUEST_MSG_STRUCT,
+                  pack_attach_request,
+                  liblte_mme_unpack_attach_request_msg> attach_request_case;
+typedef byte_case<LIBLTE_MME_ATTACH_ACCEPT_MSG_STRUCT,
+                  pack_attach_accept,
+                  liblte_mme_unpack_attach_accept_msg>  attach_accept_case;
+
+/*******************************************************************************
+                              MESSAGE CORPUS
+*******************************************************************************/
+
+// Attach Accept (integrity protected and ciphered) carrying an Activate Default EPS Bearer Context Request
+uint8_t attach_accept_pdu[] = {0x27, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07, 0x42, 0x01, 0x3e, 0x06, 0x00, 0x00, 0xf1, 0x10, 0x00,
+                               0x01, 0x00, 0x2a, 0x52, 0x01, 0xc1, 0x01, 0x04, 0x1b, 0x07, 0x74, 0x65, 0x73, 0x74, 0x31, 0x32,
+                               0x33, 0x06, 0x6d, 0x6e, 0x63, 0x30, 0x30, 0x31, 0x06, 0x6d, 0x63, 0x63, 0x30, 0x30, 0x31, 0x04,
+                               0x67, 0x70, 0x72, 0x73, 0x05, 0x01, 0xc0, 0xa8, 0x05, 0x02, 0x27, 0x01, 0x80, 0x50, 0x0b, 0xf6,
+                               0x00, 0xf1, 0x10, 0x80, 0x01, 0x01, 0x35, 0x16, 0x6d, 0xbc, 0x64, 0x01, 0x00};
+
+static void load_pdu(LIBLTE_BYTE_MSG_STRUCT *buf, uint8_t *pdu, uint32_t len)
+{
+  bzero(buf, sizeof(LIBLTE_BYTE_MSG_STRUCT));
+  memcpy(buf->msg, pdu, len);
+  buf->N_bytes = len;
+}
+
+codec_case* build_sib1()
+{
+  bcch_dlsch_case *c = new bcch_dlsch_case("RRC SIB1");
+  c->msg.N_sibs = 1;
+  c->msg.sibs[0].sib_type = LIBLTE_RRC_SYS_INFO_BLOCK_TYPE_1;
+
+  LIBLTE_RRC_SYS_INFO_BLOCK_TYPE_1_STRUCT *sib1 = &c->msg.sibs[0].sib.sib1;
+  sib1->N_plmn_ids                = 1;
+  sib1->plmn_id[0].id.mcc         = 0xF001;
+  sib1->plmn_id[0].id.mnc         = 0xFF01;
+  sib1->plmn_id[0].resv_for_oper  = LIBLTE_RRC_NOT_RESV_FOR_OPER;
+  sib1->tracking_area_code        = 0x0007;
+  sib1->cell_id                   = 0x19B01;
+  sib1->q_rx_lev_min              = -130;
+  sib1->freq_band_indicator       = 7;
+  sib1->N_sched_info              = 1;
+  sib1->sched_info[0].si_periodicity          = LIBLTE_RRC_SI_PERIODICITY_RF16;
+  sib1->sched_info[0].N_sib_mapping_info      = 1;
+  sib1->sched_info[0].sib_mapping_info[0].sib_type = LIBLTE_RRC_SIB_TYPE_3;
+  sib1->si_window_length          = LIBLTE_RRC_SI_WINDOW_LENGTH_MS20;
+  sib1->system_info_value_tag     = 0;
+  return c;
+}
+
+codec_case* build_sib2()
+{
+  bcch_dlsch_case *c = new bcch_dlsch_case("RRC SIB2");
+  c->msg.N_sibs = 1;
+  c->msg.sibs[0].sib_type = LIBLTE_RRC_SYS_INFO_BLOCK_TYPE_2;
+
+  LIBLTE_RRC_SYS_INFO_BLOCK_TYPE_2_STRUCT *sib2 = &c->msg.sibs[0].sib.sib2;
+  sib2->rr_config_common_sib.rach_cnfg.num_ra_preambles                      = LIBLTE_RRC_NUMBER_OF_RA_PREAMBLES_N52;
+  sib2->rr_config_common_sib.rach_cnfg.max_harq_msg3_tx                      = 4;
+  sib2->rr_config_common_sib.prach_cnfg.root_sequence_index                  = 128;
+  sib2->rr_config_common_sib.prach_cnfg.prach_cnfg_info.zero_correlation_zone_config = 5;
+  sib2->rr_config_common_sib.prach_cnfg.prach_cnfg_info.prach_freq_offset    = 4;
+  sib2->rr_config_common_sib.pdsch_cnfg.rs_power                             = -4;
+  sib2->rr_config_common_sib.pusch_cnfg.n_sb                                 = 1;
+  sib2->rr_config_common_sib.pusch_cnfg.ul_rs.cyclic_shift                   = 0;
+  sib2->rr_config_common_sib.pucch_cnfg.n_rb_cqi                             = 1;
+  sib2->rr_config_common_sib.pucch_cnfg.n1_pucch_an                          = 12;
+  sib2->rr_config_common_sib.ul_pwr_ctrl.p0_nominal_pusch                    = -85;
+  sib2->rr_config_common_sib.ul_pwr_ctrl.p0_nominal_pucch                    = -107;
+  sib2->rr_config_common_sib.ul_pwr_ctrl.delta_preamble_msg3                 = 6;
+  sib2->arfcn_value_eutra.present    = false;
+  sib2->ul_bw.present                = false;
+  sib2->additional_spectrum_emission = 1;
+  sib2->time_alignment_timer         = LIBLTE_RRC_TIME_ALIGNMENT_TIMER_INFINITY;
+  return c;
+}
+
+codec_case* build_rrc_connection_setup()
+{
+  dl_ccch_case *c = new dl_ccch_case("RRC ConnectionSetup");
+  c->msg.msg_type = LIBLTE_RRC_DL_CCCH_MSG_TYPE_RRC_CON_SETUP;
+  c->msg.msg.rrc_con_setup.rrc_transaction_id = 0;
+
+  LIBLTE_RRC_RR_CONFIG_DEDICATED_STRUCT *rr_cfg = &c->msg.msg.rrc_con_setup.rr_cnfg;
+  rr_cfg->srb_to_add_mod_list_size                        = 1;
+  rr_cfg->srb_to_add_mod_list[0].srb_id                   = 1;
+  rr_cfg->srb_to_add_mod_list[0].lc_cnfg_present          = true;
+  rr_cfg->srb_to_add_mod_list[0].lc_default_cnfg_present  = true;
+  rr_cfg->srb_to_add_mod_list[0].rlc_cnfg_present         = true;
+  rr_cfg->srb_to_add_mod_list[0].rlc_default_cnfg_present = true;
+
+  rr_cfg->mac_main_cnfg_present = true;
+  LIBLTE_RRC_MAC_MAIN_CONFIG_STRUCT *mac_cfg = &rr_cfg->mac_main_cnfg.explicit_value;
+  mac_cfg->ulsch_cnfg_present = true;
+  mac_cfg->ulsch_cnfg.max_harq_tx         = LIBLTE_RRC_MAX_HARQ_TX_N4;
+  mac_cfg->ulsch_cnfg.periodic_bsr_timer  = LIBLTE_RRC_PERIODIC_BSR_TIMER_SF20;
+  mac_cfg->ulsch_cnfg.retx_bsr_timer      = LIBLTE_RRC_RETRANSMISSION_BSR_TIMER_SF320;
+  mac_cfg->phr_cnfg_present               = true;
+  mac_cfg->phr_cnfg.setup_present         = true;
+  mac_cfg->time_alignment_timer           = LIBLTE_RRC_TIME_ALIGNMENT_TIMER_INFINITY;
+
+  rr_cfg->phy_cnfg_ded_present = true;
+  LIBLTE_RRC_PHYSICAL_CONFIG_DEDICATED_STRUCT *phy_cfg = &rr_cfg->phy_cnfg_ded;
+  phy_cfg->pusch_cnfg_ded_present                   = true;
+  phy_cfg->pusch_cnfg_ded.beta_offset_ack_idx       = 6;
+  phy_cfg->pusch_cnfg_ded.beta_offset_ri_idx        = 6;
+  phy_cfg->pusch_cnfg_ded.beta_offset_cqi_idx       = 6;
+  phy_cfg->sched_request_cnfg_present               = true;
+  phy_cfg->sched_request_cnfg.setup_present         = true;
+  phy_cfg->sched_request_cnfg.sr_cnfg_idx           = 35;
+  phy_cfg->sched_request_cnfg.sr_pucch_resource_idx = 2;
+  phy_cfg->sched_request_cnfg.dsr_trans_max         = LIBLTE_RRC_DSR_TRANS_MAX_N64;
+  phy_cfg->antenna_info_default_value               = true;
+  phy_cfg->ul_pwr_ctrl_ded_present                  = true;
+  phy_cfg->ul_pwr_ctrl_ded.accumulation_en          = true;
+  phy_cfg->ul_pwr_ctrl_ded.p_srs_offset             = 3;
+  phy_cfg->pdsch_cnfg_ded_present                   = true;
+  phy_cfg->pdsch_cnfg_ded                           = LIBLTE_RRC_PDSCH_CONFIG_P_A_DB_0;
+  phy_cfg->pucch_cnfg_ded_present                   = true;
+  phy_cfg->cqi_report_cnfg_present                  = true;
+  phy_cfg->cqi_report_cnfg.report_periodic_present       = true;
+  phy_cfg->cqi_report_cnfg.report_periodic_setup_present = true;
+  phy_cfg->cqi_report_cnfg.report_periodic.format_ind_periodic = LIBLTE_RRC_CQI_FORMAT_INDICATOR_PERIODIC_WIDEBAND_CQI;
+  phy_cfg->cqi_report_cnfg.report_periodic.pmi_cnfg_idx       = 37;
+  phy_cfg->cqi_report_cnfg.report_periodic.pucch_resource_idx = 1;
+  return c;
+}
+
+codec_case* build_rrc_connection_reconfiguration()
+{
+  dl_dcch_case *c = new dl_dcch_case("RRC ConnectionReconfiguration");
+  c->msg.msg_type = LIBLTE_RRC_DL_DCCH_MSG_TYPE_RRC_CON_RECONFIG;
+
+  LIBLTE_RRC_CONNECTION_RECONFIGURATION_STRUCT *conn_reconf = &c->msg.msg.rrc_con_reconfig;
+  conn_reconf->rrc_transaction_id  = 1;
+  conn_reconf->rr_cnfg_ded_present = true;
+
+  LIBLTE_RRC_PHYSICAL_CONFIG_DEDICATED_STRUCT *phy_cfg = &conn_reconf->rr_cnfg_ded.phy_cnfg_ded;
+  conn_reconf->rr_cnfg_ded.phy_cnfg_ded_present      = true;
+  phy_cfg->antenna_info_present                      = true;
+  phy_cfg->antenna_info_explicit_value.tx_mode       = LIBLTE_RRC_TRANSMISSION_MODE_3;
+  phy_cfg->antenna_info_explicit_value.ue_tx_antenna_selection_setup_present = false;
+  phy_cfg->cqi_report_cnfg_present                   = true;
+  phy_cfg->cqi_report_cnfg.report_periodic_present       = true;
+  phy_cfg->cqi_report_cnfg.report_periodic_setup_present = true;
+  phy_cfg->cqi_report_cnfg.report_periodic.format_ind_periodic = LIBLTE_RRC_CQI_FORMAT_INDICATOR_PERIODIC_WIDEBAND_CQI;
+  phy_cfg->cqi_report_cnfg.report_periodic.pmi_cnfg_idx        = 37;
+  phy_cfg->cqi_report_cnfg.report_periodic.pucch_resource_idx  = 1;
+  phy_cfg->cqi_report_cnfg.report_periodic.ri_cnfg_idx_present = true;
+  phy_cfg->cqi_report_cnfg.report_periodic.ri_cnfg_idx         = 483;
+
+  // SRB2
+  conn_reconf->rr_cnfg_ded.srb_to_add_mod_list_size                        = 1;
+  conn_reconf->rr_cnfg_ded.srb_to_add_mod_list[0].srb_id                   = 2;
+  conn_reconf->rr_cnfg_ded.srb_to_add_mod_list[0].lc_cnfg_present          = true;
+  conn_reconf->rr_cnfg_ded.srb_to_add_mod_list[0].lc_default_cnfg_present  = true;
+  conn_reconf->rr_cnfg_ded.srb_to_add_mod_list[0].rlc_cnfg_present         = true;
+  conn_reconf->rr_cnfg_ded.srb_to_add_mod_list[0].rlc_default_cnfg_present = true;
+
+  // DRB1 over RLC AM
+  LIBLTE_RRC_DRB_TO_ADD_MOD_STRUCT *drb = &conn_reconf->rr_cnfg_ded.drb_to_add_mod_list[0];
+  conn_reconf->rr_cnfg_ded.drb_to_add_mod_list_size = 1;
+  drb->drb_id                = 1;
+  drb->lc_id                 = 3;
+  drb->lc_id_present         = true;
+  drb->eps_bearer_id         = 5;
+  drb->eps_bearer_id_present = true;
+  drb->lc_cnfg_present       = true;
+  drb->lc_cnfg.ul_specific_params_present = true;
+  drb->lc_cnfg.ul_specific_params.priority               = 11;
+  drb->lc_cnfg.ul_specific_params.prioritized_bit_rate   = LIBLTE_RRC_PRIORITIZED_BIT_RATE_INFINITY;
+  drb->lc_cnfg.ul_specific_params.bucket_size_duration   = LIBLTE_RRC_BUCKET_SIZE_DURATION_MS100;
+  drb->lc_cnfg.ul_specific_params.log_chan_group         = 3;
+  drb->lc_cnfg.ul_specific_params.log_chan_group_present = true;
+  drb->pdcp_cnfg_present                 = true;
+  drb->pdcp_cnfg.discard_timer_present   = true;
+  drb->pdcp_cnfg.discard_timer           = LIBLTE_RRC_DISCARD_TIMER_INFINITY;
+  drb->pdcp_cnfg.rlc_am_status_report_required_present = true;
+  drb->pdcp_cnfg.rlc_am_status_report_required         = true;
+  drb->rlc_cnfg_present                  = true;
+  drb->rlc_cnfg.rlc_mode                 = LIBLTE_RRC_RLC_MODE_AM;
+  drb->rlc_cnfg.ul_am_rlc.t_poll_retx    = LIBLTE_RRC_T_POLL_RETRANSMIT_MS45;
+  drb->rlc_cnfg.ul_am_rlc.poll_pdu       = LIBLTE_RRC_POLL_PDU_INFINITY;
+  drb->rlc_cnfg.ul_am_rlc.poll_byte      = LIBLTE_RRC_POLL_BYTE_INFINITY;
+  drb->rlc_cnfg.ul_am_rlc.max_retx_thresh = LIBLTE_RRC_MAX_RETX_THRESHOLD_T4;
+  drb->rlc_cnfg.dl_am_rlc.t_reordering   = LIBLTE_RRC_T_REORDERING_MS35;
+  drb->rlc_cnfg.dl_am_rlc.t_status_prohibit = LIBLTE_RRC_T_STATUS_PROHIBIT_MS0;
+
+  // Piggybacked NAS Attach Accept
+  conn_reconf->N_ded_info_nas = 1;
+  memcpy(conn_reconf->ded_info_nas_list[0].msg, attach_accept_pdu, sizeof(attach_accept_pdu));
+  conn_reconf->ded_info_nas_list[0].N_bytes = sizeof(attach_accept_pdu);
+  return c;
+}
+
+codec_case* build_attach_request()
+{
+  attach_request_case *c = new attach_request_case("NAS Attach Request");
+  LIBLTE_MME_ATTACH_REQUEST_MSG_STRUCT *attach_req = &c->msg;
+
+  attach_req->eps_attach_type = LIBLTE_MME_EPS_ATTACH_TYPE_EPS_ATTACH;
+  for (uint32_t i = 0; i < 8; i++) {
+    attach_req->ue_network_cap.eea[i] = (i < 3);
+    attach_req->ue_network_cap.eia[i] = (i > 0 && i < 3);
+  }
+  attach_req->eps_mobile_id.type_of_id = LIBLTE_MME_EPS_MOBILE_ID_TYPE_IMSI;
+  for (uint32_t i = 0; i < 15; i++) {
+    attach_req->eps_mobile_id.imsi[i] = (uint8_t) ((i * 7 + 1) % 10);
+  }
+  attach_req->nas_ksi.tsc_flag = LIBLTE_MME_TYPE_OF_SECURITY_CONTEXT_FLAG_NATIVE;
+  attach_req->nas_ksi.nas_ksi  = 0;
+
+  // PDN Connectivity Request for the default bearer
+  LIBLTE_MME_PDN_CONNECTIVITY_REQUEST_MSG_STRUCT pdn_con_req;
+  bzero(&pdn_con_req, sizeof(LIBLTE_MME_PDN_CONNECTIVITY_REQUEST_MSG_STRUCT));
+  pdn_con_req.eps_bearer_id       = 0x00;
+  pdn_con_req.proc_transaction_id = 0x01;
+  pdn_con_req.pdn_type            = LIBLTE_MME_PDN_TYPE_IPV4;
+  pdn_con_req.request_type        = LIBLTE_MME_REQUEST_TYPE_INITIAL_REQUEST;
+  liblte_mme_pack_pdn_connectivity_request_msg(&pdn_con_req, &attach_req->esm_msg);
+  return c;
+}
+
+codec_case* build_attach_accept()
+{
+  attach_accept_case *c = new attach_accept_case("NAS Attach Accept");
+  LIBLTE_BYTE_MSG_STRUCT buf;
+  load_pdu(&buf, attach_accept_pdu, sizeof(attach_accept_pdu));
+  c->decode(&buf);
+  return c;
+}
+
+static void fill_tai_and_cgi(LIBLTE_S1AP_TAI_STRUCT *tai, LIBLTE_S1AP_EUTRAN_CGI_STRUCT *cgi)
+{
+  uint8_t plmn[3] = {0x00, 0xf1, 0x10};
+  memcpy(tai->pLMNidentity.buffer, plmn, 3);
+  tai->tAC.buffer[0] = 0x00;
+  tai->tAC.buffer[1] = 0x07;
+  memcpy(cgi->pLMNidentity.buffer, plmn, 3);
+  uint8_t *ptr = cgi->cell_ID.buffer;
+  liblte_value_2_bits(0x19B01, &ptr, 28);
+}
+
+codec_case* build_initial_ue_message()
+{
+  s1ap_case *c = new s1ap_case("S1AP InitialUEMessage");
+  c->msg.choice_type = LIBLTE_S1AP_S1AP_PDU_CHOICE_INITIATINGMESSAGE;
+
+  LIBLTE_S1AP_INITIATINGMESSAGE_STRUCT *init = &c->msg.choice.initiatingMessage;
+  init->procedureCode = LIBLTE_S1AP_PROC_ID_INITIALUEMESSAGE;
+  init->choice_type   = LIBLTE_S1AP_INITIATINGMESSAGE_CHOICE_INITIALUEMESSAGE;
+
+  LIBLTE_S1AP_MESSAGE_INITIALUEMESSAGE_STRUCT *initue = &init->choice.InitialUEMessage;
+  initue->eNB_UE_S1AP_ID.ENB_UE_S1AP_ID = 1;
+
+  // Carry the NAS Attach Request as the UE would send it
+  codec_case            *attach_req = build_attach_request();
+  LIBLTE_BYTE_MSG_STRUCT nas;
+  attach_req->encode(&nas);
+  delete attach_req;
+  memcpy(initue->NAS_PDU.buffer, nas.msg, nas.N_bytes);
+  initue->NAS_PDU.n_octets = nas.N_bytes;
+
+  fill_tai_and_cgi(&initue->TAI, &initue->EUTRAN_CGI);
+  initue->RRC_Establishment_Cause.e = LIBLTE_S1AP_RRC_ESTABLISHMENT_CAUSE_MO_SIGNALLING;
+  return c;
+}
+
+codec_case* build_initial_context_setup_request()
+{
+  s1ap_case *c = new s1ap_case("S1AP InitialContextSetupRequest");
+  c->msg.choice_type = LIBLTE_S1AP_S1AP_PDU_CHOICE_INITIATINGMESSAGE;
+
+  LIBLTE_S1AP_INITIATINGMESSAGE_STRUCT *init = &c->msg.choice.initiatingMessage;
+  init->procedureCode = LIBLTE_S1AP_PROC_ID_INITIALCONTEXTSETUP;
+  init->choice_type   = LIBLTE_S1AP_INITIATINGMESSAGE_CHOICE_INITIALCONTEXTSETUPREQUEST;
+
+  LIBLTE_S1AP_MESSAGE_INITIALCONTEXTSETUPREQUEST_STRUCT *in_ctxt_req = &init->choice.InitialContextSetupRequest;
+  in_ctxt_req->MME_UE_S1AP_ID.MME_UE_S1AP_ID = 1;
+  in_ctxt_req->eNB_UE_S1AP_ID.ENB_UE_S1AP_ID = 1;
+  in_ctxt_req->uEaggregateMaximumBitrate.uEaggregateMaximumBitRateDL.BitRate = 1000000000;
+  in_ctxt_req->uEaggregateMaximumBitrate.uEaggregateMaximumBitRateUL.BitRate = 1000000000;
+
+  in_ctxt_req->E_RABToBeSetupListCtxtSUReq.len = 1;
+  LIBLTE_S1AP_E_RABTOBESETUPITEMCTXTSUREQ_STRUCT *erab = &in_ctxt_req->E_RABToBeSetupListCtxtSUReq.buffer[0];
+  erab->e_RAB_ID.E_RAB_ID = 5;
+  erab->e_RABlevelQoSParameters.qCI.QCI = 9;
+  erab->e_RABlevelQoSParameters.allocationRetentionPriority.priorityLevel.PriorityLevel = 15;
+  erab->e_RABlevelQoSParameters.allocationRetentionPriority.pre_emptionCapability =
+      LIBLTE_S1AP_PRE_EMPTIONCAPABILITY_SHALL_NOT_TRIGGER_PRE_EMPTION;
+  erab->e_RABlevelQoSParameters.allocationRetentionPriority.pre_emptionVulnerability =
+      LIBLTE_S1AP_PRE_EMPTIONVULNERABILITY_PRE_EMPTABLE;
+  erab->transportLayerAddress.n_bits = 32;
+  uint8_t *ptr = erab->transportLayerAddress.buffer;
+  liblte_value_2_bits(0x7f000001, &ptr, 32);
+  erab->gTP_TEID.buffer[3] = 1;
+
+  // Piggybacked NAS Attach Accept
+  erab->nAS_PDU_present = true;
+  memcpy(erab->nAS_PDU.buffer, attach_accept_pdu, sizeof(attach_accept_pdu));
+  erab->nAS_PDU.n_octets = sizeof(attach_accept_pdu);
+
+  for (int i = 0; i < 3; i++) {
+    in_ctxt_req->UESecurityCapabilities.encryptionAlgorithms.buffer[i]          = 1;
+    in_ctxt_req->UESecurityCapabilities.integrityProtectionAlgorithms.buffer[i] = 1;
+  }
+  for (int i = 0; i < 256; i++) {
+    in_ctxt_req->SecurityKey.buffer[i] = (uint8_t) ((i * 13) % 7 > 3);
+  }
+  return c;
+}
+
+/*******************************************************************************
+                              BENCHMARK
+*******************************************************************************/
+
+typedef struct {
+  uint32_t len;
+  double   enc_ns;
+  double   dec_ns;
+  double   enc_heap;
+  double   dec_heap;
+} bench_result_t;
+
+static bool buffers_equal(LIBLTE_BYTE_MSG_STRUCT *a, LIBLTE_BYTE_MSG_STRUCT *b)
+{
+  return a->N_bytes == b->N_bytes && memcmp(a->msg, b->msg, a->N_bytes) == 0;
+}
+
+int run_case(codec_case *c, bench_result_t *r)
+{
+  static LIBLTE_BYTE_MSG_STRUCT ref, buf;
+  bzero(r, sizeof(bench_result_t));
+
+  // NAS decoders look for optional IEs past the end of the message, so start
+  // from clean buffers to keep the result independent of the previous case
+  bzero(&ref, sizeof(LIBLTE_BYTE_MSG_STRUCT));
+  bzero(&buf, sizeof(LIBLTE_BYTE_MSG_STRUCT));
+
+  // Round trip: encode, decode, re-encode and compare
+  if (!c->encode(&ref) || !c->decode(&ref) || !c->encode(&buf)) {
+    fprintf(stderr, "%s: codec error\n", c->name);
+    return -1;
+  }
+  if (!buffers_equal(&ref, &buf)) {
+    fprintf(stderr, "%s: round trip mismatch (%d != %d bytes)\n", c->name, ref.N_bytes, buf.N_bytes);
+    return -1;
+  }
+  r->len = ref.N_bytes;
+
+  uint64_t heap0 = heap_bytes;
+  uint64_t t0    = now_ns();
+  for (uint32_t i = 0; i < nof_iterations; i++) {
+    c->encode(&buf);
+  }
+  uint64_t t1    = now_ns();
+  uint64_t heap1 = heap_bytes;
+  for (uint32_t i = 0; i < nof_iterations; i++) {
+    c->decode(&ref);
+  }
+  uint64_t t2    = now_ns();
+  uint64_t heap2 = heap_bytes;
+
+  r->enc_ns   = (double) (t1 - t0) / nof_iterations;
+  r->dec_ns   = (double) (t2 - t1) / nof_iterations;
+  r->enc_heap = (double) (heap1 - heap0) / nof_iterations;
+  r->dec_heap = (double) (heap2 - heap1) / nof_iterations;
+
+  return 0;
+}
+
+void usage(char *prog)
+{
+  printf("Usage: %s [nc]\n", prog);
+  printf("\t-n number of encode/decode iterations per message [Default %d]\n", nof_iterations);
+  printf("\t-c print results as CSV\n");
+}
+
+void parse_args(int argc, char **argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "nc")) != -1) {
+    switch (opt) {
+      case 'n':
+        nof_iterations = (uint32_t) atoi(argv[optind]);
+        break;
+      case 'c':
+        csv_output = true;
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+  if (nof_iterations == 0) {
+    nof_iterations = 1;
+  }
+}
+
+int main(int argc, char **argv)
+{
+  parse_args(argc, argv);
+
+  codec_case *cases[] = {
+      build_sib1(),
+      build_sib2(),
+      build_rrc_connection_setup(),
+      build_rrc_connection_reconfiguration(),
+      build_initial_ue_message(),
+      build_initial_context_setup_request(),
+      build_attach_request(),
+      build_attach_accept(),
+  };
+  uint32_t nof_cases = sizeof(cases) / sizeof(codec_case*);
+
+  if (csv_output) {
+    printf("message,bytes,struct_bytes,encode_ns,decode_ns,encode_heap_bytes,decode_heap_bytes\n");
+  } else {
+    printf("%-32s %6s %9s %10s %10s %9s %9s %12s\n",
+           "Message", "Bytes", "Struct", "Enc ns", "Dec ns", "Enc heap", "Dec heap", "Msg/s/core");
+  }
+
+  int ret = 0;
+  for (uint32_t i = 0; i < nof_cases; i++) {
+    bench_result_t r;
+    if (run_case(cases[i], &r)) {
+      ret = -1;
+      continue;
+    }
+    if (csv_output) {
+      printf("%s,%d,%zu,%.1f,%.1f,%.1f,%.1f\n",
+             cases[i]->name, r.len, cases[i]->msg_size(), r.enc_ns, r.dec_ns, r.enc_heap, r.dec_heap);
+    } else {
+      printf("%-32s %6d %9zu %10.1f %10.1f %9.1f %9.1f %12.0f\n",
+             cases[i]->name, r.len, cases[i]->msg_size(), r.enc_ns, r.dec_ns,
+             r.enc_heap, r.dec_heap, 1e9 / (r.enc_ns + r.dec_ns));
+    }
+  }
+
+  for (uint32_t i = 0; i < nof_cases; i++) {
+    delete cases[i];
+  }
+
+  if (ret) {
+    printf("Error\n");
+  } else if (!csv_output) {
+    printf("Ok\n");
+  }
+  exit(ret);
+}
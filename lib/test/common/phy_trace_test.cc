@@ -0,0 +1,138 @@
+/**
+ *
+ * \section COPYRIGHT
+ *
+ * Copyright 2013-2015 Software Radio Systems Limited
+ *
+ * \section LICENSE
+ *
+ * This file is part of the srsUE library.
+ *
+ * srsUE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsUE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#define NOF_EVENTS  16
+#define NOF_SF      20
+#define BUDGET_US   2000
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "srslte/common/phy_trace.h"
+
+using namespace srslte;
+
+int main(int argc, char **argv) {
+  bool                     result = true;
+  phy_trace                t0, t1;
+  phy_proc_metrics_t       m;
+  std::vector<phy_trace*>  traces;
+  char                     filename[] = "/tmp/phy_trace_test_XXXXXX";
+
+  int fd = mkstemp(filename);
+  if (fd < 0) {
+    perror("mkstemp");
+    exit(1);
+  }
+  close(fd);
+
+  t0.init(NOF_EVENTS, BUDGET_US);
+  t1.init(NOF_EVENTS, BUDGET_US);
+  t0.start();
+
+  // The timeline is built from explicit timestamps, so lateness does not depend on the scheduler.
+  // Worker 0 records 3 events per subframe, the buffer wraps. One subframe is late.
+  uint64_t t = phy_trace::now();
+  for (uint32_t tti=0;tti<NOF_SF;tti++) {
+    uint64_t fft = phy_trace::us_to_ticks(tti == 5 ? 2*BUDGET_US + 10 : 10);
+    uint64_t sf  = fft + phy_trace::us_to_ticks(10);
+
+    t0.sf_begin(tti, t);
+    t0.push(PHY_TRACE_FFT, t, t + fft);
+    t0.push(PHY_TRACE_PDSCH, t + fft, t + sf);
+    t0.sf_end(t + sf);
+
+    // Worker 1 is not started, only the processing time is measured
+    t1.sf_begin(tti, t);
+    {
+      phy_trace::scope s(&t1, PHY_TRACE_PUSCH);
+    }
+    t1.sf_end(t + phy_trace::us_to_ticks(10));
+
+    t += phy_trace::us_to_ticks(1000);
+  }
+
+  t0.get_metrics(&m);
+  if (m.nof_sf != NOF_SF || m.nof_late != 1 || m.max_us < 2*BUDGET_US || m.avg_us > m.max_us) {
+    printf("Wrong metrics: nof_sf=%d, nof_late=%d, avg=%.1f us, max=%.1f us\n", m.nof_sf, m.nof_late, m.avg_us, m.max_us);
+    result = false;
+  }
+  t0.get_metrics(&m);
+  if (m.nof_sf != 0 || m.nof_late != 0) {
+    printf("Metrics were not reset\n");
+    result = false;
+  }
+  t1.get_metrics(&m);
+  if (m.nof_sf != NOF_SF || m.nof_late != 0) {
+    printf("Wrong metrics of the disabled trace: nof_sf=%d, nof_late=%d\n", m.nof_sf, m.nof_late);
+    result = false;
+  }
+
+  traces.push_back(&t0);
+  traces.push_back(&t1);
+  if (!phy_trace::write_json(filename, traces)) {
+    result = false;
+  }
+
+  // Only the last NOF_EVENTS of worker 0 are kept. With 3 events per subframe, the oldest is the SF event of TTI 14
+  FILE *f = fopen(filename, "r");
+  if (f) {
+    char line[512];
+    uint32_t nof_events = 0, nof_threads = 0;
+    while (fgets(line, sizeof(line), f)) {
+      if (strstr(line, "\"ph\":\"X\"")) {
+        if (nof_events == 0 && (!strstr(line, "\"name\":\"SF\"") || !strstr(line, "\"tti\":14}"))) {
+          printf("Wrong first event: %s", line);
+          result = false;
+        }
+        if (strstr(line, "\"tid\":1,")) {
+          printf("Event from disabled trace: %s", line);
+          result = false;
+        }
+        nof_events++;
+      } else if (strstr(line, "\"thread_name\"")) {
+        nof_threads++;
+      }
+    }
+    fclose(f);
+    if (nof_events != NOF_EVENTS || nof_threads != 2) {
+      printf("Wrong trace: %d events, %d threads\n", nof_events, nof_threads);
+      result = false;
+    }
+  } else {
+    result = false;
+  }
+  unlink(filename);
+
+  if(result) {
+    printf("Passed\n");
+    exit(0);
+  }else{
+    printf("Failed\n;");
+    exit(1);
+  }
+}
@@ -0,0 +1,298 @@
+/**
+ *
+ * \section COPYRIGHT
+ *
+ * Copyright 2013-2015 Software Radio Systems Limited
+ *
+ * \section LICENSE
+ *
+ * This file is part of the srsUE library.
+ *
+ * srsUE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsUE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#define MAX_SUBH      20
+#define MAX_PDU_LEN   3000
+#define NOF_PDUS      2000
+#define NOF_BENCH     20000
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include "srslte/common/log_filter.h"
+#include "srslte/common/pdu.h"
+#include "srslte/common/sch_pdu_codec.h"
+
+using namespace srslte;
+
+// Writes a counter pattern, sometimes less than requested like RLC does
+class rlc_dummy : public read_pdu_interface
+{
+public:
+  int read_pdu(uint32_t lcid, uint8_t *payload, uint32_t nof_bytes) {
+    uint32_t n = nof_bytes > 4 && lcid%3 == 0 ? nof_bytes - 2 : nof_bytes;
+    for (uint32_t i=0;i<n;i++) {
+      payload[i] = (uint8_t) (lcid + i);
+    }
+    return n;
+  }
+};
+
+typedef struct {
+  bool     is_ul;
+  uint32_t pdu_len;
+  uint32_t nof_ce;
+  uint32_t ce_type[3];
+  uint32_t nof_sdu;
+  uint32_t sdu_lcid[MAX_SUBH];
+  uint32_t sdu_len[MAX_SUBH];
+} pdu_desc_t;
+
+uint32_t bsr[4] = {0, 1200, 37, 150001};
+
+void random_pdu(pdu_desc_t *d, uint32_t max_sdu_len)
+{
+  d->is_ul   = rand()%2;
+  d->pdu_len = 3 + rand()%(MAX_PDU_LEN-3);
+  d->nof_ce  = rand()%4;
+  for (uint32_t i=0;i<d->nof_ce;i++) {
+    d->ce_type[i] = rand()%3;
+  }
+  d->nof_sdu = rand()%MAX_SUBH;
+  for (uint32_t i=0;i<d->nof_sdu;i++) {
+    d->sdu_lcid[i] = rand()%11;
+    d->sdu_len[i]  = 1 + rand()%max_sdu_len;
+  }
+}
+
+uint8_t* write_sch_pdu(sch_pdu *pdu, pdu_desc_t *d, uint8_t *buffer, rlc_dummy *rlc, srslte::log *log_h)
+{
+  pdu->init_tx(buffer, d->pdu_len, d->is_ul);
+  for (uint32_t i=0;i<d->nof_ce;i++) {
+    if (pdu->new_subh()) {
+      bool ret;
+      if (d->is_ul) {
+        switch(d->ce_type[i]) {
+          case 0:  ret = pdu->get()->set_c_rnti(0x4601); break;
+          case 1:  ret = pdu->get()->set_bsr(bsr, i%2 ? sch_subh::LONG_BSR : sch_subh::SHORT_BSR); break;
+          default: ret = pdu->get()->set_phr(12.0); break;
+        }
+      } else {
+        ret = d->ce_type[i] ? pdu->get()->set_ta_cmd(31) : pdu->get()->set_con_res_id(0x123456789abcULL);
+      }
+      if (!ret) {
+        pdu->del_subh();
+      }
+    }
+  }
+  for (uint32_t i=0;i<d->nof_sdu;i++) {
+    if (pdu->new_subh()) {
+      if (pdu->get()->set_sdu(d->sdu_lcid[i], d->sdu_len[i], rlc) <= 0) {
+        pdu->del_subh();
+      }
+    }
+  }
+  return pdu->write_packet(log_h);
+}
+
+uint8_t* write_encoder(sch_pdu_encoder *pdu, pdu_desc_t *d, uint8_t *buffer, rlc_dummy *rlc, srslte::log *log_h)
+{
+  pdu->init(buffer, d->pdu_len);
+  for (uint32_t i=0;i<d->nof_ce;i++) {
+    if (d->is_ul) {
+      switch(d->ce_type[i]) {
+        case 0:  pdu->add_c_rnti(0x4601); break;
+        case 1:  pdu->add_bsr(bsr, i%2 ? sch_subh::LONG_BSR : sch_subh::SHORT_BSR); break;
+        default: pdu->add_phr(12.0); break;
+      }
+    } else {
+      d->ce_type[i] ? pdu->add_ta_cmd(31) : pdu->add_con_res_id(0x123456789abcULL);
+    }
+  }
+  for (uint32_t i=0;i<d->nof_sdu;i++) {
+    pdu->add_sdu(d->sdu_lcid[i], d->sdu_len[i], rlc);
+  }
+  return pdu->write_packet(log_h);
+}
+
+// Compares every subheader of both decoders, including the CE contents
+bool same_decoding(sch_pdu *ref, sch_pdu_decoder *dec)
+{
+  ref->reset();
+  dec->reset();
+  for (uint32_t i=0;ref->next();i++) {
+    sch_subh *a = ref->get();
+    // The decoder drops padding subheaders that are not the last one
+    if (a->ce_type() == sch_subh::PADDING && i < ref->nof_subh()-1) {
+      continue;
+    }
+    if (!dec->next()) {
+      printf("Decoded %d subheaders, expected more\n", dec->nof_subh());
+      return false;
+    }
+    sch_pdu_elem *b = dec->get();
+    if (a->ce_type() != b->ce_type() || a->get_payload_size() != b->get_payload_size() ||
+        (a->get_payload_size() && memcmp(a->get_sdu_ptr(), b->get_sdu_ptr(), a->get_payload_size()))) {
+      printf("Subheader mismatch: lcid=%d/%d, nof_bytes=%d/%d\n",
+             a->get_sdu_lcid(), b->get_sdu_lcid(), a->get_payload_size(), b->get_payload_size());
+      return false;
+    }
+    if (ref->is_ul() && (b->ce_type() == sch_subh::LONG_BSR || b->ce_type() == sch_subh::SHORT_BSR)) {
+      uint32_t bs_a[4] = {0, 0, 0, 0};
+      uint32_t bs_b[4] = {0, 0, 0, 0};
+      if (a->get_bsr(bs_a) != b->get_bsr(bs_b) || memcmp(bs_a, bs_b, sizeof(bs_a))) {
+        printf("BSR mismatch\n");
+        return false;
+      }
+    }
+  }
+  if (dec->next()) {
+    printf("Decoded %d subheaders, expected less\n", dec->nof_subh());
+    return false;
+  }
+  return true;
+}
+
+// Encodes and decodes a long BSR. Each level must come back in its own LCG.
+bool long_bsr_test(srslte::log *log_h)
+{
+  uint8_t         buffer[MAX_PDU_LEN*2];
+  sch_pdu_encoder enc(MAX_SUBH);
+  sch_pdu_decoder dec(MAX_SUBH);
+  uint32_t        bs[4] = {10, 0, 4000, 93000};
+  uint32_t        rx[4];
+
+  enc.init(buffer, 16);
+  enc.add_bsr(bs, sch_subh::LONG_BSR);
+  uint8_t *ptr = enc.write_packet(log_h);
+  if (!ptr || !dec.parse_packet(ptr, 16, true) || !dec.next() || dec.get()->ce_type() != sch_subh::LONG_BSR) {
+    printf("Error decoding long BSR\n");
+    return false;
+  }
+  dec.get()->get_bsr(rx);
+  for (int i=0;i<4;i++) {
+    if (rx[i] != sch_subh::buff_size_value(sch_subh::buff_size_table(bs[i]))) {
+      printf("Long BSR LCG %d: sent %d bytes, received %d\n", i, bs[i], rx[i]);
+      return false;
+    }
+  }
+  return true;
+}
+
+// Truncated or inconsistent PDUs must be rejected
+bool malformed_test()
+{
+  sch_pdu_decoder dec(MAX_SUBH);
+  uint8_t sdu_past_end[] = {0x23, 0x10, 0x04, 0xaa};  // SDU of 16 bytes in a 4-byte PDU
+  uint8_t missing_len[]  = {0x23};                    // Length field after the end
+  uint8_t too_many[32];
+  memset(too_many, 0x3f, sizeof(too_many));           // Only padding subheaders with E bit set
+
+  return !dec.parse_packet(sdu_past_end, sizeof(sdu_past_end), false) &&
+         !dec.parse_packet(missing_len, sizeof(missing_len), false) &&
+         !dec.parse_packet(too_many, sizeof(too_many), false);
+}
+
+double bench_us(struct timeval *t0)
+{
+  struct timeval t1;
+  gettimeofday(&t1, NULL);
+  return (t1.tv_sec - t0->tv_sec)*1e6 + (t1.tv_usec - t0->tv_usec);
+}
+
+int main(int argc, char **argv)
+{
+  log_filter      log_h("MAC");
+  rlc_dummy       rlc;
+  sch_pdu         ref(MAX_SUBH);
+  sch_pdu         ref_rx(MAX_SUBH+3);  // sch_pdu reads at most max_subheaders-1 subheaders
+  sch_pdu_encoder enc(MAX_SUBH);
+  sch_pdu_decoder dec(MAX_SUBH);
+  uint8_t         buffer_ref[MAX_PDU_LEN*2];
+  uint8_t         buffer_enc[MAX_PDU_LEN*2];
+  pdu_desc_t      d;
+
+  srand(0);
+  for (uint32_t n=0;n<NOF_PDUS;n++) {
+    random_pdu(&d, n%2 ? 40 : 400);
+    uint8_t *a = write_sch_pdu(&ref, &d, buffer_ref, &rlc, &log_h);
+    uint8_t *b = write_encoder(&enc, &d, buffer_enc, &rlc, &log_h);
+    // sch_pdu may run out of space for the headers, the encoder must not
+    if ((enc.nof_subh() > 0) != (b != NULL) || (a && memcmp(a, b, d.pdu_len))) {
+      printf("PDU %d: encoder output differs from sch_pdu (pdu_len=%d, nof_ce=%d, nof_sdu=%d)\n",
+             n, d.pdu_len, d.nof_ce, d.nof_sdu);
+      exit(-1);
+    }
+    if (b) {
+      ref_rx.init_rx(d.pdu_len, d.is_ul);
+      ref_rx.parse_packet(b);
+      if (!dec.parse_packet(b, d.pdu_len, d.is_ul) || !same_decoding(&ref_rx, &dec)) {
+        printf("PDU %d: decoder output differs from sch_pdu\n", n);
+        exit(-1);
+      }
+    }
+  }
+
+  if (!long_bsr_test(&log_h) || !malformed_test()) {
+    exit(-1);
+  }
+
+  // Many small SDUs in a large TB, as when RLC status and AM segments are multiplexed
+  struct timeval t0;
+  d.is_ul   = true;
+  d.pdu_len = 1500;
+  d.nof_ce  = 2;
+  d.ce_type[0] = 0;
+  d.ce_type[1] = 1;
+  d.nof_sdu = MAX_SUBH-4;
+  for (uint32_t i=0;i<d.nof_sdu;i++) {
+    d.sdu_lcid[i] = 1 + i%8;
+    d.sdu_len[i]  = 20 + 7*i;
+  }
+  double t_ref[2], t_new[2];
+  uint8_t *ptr = NULL;
+
+  gettimeofday(&t0, NULL);
+  for (uint32_t n=0;n<NOF_BENCH;n++) {
+    ptr = write_sch_pdu(&ref, &d, buffer_ref, &rlc, &log_h);
+  }
+  t_ref[0] = bench_us(&t0);
+  gettimeofday(&t0, NULL);
+  for (uint32_t n=0;n<NOF_BENCH;n++) {
+    ref.init_rx(d.pdu_len, d.is_ul);
+    ref.parse_packet(ptr);
+  }
+  t_ref[1] = bench_us(&t0);
+
+  gettimeofday(&t0, NULL);
+  for (uint32_t n=0;n<NOF_BENCH;n++) {
+    ptr = write_encoder(&enc, &d, buffer_enc, &rlc, &log_h);
+  }
+  t_new[0] = bench_us(&t0);
+  gettimeofday(&t0, NULL);
+  for (uint32_t n=0;n<NOF_BENCH;n++) {
+    dec.parse_packet(ptr, d.pdu_len, d.is_ul);
+  }
+  t_new[1] = bench_us(&t0);
+
+  printf("%d subheaders in %d bytes, ns/TB   sch_pdu: write=%.0f parse=%.0f   codec: write=%.0f parse=%.0f\n",
+         enc.nof_subh(), d.pdu_len, 1e3*t_ref[0]/NOF_BENCH, 1e3*t_ref[1]/NOF_BENCH,
+         1e3*t_new[0]/NOF_BENCH, 1e3*t_new[1]/NOF_BENCH);
+
+  printf("Ok\n");
+  exit(0);
+}
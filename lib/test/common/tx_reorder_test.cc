@@ -0,0 +1,114 @@
+/**
+ *
+ * \section COPYRIGHT
+ *
+ * Copyright 2013-2015 Software Radio Systems Limited
+ *
+ * \section LICENSE
+ *
+ * This file is part of the srsUE library.
+ *
+ * srsUE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsUE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#define NOF_WORKERS 4
+#define NOF_SLOTS   6
+#define NOF_SF      4000
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "srslte/common/tx_reorder.h"
+
+using namespace srslte;
+
+class tx_checker : public tx_reorder_handler
+{
+public:
+  tx_checker() : nof_tx(0), nof_errors(0) {}
+  void tx_slot(uint32_t seq, tx_reorder_slot_t *slot) {
+    uint32_t payload;
+    memcpy(&payload, slot->buffer[1], sizeof(uint32_t));
+    if (seq != nof_tx || payload != seq || slot->nof_samples != seq%7 || slot->tx_enable != (seq%3 == 0)) {
+      if (nof_errors < 10) {
+        printf("Wrong slot: seq=%d, expected=%d, payload=%d\n", seq, nof_tx, payload);
+      }
+      nof_errors++;
+    }
+    // Make the transmitter fall behind now and then
+    if (seq%500 == 0) {
+      usleep(2000);
+    }
+    __atomic_store_n(&nof_tx, nof_tx + 1, __ATOMIC_RELEASE);
+  }
+  uint32_t nof_tx;
+  uint32_t nof_errors;
+};
+
+tx_reorder reorder;
+
+// Worker i fills every NOF_WORKERS-th subframe, with a random processing time
+void *worker_thread(void *arg)
+{
+  uint32_t id   = (uint32_t) (size_t) arg;
+  uint32_t seed = id;
+  for (uint32_t seq=id;seq<NOF_SF;seq+=NOF_WORKERS) {
+    usleep(rand_r(&seed)%200);
+    tx_reorder_slot_t *slot = reorder.get_slot(seq);
+    memcpy(slot->buffer[1], &seq, sizeof(uint32_t));
+    slot->nof_samples = seq%7;
+    slot->tx_enable   = seq%3 == 0;
+    reorder.push(seq);
+  }
+  return NULL;
+}
+
+int main(int argc, char **argv) {
+  tx_checker checker;
+  pthread_t  workers[NOF_WORKERS];
+
+  if (!reorder.init(&checker, NOF_SLOTS, 2, 64, -1)) {
+    printf("Error initiating tx_reorder\n");
+    exit(-1);
+  }
+  if (reorder.get_nof_slots() != 8) {
+    printf("Number of slots is not a power of two: %d\n", reorder.get_nof_slots());
+    exit(-1);
+  }
+
+  for (uint32_t i=0;i<NOF_WORKERS;i++) {
+    pthread_create(&workers[i], NULL, worker_thread, (void*) (size_t) i);
+  }
+  for (uint32_t i=0;i<NOF_WORKERS;i++) {
+    pthread_join(workers[i], NULL);
+  }
+
+  // Wait for the last slots to be transmitted
+  for (uint32_t i=0;i<1000 && __atomic_load_n(&checker.nof_tx, __ATOMIC_ACQUIRE) < NOF_SF;i++) {
+    usleep(1000);
+  }
+  reorder.stop();
+
+  if (checker.nof_tx != NOF_SF || checker.nof_errors) {
+    printf("Transmitted %d of %d subframes, %d errors\n", checker.nof_tx, NOF_SF, checker.nof_errors);
+    exit(-1);
+  }
+
+  printf("Ok\n");
+  exit(0);
+}
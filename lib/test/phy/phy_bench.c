@@ -0,0 +1,1243 @@
+/**
+ *
+ * \section COPYRIGHT
+ *
+ * Copyright 2013-2015 Software Radio Systems Limited
+ *
+ * \section LICENSE
+ *
+ * This file is part of the srsLTE library.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*
+ * PHY kernel benchmark. Times the OFDM modulator and demodulator, the channel
+ * estimators, the soft demodulator, the turbo and Viterbi decoders, the turbo
+ * rate matching, the PDCCH blind search, the PRACH detector and the complete
+ * PDSCH and PUSCH chains, for every bandwidth and a set of MCS. The chains
+ * are checked for CRC errors, so the benchmark doubles as a regression test
+ * when run with few iterations.
+ *
+ * The results can be written as CSV (-c) or JSON (-j), together with the
+ * host, the build and the kernels in use. A CSV file from an earlier run can
+ * be given with -b: any kernel slower than the baseline by more than the
+ * threshold (-t) is reported and the benchmark fails.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/utsname.h>
+
+#include "srslte/srslte.h"
+#include "srslte/build_info.h"
+
+#define MAX_RESULTS         512
+#define MAX_DATABUFFER_SIZE (6144 * 16 * 3 / 8)
+#define TDEC_NOF_ITERATIONS 4
+
+static const uint32_t bench_prb[]    = {6, 15, 25, 50, 75, 100};
+static const uint32_t tdec_cb_len[]  = {40, 1056, 6144};
+static const uint32_t pdsch_mcs[]    = {0, 9, 17, 27};
+static const uint32_t pusch_mcs[]    = {0, 10, 20};
+
+#define NOF_BENCH_PRB (sizeof(bench_prb) / sizeof(uint32_t))
+#define NOF_TDEC_CB   (sizeof(tdec_cb_len) / sizeof(uint32_t))
+#define NOF_PDSCH_MCS (sizeof(pdsch_mcs) / sizeof(uint32_t))
+#define NOF_PUSCH_MCS (sizeof(pusch_mcs) / sizeof(uint32_t))
+
+uint32_t nof_iterations = 100;
+uint32_t nof_prb        = 0;
+char    *kernel_filter  = NULL;
+bool     csv_output     = false;
+bool     json_output    = false;
+char    *baseline_file  = NULL;
+float    threshold      = 10.0;
+
+uint16_t rnti = 0x1234;
+
+void usage(char *prog) {
+  printf("Usage: %s [npkcjbtv]\n", prog);
+  printf("\t-n number of iterations per kernel [Default %d]\n", nof_iterations);
+  printf("\t-p nof_prb [Default all of 6, 15, 25, 50, 75, 100]\n");
+  printf("\t-k only run the kernels whose name contains this string [Default all]\n");
+  printf("\t-c CSV output\n");
+  printf("\t-j JSON output\n");
+  printf("\t-b baseline CSV file to compare with [Default none]\n");
+  printf("\t-t regression threshold in %% [Default %.0f]\n", threshold);
+  printf("\t-v [set srslte_verbose to debug, default none]\n");
+}
+
+void parse_args(int argc, char **argv) {
+  int opt;
+  while ((opt = getopt(argc, argv, "npkcjbtv")) != -1) {
+    switch (opt) {
+      case 'n':
+        nof_iterations = (uint32_t) atoi(argv[optind]);
+        break;
+      case 'p':
+        nof_prb = (uint32_t) atoi(argv[optind]);
+        break;
+      case 'k':
+        kernel_filter = argv[optind];
+        break;
+      case 'c':
+        csv_output = true;
+        break;
+      case 'j':
+        json_output = true;
+        break;
+      case 'b':
+        baseline_file = argv[optind];
+        break;
+      case 't':
+        threshold = (float) atof(argv[optind]);
+        break;
+      case 'v':
+        srslte_verbose++;
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+  if (nof_iterations == 0) {
+    nof_iterations = 1;
+  }
+}
+
+/*******************************************************************************
+                                 BENCH CORE
+*******************************************************************************/
+
+typedef struct {
+  char     kernel[32];
+  uint32_t nof_prb;
+  char     param[16];
+  uint32_t iterations;
+  double   avg_us;
+  double   min_us;
+  double   mbps;
+} bench_result_t;
+
+static bench_result_t results[MAX_RESULTS];
+static uint32_t       nof_results = 0;
+
+static uint64_t now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static bool bench_selected(const char *kernel) {
+  return kernel_filter == NULL || strstr(kernel, kernel_filter) != NULL;
+}
+
+/* Runs fn once to warm up the caches, then nof_iterations times. fn returns non-zero on error.
+ * nof_bits is the number of information bits processed by each call, or 0 if not meaningful */
+static int bench_run(const char *kernel, uint32_t prb, const char *param, uint32_t nof_bits,
+                     int (*fn)(void *), void *arg) {
+  if (!bench_selected(kernel)) {
+    return SRSLTE_SUCCESS;
+  }
+  if (nof_results == MAX_RESULTS) {
+    fprintf(stderr, "Too many results\n");
+    return SRSLTE_ERROR;
+  }
+
+  if (fn(arg)) {
+    fprintf(stderr, "Error running %s nof_prb=%d %s\n", kernel, prb, param);
+    return SRSLTE_ERROR;
+  }
+
+  uint64_t total = 0, min = UINT64_MAX;
+  for (uint32_t i = 0; i < nof_iterations; i++) {
+    uint64_t t0 = now_ns();
+    int      r  = fn(arg);
+    uint64_t t  = now_ns() - t0;
+    if (r) {
+      fprintf(stderr, "Error running %s nof_prb=%d %s\n", kernel, prb, param);
+      return SRSLTE_ERROR;
+    }
+    total += t;
+    if (t < min) {
+      min = t;
+    }
+  }
+
+  bench_result_t *res = &results[nof_results++];
+  snprintf(res->kernel, sizeof(res->kernel), "%s", kernel);
+  res->nof_prb = prb;
+  snprintf(res->param, sizeof(res->param), "%s", param);
+  res->iterations = nof_iterations;
+  res->avg_us     = (double) total / nof_iterations / 1000;
+  res->min_us     = (double) min / 1000;
+  res->mbps       = res->avg_us > 0 ? nof_bits / res->avg_us : 0;
+
+  if (!csv_output && !json_output) {
+    printf("%-16s %8d %10s %10.1f %10.1f %10.1f\n", res->kernel, res->nof_prb, res->param,
+           res->avg_us, res->min_us, res->mbps);
+  }
+  return SRSLTE_SUCCESS;
+}
+
+/*******************************************************************************
+                             BANDWIDTH-INDEPENDENT
+*******************************************************************************/
+
+typedef struct {
+  srslte_tdec_t tdec;
+  int16_t      *llr_s;
+  int8_t       *llr_b;
+  uint8_t      *data;
+  uint32_t      K;
+} bench_tdec_t;
+
+static int run_tdec(void *arg) {
+  bench_tdec_t *b = (bench_tdec_t *) arg;
+  return srslte_tdec_run_all(&b->tdec, b->llr_s, b->data, TDEC_NOF_ITERATIONS, b->K);
+}
+
+static int run_tdec_8bit(void *arg) {
+  bench_tdec_t *b = (bench_tdec_t *) arg;
+  return srslte_tdec_run_all_8bit(&b->tdec, b->llr_b, b->data, TDEC_NOF_ITERATIONS, b->K);
+}
+
+/* Decodes a noiseless code block. The decoder always runs all the iterations,
+ * the correctness of its output is covered by turbodecoder_test */
+static int bench_tdec() {
+  bench_tdec_t b;
+  srslte_tcod_t tcod;
+  uint8_t *bits = NULL, *coded = NULL;
+  int ret = SRSLTE_ERROR;
+
+  bzero(&b, sizeof(bench_tdec_t));
+  bzero(&tcod, sizeof(srslte_tcod_t));
+  if (srslte_tdec_init(&b.tdec, SRSLTE_TCOD_MAX_LEN_CB) || srslte_tcod_init(&tcod, SRSLTE_TCOD_MAX_LEN_CB)) {
+    fprintf(stderr, "Error initiating turbo coder\n");
+    goto clean_exit;
+  }
+  uint32_t max_coded = 3 * SRSLTE_TCOD_MAX_LEN_CB + SRSLTE_TCOD_TOTALTAIL;
+  bits    = srslte_vec_malloc(sizeof(uint8_t) * SRSLTE_TCOD_MAX_LEN_CB);
+  coded   = srslte_vec_malloc(sizeof(uint8_t) * max_coded);
+  b.llr_s = srslte_vec_malloc(sizeof(int16_t) * max_coded);
+  b.llr_b = srslte_vec_malloc(sizeof(int8_t) * max_coded);
+  b.data  = srslte_vec_malloc(sizeof(uint8_t) * SRSLTE_TCOD_MAX_LEN_CB / 8);
+  if (!bits || !coded || !b.llr_s || !b.llr_b || !b.data) {
+    perror("srslte_vec_malloc");
+    goto clean_exit;
+  }
+
+  for (uint32_t n = 0; n < NOF_TDEC_CB; n++) {
+    char param[16];
+    b.K = tdec_cb_len[n];
+    for (uint32_t i = 0; i < b.K; i++) {
+      bits[i] = (uint8_t) (rand() % 2);
+    }
+    srslte_tcod_encode(&tcod, bits, coded, b.K);
+    for (uint32_t i = 0; i < 3 * b.K + SRSLTE_TCOD_TOTALTAIL; i++) {
+      b.llr_s[i] = coded[i] ? 100 : -100;
+      b.llr_b[i] = coded[i] ? 10 : -10;
+    }
+    snprintf(param, sizeof(param), "K=%d", b.K);
+    if (bench_run("tdec", 0, param, b.K, run_tdec, &b) ||
+        bench_run("tdec_8bit", 0, param, b.K, run_tdec_8bit, &b)) {
+      goto clean_exit;
+    }
+  }
+  ret = SRSLTE_SUCCESS;
+
+clean_exit:
+  srslte_tdec_free(&b.tdec);
+  srslte_tcod_free(&tcod);
+  if (bits) {
+    free(bits);
+  }
+  if (coded) {
+    free(coded);
+  }
+  if (b.llr_s) {
+    free(b.llr_s);
+  }
+  if (b.llr_b) {
+    free(b.llr_b);
+  }
+  if (b.data) {
+    free(b.data);
+  }
+  return ret;
+}
+
+typedef struct {
+  srslte_viterbi_t dec;
+  float           *llr;
+  uint8_t         *data;
+  uint8_t         *data_rx;
+  uint32_t         len;
+} bench_viterbi_t;
+
+static int run_viterbi(void *arg) {
+  bench_viterbi_t *b = (bench_viterbi_t *) arg;
+  srslte_viterbi_decode_f(&b->dec, b->llr, b->data_rx, b->len);
+  return memcmp(b->data, b->data_rx, b->len) ? SRSLTE_ERROR : SRSLTE_SUCCESS;
+}
+
+/* Tail-biting decoder of the PDCCH and the PBCH */
+static int bench_viterbi() {
+  bench_viterbi_t b;
+  srslte_convcoder_t cod;
+  int poly[3] = {0x6D, 0x4F, 0x57};
+  uint8_t coded[3 * (SRSLTE_DCI_MAX_BITS + 16)];
+  float llr[3 * (SRSLTE_DCI_MAX_BITS + 16)];
+  uint8_t data[SRSLTE_DCI_MAX_BITS + 16], data_rx[SRSLTE_DCI_MAX_BITS + 16];
+  const uint32_t len[2] = {SRSLTE_DCI_MAX_BITS + 16, SRSLTE_BCH_PAYLOADCRC_LEN};
+  const char *name[2] = {"dci", "bch"};
+  int ret = SRSLTE_ERROR;
+
+  bzero(&b, sizeof(bench_viterbi_t));
+  if (srslte_viterbi_init(&b.dec, SRSLTE_VITERBI_37, poly, SRSLTE_DCI_MAX_BITS + 16, true)) {
+    fprintf(stderr, "Error initiating Viterbi decoder\n");
+    return SRSLTE_ERROR;
+  }
+  cod.R = 3;
+  cod.K = 7;
+  cod.tail_biting = true;
+  memcpy(cod.poly, poly, sizeof(poly));
+
+  b.llr     = llr;
+  b.data    = data;
+  b.data_rx = data_rx;
+  for (uint32_t n = 0; n < 2; n++) {
+    b.len = len[n];
+    for (uint32_t i = 0; i < b.len; i++) {
+      data[i] = (uint8_t) (rand() % 2);
+    }
+    srslte_convcoder_encode(&cod, data, coded, b.len);
+    for (uint32_t i = 0; i < 3 * b.len; i++) {
+      llr[i] = coded[i] ? 1.0 : -1.0;
+    }
+    if (bench_run("viterbi", 0, name[n], b.len, run_viterbi, &b)) {
+      goto clean_exit;
+    }
+  }
+  ret = SRSLTE_SUCCESS;
+
+clean_exit:
+  srslte_viterbi_free(&b.dec);
+  return ret;
+}
+
+typedef struct {
+  uint8_t *w_buff;
+  uint8_t *systematic;
+  uint8_t *parity;
+  uint8_t *output;
+  int16_t *input_s;
+  int16_t *output_s;
+  int8_t  *input_b;
+  int8_t  *output_b;
+  uint32_t cb_idx;
+  uint32_t E;
+} bench_rm_t;
+
+static int run_rm_tx(void *arg) {
+  bench_rm_t *b = (bench_rm_t *) arg;
+  return srslte_rm_turbo_tx_lut(b->w_buff, b->systematic, b->parity, b->output, b->cb_idx, b->E, 0, 0);
+}
+
+static int run_rm_rx(void *arg) {
+  bench_rm_t *b = (bench_rm_t *) arg;
+  return srslte_rm_turbo_rx_lut(b->input_s, b->output_s, b->E, b->cb_idx, 0);
+}
+
+static int run_rm_rx_8bit(void *arg) {
+  bench_rm_t *b = (bench_rm_t *) arg;
+  return srslte_rm_turbo_rx_lut_8bit(b->input_b, b->output_b, b->E, b->cb_idx, 0);
+}
+
+/* Rate matching of a code block at rate 1/3 */
+static int bench_rm() {
+  bench_rm_t b;
+  int ret = SRSLTE_ERROR;
+
+  bzero(&b, sizeof(bench_rm_t));
+  srslte_rm_turbo_gentables();
+
+  b.w_buff     = srslte_vec_malloc(sizeof(uint8_t) * SOFTBUFFER_SIZE);
+  b.systematic = srslte_vec_malloc(sizeof(uint8_t) * SOFTBUFFER_SIZE);
+  b.parity     = srslte_vec_malloc(sizeof(uint8_t) * SOFTBUFFER_SIZE);
+  b.output     = srslte_vec_malloc(sizeof(uint8_t) * SOFTBUFFER_SIZE);
+  b.input_s    = srslte_vec_malloc(sizeof(int16_t) * SOFTBUFFER_SIZE);
+  b.output_s   = srslte_vec_malloc(sizeof(int16_t) * SOFTBUFFER_SIZE);
+  b.input_b    = srslte_vec_malloc(sizeof(int8_t) * SOFTBUFFER_SIZE);
+  b.output_b   = srslte_vec_malloc(sizeof(int8_t) * SOFTBUFFER_SIZE);
+  if (!b.w_buff || !b.systematic || !b.parity || !b.output ||
+      !b.input_s || !b.output_s || !b.input_b || !b.output_b) {
+    perror("srslte_vec_malloc");
+    goto clean_exit;
+  }
+  for (uint32_t i = 0; i < SOFTBUFFER_SIZE; i++) {
+    b.systematic[i] = (uint8_t) rand();
+    b.parity[i]     = (uint8_t) rand();
+    b.input_s[i]    = (int16_t) (rand() % 200 - 100);
+    b.input_b[i]    = (int8_t) (rand() % 20 - 10);
+  }
+  bzero(b.w_buff, sizeof(uint8_t) * SOFTBUFFER_SIZE);
+
+  for (uint32_t n = 0; n < NOF_TDEC_CB; n++) {
+    char param[16];
+    uint32_t K = tdec_cb_len[n];
+    b.cb_idx = (uint32_t) srslte_cbsegm_cbindex(K);
+    b.E      = 3 * K + SRSLTE_TCOD_TOTALTAIL;
+    snprintf(param, sizeof(param), "K=%d", K);
+    bzero(b.output_s, sizeof(int16_t) * SOFTBUFFER_SIZE);
+    bzero(b.output_b, sizeof(int8_t) * SOFTBUFFER_SIZE);
+    if (bench_run("rm_turbo_tx", 0, param, K, run_rm_tx, &b) ||
+        bench_run("rm_turbo_rx", 0, param, K, run_rm_rx, &b) ||
+        bench_run("rm_turbo_rx_8bit", 0, param, K, run_rm_rx_8bit, &b)) {
+      goto clean_exit;
+    }
+  }
+  ret = SRSLTE_SUCCESS;
+
+clean_exit:
+  if (b.w_buff) {
+    free(b.w_buff);
+  }
+  if (b.systematic) {
+    free(b.systematic);
+  }
+  if (b.parity) {
+    free(b.parity);
+  }
+  if (b.output) {
+    free(b.output);
+  }
+  if (b.input_s) {
+    free(b.input_s);
+  }
+  if (b.output_s) {
+    free(b.output_s);
+  }
+  if (b.input_b) {
+    free(b.input_b);
+  }
+  if (b.output_b) {
+    free(b.output_b);
+  }
+  return ret;
+}
+
+/*******************************************************************************
+                                PER BANDWIDTH
+*******************************************************************************/
+
+static srslte_cell_t bench_cell(uint32_t prb) {
+  srslte_cell_t cell = {
+      .nof_prb = prb,
+      .nof_ports = 1,
+      .id = 1,
+      .cp = SRSLTE_CP_NORM,
+      .phich_resources = SRSLTE_PHICH_R_1,
+      .phich_length = SRSLTE_PHICH_NORM
+  };
+  return cell;
+}
+
+static void random_symbols(cf_t *x, uint32_t len) {
+  for (uint32_t i = 0; i < len; i++) {
+    x[i] = ((rand() % 2) ? 1 : -1) * M_SQRT1_2 + ((rand() % 2) ? 1 : -1) * M_SQRT1_2 * _Complex_I;
+  }
+}
+
+static int run_ofdm_tx(void *arg) {
+  srslte_ofdm_tx_sf((srslte_ofdm_t *) arg);
+  return SRSLTE_SUCCESS;
+}
+
+static int run_ofdm_rx(void *arg) {
+  srslte_ofdm_rx_sf((srslte_ofdm_t *) arg);
+  return SRSLTE_SUCCESS;
+}
+
+static int bench_ofdm(srslte_cell_t cell) {
+  srslte_ofdm_t ifft, fft;
+  int ret = SRSLTE_ERROR;
+
+  bzero(&ifft, sizeof(srslte_ofdm_t));
+  bzero(&fft, sizeof(srslte_ofdm_t));
+  cf_t *grid   = srslte_vec_malloc(sizeof(cf_t) * SRSLTE_SF_LEN_RE(cell.nof_prb, cell.cp));
+  cf_t *signal = srslte_vec_malloc(sizeof(cf_t) * SRSLTE_SF_LEN_PRB(cell.nof_prb));
+  if (!grid || !signal) {
+    perror("srslte_vec_malloc");
+    goto clean_exit;
+  }
+  random_symbols(grid, SRSLTE_SF_LEN_RE(cell.nof_prb, cell.cp));
+
+  if (srslte_ofdm_tx_init(&ifft, cell.cp, grid, signal, cell.nof_prb) ||
+      srslte_ofdm_rx_init(&fft, cell.cp, signal, grid, cell.nof_prb)) {
+    fprintf(stderr, "Error initiating OFDM\n");
+    goto clean_exit;
+  }
+  if (bench_run("ofdm_tx", cell.nof_prb, "", 0, run_ofdm_tx, &ifft) ||
+      bench_run("ofdm_rx", cell.nof_prb, "", 0, run_ofdm_rx, &fft)) {
+    goto clean_exit;
+  }
+  ret = SRSLTE_SUCCESS;
+
+clean_exit:
+  srslte_ofdm_tx_free(&ifft);
+  srslte_ofdm_rx_free(&fft);
+  if (grid) {
+    free(grid);
+  }
+  if (signal) {
+    free(signal);
+  }
+  return ret;
+}
+
+typedef struct {
+  srslte_chest_dl_t chest;
+  cf_t             *input;
+  cf_t             *ce[SRSLTE_MAX_PORTS];
+} bench_chest_dl_t;
+
+static int run_chest_dl(void *arg) {
+  bench_chest_dl_t *b = (bench_chest_dl_t *) arg;
+  return srslte_chest_dl_estimate(&b->chest, b->input, b->ce, 1);
+}
+
+static int bench_chest_dl(srslte_cell_t cell) {
+  bench_chest_dl_t b;
+  int ret = SRSLTE_ERROR;
+
+  bzero(&b, sizeof(bench_chest_dl_t));
+  uint32_t nof_re = SRSLTE_SF_LEN_RE(cell.nof_prb, cell.cp);
+  b.input = srslte_vec_malloc(sizeof(cf_t) * nof_re);
+  b.ce[0] = srslte_vec_malloc(sizeof(cf_t) * nof_re);
+  if (!b.input || !b.ce[0]) {
+    perror("srslte_vec_malloc");
+    goto clean_exit;
+  }
+  random_symbols(b.input, nof_re);
+
+  if (srslte_chest_dl_init(&b.chest, cell.nof_prb) || srslte_chest_dl_set_cell(&b.chest, cell)) {
+    fprintf(stderr, "Error initiating DL channel estimator\n");
+    goto clean_exit;
+  }
+  if (bench_run("chest_dl", cell.nof_prb, "", 0, run_chest_dl, &b)) {
+    goto clean_exit;
+  }
+  ret = SRSLTE_SUCCESS;
+
+clean_exit:
+  srslte_chest_dl_free(&b.chest);
+  if (b.input) {
+    free(b.input);
+  }
+  if (b.ce[0]) {
+    free(b.ce[0]);
+  }
+  return ret;
+}
+
+typedef struct {
+  srslte_chest_ul_t chest;
+  cf_t             *input;
+  cf_t             *ce;
+  uint32_t          nof_prb;
+  uint32_t          n_prb[2];
+} bench_chest_ul_t;
+
+static int run_chest_ul(void *arg) {
+  bench_chest_ul_t *b = (bench_chest_ul_t *) arg;
+  return srslte_chest_ul_estimate(&b->chest, b->input, b->ce, b->nof_prb, 1, 0, b->n_prb);
+}
+
+static int run_chest_ul_dmrs(void *arg) {
+  bench_chest_ul_t *b = (bench_chest_ul_t *) arg;
+  return srslte_chest_ul_estimate_dmrs(&b->chest, b->input, b->nof_prb, 1, 0, b->n_prb);
+}
+
+/* Resource grid estimator and the DMRS-only estimator of the fused PUSCH receiver */
+static int bench_chest_ul(srslte_cell_t cell) {
+  bench_chest_ul_t b;
+  srslte_refsignal_dmrs_pusch_cfg_t dmrs_cfg;
+  int ret = SRSLTE_ERROR;
+
+  bzero(&b, sizeof(bench_chest_ul_t));
+  bzero(&dmrs_cfg, sizeof(srslte_refsignal_dmrs_pusch_cfg_t));
+  uint32_t nof_re = SRSLTE_SF_LEN_RE(cell.nof_prb, cell.cp);
+  b.input = srslte_vec_malloc(sizeof(cf_t) * nof_re);
+  b.ce    = srslte_vec_malloc(sizeof(cf_t) * nof_re);
+  if (!b.input || !b.ce) {
+    perror("srslte_vec_malloc");
+    goto clean_exit;
+  }
+  random_symbols(b.input, nof_re);
+
+  if (srslte_chest_ul_init(&b.chest, cell.nof_prb) || srslte_chest_ul_set_cell(&b.chest, cell)) {
+    fprintf(stderr, "Error initiating UL channel estimator\n");
+    goto clean_exit;
+  }
+  srslte_chest_ul_set_cfg(&b.chest, &dmrs_cfg, NULL, NULL);
+
+  /* Largest allocation with a valid DFT size */
+  b.nof_prb = cell.nof_prb;
+  while (!srslte_dft_precoding_valid_prb(b.nof_prb)) {
+    b.nof_prb--;
+  }
+  if (bench_run("chest_ul", cell.nof_prb, "", 0, run_chest_ul, &b) ||
+      bench_run("chest_ul_dmrs", cell.nof_prb, "", 0, run_chest_ul_dmrs, &b)) {
+    goto clean_exit;
+  }
+  ret = SRSLTE_SUCCESS;
+
+clean_exit:
+  srslte_chest_ul_free(&b.chest);
+  if (b.input) {
+    free(b.input);
+  }
+  if (b.ce) {
+    free(b.ce);
+  }
+  return ret;
+}
+
+typedef struct {
+  srslte_mod_t mod;
+  cf_t        *symbols;
+  short       *llr_s;
+  int8_t      *llr_b;
+  uint32_t     nof_symbols;
+} bench_demod_t;
+
+static int run_demod_s(void *arg) {
+  bench_demod_t *b = (bench_demod_t *) arg;
+  return srslte_demod_soft_demodulate_s(b->mod, b->symbols, b->llr_s, b->nof_symbols) < 0;
+}
+
+static int run_demod_b(void *arg) {
+  bench_demod_t *b = (bench_demod_t *) arg;
+  return srslte_demod_soft_demodulate_b(b->mod, b->symbols, b->llr_b, b->nof_symbols) < 0;
+}
+
+/* Soft demodulation of the data REs of a subframe */
+static int bench_demod(srslte_cell_t cell) {
+  bench_demod_t b;
+  srslte_mod_t mods[3] = {SRSLTE_MOD_QPSK, SRSLTE_MOD_16QAM, SRSLTE_MOD_64QAM};
+  int ret = SRSLTE_ERROR;
+
+  bzero(&b, sizeof(bench_demod_t));
+  b.nof_symbols = cell.nof_prb * SRSLTE_NRE * 12;
+  b.symbols = srslte_vec_malloc(sizeof(cf_t) * b.nof_symbols);
+  b.llr_s   = srslte_vec_malloc(sizeof(short) * b.nof_symbols * 6);
+  b.llr_b   = srslte_vec_malloc(sizeof(int8_t) * b.nof_symbols * 6);
+  if (!b.symbols || !b.llr_s || !b.llr_b) {
+    perror("srslte_vec_malloc");
+    goto clean_exit;
+  }
+  random_symbols(b.symbols, b.nof_symbols);
+
+  for (uint32_t n = 0; n < 3; n++) {
+    b.mod = mods[n];
+    uint32_t nof_bits = b.nof_symbols * srslte_mod_bits_x_symbol(b.mod);
+    if (bench_run("demod_s", cell.nof_prb, srslte_mod_string(b.mod), nof_bits, run_demod_s, &b) ||
+        bench_run("demod_b", cell.nof_prb, srslte_mod_string(b.mod), nof_bits, run_demod_b, &b)) {
+      goto clean_exit;
+    }
+  }
+  ret = SRSLTE_SUCCESS;
+
+clean_exit:
+  if (b.symbols) {
+    free(b.symbols);
+  }
+  if (b.llr_s) {
+    free(b.llr_s);
+  }
+  if (b.llr_b) {
+    free(b.llr_b);
+  }
+  return ret;
+}
+
+typedef struct {
+  srslte_prach_t prach;
+  cf_t          *signal;
+  uint32_t       indices[64];
+  uint32_t       nof_indices;
+} bench_prach_t;
+
+static int run_prach(void *arg) {
+  bench_prach_t *b = (bench_prach_t *) arg;
+  if (srslte_prach_detect(&b->prach, 0, &b->signal[b->prach.N_cp], b->prach.N_seq, b->indices, &b->nof_indices)) {
+    return SRSLTE_ERROR;
+  }
+  return (b->nof_indices == 1 && b->indices[0] == 0) ? SRSLTE_SUCCESS : SRSLTE_ERROR;
+}
+
+/* Detection of a preamble format 0 at the IFFT size of the bandwidth */
+static int bench_prach(srslte_cell_t cell) {
+  bench_prach_t b;
+  uint32_t N_ifft_ul = (uint32_t) srslte_symbol_sz(cell.nof_prb);
+  int ret = SRSLTE_ERROR;
+
+  bzero(&b, sizeof(bench_prach_t));
+  if (srslte_prach_init(&b.prach, N_ifft_ul) || srslte_prach_set_cell(&b.prach, N_ifft_ul, 3, 0, false, 15)) {
+    fprintf(stderr, "Error initiating PRACH\n");
+    goto clean_exit;
+  }
+  b.signal = srslte_vec_malloc(sizeof(cf_t) * (b.prach.N_cp + b.prach.N_seq));
+  if (!b.signal) {
+    perror("srslte_vec_malloc");
+    goto clean_exit;
+  }
+  bzero(b.signal, sizeof(cf_t) * (b.prach.N_cp + b.prach.N_seq));
+  if (srslte_prach_gen(&b.prach, 0, 0, b.signal)) {
+    fprintf(stderr, "Error generating PRACH\n");
+    goto clean_exit;
+  }
+  if (bench_run("prach_detect", cell.nof_prb, "", 0, run_prach, &b)) {
+    goto clean_exit;
+  }
+  ret = SRSLTE_SUCCESS;
+
+clean_exit:
+  srslte_prach_free(&b.prach);
+  if (b.signal) {
+    free(b.signal);
+  }
+  return ret;
+}
+
+typedef struct {
+  srslte_enb_dl_t         enb_dl;
+  srslte_ue_dl_t          ue_dl;
+  srslte_softbuffer_tx_t *softbuffer_tx[SRSLTE_MAX_CODEWORDS];
+  uint8_t                *data_tx[SRSLTE_MAX_CODEWORDS];
+  uint8_t                *data_rx[SRSLTE_MAX_CODEWORDS];
+  srslte_ra_dl_dci_t      dci;
+  srslte_ra_dl_grant_t    grant;
+  srslte_dci_location_t   location;
+  uint32_t                cfi;
+  uint32_t                sf_idx;
+  uint16_t                rnti;
+} bench_pdsch_t;
+
+static int run_pdsch_tx(void *arg) {
+  bench_pdsch_t *b = (bench_pdsch_t *) arg;
+  int rv[SRSLTE_MAX_CODEWORDS] = {0, 0};
+
+  srslte_enb_dl_clear_sf(&b->enb_dl);
+  srslte_enb_dl_put_base(&b->enb_dl, b->sf_idx);
+  if (srslte_enb_dl_put_pdcch_dl(&b->enb_dl, &b->dci, SRSLTE_DCI_FORMAT1, b->location, rnti, b->sf_idx) < 0) {
+    fprintf(stderr, "Error putting PDCCH\n");
+    return SRSLTE_ERROR;
+  }
+  if (srslte_enb_dl_put_pdsch(&b->enb_dl, &b->grant, b->softbuffer_tx, rnti, rv, b->sf_idx, b->data_tx,
+                              SRSLTE_MIMO_TYPE_SINGLE_ANTENNA) < 0) {
+    fprintf(stderr, "Error putting PDSCH\n");
+    return SRSLTE_ERROR;
+  }
+  srslte_enb_dl_gen_signal(&b->enb_dl);
+  return SRSLTE_SUCCESS;
+}
+
+/* FFT, estimation, PCFICH, PDCCH search and PDSCH decoding */
+static int run_pdsch_rx(void *arg) {
+  bench_pdsch_t *b = (bench_pdsch_t *) arg;
+  bool acks[SRSLTE_MAX_CODEWORDS] = {false, false};
+
+  if (srslte_ue_dl_decode(&b->ue_dl, b->data_rx, 0, b->sf_idx, acks) < 0 || !acks[0]) {
+    return SRSLTE_ERROR;
+  }
+  return memcmp(b->data_tx[0], b->data_rx[0], b->grant.mcs[0].tbs / 8) ? SRSLTE_ERROR : SRSLTE_SUCCESS;
+}
+
+/* Blind search of the UE and common search spaces, on the LLRs of the last decoded subframe */
+static int run_pdcch_found(void *arg) {
+  bench_pdsch_t *b = (bench_pdsch_t *) arg;
+  srslte_dci_msg_t dci_msg;
+  return srslte_ue_dl_find_dl_dci(&b->ue_dl, 0, b->cfi, b->sf_idx, rnti, &dci_msg) == 1 ? SRSLTE_SUCCESS
+                                                                                       : SRSLTE_ERROR;
+}
+
+static int run_pdcch_miss(void *arg) {
+  bench_pdsch_t *b = (bench_pdsch_t *) arg;
+  srslte_dci_msg_t dci_msg;
+  return srslte_ue_dl_find_dl_dci(&b->ue_dl, 0, b->cfi, b->sf_idx, rnti + 1, &dci_msg) == 0 ? SRSLTE_SUCCESS
+                                                                                           : SRSLTE_ERROR;
+}
+
+/* Format 1 allocation of all the RBGs */
+static int bench_pdsch(srslte_cell_t cell) {
+  bench_pdsch_t *b = calloc(1, sizeof(bench_pdsch_t));
+  cf_t *signal_buffer[SRSLTE_MAX_PORTS] = {NULL};
+  int ret = SRSLTE_ERROR;
+
+  if (!b) {
+    perror("calloc");
+    return SRSLTE_ERROR;
+  }
+  signal_buffer[0] = srslte_vec_malloc(sizeof(cf_t) * SRSLTE_SF_LEN_PRB(cell.nof_prb));
+  if (!signal_buffer[0]) {
+    perror("srslte_vec_malloc");
+    goto clean_exit;
+  }
+  for (int i = 0; i < SRSLTE_MAX_CODEWORDS; i++) {
+    b->softbuffer_tx[i] = calloc(1, sizeof(srslte_softbuffer_tx_t));
+    b->data_tx[i] = srslte_vec_malloc(sizeof(uint8_t) * MAX_DATABUFFER_SIZE);
+    b->data_rx[i] = srslte_vec_malloc(sizeof(uint8_t) * MAX_DATABUFFER_SIZE);
+    if (!b->softbuffer_tx[i] || !b->data_tx[i] || !b->data_rx[i]) {
+      perror("srslte_vec_malloc");
+      goto clean_exit;
+    }
+    if (srslte_softbuffer_tx_init(b->softbuffer_tx[i], cell.nof_prb)) {
+      fprintf(stderr, "Error initiating softbuffer_tx\n");
+      goto clean_exit;
+    }
+  }
+
+  b->cfi    = 2;
+  b->sf_idx = 1;
+  if (srslte_enb_dl_init(&b->enb_dl, signal_buffer, cell.nof_prb) || srslte_enb_dl_set_cell(&b->enb_dl, cell)) {
+    fprintf(stderr, "Error initiating eNb downlink\n");
+    goto clean_exit;
+  }
+  srslte_enb_dl_set_cfi(&b->enb_dl, b->cfi);
+  srslte_enb_dl_set_power_allocation(&b->enb_dl, 0.0f, 0.0f);
+
+  if (srslte_ue_dl_init(&b->ue_dl, signal_buffer, cell.nof_prb, 1) || srslte_ue_dl_set_cell(&b->ue_dl, cell)) {
+    fprintf(stderr, "Error initiating UE downlink\n");
+    goto clean_exit;
+  }
+  srslte_ue_dl_set_rnti(&b->ue_dl, rnti);
+
+  srslte_dci_location_t locations[MAX_CANDIDATES_UE];
+  if (srslte_pdcch_ue_locations(&b->enb_dl.pdcch, locations, MAX_CANDIDATES_UE, b->sf_idx, b->cfi, rnti) == 0) {
+    fprintf(stderr, "No PDCCH locations\n");
+    goto clean_exit;
+  }
+  b->location = locations[0];
+
+  for (uint32_t n = 0; n < NOF_PDSCH_MCS; n++) {
+    char param[16];
+
+    bzero(&b->dci, sizeof(srslte_ra_dl_dci_t));
+    b->dci.mcs_idx = pdsch_mcs[n];
+    b->dci.tb_en[0] = true;
+    b->dci.alloc_type = SRSLTE_RA_ALLOC_TYPE0;
+    b->dci.type0_alloc.rbg_bitmask = (1u << (uint32_t) ceilf((float) cell.nof_prb / srslte_ra_type0_P(cell.nof_prb))) - 1;
+    if (srslte_ra_dl_dci_to_grant(&b->dci, cell.nof_prb, rnti, &b->grant)) {
+      fprintf(stderr, "Error computing the DL grant\n");
+      goto clean_exit;
+    }
+    for (uint32_t i = 0; i < MAX_DATABUFFER_SIZE; i++) {
+      b->data_tx[0][i] = (uint8_t) rand();
+    }
+
+    snprintf(param, sizeof(param), "mcs=%d", pdsch_mcs[n]);
+    if (bench_run("pdsch_tx", cell.nof_prb, param, b->grant.mcs[0].tbs, run_pdsch_tx, b) ||
+        bench_run("pdsch_rx", cell.nof_prb, param, b->grant.mcs[0].tbs, run_pdsch_rx, b)) {
+      goto clean_exit;
+    }
+  }
+
+  /* The search needs the LLRs of a decoded subframe */
+  if (bench_selected("pdcch")) {
+    if (run_pdsch_tx(b) || run_pdsch_rx(b)) {
+      fprintf(stderr, "Error decoding PDSCH\n");
+      goto clean_exit;
+    }
+    if (bench_run("pdcch_search", cell.nof_prb, "found", 0, run_pdcch_found, b) ||
+        bench_run("pdcch_search", cell.nof_prb, "miss", 0, run_pdcch_miss, b)) {
+      goto clean_exit;
+    }
+  }
+  ret = SRSLTE_SUCCESS;
+
+clean_exit:
+  srslte_enb_dl_free(&b->enb_dl);
+  srslte_ue_dl_free(&b->ue_dl);
+  for (int i = 0; i < SRSLTE_MAX_CODEWORDS; i++) {
+    if (b->softbuffer_tx[i]) {
+      srslte_softbuffer_tx_free(b->softbuffer_tx[i]);
+      free(b->softbuffer_tx[i]);
+    }
+    if (b->data_tx[i]) {
+      free(b->data_tx[i]);
+    }
+    if (b->data_rx[i]) {
+      free(b->data_rx[i]);
+    }
+  }
+  if (signal_buffer[0]) {
+    free(signal_buffer[0]);
+  }
+  free(b);
+  return ret;
+}
+
+typedef struct {
+  srslte_pusch_t         pusch_tx;
+  srslte_pusch_t         pusch_rx;
+  srslte_refsignal_ul_t  dmrs;
+  srslte_chest_ul_t      chest;
+  srslte_softbuffer_tx_t softbuffer_tx;
+  srslte_softbuffer_rx_t softbuffer_rx;
+  srslte_pusch_cfg_t     cfg;
+  srslte_uci_data_t      uci_data;
+  cf_t                  *sf_symbols;
+  cf_t                  *ce;
+  cf_t                  *r_pusch;
+  uint8_t               *data_tx;
+  uint8_t               *data_rx;
+  uint32_t               sf_idx;
+} bench_pusch_t;
+
+static int run_pusch_tx(void *arg) {
+  bench_pusch_t *b = (bench_pusch_t *) arg;
+
+  srslte_softbuffer_tx_reset(&b->softbuffer_tx);
+  if (srslte_pusch_encode(&b->pusch_tx, &b->cfg, &b->softbuffer_tx, b->data_tx, b->uci_data, rnti, b->sf_symbols)) {
+    return SRSLTE_ERROR;
+  }
+  srslte_refsignal_dmrs_pusch_gen(&b->dmrs, b->cfg.grant.L_prb, b->sf_idx, 0, b->r_pusch);
+  srslte_refsignal_dmrs_pusch_put(&b->dmrs, b->r_pusch, b->cfg.grant.L_prb, b->cfg.grant.n_prb_tilde, b->sf_symbols);
+  return SRSLTE_SUCCESS;
+}
+
+/* Same receiver as srslte_enb_ul_get_pusch() */
+static int run_pusch_rx(void *arg) {
+  bench_pusch_t *b = (bench_pusch_t *) arg;
+
+  srslte_softbuffer_rx_reset(&b->softbuffer_rx);
+  srslte_chest_ul_estimate(&b->chest, b->sf_symbols, b->ce, b->cfg.grant.L_prb, b->sf_idx, 0, b->cfg.grant.n_prb);
+  float noise = srslte_chest_ul_get_noise_estimate(&b->chest);
+  if (srslte_pusch_decode(&b->pusch_rx, &b->cfg, &b->softbuffer_rx, b->sf_symbols, b->ce, noise, rnti,
+                          b->data_rx, NULL, &b->uci_data)) {
+    return SRSLTE_ERROR;
+  }
+  return memcmp(b->data_tx, b->data_rx, b->cfg.grant.mcs.tbs / 8) ? SRSLTE_ERROR : SRSLTE_SUCCESS;
+}
+
+/* Same receiver as srslte_enb_ul_get_pusch() with srslte_enb_ul_set_pusch_fused() */
+static int run_pusch_rx_fused(void *arg) {
+  bench_pusch_t *b = (bench_pusch_t *) arg;
+
+  srslte_softbuffer_rx_reset(&b->softbuffer_rx);
+  srslte_chest_ul_estimate_dmrs(&b->chest, b->sf_symbols, b->cfg.grant.L_prb, b->sf_idx, 0, b->cfg.grant.n_prb_tilde);
+  float noise = srslte_chest_ul_get_noise_estimate(&b->chest);
+  if (srslte_pusch_decode_fused(&b->pusch_rx, &b->cfg, &b->softbuffer_rx, b->sf_symbols, &b->chest, noise, rnti,
+                                b->data_rx, NULL, &b->uci_data)) {
+    return SRSLTE_ERROR;
+  }
+  return memcmp(b->data_tx, b->data_rx, b->cfg.grant.mcs.tbs / 8) ? SRSLTE_ERROR : SRSLTE_SUCCESS;
+}
+
+/* Allocation of the largest valid number of PRB, 64QAM is not supported by the UE category */
+static int bench_pusch(srslte_cell_t cell) {
+  bench_pusch_t *b = calloc(1, sizeof(bench_pusch_t));
+  srslte_refsignal_dmrs_pusch_cfg_t dmrs_cfg;
+  srslte_pusch_hopping_cfg_t ul_hopping;
+  int ret = SRSLTE_ERROR;
+
+  if (!b) {
+    perror("calloc");
+    return SRSLTE_ERROR;
+  }
+  bzero(&dmrs_cfg, sizeof(srslte_refsignal_dmrs_pusch_cfg_t));
+  bzero(&ul_hopping, sizeof(srslte_pusch_hopping_cfg_t));
+  ul_hopping.n_sb = 1;
+  ul_hopping.hop_mode = 1;
+  b->sf_idx = 1;
+
+  if (srslte_pusch_init_ue(&b->pusch_tx, cell.nof_prb) || srslte_pusch_set_cell(&b->pusch_tx, cell) ||
+      srslte_pusch_init_enb(&b->pusch_rx, cell.nof_prb) || srslte_pusch_set_cell(&b->pusch_rx, cell)) {
+    fprintf(stderr, "Error creating PUSCH object\n");
+    goto clean_exit;
+  }
+  if (srslte_refsignal_ul_init(&b->dmrs, cell.nof_prb) || srslte_refsignal_ul_set_cell(&b->dmrs, cell)) {
+    fprintf(stderr, "Error creating DMRS object\n");
+    goto clean_exit;
+  }
+  srslte_refsignal_ul_set_cfg(&b->dmrs, &dmrs_cfg, NULL, NULL);
+  if (srslte_chest_ul_init(&b->chest, cell.nof_prb) || srslte_chest_ul_set_cell(&b->chest, cell)) {
+    fprintf(stderr, "Error initiating UL channel estimator\n");
+    goto clean_exit;
+  }
+  srslte_chest_ul_set_cfg(&b->chest, &dmrs_cfg, NULL, NULL);
+  if (srslte_softbuffer_tx_init(&b->softbuffer_tx, cell.nof_prb) ||
+      srslte_softbuffer_rx_init(&b->softbuffer_rx, cell.nof_prb)) {
+    fprintf(stderr, "Error initiating soft buffer\n");
+    goto clean_exit;
+  }
+  srslte_pusch_set_rnti(&b->pusch_tx, rnti);
+  srslte_pusch_set_rnti(&b->pusch_rx, rnti);
+
+  uint32_t nof_re = SRSLTE_SF_LEN_RE(cell.nof_prb, cell.cp);
+  b->sf_symbols = srslte_vec_malloc(sizeof(cf_t) * nof_re);
+  b->ce         = srslte_vec_malloc(sizeof(cf_t) * nof_re);
+  b->r_pusch    = srslte_vec_malloc(sizeof(cf_t) * 2 * SRSLTE_NRE * cell.nof_prb);
+  b->data_tx    = srslte_vec_malloc(sizeof(uint8_t) * MAX_DATABUFFER_SIZE);
+  b->data_rx    = srslte_vec_malloc(sizeof(uint8_t) * MAX_DATABUFFER_SIZE);
+  if (!b->sf_symbols || !b->ce || !b->r_pusch || !b->data_tx || !b->data_rx) {
+    perror("srslte_vec_malloc");
+    goto clean_exit;
+  }
+  bzero(b->sf_symbols, sizeof(cf_t) * nof_re);
+
+  uint32_t L_prb = cell.nof_prb;
+  while (!srslte_dft_precoding_valid_prb(L_prb)) {
+    L_prb--;
+  }
+
+  for (uint32_t n = 0; n < NOF_PUSCH_MCS; n++) {
+    srslte_ra_ul_dci_t dci;
+    srslte_ra_ul_grant_t grant;
+    char param[16];
+
+    bzero(&dci, sizeof(srslte_ra_ul_dci_t));
+    dci.freq_hop_fl = -1;
+    dci.type2_alloc.L_crb = L_prb;
+    dci.type2_alloc.RB_start = 0;
+    dci.mcs_idx = pusch_mcs[n];
+    if (srslte_ra_ul_dci_to_grant(&dci, cell.nof_prb, 0, &grant)) {
+      fprintf(stderr, "Error computing the UL grant\n");
+      goto clean_exit;
+    }
+    if (grant.mcs.mod == SRSLTE_MOD_64QAM) {
+      grant.mcs.mod = SRSLTE_MOD_16QAM;
+      grant.Qm = 4;
+    }
+    if (srslte_pusch_cfg(&b->pusch_tx, &b->cfg, &grant, NULL, &ul_hopping, NULL, b->sf_idx, 0, 0)) {
+      fprintf(stderr, "Error configuring PUSCH\n");
+      goto clean_exit;
+    }
+    for (uint32_t i = 0; i < MAX_DATABUFFER_SIZE; i++) {
+      b->data_tx[i] = (uint8_t) rand();
+    }
+
+    snprintf(param, sizeof(param), "mcs=%d", pusch_mcs[n]);
+    if (bench_run("pusch_tx", cell.nof_prb, param, b->cfg.grant.mcs.tbs, run_pusch_tx, b)) {
+      goto clean_exit;
+    }
+    if (bench_selected("pusch_rx") || bench_selected("pusch_rx_fused")) {
+      /* The transmitter may not have run */
+      if (run_pusch_tx(b) ||
+          bench_run("pusch_rx", cell.nof_prb, param, b->cfg.grant.mcs.tbs, run_pusch_rx, b) ||
+          bench_run("pusch_rx_fused", cell.nof_prb, param, b->cfg.grant.mcs.tbs, run_pusch_rx_fused, b)) {
+        goto clean_exit;
+      }
+    }
+  }
+  ret = SRSLTE_SUCCESS;
+
+clean_exit:
+  srslte_pusch_free(&b->pusch_tx);
+  srslte_pusch_free(&b->pusch_rx);
+  srslte_refsignal_ul_free(&b->dmrs);
+  srslte_chest_ul_free(&b->chest);
+  srslte_softbuffer_tx_free(&b->softbuffer_tx);
+  srslte_softbuffer_rx_free(&b->softbuffer_rx);
+  if (b->sf_symbols) {
+    free(b->sf_symbols);
+  }
+  if (b->ce) {
+    free(b->ce);
+  }
+  if (b->r_pusch) {
+    free(b->r_pusch);
+  }
+  if (b->data_tx) {
+    free(b->data_tx);
+  }
+  if (b->data_rx) {
+    free(b->data_rx);
+  }
+  free(b);
+  return ret;
+}
+
+/*******************************************************************************
+                                   OUTPUT
+*******************************************************************************/
+
+static char host_name[64];
+static char host_info[256];
+static char cpu_info[128];
+
+static void get_host_info() {
+  struct utsname u;
+
+  if (gethostname(host_name, sizeof(host_name))) {
+    snprintf(host_name, sizeof(host_name), "unknown");
+  }
+  host_name[sizeof(host_name) - 1] = '\0';
+  if (uname(&u)) {
+    snprintf(host_info, sizeof(host_info), "unknown");
+  } else {
+    snprintf(host_info, sizeof(host_info), "%s %s %s", u.sysname, u.release, u.machine);
+  }
+  srslte_cpu_isa_info(cpu_info, sizeof(cpu_info));
+}
+
+static void print_csv() {
+  printf("# srsLTE %s, %s, %s\n", srslte_get_version(), srslte_get_build_info(), srslte_get_build_mode());
+  printf("# host %s, %s\n", host_name, host_info);
+  printf("# %s\n", cpu_info);
+  printf("kernel,nof_prb,param,iterations,avg_us,min_us,mbps\n");
+  for (uint32_t i = 0; i < nof_results; i++) {
+    bench_result_t *r = &results[i];
+    printf("%s,%d,%s,%d,%.3f,%.3f,%.3f\n", r->kernel, r->nof_prb, r->param, r->iterations,
+           r->avg_us, r->min_us, r->mbps);
+  }
+}
+
+static void print_json() {
+  printf("{\n");
+  printf("  \"version\": \"%s\",\n", srslte_get_version());
+  printf("  \"build\": \"%s\",\n", srslte_get_build_info());
+  printf("  \"build_mode\": \"%s\",\n", srslte_get_build_mode());
+  printf("  \"host\": \"%s\",\n", host_name);
+  printf("  \"system\": \"%s\",\n", host_info);
+  printf("  \"cpu\": \"%s\",\n", cpu_info);
+  printf("  \"results\": [\n");
+  for (uint32_t i = 0; i < nof_results; i++) {
+    bench_result_t *r = &results[i];
+    printf("    {\"kernel\": \"%s\", \"nof_prb\": %d, \"param\": \"%s\", \"iterations\": %d, "
+           "\"avg_us\": %.3f, \"min_us\": %.3f, \"mbps\": %.3f}%s\n",
+           r->kernel, r->nof_prb, r->param, r->iterations, r->avg_us, r->min_us, r->mbps,
+           i + 1 < nof_results ? "," : "");
+  }
+  printf("  ]\n");
+  printf("}\n");
+}
+
+/* Compares the minimum time of each kernel with a CSV written by an earlier run.
+ * Returns the number of regressions */
+static int compare_baseline(const char *filename) {
+  char line[256];
+  int nof_regressions = 0;
+  uint32_t nof_compared = 0;
+
+  FILE *f = fopen(filename, "r");
+  if (!f) {
+    perror(filename);
+    return -1;
+  }
+  while (fgets(line, sizeof(line), f)) {
+    char kernel[32], param[16] = "";
+    uint32_t prb, iterations;
+    double avg_us, min_us;
+
+    if (line[0] == '#' || !strncmp(line, "kernel,", 7)) {
+      continue;
+    }
+    /* param may be empty */
+    char *p = line;
+    char *fields[7];
+    uint32_t nof_fields = 0;
+    while (nof_fields < 7 && (fields[nof_fields] = strsep(&p, ",\n")) != NULL) {
+      nof_fields++;
+    }
+    if (nof_fields < 6) {
+      continue;
+    }
+    snprintf(kernel, sizeof(kernel), "%s", fields[0]);
+    prb = (uint32_t) atoi(fields[1]);
+    snprintf(param, sizeof(param), "%s", fields[2]);
+    iterations = (uint32_t) atoi(fields[3]);
+    avg_us = atof(fields[4]);
+    min_us = atof(fields[5]);
+
+    for (uint32_t i = 0; i < nof_results; i++) {
+      bench_result_t *r = &results[i];
+      if (r->nof_prb == prb && !strcmp(r->kernel, kernel) && !strcmp(r->param, param)) {
+        double change = min_us > 0 ? 100 * (r->min_us - min_us) / min_us : 0;
+        nof_compared++;
+        if (change > threshold) {
+          fprintf(stderr, "Regression: %s nof_prb=%d %s min %.2f us, baseline %.2f us (%+.1f%%, %d iterations)\n",
+                  kernel, prb, param, r->min_us, min_us, change, iterations);
+          nof_regressions++;
+        } else if (srslte_verbose) {
+          fprintf(stderr, "%s nof_prb=%d %s avg %.1f us, baseline %.1f us (%+.1f%%)\n",
+                  kernel, prb, param, r->avg_us, avg_us, change);
+        }
+      }
+    }
+  }
+  fclose(f);
+
+  fprintf(stderr, "Compared %d results with %s: %d regressions above %.0f%%\n",
+          nof_compared, filename, nof_regressions, threshold);
+  return nof_regressions;
+}
+
+int main(int argc, char **argv) {
+  int ret = SRSLTE_ERROR;
+
+  parse_args(argc, argv);
+  get_host_info();
+  srslte_dft_load();
+
+  if (!csv_output && !json_output) {
+    printf("srsLTE %s, %s, %s\n", srslte_get_version(), srslte_get_build_info(), srslte_get_build_mode());
+    printf("%s, %s\n", host_name, host_info);
+    printf("%s\n\n", cpu_info);
+    printf("%-16s %8s %10s %10s %10s %10s\n", "kernel", "nof_prb", "param", "avg_us", "min_us", "Mbps");
+  }
+
+  if (bench_tdec() || bench_viterbi() || bench_rm()) {
+    goto clean_exit;
+  }
+  for (uint32_t i = 0; i < NOF_BENCH_PRB; i++) {
+    if (nof_prb && i > 0) {
+      break;
+    }
+    srslte_cell_t cell = bench_cell(nof_prb ? nof_prb : bench_prb[i]);
+    if (bench_ofdm(cell) || bench_chest_dl(cell) || bench_chest_ul(cell) || bench_demod(cell) ||
+        bench_prach(cell) || bench_pdsch(cell) || bench_pusch(cell)) {
+      goto clean_exit;
+    }
+  }
+
+  if (csv_output) {
+    print_csv();
+  }
+  if (json_output) {
+    print_json();
+  }
+  ret = SRSLTE_SUCCESS;
+
+  if (baseline_file && compare_baseline(baseline_file) != 0) {
+    ret = SRSLTE_ERROR;
+  }
+
+clean_exit:
+  srslte_dft_exit();
+  srslte_rm_turbo_free_tables();
+  if (!csv_output && !json_output) {
+    printf("%s\n", ret ? "Error" : "Ok");
+  }
+  exit(ret);
+}
@@ -121,6 +121,11 @@ typedef struct {
   bool          enable;
 }gui_args_t;
 
+typedef struct {
+  bool          enable;
+  std::string   phy_filename;
+}trace_args_t;
+
 typedef struct {
   phy_args_t phy; 
   mac_args_t mac; 
@@ -139,6 +144,7 @@ typedef struct {
   pcap_args_t   pcap;
   log_args_t    log;
   gui_args_t    gui;
+  trace_args_t  trace;
   expert_args_t expert;
 }all_args_t;
 
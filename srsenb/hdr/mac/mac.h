@@ -52,6 +52,8 @@ public:
 typedef struct {
   sched_interface::sched_args_t sched; 
   int link_failure_nof_err; 
+  uint32_t ul_softbuffer_pool_mb;  // 0 preallocates the UL softbuffers of every HARQ process
+  bool ul_softbuffer_8bit;
 } mac_args_t; 
 
 class mac
@@ -177,6 +179,10 @@ private:
   srslte_softbuffer_tx_t bcch_softbuffer_tx[NOF_BCCH_DLSCH_MSG];
   srslte_softbuffer_tx_t pcch_softbuffer_tx;
   srslte_softbuffer_tx_t rar_softbuffer_tx;
+
+  // Storage for the UL softbuffers of all users
+  srslte_softbuffer_pool_t ul_softbuffer_pool;
+  srslte_softbuffer_pool_t* get_ul_softbuffer_pool();
   
   const static int mcch_payload_len = 3000; //TODO FIND OUT MAX LENGTH
   int current_mcch_length;
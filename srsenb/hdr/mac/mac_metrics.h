@@ -27,6 +27,7 @@
 #ifndef SRSENB_MAC_METRICS_H
 #define SRSENB_MAC_METRICS_H
 
+#include "srslte/phy/fec/softbuffer.h"
 
 namespace srsenb {
 
@@ -47,6 +48,7 @@ struct mac_metrics_t
   float dl_ri;
   float dl_pmi;
   float phr; 
+  srslte_softbuffer_pool_metrics_t ul_softbuffer; // Common to all users
 };
 
 } // namespace srsenb
@@ -29,6 +29,7 @@
 
 #include "srslte/common/log.h"
 #include "srslte/common/pdu.h"
+#include "srslte/common/sch_pdu_codec.h"
 #include "srslte/common/mac_pcap.h"
 #include "srslte/common/pdu_queue.h"
 #include "srslte/interfaces/enb_interfaces.h"
@@ -86,7 +87,9 @@ public:
   void     start_pcap(srslte::mac_pcap* pcap_);
   void     set_tti(uint32_t tti); 
   
-  void     config(uint16_t rnti, uint32_t nof_prb, sched_interface *sched, rrc_interface_mac *rrc_, rlc_interface_mac *rlc, srslte::log *log_h);
+  // If rx_pool is not NULL the UL softbuffers take their storage from it
+  void     config(uint16_t rnti, uint32_t nof_prb, sched_interface *sched, rrc_interface_mac *rrc_, rlc_interface_mac *rlc, srslte::log *log_h,
+                  srslte_softbuffer_pool_t *rx_pool = NULL);
   uint8_t* generate_pdu(uint32_t tb_idx, sched_interface::dl_sched_pdu_t pdu[sched_interface::MAX_RLC_PDU_LIST],
                     uint32_t nof_pdu_elems, uint32_t grant_size);
   uint8_t* generate_mch_pdu(sched_interface::dl_pdu_mch_t sched, uint32_t nof_pdu_elems, uint32_t grant_size);
@@ -118,9 +121,9 @@ public:
   int  read_pdu(uint32_t lcid, uint8_t *payload, uint32_t requested_bytes); 
 private: 
     
-  void allocate_sdu(srslte::sch_pdu *pdu, uint32_t lcid, uint32_t sdu_len);   
-  bool process_ce(srslte::sch_subh *subh); 
-  void allocate_ce(srslte::sch_pdu *pdu, uint32_t lcid);
+  void allocate_sdu(srslte::sch_pdu_encoder *pdu, uint32_t lcid, uint32_t sdu_len);   
+  bool process_ce(srslte::sch_pdu_elem *subh); 
+  void allocate_ce(srslte::sch_pdu_encoder *pdu, uint32_t lcid);
 
   std::vector<uint32_t> lc_groups[4];
 
@@ -152,7 +155,8 @@ private:
   
   // For UL there are multiple buffers per PID and are managed by pdu_queue
   srslte::pdu_queue pdus; 
-  srslte::sch_pdu mac_msg_dl, mac_msg_ul;
+  srslte::sch_pdu_encoder mac_msg_dl;
+  srslte::sch_pdu_decoder mac_msg_ul;
   srslte::mch_pdu mch_mac_msg_dl;
   
   rlc_interface_mac *rlc; 
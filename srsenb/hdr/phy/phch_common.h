@@ -33,8 +33,10 @@
 #include "srslte/interfaces/enb_metrics_interface.h"
 #include "srslte/common/gen_mch_tables.h"
 #include "srslte/common/log.h"
+#include "srslte/common/phy_trace.h"
 #include "srslte/common/threads.h"
 #include "srslte/common/thread_pool.h"
+#include "srslte/common/tx_reorder.h"
 #include "srslte/radio/radio.h"
 #include <string.h>
 
@@ -44,11 +46,14 @@ typedef struct {
   float max_prach_offset_us; 
   int pusch_max_its;
   bool pusch_8bit_decoder;
+  bool pusch_fused;
   float tx_amplitude; 
   int nof_phy_threads;  
   std::string equalizer_mode; 
   float estimator_fil_w;   
   bool       pregenerate_signals;
+  bool       c16_samples;
+  uint32_t   rf_batch_sf;
 } phy_args_t; 
 
 typedef enum{
@@ -71,7 +76,7 @@ typedef struct {
 
 
 
-class phch_common
+class phch_common : public srslte::tx_reorder_handler
 {
 public:
  
@@ -81,11 +86,26 @@ public:
 
   void set_nof_workers(uint32_t nof_workers);
 
-  bool init(srslte_cell_t *cell, srslte::radio *radio_handler, mac_interface_phy *mac);  
+  bool init(srslte_cell_t *cell, srslte::radio *radio_handler, mac_interface_phy *mac, int tx_prio);
   void reset(); 
   void stop();
   
-  void worker_end(uint32_t tx_mutex_cnt, cf_t *buffer[SRSLTE_MAX_PORTS], uint32_t nof_samples, srslte_timestamp_t tx_time);
+  void worker_end(uint32_t tx_seq, cf_t *buffer[SRSLTE_MAX_PORTS], uint32_t nof_samples, srslte_timestamp_t tx_time,
+                  srslte::phy_trace *trace = NULL);
+  void worker_end_c16(uint32_t tx_seq, c16_t *buffer[SRSLTE_MAX_PORTS], uint32_t nof_samples, srslte_timestamp_t tx_time,
+                      srslte::phy_trace *trace = NULL);
+
+  // Transmits the subframes in sequence, from the tx thread
+  void tx_slot(uint32_t seq, srslte::tx_reorder_slot_t *slot);
+
+  /* Radio batching. txrx announces each batch of subframes it receives in one radio call, and the
+   * same subframes are then transmitted in one radio call as well */
+  void     rf_batch_start(uint32_t nof_sf);
+  uint32_t get_rf_batch_len();
+
+  // Late subframes, counted by the workers and by the radio error handler
+  void     late_sf();
+  uint32_t get_nof_late();
 
   // Common objects
   srslte_cell_t                     cell; 
@@ -137,8 +157,7 @@ public:
   
 
 private:
-  std::vector<sem_t>    tx_sem;
-  bool            is_first_tx;
+  srslte::tx_reorder tx_queue;
   bool            is_first_of_burst; 
 
   uint32_t        nof_workers;
@@ -157,6 +176,21 @@ private:
   bool is_mcch_subframe(subframe_cfg_t *cfg, uint32_t phy_tti);
 
   void add_rnti(uint16_t rnti);
+
+  void worker_end(void *buffer[SRSLTE_MAX_PORTS], bool c16, uint32_t tx_seq, uint32_t nof_samples, srslte_timestamp_t tx_time,
+                  srslte::phy_trace *trace);
+
+  const static uint32_t RF_BATCH_QUEUE_SZ = 16;
+  pthread_mutex_t     rf_batch_mutex;
+  uint32_t            rf_batch_queue[RF_BATCH_QUEUE_SZ];
+  uint32_t            rf_batch_wpm;
+  uint32_t            rf_batch_rpm;
+  uint32_t            rf_batch_len;
+  void               *tx_batch_buffer[SRSLTE_MAX_PORTS];
+  uint32_t            tx_batch_len;
+  uint32_t            tx_batch_idx;
+  srslte_timestamp_t  tx_batch_time;
+  uint32_t            nof_late;
   
 };
 
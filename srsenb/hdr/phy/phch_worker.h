@@ -30,6 +30,7 @@
 #include <string.h>
 
 #include "srslte/srslte.h"
+#include "srslte/common/phy_trace.h"
 #include "phch_common.h"
 
 #define LOG_EXECTIME
@@ -46,7 +47,8 @@ public:
   void  reset();
   
   cf_t *get_buffer_rx(uint32_t antenna_idx);
-  void set_time(uint32_t tti, uint32_t tx_worker_cnt, srslte_timestamp_t tx_time);
+  c16_t *get_buffer_rx_c16(uint32_t antenna_idx);
+  void set_time(uint32_t tti, uint32_t tx_seq, srslte_timestamp_t tx_time);
   
   int  add_rnti(uint16_t rnti);
   void rem_rnti(uint16_t rnti);
@@ -67,8 +69,14 @@ public:
                             LIBLTE_RRC_PHYSICAL_CONFIG_DEDICATED_STRUCT* dedicated);
   
   uint32_t get_metrics(phy_metrics_t metrics[ENB_METRICS_MAX_USERS]);
-  
+  void get_proc_metrics(srslte::phy_proc_metrics_t *m);
+
+  void start_trace();
+  srslte::phy_trace* get_trace();
+
 private: 
+
+  const static uint32_t TRACE_NOF_EVENTS = 65536;
   
   const static float PUSCH_RL_SNR_DB_TH = 1.0; 
   const static float PUCCH_RL_CORR_TH = 0.15;
@@ -92,14 +100,19 @@ private:
 
   cf_t          *signal_buffer_rx[SRSLTE_MAX_PORTS];
   cf_t          *signal_buffer_tx[SRSLTE_MAX_PORTS];
+  // Buffers exchanged with the radio when it runs with complex int16 samples
+  c16_t         *signal_buffer_rx_c16[SRSLTE_MAX_PORTS];
+  c16_t         *signal_buffer_tx_c16[SRSLTE_MAX_PORTS];
   uint32_t       tti_rx, tti_tx_dl, tti_tx_ul;
   uint32_t       sf_rx, sf_tx;
   uint32_t       t_rx, t_tx_dl, t_tx_ul;
-  uint32_t       tx_worker_cnt;
+  uint32_t       tx_seq;
   srslte_enb_dl_t enb_dl;
   srslte_enb_ul_t enb_ul;
   srslte_softbuffer_tx_t temp_mbsfn_softbuffer;
   srslte_timestamp_t tx_time;
+  srslte::phy_trace trace;
+  uint32_t       rf_batch_len;
 
   // Class to store user information 
   class ue {
@@ -75,6 +75,12 @@ public:
   void set_config_dedicated(uint16_t rnti, LIBLTE_RRC_PHYSICAL_CONFIG_DEDICATED_STRUCT* dedicated);
   
   void get_metrics(phy_metrics_t metrics[ENB_METRICS_MAX_USERS]);
+
+  void start_trace();
+  void write_trace(std::string filename);
+
+  // Called by the radio error handler on late and underflow events
+  void radio_late();
   
 private:
   phy_rrc_cfg_t phy_rrc_config;
@@ -85,6 +91,7 @@ private:
   
   const static int PRACH_WORKER_THREAD_PRIO = 3;
   const static int SF_RECV_THREAD_PRIO = 1;
+  const static int TX_THREAD_PRIO = 1;
   const static int WORKERS_THREAD_PRIO = 2;
   
   srslte::radio         *radio_handler;
@@ -27,6 +27,7 @@
 #ifndef SRSENB_PHY_METRICS_H
 #define SRSENB_PHY_METRICS_H
 
+#include "srslte/common/phy_trace.h"
 
 namespace srsenb {
 
@@ -52,6 +53,7 @@ struct phy_metrics_t
 {
   dl_metrics_t   dl;
   ul_metrics_t   ul;
+  srslte::phy_proc_metrics_t proc; // Common to all users
 };
 
 } // namespace srsenb
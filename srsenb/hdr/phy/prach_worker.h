@@ -52,6 +52,7 @@ public:
   
   int  init(srslte_cell_t *cell, srslte_prach_cfg_t *prach_cfg, mac_interface_phy *mac, srslte::log *log_h, int priority);
   int  new_tti(uint32_t tti, cf_t *buffer);
+  int  new_tti_c16(uint32_t tti, c16_t *buffer);
   void set_max_prach_offset_us(float delay_us);
   void stop();
   
@@ -88,6 +89,7 @@ private:
 
   void run_thread();
   int run_tti(sf_buffer *b);
+  int save_samples(uint32_t tti, cf_t *buffer, c16_t *buffer_c16);
 
 
 };
@@ -42,6 +42,7 @@ class txrx : public thread
 {
 public:
   txrx();
+  ~txrx();
   bool init(srslte::radio *radio_handler, 
             srslte::thread_pool *_workers_pool, 
             phch_common *worker_com, 
@@ -53,6 +54,11 @@ public:
 private:
     
   void run_thread(); 
+  bool rx_batch(uint32_t nof_samples, srslte_timestamp_t *rx_time);
+  void adapt_rf_batch();
+
+  // A batch is shortened after a late subframe and grown back after this many subframes in time
+  const static uint32_t RF_BATCH_GROW_SF = 1000;
   
   srslte::radio        *radio_h;
   srslte::log          *log_h;
@@ -63,8 +69,15 @@ private:
   // Main system TTI counter   
   uint32_t tti;
 
-  uint32_t tx_worker_cnt;
+  // Sequence number of the subframes in the transmission queue, wraps freely
+  uint32_t tx_seq;
   uint32_t nof_workers;
+
+  // Radio batching
+  void    *rx_batch_buffer[SRSLTE_MAX_PORTS];
+  uint32_t rf_batch_len;
+  uint32_t rf_batch_nof_late;
+  uint32_t rf_batch_in_time;
   
   bool running; 
 };
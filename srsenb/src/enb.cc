@@ -27,6 +27,7 @@
 #include <boost/algorithm/string.hpp>
 #include "srsenb/hdr/enb.h"
 #include "srslte/build_info.h"
+#include "srslte/phy/utils/cpu_features.h"
 #include <iostream>
 #include <sstream>
 
@@ -245,6 +246,10 @@ bool enb::init(all_args_t *args_)
 
   // Init all layers   
   phy.init(&args->expert.phy, &phy_cfg, &radio, &mac, phy_log);
+  if (args->trace.enable) {
+    phy.start_trace();
+  }
+  args->expert.mac.ul_softbuffer_8bit = args->expert.phy.pusch_8bit_decoder;
   mac.init(&args->expert.mac, &cell_cfg, &phy, &rlc, &rrc, &mac_log);
   rlc.init(&pdcp, &rrc, &mac, &mac, &rlc_log);
   pdcp.init(&rlc, &rrc, &gtpu, &pdcp_log);
@@ -280,6 +285,10 @@ void enb::stop()
     {
        mac_pcap.close();
     }
+    if(args->trace.enable)
+    {
+      phy.write_trace(args->trace.phy_filename);
+    }
     radio.stop();
     started = false;
   }
@@ -324,10 +333,12 @@ void enb::handle_rf_msg(srslte_rf_error_t error)
     rf_metrics.rf_u++;
     rf_metrics.rf_error = true;
     rf_log.warning("Underflow\n");
+    phy.radio_late();
   } else if(error.type == srslte_rf_error_t::SRSLTE_RF_ERROR_LATE) {
     rf_metrics.rf_l++;
     rf_metrics.rf_error = true;
     rf_log.warning("Late\n");
+    phy.radio_late();
   } else if (error.type == srslte_rf_error_t::SRSLTE_RF_ERROR_OTHER) {
     std::string str(error.msg);
     str.erase(std::remove(str.begin(), str.end(), '\n'), str.end());
@@ -371,7 +382,10 @@ std::string enb::get_build_info()
 std::string enb::get_build_string()
 {
   std::stringstream ss;
+  char isa_info[128];
+  srslte_cpu_isa_info(isa_info, sizeof(isa_info));
   ss << "Built in " << get_build_mode() << " mode using " << get_build_info() << "." << std::endl;
+  ss << isa_info << "." << std::endl;
   return ss.str();
 }
 
@@ -62,6 +62,7 @@ mac::mac() : timers_db(128), timers_thread(&timers_db), tti(0), last_rnti(0),
   bzero(&bcch_softbuffer_tx, sizeof(bcch_softbuffer_tx));
   bzero(&pcch_softbuffer_tx, sizeof(pcch_softbuffer_tx));
   bzero(&rar_softbuffer_tx, sizeof(rar_softbuffer_tx));
+  bzero(&ul_softbuffer_pool, sizeof(ul_softbuffer_pool));
 }
   
 bool mac::init(mac_args_t *args_, srslte_cell_t *cell_, phy_interface_mac *phy, rlc_interface_mac *rlc, rrc_interface_mac *rrc, srslte::log *log_h_)
@@ -94,6 +95,14 @@ bool mac::init(mac_args_t *args_, srslte_cell_t *cell_, phy_interface_mac *phy,
     // Init softbuffer for RAR 
     srslte_softbuffer_tx_init(&rar_softbuffer_tx, cell.nof_prb);
 
+    // Init shared storage for UL softbuffers
+    if (args.ul_softbuffer_pool_mb) {
+      if (srslte_softbuffer_pool_init(&ul_softbuffer_pool, args.ul_softbuffer_pool_mb*1024*1024, args.ul_softbuffer_8bit)) {
+        log_h->console("Error initiating UL softbuffer pool of %d MB\n", args.ul_softbuffer_pool_mb);
+        return false;
+      }
+    }
+
     reset();
 
     pthread_rwlock_init(&rwlock, NULL);
@@ -108,9 +117,11 @@ void mac::stop()
 {
   pthread_rwlock_wrlock(&rwlock);
 
-  for (uint32_t i=0;i<ue_db.size();i++) {
-    delete ue_db[i];
+  for(std::map<uint16_t, ue*>::iterator iter=ue_db.begin(); iter!=ue_db.end(); ++iter) {
+    delete iter->second;
   }
+  ue_db.clear();
+  srslte_softbuffer_pool_free(&ul_softbuffer_pool);
   for (int i=0;i<NOF_BCCH_DLSCH_MSG;i++) {
     srslte_softbuffer_tx_free(&bcch_softbuffer_tx[i]);
   }
@@ -274,14 +285,22 @@ int mac::cell_cfg(sched_interface::cell_cfg_t* cell_cfg)
   return scheduler.cell_cfg(cell_cfg);
 }
 
+srslte_softbuffer_pool_t* mac::get_ul_softbuffer_pool()
+{
+  return args.ul_softbuffer_pool_mb ? &ul_softbuffer_pool : NULL;
+}
+
 void mac::get_metrics(mac_metrics_t metrics[ENB_METRICS_MAX_USERS])
 {
   pthread_rwlock_rdlock(&rwlock);
+  srslte_softbuffer_pool_metrics_t ul_softbuffer;
+  srslte_softbuffer_pool_get_metrics(&ul_softbuffer_pool, &ul_softbuffer);
   int cnt=0;
   for(std::map<uint16_t, ue*>::iterator iter=ue_db.begin(); iter!=ue_db.end(); ++iter) {
     ue *u = iter->second;
     if(iter->first != SRSLTE_MRNTI) {
       u->metrics_read(&metrics[cnt]);
+      metrics[cnt].ul_softbuffer = ul_softbuffer;
       cnt++;
     }
   }
@@ -478,7 +497,7 @@ int mac::rach_detected(uint32_t tti, uint32_t preamble_idx, uint32_t time_adv)
 
   // Create new UE
   ue_db[last_rnti] = new ue;
-  ue_db[last_rnti]->config(last_rnti, cell.nof_prb, &scheduler, rrc_h, rlc_h, log_h);
+  ue_db[last_rnti]->config(last_rnti, cell.nof_prb, &scheduler, rrc_h, rlc_h, log_h, get_ul_softbuffer_pool());
 
   // Set PCAP if available
   if (pcap) {
@@ -817,7 +836,7 @@ int mac::get_ul_sched(uint32_t tti, ul_sched_t *ul_sched_res)
 
         ul_sched_res->sched_grants[n].softbuffer = ue_db[rnti]->get_rx_softbuffer(tti);
 
-        if (sched_result.pusch[n].current_tx_nb == 0) {
+        if (sched_result.pusch[i].current_tx_nb == 0) {
           srslte_softbuffer_rx_reset_tbs(ul_sched_res->sched_grants[n].softbuffer, sched_result.pusch[i].tbs*8);
         }
         ul_sched_res->sched_grants[n].data = ue_db[rnti]->request_buffer(tti, sched_result.pusch[i].tbs);
@@ -985,7 +1004,7 @@ void mac::write_mcch(LIBLTE_RRC_SYS_INFO_BLOCK_TYPE_2_STRUCT *sib2, LIBLTE_RRC_S
   current_mcch_length =  current_mcch_length + rlc_header_len;
   srslte_bit_pack_vector(&bitbuffer.msg[0], &mcch_payload_buffer[rlc_header_len], bitbuffer.N_bits);
   ue_db[SRSLTE_MRNTI] = new ue;
-  ue_db[SRSLTE_MRNTI]->config(SRSLTE_MRNTI, cell.nof_prb, &scheduler, rrc_h, rlc_h, log_h);
+  ue_db[SRSLTE_MRNTI]->config(SRSLTE_MRNTI, cell.nof_prb, &scheduler, rrc_h, rlc_h, log_h, get_ul_softbuffer_pool());
 
   rrc_h->add_user(SRSLTE_MRNTI);
 }
@@ -38,7 +38,8 @@
 
 namespace srsenb {
   
-void ue::config(uint16_t rnti_, uint32_t nof_prb, sched_interface *sched_, rrc_interface_mac *rrc_, rlc_interface_mac *rlc_, srslte::log *log_h_)
+void ue::config(uint16_t rnti_, uint32_t nof_prb, sched_interface *sched_, rrc_interface_mac *rrc_, rlc_interface_mac *rlc_, srslte::log *log_h_,
+                srslte_softbuffer_pool_t *rx_pool)
 {
   rnti  = rnti_; 
   rlc   = rlc_; 
@@ -48,7 +49,11 @@ void ue::config(uint16_t rnti_, uint32_t nof_prb, sched_interface *sched_, rrc_i
   pdus.init(this, log_h);
   
   for (int i=0;i<NOF_HARQ_PROCESSES;i++) {
-    srslte_softbuffer_rx_init(&softbuffer_rx[i], nof_prb);
+    if (rx_pool) {
+      srslte_softbuffer_rx_init_pool(&softbuffer_rx[i], nof_prb, rx_pool);
+    } else {
+      srslte_softbuffer_rx_init(&softbuffer_rx[i], nof_prb);
+    }
     srslte_softbuffer_tx_init(&softbuffer_tx[i], nof_prb);
   }
   // don't need to reset because just initiated the buffers
@@ -143,8 +148,7 @@ void ue::set_tti(uint32_t tti) {
 void ue::process_pdu(uint8_t* pdu, uint32_t nof_bytes, srslte::pdu_queue::channel_t channel, uint32_t tstamp)
 {
   // Unpack ULSCH MAC PDU 
-  mac_msg_ul.init_rx(nof_bytes, true);
-  mac_msg_ul.parse_packet(pdu);
+  bool valid_pdu = mac_msg_ul.parse_packet(pdu, nof_bytes, true);
 
   if (pcap) {
     pcap->write_ul_crnti(pdu, nof_bytes, rnti, true, last_tti);
@@ -152,6 +156,11 @@ void ue::process_pdu(uint8_t* pdu, uint32_t nof_bytes, srslte::pdu_queue::channe
 
   pdus.deallocate(pdu);
 
+  if (!valid_pdu) {
+    Error("Received malformed MAC PDU from rnti=0x%x, %d bytes\n", rnti, nof_bytes);
+    return;
+  }
+
   uint32_t lcid_most_data = 0;
   int most_data = -99;
   
@@ -259,7 +268,7 @@ void ue::push_pdu(uint32_t tti, uint32_t len)
   }
 }
 
-bool ue::process_ce(srslte::sch_subh *subh) {
+bool ue::process_ce(srslte::sch_pdu_elem *subh) {
   uint32_t buff_size[4] = {0, 0, 0, 0};
   float phr = 0;
   int32_t idx = 0;
@@ -324,41 +333,32 @@ int ue::read_pdu(uint32_t lcid, uint8_t *payload, uint32_t requested_bytes)
   return rlc->read_pdu(rnti, lcid, payload, requested_bytes);  
 }
 
-void ue::allocate_sdu(srslte::sch_pdu *pdu, uint32_t lcid, uint32_t total_sdu_len) 
+void ue::allocate_sdu(srslte::sch_pdu_encoder *pdu, uint32_t lcid, uint32_t total_sdu_len) 
 {
   int sdu_space = pdu->get_sdu_space();
   if (sdu_space > 0) {
     int sdu_len = SRSLTE_MIN(total_sdu_len, (uint32_t) sdu_space);
     int n=1;
     while(sdu_len > 3 && n > 0) {
-      if (pdu->new_subh()) { // there is space for a new subheader
-        log_h->debug("SDU:   set_sdu(), lcid=%d, sdu_len=%d, sdu_space=%d\n", lcid, sdu_len, sdu_space);
-          n = pdu->get()->set_sdu(lcid, sdu_len, this);
-        if (n > 0) { // new SDU could be added      
-          sdu_len -= n; 
-          log_h->debug("SDU:   rnti=0x%x, lcid=%d, nbytes=%d, rem_len=%d\n", 
-                      rnti, lcid, n, sdu_len);
-        } else {
-          Debug("Could not add SDU lcid=%d nbytes=%d, space=%d\n", lcid, sdu_len, sdu_space);
-          pdu->del_subh();
-        }
+      log_h->debug("SDU:   add_sdu(), lcid=%d, sdu_len=%d, sdu_space=%d\n", lcid, sdu_len, sdu_space);
+      n = pdu->add_sdu(lcid, sdu_len, this);
+      if (n > 0) { // new SDU could be added      
+        sdu_len -= n; 
+        log_h->debug("SDU:   rnti=0x%x, lcid=%d, nbytes=%d, rem_len=%d\n", 
+                    rnti, lcid, n, sdu_len);
       } else {
-        n=0; 
+        Debug("Could not add SDU lcid=%d nbytes=%d, space=%d\n", lcid, sdu_len, sdu_space);
       }
     }    
   }
 }
 
-void ue::allocate_ce(srslte::sch_pdu *pdu, uint32_t lcid)
+void ue::allocate_ce(srslte::sch_pdu_encoder *pdu, uint32_t lcid)
 {
   switch((srslte::sch_subh::cetype) lcid) {
     case srslte::sch_subh::CON_RES_ID: 
-      if (pdu->new_subh()) {
-        if (pdu->get()->set_con_res_id(conres_id)) {
-          Info("CE:    Added Contention Resolution ID=0x%lx\n", conres_id);
-        } else {
-          Error("CE:    Setting Contention Resolution ID CE\n");
-        }
+      if (pdu->add_con_res_id(conres_id)) {
+        Info("CE:    Added Contention Resolution ID=0x%lx\n", conres_id);
       } else {
         Error("CE:    Setting Contention Resolution ID CE. No space for a subheader\n");
       }
@@ -375,7 +375,7 @@ uint8_t* ue::generate_pdu(uint32_t tb_idx, sched_interface::dl_sched_pdu_t pdu[s
   uint8_t *ret = NULL; 
   pthread_mutex_lock(&mutex);
   if (rlc) {
-    mac_msg_dl.init_tx(tx_payload_buffer[tb_idx], grant_size, false);
+    mac_msg_dl.init(tx_payload_buffer[tb_idx], grant_size);
     for (uint32_t i=0;i<nof_pdu_elems;i++) {
       if (pdu[i].lcid <= srslte::sch_subh::PHR_REPORT) {
         allocate_sdu(&mac_msg_dl, pdu[i].lcid, pdu[i].nbytes);
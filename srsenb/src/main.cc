@@ -106,6 +106,9 @@ void parse_args(all_args_t *args, int argc, char* argv[]) {
 
     ("gui.enable",        bpo::value<bool>(&args->gui.enable)->default_value(false),            "Enable GUI plots")
 
+    ("trace.enable",       bpo::value<bool>(&args->trace.enable)->default_value(false),                     "Enable PHY processing timeline trace")
+    ("trace.phy_filename", bpo::value<string>(&args->trace.phy_filename)->default_value("enb_phy_trace.json"), "PHY timeline trace filename (Chrome trace format)")
+
     ("log.phy_level",     bpo::value<string>(&args->log.phy_level),   "PHY log level")
     ("log.phy_hex_limit", bpo::value<int>(&args->log.phy_hex_limit),  "PHY log hex dump limit")
     ("log.phy_lib_level", bpo::value<string>(&args->log.phy_lib_level)->default_value("none"), "PHY lib log level")
@@ -162,10 +165,22 @@ void parse_args(all_args_t *args, int argc, char* argv[]) {
        bpo::value<bool>(&args->expert.phy.pusch_8bit_decoder)->default_value(false),
        "Use 8-bit for LLR representation and turbo decoder trellis computation (Experimental)")
 
+      ("expert.pusch_fused",
+       bpo::value<bool>(&args->expert.phy.pusch_fused)->default_value(false),
+       "Estimate, equalize and demodulate each PUSCH symbol in one pass (Experimental)")
+
       ("expert.tx_amplitude",
         bpo::value<float>(&args->expert.phy.tx_amplitude)->default_value(0.6),
         "Transmit amplitude factor")
 
+    ("expert.c16_samples",
+        bpo::value<bool>(&args->expert.phy.c16_samples)->default_value(false),
+        "Exchange complex int16 samples with the radio instead of complex float")
+
+    ("expert.rf_batch_sf",
+        bpo::value<uint32_t>(&args->expert.phy.rf_batch_sf)->default_value(1),
+        "Maximum number of subframes received and transmitted in a single radio call")
+
     ("expert.nof_phy_threads",
         bpo::value<int>(&args->expert.phy.nof_phy_threads)->default_value(2),
         "Number of PHY threads")
@@ -174,6 +189,10 @@ void parse_args(all_args_t *args, int argc, char* argv[]) {
         bpo::value<int>(&args->expert.mac.link_failure_nof_err)->default_value(100),
         "Number of PUSCH failures after which a radio-link failure is triggered")
 
+    ("expert.ul_softbuffer_pool_mb",
+        bpo::value<uint32_t>(&args->expert.mac.ul_softbuffer_pool_mb)->default_value(64),
+        "Size of the memory shared by the UL softbuffers of all users in MB. 0 preallocates them for every HARQ process")
+
     ("expert.max_prach_offset_us",
         bpo::value<float>(&args->expert.phy.max_prach_offset_us)->default_value(30),
         "Maximum allowed RACH offset (in us)")
@@ -174,6 +174,15 @@ void metrics_stdout::print_metrics()
   if(metrics.rf.rf_error) {
     printf("RF status: O=%d, U=%d, L=%d\n", metrics.rf.rf_o, metrics.rf.rf_u, metrics.rf.rf_l);
   }
+  if(metrics.phy[0].proc.nof_late > 0) {
+    printf("PHY late: %d/%d subframes, avg=%.0f us, max=%.0f us\n", metrics.phy[0].proc.nof_late, metrics.phy[0].proc.nof_sf,
+           metrics.phy[0].proc.avg_us, metrics.phy[0].proc.max_us);
+  }
+  if(metrics.rrc.n_ues > 0 && metrics.mac[0].ul_softbuffer.nof_chunks > 0) {
+    srslte_softbuffer_pool_metrics_t *sb = &metrics.mac[0].ul_softbuffer;
+    printf("UL softbuffer: %d CBs, used=%.1f%%, max=%.1f%%, fail=%d\n", sb->nof_cb,
+           (float) 100*sb->nof_used/sb->nof_chunks, (float) 100*sb->max_used/sb->nof_chunks, sb->nof_fail);
+  }
 
   cout.flags(f); // For avoiding Coverity defect: Not restoring ostream format
 }
@@ -41,13 +41,12 @@ using namespace std;
 
 namespace srsenb {
 
-phch_common::phch_common(uint32_t max_workers) : tx_sem(max_workers)
+phch_common::phch_common(uint32_t max_workers)
 {
   this->nof_workers = nof_workers;
   params.max_prach_offset_us = 20;
   radio = NULL;
   mac = NULL;
-  is_first_tx = false;
   is_first_of_burst = false;
   pdsch_p_b = 0;
   this->max_workers = max_workers;
@@ -56,15 +55,26 @@ phch_common::phch_common(uint32_t max_workers) : tx_sem(max_workers)
   bzero(&pucch_cfg, sizeof(pucch_cfg));
   bzero(&ul_grants, sizeof(ul_grants));
 
-  for (uint32_t i=0;i<max_workers;i++) {
-    sem_init(&tx_sem[i], 0, 0); // All semaphores start blocked
-  }
+  pthread_mutex_init(&rf_batch_mutex, NULL);
+  bzero(rf_batch_queue, sizeof(rf_batch_queue));
+  bzero(tx_batch_buffer, sizeof(tx_batch_buffer));
+  bzero(&tx_batch_time, sizeof(tx_batch_time));
+  rf_batch_wpm = 0;
+  rf_batch_rpm = 0;
+  rf_batch_len = 1;
+  tx_batch_len = 0;
+  tx_batch_idx = 0;
+  nof_late     = 0;
 }
 
 phch_common::~phch_common() {
-  for (uint32_t i=0;i<max_workers;i++) {
-    sem_destroy(&tx_sem[i]);
+  tx_queue.stop();
+  for (uint32_t p=0;p<SRSLTE_MAX_PORTS;p++) {
+    if (tx_batch_buffer[p]) {
+      free(tx_batch_buffer[p]);
+    }
   }
+  pthread_mutex_destroy(&rf_batch_mutex);
 }
 
 void phch_common::set_nof_workers(uint32_t nof_workers)
@@ -77,57 +87,160 @@ void phch_common::reset() {
   bzero(dl_grants, sizeof(mac_interface_phy::dl_sched_t)*TTIMOD_SZ);
 }
 
-bool phch_common::init(srslte_cell_t *cell_, srslte::radio* radio_h_, mac_interface_phy *mac_)
+bool phch_common::init(srslte_cell_t *cell_, srslte::radio* radio_h_, mac_interface_phy *mac_, int tx_prio)
 {
   radio = radio_h_;
   mac   = mac_; 
   memcpy(&cell, cell_, sizeof(srslte_cell_t));
 
   pthread_mutex_init(&user_mutex, NULL);
+
+  if (params.rf_batch_sf > 1) {
+    uint32_t len = params.rf_batch_sf * SRSLTE_SF_LEN_PRB(cell.nof_prb) * sizeof(cf_t);
+    for (uint32_t p=0;p<cell.nof_ports;p++) {
+      tx_batch_buffer[p] = srslte_vec_malloc(len);
+      if (!tx_batch_buffer[p]) {
+        fprintf(stderr, "Error allocating memory\n");
+        return false;
+      }
+      bzero(tx_batch_buffer[p], len);
+    }
+  }
   
+  // Twice the workers, so that a late subframe does not stop the others from handing over theirs
+  uint32_t sf_bytes = SRSLTE_SF_LEN_PRB(cell.nof_prb) * (params.c16_samples ? sizeof(c16_t) : sizeof(cf_t));
+  if (!tx_queue.init(this, 2*max_workers, cell.nof_ports, sf_bytes, tx_prio)) {
+    return false;
+  }
+
   is_first_of_burst = true; 
-  is_first_tx = true; 
   reset();
   return true; 
 }
 
 void phch_common::stop() {
-  for (uint32_t i=0;i<max_workers;i++) {
-    sem_post(&tx_sem[i]);
-  }
+  tx_queue.stop();
 }
 
-/* The transmission of UL subframes must be in sequence. The correct sequence is guaranteed by a chain of N semaphores,
- * one per TTI%nof_workers. Each threads waits for the semaphore for the current thread and after transmission allows
- * next TTI to be transmitted
+/* The transmission of DL subframes must be in sequence. Each worker copies its subframe into the slot of the
+ * transmission queue given by its sequence number and returns without waiting for the previous subframes, which
+ * are transmitted in order by the tx thread.
  *
- * Each worker uses this function to indicate that all processing is done and data is ready for transmission or
- * there is no transmission at all (tx_enable). In that case, the end of burst message will be sent to the radio
+ * Workers that fail to generate a subframe still call this function with nof_samples=0 so that the sequence has
+ * no gaps. Nothing is transmitted for them.
  */
-void phch_common::worker_end(uint32_t tti, cf_t* buffer[SRSLTE_MAX_PORTS], uint32_t nof_samples, srslte_timestamp_t tx_time)
+void phch_common::worker_end(uint32_t tx_seq, cf_t* buffer[SRSLTE_MAX_PORTS], uint32_t nof_samples, srslte_timestamp_t tx_time,
+                             srslte::phy_trace *trace)
+{
+  worker_end((void **) buffer, false, tx_seq, nof_samples, tx_time, trace);
+}
+
+void phch_common::worker_end_c16(uint32_t tx_seq, c16_t* buffer[SRSLTE_MAX_PORTS], uint32_t nof_samples, srslte_timestamp_t tx_time,
+                                 srslte::phy_trace *trace)
+{
+  worker_end((void **) buffer, true, tx_seq, nof_samples, tx_time, trace);
+}
+
+void phch_common::worker_end(void *buffer[SRSLTE_MAX_PORTS], bool c16, uint32_t tx_seq, uint32_t nof_samples, srslte_timestamp_t tx_time,
+                             srslte::phy_trace *trace)
 {
+  srslte::tx_reorder_slot_t *slot;
 
-  // This variable is not protected but it is very unlikely that 2 threads arrive here simultaneously since at the beginning
-  // there is no workload and threads are separated by 1 ms
-  if (is_first_tx) {
-    is_first_tx = false;
-    // Allow my own transmission if I'm the first to transmit
-    sem_post(&tx_sem[tti%nof_workers]);
+  // Only waits if the radio is a whole queue behind
+  {
+    srslte::phy_trace::scope s(trace, srslte::PHY_TRACE_TX_WAIT);
+    slot = tx_queue.get_slot(tx_seq);
   }
 
-  // Wait for the green light to transmit in the current TTI
-  sem_wait(&tx_sem[tti%nof_workers]);
+  {
+    srslte::phy_trace::scope s(trace, srslte::PHY_TRACE_TX);
+    size_t sf_bytes = nof_samples * (c16 ? sizeof(c16_t) : sizeof(cf_t));
+    if (sf_bytes > tx_queue.get_slot_bytes()) {
+      fprintf(stderr, "Error subframe of %d samples does not fit the transmission queue\n", nof_samples);
+      nof_samples = 0;
+      sf_bytes    = 0;
+    }
+    for (uint32_t p=0;p<cell.nof_ports;p++) {
+      memcpy(slot->buffer[p], buffer[p], sf_bytes);
+    }
+    slot->nof_samples = nof_samples;
+    slot->tx_enable   = nof_samples > 0;
+    slot->c16         = c16;
+    srslte_timestamp_copy(&slot->tx_time, &tx_time);
+  }
 
-  radio->set_tti(tti);
-  radio->tx((void **) buffer, nof_samples, tx_time);
+  tx_queue.push(tx_seq);
+}
 
-  // Allow next TTI to transmit
-  sem_post(&tx_sem[(tti+1)%nof_workers]);
+void phch_common::tx_slot(uint32_t seq, srslte::tx_reorder_slot_t *slot)
+{
+  radio->set_tti(seq);
+  if (params.rf_batch_sf > 1) {
+    // Append this subframe to the batch and send it once complete. A missing subframe is sent as zeros.
+    if (tx_batch_idx == 0) {
+      pthread_mutex_lock(&rf_batch_mutex);
+      tx_batch_len = rf_batch_queue[rf_batch_rpm];
+      rf_batch_rpm = (rf_batch_rpm+1)%RF_BATCH_QUEUE_SZ;
+      pthread_mutex_unlock(&rf_batch_mutex);
+      srslte_timestamp_copy(&tx_batch_time, &slot->tx_time);
+    }
+    uint32_t sf_len   = SRSLTE_SF_LEN_PRB(cell.nof_prb);
+    size_t   sf_bytes = sf_len * (params.c16_samples ? sizeof(c16_t) : sizeof(cf_t));
+    for (uint32_t p=0;p<cell.nof_ports;p++) {
+      if (slot->tx_enable) {
+        memcpy((uint8_t*) tx_batch_buffer[p] + tx_batch_idx*sf_bytes, slot->buffer[p], sf_bytes);
+      } else {
+        bzero((uint8_t*) tx_batch_buffer[p] + tx_batch_idx*sf_bytes, sf_bytes);
+      }
+    }
+    tx_batch_idx++;
+    if (tx_batch_idx >= tx_batch_len) {
+      if (params.c16_samples) {
+        radio->tx_c16(tx_batch_buffer, tx_batch_len*sf_len, tx_batch_time);
+      } else {
+        radio->tx(tx_batch_buffer, tx_batch_len*sf_len, tx_batch_time);
+      }
+      tx_batch_idx = 0;
+    }
+  } else if (slot->tx_enable) {
+    if (slot->c16) {
+      radio->tx_c16(slot->buffer, slot->nof_samples, slot->tx_time);
+    } else {
+      radio->tx(slot->buffer, slot->nof_samples, slot->tx_time);
+    }
+  }
 
   // Trigger MAC clock
   mac->tti_clock();
 }
 
+void phch_common::rf_batch_start(uint32_t nof_sf)
+{
+  pthread_mutex_lock(&rf_batch_mutex);
+  rf_batch_queue[rf_batch_wpm] = nof_sf;
+  rf_batch_wpm = (rf_batch_wpm+1)%RF_BATCH_QUEUE_SZ;
+  rf_batch_len = nof_sf;
+  pthread_mutex_unlock(&rf_batch_mutex);
+}
+
+uint32_t phch_common::get_rf_batch_len()
+{
+  pthread_mutex_lock(&rf_batch_mutex);
+  uint32_t len = rf_batch_len;
+  pthread_mutex_unlock(&rf_batch_mutex);
+  return len;
+}
+
+void phch_common::late_sf()
+{
+  __sync_fetch_and_add(&nof_late, 1);
+}
+
+uint32_t phch_common::get_nof_late()
+{
+  return __sync_fetch_and_add(&nof_late, 0);
+}
+
 void phch_common::ue_db_clear(uint32_t sf_idx)
 {
   for(std::map<uint16_t,common_ue>::iterator iter=common_ue_db.begin(); iter!=common_ue_db.end(); ++iter) {
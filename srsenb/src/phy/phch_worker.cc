@@ -77,6 +77,9 @@ phch_worker::phch_worker()
   bzero(&enb_dl, sizeof(enb_dl));
   bzero(&enb_ul, sizeof(enb_ul));
   bzero(&tx_time, sizeof(tx_time));
+  bzero(signal_buffer_rx_c16, sizeof(signal_buffer_rx_c16));
+  bzero(signal_buffer_tx_c16, sizeof(signal_buffer_tx_c16));
+  rf_batch_len = 1;
 
   reset();  
 }
@@ -106,6 +109,16 @@ void phch_worker::init(phch_common* phy_, srslte::log *log_h_)
       return;
     }
     bzero(signal_buffer_tx[p], 2 * SRSLTE_SF_LEN_PRB(phy->cell.nof_prb) * sizeof(cf_t));
+    if (phy->params.c16_samples) {
+      signal_buffer_rx_c16[p] = (c16_t *) srslte_vec_malloc(SRSLTE_SF_LEN_PRB(phy->cell.nof_prb) * sizeof(c16_t));
+      signal_buffer_tx_c16[p] = (c16_t *) srslte_vec_malloc(SRSLTE_SF_LEN_PRB(phy->cell.nof_prb) * sizeof(c16_t));
+      if (!signal_buffer_rx_c16[p] || !signal_buffer_tx_c16[p]) {
+        fprintf(stderr, "Error allocating memory\n");
+        return;
+      }
+      bzero(signal_buffer_rx_c16[p], SRSLTE_SF_LEN_PRB(phy->cell.nof_prb) * sizeof(c16_t));
+      bzero(signal_buffer_tx_c16[p], SRSLTE_SF_LEN_PRB(phy->cell.nof_prb) * sizeof(c16_t));
+    }
   }
   if (srslte_enb_dl_init(&enb_dl, signal_buffer_tx, phy->cell.nof_prb)) {
     fprintf(stderr, "Error initiating ENB DL\n");
@@ -150,7 +163,14 @@ void phch_worker::init(phch_common* phy_, srslte::log *log_h_)
   srslte_softbuffer_tx_reset(&temp_mbsfn_softbuffer);
   srslte_pucch_set_threshold(&enb_ul.pucch, 0.5);
   srslte_sch_set_max_noi(&enb_ul.pusch.ul_sch, phy->params.pusch_max_its);
+  srslte_enb_ul_set_mimo_decoder(&enb_ul, phy->params.equalizer_mode.compare("zf") ? SRSLTE_MIMO_DECODER_MMSE
+                                                                                   : SRSLTE_MIMO_DECODER_ZF);
+  srslte_enb_ul_set_pusch_fused(&enb_ul, phy->params.pusch_fused);
   srslte_enb_dl_set_amp(&enb_dl, phy->params.tx_amplitude);
+
+  // Subframes are late when they are not transmitted before their tx_time
+  rf_batch_len = 1;
+  trace.init(TRACE_NOF_EVENTS, (HARQ_DELAY_MS-rf_batch_len)*1000);
   
   Info("Worker %d configured cell %d PRB\n", get_id(), phy->cell.nof_prb);
 
@@ -188,6 +208,12 @@ void phch_worker::stop()
       if (signal_buffer_tx[p]) {
         free(signal_buffer_tx[p]);
       }
+      if (signal_buffer_rx_c16[p]) {
+        free(signal_buffer_rx_c16[p]);
+      }
+      if (signal_buffer_tx_c16[p]) {
+        free(signal_buffer_tx_c16[p]);
+      }
     }
   } else {
     printf("Warning could not stop properly PHY\n");
@@ -206,7 +232,12 @@ cf_t* phch_worker::get_buffer_rx(uint32_t antenna_idx)
   return signal_buffer_rx[antenna_idx];
 }
 
-void phch_worker::set_time(uint32_t tti_, uint32_t tx_worker_cnt_, srslte_timestamp_t tx_time_)
+c16_t* phch_worker::get_buffer_rx_c16(uint32_t antenna_idx)
+{
+  return signal_buffer_rx_c16[antenna_idx];
+}
+
+void phch_worker::set_time(uint32_t tti_, uint32_t tx_seq_, srslte_timestamp_t tx_time_)
 {
   tti_rx       = tti_; 
   tti_tx_dl    = TTI_TX(tti_rx);
@@ -219,7 +250,7 @@ void phch_worker::set_time(uint32_t tti_, uint32_t tx_worker_cnt_, srslte_timest
   t_rx         = TTIMOD(tti_rx);
   t_tx_ul      = TTIMOD(tti_tx_ul);
 
-  tx_worker_cnt = tx_worker_cnt_;
+  tx_seq = tx_seq_;
   memcpy(&tx_time, &tx_time_, sizeof(srslte_timestamp_t));
 }
 
@@ -374,6 +405,13 @@ void phch_worker::work_imp()
     return;
   }
 
+  // With radio batching, all subframes of a batch start when the last one is received and are sent with the first one
+  if (phy->get_rf_batch_len() != rf_batch_len) {
+    rf_batch_len = phy->get_rf_batch_len();
+    trace.set_budget((HARQ_DELAY_MS-rf_batch_len)*1000);
+  }
+  trace.sf_begin(tti_rx);
+
   subframe_cfg_t sf_cfg;
   phy->get_sf_config(&sf_cfg, tti_tx_dl);// TODO difference between  tti_tx_dl and t_tx_dl
 
@@ -394,13 +432,26 @@ void phch_worker::work_imp()
   }
 
   // Process UL signal
-  srslte_enb_ul_fft(&enb_ul);
+  {
+    srslte::phy_trace::scope s(&trace, srslte::PHY_TRACE_FFT);
+    if (phy->params.c16_samples) {
+      srslte_enb_ul_fft_c16(&enb_ul, signal_buffer_rx_c16[0], SRSLTE_RF_C16_SCALE);
+    } else {
+      srslte_enb_ul_fft(&enb_ul);
+    }
+  }
 
   // Decode pending UL grants for the tti they were scheduled
-  decode_pusch(ul_grants[t_rx].sched_grants, ul_grants[t_rx].nof_grants);
+  {
+    srslte::phy_trace::scope s(&trace, srslte::PHY_TRACE_PUSCH);
+    decode_pusch(ul_grants[t_rx].sched_grants, ul_grants[t_rx].nof_grants);
+  }
 
   // Decode remaining PUCCH ACKs not associated with PUSCH transmission and SR signals
-  decode_pucch();
+  {
+    srslte::phy_trace::scope s(&trace, srslte::PHY_TRACE_PUCCH);
+    decode_pucch();
+  }
 
   // Get DL scheduling for the TX TTI from MAC
 
@@ -441,17 +492,28 @@ void phch_worker::work_imp()
   
   if(sf_cfg.sf_type == SUBFRAME_TYPE_REGULAR) {
     // Put UL/DL grants to resource grid. PDSCH data will be encoded as well.
-    encode_pdcch_dl(dl_grants[t_tx_dl].sched_grants, dl_grants[t_tx_dl].nof_grants);
+    {
+      srslte::phy_trace::scope s(&trace, srslte::PHY_TRACE_PDCCH);
+      encode_pdcch_dl(dl_grants[t_tx_dl].sched_grants, dl_grants[t_tx_dl].nof_grants);
+    }
+    srslte::phy_trace::scope s(&trace, srslte::PHY_TRACE_PDSCH);
     encode_pdsch(dl_grants[t_tx_dl].sched_grants, dl_grants[t_tx_dl].nof_grants);
   }else {
+    srslte::phy_trace::scope s(&trace, srslte::PHY_TRACE_PDSCH);
     srslte_ra_dl_grant_t phy_grant;
     phy_grant.mcs[0].idx = sf_cfg.mbsfn_mcs;
     encode_pmch(&dl_grants[t_tx_dl].sched_grants[0], &phy_grant);
   }
   
-  encode_pdcch_ul(ul_grants[t_tx_ul].sched_grants, ul_grants[t_tx_ul].nof_grants);
+  {
+    srslte::phy_trace::scope s(&trace, srslte::PHY_TRACE_PDCCH);
+    encode_pdcch_ul(ul_grants[t_tx_ul].sched_grants, ul_grants[t_tx_ul].nof_grants);
+  }
   // Put pending PHICH HARQ ACK/NACK indications into subframe
-  encode_phich(ul_grants[t_tx_ul].phich, ul_grants[t_tx_ul].nof_phich);
+  {
+    srslte::phy_trace::scope s(&trace, srslte::PHY_TRACE_PHICH);
+    encode_phich(ul_grants[t_tx_ul].phich, ul_grants[t_tx_ul].nof_phich);
+  }
 
   // Prepare for receive ACK for DL grants in t_tx_dl+4
   phy->ue_db_clear(TTIMOD(TTI_TX(t_tx_dl)));
@@ -474,16 +536,34 @@ void phch_worker::work_imp()
   }
 
   // Generate signal and transmit
-  if(sf_cfg.sf_type == SUBFRAME_TYPE_REGULAR) {
-    srslte_enb_dl_gen_signal(&enb_dl);
-  } else {
-    srslte_enb_dl_gen_signal_mbsfn(&enb_dl);
+  {
+    srslte::phy_trace::scope s(&trace, srslte::PHY_TRACE_ENCODE);
+    if (phy->params.c16_samples) {
+      if(sf_cfg.sf_type == SUBFRAME_TYPE_REGULAR) {
+        srslte_enb_dl_gen_signal_c16(&enb_dl, signal_buffer_tx_c16, SRSLTE_RF_C16_SCALE);
+      } else {
+        srslte_enb_dl_gen_signal_mbsfn_c16(&enb_dl, signal_buffer_tx_c16[0], SRSLTE_RF_C16_SCALE);
+      }
+    } else {
+      if(sf_cfg.sf_type == SUBFRAME_TYPE_REGULAR) {
+        srslte_enb_dl_gen_signal(&enb_dl);
+      } else {
+        srslte_enb_dl_gen_signal_mbsfn(&enb_dl);
+      }
+    }
   }
 
   pthread_mutex_unlock(&mutex);
 
   Debug("Sending to radio\n");
-  phy->worker_end(tx_worker_cnt, signal_buffer_tx, SRSLTE_SF_LEN_PRB(phy->cell.nof_prb), tx_time);
+  if (phy->params.c16_samples) {
+    phy->worker_end_c16(tx_seq, signal_buffer_tx_c16, SRSLTE_SF_LEN_PRB(phy->cell.nof_prb), tx_time, &trace);
+  } else {
+    phy->worker_end(tx_seq, signal_buffer_tx, SRSLTE_SF_LEN_PRB(phy->cell.nof_prb), tx_time, &trace);
+  }
+  if (trace.sf_end()) {
+    phy->late_sf();
+  }
 
   is_worker_running = false;
 
@@ -509,6 +589,14 @@ unlock:
   if (is_worker_running) {
     is_worker_running = false;
     pthread_mutex_unlock(&mutex);
+
+    // Nothing to transmit, but the following subframes are not transmitted until this one is handed over
+    if (phy->params.c16_samples) {
+      phy->worker_end_c16(tx_seq, signal_buffer_tx_c16, 0, tx_time, &trace);
+    } else {
+      phy->worker_end(tx_seq, signal_buffer_tx, 0, tx_time, &trace);
+    }
+    trace.sf_end();
   }
 
 }
@@ -1056,6 +1144,11 @@ uint32_t phch_worker::get_metrics(phy_metrics_t metrics[ENB_METRICS_MAX_USERS])
   return cnt;
 }
 
+void phch_worker::get_proc_metrics(srslte::phy_proc_metrics_t *m)
+{
+  trace.get_metrics(m);
+}
+
 void phch_worker::ue::metrics_read(phy_metrics_t* metrics_)
 {
   memcpy(metrics_, &metrics, sizeof(phy_metrics_t));
@@ -1079,6 +1172,18 @@ void phch_worker::ue::metrics_ul(uint32_t mcs, float rssi, float sinr, uint32_t
 
 
 
+/************ Processing timeline trace ********************/
+void phch_worker::start_trace()
+{
+  trace.start();
+}
+
+srslte::phy_trace* phch_worker::get_trace()
+{
+  return &trace;
+}
+
+
 void phch_worker::start_plot() {
 #ifdef ENABLE_GUI
   if (plot_worker_id == -1) {
@@ -1098,6 +1203,10 @@ int phch_worker::read_ce_abs(float *ce_abs) {
   uint32_t i=0;
   int sz = srslte_symbol_sz(phy->cell.nof_prb);
   bzero(ce_abs, sizeof(float)*sz);
+  // The fused PUSCH decoder does not fill the channel estimate grid
+  if (phy->params.pusch_fused) {
+    return sz;
+  }
   int g = (sz - 12*phy->cell.nof_prb)/2;
   for (i = 0; i < 12*phy->cell.nof_prb; i++) {
     ce_abs[g+i] = 20 * log10(cabs(enb_ul.ce[i]));
@@ -1112,6 +1221,10 @@ int phch_worker::read_ce_arg(float *ce_arg) {
   uint32_t i=0;
   int sz = srslte_symbol_sz(phy->cell.nof_prb);
   bzero(ce_arg, sizeof(float)*sz);
+  // The fused PUSCH decoder does not fill the channel estimate grid
+  if (phy->params.pusch_fused) {
+    return sz;
+  }
   int g = (sz - 12*phy->cell.nof_prb)/2;
   for (i = 0; i < 12*phy->cell.nof_prb; i++) {
     ce_arg[g+i] = cargf(enb_ul.ce[i]) * 180.0f / (float) M_PI;
@@ -119,7 +119,18 @@ bool phy::init(phy_args_t *args,
   this->log_h = (srslte::log*)log_vec[0];
   workers_common.params = *args; 
 
-  workers_common.init(&cfg->cell, radio_handler, mac);
+  // Subframes of a batch wait for the last one before being processed, so a batch must be shorter than the HARQ delay
+  if (args->rf_batch_sf < 1 || args->rf_batch_sf >= HARQ_DELAY_MS) {
+    uint32_t rf_batch_sf = SRSLTE_MIN(SRSLTE_MAX(args->rf_batch_sf, 1), HARQ_DELAY_MS-1);
+    log_h->console("Invalid rf_batch_sf=%d, using %d\n", args->rf_batch_sf, rf_batch_sf);
+    workers_common.params.rf_batch_sf = rf_batch_sf;
+  }
+  if (workers_common.params.rf_batch_sf > nof_workers) {
+    log_h->console("Warning: rf_batch_sf=%d is larger than the number of PHY threads (%d)\n",
+                   workers_common.params.rf_batch_sf, nof_workers);
+  }
+
+  workers_common.init(&cfg->cell, radio_handler, mac, TX_THREAD_PRIO);
   
   parse_config(cfg);
   
@@ -210,6 +221,46 @@ void phy::get_metrics(phy_metrics_t metrics[ENB_METRICS_MAX_USERS])
     metrics[j].ul.sinr        /= metrics[j].ul.n_samples;
     metrics[j].ul.turbo_iters /= metrics[j].ul.n_samples;
   }
+
+  // Subframe processing times are not per user, all the entries get the same values
+  srslte::phy_proc_metrics_t proc, proc_tmp;
+  bzero(&proc, sizeof(srslte::phy_proc_metrics_t));
+  for (uint32_t i=0;i<nof_workers;i++) {
+    workers[i].get_proc_metrics(&proc_tmp);
+    proc.avg_us   += proc_tmp.nof_sf*proc_tmp.avg_us;
+    proc.max_us    = SRSLTE_MAX(proc.max_us, proc_tmp.max_us);
+    proc.nof_sf   += proc_tmp.nof_sf;
+    proc.nof_late += proc_tmp.nof_late;
+  }
+  if (proc.nof_sf > 0) {
+    proc.avg_us /= proc.nof_sf;
+  }
+  for (uint32_t j=0;j<ENB_METRICS_MAX_USERS;j++) {
+    metrics[j].proc = proc;
+  }
+}
+
+void phy::radio_late()
+{
+  workers_common.late_sf();
+}
+
+void phy::start_trace()
+{
+  for (uint32_t i=0;i<nof_workers;i++) {
+    workers[i].start_trace();
+  }
+}
+
+void phy::write_trace(std::string filename)
+{
+  std::vector<srslte::phy_trace*> traces;
+  for (uint32_t i=0;i<nof_workers;i++) {
+    traces.push_back(workers[i].get_trace());
+  }
+  if (!srslte::phy_trace::write_json(filename, traces)) {
+    log_h->error("Writing PHY trace to %s\n", filename.c_str());
+  }
 }
 
 
@@ -25,6 +25,7 @@
  */
 
 #include "srslte/srslte.h"
+#include "srslte/phy/rf/rf.h"
 #include "srsenb/hdr/phy/prach_worker.h"
 
 namespace srsenb {
@@ -70,6 +71,16 @@ void prach_worker::set_max_prach_offset_us(float delay_us)
 }
 
 int prach_worker::new_tti(uint32_t tti_rx, cf_t* buffer_rx)
+{
+  return save_samples(tti_rx, buffer_rx, NULL);
+}
+
+int prach_worker::new_tti_c16(uint32_t tti_rx, c16_t* buffer_rx)
+{
+  return save_samples(tti_rx, NULL, buffer_rx);
+}
+
+int prach_worker::save_samples(uint32_t tti_rx, cf_t* buffer_rx, c16_t* buffer_rx_c16)
 {
   // Save buffer only if it's a PRACH TTI
   if (srslte_prach_tti_opportunity(&prach, tti_rx, -1) || sf_cnt) {
@@ -85,7 +96,13 @@ int prach_worker::new_tti(uint32_t tti_rx, cf_t* buffer_rx)
       return -1;
     }
     if (current_buffer->nof_samples+SRSLTE_SF_LEN_PRB(cell.nof_prb) < sf_buffer_sz) {
-      memcpy(&current_buffer->samples[sf_cnt*SRSLTE_SF_LEN_PRB(cell.nof_prb)], buffer_rx, sizeof(cf_t)*SRSLTE_SF_LEN_PRB(cell.nof_prb));
+      cf_t *samples = &current_buffer->samples[sf_cnt*SRSLTE_SF_LEN_PRB(cell.nof_prb)];
+      if (buffer_rx_c16) {
+        // The detector runs in float, convert while copying
+        srslte_vec_convert_if((int16_t*) buffer_rx_c16, SRSLTE_RF_C16_SCALE, (float*) samples, 2*SRSLTE_SF_LEN_PRB(cell.nof_prb));
+      } else {
+        memcpy(samples, buffer_rx, sizeof(cf_t)*SRSLTE_SF_LEN_PRB(cell.nof_prb));
+      }
       current_buffer->nof_samples += SRSLTE_SF_LEN_PRB(cell.nof_prb);
       if (sf_cnt == 0) {
         current_buffer->tti = tti_rx;
@@ -42,13 +42,26 @@ using namespace std;
 
 namespace srsenb {
 
-txrx::txrx() : tx_worker_cnt(0), nof_workers(0), tti(0) {
+txrx::txrx() : tx_seq(0), nof_workers(0), tti(0) {
   running = false;   
   radio_h = NULL; 
   log_h   = NULL; 
   workers_pool = NULL; 
   worker_com   = NULL;
   prach = NULL;
+  bzero(rx_batch_buffer, sizeof(rx_batch_buffer));
+  rf_batch_len      = 1;
+  rf_batch_nof_late = 0;
+  rf_batch_in_time  = 0;
+}
+
+txrx::~txrx()
+{
+  for (uint32_t p=0;p<SRSLTE_MAX_PORTS;p++) {
+    if (rx_batch_buffer[p]) {
+      free(rx_batch_buffer[p]);
+    }
+  }
 }
 
 bool txrx::init(srslte::radio* radio_h_, srslte::thread_pool* workers_pool_, phch_common* worker_com_, prach_worker *prach_, srslte::log* log_h_, uint32_t prio_)
@@ -58,11 +71,24 @@ bool txrx::init(srslte::radio* radio_h_, srslte::thread_pool* workers_pool_, phc
   workers_pool = workers_pool_;
   worker_com   = worker_com_;
   prach        = prach_; 
-  tx_worker_cnt = 0; 
+  tx_seq = 0; 
   running      = true; 
   
   nof_workers = workers_pool->get_nof_workers();
   worker_com->set_nof_workers(nof_workers);
+
+  rf_batch_len = worker_com->params.rf_batch_sf;
+  if (rf_batch_len > 1) {
+    uint32_t len = rf_batch_len * SRSLTE_SF_LEN_PRB(worker_com->cell.nof_prb) * sizeof(cf_t);
+    for (uint32_t p=0;p<worker_com->cell.nof_ports;p++) {
+      rx_batch_buffer[p] = srslte_vec_malloc(len);
+      if (!rx_batch_buffer[p]) {
+        log_h->error("Allocating radio batch buffer\n");
+        return false;
+      }
+    }
+    log_h->console("Batching %d subframes per radio call\n", rf_batch_len);
+  }
     
   start(prio_);
   return true; 
@@ -78,6 +104,7 @@ void txrx::run_thread()
 {
   phch_worker *worker = NULL;
   cf_t *buffer[SRSLTE_MAX_PORTS] = {NULL};
+  c16_t *buffer_c16[SRSLTE_MAX_PORTS] = {NULL};
   srslte_timestamp_t rx_time, tx_time; 
   uint32_t sf_len = SRSLTE_SF_LEN_PRB(worker_com->cell.nof_prb);
   
@@ -111,33 +138,65 @@ void txrx::run_thread()
   printf("\n==== eNodeB started ===\n");
   printf("Type <t> to view trace\n");
   // Main loop
+  uint32_t batch_len = 1;
+  uint32_t batch_idx = 0;
+  srslte_timestamp_t batch_time;
   while (running) {
+    // With batching, receive the next subframes in one radio call and hand them to the workers one by one
+    if (worker_com->params.rf_batch_sf > 1 && batch_idx == 0) {
+      adapt_rf_batch();
+      batch_len = rf_batch_len;
+      worker_com->rf_batch_start(batch_len);
+      rx_batch(batch_len*sf_len, &batch_time);
+    }
+
     tti = (tti+1)%10240;        
     worker = (phch_worker*) workers_pool->wait_worker(tti);
     if (worker) {
-      for (int p = 0; p < SRSLTE_MAX_PORTS; p++){
-        buffer[p] = worker->get_buffer_rx(p);
+      if (worker_com->params.rf_batch_sf > 1) {
+        size_t sf_bytes = sf_len * (worker_com->params.c16_samples ? sizeof(c16_t) : sizeof(cf_t));
+        for (uint32_t p = 0; p < worker_com->cell.nof_ports; p++) {
+          buffer[p]     = worker->get_buffer_rx(p);
+          buffer_c16[p] = worker->get_buffer_rx_c16(p);
+          memcpy(worker_com->params.c16_samples ? (void*) buffer_c16[p] : (void*) buffer[p],
+                 (uint8_t*) rx_batch_buffer[p] + batch_idx*sf_bytes, sf_bytes);
+        }
+        srslte_timestamp_copy(&rx_time, &batch_time);
+        srslte_timestamp_add(&rx_time, 0, batch_idx*1e-3);
+        batch_idx = (batch_idx+1)%batch_len;
+      } else if (worker_com->params.c16_samples) {
+        for (int p = 0; p < SRSLTE_MAX_PORTS; p++){
+          buffer_c16[p] = worker->get_buffer_rx_c16(p);
+        }
+        radio_h->rx_now_c16((void **) buffer_c16, sf_len, &rx_time);
+      } else {
+        for (int p = 0; p < SRSLTE_MAX_PORTS; p++){
+          buffer[p] = worker->get_buffer_rx(p);
+        }
+        radio_h->rx_now((void **) buffer, sf_len, &rx_time);
       }
-      
-      radio_h->rx_now((void **) buffer, sf_len, &rx_time);
                     
       /* Compute TX time: Any transmission happens in TTI+4 thus advance 4 ms the reception time */
       srslte_timestamp_copy(&tx_time, &rx_time);
       srslte_timestamp_add(&tx_time, 0, HARQ_DELAY_MS*1e-3);
       
-      Debug("Settting TTI=%d, tx_mutex=%d, tx_time=%ld:%f to worker %d\n", 
-            tti, tx_worker_cnt, 
+      Debug("Settting TTI=%d, tx_seq=%d, tx_time=%ld:%f to worker %d\n", 
+            tti, tx_seq, 
             tx_time.full_secs, tx_time.frac_secs,
             worker->get_id());
       
-      worker->set_time(tti, tx_worker_cnt, tx_time);
-      tx_worker_cnt = (tx_worker_cnt+1)%nof_workers;
+      worker->set_time(tti, tx_seq, tx_time);
+      tx_seq++;
       
       // Trigger phy worker execution
       workers_pool->start_worker(worker);       
 
       // Trigger prach worker execution 
-      prach->new_tti(tti, buffer[0]);
+      if (worker_com->params.c16_samples) {
+        prach->new_tti_c16(tti, buffer_c16[0]);
+      } else {
+        prach->new_tti(tti, buffer[0]);
+      }
       
     } else {
       // wait_worker() only returns NULL if it's being closed. Quit now to avoid unnecessary loops here
@@ -146,6 +205,38 @@ void txrx::run_thread()
   }
 }
 
+bool txrx::rx_batch(uint32_t nof_samples, srslte_timestamp_t *rx_time)
+{
+  if (worker_com->params.c16_samples) {
+    return radio_h->rx_now_c16(rx_batch_buffer, nof_samples, rx_time);
+  } else {
+    return radio_h->rx_now(rx_batch_buffer, nof_samples, rx_time);
+  }
+}
+
+/* Batching trades latency for fewer radio calls: every subframe of a batch waits for the last one to be received,
+ * and is transmitted with the last one. The batch is shortened as soon as subframes are late, and grown back to the
+ * configured length after RF_BATCH_GROW_SF subframes in time. */
+void txrx::adapt_rf_batch()
+{
+  uint32_t nof_late = worker_com->get_nof_late();
+  if (nof_late != rf_batch_nof_late) {
+    rf_batch_nof_late = nof_late;
+    rf_batch_in_time  = 0;
+    if (rf_batch_len > 1) {
+      rf_batch_len--;
+      log_h->info("Late subframes, batching %d subframes per radio call\n", rf_batch_len);
+    }
+  } else if (rf_batch_len < worker_com->params.rf_batch_sf) {
+    rf_batch_in_time += rf_batch_len;
+    if (rf_batch_in_time >= RF_BATCH_GROW_SF) {
+      rf_batch_in_time = 0;
+      rf_batch_len++;
+      log_h->info("Batching %d subframes per radio call\n", rf_batch_len);
+    }
+  }
+}
+
 
   
 }
@@ -580,15 +580,21 @@ int main(int argc, char *argv[])
   // Configuure cell 
   srsenb::phy_cfg_t phy_cfg;   
   srsenb::sched_interface::cell_cfg_t mac_cfg; 
-  srsenb::mac_args_t mac_args; 
+  srsenb::mac_args_t mac_args = srsenb::mac_args_t();
   srsenb::phy_args_t phy_args; 
   
   mac_args.link_failure_nof_err = 10; 
+  mac_args.ul_softbuffer_pool_mb = 64;
   phy_args.equalizer_mode  = "mmse"; 
   phy_args.estimator_fil_w = 0.2;
   phy_args.max_prach_offset_us = 50; 
   phy_args.nof_phy_threads = 1; 
   phy_args.pusch_max_its   = 5; 
+  phy_args.c16_samples     = false;
+  phy_args.rf_batch_sf     = 1;
+  phy_args.pusch_8bit_decoder = false;
+  phy_args.pusch_fused     = false;
+  mac_args.ul_softbuffer_8bit = phy_args.pusch_8bit_decoder;
   
   generate_cell_configuration(&mac_cfg, &phy_cfg);
   
@@ -38,8 +38,13 @@
 #include "srslte/common/logger_file.h"
 #include "srslte/common/log_filter.h"
 #include "srslte/common/buffer_pool.h"
+#include "srslte/common/threads.h"
+#include "srslte/common/block_queue.h"
 #include "srslte/interfaces/epc_interfaces.h"
+#include "srsepc/hdr/hss/hss_db.h"
 #include <fstream>
+#include <vector>
+#include <deque>
 #include <map>
 
 #define LTE_FDD_ENB_IND_HE_N_BITS    5
@@ -52,29 +57,33 @@ namespace srsepc{
 typedef struct{
   std::string auth_algo;
   std::string db_file;
+  std::string db_store;
+  bool db_sync;
+  uint32_t av_pool_depth;
   uint16_t mcc;
   uint16_t mnc;
 }hss_args_t;
 
 typedef struct{
-    std::string name;
-    uint64_t imsi;
-    uint8_t  key[16];
-    bool     op_configured;
-    uint8_t  op[16];
-    uint8_t  opc[16];
-    uint8_t  amf[2];
-    uint8_t  sqn[6];
-    uint16_t qci;
-    uint8_t  last_rand[16];
-}hss_ue_ctx_t;
+  uint8_t k_asme[32];
+  uint8_t autn[16];
+  uint8_t rand[16];
+  uint8_t xres[16];
+}hss_auth_vector_t;
+
+/* Authentication vectors precomputed for one subscriber, oldest SQN first */
+typedef struct{
+  std::deque<hss_auth_vector_t> vectors;
+  uint32_t epoch;                       // Bumped on resync, vectors of an older epoch are dropped
+  bool     refill_pending;
+}hss_av_pool_t;
 
 enum hss_auth_algo {
   HSS_ALGO_XOR,
   HSS_ALGO_MILENAGE
 };
 
-class hss : public hss_interface_s1ap
+class hss : public hss_interface_s1ap, public thread
 {
 public:
   static hss* get_instance(void);
@@ -95,14 +104,23 @@ private:
 
   srslte::byte_buffer_pool *m_pool;
 
-  std::map<uint64_t,hss_ue_ctx_t*> m_imsi_to_ue_ctx;
+  hss_db m_db;
 
 
   void gen_rand(uint8_t rand_[16]);
   bool get_k_amf_opc_sqn(uint64_t imsi, uint8_t *k, uint8_t *amf, uint8_t *opc, uint8_t *sqn);
 
-  bool gen_auth_info_answer_milenage(uint64_t imsi, uint8_t *k_asme, uint8_t *autn, uint8_t *rand, uint8_t *xres);
-  bool gen_auth_info_answer_xor(uint64_t imsi, uint8_t *k_asme, uint8_t *autn, uint8_t *rand, uint8_t *xres);
+  bool reserve_sqn(uint64_t imsi, uint8_t *k, uint8_t *amf, uint8_t *opc, uint8_t *sqn, uint8_t *rand);
+  //The RAND of the vector is an input, drawn by reserve_sqn() with the SQN
+  bool gen_auth_vector(uint8_t *k, uint8_t *amf, uint8_t *opc, uint8_t *sqn, hss_auth_vector_t *av);
+  bool gen_auth_vector_milenage(uint8_t *k, uint8_t *amf, uint8_t *opc, uint8_t *sqn, uint8_t *k_asme, uint8_t *autn, uint8_t *rand, uint8_t *xres);
+  bool gen_auth_vector_xor(uint8_t *k, uint8_t *amf, uint8_t *opc, uint8_t *sqn, uint8_t *k_asme, uint8_t *autn, uint8_t *rand, uint8_t *xres);
+
+  /*Authentication vector pools*/
+  void run_thread();
+  bool pop_pooled_av(uint64_t imsi, hss_auth_vector_t *av);
+  void refill_av_pool(uint64_t imsi);
+  void invalidate_av_pool(uint64_t imsi);
 
   bool resync_sqn_milenage(uint64_t imsi, uint8_t *auts);
   bool resync_sqn_xor(uint64_t imsi, uint8_t *auts);
@@ -119,7 +137,8 @@ private:
   void get_last_rand(uint64_t imsi, uint8_t *rand);
 
   bool set_auth_algo(std::string auth_algo);
-  bool read_db_file(std::string db_file);
+  bool read_db_file(std::string db_file, std::vector<hss_ue_ctx_t> *users);
+  bool load_db(std::string db_file, std::string db_store);
   bool write_db_file(std::string db_file);
   bool get_ue_ctx(uint64_t imsi, hss_ue_ctx_t **ue_ctx);
   
@@ -127,6 +146,15 @@ private:
 
   enum hss_auth_algo m_auth_algo;
   std::string db_file;
+  std::string db_store;
+
+  // Serializes SQN updates between the S1AP path and the vector generator
+  pthread_mutex_t m_sqn_mutex;
+  uint32_t m_av_pool_depth;
+  bool m_av_running;
+  std::map<uint64_t,hss_av_pool_t> m_av_pools;
+  srslte::block_queue<uint64_t> m_av_refill_queue;
+
   /*Logs*/
   srslte::log_filter       *m_hss_log;
   
@@ -0,0 +1,112 @@
+/**
+ *
+ * \section COPYRIGHT
+ *
+ * Copyright 2013-2017 Software Radio Systems Limited
+ *
+ * \section LICENSE
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ * File:        hss_db.h
+ * Description: Subscriber store of the HSS. Subscribers are kept in a
+ *              memory mapped open-addressing hash table indexed by IMSI.
+ *              When backed by a file, SQN and RAND updates are written
+ *              in place, so they survive a crash of the EPC and the
+ *              store can be mapped at startup without parsing the .csv.
+ *****************************************************************************/
+
+#ifndef SRSEPC_HSS_DB_H
+#define SRSEPC_HSS_DB_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "srslte/common/log_filter.h"
+
+#define HSS_DB_MAGIC        0x3142445353485253ULL // "SRSHSSDB" read as little-endian
+#define HSS_DB_VERSION      1
+#define HSS_DB_NAME_LEN     32
+#define HSS_DB_HEADER_LEN   4096
+
+namespace srsepc{
+
+/* Subscriber record. Stored as-is in the memory mapped store, so it must stay POD. */
+typedef struct{
+    uint64_t imsi;                  // 0 marks an empty slot
+    char     name[HSS_DB_NAME_LEN];
+    uint8_t  key[16];
+    uint8_t  op[16];
+    uint8_t  opc[16];
+    uint8_t  last_rand[16];
+    uint8_t  sqn[6];
+    uint8_t  amf[2];
+    uint16_t qci;
+    bool     op_configured;
+}hss_ue_ctx_t;
+
+typedef struct{
+    uint64_t magic;
+    uint32_t version;
+    uint32_t record_len;
+    uint64_t nof_slots;             // Power of two
+    uint64_t nof_users;
+    int64_t  csv_mtime;             // Stamp of the .csv the store was built from
+    uint64_t csv_size;
+}hss_db_header_t;
+
+class hss_db
+{
+public:
+  hss_db();
+  ~hss_db();
+
+  void set_log(srslte::log_filter *hss_log);
+  void set_sync(bool sync);
+
+  bool open(const std::string &store_file);
+  bool is_stale(const std::string &csv_file);
+  bool rebuild(const std::string &store_file, const std::vector<hss_ue_ctx_t> &users, const std::string &csv_file);
+  void close(void);
+
+  hss_ue_ctx_t* find(uint64_t imsi);
+  void commit(hss_ue_ctx_t *ue_ctx);
+
+  uint64_t get_nof_users(void);
+  uint64_t get_nof_slots(void);
+  hss_ue_ctx_t* get_slot(uint64_t idx);
+
+private:
+  hss_ue_ctx_t* lookup(hss_ue_ctx_t *slots, uint64_t nof_slots, uint64_t imsi);
+  bool get_csv_stamp(const std::string &csv_file, int64_t *mtime, uint64_t *size);
+
+  srslte::log_filter *m_hss_log;
+  bool                m_sync;
+
+  uint8_t            *m_map;
+  size_t              m_map_len;
+  bool                m_file_backed;
+  hss_db_header_t    *m_header;
+  hss_ue_ctx_t       *m_slots;
+};
+
+} // namespace srsepc
+
+#endif // SRSEPC_HSS_DB_H
@@ -39,7 +39,9 @@
 #include "srslte/common/log_filter.h"
 #include "srslte/common/buffer_pool.h"
 #include "srslte/common/threads.h"
+#include "srslte/common/block_queue.h"
 #include "s1ap.h"
+#include <vector>
 
 
 namespace srsepc{
@@ -60,6 +62,45 @@ typedef struct{
 } mme_args_t;
 
 
+class mme;
+
+/*
+ * S1AP worker. Handles the S1AP PDUs of one UE context shard.
+ */
+class mme_worker:
+  public thread
+{
+public:
+  mme_worker();
+  virtual ~mme_worker();
+  void init(uint32_t shard, mme *mme_, s1ap *s1ap_, srslte::log_filter *s1ap_log);
+  void stop();
+
+  void push_pdu(srslte::byte_buffer_t *pdu, const struct sctp_sndrcvinfo *sri);
+  void push_enb_shutdown(int32_t assoc_id);
+
+private:
+  void run_thread();
+
+  typedef struct{
+    uint32_t                type;
+    srslte::byte_buffer_t  *pdu;
+    struct sctp_sndrcvinfo  sri;
+  } worker_msg_t;
+
+  const static uint32_t MSG_PDU          = 0;
+  const static uint32_t MSG_ENB_SHUTDOWN = 1;
+  const static uint32_t MSG_EXIT         = 2;
+
+  uint32_t m_shard;
+  bool     m_running;
+  mme     *m_mme;
+  s1ap    *m_s1ap;
+  srslte::byte_buffer_pool *m_pool;
+  srslte::log_filter       *m_s1ap_log;
+  srslte::block_queue<worker_msg_t> m_queue;
+};
+
 class mme:
   public thread
 {
@@ -71,6 +112,8 @@ public:
   int get_s1_mme();
   void run_thread();
 
+  bool enb_shutdown_done(int32_t assoc_id);
+
 private:
 
   mme();
@@ -82,6 +125,11 @@ private:
   bool m_running;
   srslte::byte_buffer_pool *m_pool;
 
+  /*S1AP workers, one per UE context shard. Empty when S1AP runs in the receive thread*/
+  std::vector<mme_worker*> m_workers;
+  std::map<int32_t,uint32_t> m_enb_shutdown_pending;
+  pthread_mutex_t m_enb_shutdown_mutex;
+
   /*Logs*/
   srslte::log_filter  *m_s1ap_log;
   srslte::log_filter  *m_mme_gtpc_log;
@@ -75,6 +75,9 @@ private:
   std::map<uint32_t,uint64_t> m_mme_ctr_teid_to_imsi;
   std::map<uint64_t,struct gtpc_ctx> m_imsi_to_gtpc_ctx;
 
+  //Serializes the S1AP workers. Held for the whole request/response exchange with the SP-GW.
+  pthread_mutex_t m_mutex;
+
 };
 
 }
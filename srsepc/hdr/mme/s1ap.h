@@ -41,6 +41,8 @@
 #include <unistd.h>
 #include <map>
 #include <set>
+#include <vector>
+#include <pthread.h>
 #include "s1ap_common.h"
 #include "s1ap_mngmt_proc.h"
 #include "s1ap_nas_transport.h"
@@ -65,13 +67,19 @@ public:
 
   int get_s1_mme();
 
-  void delete_enb_ctx(int32_t assoc_id);
+  //release_ues=false skips the UEs, when every worker has already released those of its shard
+  void delete_enb_ctx(int32_t assoc_id, bool release_ues = true);
 
   bool s1ap_tx_pdu(srslte::byte_buffer_t *pdu, struct sctp_sndrcvinfo *enb_sri);
   bool handle_s1ap_rx_pdu(srslte::byte_buffer_t *pdu, struct sctp_sndrcvinfo *enb_sri);
   bool handle_initiating_message(LIBLTE_S1AP_INITIATINGMESSAGE_STRUCT *msg, struct sctp_sndrcvinfo *enb_sri);
   bool handle_successful_outcome(LIBLTE_S1AP_SUCCESSFULOUTCOME_STRUCT *msg);
 
+  //Sharded execution. All UE state is partitioned in shards, each one owned by one worker thread.
+  uint32_t get_nof_shards();
+  void set_worker_shard(uint32_t shard);
+  uint32_t get_rx_pdu_shard(srslte::byte_buffer_t *pdu);
+
   void activate_eps_bearer(uint64_t imsi, uint8_t ebi);
 
   void print_enb_ctx_info(const std::string &prefix, const enb_ctx_t &enb_ctx);
@@ -88,6 +96,7 @@ public:
 
   ue_ctx_t* find_ue_ctx_from_imsi(uint64_t imsi);
   ue_ctx_t* find_ue_ctx_from_mme_ue_s1ap_id(uint32_t mme_ue_s1ap_id);
+  bool find_imsi_from_m_tmsi(uint32_t m_tmsi, uint64_t *imsi);
 
   bool release_ue_ecm_ctx(uint32_t mme_ue_s1ap_id);
   void release_ues_ecm_ctx_in_enb(int32_t enb_assoc);
@@ -102,8 +111,6 @@ public:
   s1ap_nas_transport*            m_s1ap_nas_transport;
   s1ap_ctx_mngmt_proc*           m_s1ap_ctx_mngmt_proc;
 
-  std::map<uint32_t, uint64_t>                      m_tmsi_to_imsi;
-
 private:
   s1ap();
   virtual ~s1ap();
@@ -119,11 +126,26 @@ private:
   std::map<int32_t, uint16_t>                       m_sctp_to_enb_id;
   std::map<int32_t,std::set<uint32_t> >             m_enb_assoc_to_ue_ids;
 
-  std::map<uint64_t, ue_ctx_t*>                     m_imsi_to_ue_ctx;
-  std::map<uint32_t, ue_ctx_t*>                     m_mme_ue_s1ap_id_to_ue_ctx;
+  pthread_mutex_t                                   m_enb_mutex;
+
+  //UE contexts of one shard. Only the worker owning the shard accesses them.
+  //MME-UE-S1AP-IDs and M-TMSIs are allocated so that id % nof_shards is the owner shard.
+  typedef struct{
+    std::map<uint64_t, ue_ctx_t*>                   imsi_to_ue_ctx;
+    std::map<uint32_t, ue_ctx_t*>                   mme_ue_s1ap_id_to_ue_ctx;
+    std::map<uint32_t, uint64_t>                    tmsi_to_imsi;
+    uint32_t                                        next_mme_ue_s1ap_id;
+    uint32_t                                        next_m_tmsi;
+  } s1ap_shard_t;
+
+  uint32_t get_worker_shard();
+  s1ap_shard_t* get_shard();
+  uint32_t get_imsi_shard(uint64_t imsi);
 
-  uint32_t                                          m_next_mme_ue_s1ap_id;
-  uint32_t                                          m_next_m_tmsi;
+  std::vector<s1ap_shard_t>                         m_shards;
+  pthread_key_t                                     m_shard_key;
+  std::map<uint64_t, uint32_t>                      m_imsi_to_shard;
+  pthread_mutex_t                                   m_imsi_to_shard_mutex;
 
   //FIXME the GTP-C should be moved to the MME class, when the packaging of GTP-C messages is done.
   mme_gtpc *m_mme_gtpc;
@@ -131,6 +153,7 @@ private:
   //PCAP
   bool              m_pcap_enable;
   srslte::s1ap_pcap m_pcap;
+  pthread_mutex_t   m_pcap_mutex;
 };
 
 inline uint32_t
@@ -139,6 +162,12 @@ s1ap::get_plmn()
   return m_plmn;
 }
 
+inline uint32_t
+s1ap::get_nof_shards()
+{
+  return m_shards.size();
+}
+
 
 } //namespace srsepc
 
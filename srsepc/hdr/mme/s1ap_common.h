@@ -95,6 +95,7 @@ typedef struct{
   std::string   mme_apn;
   bool          pcap_enable;
   std::string   pcap_filename;
+  uint32_t      nof_workers;  // S1AP worker threads. UE contexts are sharded across them.
 } s1ap_args_t;
 
 typedef struct{
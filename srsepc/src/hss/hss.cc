@@ -28,6 +28,7 @@
 #include <string>
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
 #include <inttypes.h> // for printing uint64_t
 #include "srsepc/hdr/hss/hss.h"
 #include "srslte/common/security.h"
@@ -39,14 +40,18 @@ namespace srsepc{
 hss*          hss::m_instance = NULL;
 pthread_mutex_t hss_instance_mutex = PTHREAD_MUTEX_INITIALIZER;
 
-hss::hss()
+hss::hss():
+  m_av_pool_depth(0),
+  m_av_running(false)
 {
   m_pool = srslte::byte_buffer_pool::get_instance();
+  pthread_mutex_init(&m_sqn_mutex, NULL);
   return;
 }
 
 hss::~hss()
 {
+  pthread_mutex_destroy(&m_sqn_mutex);
   return;
 }
 
@@ -85,7 +90,9 @@ hss::init(hss_args_t *hss_args, srslte::log_filter *hss_log)
     return -1;
   }
   /*Read user information from DB*/
-  if(read_db_file(hss_args->db_file) == false)
+  m_db.set_log(m_hss_log);
+  m_db.set_sync(hss_args->db_sync);
+  if(load_db(hss_args->db_file, hss_args->db_store) == false)
   {
     m_hss_log->console("Error reading user database file %s\n", hss_args->db_file.c_str());
     return -1;
@@ -95,8 +102,20 @@ hss::init(hss_args_t *hss_args, srslte::log_filter *hss_log)
   mnc = hss_args->mnc;
 
   db_file = hss_args->db_file;
+  db_store = hss_args->db_store;
 
-  m_hss_log->info("HSS Initialized. DB file %s, authentication algorithm %s, MCC: %d, MNC: %d\n", hss_args->db_file.c_str(),hss_args->auth_algo.c_str(), mcc, mnc);
+  /*Start authentication vector generator*/
+  m_av_pool_depth = hss_args->av_pool_depth;
+  if(m_av_pool_depth > 0)
+  {
+    m_av_running = true;
+    start();
+    m_hss_log->info("Precomputing up to %d authentication vectors per user\n", m_av_pool_depth);
+  }
+
+  m_hss_log->info("HSS Initialized. DB file %s, DB store %s, authentication algorithm %s, MCC: %d, MNC: %d\n", hss_args->db_file.c_str(),
+                  db_store.empty() ? "none" : db_store.c_str(), hss_args->auth_algo.c_str(), mcc, mnc);
+  m_hss_log->info("Number of users in HSS: %" PRIu64 "\n", m_db.get_nof_users());
   m_hss_log->console("HSS Initialized.\n");
   return 0;
 }
@@ -104,15 +123,19 @@ hss::init(hss_args_t *hss_args, srslte::log_filter *hss_log)
 void
 hss::stop(void)
 {
-  write_db_file(db_file);
-  std::map<uint64_t,hss_ue_ctx_t*>::iterator it = m_imsi_to_ue_ctx.begin();
-  while(it!=m_imsi_to_ue_ctx.end())
-    {
-      m_hss_log->info("Deleting UE context in HSS. IMSI: %015lu\n", it->second->imsi);
-      m_hss_log->console("Deleting UE context in HSS. IMSI: %015lu\n", it->second->imsi);
-      delete it->second;
-      m_imsi_to_ue_ctx.erase(it++);
-    }
+  if(m_av_running)
+  {
+    m_av_running = false;
+    m_av_refill_queue.push(0);
+    wait_thread_finish();
+  }
+  if(db_store.empty())
+  {
+    // Without a store the .csv is the only place where SQNs are kept
+    write_db_file(db_file);
+  }
+  m_hss_log->info("Closing HSS user database. Users: %" PRIu64 "\n", m_db.get_nof_users());
+  m_db.close();
   return;
 }
 
@@ -137,7 +160,28 @@ hss::set_auth_algo(std::string auth_algo)
 }
 
 bool
-hss::read_db_file(std::string db_filename)
+hss::load_db(std::string db_filename, std::string db_store)
+{
+  // A store that is up to date with the .csv is used directly, no parsing needed
+  if(!db_store.empty() && m_db.open(db_store) && !m_db.is_stale(db_filename))
+  {
+    return true;
+  }
+  if(!db_store.empty())
+  {
+    m_hss_log->info("Importing %s into subscriber store %s\n", db_filename.c_str(), db_store.c_str());
+  }
+
+  std::vector<hss_ue_ctx_t> users;
+  if(read_db_file(db_filename, &users) == false)
+  {
+    return false;
+  }
+  return m_db.rebuild(db_store, users, db_filename);
+}
+
+bool
+hss::read_db_file(std::string db_filename, std::vector<hss_ue_ctx_t> *users)
 {
   std::ifstream m_db_file;
 
@@ -161,8 +205,10 @@ hss::read_db_file(std::string db_filename)
         m_hss_log->error("Columns: %lu, Expected %d.\n",split.size(),column_size);
         return false;
       }
-      hss_ue_ctx_t *ue_ctx = new hss_ue_ctx_t;
-      ue_ctx->name = split[0];
+      hss_ue_ctx_t user;
+      hss_ue_ctx_t *ue_ctx = &user;
+      memset(ue_ctx, 0, sizeof(hss_ue_ctx_t));
+      strncpy(ue_ctx->name, split[0].c_str(), HSS_DB_NAME_LEN - 1);
       ue_ctx->imsi = atoll(split[1].c_str());
       get_uint_vec_from_hex_str(split[2],ue_ctx->key,16);
       if(split[3] == std::string("op"))
@@ -194,7 +240,7 @@ hss::read_db_file(std::string db_filename)
       m_hss_log->debug_hex(ue_ctx->sqn, 6, "SQN : ");
       ue_ctx->qci = atoi(split[7].c_str());
       m_hss_log->debug("Default Bearer QCI: %d\n",ue_ctx->qci);
-      m_imsi_to_ue_ctx.insert(std::pair<uint64_t,hss_ue_ctx_t*>(ue_ctx->imsi,ue_ctx));
+      users->push_back(user);
     }
   }
 
@@ -239,8 +285,21 @@ bool hss::write_db_file(std::string db_filename)
             << "#                                                                            " << std::endl
             << "# Note: Lines starting by '#' are ignored and will be overwritten            " << std::endl;
 
-  std::map<uint64_t,hss_ue_ctx_t*>::iterator it = m_imsi_to_ue_ctx.begin();
-  while(it!=m_imsi_to_ue_ctx.end())
+  // Keep the users sorted by IMSI, as they were written before the hash table
+  std::vector<std::pair<uint64_t,hss_ue_ctx_t*> > users;
+  users.reserve(m_db.get_nof_users());
+  for(uint64_t i=0; i<m_db.get_nof_slots(); i++)
+  {
+    hss_ue_ctx_t *ue_ctx = m_db.get_slot(i);
+    if(ue_ctx != NULL)
+    {
+      users.push_back(std::make_pair(ue_ctx->imsi, ue_ctx));
+    }
+  }
+  std::sort(users.begin(), users.end());
+
+  std::vector<std::pair<uint64_t,hss_ue_ctx_t*> >::iterator it = users.begin();
+  while(it!=users.end())
   {
       m_db_file << it->second->name;
       m_db_file << ",";
@@ -274,44 +333,76 @@ bool hss::write_db_file(std::string db_filename)
 
 bool
 hss::gen_auth_info_answer(uint64_t imsi, uint8_t *k_asme, uint8_t *autn, uint8_t *rand, uint8_t *xres)
+{
+  hss_auth_vector_t av;
+  if(!pop_pooled_av(imsi, &av))
+  {
+    // No precomputed vector, generate it in the S1AP path
+    uint8_t k[16];
+    uint8_t amf[2];
+    uint8_t opc[16];
+    uint8_t sqn[6];
+    pthread_mutex_lock(&m_sqn_mutex);
+    bool ret = reserve_sqn(imsi, k, amf, opc, sqn, av.rand);
+    if(ret)
+    {
+      set_last_rand(imsi, av.rand);
+    }
+    pthread_mutex_unlock(&m_sqn_mutex);
+    if(!ret)
+    {
+      return false;
+    }
+    if(!gen_auth_vector(k, amf, opc, sqn, &av))
+    {
+      return false;
+    }
+  }
+  memcpy(k_asme, av.k_asme, 32);
+  memcpy(autn, av.autn, 16);
+  memcpy(rand, av.rand, 16);
+  memcpy(xres, av.xres, 16);
+  return true;
+}
+
+bool
+hss::reserve_sqn(uint64_t imsi, uint8_t *k, uint8_t *amf, uint8_t *opc, uint8_t *sqn, uint8_t *rand)
+{
+  // Must be called with m_sqn_mutex held
+  // Hands out the current SQN with a new RAND and moves the stored SQN forward, so no two vectors share a SQN
+  bool ret = get_k_amf_opc_sqn(imsi, k, amf, opc, sqn);
+  if(ret)
+  {
+    increment_ue_sqn(imsi);
+    gen_rand(rand);
+  }
+  return ret;
+}
+
+bool
+hss::gen_auth_vector(uint8_t *k, uint8_t *amf, uint8_t *opc, uint8_t *sqn, hss_auth_vector_t *av)
 {
   bool ret = false;
   switch (m_auth_algo)
   {
   case HSS_ALGO_XOR:
-    ret = gen_auth_info_answer_xor(imsi, k_asme, autn, rand, xres);
+    ret = gen_auth_vector_xor(k, amf, opc, sqn, av->k_asme, av->autn, av->rand, av->xres);
     break;
   case HSS_ALGO_MILENAGE:
-    ret = gen_auth_info_answer_milenage(imsi, k_asme, autn, rand, xres);
+    ret = gen_auth_vector_milenage(k, amf, opc, sqn, av->k_asme, av->autn, av->rand, av->xres);
     break;
   }
-  increment_ue_sqn(imsi);
   return ret;
-
 }
 
-
-
 bool
-hss::gen_auth_info_answer_milenage(uint64_t imsi, uint8_t *k_asme, uint8_t *autn, uint8_t *rand, uint8_t *xres)
+hss::gen_auth_vector_milenage(uint8_t *k, uint8_t *amf, uint8_t *opc, uint8_t *sqn, uint8_t *k_asme, uint8_t *autn, uint8_t *rand, uint8_t *xres)
 {
-  uint8_t k[16];
-  uint8_t amf[2];
-  uint8_t opc[16];
-  uint8_t sqn[6];
-
   uint8_t     ck[16];
   uint8_t     ik[16];
   uint8_t     ak[6];
   uint8_t     mac[8];
 
-
-  if(!get_k_amf_opc_sqn(imsi, k, amf, opc, sqn))
-  {
-    return false;
-  }
-  gen_rand(rand);
-  
   security_milenage_f2345( k,
                            opc,
                            rand,
@@ -366,19 +457,12 @@ hss::gen_auth_info_answer_milenage(uint64_t imsi, uint8_t *k_asme, uint8_t *autn
   
   m_hss_log->debug_hex(autn, 16, "User AUTN: ");
 
-  set_last_rand(imsi, rand);
-
   return true;
 }
 
 bool
-hss::gen_auth_info_answer_xor(uint64_t imsi, uint8_t *k_asme, uint8_t *autn, uint8_t *rand, uint8_t *xres)
+hss::gen_auth_vector_xor(uint8_t *k, uint8_t *amf, uint8_t *opc, uint8_t *sqn, uint8_t *k_asme, uint8_t *autn, uint8_t *rand, uint8_t *xres)
 {
-  uint8_t k[16];
-  uint8_t amf[2];
-  uint8_t opc[16];
-  uint8_t sqn[6];
-
   uint8_t  xdout[16];
   uint8_t  cdout[8];
 
@@ -389,12 +473,6 @@ hss::gen_auth_info_answer_xor(uint64_t imsi, uint8_t *k_asme, uint8_t *autn, uin
 
   int i = 0;
 
-  if(!get_k_amf_opc_sqn(imsi, k, amf, opc, sqn))
-  {
-    return false;
-  }
-  gen_rand(rand);
-
   // Use RAND and K to compute RES, CK, IK and AK
   for(i=0; i<16; i++) {
     xdout[i] = k[i]^rand[i];
@@ -475,22 +553,19 @@ hss::gen_auth_info_answer_xor(uint64_t imsi, uint8_t *k_asme, uint8_t *autn, uin
 
   m_hss_log->debug_hex(autn, 8, "User AUTN: ");
 
-  set_last_rand(imsi, rand);
-
   return true;
 }
 
 bool
 hss::gen_update_loc_answer(uint64_t imsi, uint8_t* qci)
 {
-  std::map<uint64_t,hss_ue_ctx_t*>::iterator ue_ctx_it = m_imsi_to_ue_ctx.find(imsi);
-  if(ue_ctx_it == m_imsi_to_ue_ctx.end())
+  hss_ue_ctx_t *ue_ctx = m_db.find(imsi);
+  if(ue_ctx == NULL)
   {
     m_hss_log->info("User not found. IMSI: %015lu\n",imsi);
     m_hss_log->console("User not found. IMSI: %015lu\n",imsi);
     return false;
   }
-  hss_ue_ctx_t *ue_ctx = ue_ctx_it->second;
   m_hss_log->info("Found User %015lu\n",imsi);
   *qci = ue_ctx->qci;
   return true;
@@ -502,14 +577,13 @@ bool
 hss::get_k_amf_opc_sqn(uint64_t imsi, uint8_t *k, uint8_t *amf, uint8_t *opc, uint8_t *sqn)
 {
 
-  std::map<uint64_t,hss_ue_ctx_t*>::iterator ue_ctx_it = m_imsi_to_ue_ctx.find(imsi);
-  if(ue_ctx_it == m_imsi_to_ue_ctx.end())
+  hss_ue_ctx_t *ue_ctx = m_db.find(imsi);
+  if(ue_ctx == NULL)
   {
     m_hss_log->info("User not found. IMSI: %015lu\n",imsi);
     m_hss_log->console("User not found. IMSI: %015lu\n",imsi);
     return false;
   }
-  hss_ue_ctx_t *ue_ctx = ue_ctx_it->second;
   m_hss_log->info("Found User %015lu\n",imsi);
   memcpy(k, ue_ctx->key, 16);
   memcpy(amf, ue_ctx->amf, 2);
@@ -523,6 +597,9 @@ bool
 hss::resync_sqn(uint64_t imsi, uint8_t *auts)
 {
   bool ret = false;
+  pthread_mutex_lock(&m_sqn_mutex);
+  // Vectors computed with the old SQN would fail synchronization again
+  invalidate_av_pool(imsi);
   switch (m_auth_algo)
   {
   case HSS_ALGO_XOR:
@@ -533,6 +610,7 @@ hss::resync_sqn(uint64_t imsi, uint8_t *auts)
     break;
   }
   increment_seq_after_resync(imsi);
+  pthread_mutex_unlock(&m_sqn_mutex);
   return ret;
 }
 
@@ -618,6 +696,7 @@ hss::increment_ue_sqn(uint64_t imsi)
   }
 
   increment_sqn(ue_ctx->sqn,ue_ctx->sqn);
+  m_db.commit(ue_ctx);
   m_hss_log->debug("Incremented SQN (IMSI: %" PRIu64 ")" PRIu64 "\n", imsi);
   m_hss_log->debug_hex(ue_ctx->sqn, 6, "SQN: ");
 }
@@ -698,6 +777,7 @@ hss::increment_seq_after_resync(uint64_t imsi)
   {
     sqn[i] =  (nextsqn >> (5-i)*8) & 0xFF;
   }
+  m_db.commit(ue_ctx);
 
   return;
 
@@ -715,6 +795,7 @@ hss::set_sqn(uint64_t imsi, uint8_t *sqn)
     return;
   }
   memcpy(ue_ctx->sqn, sqn, 6);
+  m_db.commit(ue_ctx);
 }
 
 void
@@ -727,6 +808,7 @@ hss::set_last_rand(uint64_t imsi, uint8_t *rand)
     return;
   }
   memcpy(ue_ctx->last_rand, rand, 16);
+  m_db.commit(ue_ctx);
 
 }
 
@@ -745,6 +827,7 @@ hss::get_last_rand(uint64_t imsi, uint8_t *rand)
 void
 hss::gen_rand(uint8_t rand_[16])
 {
+  // Must be called with m_sqn_mutex held, rand() is not thread-safe
   for(int i=0;i<16;i++)
   {
     rand_[i]=rand()%256; //Pulls on byte at a time. It's slow, but does not depend on RAND_MAX.
@@ -752,16 +835,131 @@ hss::gen_rand(uint8_t rand_[16])
   return;
 }
 
+/* Authentication vector pools */
+void
+hss::run_thread()
+{
+  while(m_av_running)
+  {
+    uint64_t imsi = m_av_refill_queue.wait_pop();
+    if(!m_av_running)
+    {
+      break;
+    }
+    refill_av_pool(imsi);
+  }
+  m_hss_log->info("Authentication vector generator stopped\n");
+}
+
+bool
+hss::pop_pooled_av(uint64_t imsi, hss_auth_vector_t *av)
+{
+  if(m_av_pool_depth == 0 || m_db.find(imsi) == NULL)
+  {
+    return false;
+  }
+
+  bool ret = false;
+  pthread_mutex_lock(&m_sqn_mutex);
+  // Pools are created on the first request, so only users that attach get vectors precomputed
+  hss_av_pool_t *pool = &m_av_pools[imsi];
+  if(!pool->vectors.empty())
+  {
+    *av = pool->vectors.front();
+    pool->vectors.pop_front();
+    set_last_rand(imsi, av->rand);
+    ret = true;
+  }
+  size_t remaining = pool->vectors.size();
+  if(!pool->refill_pending && remaining < m_av_pool_depth)
+  {
+    pool->refill_pending = true;
+    m_av_refill_queue.push(imsi);
+  }
+  pthread_mutex_unlock(&m_sqn_mutex);
+
+  if(ret)
+  {
+    m_hss_log->debug("Using precomputed authentication vector. IMSI: %015" PRIu64 ", remaining: %zd\n", imsi, remaining);
+  }
+  else
+  {
+    m_hss_log->debug("No precomputed authentication vector. IMSI: %015" PRIu64 "\n", imsi);
+  }
+  return ret;
+}
+
+void
+hss::refill_av_pool(uint64_t imsi)
+{
+  uint8_t k[16];
+  uint8_t amf[2];
+  uint8_t opc[16];
+  uint8_t sqn[6];
+  hss_auth_vector_t av;
+
+  while(m_av_running)
+  {
+    // Reserve the SQN under the lock, run Milenage outside of it
+    pthread_mutex_lock(&m_sqn_mutex);
+    hss_av_pool_t *pool = &m_av_pools[imsi];
+    if(pool->vectors.size() >= m_av_pool_depth)
+    {
+      pool->refill_pending = false;
+      pthread_mutex_unlock(&m_sqn_mutex);
+      return;
+    }
+    uint32_t epoch = pool->epoch;
+    bool ret = reserve_sqn(imsi, k, amf, opc, sqn, av.rand);
+    if(!ret)
+    {
+      pool->refill_pending = false;
+    }
+    pthread_mutex_unlock(&m_sqn_mutex);
+    if(!ret)
+    {
+      return;
+    }
+
+    ret = gen_auth_vector(k, amf, opc, sqn, &av);
+
+    pthread_mutex_lock(&m_sqn_mutex);
+    pool = &m_av_pools[imsi];
+    if(ret && pool->epoch == epoch)
+    {
+      pool->vectors.push_back(av);
+    }
+    else
+    {
+      m_hss_log->debug("Discarding authentication vector computed before resync. IMSI: %015" PRIu64 "\n", imsi);
+    }
+    pthread_mutex_unlock(&m_sqn_mutex);
+  }
+}
+
+void
+hss::invalidate_av_pool(uint64_t imsi)
+{
+  // Must be called with m_sqn_mutex held
+  std::map<uint64_t,hss_av_pool_t>::iterator it = m_av_pools.find(imsi);
+  if(it == m_av_pools.end())
+  {
+    return;
+  }
+  m_hss_log->info("Invalidating %zd precomputed authentication vectors. IMSI: %015" PRIu64 "\n", it->second.vectors.size(), imsi);
+  it->second.vectors.clear();
+  it->second.epoch++;
+}
+
 bool hss::get_ue_ctx(uint64_t imsi, hss_ue_ctx_t **ue_ctx)
 {
-  std::map<uint64_t,hss_ue_ctx_t*>::iterator ue_ctx_it = m_imsi_to_ue_ctx.find(imsi);
-  if(ue_ctx_it == m_imsi_to_ue_ctx.end())
+  *ue_ctx = m_db.find(imsi);
+  if(*ue_ctx == NULL)
   {
     m_hss_log->info("User not found. IMSI: %015lu\n",imsi);
     return false;
   }
 
-  *ue_ctx = ue_ctx_it->second;
   return true;
 }
 
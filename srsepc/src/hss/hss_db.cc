@@ -0,0 +1,354 @@
+/**
+ *
+ * \section COPYRIGHT
+ *
+ * Copyright 2013-2017 Software Radio Systems Limited
+ *
+ * \section LICENSE
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <inttypes.h> // for printing uint64_t
+#include "srsepc/hdr/hss/hss_db.h"
+
+namespace srsepc{
+
+hss_db::hss_db():
+  m_hss_log(NULL),
+  m_sync(false),
+  m_map(NULL),
+  m_map_len(0),
+  m_file_backed(false),
+  m_header(NULL),
+  m_slots(NULL)
+{
+  return;
+}
+
+hss_db::~hss_db()
+{
+  close();
+  return;
+}
+
+void
+hss_db::set_log(srslte::log_filter *hss_log)
+{
+  m_hss_log = hss_log;
+}
+
+void
+hss_db::set_sync(bool sync)
+{
+  m_sync = sync;
+}
+
+bool
+hss_db::open(const std::string &store_file)
+{
+  close();
+
+  int fd = ::open(store_file.c_str(), O_RDWR);
+  if(fd < 0)
+  {
+    m_hss_log->info("Could not open subscriber store %s: %s\n", store_file.c_str(), strerror(errno));
+    return false;
+  }
+
+  struct stat st;
+  if(fstat(fd, &st) < 0 || (size_t) st.st_size < HSS_DB_HEADER_LEN)
+  {
+    m_hss_log->warning("Subscriber store %s is truncated\n", store_file.c_str());
+    ::close(fd);
+    return false;
+  }
+
+  uint8_t *map = (uint8_t*) mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if(map == MAP_FAILED)
+  {
+    m_hss_log->error("Could not map subscriber store %s: %s\n", store_file.c_str(), strerror(errno));
+    return false;
+  }
+
+  hss_db_header_t *header = (hss_db_header_t*) map;
+  if(header->magic      != HSS_DB_MAGIC         ||
+     header->version    != HSS_DB_VERSION       ||
+     header->record_len != sizeof(hss_ue_ctx_t) ||
+     header->nof_slots  == 0                    ||
+     (header->nof_slots & (header->nof_slots - 1)) != 0 ||
+     (size_t) st.st_size != HSS_DB_HEADER_LEN + header->nof_slots * sizeof(hss_ue_ctx_t))
+  {
+    m_hss_log->warning("Subscriber store %s has an incompatible format, it will be rebuilt\n", store_file.c_str());
+    munmap(map, st.st_size);
+    return false;
+  }
+
+  // Lookups hit random slots, read-ahead would only pull in unrelated subscribers
+  madvise(map, st.st_size, MADV_RANDOM);
+
+  m_map         = map;
+  m_map_len     = st.st_size;
+  m_file_backed = true;
+  m_header      = header;
+  m_slots       = (hss_ue_ctx_t*) (map + HSS_DB_HEADER_LEN);
+
+  m_hss_log->info("Mapped subscriber store %s. Users: %" PRIu64 ", slots: %" PRIu64 "\n",
+                  store_file.c_str(), m_header->nof_users, m_header->nof_slots);
+  return true;
+}
+
+bool
+hss_db::is_stale(const std::string &csv_file)
+{
+  if(m_header == NULL)
+  {
+    return true;
+  }
+
+  int64_t  mtime;
+  uint64_t size;
+  if(!get_csv_stamp(csv_file, &mtime, &size))
+  {
+    // Without a .csv the store is the only copy of the subscribers
+    return false;
+  }
+  return mtime != m_header->csv_mtime || size != m_header->csv_size;
+}
+
+bool
+hss_db::rebuild(const std::string &store_file, const std::vector<hss_ue_ctx_t> &users, const std::string &csv_file)
+{
+  // Keep the load factor under 3/4 so that linear probing stays short
+  uint64_t nof_slots = 16;
+  while(nof_slots < users.size() + users.size() / 3 + 1)
+  {
+    nof_slots <<= 1;
+  }
+  size_t map_len = HSS_DB_HEADER_LEN + nof_slots * sizeof(hss_ue_ctx_t);
+
+  std::string tmp_file = store_file + ".tmp";
+  uint8_t *map = NULL;
+  int fd = -1;
+  if(store_file.empty())
+  {
+    map = (uint8_t*) mmap(NULL, map_len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  }
+  else
+  {
+    fd = ::open(tmp_file.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if(fd < 0)
+    {
+      m_hss_log->error("Could not create subscriber store %s: %s\n", tmp_file.c_str(), strerror(errno));
+      return false;
+    }
+    // The file is sparse, so empty slots read as zeros and take no disk space
+    if(ftruncate(fd, map_len) < 0)
+    {
+      m_hss_log->error("Could not size subscriber store %s: %s\n", tmp_file.c_str(), strerror(errno));
+      ::close(fd);
+      unlink(tmp_file.c_str());
+      return false;
+    }
+    map = (uint8_t*) mmap(NULL, map_len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  if(map == MAP_FAILED)
+  {
+    m_hss_log->error("Could not map subscriber store: %s\n", strerror(errno));
+    if(fd >= 0)
+    {
+      ::close(fd);
+      unlink(tmp_file.c_str());
+    }
+    return false;
+  }
+
+  hss_db_header_t *header = (hss_db_header_t*) map;
+  hss_ue_ctx_t    *slots  = (hss_ue_ctx_t*) (map + HSS_DB_HEADER_LEN);
+
+  header->magic      = HSS_DB_MAGIC;
+  header->version    = HSS_DB_VERSION;
+  header->record_len = sizeof(hss_ue_ctx_t);
+  header->nof_slots  = nof_slots;
+  header->nof_users  = 0;
+  header->csv_mtime  = 0;
+  header->csv_size   = 0;
+  get_csv_stamp(csv_file, &header->csv_mtime, &header->csv_size);
+
+  for(std::vector<hss_ue_ctx_t>::const_iterator it = users.begin(); it != users.end(); ++it)
+  {
+    if(it->imsi == 0)
+    {
+      continue;
+    }
+    hss_ue_ctx_t *slot = lookup(slots, nof_slots, it->imsi);
+    if(slot->imsi == it->imsi)
+    {
+      m_hss_log->warning("Duplicated user in DB, keeping the first entry. IMSI: %015" PRIu64 "\n", it->imsi);
+      continue;
+    }
+    memcpy(slot, &(*it), sizeof(hss_ue_ctx_t));
+
+    // The store holds the SQNs handed out since the .csv was written, never roll them back
+    hss_ue_ctx_t *old = find(it->imsi);
+    if(old != NULL)
+    {
+      uint64_t old_sqn = 0, new_sqn = 0;
+      for(int i=0; i<6; i++)
+      {
+        old_sqn = (old_sqn << 8) | old->sqn[i];
+        new_sqn = (new_sqn << 8) | slot->sqn[i];
+      }
+      if(old_sqn > new_sqn)
+      {
+        memcpy(slot->sqn, old->sqn, 6);
+      }
+      memcpy(slot->last_rand, old->last_rand, 16);
+    }
+    header->nof_users++;
+  }
+
+  if(fd >= 0)
+  {
+    if(msync(map, map_len, MS_SYNC) < 0 || fsync(fd) < 0 || rename(tmp_file.c_str(), store_file.c_str()) < 0)
+    {
+      m_hss_log->error("Could not write subscriber store %s: %s\n", store_file.c_str(), strerror(errno));
+      munmap(map, map_len);
+      ::close(fd);
+      unlink(tmp_file.c_str());
+      return false;
+    }
+    ::close(fd);
+    madvise(map, map_len, MADV_RANDOM);
+    m_hss_log->info("Built subscriber store %s. Users: %" PRIu64 ", slots: %" PRIu64 "\n",
+                    store_file.c_str(), header->nof_users, nof_slots);
+  }
+
+  close();
+  m_map         = map;
+  m_map_len     = map_len;
+  m_file_backed = (fd >= 0);
+  m_header      = header;
+  m_slots       = slots;
+  return true;
+}
+
+void
+hss_db::close(void)
+{
+  if(m_map != NULL)
+  {
+    if(m_file_backed)
+    {
+      msync(m_map, m_map_len, MS_SYNC);
+    }
+    munmap(m_map, m_map_len);
+  }
+  m_map         = NULL;
+  m_map_len     = 0;
+  m_file_backed = false;
+  m_header      = NULL;
+  m_slots       = NULL;
+}
+
+hss_ue_ctx_t*
+hss_db::find(uint64_t imsi)
+{
+  if(m_slots == NULL || imsi == 0)
+  {
+    return NULL;
+  }
+  hss_ue_ctx_t *slot = lookup(m_slots, m_header->nof_slots, imsi);
+  return slot->imsi == imsi ? slot : NULL;
+}
+
+void
+hss_db::commit(hss_ue_ctx_t *ue_ctx)
+{
+  // Updates land in the shared mapping, so they already survive an EPC crash.
+  // Syncing additionally makes them survive a host crash, at the cost of a disk write per update.
+  if(!m_file_backed || !m_sync || ue_ctx == NULL)
+  {
+    return;
+  }
+  uintptr_t page_mask = ~((uintptr_t) sysconf(_SC_PAGESIZE) - 1);
+  uintptr_t start     = (uintptr_t) ue_ctx & page_mask;
+  uintptr_t end       = (uintptr_t) ue_ctx + sizeof(hss_ue_ctx_t);
+  if(msync((void*) start, end - start, MS_SYNC) < 0)
+  {
+    m_hss_log->error("Could not sync subscriber store. IMSI: %015" PRIu64 ", error: %s\n", ue_ctx->imsi, strerror(errno));
+  }
+}
+
+uint64_t
+hss_db::get_nof_users(void)
+{
+  return m_header == NULL ? 0 : m_header->nof_users;
+}
+
+uint64_t
+hss_db::get_nof_slots(void)
+{
+  return m_header == NULL ? 0 : m_header->nof_slots;
+}
+
+hss_ue_ctx_t*
+hss_db::get_slot(uint64_t idx)
+{
+  if(m_slots == NULL || idx >= m_header->nof_slots || m_slots[idx].imsi == 0)
+  {
+    return NULL;
+  }
+  return &m_slots[idx];
+}
+
+hss_ue_ctx_t*
+hss_db::lookup(hss_ue_ctx_t *slots, uint64_t nof_slots, uint64_t imsi)
+{
+  // Returns the slot holding the IMSI, or the empty slot where it would be inserted
+  uint64_t mask = nof_slots - 1;
+  uint64_t hash = imsi * 0x9E3779B97F4A7C15ULL;
+  uint64_t idx  = (hash ^ (hash >> 32)) & mask;
+  while(slots[idx].imsi != 0 && slots[idx].imsi != imsi)
+  {
+    idx = (idx + 1) & mask;
+  }
+  return &slots[idx];
+}
+
+bool
+hss_db::get_csv_stamp(const std::string &csv_file, int64_t *mtime, uint64_t *size)
+{
+  struct stat st;
+  if(stat(csv_file.c_str(), &st) < 0)
+  {
+    return false;
+  }
+  *mtime = st.st_mtime;
+  *size  = st.st_size;
+  return true;
+}
+
+} //namespace srsepc
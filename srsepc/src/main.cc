@@ -113,7 +113,11 @@ parse_args(all_args_t *args, int argc, char* argv[]) {
     ("mme.mme_bind_addr",   bpo::value<string>(&mme_bind_addr)->default_value("127.0.0.1"),  "IP address of MME for S1 connnection")
     ("mme.dns_addr",        bpo::value<string>(&dns_addr)->default_value("8.8.8.8"),         "IP address of the DNS server for the UEs")
     ("mme.apn",             bpo::value<string>(&mme_apn)->default_value(""),                 "Set Access Point Name (APN) for data services")
+    ("mme.nof_workers",     bpo::value<uint32_t>(&args->mme_args.s1ap_args.nof_workers)->default_value(1), "Number of S1AP worker threads")
     ("hss.db_file",         bpo::value<string>(&hss_db_file)->default_value("ue_db.csv"),    ".csv file that stores UE's keys")
+    ("hss.db_store",        bpo::value<string>(&args->hss_args.db_store)->default_value(""), "Memory mapped subscriber store built from db_file. Empty keeps users in memory only")
+    ("hss.db_sync",         bpo::value<bool>(&args->hss_args.db_sync)->default_value(false), "Sync the subscriber store to disk on every SQN/RAND update")
+    ("hss.av_pool_depth",   bpo::value<uint32_t>(&args->hss_args.av_pool_depth)->default_value(0), "Authentication vectors precomputed per user. 0 generates them on request")
     ("hss.auth_algo",       bpo::value<string>(&hss_auth_algo)->default_value("milenage"),   "HSS uthentication algorithm.")
     ("spgw.gtpu_bind_addr", bpo::value<string>(&spgw_bind_addr)->default_value("127.0.0.1"), "IP address of SP-GW for the S1-U connection")
     ("spgw.sgi_if_addr",    bpo::value<string>(&sgi_if_addr)->default_value("176.16.0.1"),   "IP address of TUN interface for the SGi connection")
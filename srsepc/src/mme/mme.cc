@@ -92,6 +92,19 @@ mme::init(mme_args_t* args, srslte::log_filter *s1ap_log, srslte::log_filter *mm
     exit(-1);
   }
 
+  /*Init S1AP workers*/
+  pthread_mutex_init(&m_enb_shutdown_mutex, NULL);
+  if(m_s1ap->get_nof_shards() > 1)
+  {
+    for(uint32_t i=0; i<m_s1ap->get_nof_shards(); i++)
+    {
+      mme_worker *worker = new mme_worker();
+      worker->init(i, this, m_s1ap, m_s1ap_log);
+      m_workers.push_back(worker);
+    }
+    m_s1ap_log->info("Started %d S1AP workers\n", (int) m_workers.size());
+  }
+
   /*Log successful initialization*/
   m_s1ap_log->info("MME Initialized. MCC: %d, MNC: %d\n",args->s1ap_args.mcc, args->s1ap_args.mnc);
   m_s1ap_log->console("MME Initialized. \n");
@@ -103,6 +116,12 @@ mme::stop()
 {
   if(m_running)
   {
+    for(uint32_t i=0; i<m_workers.size(); i++)
+    {
+      m_workers[i]->stop();
+      delete m_workers[i];
+    }
+    m_workers.clear();
     m_s1ap->stop();
     m_s1ap->cleanup();
     m_running = false;
@@ -151,7 +170,21 @@ mme::run_thread()
         {
           m_s1ap_log->info("SCTP Association Shutdown. Association: %d\n",sri.sinfo_assoc_id);
           m_s1ap_log->console("SCTP Association Shutdown. Association: %d\n",sri.sinfo_assoc_id);
-          m_s1ap->delete_enb_ctx(sri.sinfo_assoc_id);
+          if(m_workers.empty())
+          {
+            m_s1ap->delete_enb_ctx(sri.sinfo_assoc_id);
+          }
+          else
+          {
+            //Every worker releases its UEs. The last one deletes the eNB context.
+            pthread_mutex_lock(&m_enb_shutdown_mutex);
+            m_enb_shutdown_pending[sri.sinfo_assoc_id] = m_workers.size();
+            pthread_mutex_unlock(&m_enb_shutdown_mutex);
+            for(uint32_t i=0; i<m_workers.size(); i++)
+            {
+              m_workers[i]->push_enb_shutdown(sri.sinfo_assoc_id);
+            }
+          }
         }
       }
       else
@@ -159,11 +192,129 @@ mme::run_thread()
         //Received data
         pdu->N_bytes = rd_sz;
         m_s1ap_log->info("Received S1AP msg. Size: %d\n", pdu->N_bytes);
-        m_s1ap->handle_s1ap_rx_pdu(pdu,&sri);
+        if(m_workers.empty())
+        {
+          m_s1ap->handle_s1ap_rx_pdu(pdu,&sri);
+        }
+        else
+        {
+          //Hand the PDU over to the worker owning the UE. The worker deallocates it.
+          m_workers[m_s1ap->get_rx_pdu_shard(pdu)]->push_pdu(pdu,&sri);
+          pdu = m_pool->allocate("mme::run_thread", true);
+        }
       }
     }
   }
+  m_pool->deallocate(pdu);
   return;
 }
 
+bool
+mme::enb_shutdown_done(int32_t assoc_id)
+{
+  bool last = false;
+  pthread_mutex_lock(&m_enb_shutdown_mutex);
+  std::map<int32_t,uint32_t>::iterator it = m_enb_shutdown_pending.find(assoc_id);
+  if(it != m_enb_shutdown_pending.end() && --it->second == 0)
+  {
+    m_enb_shutdown_pending.erase(it);
+    last = true;
+  }
+  pthread_mutex_unlock(&m_enb_shutdown_mutex);
+  return last;
+}
+
+/*******************************************************************************
+  S1AP worker
+*******************************************************************************/
+mme_worker::mme_worker():
+  m_shard(0),
+  m_running(false),
+  m_mme(NULL),
+  m_s1ap(NULL),
+  m_pool(NULL),
+  m_s1ap_log(NULL)
+{
+}
+
+mme_worker::~mme_worker()
+{
+}
+
+void
+mme_worker::init(uint32_t shard, mme *mme_, s1ap *s1ap_, srslte::log_filter *s1ap_log)
+{
+  m_shard = shard;
+  m_mme = mme_;
+  m_s1ap = s1ap_;
+  m_s1ap_log = s1ap_log;
+  m_pool = srslte::byte_buffer_pool::get_instance();
+  m_running = true;
+  start();
+}
+
+void
+mme_worker::stop()
+{
+  if(m_running)
+  {
+    m_running = false;
+    worker_msg_t msg;
+    bzero(&msg, sizeof(worker_msg_t));
+    msg.type = MSG_EXIT;
+    m_queue.push(msg);
+    wait_thread_finish();
+  }
+}
+
+void
+mme_worker::push_pdu(srslte::byte_buffer_t *pdu, const struct sctp_sndrcvinfo *sri)
+{
+  worker_msg_t msg;
+  msg.type = MSG_PDU;
+  msg.pdu = pdu;
+  memcpy(&msg.sri, sri, sizeof(struct sctp_sndrcvinfo));
+  m_queue.push(msg);
+}
+
+void
+mme_worker::push_enb_shutdown(int32_t assoc_id)
+{
+  worker_msg_t msg;
+  bzero(&msg, sizeof(worker_msg_t));
+  msg.type = MSG_ENB_SHUTDOWN;
+  msg.sri.sinfo_assoc_id = assoc_id;
+  m_queue.push(msg);
+}
+
+void
+mme_worker::run_thread()
+{
+  m_s1ap->set_worker_shard(m_shard);
+  while(true)
+  {
+    worker_msg_t msg = m_queue.wait_pop();
+    switch(msg.type)
+    {
+    case MSG_PDU:
+      m_s1ap->handle_s1ap_rx_pdu(msg.pdu, &msg.sri);
+      m_pool->deallocate(msg.pdu);
+      break;
+    case MSG_ENB_SHUTDOWN:
+      //Release the UEs of this shard before counting this worker as done, so the eNB
+      //context is only deleted once no worker uses it any more
+      m_s1ap->release_ues_ecm_ctx_in_enb(msg.sri.sinfo_assoc_id);
+      if(m_mme->enb_shutdown_done(msg.sri.sinfo_assoc_id))
+      {
+        m_s1ap->delete_enb_ctx(msg.sri.sinfo_assoc_id, false);
+      }
+      break;
+    case MSG_EXIT:
+      return;
+    default:
+      m_s1ap_log->error("Unknown S1AP worker message type %d\n", msg.type);
+    }
+  }
+}
+
 } //namespace srsepc
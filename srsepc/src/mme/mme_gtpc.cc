@@ -76,6 +76,7 @@ mme_gtpc::init(srslte::log_filter *mme_gtpc_log)
   m_mme_gtpc_log = mme_gtpc_log;
 
   m_next_ctrl_teid = 1;
+  pthread_mutex_init(&m_mutex, NULL);
 
   m_s1ap = s1ap::get_instance();
   m_mme_gtpc_ip = inet_addr("127.0.0.1");//FIXME At the moment, the GTP-C messages are not sent over the wire. So this parameter is not used.
@@ -96,6 +97,7 @@ mme_gtpc::send_create_session_request(uint64_t imsi)
 {
   m_mme_gtpc_log->info("Sending Create Session Request.\n");
   m_mme_gtpc_log->console("Sending Create Session Request.\n");
+  pthread_mutex_lock(&m_mutex);
   struct srslte::gtpc_pdu cs_req_pdu;
   struct srslte::gtpc_create_session_request *cs_req = &cs_req_pdu.choice.create_session_request;
 
@@ -160,7 +162,7 @@ mme_gtpc::send_create_session_request(uint64_t imsi)
   gtpc_ctx.mme_ctr_fteid = cs_req->sender_f_teid;
   m_imsi_to_gtpc_ctx.insert(std::pair<uint64_t,gtpc_ctx_t>(imsi,gtpc_ctx));
   m_spgw->handle_create_session_request(cs_req, &cs_resp_pdu);
-
+  pthread_mutex_unlock(&m_mutex);
 }
 
 void
@@ -262,9 +264,11 @@ mme_gtpc::send_modify_bearer_request(uint64_t imsi, erab_ctx_t *erab_ctx)
   srslte::gtpc_pdu mb_req_pdu;
   srslte::gtp_fteid_t *enb_fteid = &erab_ctx->enb_fteid;
 
+  pthread_mutex_lock(&m_mutex);
   std::map<uint64_t,gtpc_ctx_t>::iterator it = m_imsi_to_gtpc_ctx.find(imsi);
   if(it == m_imsi_to_gtpc_ctx.end())
   {
+    pthread_mutex_unlock(&m_mutex);
     m_mme_gtpc_log->error("Modify bearer request for UE without GTP-C connection\n");
     return;
   }
@@ -289,6 +293,7 @@ mme_gtpc::send_modify_bearer_request(uint64_t imsi, erab_ctx_t *erab_ctx)
   srslte::gtpc_pdu mb_resp_pdu;
   m_spgw->handle_modify_bearer_request(&mb_req_pdu,&mb_resp_pdu);
   handle_modify_bearer_response(&mb_resp_pdu);
+  pthread_mutex_unlock(&m_mutex);
   return;
 }
 
@@ -318,9 +323,11 @@ mme_gtpc::send_delete_session_request(uint64_t imsi)
   srslte::gtp_fteid_t sgw_ctr_fteid;
   srslte::gtp_fteid_t mme_ctr_fteid;
   //Get S-GW Ctr TEID
+  pthread_mutex_lock(&m_mutex);
   std::map<uint64_t,gtpc_ctx_t>::iterator it_ctx = m_imsi_to_gtpc_ctx.find(imsi);
   if(it_ctx == m_imsi_to_gtpc_ctx.end())
   {
+      pthread_mutex_unlock(&m_mutex);
       m_mme_gtpc_log->error("Could not find GTP-C context to remove\n");
       return;
   }
@@ -351,6 +358,7 @@ mme_gtpc::send_delete_session_request(uint64_t imsi)
     m_mme_ctr_teid_to_imsi.erase(it_imsi);
   }
   m_imsi_to_gtpc_ctx.erase(it_ctx);
+  pthread_mutex_unlock(&m_mutex);
   return;
 }
 
@@ -362,9 +370,11 @@ mme_gtpc::send_release_access_bearers_request(uint64_t imsi)
   srslte::gtp_fteid_t sgw_ctr_fteid;
 
   //Get S-GW Ctr TEID
+  pthread_mutex_lock(&m_mutex);
   std::map<uint64_t,gtpc_ctx_t>::iterator it_ctx = m_imsi_to_gtpc_ctx.find(imsi);
   if(it_ctx == m_imsi_to_gtpc_ctx.end())
   {
+    pthread_mutex_unlock(&m_mutex);
     m_mme_gtpc_log->error("Could not find GTP-C context to remove\n");
     return;
   }
@@ -381,6 +391,7 @@ mme_gtpc::send_release_access_bearers_request(uint64_t imsi)
 
   srslte::gtpc_pdu rel_resp_pdu;
   m_spgw->handle_release_access_bearers_request(&rel_req_pdu, &rel_resp_pdu);
+  pthread_mutex_unlock(&m_mutex);
 
   //The GTP-C connection will not be torn down, just the user plane bearers.
   return;
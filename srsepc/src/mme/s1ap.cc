@@ -39,7 +39,6 @@ pthread_mutex_t s1ap_instance_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 s1ap::s1ap():
   m_s1mme(-1),
-  m_next_mme_ue_s1ap_id(1),
   m_mme_gtpc(NULL),
   m_pool(NULL)
 {
@@ -79,10 +78,23 @@ s1ap::init(s1ap_args_t s1ap_args, srslte::log_filter *s1ap_log, hss_interface_s1
 
   m_s1ap_args = s1ap_args;
   srslte::s1ap_mccmnc_to_plmn(s1ap_args.mcc, s1ap_args.mnc, &m_plmn);
-  m_next_m_tmsi = rand();
   //Init log
   m_s1ap_log = s1ap_log;
 
+  //Init UE context shards. Shard i allocates the IDs congruent to i modulo the number of shards.
+  uint32_t nof_shards = s1ap_args.nof_workers > 0 ? s1ap_args.nof_workers : 1;
+  uint32_t m_tmsi_base = rand();
+  m_shards.resize(nof_shards);
+  for(uint32_t i=0; i<nof_shards; i++)
+  {
+    m_shards[i].next_mme_ue_s1ap_id = (i == 0) ? nof_shards : i;
+    m_shards[i].next_m_tmsi = m_tmsi_base - m_tmsi_base % nof_shards + i;
+  }
+  pthread_key_create(&m_shard_key, NULL);
+  pthread_mutex_init(&m_imsi_to_shard_mutex, NULL);
+  pthread_mutex_init(&m_enb_mutex, NULL);
+  pthread_mutex_init(&m_pcap_mutex, NULL);
+
   //Get pointer to the HSS
   m_hss = hss_;
 
@@ -123,14 +135,18 @@ s1ap::stop()
     m_active_enbs.erase(enb_it++);
   }
 
-  std::map<uint64_t,ue_ctx_t*>::iterator ue_it = m_imsi_to_ue_ctx.begin();
-  while(ue_it!=m_imsi_to_ue_ctx.end())
+  for(uint32_t i=0; i<m_shards.size(); i++)
   {
-    m_s1ap_log->info("Deleting UE EMM context. IMSI: %015lu\n", ue_it->first);
-    m_s1ap_log->console("Deleting UE EMM context. IMSI: %015lu\n", ue_it->first);
-    delete ue_it->second;
-    m_imsi_to_ue_ctx.erase(ue_it++);
+    std::map<uint64_t,ue_ctx_t*>::iterator ue_it = m_shards[i].imsi_to_ue_ctx.begin();
+    while(ue_it!=m_shards[i].imsi_to_ue_ctx.end())
+    {
+      m_s1ap_log->info("Deleting UE EMM context. IMSI: %015lu\n", ue_it->first);
+      m_s1ap_log->console("Deleting UE EMM context. IMSI: %015lu\n", ue_it->first);
+      delete ue_it->second;
+      m_shards[i].imsi_to_ue_ctx.erase(ue_it++);
+    }
   }
+  m_imsi_to_shard.clear();
   //Cleanup message handlers
   s1ap_mngmt_proc::cleanup();
   s1ap_nas_transport::cleanup();
@@ -153,9 +169,212 @@ s1ap::get_s1_mme()
 uint32_t
 s1ap::get_next_mme_ue_s1ap_id()
 {
-    return m_next_mme_ue_s1ap_id++;
+  s1ap_shard_t *shard = get_shard();
+  uint32_t mme_ue_s1ap_id = shard->next_mme_ue_s1ap_id;
+  shard->next_mme_ue_s1ap_id += m_shards.size();
+  return mme_ue_s1ap_id;
+}
+
+//Sharded execution
+void
+s1ap::set_worker_shard(uint32_t shard)
+{
+  //Stored as shard+1, so that threads that never set it (NULL) map to shard 0.
+  pthread_setspecific(m_shard_key, (void*) (uintptr_t) (shard + 1));
+}
+
+uint32_t
+s1ap::get_worker_shard()
+{
+  uintptr_t shard = (uintptr_t) pthread_getspecific(m_shard_key);
+  if(shard == 0 || shard > m_shards.size())
+  {
+    return 0;
+  }
+  return shard - 1;
+}
+
+s1ap::s1ap_shard_t*
+s1ap::get_shard()
+{
+  return &m_shards[get_worker_shard()];
+}
+
+uint32_t
+s1ap::get_imsi_shard(uint64_t imsi)
+{
+  //UEs first identified by a foreign GUTI stay in the shard that served them
+  uint32_t shard = imsi % m_shards.size();
+  pthread_mutex_lock(&m_imsi_to_shard_mutex);
+  std::map<uint64_t,uint32_t>::iterator it = m_imsi_to_shard.find(imsi);
+  if(it != m_imsi_to_shard.end())
+  {
+    shard = it->second;
+  }
+  pthread_mutex_unlock(&m_imsi_to_shard_mutex);
+  return shard;
+}
+
+/*
+ * Reads an APER length determinant. Only the short and long forms are accepted,
+ * routed PDUs are never fragmented.
+ */
+static bool
+route_read_len(const uint8_t **ptr, const uint8_t *end, uint32_t *len)
+{
+  const uint8_t *p = *ptr;
+  if(p >= end)
+  {
+    return false;
+  }
+  if((p[0] & 0x80) == 0)
+  {
+    *len = p[0];
+    *ptr = p + 1;
+    return true;
+  }
+  if((p[0] & 0x40) == 0 && p + 2 <= end)
+  {
+    *len = ((p[0] & 0x3F) << 8) | p[1];
+    *ptr = p + 2;
+    return true;
+  }
+  return false;
 }
 
+uint32_t
+s1ap::get_rx_pdu_shard(srslte::byte_buffer_t *pdu)
+{
+  /*
+   * Called from the S1-MME receive thread, before the PDU is handed to a worker.
+   * UE associated messages go to the shard of their MME-UE-S1AP-ID, Initial UE Messages
+   * to the shard of the IMSI or M-TMSI the UE identifies itself with.
+   * Non UE associated messages are handled by shard 0.
+   *
+   * The PDU is decoded by the worker. Here only the framing and the IEs used for routing
+   * are read, all of them octet aligned: the S1AP-PDU choice, procedure code, criticality
+   * and length of the message, then the extension bit and number of IEs, then for each
+   * IE its id, criticality, length and value.
+   */
+  uint32_t nof_shards = m_shards.size();
+  if(nof_shards == 1)
+  {
+    return 0;
+  }
+
+  const uint8_t *p   = pdu->msg;
+  const uint8_t *end = pdu->msg + pdu->N_bytes;
+  uint32_t len;
+  if(pdu->N_bytes < 3)
+  {
+    return 0;
+  }
+  uint32_t choice    = (p[0] >> 5) & 0x3;
+  uint32_t proc_code = p[1];
+  p += 3;
+  if(!route_read_len(&p, end, &len) || p + 3 > end)
+  {
+    return 0;
+  }
+  uint32_t n_ie = (p[1] << 8) | p[2];
+  p += 3;
+
+  bool by_mme_ue_id = false;
+  bool initial_ue   = false;
+  if(choice == LIBLTE_S1AP_S1AP_PDU_CHOICE_SUCCESSFULOUTCOME)
+  {
+    //Initial Context Setup Response, UE Context Release Complete
+    by_mme_ue_id = proc_code == LIBLTE_S1AP_PROC_ID_INITIALCONTEXTSETUP ||
+                   proc_code == LIBLTE_S1AP_PROC_ID_UECONTEXTRELEASE;
+  }
+  else if(choice == LIBLTE_S1AP_S1AP_PDU_CHOICE_INITIATINGMESSAGE)
+  {
+    by_mme_ue_id = proc_code == LIBLTE_S1AP_PROC_ID_UPLINKNASTRANSPORT ||
+                   proc_code == LIBLTE_S1AP_PROC_ID_UECONTEXTRELEASEREQUEST;
+    initial_ue   = proc_code == LIBLTE_S1AP_PROC_ID_INITIALUEMESSAGE;
+  }
+  if(!by_mme_ue_id && !initial_ue)
+  {
+    return 0;
+  }
+
+  const uint8_t *nas_pdu = NULL;
+  const uint8_t *s_tmsi  = NULL;
+  uint32_t nas_len = 0;
+  for(uint32_t i=0; i<n_ie; i++)
+  {
+    if(p + 3 > end)
+    {
+      return 0;
+    }
+    uint32_t ie_id = (p[0] << 8) | p[1];
+    p += 3;
+    if(!route_read_len(&p, end, &len) || p + len > end)
+    {
+      return 0;
+    }
+    if(by_mme_ue_id && ie_id == LIBLTE_S1AP_IE_ID_MME_UE_S1AP_ID)
+    {
+      //Constrained whole number: number of octets minus one, then the octets
+      uint32_t n_octets = (p[0] >> 6) + 1;
+      if(len < n_octets + 1)
+      {
+        return 0;
+      }
+      uint32_t mme_ue_s1ap_id = 0;
+      for(uint32_t j=1; j<=n_octets; j++)
+      {
+        mme_ue_s1ap_id = (mme_ue_s1ap_id << 8) | p[j];
+      }
+      return mme_ue_s1ap_id % nof_shards;
+    }
+    if(initial_ue && ie_id == LIBLTE_S1AP_IE_ID_NAS_PDU)
+    {
+      const uint8_t *q = p;
+      if(route_read_len(&q, p + len, &nas_len) && q + nas_len <= p + len)
+      {
+        nas_pdu = q;
+      }
+    }
+    if(initial_ue && ie_id == LIBLTE_S1AP_IE_ID_S_TMSI && len >= 6)
+    {
+      //Extension and option bits and the MME code, then the M-TMSI aligned
+      s_tmsi = p + 2;
+    }
+    p += len;
+  }
+
+  if(nas_pdu != NULL && nas_len >= 2 && (nas_pdu[0] & 0x0F) == LIBLTE_MME_PD_EPS_MOBILITY_MANAGEMENT)
+  {
+    //Integrity protected messages carry the plain one after 6 octets of security header
+    uint32_t offset = (nas_pdu[0] >> 4) == LIBLTE_MME_SECURITY_HDR_TYPE_PLAIN_NAS ? 0 : 6;
+    //Message type, attach type and key set identifier, then the length of the EPS mobile identity
+    if(offset + 4 <= nas_len && nas_pdu[offset + 1] == LIBLTE_MME_MSG_TYPE_ATTACH_REQUEST &&
+       offset + 4 + nas_pdu[offset + 3] <= nas_len)
+    {
+      LIBLTE_MME_EPS_MOBILE_ID_STRUCT eps_mobile_id;
+      uint8 *id_ptr = (uint8*) &nas_pdu[offset + 3];
+      if(liblte_mme_unpack_eps_mobile_id_ie(&id_ptr, &eps_mobile_id) != LIBLTE_SUCCESS)
+      {
+        return 0;
+      }
+      if(eps_mobile_id.type_of_id == LIBLTE_MME_EPS_MOBILE_ID_TYPE_IMSI)
+      {
+        uint64_t imsi = 0;
+        for(int i=0;i<=14;i++){
+          imsi = imsi*10 + eps_mobile_id.imsi[i];
+        }
+        return get_imsi_shard(imsi);
+      }
+      return eps_mobile_id.guti.m_tmsi % nof_shards;
+    }
+  }
+  if(s_tmsi != NULL)
+  {
+    return ((uint32_t) s_tmsi[0] << 24 | s_tmsi[1] << 16 | s_tmsi[2] << 8 | s_tmsi[3]) % nof_shards;
+  }
+  return 0;
+}
 
 int
 s1ap::enb_listen()
@@ -218,7 +437,9 @@ s1ap::s1ap_tx_pdu(srslte::byte_buffer_t *pdu, struct sctp_sndrcvinfo *enb_sri)
     return false;
   }
   if(m_pcap_enable){
+    pthread_mutex_lock(&m_pcap_mutex);
     m_pcap.write_s1ap(pdu->msg,pdu->N_bytes);
+    pthread_mutex_unlock(&m_pcap_mutex);
   }
   return true;
 }
@@ -234,7 +455,9 @@ s1ap::handle_s1ap_rx_pdu(srslte::byte_buffer_t *pdu, struct sctp_sndrcvinfo *enb
   }
 
   if(m_pcap_enable){
+    pthread_mutex_lock(&m_pcap_mutex);
     m_pcap.write_s1ap(pdu->msg,pdu->N_bytes);
+    pthread_mutex_unlock(&m_pcap_mutex);
   }
 
   switch(rx_pdu.choice_type) {
@@ -321,9 +544,11 @@ s1ap::add_new_enb_ctx(const enb_ctx_t &enb_ctx, const struct sctp_sndrcvinfo *en
   std::set<uint32_t> ue_set;
   enb_ctx_t *enb_ptr = new enb_ctx_t;
   memcpy(enb_ptr,&enb_ctx,sizeof(enb_ctx_t));
+  pthread_mutex_lock(&m_enb_mutex);
   m_active_enbs.insert(std::pair<uint16_t,enb_ctx_t*>(enb_ptr->enb_id,enb_ptr));
   m_sctp_to_enb_id.insert(std::pair<int32_t,uint16_t>(enb_sri->sinfo_assoc_id, enb_ptr->enb_id));
   m_enb_assoc_to_ue_ids.insert(std::pair<int32_t,std::set<uint32_t> >(enb_sri->sinfo_assoc_id,ue_set));
+  pthread_mutex_unlock(&m_enb_mutex);
 
   return;
 }
@@ -331,40 +556,50 @@ s1ap::add_new_enb_ctx(const enb_ctx_t &enb_ctx, const struct sctp_sndrcvinfo *en
 enb_ctx_t*
 s1ap::find_enb_ctx(uint16_t enb_id)
 {
+  enb_ctx_t *enb_ctx = NULL;
+  pthread_mutex_lock(&m_enb_mutex);
   std::map<uint16_t,enb_ctx_t*>::iterator it = m_active_enbs.find(enb_id);
-  if(it == m_active_enbs.end())
-  {
-    return NULL;
-  }
-  else
+  if(it != m_active_enbs.end())
   {
-    return it->second;
+    enb_ctx = it->second;
   }
+  pthread_mutex_unlock(&m_enb_mutex);
+  return enb_ctx;
 }
 
 void
-s1ap::delete_enb_ctx(int32_t assoc_id)
+s1ap::delete_enb_ctx(int32_t assoc_id, bool release_ues)
 {
+  pthread_mutex_lock(&m_enb_mutex);
   std::map<int32_t,uint16_t>::iterator it_assoc = m_sctp_to_enb_id.find(assoc_id);
-  uint16_t enb_id = it_assoc->second;
-
-  std::map<uint16_t,enb_ctx_t*>::iterator it_ctx = m_active_enbs.find(enb_id);
-  if(it_ctx == m_active_enbs.end() || it_assoc == m_sctp_to_enb_id.end())
+  if(it_assoc == m_sctp_to_enb_id.end() || m_active_enbs.find(it_assoc->second) == m_active_enbs.end())
   {
+    pthread_mutex_unlock(&m_enb_mutex);
     m_s1ap_log->error("Could not find eNB to delete. Association: %d\n",assoc_id);
     return;
   }
+  uint16_t enb_id = it_assoc->second;
+  pthread_mutex_unlock(&m_enb_mutex);
 
   m_s1ap_log->info("Deleting eNB context. eNB Id: 0x%x\n", enb_id);
   m_s1ap_log->console("Deleting eNB context. eNB Id: 0x%x\n", enb_id);
 
   //Delete connected UEs ctx
-  release_ues_ecm_ctx_in_enb(assoc_id);
+  if(release_ues)
+  {
+    release_ues_ecm_ctx_in_enb(assoc_id);
+  }
 
   //Delete eNB
-  delete it_ctx->second;
-  m_active_enbs.erase(it_ctx);
-  m_sctp_to_enb_id.erase(it_assoc);
+  pthread_mutex_lock(&m_enb_mutex);
+  std::map<uint16_t,enb_ctx_t*>::iterator it_ctx = m_active_enbs.find(enb_id);
+  if(it_ctx != m_active_enbs.end())
+  {
+    delete it_ctx->second;
+    m_active_enbs.erase(it_ctx);
+  }
+  m_sctp_to_enb_id.erase(assoc_id);
+  pthread_mutex_unlock(&m_enb_mutex);
   return;
 }
 
@@ -373,22 +608,38 @@ s1ap::delete_enb_ctx(int32_t assoc_id)
 bool
 s1ap::add_ue_ctx_to_imsi_map(ue_ctx_t *ue_ctx)
 {
-  std::map<uint64_t, ue_ctx_t*>::iterator ctx_it = m_imsi_to_ue_ctx.find(ue_ctx->emm_ctx.imsi);
-  if(ctx_it != m_imsi_to_ue_ctx.end())
+  s1ap_shard_t *shard = get_shard();
+  std::map<uint64_t, ue_ctx_t*>::iterator ctx_it = shard->imsi_to_ue_ctx.find(ue_ctx->emm_ctx.imsi);
+  if(ctx_it != shard->imsi_to_ue_ctx.end())
   {
     m_s1ap_log->error("UE Context already exists. IMSI %015lu",ue_ctx->emm_ctx.imsi);
     return false;
   }
   if(ue_ctx->ecm_ctx.mme_ue_s1ap_id != 0)
   {
-    std::map<uint32_t,ue_ctx_t*>::iterator ctx_it2 = m_mme_ue_s1ap_id_to_ue_ctx.find(ue_ctx->ecm_ctx.mme_ue_s1ap_id);
-    if(ctx_it2 != m_mme_ue_s1ap_id_to_ue_ctx.end() && ctx_it2->second != ue_ctx)
+    std::map<uint32_t,ue_ctx_t*>::iterator ctx_it2 = shard->mme_ue_s1ap_id_to_ue_ctx.find(ue_ctx->ecm_ctx.mme_ue_s1ap_id);
+    if(ctx_it2 != shard->mme_ue_s1ap_id_to_ue_ctx.end() && ctx_it2->second != ue_ctx)
     {
       m_s1ap_log->error("Context identified with IMSI does not match context identified by MME UE S1AP Id.\n");
       return false;
     }
   }
-  m_imsi_to_ue_ctx.insert(std::pair<uint64_t,ue_ctx_t*>(ue_ctx->emm_ctx.imsi, ue_ctx));
+
+  //Make the IMSI owned by this shard
+  uint32_t shard_idx = get_worker_shard();
+  pthread_mutex_lock(&m_imsi_to_shard_mutex);
+  std::map<uint64_t,uint32_t>::iterator shard_it = m_imsi_to_shard.find(ue_ctx->emm_ctx.imsi);
+  if(shard_it != m_imsi_to_shard.end() && shard_it->second != shard_idx)
+  {
+    uint32_t owner = shard_it->second;
+    pthread_mutex_unlock(&m_imsi_to_shard_mutex);
+    m_s1ap_log->error("UE Context already exists in shard %d. IMSI %015lu",owner, ue_ctx->emm_ctx.imsi);
+    return false;
+  }
+  m_imsi_to_shard[ue_ctx->emm_ctx.imsi] = shard_idx;
+  pthread_mutex_unlock(&m_imsi_to_shard_mutex);
+
+  shard->imsi_to_ue_ctx.insert(std::pair<uint64_t,ue_ctx_t*>(ue_ctx->emm_ctx.imsi, ue_ctx));
   m_s1ap_log->debug("Saved UE context corresponding to IMSI %015lu\n",ue_ctx->emm_ctx.imsi);
   return true;
 }
@@ -401,22 +652,23 @@ s1ap::add_ue_ctx_to_mme_ue_s1ap_id_map(ue_ctx_t *ue_ctx)
     m_s1ap_log->error("Could not add UE context to MME UE S1AP map. MME UE S1AP ID 0 is not valid.");
     return false;
   }
-  std::map<uint32_t, ue_ctx_t*>::iterator ctx_it = m_mme_ue_s1ap_id_to_ue_ctx.find(ue_ctx->ecm_ctx.mme_ue_s1ap_id);
-  if(ctx_it != m_mme_ue_s1ap_id_to_ue_ctx.end())
+  s1ap_shard_t *shard = get_shard();
+  std::map<uint32_t, ue_ctx_t*>::iterator ctx_it = shard->mme_ue_s1ap_id_to_ue_ctx.find(ue_ctx->ecm_ctx.mme_ue_s1ap_id);
+  if(ctx_it != shard->mme_ue_s1ap_id_to_ue_ctx.end())
   {
     m_s1ap_log->error("UE Context already exists. MME UE S1AP Id %015lu",ue_ctx->emm_ctx.imsi);
     return false;
   }
   if(ue_ctx->ecm_ctx.imsi != 0)
   {
-    std::map<uint32_t,ue_ctx_t*>::iterator ctx_it2 = m_mme_ue_s1ap_id_to_ue_ctx.find(ue_ctx->ecm_ctx.mme_ue_s1ap_id);
-    if(ctx_it2 != m_mme_ue_s1ap_id_to_ue_ctx.end() && ctx_it2->second != ue_ctx)
+    std::map<uint32_t,ue_ctx_t*>::iterator ctx_it2 = shard->mme_ue_s1ap_id_to_ue_ctx.find(ue_ctx->ecm_ctx.mme_ue_s1ap_id);
+    if(ctx_it2 != shard->mme_ue_s1ap_id_to_ue_ctx.end() && ctx_it2->second != ue_ctx)
     {
       m_s1ap_log->error("Context identified with MME UE S1AP Id does not match context identified by IMSI.\n");
       return false;
     }
   }
-  m_mme_ue_s1ap_id_to_ue_ctx.insert(std::pair<uint32_t,ue_ctx_t*>(ue_ctx->ecm_ctx.mme_ue_s1ap_id, ue_ctx));
+  shard->mme_ue_s1ap_id_to_ue_ctx.insert(std::pair<uint32_t,ue_ctx_t*>(ue_ctx->ecm_ctx.mme_ue_s1ap_id, ue_ctx));
   m_s1ap_log->debug("Saved UE context corresponding to MME UE S1AP Id %d\n",ue_ctx->ecm_ctx.mme_ue_s1ap_id);
   return true;
 }
@@ -424,20 +676,23 @@ s1ap::add_ue_ctx_to_mme_ue_s1ap_id_map(ue_ctx_t *ue_ctx)
 bool
 s1ap::add_ue_to_enb_set(int32_t enb_assoc, uint32_t mme_ue_s1ap_id)
 {
-
+  pthread_mutex_lock(&m_enb_mutex);
   std::map<int32_t,std::set<uint32_t> >::iterator ues_in_enb = m_enb_assoc_to_ue_ids.find(enb_assoc);
   if(ues_in_enb == m_enb_assoc_to_ue_ids.end())
   {
+    pthread_mutex_unlock(&m_enb_mutex);
     m_s1ap_log->error("Could not find eNB from eNB SCTP association %d",enb_assoc);
     return false;
   }
   std::set<uint32_t>::iterator ue_id = ues_in_enb->second.find(mme_ue_s1ap_id);
   if(ue_id != ues_in_enb->second.end())
   {
+    pthread_mutex_unlock(&m_enb_mutex);
     m_s1ap_log->error("UE with MME UE S1AP Id already exists %d",mme_ue_s1ap_id);
     return false;
   }
   ues_in_enb->second.insert(mme_ue_s1ap_id);
+  pthread_mutex_unlock(&m_enb_mutex);
   m_s1ap_log->debug("Added UE with MME-UE S1AP Id %d to eNB with association %d\n", mme_ue_s1ap_id, enb_assoc);
   return true;
 }
@@ -445,8 +700,9 @@ s1ap::add_ue_to_enb_set(int32_t enb_assoc, uint32_t mme_ue_s1ap_id)
 ue_ctx_t*
 s1ap::find_ue_ctx_from_mme_ue_s1ap_id(uint32_t mme_ue_s1ap_id)
 {
-  std::map<uint32_t, ue_ctx_t*>::iterator it = m_mme_ue_s1ap_id_to_ue_ctx.find(mme_ue_s1ap_id);
-  if(it == m_mme_ue_s1ap_id_to_ue_ctx.end())
+  s1ap_shard_t *shard = get_shard();
+  std::map<uint32_t, ue_ctx_t*>::iterator it = shard->mme_ue_s1ap_id_to_ue_ctx.find(mme_ue_s1ap_id);
+  if(it == shard->mme_ue_s1ap_id_to_ue_ctx.end())
   {
     return NULL;
   }
@@ -459,8 +715,9 @@ s1ap::find_ue_ctx_from_mme_ue_s1ap_id(uint32_t mme_ue_s1ap_id)
 ue_ctx_t*
 s1ap::find_ue_ctx_from_imsi(uint64_t imsi)
 {
-  std::map<uint64_t, ue_ctx_t*>::iterator it = m_imsi_to_ue_ctx.find(imsi);
-  if(it == m_imsi_to_ue_ctx.end())
+  s1ap_shard_t *shard = get_shard();
+  std::map<uint64_t, ue_ctx_t*>::iterator it = shard->imsi_to_ue_ctx.find(imsi);
+  if(it == shard->imsi_to_ue_ctx.end())
   {
     return NULL;
   }
@@ -470,36 +727,75 @@ s1ap::find_ue_ctx_from_imsi(uint64_t imsi)
   }
 }
 
+bool
+s1ap::find_imsi_from_m_tmsi(uint32_t m_tmsi, uint64_t *imsi)
+{
+  s1ap_shard_t *shard = get_shard();
+  std::map<uint32_t, uint64_t>::iterator it = shard->tmsi_to_imsi.find(m_tmsi);
+  if(it == shard->tmsi_to_imsi.end())
+  {
+    return false;
+  }
+  *imsi = it->second;
+  return true;
+}
+
 void
 s1ap::release_ues_ecm_ctx_in_enb(int32_t enb_assoc)
 {
   m_s1ap_log->console("Releasing UEs context\n");
-  //delete UEs ctx
+  //Only the UEs of the calling worker's shard are released
+  uint32_t shard_idx = get_worker_shard();
+  s1ap_shard_t *shard = &m_shards[shard_idx];
+  std::vector<uint32_t> ue_ids;
+
+  pthread_mutex_lock(&m_enb_mutex);
   std::map<int32_t,std::set<uint32_t> >::iterator ues_in_enb = m_enb_assoc_to_ue_ids.find(enb_assoc);
-  std::set<uint32_t>::iterator ue_id = ues_in_enb->second.begin();
-  if(ue_id == ues_in_enb->second.end())
+  if(ues_in_enb != m_enb_assoc_to_ue_ids.end())
   {
-    m_s1ap_log->console("No UEs to be released\n");
-  } else {
-    while(ue_id != ues_in_enb->second.end() )
+    std::set<uint32_t>::iterator ue_id = ues_in_enb->second.begin();
+    while(ue_id != ues_in_enb->second.end())
     {
-      std::map<uint32_t, ue_ctx_t*>::iterator ue_ctx = m_mme_ue_s1ap_id_to_ue_ctx.find(*ue_id);
-      ue_emm_ctx_t *emm_ctx = &ue_ctx->second->emm_ctx;
-      ue_ecm_ctx_t *ecm_ctx = &ue_ctx->second->ecm_ctx;
-
-      m_s1ap_log->info("Releasing UE context. IMSI: %015lu, UE-MME S1AP Id: %d\n", emm_ctx->imsi, ecm_ctx->mme_ue_s1ap_id);
-      if(emm_ctx->state == EMM_STATE_REGISTERED)
+      if(*ue_id % m_shards.size() == shard_idx)
+      {
+        ue_ids.push_back(*ue_id);
+        ues_in_enb->second.erase(ue_id++);
+      }
+      else
       {
-        m_mme_gtpc->send_delete_session_request(emm_ctx->imsi);
-        emm_ctx->state = EMM_STATE_DEREGISTERED;
+        ue_id++;
       }
-      m_s1ap_log->console("Releasing UE ECM context. UE-MME S1AP Id: %d\n", ecm_ctx->mme_ue_s1ap_id);
-      ecm_ctx->state = ECM_STATE_IDLE;
-      ecm_ctx->mme_ue_s1ap_id = 0;
-      ecm_ctx->enb_ue_s1ap_id = 0;
-      ues_in_enb->second.erase(ue_id++);
     }
   }
+  pthread_mutex_unlock(&m_enb_mutex);
+
+  if(ue_ids.empty())
+  {
+    m_s1ap_log->console("No UEs to be released\n");
+    return;
+  }
+  for(uint32_t i=0; i<ue_ids.size(); i++)
+  {
+    std::map<uint32_t, ue_ctx_t*>::iterator ue_ctx = shard->mme_ue_s1ap_id_to_ue_ctx.find(ue_ids[i]);
+    if(ue_ctx == shard->mme_ue_s1ap_id_to_ue_ctx.end())
+    {
+      continue;
+    }
+    ue_emm_ctx_t *emm_ctx = &ue_ctx->second->emm_ctx;
+    ue_ecm_ctx_t *ecm_ctx = &ue_ctx->second->ecm_ctx;
+
+    m_s1ap_log->info("Releasing UE context. IMSI: %015lu, UE-MME S1AP Id: %d\n", emm_ctx->imsi, ecm_ctx->mme_ue_s1ap_id);
+    if(emm_ctx->state == EMM_STATE_REGISTERED)
+    {
+      m_mme_gtpc->send_delete_session_request(emm_ctx->imsi);
+      emm_ctx->state = EMM_STATE_DEREGISTERED;
+    }
+    m_s1ap_log->console("Releasing UE ECM context. UE-MME S1AP Id: %d\n", ecm_ctx->mme_ue_s1ap_id);
+    ecm_ctx->state = ECM_STATE_IDLE;
+    ecm_ctx->mme_ue_s1ap_id = 0;
+    ecm_ctx->enb_ue_s1ap_id = 0;
+    shard->mme_ue_s1ap_id_to_ue_ctx.erase(ue_ctx);
+  }
 }
 
 bool
@@ -514,9 +810,11 @@ s1ap::release_ue_ecm_ctx(uint32_t mme_ue_s1ap_id)
   ue_ecm_ctx_t* ecm_ctx = &ue_ctx->ecm_ctx;
 
   //Delete UE within eNB UE set
+  pthread_mutex_lock(&m_enb_mutex);
   std::map<int32_t,uint16_t>::iterator it = m_sctp_to_enb_id.find(ecm_ctx->enb_sri.sinfo_assoc_id);
   if(it == m_sctp_to_enb_id.end() )
   {
+    pthread_mutex_unlock(&m_enb_mutex);
     m_s1ap_log->error("Could not find eNB for UE release request.\n");
     return false;
   }
@@ -524,13 +822,15 @@ s1ap::release_ue_ecm_ctx(uint32_t mme_ue_s1ap_id)
   std::map<int32_t,std::set<uint32_t> >::iterator ue_set = m_enb_assoc_to_ue_ids.find(ecm_ctx->enb_sri.sinfo_assoc_id);
   if(ue_set == m_enb_assoc_to_ue_ids.end())
   {
+    pthread_mutex_unlock(&m_enb_mutex);
     m_s1ap_log->error("Could not find the eNB's UEs.\n");
     return false;
   }
   ue_set->second.erase(mme_ue_s1ap_id);
+  pthread_mutex_unlock(&m_enb_mutex);
 
   //Release UE ECM context
-  m_mme_ue_s1ap_id_to_ue_ctx.erase(mme_ue_s1ap_id);
+  get_shard()->mme_ue_s1ap_id_to_ue_ctx.erase(mme_ue_s1ap_id);
   ecm_ctx->state = ECM_STATE_IDLE;
   ecm_ctx->mme_ue_s1ap_id = 0;
   ecm_ctx->enb_ue_s1ap_id = 0;
@@ -556,7 +856,10 @@ s1ap::delete_ue_ctx(uint64_t imsi)
   }
 
   //Delete UE context
-  m_imsi_to_ue_ctx.erase(imsi);
+  get_shard()->imsi_to_ue_ctx.erase(imsi);
+  pthread_mutex_lock(&m_imsi_to_shard_mutex);
+  m_imsi_to_shard.erase(imsi);
+  pthread_mutex_unlock(&m_imsi_to_shard_mutex);
   delete ue_ctx;
   m_s1ap_log->info("Deleted UE Context.\n");
   return true;
@@ -569,16 +872,17 @@ s1ap::delete_ue_ctx(uint64_t imsi)
 void
 s1ap::activate_eps_bearer(uint64_t imsi, uint8_t ebi)
 {
-  std::map<uint64_t,ue_ctx_t*>::iterator ue_ctx_it = m_imsi_to_ue_ctx.find(imsi);
-  if(ue_ctx_it == m_imsi_to_ue_ctx.end())
+  s1ap_shard_t *shard = get_shard();
+  std::map<uint64_t,ue_ctx_t*>::iterator ue_ctx_it = shard->imsi_to_ue_ctx.find(imsi);
+  if(ue_ctx_it == shard->imsi_to_ue_ctx.end())
   {
     m_s1ap_log->error("Could not activate EPS bearer: Could not find UE context\n");
       return;
   }
   //Make sure NAS is active
   uint32_t mme_ue_s1ap_id = ue_ctx_it->second->ecm_ctx.mme_ue_s1ap_id;
-  std::map<uint32_t,ue_ctx_t*>::iterator it = m_mme_ue_s1ap_id_to_ue_ctx.find(mme_ue_s1ap_id);
-  if(it == m_mme_ue_s1ap_id_to_ue_ctx.end())
+  std::map<uint32_t,ue_ctx_t*>::iterator it = shard->mme_ue_s1ap_id_to_ue_ctx.find(mme_ue_s1ap_id);
+  if(it == shard->mme_ue_s1ap_id_to_ue_ctx.end())
   {
     m_s1ap_log->error("Could not activate EPS bearer: ECM context seems to be missing\n");
     return;
@@ -601,10 +905,11 @@ s1ap::activate_eps_bearer(uint64_t imsi, uint8_t ebi)
 uint32_t
 s1ap::allocate_m_tmsi(uint64_t imsi)
 {
-  uint32_t m_tmsi = m_next_m_tmsi;
-  m_next_m_tmsi = (m_next_m_tmsi + 1) % UINT32_MAX;
+  s1ap_shard_t *shard = get_shard();
+  uint32_t m_tmsi = shard->next_m_tmsi;
+  shard->next_m_tmsi += m_shards.size();
 
-  m_tmsi_to_imsi.insert(std::pair<uint32_t,uint64_t>(m_tmsi,imsi));
+  shard->tmsi_to_imsi.insert(std::pair<uint32_t,uint64_t>(m_tmsi,imsi));
   m_s1ap_log->debug("Allocated M-TMSI 0x%x to IMSI %015lu,\n",m_tmsi,imsi);
   return m_tmsi;
 }
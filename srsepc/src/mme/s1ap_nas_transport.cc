@@ -553,8 +553,8 @@ s1ap_nas_transport::handle_nas_guti_attach_request(  uint32_t enb_ue_s1ap_id,
 
   //GUTI style attach
   uint32_t m_tmsi = attach_req.eps_mobile_id.guti.m_tmsi;
-  std::map<uint32_t,uint64_t>::iterator it = m_s1ap->m_tmsi_to_imsi.find(m_tmsi);
-  if(it == m_s1ap->m_tmsi_to_imsi.end())
+  uint64_t imsi = 0;
+  if(!m_s1ap->find_imsi_from_m_tmsi(m_tmsi, &imsi))
   {
 
     m_s1ap_log->console("Attach Request -- Could not find M-TMSI 0x%x\n", m_tmsi);
@@ -635,9 +635,9 @@ s1ap_nas_transport::handle_nas_guti_attach_request(  uint32_t enb_ue_s1ap_id,
   else{
 
     m_s1ap_log->console("Attach Request -- Found M-TMSI: %d\n",m_tmsi);
-    m_s1ap_log->console("Attach Request -- IMSI: %015lu\n",it->second);
+    m_s1ap_log->console("Attach Request -- IMSI: %015lu\n",imsi);
     //Get UE EMM context
-    ue_ctx_t *ue_ctx = m_s1ap->find_ue_ctx_from_imsi(it->second);
+    ue_ctx_t *ue_ctx = m_s1ap->find_ue_ctx_from_imsi(imsi);
     if(ue_ctx!=NULL)
     {
       ue_emm_ctx_t *emm_ctx = &ue_ctx->emm_ctx;
@@ -824,8 +824,8 @@ s1ap_nas_transport::handle_nas_service_request(uint32_t m_tmsi,
     return false;
   }
 
-  std::map<uint32_t,uint64_t>::iterator it = m_s1ap->m_tmsi_to_imsi.find(m_tmsi);
-  if(it == m_s1ap->m_tmsi_to_imsi.end())
+  uint64_t imsi = 0;
+  if(!m_s1ap->find_imsi_from_m_tmsi(m_tmsi, &imsi))
   {
     m_s1ap_log->console("Could not find IMSI from M-TMSI. M-TMSI 0x%x\n", m_tmsi);
     m_s1ap_log->error("Could not find IMSI from M-TMSI. M-TMSI 0x%x\n", m_tmsi);
@@ -834,7 +834,7 @@ s1ap_nas_transport::handle_nas_service_request(uint32_t m_tmsi,
     return true;
   }
 
-  ue_ctx_t *ue_ctx = m_s1ap->find_ue_ctx_from_imsi(it->second);
+  ue_ctx_t *ue_ctx = m_s1ap->find_ue_ctx_from_imsi(imsi);
   if(ue_ctx == NULL || ue_ctx->emm_ctx.state != EMM_STATE_REGISTERED)
   {
     m_s1ap_log->console("UE is not EMM-Registered.\n");
@@ -923,14 +923,14 @@ s1ap_nas_transport::handle_nas_detach_request(uint32_t m_tmsi,
     return false;
   }
 
-  std::map<uint32_t,uint64_t>::iterator it = m_s1ap->m_tmsi_to_imsi.find(m_tmsi);
-  if(it == m_s1ap->m_tmsi_to_imsi.end())
+  uint64_t imsi = 0;
+  if(!m_s1ap->find_imsi_from_m_tmsi(m_tmsi, &imsi))
   {
     m_s1ap_log->console("Could not find IMSI from M-TMSI. M-TMSI 0x%x\n", m_tmsi);
     m_s1ap_log->error("Could not find IMSI from M-TMSI. M-TMSI 0x%x\n", m_tmsi);
     return true;
   }
-  ue_ctx_t *ue_ctx = m_s1ap->find_ue_ctx_from_imsi(it->second);
+  ue_ctx_t *ue_ctx = m_s1ap->find_ue_ctx_from_imsi(imsi);
   ue_emm_ctx_t *emm_ctx = &ue_ctx->emm_ctx;
   ue_ecm_ctx_t *ecm_ctx = &ue_ctx->ecm_ctx;
 
@@ -983,14 +983,14 @@ s1ap_nas_transport::handle_nas_tracking_area_update_request(uint32_t m_tmsi,
   m_s1ap_log->console("Warning: Tracking area update requests are not handled yet.\n");
   m_s1ap_log->warning("Tracking area update requests are not handled yet.\n");
 
-  std::map<uint32_t,uint64_t>::iterator it = m_s1ap->m_tmsi_to_imsi.find(m_tmsi);
-  if(it == m_s1ap->m_tmsi_to_imsi.end())
+  uint64_t imsi = 0;
+  if(!m_s1ap->find_imsi_from_m_tmsi(m_tmsi, &imsi))
   {
     m_s1ap_log->console("Could not find IMSI from M-TMSI. M-TMSI 0x%x\n", m_tmsi);
     m_s1ap_log->error("Could not find IMSI from M-TMSI. M-TMSI 0x%x\n", m_tmsi);
     return true;
   }
-  ue_ctx_t *ue_ctx = m_s1ap->find_ue_ctx_from_imsi(it->second);
+  ue_ctx_t *ue_ctx = m_s1ap->find_ue_ctx_from_imsi(imsi);
   ue_emm_ctx_t *emm_ctx = &ue_ctx->emm_ctx;
   ue_ecm_ctx_t *ecm_ctx = &ue_ctx->ecm_ctx;
 
@@ -0,0 +1,1402 @@
+/**
+ *
+ * \section COPYRIGHT
+ *
+ * Copyright 2013-2017 Software Radio Systems Limited
+ *
+ * \section LICENSE
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ * File:        mme_stress_test.cc
+ * Description: S1AP/NAS control plane load generator for srsEPC.
+ *              Opens one SCTP association per simulated eNB, performs
+ *              S1 Setup and drives Attach, Detach, Service Request and
+ *              Tracking Area Update procedures for a population of
+ *              simulated UEs at configurable rates. Reports per
+ *              procedure latency percentiles.
+ *
+ *              The HSS must know the simulated subscribers. Use --db_out
+ *              to write a matching user_db.csv before starting srsepc.
+ *****************************************************************************/
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <deque>
+#include <map>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <signal.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/sctp.h>
+#include <arpa/inet.h>
+#include <boost/program_options.hpp>
+
+#include "srslte/common/log_filter.h"
+#include "srslte/common/logger_stdout.h"
+#include "srslte/common/threads.h"
+#include "srslte/common/common.h"
+#include "srslte/common/security.h"
+#include "srslte/common/bcd_helpers.h"
+#include "srslte/common/int_helpers.h"
+#include "srslte/asn1/liblte_mme.h"
+#include "srslte/asn1/liblte_s1ap.h"
+
+using namespace srslte;
+namespace bpo = boost::program_options;
+
+#define S1AP_PORT         36412
+#define S1AP_PPID         18
+#define NONUE_STREAM_ID   0
+#define UE_STREAM_ID      1
+
+typedef struct {
+  std::string mme_addr;
+  std::string s1c_bind_addr;
+  std::string gtp_bind_addr;
+  std::string mcc;
+  std::string mnc;
+  uint32_t    tac;
+  uint32_t    enb_id;
+  uint32_t    nof_enbs;
+  uint32_t    nof_ues;
+  uint64_t    imsi_base;
+  std::string k;
+  std::string opc;
+  std::string auth_algo;
+  float       attach_rate;
+  float       detach_rate;
+  float       service_rate;
+  float       tau_rate;
+  uint32_t    duration_sec;
+  uint32_t    timeout_ms;
+  uint32_t    log_level;
+  std::string db_out;
+} stress_test_args_t;
+
+typedef enum {
+  PROC_ATTACH = 0,
+  PROC_DETACH,
+  PROC_SERVICE_REQUEST,
+  PROC_TAU,
+  PROC_RELEASE,
+  PROC_N_ITEMS,
+} proc_t;
+static const char proc_text[PROC_N_ITEMS][20] = {"Attach",
+                                                 "Detach",
+                                                 "Service Request",
+                                                 "TAU",
+                                                 "Release"};
+
+typedef enum {
+  UE_DEREGISTERED = 0,
+  UE_ATTACHING,
+  UE_SERVICE_REQUEST,
+  UE_RELEASING,
+  UE_IDLE,
+  UE_DETACHING,
+} ue_state_t;
+
+bool running = true;
+
+void sig_int_handler(int signo)
+{
+  running = false;
+}
+
+static uint64_t now_usec()
+{
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return (uint64_t) t.tv_sec*1000000 + t.tv_nsec/1000;
+}
+
+static void hex_str_to_vec(std::string str, uint8_t *vec, uint32_t len)
+{
+  for (uint32_t i = 0; i < len; i++) {
+    vec[i] = (uint8_t) strtoul(str.substr(2*i, 2).c_str(), NULL, 16);
+  }
+}
+
+/*******************************************************************************
+  Procedure statistics
+*******************************************************************************/
+
+class proc_stats
+{
+public:
+  proc_stats() : started(0), completed(0), failed(0), timed_out(0), skipped(0) {}
+
+  void merge(const proc_stats &other)
+  {
+    started   += other.started;
+    completed += other.completed;
+    failed    += other.failed;
+    timed_out += other.timed_out;
+    skipped   += other.skipped;
+    latency_us.insert(latency_us.end(), other.latency_us.begin(), other.latency_us.end());
+  }
+
+  float percentile_ms(float p)
+  {
+    if (latency_us.empty()) {
+      return 0;
+    }
+    uint32_t idx = (uint32_t) (p/100*(latency_us.size()-1) + 0.5);
+    return (float) latency_us[idx]/1000;
+  }
+
+  uint32_t started;
+  uint32_t completed;
+  uint32_t failed;
+  uint32_t timed_out;
+  uint32_t skipped;
+  std::vector<uint32_t> latency_us;
+};
+
+/*******************************************************************************
+  Simulated UE
+*******************************************************************************/
+
+typedef struct {
+  uint64_t    imsi;
+  uint8_t     imsi_vec[15];
+  uint8_t     k[16];
+  uint8_t     opc[16];
+
+  ue_state_t  state;
+  proc_t      proc;
+  uint64_t    proc_start_us;
+  bool        in_proc;
+
+  uint32_t    enb_ue_s1ap_id;
+  uint32_t    mme_ue_s1ap_id;
+
+  bool                                 have_guti;
+  LIBLTE_MME_EPS_MOBILE_ID_GUTI_STRUCT guti;
+
+  uint8_t                     ksi;
+  uint8_t                     k_asme[32];
+  uint8_t                     k_nas_enc[32];
+  uint8_t                     k_nas_int[32];
+  CIPHERING_ALGORITHM_ID_ENUM cipher_algo;
+  INTEGRITY_ALGORITHM_ID_ENUM integ_algo;
+  uint32_t                    tx_count;
+  uint8_t                     eps_bearer_id;
+  uint8_t                     proc_transaction_id;
+} sim_ue_t;
+
+/*******************************************************************************
+  Simulated eNB. Owns one SCTP association and a slice of the UE population.
+*******************************************************************************/
+
+class sim_enb : public thread
+{
+public:
+  sim_enb() : log(NULL), socket_fd(-1), enb_running(false), next_enb_ue_s1ap_id(1), rx_pdu(NULL), tx_pdu(NULL)
+  {
+    bzero(rate, sizeof(rate));
+    bzero(credit, sizeof(credit));
+  }
+
+  virtual ~sim_enb()
+  {
+    if (socket_fd >= 0) {
+      close(socket_fd);
+    }
+    delete rx_pdu;
+    delete tx_pdu;
+  }
+
+  bool init(stress_test_args_t *args_, uint32_t idx, std::vector<sim_ue_t*> ues_, srslte::log *log_)
+  {
+    args = args_;
+    log  = log_;
+    ues  = ues_;
+    enb_id = args->enb_id + idx;
+
+    string_to_mcc(args->mcc, &mcc);
+    string_to_mnc(args->mnc, &mnc);
+    inet_pton(AF_INET, args->gtp_bind_addr.c_str(), gtp_addr);
+
+    rate[PROC_ATTACH]          = args->attach_rate/args->nof_enbs;
+    rate[PROC_DETACH]          = args->detach_rate/args->nof_enbs;
+    rate[PROC_SERVICE_REQUEST] = args->service_rate/args->nof_enbs;
+    rate[PROC_TAU]             = args->tau_rate/args->nof_enbs;
+
+    rx_pdu = new LIBLTE_S1AP_S1AP_PDU_STRUCT;
+    tx_pdu = new LIBLTE_S1AP_S1AP_PDU_STRUCT;
+
+    for (uint32_t i = 0; i < ues.size(); i++) {
+      dereg_queue.push_back(ues[i]);
+    }
+
+    build_tai_cgi();
+    if (!connect_mme()) {
+      return false;
+    }
+    if (!setup_s1()) {
+      return false;
+    }
+    log->info("S1 Setup complete, eNB ID %d, %d UEs\n", enb_id, (int) ues.size());
+    return true;
+  }
+
+  void stop()
+  {
+    if (enb_running) {
+      enb_running = false;
+      wait_thread_finish();
+    }
+  }
+
+  void start_traffic()
+  {
+    enb_running = true;
+    start();
+  }
+
+  proc_stats stats[PROC_N_ITEMS];
+
+private:
+  stress_test_args_t     *args;
+  srslte::log            *log;
+  std::vector<sim_ue_t*>  ues;
+  uint32_t                enb_id;
+  uint16_t                mcc;
+  uint16_t                mnc;
+  uint8_t                 gtp_addr[4];
+
+  int                     socket_fd;
+  struct sockaddr_in      mme_addr;
+  bool                    enb_running;
+
+  LIBLTE_S1AP_TAI_STRUCT        tai;
+  LIBLTE_S1AP_EUTRAN_CGI_STRUCT eutran_cgi;
+
+  uint32_t                      next_enb_ue_s1ap_id;
+  std::map<uint32_t, sim_ue_t*> enb_ue_s1ap_id_to_ue;
+  std::deque<sim_ue_t*>         dereg_queue;
+  std::deque<sim_ue_t*>         idle_queue;
+
+  float                         rate[PROC_N_ITEMS];
+  float                         credit[PROC_N_ITEMS];
+
+  // S1AP PDUs are large, keep one of each per eNB off the stack
+  LIBLTE_S1AP_S1AP_PDU_STRUCT  *rx_pdu;
+  LIBLTE_S1AP_S1AP_PDU_STRUCT  *tx_pdu;
+  byte_buffer_t                 rx_buf;
+
+  /* Main loop */
+  void run_thread()
+  {
+    uint64_t last_tick = now_usec();
+    uint64_t last_timeout_check = last_tick;
+
+    while (enb_running) {
+      uint64_t now = now_usec();
+      schedule_procedures((float) (now - last_tick)/1e6);
+      last_tick = now;
+
+      struct pollfd pfd;
+      pfd.fd      = socket_fd;
+      pfd.events  = POLLIN;
+      pfd.revents = 0;
+      int n = poll(&pfd, 1, 1);
+      if (n > 0 && (pfd.revents & POLLIN)) {
+        rx_buf.reset();
+        ssize_t n_recv = recv(socket_fd, rx_buf.msg, SRSLTE_MAX_BUFFER_SIZE_BYTES - SRSLTE_BUFFER_HEADER_OFFSET, 0);
+        if (n_recv <= 0) {
+          log->error("eNB %d: MME closed the association\n", enb_id);
+          log->console("eNB %d: MME closed the association\n", enb_id);
+          enb_running = false;
+          break;
+        }
+        rx_buf.N_bytes = n_recv;
+        handle_s1ap_rx_pdu(&rx_buf);
+      }
+
+      if (now - last_timeout_check > 10000) {
+        check_timeouts(now);
+        last_timeout_check = now;
+      }
+    }
+  }
+
+  void schedule_procedures(float dt)
+  {
+    for (uint32_t p = 0; p < PROC_RELEASE; p++) {
+      if (rate[p] <= 0) {
+        continue;
+      }
+      credit[p] += rate[p]*dt;
+      while (credit[p] >= 1) {
+        std::deque<sim_ue_t*> *q = (p == PROC_ATTACH) ? &dereg_queue : &idle_queue;
+        if (q->empty()) {
+          // No UE in the required state, do not accumulate a backlog
+          stats[p].skipped += (uint32_t) credit[p];
+          credit[p] -= (uint32_t) credit[p];
+          break;
+        }
+        sim_ue_t *ue = q->front();
+        q->pop_front();
+        credit[p] -= 1;
+        switch (p) {
+          case PROC_ATTACH:
+            start_attach(ue);
+            break;
+          case PROC_DETACH:
+            start_detach(ue);
+            break;
+          case PROC_SERVICE_REQUEST:
+            start_service_request(ue);
+            break;
+          case PROC_TAU:
+            start_tau(ue);
+            break;
+          default:
+            break;
+        }
+      }
+    }
+  }
+
+  void check_timeouts(uint64_t now)
+  {
+    for (uint32_t i = 0; i < ues.size(); i++) {
+      sim_ue_t *ue = ues[i];
+      if (ue->in_proc && now - ue->proc_start_us > (uint64_t) args->timeout_ms*1000) {
+        log->warning("IMSI %015lu: %s timed out\n", ue->imsi, proc_text[ue->proc]);
+        stats[ue->proc].timed_out++;
+        ue->in_proc = false;
+        // The MME state of this UE is unknown, start over with an IMSI attach
+        enb_ue_s1ap_id_to_ue.erase(ue->enb_ue_s1ap_id);
+        set_state(ue, UE_DEREGISTERED);
+      }
+    }
+  }
+
+  /* UE state handling */
+  void set_state(sim_ue_t *ue, ue_state_t state)
+  {
+    ue->state = state;
+    if (state == UE_DEREGISTERED) {
+      ue->have_guti = false;
+      dereg_queue.push_back(ue);
+    } else if (state == UE_IDLE) {
+      idle_queue.push_back(ue);
+    }
+  }
+
+  void begin_proc(sim_ue_t *ue, proc_t proc)
+  {
+    ue->proc          = proc;
+    ue->in_proc       = true;
+    ue->proc_start_us = now_usec();
+    stats[proc].started++;
+  }
+
+  void end_proc(sim_ue_t *ue, bool success)
+  {
+    if (!ue->in_proc) {
+      return;
+    }
+    ue->in_proc = false;
+    if (success) {
+      stats[ue->proc].completed++;
+      stats[ue->proc].latency_us.push_back((uint32_t) (now_usec() - ue->proc_start_us));
+    } else {
+      stats[ue->proc].failed++;
+    }
+  }
+
+  uint32_t new_ue_connection(sim_ue_t *ue)
+  {
+    ue->enb_ue_s1ap_id = next_enb_ue_s1ap_id++;
+    if (next_enb_ue_s1ap_id > 0xFFFFFF) {
+      next_enb_ue_s1ap_id = 1;
+    }
+    ue->mme_ue_s1ap_id = 0;
+    enb_ue_s1ap_id_to_ue[ue->enb_ue_s1ap_id] = ue;
+    return ue->enb_ue_s1ap_id;
+  }
+
+  sim_ue_t* find_ue(uint32_t enb_ue_s1ap_id)
+  {
+    std::map<uint32_t, sim_ue_t*>::iterator it = enb_ue_s1ap_id_to_ue.find(enb_ue_s1ap_id);
+    if (it == enb_ue_s1ap_id_to_ue.end()) {
+      return NULL;
+    }
+    return it->second;
+  }
+
+  /* NAS security */
+  void integrity_generate(sim_ue_t *ue, uint32_t count, uint8_t *msg, uint32_t msg_len, uint8_t *mac)
+  {
+    switch (ue->integ_algo) {
+      case INTEGRITY_ALGORITHM_ID_128_EIA1:
+        security_128_eia1(&ue->k_nas_int[16], count, 0, SECURITY_DIRECTION_UPLINK, msg, msg_len, mac);
+        break;
+      case INTEGRITY_ALGORITHM_ID_128_EIA2:
+        security_128_eia2(&ue->k_nas_int[16], count, 0, SECURITY_DIRECTION_UPLINK, msg, msg_len, mac);
+        break;
+      default:
+        break;
+    }
+  }
+
+  void protect_nas(sim_ue_t *ue, byte_buffer_t *pdu, bool cipher)
+  {
+    if (pdu->N_bytes <= 6) {
+      log->error("Invalid NAS PDU size %d\n", pdu->N_bytes);
+      return;
+    }
+    if (cipher && ue->cipher_algo != CIPHERING_ALGORITHM_ID_EEA0) {
+      uint8_t tmp[SRSLTE_MAX_BUFFER_SIZE_BYTES];
+      if (ue->cipher_algo == CIPHERING_ALGORITHM_ID_128_EEA1) {
+        security_128_eea1(&ue->k_nas_enc[16], ue->tx_count, 0, SECURITY_DIRECTION_UPLINK,
+                          &pdu->msg[6], pdu->N_bytes - 6, tmp);
+      } else {
+        security_128_eea2(&ue->k_nas_enc[16], ue->tx_count, 0, SECURITY_DIRECTION_UPLINK,
+                          &pdu->msg[6], pdu->N_bytes - 6, tmp);
+      }
+      memcpy(&pdu->msg[6], tmp, pdu->N_bytes - 6);
+    }
+    integrity_generate(ue, ue->tx_count, &pdu->msg[5], pdu->N_bytes - 5, &pdu->msg[1]);
+  }
+
+  bool generate_auth_response(sim_ue_t *ue, uint8_t *rand, uint8_t *autn, uint8_t *res)
+  {
+    uint8_t ck[16], ik[16], ak[6], sqn[6], amf[2], mac[8];
+    uint8_t xdout[16];
+
+    if (args->auth_algo == "xor") {
+      for (uint32_t i = 0; i < 16; i++) {
+        xdout[i] = ue->k[i]^rand[i];
+      }
+      for (uint32_t i = 0; i < 16; i++) {
+        res[i] = xdout[i];
+        ck[i]  = xdout[(i+1)%16];
+        ik[i]  = xdout[(i+2)%16];
+      }
+      for (uint32_t i = 0; i < 6; i++) {
+        ak[i] = xdout[i+3];
+      }
+    } else {
+      security_milenage_f2345(ue->k, ue->opc, rand, res, ck, ik, ak);
+    }
+
+    for (uint32_t i = 0; i < 6; i++) {
+      sqn[i] = autn[i]^ak[i];
+    }
+    amf[0] = autn[6];
+    amf[1] = autn[7];
+
+    if (args->auth_algo == "xor") {
+      for (uint32_t i = 0; i < 8; i++) {
+        mac[i] = xdout[i]^(i < 6 ? sqn[i] : amf[i-6]);
+      }
+    } else {
+      security_milenage_f1(ue->k, ue->opc, rand, sqn, amf, mac);
+    }
+
+    if (memcmp(mac, &autn[8], 8)) {
+      log->warning("IMSI %015lu: network authentication failed\n", ue->imsi);
+      return false;
+    }
+
+    security_generate_k_asme(ck, ik, ak, sqn, mcc, mnc, ue->k_asme);
+    return true;
+  }
+
+  /* Procedure triggers */
+  void start_attach(sim_ue_t *ue)
+  {
+    LIBLTE_MME_ATTACH_REQUEST_MSG_STRUCT           attach_req;
+    LIBLTE_MME_PDN_CONNECTIVITY_REQUEST_MSG_STRUCT pdn_con_req;
+    byte_buffer_t                                  nas;
+    bzero(&attach_req, sizeof(attach_req));
+    bzero(&pdn_con_req, sizeof(pdn_con_req));
+
+    ue->tx_count  = 0;
+    ue->have_guti = false;
+
+    attach_req.eps_attach_type = LIBLTE_MME_EPS_ATTACH_TYPE_EPS_ATTACH;
+    for (uint32_t i = 0; i < 8; i++) {
+      attach_req.ue_network_cap.eea[i] = i < 3;
+      attach_req.ue_network_cap.eia[i] = i > 0 && i < 3;
+    }
+    attach_req.eps_mobile_id.type_of_id = LIBLTE_MME_EPS_MOBILE_ID_TYPE_IMSI;
+    memcpy(attach_req.eps_mobile_id.imsi, ue->imsi_vec, 15);
+    attach_req.nas_ksi.tsc_flag = LIBLTE_MME_TYPE_OF_SECURITY_CONTEXT_FLAG_NATIVE;
+    attach_req.nas_ksi.nas_ksi  = 0;
+
+    pdn_con_req.eps_bearer_id       = 0;
+    pdn_con_req.proc_transaction_id = 1;
+    pdn_con_req.pdn_type            = LIBLTE_MME_PDN_TYPE_IPV4;
+    pdn_con_req.request_type        = LIBLTE_MME_REQUEST_TYPE_INITIAL_REQUEST;
+    liblte_mme_pack_pdn_connectivity_request_msg(&pdn_con_req, &attach_req.esm_msg);
+
+    liblte_mme_pack_attach_request_msg(&attach_req, (LIBLTE_BYTE_MSG_STRUCT*) &nas);
+
+    new_ue_connection(ue);
+    ue->state = UE_ATTACHING;
+    begin_proc(ue, PROC_ATTACH);
+    send_initialuemessage(ue, &nas, false);
+  }
+
+  void start_service_request(sim_ue_t *ue)
+  {
+    byte_buffer_t nas;
+    uint8_t       mac[4];
+
+    nas.msg[0] = (LIBLTE_MME_SECURITY_HDR_TYPE_SERVICE_REQUEST << 4) | LIBLTE_MME_PD_EPS_MOBILITY_MANAGEMENT;
+    nas.msg[1] = ((ue->ksi & 0x07) << 5) | (ue->tx_count & 0x1F);
+    integrity_generate(ue, ue->tx_count, &nas.msg[0], 2, mac);
+    nas.msg[2] = mac[2];
+    nas.msg[3] = mac[3];
+    nas.N_bytes = 4;
+    ue->tx_count++;
+
+    new_ue_connection(ue);
+    ue->state = UE_SERVICE_REQUEST;
+    begin_proc(ue, PROC_SERVICE_REQUEST);
+    send_initialuemessage(ue, &nas, true);
+  }
+
+  void start_tau(sim_ue_t *ue)
+  {
+    LIBLTE_MME_EPS_UPDATE_TYPE_STRUCT update_type;
+    LIBLTE_MME_NAS_KEY_SET_ID_STRUCT  nas_ksi;
+    LIBLTE_MME_EPS_MOBILE_ID_STRUCT   old_guti;
+    byte_buffer_t                     nas;
+    uint8_t                          *ptr = nas.msg;
+
+    update_type.type        = LIBLTE_MME_EPS_UPDATE_TYPE_TA_UPDATING;
+    update_type.active_flag = false;
+    nas_ksi.tsc_flag        = LIBLTE_MME_TYPE_OF_SECURITY_CONTEXT_FLAG_NATIVE;
+    nas_ksi.nas_ksi         = ue->ksi;
+    bzero(&old_guti, sizeof(old_guti));
+    old_guti.type_of_id = LIBLTE_MME_EPS_MOBILE_ID_TYPE_GUTI;
+    memcpy(&old_guti.guti, &ue->guti, sizeof(LIBLTE_MME_EPS_MOBILE_ID_GUTI_STRUCT));
+
+    // liblte_mme has no TAU Request packer, build the mandatory IEs by hand
+    *ptr++ = (LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY << 4) | LIBLTE_MME_PD_EPS_MOBILITY_MANAGEMENT;
+    ptr += 4; // MAC
+    *ptr++ = ue->tx_count & 0xFF;
+    *ptr++ = LIBLTE_MME_PD_EPS_MOBILITY_MANAGEMENT;
+    *ptr++ = LIBLTE_MME_MSG_TYPE_TRACKING_AREA_UPDATE_REQUEST;
+    *ptr   = 0;
+    liblte_mme_pack_eps_update_type_ie(&update_type, 0, &ptr);
+    liblte_mme_pack_nas_key_set_id_ie(&nas_ksi, 4, &ptr);
+    ptr++;
+    liblte_mme_pack_eps_mobile_id_ie(&old_guti, &ptr);
+    nas.N_bytes = ptr - nas.msg;
+    protect_nas(ue, &nas, false);
+    ue->tx_count++;
+
+    // The MME does not answer TAU Requests yet, only the number sent is reported
+    uint32_t enb_ue_s1ap_id = new_ue_connection(ue);
+    begin_proc(ue, PROC_TAU);
+    if (send_initialuemessage(ue, &nas, true)) {
+      end_proc(ue, true);
+    } else {
+      end_proc(ue, false);
+    }
+    enb_ue_s1ap_id_to_ue.erase(enb_ue_s1ap_id);
+    set_state(ue, UE_IDLE);
+  }
+
+  void start_detach(sim_ue_t *ue)
+  {
+    LIBLTE_MME_DETACH_REQUEST_MSG_STRUCT detach_req;
+    byte_buffer_t                        nas;
+    bzero(&detach_req, sizeof(detach_req));
+
+    detach_req.detach_type.switch_off     = 1;
+    detach_req.detach_type.type_of_detach = LIBLTE_MME_SO_FLAG_SWITCH_OFF;
+    detach_req.eps_mobile_id.type_of_id   = LIBLTE_MME_EPS_MOBILE_ID_TYPE_GUTI;
+    memcpy(&detach_req.eps_mobile_id.guti, &ue->guti, sizeof(LIBLTE_MME_EPS_MOBILE_ID_GUTI_STRUCT));
+    detach_req.nas_ksi.tsc_flag = LIBLTE_MME_TYPE_OF_SECURITY_CONTEXT_FLAG_NATIVE;
+    detach_req.nas_ksi.nas_ksi  = ue->ksi;
+    liblte_mme_pack_detach_request_msg(&detach_req, LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY,
+                                       ue->tx_count, (LIBLTE_BYTE_MSG_STRUCT*) &nas);
+    protect_nas(ue, &nas, false);
+    ue->tx_count++;
+
+    new_ue_connection(ue);
+    ue->state = UE_DETACHING;
+    begin_proc(ue, PROC_DETACH);
+    send_initialuemessage(ue, &nas, true);
+  }
+
+  void start_release(sim_ue_t *ue)
+  {
+    ue->state = UE_RELEASING;
+    begin_proc(ue, PROC_RELEASE);
+    send_uectxtreleaserequest(ue);
+  }
+
+  /* S1AP message handlers */
+  bool handle_s1ap_rx_pdu(byte_buffer_t *pdu)
+  {
+    if (liblte_s1ap_unpack_s1ap_pdu((LIBLTE_BYTE_MSG_STRUCT*) pdu, rx_pdu) != LIBLTE_SUCCESS) {
+      log->error("Failed to unpack received PDU\n");
+      return false;
+    }
+
+    if (rx_pdu->choice_type != LIBLTE_S1AP_S1AP_PDU_CHOICE_INITIATINGMESSAGE) {
+      log->warning("Unhandled S1AP PDU type %d\n", rx_pdu->choice_type);
+      return false;
+    }
+
+    LIBLTE_S1AP_INITIATINGMESSAGE_STRUCT *msg = &rx_pdu->choice.initiatingMessage;
+    switch (msg->choice_type) {
+      case LIBLTE_S1AP_INITIATINGMESSAGE_CHOICE_DOWNLINKNASTRANSPORT:
+        return handle_dlnastransport(&msg->choice.DownlinkNASTransport);
+      case LIBLTE_S1AP_INITIATINGMESSAGE_CHOICE_INITIALCONTEXTSETUPREQUEST:
+        return handle_initialctxtsetuprequest(&msg->choice.InitialContextSetupRequest);
+      case LIBLTE_S1AP_INITIATINGMESSAGE_CHOICE_UECONTEXTRELEASECOMMAND:
+        return handle_uectxtreleasecommand(&msg->choice.UEContextReleaseCommand);
+      default:
+        log->warning("Unhandled initiating message: %s\n", liblte_s1ap_initiatingmessage_choice_text[msg->choice_type]);
+    }
+    return true;
+  }
+
+  bool handle_dlnastransport(LIBLTE_S1AP_MESSAGE_DOWNLINKNASTRANSPORT_STRUCT *msg)
+  {
+    sim_ue_t *ue = find_ue(msg->eNB_UE_S1AP_ID.ENB_UE_S1AP_ID);
+    if (ue == NULL) {
+      log->warning("DownlinkNASTransport for unknown eNB-UE S1AP ID %d\n", msg->eNB_UE_S1AP_ID.ENB_UE_S1AP_ID);
+      return false;
+    }
+    ue->mme_ue_s1ap_id = msg->MME_UE_S1AP_ID.MME_UE_S1AP_ID;
+
+    byte_buffer_t nas;
+    bzero(nas.msg, sizeof(nas.msg));
+    if (msg->NAS_PDU.n_octets > sizeof(nas.msg)) {
+      log->error("NAS PDU too large (%d bytes)\n", msg->NAS_PDU.n_octets);
+      return false;
+    }
+    memcpy(nas.msg, msg->NAS_PDU.buffer, msg->NAS_PDU.n_octets);
+    nas.N_bytes = msg->NAS_PDU.n_octets;
+
+    uint8_t pd, msg_type;
+    liblte_mme_parse_msg_header((LIBLTE_BYTE_MSG_STRUCT*) &nas, &pd, &msg_type);
+
+    switch (msg_type) {
+      case LIBLTE_MME_MSG_TYPE_AUTHENTICATION_REQUEST:
+        handle_authentication_request(ue, &nas);
+        break;
+      case LIBLTE_MME_MSG_TYPE_SECURITY_MODE_COMMAND:
+        handle_security_mode_command(ue, &nas);
+        break;
+      case LIBLTE_MME_MSG_TYPE_EMM_INFORMATION:
+        // Last message of the attach procedure, move the UE to idle
+        if (ue->state == UE_ATTACHING) {
+          end_proc(ue, true);
+          start_release(ue);
+        }
+        break;
+      case LIBLTE_MME_MSG_TYPE_ATTACH_REJECT:
+      case LIBLTE_MME_MSG_TYPE_AUTHENTICATION_REJECT:
+      case LIBLTE_MME_MSG_TYPE_SERVICE_REJECT:
+        log->warning("IMSI %015lu: received %s reject (0x%x)\n", ue->imsi, proc_text[ue->proc], msg_type);
+        end_proc(ue, false);
+        enb_ue_s1ap_id_to_ue.erase(ue->enb_ue_s1ap_id);
+        set_state(ue, UE_DEREGISTERED);
+        break;
+      default:
+        log->warning("IMSI %015lu: unhandled downlink NAS message 0x%x\n", ue->imsi, msg_type);
+    }
+    return true;
+  }
+
+  void handle_authentication_request(sim_ue_t *ue, byte_buffer_t *pdu)
+  {
+    LIBLTE_MME_AUTHENTICATION_REQUEST_MSG_STRUCT  auth_req;
+    LIBLTE_MME_AUTHENTICATION_RESPONSE_MSG_STRUCT auth_res;
+    bzero(&auth_req, sizeof(auth_req));
+    bzero(&auth_res, sizeof(auth_res));
+
+    liblte_mme_unpack_authentication_request_msg((LIBLTE_BYTE_MSG_STRUCT*) pdu, &auth_req);
+    ue->ksi = auth_req.nas_ksi.nas_ksi;
+
+    uint8_t res[16];
+    if (!generate_auth_response(ue, auth_req.rand, auth_req.autn, res)) {
+      end_proc(ue, false);
+      enb_ue_s1ap_id_to_ue.erase(ue->enb_ue_s1ap_id);
+      set_state(ue, UE_DEREGISTERED);
+      return;
+    }
+    memcpy(auth_res.res, res, 8);
+    auth_res.res_len = 8;
+
+    byte_buffer_t nas;
+    liblte_mme_pack_authentication_response_msg(&auth_res, LIBLTE_MME_SECURITY_HDR_TYPE_PLAIN_NAS,
+                                                0, (LIBLTE_BYTE_MSG_STRUCT*) &nas);
+    send_ulnastransport(ue, &nas);
+  }
+
+  void handle_security_mode_command(sim_ue_t *ue, byte_buffer_t *pdu)
+  {
+    LIBLTE_MME_SECURITY_MODE_COMMAND_MSG_STRUCT  sec_mode_cmd;
+    LIBLTE_MME_SECURITY_MODE_COMPLETE_MSG_STRUCT sec_mode_comp;
+    bzero(&sec_mode_cmd, sizeof(sec_mode_cmd));
+    bzero(&sec_mode_comp, sizeof(sec_mode_comp));
+
+    liblte_mme_unpack_security_mode_command_msg((LIBLTE_BYTE_MSG_STRUCT*) pdu, &sec_mode_cmd);
+    ue->cipher_algo = (CIPHERING_ALGORITHM_ID_ENUM) sec_mode_cmd.selected_nas_sec_algs.type_of_eea;
+    ue->integ_algo  = (INTEGRITY_ALGORITHM_ID_ENUM) sec_mode_cmd.selected_nas_sec_algs.type_of_eia;
+    security_generate_k_nas(ue->k_asme, ue->cipher_algo, ue->integ_algo, ue->k_nas_enc, ue->k_nas_int);
+
+    // Counters restart with the new security context (24.301 5.4.3.2)
+    ue->tx_count = 0;
+
+    byte_buffer_t nas;
+    liblte_mme_pack_security_mode_complete_msg(&sec_mode_comp,
+                                               LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY_AND_CIPHERED_WITH_NEW_EPS_SECURITY_CONTEXT,
+                                               ue->tx_count, (LIBLTE_BYTE_MSG_STRUCT*) &nas);
+    protect_nas(ue, &nas, true);
+    ue->tx_count++;
+    send_ulnastransport(ue, &nas);
+  }
+
+  bool handle_initialctxtsetuprequest(LIBLTE_S1AP_MESSAGE_INITIALCONTEXTSETUPREQUEST_STRUCT *msg)
+  {
+    sim_ue_t *ue = find_ue(msg->eNB_UE_S1AP_ID.ENB_UE_S1AP_ID);
+    if (ue == NULL) {
+      log->warning("InitialContextSetupRequest for unknown eNB-UE S1AP ID %d\n", msg->eNB_UE_S1AP_ID.ENB_UE_S1AP_ID);
+      return false;
+    }
+    ue->mme_ue_s1ap_id = msg->MME_UE_S1AP_ID.MME_UE_S1AP_ID;
+
+    send_initial_ctxt_setup_response(ue, &msg->E_RABToBeSetupListCtxtSUReq);
+
+    if (ue->state == UE_ATTACHING) {
+      LIBLTE_S1AP_E_RABTOBESETUPITEMCTXTSUREQ_STRUCT *erab = &msg->E_RABToBeSetupListCtxtSUReq.buffer[0];
+      if (msg->E_RABToBeSetupListCtxtSUReq.len == 0 || !erab->nAS_PDU_present) {
+        log->warning("IMSI %015lu: InitialContextSetupRequest without Attach Accept\n", ue->imsi);
+        return false;
+      }
+      return handle_attach_accept(ue, &erab->nAS_PDU);
+    } else if (ue->state == UE_SERVICE_REQUEST) {
+      end_proc(ue, true);
+      start_release(ue);
+    }
+    return true;
+  }
+
+  bool handle_attach_accept(sim_ue_t *ue, LIBLTE_S1AP_NAS_PDU_STRUCT *nas_pdu)
+  {
+    LIBLTE_MME_ATTACH_ACCEPT_MSG_STRUCT                              attach_accept;
+    LIBLTE_MME_ACTIVATE_DEFAULT_EPS_BEARER_CONTEXT_REQUEST_MSG_STRUCT act_def_eps_bearer_context_req;
+    LIBLTE_MME_ACTIVATE_DEFAULT_EPS_BEARER_CONTEXT_ACCEPT_MSG_STRUCT  act_def_eps_bearer_context_accept;
+    LIBLTE_MME_ATTACH_COMPLETE_MSG_STRUCT                            attach_complete;
+    bzero(&attach_accept, sizeof(attach_accept));
+    bzero(&act_def_eps_bearer_context_req, sizeof(act_def_eps_bearer_context_req));
+    bzero(&act_def_eps_bearer_context_accept, sizeof(act_def_eps_bearer_context_accept));
+    bzero(&attach_complete, sizeof(attach_complete));
+
+    byte_buffer_t nas;
+    bzero(nas.msg, sizeof(nas.msg));
+    memcpy(nas.msg, nas_pdu->buffer, nas_pdu->n_octets);
+    nas.N_bytes = nas_pdu->n_octets;
+    liblte_mme_unpack_attach_accept_msg((LIBLTE_BYTE_MSG_STRUCT*) &nas, &attach_accept);
+
+    if (!attach_accept.guti_present) {
+      log->warning("IMSI %015lu: Attach Accept without GUTI\n", ue->imsi);
+      end_proc(ue, false);
+      return false;
+    }
+    memcpy(&ue->guti, &attach_accept.guti.guti, sizeof(LIBLTE_MME_EPS_MOBILE_ID_GUTI_STRUCT));
+    ue->have_guti = true;
+
+    liblte_mme_unpack_activate_default_eps_bearer_context_request_msg(&attach_accept.esm_msg,
+                                                                      &act_def_eps_bearer_context_req);
+    ue->eps_bearer_id       = act_def_eps_bearer_context_req.eps_bearer_id;
+    ue->proc_transaction_id = act_def_eps_bearer_context_req.proc_transaction_id;
+
+    act_def_eps_bearer_context_accept.eps_bearer_id       = ue->eps_bearer_id;
+    act_def_eps_bearer_context_accept.proc_transaction_id = ue->proc_transaction_id;
+    liblte_mme_pack_activate_default_eps_bearer_context_accept_msg(&act_def_eps_bearer_context_accept,
+                                                                   &attach_complete.esm_msg);
+
+    nas.reset();
+    liblte_mme_pack_attach_complete_msg(&attach_complete, LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY_AND_CIPHERED,
+                                        ue->tx_count, (LIBLTE_BYTE_MSG_STRUCT*) &nas);
+    protect_nas(ue, &nas, true);
+    ue->tx_count++;
+    return send_ulnastransport(ue, &nas);
+  }
+
+  bool handle_uectxtreleasecommand(LIBLTE_S1AP_MESSAGE_UECONTEXTRELEASECOMMAND_STRUCT *msg)
+  {
+    uint32_t  enb_ue_s1ap_id = 0;
+    uint32_t  mme_ue_s1ap_id = 0;
+    sim_ue_t *ue = NULL;
+
+    if (msg->UE_S1AP_IDs.choice_type == LIBLTE_S1AP_UE_S1AP_IDS_CHOICE_UE_S1AP_ID_PAIR) {
+      enb_ue_s1ap_id = msg->UE_S1AP_IDs.choice.uE_S1AP_ID_pair.eNB_UE_S1AP_ID.ENB_UE_S1AP_ID;
+      mme_ue_s1ap_id = msg->UE_S1AP_IDs.choice.uE_S1AP_ID_pair.mME_UE_S1AP_ID.MME_UE_S1AP_ID;
+      ue = find_ue(enb_ue_s1ap_id);
+    } else {
+      mme_ue_s1ap_id = msg->UE_S1AP_IDs.choice.mME_UE_S1AP_ID.MME_UE_S1AP_ID;
+      std::map<uint32_t, sim_ue_t*>::iterator it;
+      for (it = enb_ue_s1ap_id_to_ue.begin(); it != enb_ue_s1ap_id_to_ue.end(); it++) {
+        if (it->second->mme_ue_s1ap_id == mme_ue_s1ap_id) {
+          ue = it->second;
+          enb_ue_s1ap_id = it->first;
+          break;
+        }
+      }
+    }
+
+    // Always confirm, the MME may release contexts of earlier connections
+    send_uectxtreleasecomplete(mme_ue_s1ap_id, enb_ue_s1ap_id);
+    if (ue == NULL) {
+      return true;
+    }
+    enb_ue_s1ap_id_to_ue.erase(enb_ue_s1ap_id);
+
+    switch (ue->state) {
+      case UE_RELEASING:
+        end_proc(ue, true);
+        set_state(ue, UE_IDLE);
+        break;
+      case UE_DETACHING:
+        end_proc(ue, true);
+        set_state(ue, UE_DEREGISTERED);
+        break;
+      default:
+        log->warning("IMSI %015lu: unexpected UEContextReleaseCommand during %s\n", ue->imsi, proc_text[ue->proc]);
+        end_proc(ue, false);
+        set_state(ue, UE_DEREGISTERED);
+        break;
+    }
+    return true;
+  }
+
+  /* S1AP message senders */
+  bool send_s1ap_pdu(LIBLTE_S1AP_S1AP_PDU_STRUCT *pdu, uint16_t stream_id)
+  {
+    byte_buffer_t msg;
+    if (liblte_s1ap_pack_s1ap_pdu(pdu, (LIBLTE_BYTE_MSG_STRUCT*) &msg) != LIBLTE_SUCCESS) {
+      log->error("Failed to pack S1AP PDU\n");
+      return false;
+    }
+    ssize_t n_sent = sctp_sendmsg(socket_fd, msg.msg, msg.N_bytes,
+                                  (struct sockaddr*) &mme_addr, sizeof(struct sockaddr_in),
+                                  htonl(S1AP_PPID), 0, stream_id, 0, 0);
+    if (n_sent == -1) {
+      log->error("Failed to send S1AP PDU\n");
+      return false;
+    }
+    return true;
+  }
+
+  bool send_initialuemessage(sim_ue_t *ue, byte_buffer_t *nas, bool has_tmsi)
+  {
+    tx_pdu->ext         = false;
+    tx_pdu->choice_type = LIBLTE_S1AP_S1AP_PDU_CHOICE_INITIATINGMESSAGE;
+
+    LIBLTE_S1AP_INITIATINGMESSAGE_STRUCT *init = &tx_pdu->choice.initiatingMessage;
+    init->procedureCode = LIBLTE_S1AP_PROC_ID_INITIALUEMESSAGE;
+    init->choice_type   = LIBLTE_S1AP_INITIATINGMESSAGE_CHOICE_INITIALUEMESSAGE;
+
+    LIBLTE_S1AP_MESSAGE_INITIALUEMESSAGE_STRUCT *initue = &init->choice.InitialUEMessage;
+    initue->ext                                       = false;
+    initue->CellAccessMode_present                    = false;
+    initue->CSG_Id_present                            = false;
+    initue->GUMMEIType_present                        = false;
+    initue->GUMMEI_ID_present                         = false;
+    initue->GW_TransportLayerAddress_present          = false;
+    initue->LHN_ID_present                            = false;
+    initue->RelayNode_Indicator_present               = false;
+    initue->SIPTO_L_GW_TransportLayerAddress_present  = false;
+    initue->S_TMSI_present                            = false;
+    initue->Tunnel_Information_for_BBF_present        = false;
+
+    if (has_tmsi) {
+      initue->S_TMSI_present               = true;
+      initue->S_TMSI.ext                   = false;
+      initue->S_TMSI.iE_Extensions_present = false;
+      uint32_to_uint8(ue->guti.m_tmsi, initue->S_TMSI.m_TMSI.buffer);
+      initue->S_TMSI.mMEC.buffer[0] = ue->guti.mme_code;
+    }
+
+    initue->eNB_UE_S1AP_ID.ENB_UE_S1AP_ID = ue->enb_ue_s1ap_id;
+
+    memcpy(initue->NAS_PDU.buffer, nas->msg, nas->N_bytes);
+    initue->NAS_PDU.n_octets = nas->N_bytes;
+
+    memcpy(&initue->TAI, &tai, sizeof(LIBLTE_S1AP_TAI_STRUCT));
+    memcpy(&initue->EUTRAN_CGI, &eutran_cgi, sizeof(LIBLTE_S1AP_EUTRAN_CGI_STRUCT));
+
+    initue->RRC_Establishment_Cause.ext = false;
+    initue->RRC_Establishment_Cause.e   = LIBLTE_S1AP_RRC_ESTABLISHMENT_CAUSE_MO_SIGNALLING;
+
+    return send_s1ap_pdu(tx_pdu, UE_STREAM_ID);
+  }
+
+  bool send_ulnastransport(sim_ue_t *ue, byte_buffer_t *nas)
+  {
+    tx_pdu->ext         = false;
+    tx_pdu->choice_type = LIBLTE_S1AP_S1AP_PDU_CHOICE_INITIATINGMESSAGE;
+
+    LIBLTE_S1AP_INITIATINGMESSAGE_STRUCT *init = &tx_pdu->choice.initiatingMessage;
+    init->procedureCode = LIBLTE_S1AP_PROC_ID_UPLINKNASTRANSPORT;
+    init->choice_type   = LIBLTE_S1AP_INITIATINGMESSAGE_CHOICE_UPLINKNASTRANSPORT;
+
+    LIBLTE_S1AP_MESSAGE_UPLINKNASTRANSPORT_STRUCT *ultx = &init->choice.UplinkNASTransport;
+    ultx->ext                                       = false;
+    ultx->GW_TransportLayerAddress_present          = false;
+    ultx->LHN_ID_present                            = false;
+    ultx->SIPTO_L_GW_TransportLayerAddress_present  = false;
+
+    ultx->MME_UE_S1AP_ID.MME_UE_S1AP_ID = ue->mme_ue_s1ap_id;
+    ultx->eNB_UE_S1AP_ID.ENB_UE_S1AP_ID = ue->enb_ue_s1ap_id;
+
+    memcpy(ultx->NAS_PDU.buffer, nas->msg, nas->N_bytes);
+    ultx->NAS_PDU.n_octets = nas->N_bytes;
+
+    memcpy(&ultx->EUTRAN_CGI, &eutran_cgi, sizeof(LIBLTE_S1AP_EUTRAN_CGI_STRUCT));
+    memcpy(&ultx->TAI, &tai, sizeof(LIBLTE_S1AP_TAI_STRUCT));
+
+    return send_s1ap_pdu(tx_pdu, UE_STREAM_ID);
+  }
+
+  bool send_initial_ctxt_setup_response(sim_ue_t *ue, LIBLTE_S1AP_E_RABTOBESETUPLISTCTXTSUREQ_STRUCT *erabs)
+  {
+    tx_pdu->ext         = false;
+    tx_pdu->choice_type = LIBLTE_S1AP_S1AP_PDU_CHOICE_SUCCESSFULOUTCOME;
+
+    LIBLTE_S1AP_SUCCESSFULOUTCOME_STRUCT *succ = &tx_pdu->choice.successfulOutcome;
+    succ->procedureCode = LIBLTE_S1AP_PROC_ID_INITIALCONTEXTSETUP;
+    succ->choice_type   = LIBLTE_S1AP_SUCCESSFULOUTCOME_CHOICE_INITIALCONTEXTSETUPRESPONSE;
+
+    LIBLTE_S1AP_MESSAGE_INITIALCONTEXTSETUPRESPONSE_STRUCT *res = &succ->choice.InitialContextSetupResponse;
+    res->ext                                     = false;
+    res->E_RABFailedToSetupListCtxtSURes_present = false;
+    res->CriticalityDiagnostics_present          = false;
+    res->MME_UE_S1AP_ID.MME_UE_S1AP_ID           = ue->mme_ue_s1ap_id;
+    res->eNB_UE_S1AP_ID.ENB_UE_S1AP_ID           = ue->enb_ue_s1ap_id;
+
+    res->E_RABSetupListCtxtSURes.len = 0;
+    for (uint32_t i = 0; i < erabs->len; i++) {
+      LIBLTE_S1AP_E_RABSETUPITEMCTXTSURES_STRUCT *item = &res->E_RABSetupListCtxtSURes.buffer[i];
+      item->ext                   = false;
+      item->iE_Extensions_present = false;
+      item->e_RAB_ID.ext          = false;
+      item->e_RAB_ID.E_RAB_ID     = erabs->buffer[i].e_RAB_ID.E_RAB_ID;
+      liblte_unpack(gtp_addr, 4, item->transportLayerAddress.buffer);
+      item->transportLayerAddress.n_bits = 32;
+      item->transportLayerAddress.ext    = false;
+      // Downlink TEIDs are never used, derive a unique one from the S1AP IDs
+      uint32_to_uint8((enb_id << 24) | ue->enb_ue_s1ap_id, item->gTP_TEID.buffer);
+      res->E_RABSetupListCtxtSURes.len++;
+    }
+
+    return send_s1ap_pdu(tx_pdu, UE_STREAM_ID);
+  }
+
+  bool send_uectxtreleaserequest(sim_ue_t *ue)
+  {
+    tx_pdu->ext         = false;
+    tx_pdu->choice_type = LIBLTE_S1AP_S1AP_PDU_CHOICE_INITIATINGMESSAGE;
+
+    LIBLTE_S1AP_INITIATINGMESSAGE_STRUCT *init = &tx_pdu->choice.initiatingMessage;
+    init->procedureCode = LIBLTE_S1AP_PROC_ID_UECONTEXTRELEASEREQUEST;
+    init->choice_type   = LIBLTE_S1AP_INITIATINGMESSAGE_CHOICE_UECONTEXTRELEASEREQUEST;
+
+    LIBLTE_S1AP_MESSAGE_UECONTEXTRELEASEREQUEST_STRUCT *req = &init->choice.UEContextReleaseRequest;
+    req->ext                                = false;
+    req->GWContextReleaseIndication_present = false;
+    req->MME_UE_S1AP_ID.MME_UE_S1AP_ID      = ue->mme_ue_s1ap_id;
+    req->eNB_UE_S1AP_ID.ENB_UE_S1AP_ID      = ue->enb_ue_s1ap_id;
+
+    req->Cause.ext                          = false;
+    req->Cause.choice_type                  = LIBLTE_S1AP_CAUSE_CHOICE_RADIONETWORK;
+    req->Cause.choice.radioNetwork.ext      = false;
+    req->Cause.choice.radioNetwork.e        = LIBLTE_S1AP_CAUSERADIONETWORK_USER_INACTIVITY;
+
+    return send_s1ap_pdu(tx_pdu, UE_STREAM_ID);
+  }
+
+  bool send_uectxtreleasecomplete(uint32_t mme_ue_s1ap_id, uint32_t enb_ue_s1ap_id)
+  {
+    tx_pdu->ext         = false;
+    tx_pdu->choice_type = LIBLTE_S1AP_S1AP_PDU_CHOICE_SUCCESSFULOUTCOME;
+
+    LIBLTE_S1AP_SUCCESSFULOUTCOME_STRUCT *succ = &tx_pdu->choice.successfulOutcome;
+    succ->procedureCode = LIBLTE_S1AP_PROC_ID_UECONTEXTRELEASE;
+    succ->choice_type   = LIBLTE_S1AP_SUCCESSFULOUTCOME_CHOICE_UECONTEXTRELEASECOMPLETE;
+
+    LIBLTE_S1AP_MESSAGE_UECONTEXTRELEASECOMPLETE_STRUCT *comp = &succ->choice.UEContextReleaseComplete;
+    comp->ext                             = false;
+    comp->CriticalityDiagnostics_present  = false;
+    comp->UserLocationInformation_present = false;
+    comp->eNB_UE_S1AP_ID.ENB_UE_S1AP_ID   = enb_ue_s1ap_id;
+    comp->MME_UE_S1AP_ID.MME_UE_S1AP_ID   = mme_ue_s1ap_id;
+
+    return send_s1ap_pdu(tx_pdu, UE_STREAM_ID);
+  }
+
+  /* Association setup */
+  void build_tai_cgi()
+  {
+    uint32_t plmn;
+    uint32_t tmp32;
+    uint16_t tmp16;
+
+    tai.ext                   = false;
+    tai.iE_Extensions_present = false;
+    s1ap_mccmnc_to_plmn(mcc, mnc, &plmn);
+    tmp32 = htonl(plmn);
+    tai.pLMNidentity.buffer[0] = ((uint8_t*)&tmp32)[1];
+    tai.pLMNidentity.buffer[1] = ((uint8_t*)&tmp32)[2];
+    tai.pLMNidentity.buffer[2] = ((uint8_t*)&tmp32)[3];
+    tmp16 = htons(args->tac);
+    memcpy(tai.tAC.buffer, (uint8_t*)&tmp16, 2);
+
+    eutran_cgi.ext                   = false;
+    eutran_cgi.iE_Extensions_present = false;
+    memcpy(eutran_cgi.pLMNidentity.buffer, tai.pLMNidentity.buffer, 3);
+    tmp32 = htonl(enb_id);
+    uint8_t enb_id_bits[4*8];
+    liblte_unpack((uint8_t*)&tmp32, 4, enb_id_bits);
+    uint8_t cell_id      = 1;
+    uint8_t cell_id_bits[1*8];
+    liblte_unpack(&cell_id, 1, cell_id_bits);
+    memcpy(eutran_cgi.cell_ID.buffer, &enb_id_bits[32-LIBLTE_S1AP_MACROENB_ID_BIT_STRING_LEN], LIBLTE_S1AP_MACROENB_ID_BIT_STRING_LEN);
+    memcpy(&eutran_cgi.cell_ID.buffer[LIBLTE_S1AP_MACROENB_ID_BIT_STRING_LEN], cell_id_bits, 8);
+  }
+
+  bool connect_mme()
+  {
+    if ((socket_fd = socket(AF_INET, SOCK_STREAM, IPPROTO_SCTP)) == -1) {
+      log->error("Failed to create S1AP socket\n");
+      return false;
+    }
+
+    struct sockaddr_in local_addr;
+    memset(&local_addr, 0, sizeof(struct sockaddr_in));
+    local_addr.sin_family = AF_INET;
+    local_addr.sin_port   = 0;
+    if (inet_pton(AF_INET, args->s1c_bind_addr.c_str(), &(local_addr.sin_addr)) != 1) {
+      log->error("Error converting IP address (%s) to sockaddr_in structure\n", args->s1c_bind_addr.c_str());
+      return false;
+    }
+    bind(socket_fd, (struct sockaddr*) &local_addr, sizeof(local_addr));
+
+    memset(&mme_addr, 0, sizeof(struct sockaddr_in));
+    mme_addr.sin_family = AF_INET;
+    mme_addr.sin_port   = htons(S1AP_PORT);
+    if (inet_pton(AF_INET, args->mme_addr.c_str(), &(mme_addr.sin_addr)) != 1) {
+      log->error("Error converting IP address (%s) to sockaddr_in structure\n", args->mme_addr.c_str());
+      return false;
+    }
+
+    if (connect(socket_fd, (struct sockaddr*) &mme_addr, sizeof(mme_addr)) == -1) {
+      log->error("Failed to establish socket connection to MME\n");
+      return false;
+    }
+    return true;
+  }
+
+  bool setup_s1()
+  {
+    uint32_t plmn;
+    uint32_t tmp32;
+    uint16_t tmp16;
+
+    tx_pdu->ext         = false;
+    tx_pdu->choice_type = LIBLTE_S1AP_S1AP_PDU_CHOICE_INITIATINGMESSAGE;
+
+    LIBLTE_S1AP_INITIATINGMESSAGE_STRUCT *init = &tx_pdu->choice.initiatingMessage;
+    init->procedureCode = LIBLTE_S1AP_PROC_ID_S1SETUP;
+    init->choice_type   = LIBLTE_S1AP_INITIATINGMESSAGE_CHOICE_S1SETUPREQUEST;
+
+    LIBLTE_S1AP_MESSAGE_S1SETUPREQUEST_STRUCT *s1setup = &init->choice.S1SetupRequest;
+    s1setup->ext                = false;
+    s1setup->CSG_IdList_present = false;
+
+    s1setup->Global_ENB_ID.ext                   = false;
+    s1setup->Global_ENB_ID.iE_Extensions_present = false;
+    s1ap_mccmnc_to_plmn(mcc, mnc, &plmn);
+    tmp32 = htonl(plmn);
+    s1setup->Global_ENB_ID.pLMNidentity.buffer[0] = ((uint8_t*)&tmp32)[1];
+    s1setup->Global_ENB_ID.pLMNidentity.buffer[1] = ((uint8_t*)&tmp32)[2];
+    s1setup->Global_ENB_ID.pLMNidentity.buffer[2] = ((uint8_t*)&tmp32)[3];
+
+    s1setup->Global_ENB_ID.eNB_ID.ext         = false;
+    s1setup->Global_ENB_ID.eNB_ID.choice_type = LIBLTE_S1AP_ENB_ID_CHOICE_MACROENB_ID;
+    tmp32 = htonl(enb_id);
+    uint8_t enb_id_bits[4*8];
+    liblte_unpack((uint8_t*)&tmp32, 4, enb_id_bits);
+    memcpy(s1setup->Global_ENB_ID.eNB_ID.choice.macroENB_ID.buffer,
+           &enb_id_bits[32-LIBLTE_S1AP_MACROENB_ID_BIT_STRING_LEN], LIBLTE_S1AP_MACROENB_ID_BIT_STRING_LEN);
+
+    std::stringstream name;
+    name << "stress_enb" << enb_id;
+    s1setup->eNBname_present = true;
+    s1setup->eNBname.ext     = false;
+    memcpy(s1setup->eNBname.buffer, name.str().c_str(), name.str().length());
+    s1setup->eNBname.n_octets = name.str().length();
+
+    s1setup->SupportedTAs.len                             = 1;
+    s1setup->SupportedTAs.buffer[0].ext                   = false;
+    s1setup->SupportedTAs.buffer[0].iE_Extensions_present = false;
+    tmp16 = htons(args->tac);
+    memcpy(s1setup->SupportedTAs.buffer[0].tAC.buffer, (uint8_t*)&tmp16, 2);
+    s1setup->SupportedTAs.buffer[0].broadcastPLMNs.len = 1;
+    tmp32 = htonl(plmn);
+    s1setup->SupportedTAs.buffer[0].broadcastPLMNs.buffer[0].buffer[0] = ((uint8_t*)&tmp32)[1];
+    s1setup->SupportedTAs.buffer[0].broadcastPLMNs.buffer[0].buffer[1] = ((uint8_t*)&tmp32)[2];
+    s1setup->SupportedTAs.buffer[0].broadcastPLMNs.buffer[0].buffer[2] = ((uint8_t*)&tmp32)[3];
+
+    s1setup->DefaultPagingDRX.ext = false;
+    s1setup->DefaultPagingDRX.e   = LIBLTE_S1AP_PAGINGDRX_V128;
+
+    if (!send_s1ap_pdu(tx_pdu, NONUE_STREAM_ID)) {
+      return false;
+    }
+
+    // Wait for the S1 Setup Response
+    struct pollfd pfd;
+    pfd.fd     = socket_fd;
+    pfd.events = POLLIN;
+    if (poll(&pfd, 1, args->timeout_ms) <= 0) {
+      log->error("eNB %d: no S1 Setup Response from MME\n", enb_id);
+      return false;
+    }
+    rx_buf.reset();
+    ssize_t n_recv = recv(socket_fd, rx_buf.msg, SRSLTE_MAX_BUFFER_SIZE_BYTES - SRSLTE_BUFFER_HEADER_OFFSET, 0);
+    if (n_recv <= 0) {
+      log->error("eNB %d: MME closed the association during S1 Setup\n", enb_id);
+      return false;
+    }
+    rx_buf.N_bytes = n_recv;
+    if (liblte_s1ap_unpack_s1ap_pdu((LIBLTE_BYTE_MSG_STRUCT*) &rx_buf, rx_pdu) != LIBLTE_SUCCESS ||
+        rx_pdu->choice_type != LIBLTE_S1AP_S1AP_PDU_CHOICE_SUCCESSFULOUTCOME ||
+        rx_pdu->choice.successfulOutcome.choice_type != LIBLTE_S1AP_SUCCESSFULOUTCOME_CHOICE_S1SETUPRESPONSE) {
+      log->error("eNB %d: S1 Setup failed\n", enb_id);
+      return false;
+    }
+    return true;
+  }
+};
+
+/*******************************************************************************
+  Main
+*******************************************************************************/
+
+void parse_args(stress_test_args_t *args, int argc, char *argv[])
+{
+  std::string imsi_base;
+
+  bpo::options_description general("General options");
+  general.add_options()
+    ("help,h", "Produce help message");
+
+  bpo::options_description common("Configuration options");
+  common.add_options()
+    ("mme_addr",      bpo::value<std::string>(&args->mme_addr)->default_value("127.0.1.100"), "MME S1-MME address")
+    ("s1c_bind_addr", bpo::value<std::string>(&args->s1c_bind_addr)->default_value("127.0.1.1"), "Local address for the eNB SCTP associations")
+    ("gtp_bind_addr", bpo::value<std::string>(&args->gtp_bind_addr)->default_value("127.0.1.1"), "S1-U address reported in Initial Context Setup Responses")
+    ("mcc",           bpo::value<std::string>(&args->mcc)->default_value("001"), "Mobile Country Code, must match the MME")
+    ("mnc",           bpo::value<std::string>(&args->mnc)->default_value("01"), "Mobile Network Code, must match the MME")
+    ("tac",           bpo::value<uint32_t>(&args->tac)->default_value(7), "Tracking Area Code")
+    ("enb_id",        bpo::value<uint32_t>(&args->enb_id)->default_value(0x19B), "eNB ID of the first simulated eNB")
+    ("nof_enbs",      bpo::value<uint32_t>(&args->nof_enbs)->default_value(1), "Number of simulated eNBs (SCTP associations)")
+    ("nof_ues",       bpo::value<uint32_t>(&args->nof_ues)->default_value(1000), "Number of simulated UEs")
+    ("imsi_base",     bpo::value<std::string>(&imsi_base)->default_value("001010000000001"), "IMSI of the first UE, following UEs use consecutive IMSIs")
+    ("k",             bpo::value<std::string>(&args->k)->default_value("00112233445566778899aabbccddeeff"), "Subscriber key K shared by all UEs")
+    ("opc",           bpo::value<std::string>(&args->opc)->default_value("63bfa50ee6523365ff14c1f45f88737d"), "Operator code OPc shared by all UEs")
+    ("auth_algo",     bpo::value<std::string>(&args->auth_algo)->default_value("xor"), "Authentication algorithm (xor/milenage), must match the HSS")
+    ("attach_rate",   bpo::value<float>(&args->attach_rate)->default_value(100), "Attach procedures per second")
+    ("detach_rate",   bpo::value<float>(&args->detach_rate)->default_value(0), "Detach procedures per second")
+    ("service_rate",  bpo::value<float>(&args->service_rate)->default_value(0), "Service Request procedures per second")
+    ("tau_rate",      bpo::value<float>(&args->tau_rate)->default_value(0), "Tracking Area Update procedures per second")
+    ("duration",      bpo::value<uint32_t>(&args->duration_sec)->default_value(10), "Test duration (sec)")
+    ("timeout",       bpo::value<uint32_t>(&args->timeout_ms)->default_value(5000), "Procedure timeout (msec)")
+    ("loglevel",      bpo::value<uint32_t>(&args->log_level)->default_value(srslte::LOG_LEVEL_WARNING), "Log level (1=Error,2=Warning,3=Info,4=Debug)")
+    ("db_out",        bpo::value<std::string>(&args->db_out)->default_value(""), "Write a HSS user_db.csv for the simulated UEs and exit");
+
+  bpo::options_description cmdline_options;
+  cmdline_options.add(common).add(general);
+
+  bpo::variables_map vm;
+  bpo::store(bpo::command_line_parser(argc, argv).options(cmdline_options).run(), vm);
+  bpo::notify(vm);
+
+  if (vm.count("help") > 0) {
+    std::cout << "Usage: " << argv[0] << " [OPTIONS]" << std::endl << std::endl;
+    std::cout << common << std::endl << general << std::endl;
+    exit(0);
+  }
+
+  args->imsi_base = strtoull(imsi_base.c_str(), NULL, 10);
+  if (args->nof_enbs == 0) {
+    args->nof_enbs = 1;
+  }
+  if (args->log_level > 4) {
+    args->log_level = 4;
+  }
+  if (args->k.length() != 32 || args->opc.length() != 32) {
+    std::cout << "Error: K and OPc must be 32 hex digits" << std::endl;
+    exit(-1);
+  }
+  if (args->auth_algo != "xor" && args->auth_algo != "milenage") {
+    std::cout << "Error: auth_algo must be xor or milenage" << std::endl;
+    exit(-1);
+  }
+}
+
+bool write_db_file(stress_test_args_t *args)
+{
+  std::ofstream db_file(args->db_out.c_str(), std::ofstream::out);
+  if (!db_file.is_open()) {
+    std::cout << "Error opening " << args->db_out << std::endl;
+    return false;
+  }
+  db_file << "# Generated by mme_stress_test: \"Name,IMSI,Key,OP_Type,OP,AMF,SQN,QCI\"" << std::endl;
+  for (uint32_t i = 0; i < args->nof_ues; i++) {
+    db_file << "stress" << i << ","
+            << std::setfill('0') << std::setw(15) << args->imsi_base + i << ","
+            << args->k << ",opc," << args->opc << ",8000,000000001234,7" << std::endl;
+  }
+  std::cout << "Wrote " << args->nof_ues << " subscribers to " << args->db_out << std::endl;
+  return true;
+}
+
+void print_report(proc_stats *stats, float elapsed_sec)
+{
+  printf("\n%-16s %8s %8s %8s %8s %8s %9s %9s %9s %9s %9s %9s\n",
+         "Procedure", "Started", "Done", "Failed", "Timeout", "Skipped",
+         "Rate/s", "p50 ms", "p90 ms", "p99 ms", "p99.9 ms", "max ms");
+  for (uint32_t p = 0; p < PROC_N_ITEMS; p++) {
+    proc_stats *s = &stats[p];
+    std::sort(s->latency_us.begin(), s->latency_us.end());
+    printf("%-16s %8d %8d %8d %8d %8d %9.1f",
+           proc_text[p], s->started, s->completed, s->failed, s->timed_out, s->skipped,
+           (float) s->completed/elapsed_sec);
+    if (p == PROC_TAU) {
+      // No response from the MME, latency is not measurable
+      printf(" %9s %9s %9s %9s %9s\n", "-", "-", "-", "-", "-");
+    } else {
+      printf(" %9.2f %9.2f %9.2f %9.2f %9.2f\n",
+             s->percentile_ms(50), s->percentile_ms(90), s->percentile_ms(99),
+             s->percentile_ms(99.9), s->percentile_ms(100));
+    }
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  stress_test_args_t args;
+  parse_args(&args, argc, argv);
+
+  if (!args.db_out.empty()) {
+    return write_db_file(&args) ? 0 : -1;
+  }
+
+  signal(SIGINT, sig_int_handler);
+  signal(SIGPIPE, SIG_IGN);
+
+  srslte::logger_stdout logger;
+  srslte::log_filter    log;
+  log.init("STRS", &logger);
+  log.set_level((srslte::LOG_LEVEL_ENUM) args.log_level);
+  log.set_hex_limit(32);
+
+  // Create the UE population
+  uint8_t k[16], opc[16];
+  hex_str_to_vec(args.k, k, 16);
+  hex_str_to_vec(args.opc, opc, 16);
+
+  std::vector<sim_ue_t> ues(args.nof_ues);
+  std::vector<std::vector<sim_ue_t*> > ues_per_enb(args.nof_enbs);
+  for (uint32_t i = 0; i < args.nof_ues; i++) {
+    sim_ue_t *ue = &ues[i];
+    bzero(ue, sizeof(sim_ue_t));
+    ue->imsi  = args.imsi_base + i;
+    ue->state = UE_DEREGISTERED;
+    uint64_t imsi = ue->imsi;
+    for (int j = 14; j >= 0; j--) {
+      ue->imsi_vec[j] = imsi % 10;
+      imsi /= 10;
+    }
+    memcpy(ue->k, k, 16);
+    memcpy(ue->opc, opc, 16);
+    ues_per_enb[i % args.nof_enbs].push_back(ue);
+  }
+
+  // Bring up all associations before starting the load
+  std::vector<sim_enb*> enbs;
+  for (uint32_t i = 0; i < args.nof_enbs && running; i++) {
+    sim_enb *enb = new sim_enb;
+    if (!enb->init(&args, i, ues_per_enb[i], &log)) {
+      log.console("Failed to set up simulated eNB %d\n", i);
+      delete enb;
+      running = false;
+      break;
+    }
+    enbs.push_back(enb);
+  }
+
+  uint64_t start_us = now_usec();
+  if (running) {
+    printf("%d eNBs connected, running for %d seconds with %d UEs...\n",
+           (int) enbs.size(), args.duration_sec, args.nof_ues);
+    for (uint32_t i = 0; i < enbs.size(); i++) {
+      enbs[i]->start_traffic();
+    }
+    for (uint32_t t = 0; t < args.duration_sec*10 && running; t++) {
+      usleep(100000);
+    }
+  }
+
+  proc_stats stats[PROC_N_ITEMS];
+  for (uint32_t i = 0; i < enbs.size(); i++) {
+    enbs[i]->stop();
+  }
+  float elapsed_sec = (float) (now_usec() - start_us)/1e6;
+  for (uint32_t i = 0; i < enbs.size(); i++) {
+    for (uint32_t p = 0; p < PROC_N_ITEMS; p++) {
+      stats[p].merge(enbs[i]->stats[p]);
+    }
+    delete enbs[i];
+  }
+
+  if (!enbs.empty()) {
+    print_report(stats, elapsed_sec);
+  }
+  return 0;
+}
@@ -32,6 +32,7 @@
 #include "srslte/common/log.h"
 #include "srslte/common/timers.h"
 #include "srslte/common/pdu.h"
+#include "srslte/common/sch_pdu_codec.h"
 
 /* Logical Channel Demultiplexing and MAC CE dissassemble */   
 
@@ -68,15 +69,15 @@ private:
   bool (*uecrid_callback) (void*, uint64_t);
   void *uecrid_callback_arg; 
   
-  srslte::sch_pdu mac_msg;
-  srslte::mch_pdu mch_mac_msg;
-  srslte::sch_pdu pending_mac_msg;
+  srslte::sch_pdu_decoder mac_msg;
+  srslte::mch_pdu         mch_mac_msg;
+  srslte::sch_pdu_decoder pending_mac_msg;
   uint8_t      mch_lcids[SRSLTE_N_MCH_LCIDS];
-  void process_sch_pdu(srslte::sch_pdu *pdu);
+  void process_sch_pdu(srslte::sch_pdu_decoder *pdu);
   void process_mch_pdu(srslte::mch_pdu *pdu);
   
    
-  bool process_ce(srslte::sch_subh *subheader);
+  bool process_ce(srslte::sch_pdu_elem *subheader);
   
   bool       is_uecrid_successful; 
     
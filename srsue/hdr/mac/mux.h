@@ -34,6 +34,7 @@
 #include "srslte/common/log.h"
 #include "srslte/interfaces/ue_interfaces.h"
 #include "srslte/common/pdu.h"
+#include "srslte/common/sch_pdu_codec.h"
 #include "proc_bsr.h"
 #include "proc_phr.h"
 
@@ -80,7 +81,7 @@ public:
 private:  
   int      find_lchid(uint32_t lch_id);
   bool     pdu_move_to_msg3(uint32_t pdu_sz);
-  bool     allocate_sdu(uint32_t lcid, srslte::sch_pdu *pdu, int max_sdu_sz);
+  bool     allocate_sdu(uint32_t lcid, srslte::sch_pdu_encoder *pdu, int max_sdu_sz);
   bool     sched_sdu(lchid_t *ch, int *sdu_space, int max_sdu_sz);
   
   const static int MIN_RLC_SDU_LEN = 0; 
@@ -107,7 +108,7 @@ private:
   uint8_t              *msg3_buff_start_pdu;
 
   /* PDU Buffer */
-  srslte::sch_pdu    pdu_msg; 
+  srslte::sch_pdu_encoder pdu_msg;
   bool msg3_has_been_transmitted;
   bool msg3_pending;
 };
@@ -39,6 +39,7 @@
 #include "srslte/radio/radio.h"
 #include "srslte/common/log.h"
 #include "srslte/common/gen_mch_tables.h"
+#include "srslte/common/tx_reorder.h"
 #include "phy_metrics.h"
 
 
@@ -73,7 +74,7 @@ typedef struct {
 
 
 /* Subclass that manages variables common to all workers */
-  class phch_common {
+  class phch_common : public srslte::tx_reorder_handler {
   public:
     
     /* Common variables used by all phy workers */
@@ -124,7 +125,9 @@ typedef struct {
               srslte::log *_log,
               srslte::radio *_radio,
               rrc_interface_phy *rrc,
-              mac_interface_phy *_mac);
+              mac_interface_phy *_mac,
+              int tx_prio);
+    void stop();
 
     /* For RNTI searches, -1 means now or forever */
     void               set_ul_rnti(srslte_rnti_type_t type, uint16_t rnti_value, int tti_start = -1, int tti_end = -1);
@@ -144,7 +147,11 @@ typedef struct {
     bool get_pending_ack(uint32_t tti, uint32_t *I_lowest, uint32_t *n_dmrs);
     bool is_any_pending_ack();
 
-    void worker_end(uint32_t tti, bool tx_enable, cf_t *buffer, uint32_t nof_samples, srslte_timestamp_t tx_time);
+    void worker_end(uint32_t tx_seq, bool tx_enable, cf_t *buffer, uint32_t nof_samples, srslte_timestamp_t tx_time,
+                    srslte::phy_trace *trace = NULL);
+
+    // Transmits the subframes in sequence, from the tx thread
+    void tx_slot(uint32_t seq, srslte::tx_reorder_slot_t *slot);
 
     void set_nof_workers(uint32_t nof_workers);
     bool sr_enabled;
@@ -180,7 +187,7 @@ typedef struct {
 
     
     
-    std::vector<sem_t>    tx_sem;
+    srslte::tx_reorder    tx_queue;
     uint32_t              nof_workers;
     uint32_t              max_workers;
 
@@ -208,8 +215,6 @@ typedef struct {
       uint32_t n_dmrs;
     } pending_ack_t;
     pending_ack_t pending_ack[TTIMOD_SZ];
-    
-    bool            is_first_tx;
 
     srslte_cell_t   cell;
 
@@ -210,6 +210,7 @@ private:
     void write(uint32_t tti, cf_t *data, uint32_t nsamples);
   private:
     void run_thread();
+    void flush();
     const static int INTRA_FREQ_MEAS_PRIO      = DEFAULT_PRIORITY + 5;
 
     scell_recv         scell;
@@ -230,9 +231,10 @@ private:
     bool                running;
     bool                receive_enabled;
     bool                receiving;
+    bool                flush_pending;
     uint32_t            measure_tti;
     uint32_t            receive_cnt;
-    srslte_ringbuffer_t ring_buffer;
+    srslte_ringbuffer_spsc_t ring_buffer;
   };
 
   // 36.133 9.1.2.1 for band 7
@@ -438,7 +440,8 @@ private:
   uint32_t      tti;
   bool          do_agc;
 
-  uint32_t      tx_worker_cnt;
+  // Sequence number of the subframes in the transmission queue, wraps freely
+  uint32_t      tx_seq;
   uint32_t      nof_workers;
 
   float         ul_dl_factor;
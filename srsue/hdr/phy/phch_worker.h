@@ -31,6 +31,7 @@
 #include "srslte/srslte.h"
 #include "srslte/common/thread_pool.h"
 #include "srslte/common/trace.h"
+#include "srslte/common/phy_trace.h"
 #include "phch_common.h"
 
 #define LOG_EXECTIME
@@ -52,7 +53,7 @@ public:
 
   /* Functions used by main PHY thread */
   cf_t* get_buffer(uint32_t antenna_idx);
-  void  set_tti(uint32_t tti, uint32_t tx_worker_cnt);
+  void  set_tti(uint32_t tti, uint32_t tx_seq);
   void  set_tx_time(srslte_timestamp_t tx_time, uint32_t next_offset);
   void  set_prach(cf_t *prach_ptr, float prach_power);
   void  set_cfo(float cfo);
@@ -63,6 +64,8 @@ public:
   
   void start_trace();
   void write_trace(std::string filename);
+  srslte::phy_trace* get_trace();
+  void get_proc_metrics(srslte::phy_proc_metrics_t *m);
   
   int read_ce_abs(float *ce_abs, uint32_t tx_antenna, uint32_t rx_antenna);
   uint32_t get_cell_nof_ports() {
@@ -134,6 +137,9 @@ private:
   srslte::trace<uint32_t> tr_exec;
   bool trace_enabled; 
 
+  const static uint32_t TRACE_NOF_EVENTS = 65536;
+  srslte::phy_trace trace;
+
   pthread_mutex_t mutex;
   
   /* Common objects */  
@@ -146,7 +152,7 @@ private:
   bool           cell_initiated;
   cf_t          *signal_buffer[SRSLTE_MAX_PORTS]; 
   uint32_t       tti; 
-  uint32_t       tx_tti;
+  uint32_t       tx_seq;
   bool           pregen_enabled;
   uint32_t       last_dl_pdcch_ncce;
   bool           rnti_is_set;
@@ -159,6 +159,7 @@ private:
   const static int DEFAULT_WORKERS     = 2;
   
   const static int SF_RECV_THREAD_PRIO = 1;
+  const static int TX_THREAD_PRIO      = 1;
   const static int WORKERS_THREAD_PRIO = 2; 
   
   srslte::radio_multi      *radio_handler;
@@ -27,6 +27,7 @@
 #ifndef SRSUE_PHY_METRICS_H
 #define SRSUE_PHY_METRICS_H
 
+#include "srslte/common/phy_trace.h"
 
 namespace srsue {
 
@@ -62,6 +63,7 @@ struct phy_metrics_t
   sync_metrics_t sync;
   dl_metrics_t   dl;
   ul_metrics_t   ul;
+  srslte::phy_proc_metrics_t proc;
 };
 
 } // namespace srsue
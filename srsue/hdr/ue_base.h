@@ -112,6 +112,8 @@ typedef struct {
 typedef struct {
   std::string   ip_netmask;
   std::string   ip_devname;
+  uint32_t      ip_nof_queues;
+  bool          ip_offload;
   phy_args_t    phy;
   float         metrics_period_secs;
   bool          pregenerate_signals;
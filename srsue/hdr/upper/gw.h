@@ -36,6 +36,8 @@
 #include "gw_metrics.h"
 
 #include <linux/if.h>
+#include <pthread.h>
+#include <vector>
 
 namespace srsue {
 
@@ -71,6 +73,22 @@ private:
   std::string tundevname;
 
   static const int GW_THREAD_PRIO = 7;
+  static const uint32_t GW_MAX_TUN_QUEUES = 8;
+  static const uint32_t GW_MAX_GSO_SIZE   = 65535;
+
+  // Reader of one additional TUN queue. Queue 0 is read by the gw thread itself
+  class tun_reader : public thread
+  {
+  public:
+    tun_reader(gw *parent_, int32 fd_) : parent(parent_), fd(fd_), running(false) {}
+    virtual ~tun_reader() {}
+    bool is_running() { return running; }
+  private:
+    void run_thread();
+    gw   *parent;
+    int32 fd;
+    bool  running;
+  };
 
   pdcp_interface_gw  *pdcp;
   nas_interface_gw   *nas;
@@ -83,6 +101,9 @@ private:
   bool                running;
   bool                run_enable;
   int32               tun_fd;
+  std::vector<int32>  tun_queue_fds;        // Queues 1..nof_queues-1
+  std::vector<tun_reader*> tun_readers;
+  pthread_mutex_t     ul_mutex;             // PDCP entities are not thread safe
   struct ifreq        ifr;
   int32               sock;
   bool                if_up;
@@ -94,6 +115,12 @@ private:
   struct timeval      metrics_time[3];
 
   void                run_thread();
+  void                run_tun_queue(int32 fd);
+  void                run_tun_queue_offload(int32 fd);
+  bool                send_ul_pdu(srslte::byte_buffer_t *pdu);
+  bool                send_ul_gso(uint8_t *pkt, uint32_t len, uint32_t mss);
+  int                 write_tun(uint8_t *pkt, uint32_t len);
+  void                close_if();
   srslte::error_t     init_if(char *err_str);
 
   // MBSFN
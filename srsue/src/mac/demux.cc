@@ -92,8 +92,9 @@ void demux::push_pdu_temp_crnti(uint8_t *buff, uint32_t nof_bytes)
 {
   if (nof_bytes > 0) {
     // Unpack DLSCH MAC PDU 
-    pending_mac_msg.init_rx(nof_bytes);
-    pending_mac_msg.parse_packet(buff);
+    if (!pending_mac_msg.parse_packet(buff, nof_bytes, false)) {
+      Warning("Received malformed MAC PDU with Temporal C-RNTI, %d bytes\n", nof_bytes);
+    }
     
     // Look for Contention Resolution UE ID 
     is_uecrid_successful = false; 
@@ -147,9 +148,11 @@ void demux::process_pdu(uint8_t *mac_pdu, uint32_t nof_bytes, srslte::pdu_queue:
   switch(channel) {
     case srslte::pdu_queue::DCH:
       // Unpack DLSCH MAC PDU
-      mac_msg.init_rx(nof_bytes);
-      mac_msg.parse_packet(mac_pdu);
-      process_sch_pdu(&mac_msg);
+      if (mac_msg.parse_packet(mac_pdu, nof_bytes, false)) {
+        process_sch_pdu(&mac_msg);
+      } else {
+        Error("Received malformed MAC PDU, %d bytes\n", nof_bytes);
+      }
       pdus.deallocate(mac_pdu);
       break;
     case srslte::pdu_queue::BCH:
@@ -165,7 +168,7 @@ void demux::process_pdu(uint8_t *mac_pdu, uint32_t nof_bytes, srslte::pdu_queue:
   }
 }
 
-void demux::process_sch_pdu(srslte::sch_pdu *pdu_msg)
+void demux::process_sch_pdu(srslte::sch_pdu_decoder *pdu_msg)
 {  
   while(pdu_msg->next()) {
     if (pdu_msg->get()->is_sdu()) {
@@ -237,7 +240,7 @@ void demux::mch_start_rx(uint32_t lcid)
   }
 }
 
-bool demux::process_ce(srslte::sch_subh *subh) {
+bool demux::process_ce(srslte::sch_pdu_elem *subh) {
   switch(subh->ce_type()) {
     case srslte::sch_subh::CON_RES_ID:
       // Do nothing
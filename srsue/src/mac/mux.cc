@@ -169,16 +169,14 @@ uint8_t* mux::pdu_get(uint8_t *payload, uint32_t pdu_sz, uint32_t tx_tti, uint32
   // Logical Channel Procedure
   bool is_rar = false;
 
-  pdu_msg.init_tx(payload, pdu_sz, true);
+  pdu_msg.init(payload, pdu_sz);
 
   // MAC control element for C-RNTI or data from UL-CCCH
   if (!allocate_sdu(0, &pdu_msg, -1)) {
     if (pending_crnti_ce) {
       is_rar = true;
-      if (pdu_msg.new_subh()) {
-        if (!pdu_msg.get()->set_c_rnti(pending_crnti_ce)) {
-          Warning("Pending C-RNTI CE could not be inserted in MAC PDU\n");
-        }
+      if (!pdu_msg.add_c_rnti(pending_crnti_ce)) {
+        Warning("Pending C-RNTI CE could not be inserted in MAC PDU\n");
       }
     }
   } else {
@@ -192,19 +190,14 @@ uint8_t* mux::pdu_get(uint8_t *payload, uint32_t pdu_sz, uint32_t tx_tti, uint32
   
   // MAC control element for BSR, with exception of BSR included for padding;
   if (regular_bsr) {
-    if (pdu_msg.new_subh()) {
-      pdu_msg.get()->set_bsr(bsr.buff_size, bsr_format_convert(bsr.format));    
-      bsr_is_inserted  = true; 
-    }
+    bsr_is_inserted = pdu_msg.add_bsr(bsr.buff_size, bsr_format_convert(bsr.format));
   }
 
   // MAC control element for PHR
   if (phr_procedure) {
     float phr_value;
     if (phr_procedure->generate_phr_on_ul_grant(&phr_value)) {
-      if (pdu_msg.new_subh()) {
-        pdu_msg.get()->set_phr(phr_value);
-      }
+      pdu_msg.add_phr(phr_value);
     }
   }
 
@@ -252,10 +245,7 @@ uint8_t* mux::pdu_get(uint8_t *payload, uint32_t pdu_sz, uint32_t tx_tti, uint32
   if (!regular_bsr) {
     // Insert Padding BSR if not inserted Regular/Periodic BSR 
     if (bsr_procedure->generate_padding_bsr(pdu_msg.rem_size(), &bsr)) {
-      if (pdu_msg.new_subh()) {
-        pdu_msg.get()->set_bsr(bsr.buff_size, bsr_format_convert(bsr.format));
-        bsr_is_inserted  = true; 
-      }    
+      bsr_is_inserted = pdu_msg.add_bsr(bsr.buff_size, bsr_format_convert(bsr.format));
     }
   }
   
@@ -305,7 +295,7 @@ bool mux::sched_sdu(lchid_t *ch, int *sdu_space, int max_sdu_sz)
   return false; 
 }
 
-bool mux::allocate_sdu(uint32_t lcid, srslte::sch_pdu* pdu_msg, int max_sdu_sz) 
+bool mux::allocate_sdu(uint32_t lcid, srslte::sch_pdu_encoder* pdu_msg, int max_sdu_sz) 
 {
  
   // Get n-th pending SDU pointer and length
@@ -321,18 +311,15 @@ bool mux::allocate_sdu(uint32_t lcid, srslte::sch_pdu* pdu_msg, int max_sdu_sz)
       sdu_len = sdu_space;
     }
     if (sdu_len > MIN_RLC_SDU_LEN) {
-      if (pdu_msg->new_subh()) { // there is space for a new subheader
-        sdu_len = pdu_msg->get()->set_sdu(lcid, sdu_len, rlc);
-        if (sdu_len > 0) { // new SDU could be added
-          Debug("SDU:   allocated lcid=%d, rlc_buffer=%d, allocated=%d/%d, max_sdu_sz=%d, remaining=%d\n",
-                 lcid, buffer_state, sdu_len, sdu_space, max_sdu_sz, pdu_msg->rem_size());
-          return true;               
-        } else {
-          Warning("SDU:   rlc_buffer=%d, allocated=%d/%d, remaining=%d\n", 
-               buffer_state, sdu_len, sdu_space, pdu_msg->rem_size());
-          pdu_msg->del_subh();
-        }
-      } 
+      sdu_len = pdu_msg->add_sdu(lcid, sdu_len, rlc);
+      if (sdu_len > 0) { // new SDU could be added
+        Debug("SDU:   allocated lcid=%d, rlc_buffer=%d, allocated=%d/%d, max_sdu_sz=%d, remaining=%d\n",
+               lcid, buffer_state, sdu_len, sdu_space, max_sdu_sz, pdu_msg->rem_size());
+        return true;               
+      } else {
+        Warning("SDU:   rlc_buffer=%d, allocated=%d/%d, remaining=%d\n", 
+             buffer_state, sdu_len, sdu_space, pdu_msg->rem_size());
+      }
     }
   }
   return false; 
@@ -365,7 +352,7 @@ bool mux::msg3_is_pending() {
 /* Returns a pointer to the Msg3 buffer */
 uint8_t* mux::msg3_get(uint8_t *payload, uint32_t pdu_sz)
 {
-  if (pdu_sz < MSG3_BUFF_SZ - 32) {
+  if (pdu_sz < MSG3_BUFF_SZ - pdu_msg.get_sdu_offset()) {
     if (!msg3_buff_start_pdu) {
       msg3_buff_start_pdu = pdu_get(msg3_buff, pdu_sz, 0, 0);
       if (!msg3_buff_start_pdu) {
@@ -376,7 +363,7 @@ uint8_t* mux::msg3_get(uint8_t *payload, uint32_t pdu_sz)
       msg3_pending = false;
     }
   } else {
-    Error("Msg3 size (%d) is longer than internal msg3_buff size=%d, (see mux.h)\n", pdu_sz, MSG3_BUFF_SZ-32);
+    Error("Msg3 size (%d) is longer than internal msg3_buff size=%d, (see mux.h)\n", pdu_sz, MSG3_BUFF_SZ-pdu_msg.get_sdu_offset());
     return NULL;
   }
   memcpy(payload, msg3_buff_start_pdu, sizeof(uint8_t)*pdu_sz);
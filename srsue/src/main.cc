@@ -146,6 +146,14 @@ void parse_args(all_args_t *args, int argc, char *argv[]) {
      bpo::value<string>(&args->expert.ip_devname)->default_value("tun_srsue"),
      "Name of the tun_srsue device")
 
+    ("expert.ip_nof_queues",
+     bpo::value<uint32_t>(&args->expert.ip_nof_queues)->default_value(1),
+     "Number of queues of the tun_srsue device, each read by its own thread")
+
+    ("expert.ip_offload",
+     bpo::value<bool>(&args->expert.ip_offload)->default_value(false),
+     "Enable TCP segmentation and checksum offloads on the tun_srsue device")
+
      ("expert.mbms_service",
      bpo::value<int>(&args->expert.mbms_service)->default_value(-1),
      "automatically starts an mbms service of the number given")
@@ -300,6 +308,14 @@ void parse_args(all_args_t *args, int argc, char *argv[]) {
      bpo::value<uint32_t>(&args->expert.phy.estimator_fil_order)->default_value(4),
      "Sets the channel estimator smooth gaussian filter order (even values perform better).")
 
+    ("expert.estimator_plan",
+     bpo::value<bool>(&args->expert.phy.estimator_plan)->default_value(true),
+     "Precomputes the channel estimator interpolation when the cell or the filter change.")
+
+    ("expert.estimator_meas_mask",
+     bpo::value<uint32_t>(&args->expert.phy.estimator_meas_mask)->default_value(1023),
+     "Bitmask for subframes on which the channel estimator measures RSRP, RSSI and noise.")
+
     ("expert.sss_algorithm",
      bpo::value<string>(&args->expert.phy.sss_algorithm)->default_value("full"),
      "Selects the SSS estimation algorithm.")
@@ -107,6 +107,10 @@ void metrics_stdout::set_metrics(ue_metrics_t &metrics, const uint32_t period_us
   if(metrics.rf.rf_error) {
     printf("RF status: O=%d, U=%d, L=%d\n", metrics.rf.rf_o, metrics.rf.rf_u, metrics.rf.rf_l);
   }
+  if(metrics.phy.proc.nof_late > 0) {
+    printf("PHY late: %d/%d subframes, avg=%.0f us, max=%.0f us\n", metrics.phy.proc.nof_late, metrics.phy.proc.nof_sf,
+           metrics.phy.proc.avg_us, metrics.phy.proc.max_us);
+  }
   
 }
 
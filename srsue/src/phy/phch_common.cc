@@ -39,7 +39,7 @@ namespace srsue {
 
 cf_t zeros[50000];
 
-phch_common::phch_common(uint32_t max_workers) : tx_sem(max_workers)
+phch_common::phch_common(uint32_t max_workers)
 {
   config    = NULL; 
   args      = NULL; 
@@ -64,10 +64,6 @@ phch_common::phch_common(uint32_t max_workers) : tx_sem(max_workers)
 
   bzero(zeros, 50000*sizeof(cf_t));
 
-  for (uint32_t i=0;i<max_workers;i++) {
-    sem_init(&tx_sem[i], 0, 0); // All semaphores start blocked
-  }
-
   reset();
 
   sib13_configured = false;
@@ -75,19 +71,15 @@ phch_common::phch_common(uint32_t max_workers) : tx_sem(max_workers)
 }
 
 phch_common::~phch_common() {
-  for (uint32_t i=0;i<max_workers;i++) {
-    sem_post(&tx_sem[i]);
-  }
-  for (uint32_t i=0;i<max_workers;i++) {
-    sem_destroy(&tx_sem[i]);
-  }
+  tx_queue.stop();
 }
 
 void phch_common::set_nof_workers(uint32_t nof_workers) {
   this->nof_workers = nof_workers;
 }
   
-void phch_common::init(phy_interface_rrc::phy_cfg_t *_config, phy_args_t *_args, srslte::log *_log, srslte::radio *_radio, rrc_interface_phy *_rrc, mac_interface_phy *_mac)
+void phch_common::init(phy_interface_rrc::phy_cfg_t *_config, phy_args_t *_args, srslte::log *_log, srslte::radio *_radio, rrc_interface_phy *_rrc, mac_interface_phy *_mac,
+                       int tx_prio)
 {
   log_h     = _log; 
   radio_h   = _radio;
@@ -95,8 +87,17 @@ void phch_common::init(phy_interface_rrc::phy_cfg_t *_config, phy_args_t *_args,
   mac       = _mac; 
   config    = _config;     
   args      = _args; 
-  is_first_tx = true; 
   sr_last_tx_tti = -1;
+
+  // A subframe grows or shrinks by the timing advance change, the slots hold two of the largest subframe
+  if (!tx_queue.init(this, 2*max_workers, 1, 2*SRSLTE_SF_LEN_MAX*sizeof(cf_t), tx_prio)) {
+    Error("Initiating transmission queue\n");
+  }
+}
+
+void phch_common::stop()
+{
+  tx_queue.stop();
 }
 
 bool phch_common::ul_rnti_active(uint32_t tti) {
@@ -232,37 +233,54 @@ bool phch_common::is_any_pending_ack() {
   return false;
 }
 
-/* The transmission of UL subframes must be in sequence. The correct sequence is guaranteed by a chain of N semaphores,
- * one per TTI%max_workers. Each threads waits for the semaphore for the current thread and after transmission allows
- * next TTI to be transmitted
+/* The transmission of UL subframes must be in sequence. Each worker copies its subframe into the slot of the
+ * transmission queue given by its sequence number and returns without waiting for the previous subframes, which
+ * are transmitted in order by the tx thread.
  *
  * Each worker uses this function to indicate that all processing is done and data is ready for transmission or
  * there is no transmission at all (tx_enable). In that case, the end of burst message will be sent to the radio
  */
-void phch_common::worker_end(uint32_t tti, bool tx_enable, 
+void phch_common::worker_end(uint32_t tx_seq, bool tx_enable,
                                    cf_t *buffer, uint32_t nof_samples, 
-                                   srslte_timestamp_t tx_time)
+                                   srslte_timestamp_t tx_time,
+                                   srslte::phy_trace *trace)
 {
+  srslte::tx_reorder_slot_t *slot;
 
-  // This variable is not protected but it is very unlikely that 2 threads arrive here simultaneously since at the beginning
-  // there is no workload and threads are separated by 1 ms
-  if (is_first_tx) {
-    is_first_tx = false;
-    // Allow my own transmission if I'm the first to transmit
-    sem_post(&tx_sem[tti%nof_workers]);
+  // Only waits if the radio is a whole queue behind
+  {
+    srslte::phy_trace::scope s(trace, srslte::PHY_TRACE_TX_WAIT);
+    slot = tx_queue.get_slot(tx_seq);
   }
 
-  // Wait for the green light to transmit in the current TTI
-  sem_wait(&tx_sem[tti%nof_workers]);
+  {
+    srslte::phy_trace::scope s(trace, srslte::PHY_TRACE_TX);
+    if (nof_samples*sizeof(cf_t) > tx_queue.get_slot_bytes()) {
+      Error("Subframe of %d samples does not fit the transmission queue\n", nof_samples);
+      tx_enable = false;
+    }
+    if (tx_enable) {
+      memcpy(slot->buffer[0], buffer, nof_samples*sizeof(cf_t));
+    }
+    slot->nof_samples = nof_samples;
+    slot->tx_enable   = tx_enable;
+    slot->c16         = false;
+    srslte_timestamp_copy(&slot->tx_time, &tx_time);
+  }
 
-  radio_h->set_tti(tti);
-  if (tx_enable) {
-    radio_h->tx_single(buffer, nof_samples, tx_time);
+  tx_queue.push(tx_seq);
+}
+
+void phch_common::tx_slot(uint32_t seq, srslte::tx_reorder_slot_t *slot)
+{
+  radio_h->set_tti(seq);
+  if (slot->tx_enable) {
+    radio_h->tx_single(slot->buffer[0], slot->nof_samples, slot->tx_time);
     is_first_of_burst = false; 
   } else {
     if (radio_h->is_continuous_tx()) {
       if (!is_first_of_burst) {
-        radio_h->tx_single(zeros, nof_samples, tx_time);
+        radio_h->tx_single(zeros, slot->nof_samples, slot->tx_time);
       }
     } else {
       if (!is_first_of_burst) {
@@ -271,9 +289,6 @@ void phch_common::worker_end(uint32_t tti, bool tx_enable,
       }
     }
   }
-
-  // Allow next TTI to transmit
-  sem_post(&tx_sem[(tti+1)%nof_workers]);
 }    
 
 
@@ -346,7 +361,6 @@ void phch_common::get_sync_metrics(sync_metrics_t &m) {
 void phch_common::reset() {
   sr_enabled        = false;
   is_first_of_burst = true;
-  is_first_tx       = true;
   rar_grant_pending = false;
   pathloss = 0;
   cur_pathloss = 0;
@@ -129,7 +129,7 @@ void phch_recv::reset()
   radio_overflow_return = false;
   in_sync_cnt = 0;
   out_of_sync_cnt = 0;
-  tx_worker_cnt = 0;
+  tx_seq = 0;
   time_adv_sec = 0;
   next_offset  = 0;
   srate_mode = SRATE_NONE;
@@ -455,13 +455,13 @@ void phch_recv::run_thread()
 
               worker->set_prach(prach_ptr?&prach_ptr[prach_sf_cnt*SRSLTE_SF_LEN_PRB(cell.nof_prb)]:NULL, prach_power);
               worker->set_cfo(get_tx_cfo());
-              worker->set_tti(tti, tx_worker_cnt);
+              worker->set_tti(tti, tx_seq);
               worker->set_tx_time(tx_time, next_offset);
               next_offset  = 0;
               if (next_time_adv_sec != time_adv_sec) {
                 time_adv_sec = next_time_adv_sec;
               }
-              tx_worker_cnt = (tx_worker_cnt+1) % nof_workers;
+              tx_seq++;
 
               // Advance/reset prach subframe pointer
               if (prach_ptr) {
@@ -1528,7 +1528,7 @@ int phch_recv::meas_stop(uint32_t earfcn, int pci) {
 }
 
 phch_recv::intra_measure::~intra_measure() {
-  srslte_ringbuffer_free(&ring_buffer);
+  srslte_ringbuffer_spsc_free(&ring_buffer);
   scell.deinit();
   free(search_buffer);
 }
@@ -1538,13 +1538,16 @@ void phch_recv::intra_measure::init(phch_common *common, rrc_interface_phy *rrc,
   this->log_h  = log_h;
   this->common = common;
   receive_enabled = false;
+  receiving       = false;
+  flush_pending   = false;
+  current_sflen   = 0;
 
   // Start scell
   scell.init(log_h, common->args->sic_pss_enabled, common->args->intra_freq_meas_len_ms);
 
   search_buffer = (cf_t*) srslte_vec_malloc(common->args->intra_freq_meas_len_ms*SRSLTE_SF_LEN_PRB(SRSLTE_MAX_PRB)*sizeof(cf_t));
 
-  if (srslte_ringbuffer_init(&ring_buffer, sizeof(cf_t)*common->args->intra_freq_meas_len_ms*2*SRSLTE_SF_LEN_PRB(SRSLTE_MAX_PRB))) {
+  if (srslte_ringbuffer_spsc_init(&ring_buffer, sizeof(cf_t)*common->args->intra_freq_meas_len_ms*2*SRSLTE_SF_LEN_PRB(SRSLTE_MAX_PRB))) {
     return;
   }
 
@@ -1554,13 +1557,20 @@ void phch_recv::intra_measure::init(phch_common *common, rrc_interface_phy *rrc,
 
 void phch_recv::intra_measure::stop() {
   running = false;
-  srslte_ringbuffer_stop(&ring_buffer);
+  srslte_ringbuffer_spsc_stop(&ring_buffer);
   tti_sync.increase();
   wait_thread_finish();
 }
 
+/* Called from the sync thread, the producer of the ring */
 void phch_recv::intra_measure::set_primay_cell(uint32_t earfcn, srslte_cell_t cell) {
   this->current_earfcn = earfcn;
+  if (current_sflen != (uint32_t) SRSLTE_SF_LEN_PRB(cell.nof_prb)) {
+    // A measurement in progress, or waiting to be read, has the old subframe length
+    srslte_ringbuffer_spsc_write_cancel(&ring_buffer);
+    receiving = false;
+    flush();
+  }
   current_sflen = SRSLTE_SF_LEN_PRB(cell.nof_prb);
   memcpy(&this->primary_cell, &cell, sizeof(srslte_cell_t));
 }
@@ -1570,7 +1580,15 @@ void phch_recv::intra_measure::clear_cells() {
   receive_enabled = false;
   receiving = false;
   receive_cnt = 0;
-  srslte_ringbuffer_reset(&ring_buffer);
+  flush();
+}
+
+/* The ring can only be emptied by its consumer, the measurement thread is woken up to discard its contents.
+ * Staged samples are dropped by the producer when the next measurement period starts.
+ */
+void phch_recv::intra_measure::flush() {
+  flush_pending = true;
+  tti_sync.increase();
 }
 
 void phch_recv::intra_measure::add_cell(int pci) {
@@ -1606,21 +1624,30 @@ void phch_recv::intra_measure::rem_cell(int pci) {
   }
 }
 
+/* Called from the sync thread every subframe. The samples of a measurement are staged in the ring and only
+ * committed once complete, so an interrupted measurement is dropped without the measurement thread seeing it.
+ */
 void phch_recv::intra_measure::write(uint32_t tti, cf_t *data, uint32_t nsamples) {
   if (receive_enabled) {
     if ((tti%common->args->intra_freq_meas_period_ms) == 0) {
-      receiving   = true;
+      srslte_ringbuffer_spsc_write_cancel(&ring_buffer);
       receive_cnt = 0;
       measure_tti = tti;
-      srslte_ringbuffer_reset(&ring_buffer);
+      // Skip this period if the previous measurement has not been read yet
+      receiving   = srslte_ringbuffer_spsc_status(&ring_buffer) == 0;
+      if (!receiving) {
+        Debug("INTRA: Skipping measurement at tti=%d, previous one still pending\n", tti);
+      }
     }
     if (receiving == true) {
-      if (srslte_ringbuffer_write(&ring_buffer, data, nsamples*sizeof(cf_t)) < (int) (nsamples*sizeof(cf_t))) {
+      if (srslte_ringbuffer_spsc_write_staged(&ring_buffer, data, nsamples*sizeof(cf_t)) < (int) (nsamples*sizeof(cf_t))) {
         Warning("Error writting to ringbuffer\n");
+        srslte_ringbuffer_spsc_write_cancel(&ring_buffer);
         receiving = false;
       } else {
         receive_cnt++;
         if (receive_cnt == common->args->intra_freq_meas_len_ms) {
+          srslte_ringbuffer_spsc_write_commit(&ring_buffer);
           tti_sync.increase();
           receiving = false; 
         }
@@ -1638,10 +1665,24 @@ void phch_recv::intra_measure::run_thread()
 
     if (running) {
 
+      // Discard anything that is not one whole measurement of the current cell, otherwise the producer,
+      // which waits for an empty ring, would never start a new measurement
+      int nof_bytes = common->args->intra_freq_meas_len_ms*current_sflen*sizeof(cf_t);
+      int queued    = srslte_ringbuffer_spsc_status(&ring_buffer);
+      if (flush_pending || queued != nof_bytes) {
+        if (queued) {
+          Debug("INTRA: Discarding %d bytes of measurement samples\n", queued);
+        }
+        flush_pending = false;
+        srslte_ringbuffer_spsc_read_advance(&ring_buffer, queued);
+        continue;
+      }
+
       // Read data from buffer and find cells in it
-      srslte_ringbuffer_read(&ring_buffer, search_buffer, common->args->intra_freq_meas_len_ms*current_sflen*sizeof(cf_t));
+      if (srslte_ringbuffer_spsc_read(&ring_buffer, search_buffer, nof_bytes) == 0) {
+        continue;
+      }
       int found_cells = scell.find_cells(search_buffer, common->rx_gain_offset, primary_cell, common->args->intra_freq_meas_len_ms, info);
-      receiving = false;
 
       for (int i=0;i<found_cells;i++) {
         rrc->new_phy_meas(info[i].rsrp, info[i].rsrq, measure_tti, current_earfcn, info[i].pci);
@@ -148,9 +148,16 @@ bool phch_worker::init(uint32_t max_prb, srslte::log *log_h, srslte::log *log_ph
   srslte_chest_dl_set_rsrp_neighbour(&ue_dl.chest, true);
   srslte_chest_dl_average_subframe(&ue_dl.chest, phy->args->average_subframe_enabled);
   srslte_chest_dl_cfo_estimate_enable(&ue_dl.chest, phy->args->cfo_ref_mask!=0, phy->args->cfo_ref_mask);
+  srslte_chest_dl_set_interp_plan(&ue_dl.chest, phy->args->estimator_plan);
+  srslte_chest_dl_set_meas_sf_mask(&ue_dl.chest, phy->args->estimator_meas_mask);
   srslte_ue_ul_set_normalization(&ue_ul, true);
   srslte_ue_ul_set_cfo_enable(&ue_ul, true);
   srslte_pdsch_enable_csi(&ue_dl.pdsch, phy->args->pdsch_csi_enabled);
+  srslte_ue_dl_set_mimo_decoder(&ue_dl, phy->args->equalizer_mode.compare("zf") ? SRSLTE_MIMO_DECODER_MMSE
+                                                                                : SRSLTE_MIMO_DECODER_ZF);
+
+  // Subframes are late when they are not transmitted before their tx_time
+  trace.init(TRACE_NOF_EVENTS, (HARQ_DELAY_MS-1)*1000);
 
   mem_initiated = true;
 
@@ -194,10 +201,10 @@ cf_t* phch_worker::get_buffer(uint32_t antenna_idx)
   return signal_buffer[antenna_idx]; 
 }
 
-void phch_worker::set_tti(uint32_t tti_, uint32_t tx_worker_cnt)
+void phch_worker::set_tti(uint32_t tti_, uint32_t tx_seq_)
 {
   tti    = tti_;
-  tx_tti = tx_worker_cnt;
+  tx_seq = tx_seq_;
   log_h->step(tti);
   if (log_phy_lib_h) {
     log_phy_lib_h->step(tti);
@@ -262,6 +269,7 @@ void phch_worker::work_imp()
 #endif
 
   tr_log_start();
+  trace.sf_begin(tti);
   
   reset_uci();
 
@@ -317,7 +325,10 @@ void phch_worker::work_imp()
       /***** Downlink Processing *******/
       
       /* PDCCH DL + PDSCH */
-       dl_grant_available = decode_pdcch_dl(&dl_mac_grant); 
+       {
+         srslte::phy_trace::scope s(&trace, srslte::PHY_TRACE_PDCCH);
+         dl_grant_available = decode_pdcch_dl(&dl_mac_grant);
+       }
        if(dl_grant_available) {
          /* Send grant to MAC and get action for this TB */
          phy->mac->new_grant_dl(dl_mac_grant, &dl_action);
@@ -329,6 +340,7 @@ void phch_worker::work_imp()
 
          /* Decode PDSCH if instructed to do so */
          if (dl_action.decode_enabled[0] || dl_action.decode_enabled[1]) {
+           srslte::phy_trace::scope s(&trace, srslte::PHY_TRACE_PDSCH);
            decode_pdsch(&dl_action.phy_grant.dl, dl_action.payload_ptr,
                          dl_action.softbuffers, dl_action.rv, dl_action.rnti,
                          dl_mac_grant.pid, dl_ack);
@@ -355,7 +367,10 @@ void phch_worker::work_imp()
     /* Do FFT and extract PDCCH LLR, or quit if no actions are required in this subframe */
     if (extract_fft_and_pdcch_llr(sf_cfg)) {
 
-      dl_grant_available = decode_pdcch_dl(&dl_mac_grant); 
+      {
+        srslte::phy_trace::scope s(&trace, srslte::PHY_TRACE_PDCCH);
+        dl_grant_available = decode_pdcch_dl(&dl_mac_grant);
+      }
       phy->mac->new_grant_dl(dl_mac_grant, &dl_action);
 
       /* Set DL ACKs to default */
@@ -384,6 +399,7 @@ void phch_worker::work_imp()
         srslte_softbuffer_rx_reset_tbs(dl_action.softbuffers[0], mch_grant.mcs[0].tbs);
         Debug("TBS=%d, Softbuffer max_cb=%d\n", mch_grant.mcs[0].tbs, dl_action.softbuffers[0]->max_cb);
         if(dl_action.decode_enabled[0]) {
+          srslte::phy_trace::scope s(&trace, srslte::PHY_TRACE_PDSCH);
           mch_decoded = decode_pmch(&mch_grant, dl_action.payload_ptr[0], dl_action.softbuffers[0], sf_cfg.mbsfn_area_id);
         }
       }
@@ -399,7 +415,11 @@ void phch_worker::work_imp()
   
   // Decode PHICH 
   bool ul_ack = false;
-  bool ul_ack_available = decode_phich(&ul_ack);
+  bool ul_ack_available = false;
+  {
+    srslte::phy_trace::scope s(&trace, srslte::PHY_TRACE_PHICH);
+    ul_ack_available = decode_phich(&ul_ack);
+  }
 
 
   /***** Uplink Processing + Transmission *******/
@@ -416,7 +436,10 @@ void phch_worker::work_imp()
     set_uci_sr();
 
     /* Check if we have UL grant. ul_phy_grant will be overwritten by new grant */
-    ul_grant_available = decode_pdcch_ul(&ul_mac_grant);
+    {
+      srslte::phy_trace::scope s(&trace, srslte::PHY_TRACE_PDCCH);
+      ul_grant_available = decode_pdcch_ul(&ul_mac_grant);
+    }
 
     /* Generate CQI reports if required, note that in case both aperiodic
         and periodic ones present, only aperiodic is sent (36.213 section 7.2) */
@@ -443,17 +466,22 @@ void phch_worker::work_imp()
 
     /* Transmit PUSCH, PUCCH or SRS */
     if (ul_action.tx_enabled) {
-      encode_pusch(&ul_action.phy_grant.ul, ul_action.payload_ptr[0], ul_action.current_tx_nb,
-                   &ul_action.softbuffers[0], ul_action.rv[0], ul_action.rnti, ul_mac_grant.is_from_rar);
+      {
+        srslte::phy_trace::scope s(&trace, srslte::PHY_TRACE_PUSCH);
+        encode_pusch(&ul_action.phy_grant.ul, ul_action.payload_ptr[0], ul_action.current_tx_nb,
+                     &ul_action.softbuffers[0], ul_action.rv[0], ul_action.rnti, ul_mac_grant.is_from_rar);
+      }
       signal_ready = true;
       if (ul_action.expect_ack) {
         phy->set_pending_ack(TTI_RX_ACK(tti), ue_ul.pusch_cfg.grant.n_prb_tilde[0], ul_action.phy_grant.ul.ncs_dmrs);
       }
 
     } else if (dl_action.generate_ack || uci_data.scheduling_request || uci_data.uci_cqi_len > 0 || uci_data.uci_ri_len > 0) {
+      srslte::phy_trace::scope s(&trace, srslte::PHY_TRACE_PUCCH);
       encode_pucch();
       signal_ready = true;
     } else if (srs_is_ready_to_send()) {
+      srslte::phy_trace::scope s(&trace, srslte::PHY_TRACE_ENCODE);
       encode_srs();
       signal_ready = true;
     }
@@ -488,10 +516,11 @@ void phch_worker::work_imp()
   }
 
   if (next_offset > 0) {
-    phy->worker_end(tx_tti, signal_ready, signal_ptr, SRSLTE_SF_LEN_PRB(cell.nof_prb)+next_offset, tx_time);
+    phy->worker_end(tx_seq, signal_ready, signal_ptr, SRSLTE_SF_LEN_PRB(cell.nof_prb)+next_offset, tx_time, &trace);
   } else {
-    phy->worker_end(tx_tti, signal_ready, &signal_ptr[-next_offset], SRSLTE_SF_LEN_PRB(cell.nof_prb)+next_offset, tx_time);
+    phy->worker_end(tx_seq, signal_ready, &signal_ptr[-next_offset], SRSLTE_SF_LEN_PRB(cell.nof_prb)+next_offset, tx_time, &trace);
   }
+  trace.sf_end();
 
   if(SUBFRAME_TYPE_REGULAR == sf_cfg.sf_type){
     update_measurements();
@@ -566,11 +595,22 @@ bool phch_worker::extract_fft_and_pdcch_llr(subframe_cfg_t sf_cfg) {
 
 
     int decode_fft = 0;
+    srslte_sf_t sf_type = SRSLTE_SF_NORM;
     if(SUBFRAME_TYPE_MBSFN == sf_cfg.sf_type) {
       srslte_ue_dl_set_non_mbsfn_region(&ue_dl, sf_cfg.non_mbsfn_region_length);
-      decode_fft = srslte_ue_dl_decode_fft_estimate_mbsfn(&ue_dl, tti%10, &cfi, SRSLTE_SF_MBSFN);
-    }else{
-      decode_fft = srslte_ue_dl_decode_fft_estimate(&ue_dl, tti%10, &cfi);
+      sf_type = SRSLTE_SF_MBSFN;
+    }
+
+    // Same as srslte_ue_dl_decode_fft_estimate_mbsfn(), split to trace the FFT and the estimation apart
+    {
+      srslte::phy_trace::scope s(&trace, srslte::PHY_TRACE_FFT);
+      for (uint32_t j=0;j<ue_dl.nof_rx_antennas;j++) {
+        srslte_ofdm_rx_sf(sf_type == SRSLTE_SF_MBSFN ? &ue_dl.fft_mbsfn : &ue_dl.fft[j]);
+      }
+    }
+    {
+      srslte::phy_trace::scope s(&trace, srslte::PHY_TRACE_CHEST);
+      decode_fft = srslte_ue_dl_decode_estimate_mbsfn(&ue_dl, tti%10, &cfi, sf_type);
     }
     if (decode_fft < 0) {
       Error("Getting PDCCH FFT estimate\n");
@@ -588,6 +628,7 @@ bool phch_worker::extract_fft_and_pdcch_llr(subframe_cfg_t sf_cfg) {
       noise_estimate = 0; 
     }
 
+    srslte::phy_trace::scope s(&trace, srslte::PHY_TRACE_PDCCH);
     if (srslte_pdcch_extract_llr_multi(&ue_dl.pdcch, ue_dl.sf_symbols_m, ue_dl.ce_m, noise_estimate, tti%10, cfi)) {
       Error("Extracting PDCCH LLR\n");
       return false; 
@@ -1684,12 +1725,21 @@ void phch_worker::update_measurements()
 
 void phch_worker::start_trace() {
   trace_enabled = true; 
+  trace.start();
 }
 
 void phch_worker::write_trace(std::string filename) {
   tr_exec.writeToBinary(filename + ".exec");
 }
 
+srslte::phy_trace* phch_worker::get_trace() {
+  return &trace;
+}
+
+void phch_worker::get_proc_metrics(srslte::phy_proc_metrics_t *m) {
+  trace.get_metrics(m);
+}
+
 void phch_worker::tr_log_start()
 {
   if (trace_enabled) {
@@ -100,6 +100,8 @@ void phy::set_default_args(phy_args_t *args)
   args->estimator_fil_auto  = false;
   args->estimator_fil_stddev = 1.0f;
   args->estimator_fil_order  = 4;
+  args->estimator_plan       = true;
+  args->estimator_meas_mask  = 1023;
 }
 
 bool phy::check_args(phy_args_t *args) 
@@ -159,7 +161,7 @@ bool phy::init(srslte::radio_multi* radio_handler, mac_interface_phy *mac, rrc_i
 void phy::run_thread() {
 
   prach_buffer.init(&config.common.prach_cnfg, SRSLTE_MAX_PRB, args, log_h);
-  workers_common.init(&config, args, (srslte::log*) log_vec[0], radio_handler, rrc, mac);
+  workers_common.init(&config, args, (srslte::log*) log_vec[0], radio_handler, rrc, mac, TX_THREAD_PRIO);
 
   // Add workers to workers pool and start threads
   for (uint32_t i=0;i<nof_workers;i++) {
@@ -207,11 +209,21 @@ void phy::write_trace(std::string filename)
     string i_str = static_cast<ostringstream*>( &(ostringstream() << i) )->str();
     workers[i].write_trace(filename + "_" + i_str);
   }
+
+  // Timeline of all workers, in Chrome trace format
+  std::vector<srslte::phy_trace*> traces;
+  for (uint32_t i=0;i<nof_workers;i++) {
+    traces.push_back(workers[i].get_trace());
+  }
+  if (!srslte::phy_trace::write_json(filename + ".json", traces)) {
+    log_h->error("Writing PHY trace to %s.json\n", filename.c_str());
+  }
 }
 
 void phy::stop()
 {  
   sf_recv.stop();
+  workers_common.stop();
   workers_pool.stop();
 }
 
@@ -224,6 +236,19 @@ void phy::get_metrics(phy_metrics_t &m) {
   m.dl.mabr_mbps = dl_tbs/1000.0; // TBS is bits/ms - convert to mbps
   m.ul.mabr_mbps = ul_tbs/1000.0; // TBS is bits/ms - convert to mbps
   Info("PHY:   MABR estimates. DL: %4.6f Mbps. UL: %4.6f Mbps.\n", m.dl.mabr_mbps, m.ul.mabr_mbps);
+
+  srslte::phy_proc_metrics_t proc;
+  bzero(&m.proc, sizeof(srslte::phy_proc_metrics_t));
+  for (uint32_t i=0;i<nof_workers;i++) {
+    workers[i].get_proc_metrics(&proc);
+    m.proc.avg_us   += proc.nof_sf*proc.avg_us;
+    m.proc.max_us    = SRSLTE_MAX(m.proc.max_us, proc.max_us);
+    m.proc.nof_sf   += proc.nof_sf;
+    m.proc.nof_late += proc.nof_late;
+  }
+  if (m.proc.nof_sf > 0) {
+    m.proc.avg_us /= m.proc.nof_sf;
+  }
 }
 
 void phy::set_timeadv_rar(uint32_t ta_cmd) {
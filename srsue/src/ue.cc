@@ -223,7 +223,8 @@ bool ue::init(all_args_t *args_) {
 
   srslte_nas_config_t nas_cfg(1, args->nas.apn_name, args->nas.apn_user, args->nas.apn_pass, args->nas.force_imsi_attach); /* RB_ID_SRB1 */
   nas.init(usim, &rrc, &gw, &nas_log, nas_cfg);
-  gw.init(&pdcp, &nas, &gw_log, 3 /* RB_ID_DRB1 */);
+  srslte_gw_config_t gw_cfg(3, args->expert.ip_nof_queues, args->expert.ip_offload); /* RB_ID_DRB1 */
+  gw.init(&pdcp, &nas, &gw_log, gw_cfg);
   gw.set_netmask(args->expert.ip_netmask);
   gw.set_tundevname(args->expert.ip_devname);
   
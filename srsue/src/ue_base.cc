@@ -142,7 +142,10 @@ std::string ue_base::get_build_info()
 std::string ue_base::get_build_string()
 {
   std::stringstream ss;
+  char isa_info[128];
+  srslte_cpu_isa_info(isa_info, sizeof(isa_info));
   ss << "Built in " << get_build_mode() << " mode using " << get_build_info() << "." << std::endl;
+  ss << isa_info << "." << std::endl;
   return ss.str();
 }
 
@@ -34,18 +34,58 @@
 #include <linux/ip.h>
 #include <linux/if.h>
 #include <linux/if_tun.h>
+#include <netinet/in.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
-
+#include <sys/uio.h>
+
+#define TCP_FLAG_FIN 0x01
+#define TCP_FLAG_PSH 0x08
+#define TCP_FLAG_CWR 0x80
+
+// Layout of struct virtio_net_hdr, linux/virtio_net.h does not build as C++
+#define TUN_VNET_HDR_F_NEEDS_CSUM 1
+#define TUN_VNET_HDR_GSO_TCPV4    1
+#define TUN_VNET_HDR_GSO_ECN      0x80
+typedef struct {
+  uint8_t  flags;
+  uint8_t  gso_type;
+  uint16_t hdr_len;
+  uint16_t gso_size;
+  uint16_t csum_start;
+  uint16_t csum_offset;
+} tun_vnet_hdr_t;
 
 namespace srsue {
 
+/* One's complement sum over big-endian 16-bit words, as used by IP/TCP checksums */
+static uint32_t csum_add(uint32_t sum, const uint8_t *data, uint32_t len)
+{
+  uint32_t i;
+  for (i = 0; i + 1 < len; i += 2) {
+    sum += (data[i] << 8) | data[i+1];
+  }
+  if (i < len) {
+    sum += data[i] << 8;
+  }
+  return sum;
+}
+
+static uint16_t csum_fold(uint32_t sum)
+{
+  while (sum >> 16) {
+    sum = (sum & 0xffff) + (sum >> 16);
+  }
+  return ~sum & 0xffff;
+}
+
 gw::gw()
   :if_up(false)
 {
   current_ip_addr = 0;
   default_netmask = true;
   tundevname = "";
+  pthread_mutex_init(&ul_mutex, NULL);
 }
 
 void gw::init(pdcp_interface_gw *pdcp_, nas_interface_gw *nas_, srslte::log *gw_log_, srslte::srslte_gw_config_t cfg_)
@@ -57,6 +97,11 @@ void gw::init(pdcp_interface_gw *pdcp_, nas_interface_gw *nas_, srslte::log *gw_
   cfg     = cfg_;
   run_enable = true;
 
+  if (cfg.nof_queues < 1 || cfg.nof_queues > GW_MAX_TUN_QUEUES) {
+    gw_log->warning("Invalid number of TUN queues %d, using 1\n", cfg.nof_queues);
+    cfg.nof_queues = 1;
+  }
+
   gettimeofday(&metrics_time[1], NULL);
   dl_tput_bytes = 0;
   ul_tput_bytes = 0;
@@ -82,7 +127,7 @@ void gw::stop()
     run_enable = false;
     if(if_up)
     {
-      close(tun_fd);
+      close_if();
       
       // Wait thread to exit gracefully otherwise might leave a mutex locked
       int cnt=0;
@@ -95,6 +140,20 @@ void gw::stop()
       }
       wait_thread_finish();
 
+      for (uint32_t i = 0; i < tun_readers.size(); i++) {
+        cnt = 0;
+        while(tun_readers[i]->is_running() && cnt<100) {
+          usleep(10000);
+          cnt++;
+        }
+        if (tun_readers[i]->is_running()) {
+          tun_readers[i]->thread_cancel();
+        }
+        tun_readers[i]->wait_thread_finish();
+        delete tun_readers[i];
+      }
+      tun_readers.clear();
+
       current_ip_addr = 0;
     }
     // TODO: tear down TUN device?
@@ -143,7 +202,7 @@ void gw::write_pdu(uint32_t lcid, srslte::byte_buffer_t *pdu)
   {
     gw_log->warning("TUN/TAP not up - dropping gw RX message\n");
   }else{
-    int n = write(tun_fd, pdu->msg, pdu->N_bytes); 
+    int n = write_tun(pdu->msg, pdu->N_bytes);
     if(n > 0 && (pdu->N_bytes != (uint32_t)n))
     {
       gw_log->warning("DL TUN/TAP write failure. Wanted to write %d B but only wrote %d B.\n", pdu->N_bytes, n);
@@ -169,7 +228,7 @@ void gw::write_pdu_mch(uint32_t lcid, srslte::byte_buffer_t *pdu)
     {
       gw_log->warning("TUN/TAP not up - dropping gw RX message\n");
     }else{
-      int n = write(tun_fd, pdu->msg, pdu->N_bytes); 
+      int n = write_tun(pdu->msg, pdu->N_bytes);
       if(n > 0 && (pdu->N_bytes != (uint32_t)n))
       {
         gw_log->warning("DL TUN/TAP write failure\n");
@@ -192,6 +251,25 @@ void gw::write_pdu_mch(uint32_t lcid, srslte::byte_buffer_t *pdu)
   pool->deallocate(pdu);
 }
 
+int gw::write_tun(uint8_t *pkt, uint32_t len)
+{
+  if (!cfg.tun_offload) {
+    return write(tun_fd, pkt, len);
+  }
+
+  // With offloads every packet is preceded by a virtio header. Downlink packets are complete, so it is left empty
+  tun_vnet_hdr_t vnet_hdr;
+  bzero(&vnet_hdr, sizeof(tun_vnet_hdr_t));
+
+  struct iovec iov[2];
+  iov[0].iov_base = &vnet_hdr;
+  iov[0].iov_len  = sizeof(tun_vnet_hdr_t);
+  iov[1].iov_base = pkt;
+  iov[1].iov_len  = len;
+  int n = writev(tun_fd, iov, 2);
+  return n > 0 ? n - (int) sizeof(tun_vnet_hdr_t) : n;
+}
+
 /*******************************************************************************
   NAS interface
 *******************************************************************************/
@@ -215,7 +293,7 @@ srslte::error_t gw::setup_if_addr(uint32_t ip_addr, char *err_str)
     {
       err_str = strerror(errno);
       gw_log->debug("Failed to set socket address: %s\n", err_str);
-      close(tun_fd);
+      close_if();
       return(srslte::ERROR_CANT_START);
     }
     ifr.ifr_netmask.sa_family                                 = AF_INET;
@@ -228,14 +306,18 @@ srslte::error_t gw::setup_if_addr(uint32_t ip_addr, char *err_str)
     {
       err_str = strerror(errno);
       gw_log->debug("Failed to set socket netmask: %s\n", err_str);
-      close(tun_fd);
+      close_if();
       return(srslte::ERROR_CANT_START);
     }
 
     current_ip_addr = ip_addr;
 
-    // Setup a thread to receive packets from the TUN device
+    // Setup a thread to receive packets from each queue of the TUN device
     start(GW_THREAD_PRIO);
+    for (uint32_t i = 0; i < tun_queue_fds.size(); i++) {
+      tun_readers.push_back(new tun_reader(this, tun_queue_fds[i]));
+      tun_readers.back()->start(GW_THREAD_PRIO);
+    }
   }
 
   return(srslte::ERROR_NONE);
@@ -259,6 +341,12 @@ srslte::error_t gw::init_if(char *err_str)
   }
   memset(&ifr, 0, sizeof(ifr));
   ifr.ifr_flags = IFF_TUN | IFF_NO_PI;
+  if (cfg.nof_queues > 1) {
+    ifr.ifr_flags |= IFF_MULTI_QUEUE;
+  }
+  if (cfg.tun_offload) {
+    ifr.ifr_flags |= IFF_VNET_HDR;
+  }
   strncpy(ifr.ifr_ifrn.ifrn_name, tundevname.c_str(), std::min(tundevname.length(), (size_t)(IFNAMSIZ-1)));
   ifr.ifr_ifrn.ifrn_name[IFNAMSIZ-1] = 0;
   if(0 > ioctl(tun_fd, TUNSETIFF, &ifr))
@@ -269,13 +357,40 @@ srslte::error_t gw::init_if(char *err_str)
       return(srslte::ERROR_CANT_START);
   }
 
+  // Attach the remaining queues to the same device
+  for (uint32_t i = 1; i < cfg.nof_queues; i++) {
+    struct ifreq queue_ifr = ifr;
+    int32 fd = open("/dev/net/tun", O_RDWR);
+    if(0 > fd || 0 > ioctl(fd, TUNSETIFF, &queue_ifr))
+    {
+      err_str = strerror(errno);
+      gw_log->debug("Failed to attach TUN queue %d: %s\n", i, err_str);
+      if (0 <= fd) {
+        close(fd);
+      }
+      close_if();
+      return(srslte::ERROR_CANT_START);
+    }
+    tun_queue_fds.push_back(fd);
+  }
+  gw_log->info("TUN device %s with %d queue(s)\n", ifr.ifr_ifrn.ifrn_name, cfg.nof_queues);
+
+  if (cfg.tun_offload) {
+    // Accept TCP segmentation and checksum offloads, segments are then built in run_tun_queue_offload()
+    unsigned int offload = TUN_F_CSUM | TUN_F_TSO4;
+    if(0 > ioctl(tun_fd, TUNSETOFFLOAD, offload))
+    {
+      gw_log->warning("Failed to enable TUN offloads: %s\n", strerror(errno));
+    }
+  }
+
   // Bring up the interface
   sock = socket(AF_INET, SOCK_DGRAM, 0);
   if(0 > ioctl(sock, SIOCGIFFLAGS, &ifr))
   {
       err_str = strerror(errno);
       gw_log->debug("Failed to bring up socket: %s\n", err_str);
-      close(tun_fd);
+      close_if();
       return(srslte::ERROR_CANT_START);
   }
   ifr.ifr_flags |= IFF_UP | IFF_RUNNING;
@@ -283,7 +398,7 @@ srslte::error_t gw::init_if(char *err_str)
   {
       err_str = strerror(errno);
       gw_log->debug("Failed to set socket flags: %s\n", err_str);
-      close(tun_fd);
+      close_if();
       return(srslte::ERROR_CANT_START);
   }
 
@@ -292,6 +407,15 @@ srslte::error_t gw::init_if(char *err_str)
   return(srslte::ERROR_NONE);
 }
 
+void gw::close_if()
+{
+  close(tun_fd);
+  for (uint32_t i = 0; i < tun_queue_fds.size(); i++) {
+    close(tun_queue_fds[i]);
+  }
+  tun_queue_fds.clear();
+}
+
 
 /*******************************************************************************
   RRC interface
@@ -310,6 +434,26 @@ void gw::add_mch_port(uint32_t lcid, uint32_t port)
 /********************/
 void gw::run_thread()
 {
+  running = true;
+  run_tun_queue(tun_fd);
+  running = false;
+  gw_log->info("GW IP receiver thread exiting.\n");
+}
+
+void gw::tun_reader::run_thread()
+{
+  running = true;
+  parent->run_tun_queue(fd);
+  running = false;
+}
+
+void gw::run_tun_queue(int32 fd)
+{
+  if (cfg.tun_offload) {
+    run_tun_queue_offload(fd);
+    return;
+  }
+
   struct iphdr   *ip_pkt;
   uint32          idx = 0;
   int32           N_bytes;
@@ -319,22 +463,18 @@ void gw::run_thread()
     return;
   }
 
-  const static uint32_t ATTACH_WAIT_TOUT = 40; // 4 sec
-  uint32_t attach_wait = 0;
+  gw_log->info("GW IP packet receiver thread run_enable, TUN fd=%d\n", fd);
 
-  gw_log->info("GW IP packet receiver thread run_enable\n");
-
-  running = true;
   while(run_enable)
   {
     if (SRSLTE_MAX_BUFFER_SIZE_BYTES-SRSLTE_BUFFER_HEADER_OFFSET > idx) {
-      N_bytes = read(tun_fd, &pdu->msg[idx], SRSLTE_MAX_BUFFER_SIZE_BYTES-SRSLTE_BUFFER_HEADER_OFFSET - idx);
+      N_bytes = read(fd, &pdu->msg[idx], SRSLTE_MAX_BUFFER_SIZE_BYTES-SRSLTE_BUFFER_HEADER_OFFSET - idx);
     } else {
       gw_log->error("GW pdu buffer full - gw receive thread exiting.\n");
       gw_log->console("GW pdu buffer full - gw receive thread exiting.\n");
       break;
     }
-    gw_log->debug("Read %d bytes from TUN fd=%d, idx=%d\n", N_bytes, tun_fd, idx);
+    gw_log->debug("Read %d bytes from TUN fd=%d, idx=%d\n", N_bytes, fd, idx);
     if(N_bytes > 0)
     {
       pdu->N_bytes = idx + N_bytes;
@@ -345,39 +485,19 @@ void gw::run_thread()
         // Check if entire packet was received
         if(ntohs(ip_pkt->tot_len) == pdu->N_bytes)
         {
-          gw_log->info_hex(pdu->msg, pdu->N_bytes, "TX PDU");
-
-          while(run_enable && !pdcp->is_lcid_enabled(cfg.lcid) && attach_wait < ATTACH_WAIT_TOUT) {
-            if (!attach_wait) {
-              gw_log->info("LCID=%d not active, requesting NAS attach (%d/%d)\n", cfg.lcid, attach_wait, ATTACH_WAIT_TOUT);
-              if (!nas->attach_request()) {
-                gw_log->warning("Could not re-establish the connection\n");
-              }
-            }
-            usleep(100000);
-            attach_wait++;
-          }
-
-          attach_wait = 0;
-
-          if (!run_enable) {
+          bool enabled = send_ul_pdu(pdu);
+          pdu = NULL;
+          if (!enabled) {
             break;
           }
-
-          // Send PDU directly to PDCP
-          if (pdcp->is_lcid_enabled(cfg.lcid)) {
-            pdu->set_timestamp();
-            ul_tput_bytes += pdu->N_bytes;
-            pdcp->write_sdu(cfg.lcid, pdu, false);
-            do {
-              pdu = pool_allocate;
-              if (!pdu) {
-                gw_log->error("Fatal Error: Couldn't allocate PDU in run_thread().\n");
-                usleep(100000);
-              }
-            } while(!pdu);
-            idx = 0;
-          }
+          do {
+            pdu = pool_allocate;
+            if (!pdu) {
+              gw_log->error("Fatal Error: Couldn't allocate PDU in run_thread().\n");
+              usleep(100000);
+            }
+          } while(!pdu);
+          idx = 0;
         }else{
           idx += N_bytes;
         }
@@ -388,8 +508,182 @@ void gw::run_thread()
       break;
     }
   }
-  running = false;
-  gw_log->info("GW IP receiver thread exiting.\n");
+  if (pdu) {
+    pool->deallocate(pdu);
+  }
+}
+
+/* Receive loop of a TUN device with offloads. Each read returns a virtio header followed
+ * by either a complete packet, possibly with a checksum left to fill, or a TCP super-packet
+ * of up to 64 KB that is segmented here. This takes far fewer reads per byte for bulk uplink.
+ */
+void gw::run_tun_queue_offload(int32 fd)
+{
+  std::vector<uint8_t>   rx_buf(sizeof(tun_vnet_hdr_t) + GW_MAX_GSO_SIZE);
+  tun_vnet_hdr_t *vnet_hdr = (tun_vnet_hdr_t*) &rx_buf[0];
+  uint8_t               *pkt      = &rx_buf[sizeof(tun_vnet_hdr_t)];
+
+  gw_log->info("GW IP packet receiver thread run_enable, TUN fd=%d with offloads\n", fd);
+
+  while(run_enable)
+  {
+    int32 N_bytes = read(fd, &rx_buf[0], rx_buf.size());
+    if (N_bytes <= 0) {
+      gw_log->error("Failed to read from TUN interface - gw receive thread exiting.\n");
+      gw_log->console("Failed to read from TUN interface - gw receive thread exiting.\n");
+      break;
+    }
+    if ((uint32_t) N_bytes <= sizeof(tun_vnet_hdr_t)) {
+      continue;
+    }
+    uint32_t len = N_bytes - sizeof(tun_vnet_hdr_t);
+    gw_log->debug("Read %d bytes from TUN fd=%d, gso_type=%d, gso_size=%d\n",
+                  len, fd, vnet_hdr->gso_type, vnet_hdr->gso_size);
+
+    // Warning: Accept only IPv4 packets
+    if (((struct iphdr*) pkt)->version != 4) {
+      continue;
+    }
+
+    if ((vnet_hdr->gso_type & ~TUN_VNET_HDR_GSO_ECN) == TUN_VNET_HDR_GSO_TCPV4) {
+      if (!send_ul_gso(pkt, len, vnet_hdr->gso_size)) {
+        break;
+      }
+      continue;
+    }
+
+    if (vnet_hdr->flags & TUN_VNET_HDR_F_NEEDS_CSUM) {
+      // The kernel left the pseudo-header sum in the checksum field, complete it over the payload
+      uint32_t csum_pos = vnet_hdr->csum_start + vnet_hdr->csum_offset;
+      if (vnet_hdr->csum_start >= len || csum_pos + 2 > len) {
+        gw_log->warning("Invalid checksum offload in TUN packet, dropping\n");
+        continue;
+      }
+      uint16_t csum = csum_fold(csum_add(0, &pkt[vnet_hdr->csum_start], len - vnet_hdr->csum_start));
+      pkt[csum_pos]   = csum >> 8;
+      pkt[csum_pos+1] = csum & 0xff;
+    }
+
+    if (len > SRSLTE_MAX_BUFFER_SIZE_BYTES-SRSLTE_BUFFER_HEADER_OFFSET) {
+      gw_log->warning("TUN packet of %d B does not fit in a PDU, dropping\n", len);
+      continue;
+    }
+    srslte::byte_buffer_t *pdu = pool_allocate;
+    if (!pdu) {
+      gw_log->error("Couldn't allocate PDU in run_tun_queue_offload(), dropping packet\n");
+      continue;
+    }
+    memcpy(pdu->msg, pkt, len);
+    pdu->N_bytes = len;
+    if (!send_ul_pdu(pdu)) {
+      break;
+    }
+  }
+}
+
+/* Splits a TCP/IPv4 super-packet into segments of at most mss bytes of payload */
+bool gw::send_ul_gso(uint8_t *pkt, uint32_t len, uint32_t mss)
+{
+  struct iphdr *ip_pkt     = (struct iphdr*) pkt;
+  uint32_t      ip_hdr_len = ip_pkt->ihl*4;
+  if (ip_pkt->protocol != IPPROTO_TCP || mss == 0 || len < ip_hdr_len + 20) {
+    gw_log->warning("Unsupported GSO packet from TUN, dropping\n");
+    return true;
+  }
+  uint32_t tcp_hdr_len = (pkt[ip_hdr_len + 12] >> 4)*4;
+  uint32_t hdr_len     = ip_hdr_len + tcp_hdr_len;
+  if (len < hdr_len || hdr_len + mss > SRSLTE_MAX_BUFFER_SIZE_BYTES-SRSLTE_BUFFER_HEADER_OFFSET) {
+    gw_log->warning("Unsupported GSO packet from TUN, dropping\n");
+    return true;
+  }
+
+  uint32_t seq;
+  memcpy(&seq, &pkt[ip_hdr_len + 4], 4);
+  seq = ntohl(seq);
+  uint16_t ip_id       = ntohs(ip_pkt->id);
+  uint8_t  tcp_flags   = pkt[ip_hdr_len + 13];
+  uint32_t payload_len = len - hdr_len;
+  uint32_t nof_segs    = 0;
+
+  for (uint32_t offset = 0; offset < payload_len; offset += mss, nof_segs++) {
+    uint32_t seg_len = std::min(mss, payload_len - offset);
+    srslte::byte_buffer_t *pdu = pool_allocate;
+    if (!pdu) {
+      gw_log->error("Couldn't allocate PDU in send_ul_gso(), dropping segment\n");
+      continue;
+    }
+    memcpy(pdu->msg, pkt, hdr_len);
+    memcpy(&pdu->msg[hdr_len], &pkt[hdr_len + offset], seg_len);
+    pdu->N_bytes = hdr_len + seg_len;
+
+    struct iphdr *seg_ip = (struct iphdr*) pdu->msg;
+    seg_ip->tot_len = htons(pdu->N_bytes);
+    seg_ip->id      = htons(ip_id + nof_segs);
+    seg_ip->check   = 0;
+    seg_ip->check   = htons(csum_fold(csum_add(0, pdu->msg, ip_hdr_len)));
+
+    uint8_t *seg_tcp     = &pdu->msg[ip_hdr_len];
+    uint32_t seg_tcp_len = tcp_hdr_len + seg_len;
+    uint32_t seg_seq     = htonl(seq + offset);
+    memcpy(&seg_tcp[4], &seg_seq, 4);
+    // FIN and PSH belong to the last segment only, CWR to the first one only
+    seg_tcp[13] = tcp_flags;
+    if (offset + seg_len < payload_len) {
+      seg_tcp[13] &= ~(TCP_FLAG_FIN | TCP_FLAG_PSH);
+    }
+    if (nof_segs > 0) {
+      seg_tcp[13] &= ~TCP_FLAG_CWR;
+    }
+    seg_tcp[16] = 0;
+    seg_tcp[17] = 0;
+    uint32_t sum = csum_add(0, (uint8_t*) &seg_ip->saddr, 8) + IPPROTO_TCP + seg_tcp_len;
+    uint16_t csum = csum_fold(csum_add(sum, seg_tcp, seg_tcp_len));
+    seg_tcp[16] = csum >> 8;
+    seg_tcp[17] = csum & 0xff;
+
+    if (!send_ul_pdu(pdu)) {
+      return false;
+    }
+  }
+  gw_log->debug("Segmented %d B GSO packet into %d PDUs\n", len, nof_segs);
+  return true;
+}
+
+/* Hands an uplink IP packet to PDCP, requesting an attach if the default bearer is not up.
+ * Takes ownership of the PDU. Returns false if the GW is stopping.
+ */
+bool gw::send_ul_pdu(srslte::byte_buffer_t *pdu)
+{
+  const static uint32_t ATTACH_WAIT_TOUT = 40; // 4 sec
+  uint32_t attach_wait = 0;
+
+  gw_log->info_hex(pdu->msg, pdu->N_bytes, "TX PDU");
+
+  pthread_mutex_lock(&ul_mutex);
+  while(run_enable && !pdcp->is_lcid_enabled(cfg.lcid) && attach_wait < ATTACH_WAIT_TOUT) {
+    if (!attach_wait) {
+      gw_log->info("LCID=%d not active, requesting NAS attach (%d/%d)\n", cfg.lcid, attach_wait, ATTACH_WAIT_TOUT);
+      if (!nas->attach_request()) {
+        gw_log->warning("Could not re-establish the connection\n");
+      }
+    }
+    usleep(100000);
+    attach_wait++;
+  }
+
+  // Send PDU directly to PDCP
+  if (run_enable && pdcp->is_lcid_enabled(cfg.lcid)) {
+    pdu->set_timestamp();
+    ul_tput_bytes += pdu->N_bytes;
+    pdcp->write_sdu(cfg.lcid, pdu, false);
+    pdu = NULL;
+  }
+  pthread_mutex_unlock(&ul_mutex);
+
+  if (pdu) {
+    pool->deallocate(pdu);
+  }
+  return run_enable;
 }
 
 } // namespace srsue